@@ -1,8 +1,9 @@
 #![allow(unreachable_code)]
 use std::{env, path::PathBuf};
 
-//#[cfg(all(target_os = "macos", feature = "openmp"))]
-//static MAC_OS_BREW_CLANG_PATH: &str = "/usr/local/opt/llvm";
+/// Homebrew LLVM prefixes on Apple Silicon and Intel Macs.
+#[cfg(all(target_os = "macos", feature = "openmp"))]
+static MAC_OS_BREW_LLVM_PATHS: [&str; 2] = ["/opt/homebrew/opt/llvm", "/usr/local/opt/llvm"];
 
 pub fn main() {
     // On docs.rs the C++ toolchain is unavailable. The pre-generated
@@ -68,6 +69,15 @@ pub fn main() {
     #[cfg(not(feature = "tbb"))]
     open_subdiv.define("NO_TBB", "1");
 
+    // OpenSubdiv's `FindTBB` looks in `TBB_LOCATION` before the system
+    // paths.
+    #[cfg(feature = "tbb")]
+    let tbb_location = env::var_os("TBB_LOCATION").map(PathBuf::from);
+    #[cfg(feature = "tbb")]
+    if let Some(tbb_location) = &tbb_location {
+        open_subdiv.define("TBB_LOCATION", tbb_location);
+    }
+
     // Disable OpenCL unless explicitly enabled
     #[cfg(not(feature = "opencl"))]
     {
@@ -75,37 +85,53 @@ pub fn main() {
         open_subdiv.define("NO_CLEW", "1");
     }
 
-    #[cfg(any(target_os = "macos", not(feature = "openmp")))]
+    #[cfg(not(feature = "openmp"))]
     open_subdiv.define("NO_OMP", "1");
 
     #[cfg(any(not(target_os = "macos"), not(feature = "metal")))]
     open_subdiv.define("NO_METAL", "1");
 
-    /* FIXME: OMP support on macOS
-    #[cfg(all(target_os = "macos", feature = "openmp"))]
-    {
-        // We try to use Homebrew's Clang for building; not Apple Clang.
-        // This allows us to build with OpenMP support.
-        let clang_path = PathBuf::from(MAC_OS_BREW_CLANG_PATH);
-        let clang = clang_path.join("bin").join("clang");
-        let clang_pp = clang_path.join("bin").join("clang++");
-        let clang_lib = clang_path.join("lib");
-
-        if clang.exists() && clang_pp.exists() {
-            open_subdiv
-                .define("CMAKE_C_COMPILER", clang)
-                .define("CMAKE_CXX_COMPILER", clang_pp)
-                .define("OPENMP_LIBRARIES", &clang_lib)
-                .define("OPENMP_INCLUDES", clang_path.join("include"));
+    // AIDEV-NOTE: OpenMP runtime detection.
+    // `OPENMP_LIBRARIES`/`OPENMP_INCLUDES` override CMake's `FindOpenMP`,
+    // which cannot find `libomp` for Clang on its own (CMake issue #18470).
+    // The same directory is searched when linking the runtime below.
+    #[cfg(feature = "openmp")]
+    let openmp_libraries = env::var_os("OPENMP_LIBRARIES").map(PathBuf::from);
+    #[cfg(feature = "openmp")]
+    if let Some(openmp_includes) = env::var_os("OPENMP_INCLUDES") {
+        open_subdiv.define("OPENMP_INCLUDES", openmp_includes);
+    }
 
-            println!("cargo:rustc-link-search=native={}", clang_lib.display());
-        } else {
+    // Apple Clang has no OpenMP support; build with Homebrew's Clang instead.
+    #[cfg(all(target_os = "macos", feature = "openmp"))]
+    let openmp_libraries = {
+        let Some(llvm_path) = env::var_os("LLVM_PREFIX").map(PathBuf::from).or_else(|| {
+            MAC_OS_BREW_LLVM_PATHS
+                .iter()
+                .map(PathBuf::from)
+                .find(|path| path.join("bin").join("clang++").exists())
+        }) else {
             // No clang installed via Homebrew – we can't build with OpenMP
             // support on macOS as Apple's Clang has no support for it.
-            panic!("Feature `openmp` enabled but no OpenMP capable compiler found.")
-        }
-
-    }*/
+            panic!(
+                "Feature `openmp` enabled but no OpenMP capable compiler found; \
+                 install LLVM with `brew install llvm libomp` or set `LLVM_PREFIX`."
+            );
+        };
+
+        open_subdiv
+            .define("CMAKE_C_COMPILER", llvm_path.join("bin").join("clang"))
+            .define("CMAKE_CXX_COMPILER", llvm_path.join("bin").join("clang++"));
+        openmp_libraries.or_else(|| {
+            open_subdiv.define("OPENMP_INCLUDES", llvm_path.join("include"));
+            Some(llvm_path.join("lib"))
+        })
+    };
+
+    #[cfg(feature = "openmp")]
+    if let Some(openmp_libraries) = &openmp_libraries {
+        open_subdiv.define("OPENMP_LIBRARIES", openmp_libraries);
+    }
 
     let open_subdiv = open_subdiv.build();
 
@@ -143,17 +169,28 @@ pub fn main() {
         .file("c-api/far/patch_table.cpp")
         .file("c-api/far/patch_evaluator.cpp")
         .file("c-api/bfr/surface_factory.cpp")
+        .file("c-api/bfr/tessellation.cpp")
         .file("c-api/osd/cpu_evaluator.cpp")
+        .file("c-api/osd/cpu_patch_table.cpp")
         .file("c-api/osd/cpu_vertex_buffer.cpp");
 
-    #[cfg(all(feature = "openmp", not(target_os = "macos")))]
+    #[cfg(feature = "openmp")]
     osd_capi.file("c-api/osd/omp_evaluator.cpp");
 
     #[cfg(all(feature = "cuda", not(target_os = "macos")))]
-    osd_capi
-        .include(&osd_inlude_path)
-        .file("c-api/osd/cuda_evaluator.cpp")
-        .file("c-api/osd/cuda_vertex_buffer.cpp");
+    {
+        // The stream/event shims include `cuda_runtime.h` directly.
+        let cuda_include_path = std::env::var("CUDA_PATH")
+            .map(|path| std::path::PathBuf::from(path).join("include"))
+            .unwrap_or_else(|_| std::path::PathBuf::from("/usr/local/cuda/include"));
+        if cuda_include_path.exists() {
+            osd_capi.include(&cuda_include_path);
+        }
+        osd_capi
+            .include(&osd_inlude_path)
+            .file("c-api/osd/cuda_evaluator.cpp")
+            .file("c-api/osd/cuda_vertex_buffer.cpp");
+    }
 
     #[cfg(all(feature = "metal", target_os = "macos"))]
     osd_capi
@@ -177,13 +214,37 @@ pub fn main() {
     println!("cargo:rustc-link-lib=static=osd-capi");
 
     println!("cargo:rustc-link-search=native={}", osd_lib_path.display());
+    // `osdCPU` also holds the OpenMP and TBB evaluators when they are
+    // enabled; only their runtimes need linking.
     println!("cargo:rustc-link-lib=static=osdCPU");
 
-    #[cfg(all(feature = "openmp", not(target_os = "macos")))]
-    println!("cargo:rustc-link-lib=static=osdOMP");
+    #[cfg(feature = "openmp")]
+    {
+        if let Some(openmp_libraries) = &openmp_libraries {
+            println!(
+                "cargo:rustc-link-search=native={}",
+                openmp_libraries.display()
+            );
+        }
+        // MSVC links `vcomp` through the objects compiled with `/openmp`.
+        let compiler = osd_capi.get_compiler();
+        if compiler.is_like_clang() {
+            println!("cargo:rustc-link-lib=dylib=omp");
+        } else if compiler.is_like_gnu() {
+            println!("cargo:rustc-link-lib=dylib=gomp");
+        }
+    }
 
     #[cfg(feature = "tbb")]
-    println!("cargo:rustc-link-lib=dylib=tbb");
+    {
+        if let Some(tbb_location) = &tbb_location {
+            println!(
+                "cargo:rustc-link-search=native={}",
+                tbb_location.join("lib").display()
+            );
+        }
+        println!("cargo:rustc-link-lib=dylib=tbb");
+    }
 
     #[cfg(feature = "cuda")]
     {
@@ -287,4 +348,12 @@ pub fn main() {
         .expect("Couldn't write bindings");
 
     println!("cargo:rerun-if-changed=build.rs");
+    for var in [
+        "LLVM_PREFIX",
+        "OPENMP_INCLUDES",
+        "OPENMP_LIBRARIES",
+        "TBB_LOCATION",
+    ] {
+        println!("cargo:rerun-if-env-changed={var}");
+    }
 }
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <opensubdiv/bfr/refinerSurfaceFactory.h>
+#include <opensubdiv/bfr/surface.h>
+#include <opensubdiv/bfr/surfaceFactoryCache.h>
+
+#include <mutex>
+
+// AIDEV-NOTE: Thread-safe factory cache.
+// The default `SurfaceFactoryCache` is not safe to use from several threads.
+// A plain mutex serves as both read and write lock since the shims build
+// against C++14, which has no `std::shared_mutex`.
+typedef OpenSubdiv::Bfr::SurfaceFactoryCacheThreaded<
+    std::mutex,
+    std::unique_lock<std::mutex>,
+    std::unique_lock<std::mutex>>
+    Bfr_ThreadedCache;
+
+typedef OpenSubdiv::Bfr::RefinerSurfaceFactory<Bfr_ThreadedCache>
+    Bfr_RefinerSurfaceFactory;
+
+// Opaque wrappers for Rust.
+struct Bfr_SurfaceFactory_f
+{
+    Bfr_RefinerSurfaceFactory *ptr;
+};
+
+struct Bfr_Surface_f
+{
+    OpenSubdiv::Bfr::Surface<float> surface;
+};
+
+struct Bfr_SurfaceFactoryCache_f
+{
+    Bfr_ThreadedCache cache;
+};
@@ -1,28 +1,57 @@
 // Minimal C API shim for Bfr::RefinerSurfaceFactory and Surface (float).
-#include <opensubdiv/bfr/refinerSurfaceFactory.h>
-#include <opensubdiv/bfr/surface.h>
+#include "surface.hpp"
+
 #include <opensubdiv/far/topologyRefiner.h>
+#include <opensubdiv/osd/bufferDescriptor.h>
+
+#include <cstddef>
 #include <vector>
 
 using namespace OpenSubdiv;          // NOLINT
 using namespace OPENSUBDIV_VERSION;  // NOLINT
 
-extern "C"
+typedef Bfr::Surface<float>::PointDescriptor PointDescriptor;
+
+/// Patch points of up to this many floats are gathered on the stack by the
+/// single-point evaluation entry point.
+static const int kStackPatchFloats = 64 * 3;
+
+/// Control point indices of up to this many points are checked on the stack.
+static const int kStackControlPoints = 64;
+
+/// Returns whether all control points of `surface` index into a mesh of
+/// `num_mesh_points` points.
+static bool controlPointsInRange(
+    Bfr::Surface<float> const &surface, int num_mesh_points)
 {
+    const int num_cvs = surface.GetNumControlPoints();
+    int stack_indices[kStackControlPoints];
+    std::vector<int> heap_indices;
+    int *indices = stack_indices;
+    if (num_cvs > kStackControlPoints) {
+        heap_indices.resize(num_cvs);
+        indices = heap_indices.data();
+    }
+    surface.GetControlPointIndices(indices);
 
-    // Opaque wrappers for Rust.
-    struct Bfr_SurfaceFactory_f
-    {
-        Bfr::RefinerSurfaceFactory<> *ptr;
-    };
+    for (int i = 0; i < num_cvs; ++i) {
+        if (indices[i] < 0 || indices[i] >= num_mesh_points) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    struct Bfr_Surface_f
-    {
-        Bfr::Surface<float> surface;
-    };
+extern "C"
+{
 
-    Bfr_SurfaceFactory_f *Bfr_SurfaceFactory_Create(
-        Far::TopologyRefiner *refiner, int approx_level_smooth, int approx_level_sharp)
+    // Create a factory that shares `cache` (which must outlive it) instead of
+    // owning one. A null `cache` uses the factory's internal cache.
+    Bfr_SurfaceFactory_f *Bfr_SurfaceFactory_CreateWithCache(
+        Far::TopologyRefiner *refiner,
+        int approx_level_smooth,
+        int approx_level_sharp,
+        Bfr_SurfaceFactoryCache_f *cache)
     {
         if (!refiner) {
             return nullptr;
@@ -31,12 +60,40 @@ extern "C"
         Bfr::SurfaceFactory::Options opts;
         opts.SetApproxLevelSmooth(approx_level_smooth);
         opts.SetApproxLevelSharp(approx_level_sharp);
+        if (cache) {
+            opts.SetExternalCache(&cache->cache);
+        }
 
         auto *wrapper = new Bfr_SurfaceFactory_f();
-        wrapper->ptr = new Bfr::RefinerSurfaceFactory<>(*refiner, opts);
+        wrapper->ptr = new Bfr_RefinerSurfaceFactory(*refiner, opts);
         return wrapper;
     }
 
+    // The factory's internal cache is thread-safe, so Init*Surface() may be
+    // called concurrently.
+    Bfr_SurfaceFactory_f *Bfr_SurfaceFactory_Create(
+        Far::TopologyRefiner *refiner, int approx_level_smooth, int approx_level_sharp)
+    {
+        return Bfr_SurfaceFactory_CreateWithCache(
+            refiner, approx_level_smooth, approx_level_sharp, nullptr);
+    }
+
+    Bfr_SurfaceFactoryCache_f *Bfr_SurfaceFactoryCache_Create()
+    {
+        return new Bfr_SurfaceFactoryCache_f();
+    }
+
+    void Bfr_SurfaceFactoryCache_Destroy(Bfr_SurfaceFactoryCache_f *cache)
+    {
+        delete cache;
+    }
+
+    // Number of distinct surface topologies in the cache.
+    int Bfr_SurfaceFactoryCache_GetNumEntries(const Bfr_SurfaceFactoryCache_f *cache)
+    {
+        return cache ? static_cast<int>(cache->cache.GetNumEntries()) : 0;
+    }
+
     void Bfr_SurfaceFactory_Destroy(Bfr_SurfaceFactory_f *factory)
     {
         if (!factory)
@@ -66,6 +123,83 @@ extern "C"
         return factory->ptr->InitVertexSurface(face_index, &surface->surface);
     }
 
+    // Initialize the varying (linearly interpolated) surface of a face. Its
+    // control points index the mesh vertices, like the vertex surface's.
+    bool Bfr_SurfaceFactory_InitVaryingSurface(
+        const Bfr_SurfaceFactory_f *factory, int face_index, Bfr_Surface_f *surface)
+    {
+        if (!factory || !factory->ptr || !surface) {
+            return false;
+        }
+
+        surface->surface.Clear();
+        return factory->ptr->InitVaryingSurface(face_index, &surface->surface);
+    }
+
+    // Initialize the surface of face-varying channel `fvar_channel` of a face.
+    // Its control points index the channel's values rather than the vertices.
+    bool Bfr_SurfaceFactory_InitFaceVaryingSurface(
+        const Bfr_SurfaceFactory_f *factory,
+        int face_index,
+        int fvar_channel,
+        Bfr_Surface_f *surface)
+    {
+        if (!factory || !factory->ptr || !surface) {
+            return false;
+        }
+        if (fvar_channel < 0 || fvar_channel >= factory->ptr->GetNumFVarChannels()) {
+            return false;
+        }
+
+        surface->surface.Clear();
+        return factory->ptr->InitFaceVaryingSurface(
+            face_index, &surface->surface, fvar_channel);
+    }
+
+    // Initialize the vertex surface of a face together with, optionally, its
+    // varying surface and the surface of one face-varying channel, gathering
+    // the face's neighborhood only once. `varying_surface` and
+    // `fvar_surface` may be null.
+    bool Bfr_SurfaceFactory_InitSurfaces(
+        const Bfr_SurfaceFactory_f *factory,
+        int face_index,
+        Bfr_Surface_f *vertex_surface,
+        Bfr_Surface_f *varying_surface,
+        int fvar_channel,
+        Bfr_Surface_f *fvar_surface)
+    {
+        if (!factory || !factory->ptr || !vertex_surface) {
+            return false;
+        }
+        if (fvar_surface &&
+            (fvar_channel < 0 || fvar_channel >= factory->ptr->GetNumFVarChannels())) {
+            return false;
+        }
+
+        const Bfr::SurfaceFactory::FVarID fvar_id = fvar_channel;
+        vertex_surface->surface.Clear();
+        if (varying_surface) {
+            varying_surface->surface.Clear();
+        }
+        if (fvar_surface) {
+            fvar_surface->surface.Clear();
+        }
+        return factory->ptr->InitSurfaces(
+            face_index, &vertex_surface->surface,
+            fvar_surface ? &fvar_surface->surface : nullptr,
+            fvar_surface ? &fvar_id : nullptr, fvar_surface ? 1 : 0,
+            varying_surface ? &varying_surface->surface : nullptr);
+    }
+
+    // Number of face-varying channels of the factory's mesh.
+    int Bfr_SurfaceFactory_GetNumFVarChannels(const Bfr_SurfaceFactory_f *factory)
+    {
+        if (!factory || !factory->ptr) {
+            return 0;
+        }
+        return factory->ptr->GetNumFVarChannels();
+    }
+
     bool Bfr_Surface_IsValid(const Bfr_Surface_f *surface)
     {
         return surface && surface->surface.IsValid();
@@ -93,6 +227,9 @@ extern "C"
     }
 
     // Evaluate position at (u,v) using mesh points with stride 3 floats.
+    //
+    // Gathers the patch points on every call; use Bfr_Surface_PreparePatchPoints
+    // and Bfr_Surface_EvaluatePoints to evaluate many (u,v) per surface.
     bool Bfr_Surface_EvaluatePosition(
         const Bfr_Surface_f *surface,
         float u,
@@ -108,16 +245,23 @@ extern "C"
             return false;
         }
 
-        Bfr::Surface<float>::PointDescriptor mesh_desc(3, mesh_stride);
-        Bfr::Surface<float>::PointDescriptor patch_desc(3);
+        PointDescriptor mesh_desc(3, mesh_stride);
+        PointDescriptor patch_desc(3);
 
-        const int num_patch_pts = surface->surface.GetNumPatchPoints();
-        std::vector<float> patch_points(static_cast<size_t>(num_patch_pts) * 3);
+        const size_t num_floats =
+            static_cast<size_t>(surface->surface.GetNumPatchPoints()) * 3;
+        float stack_points[kStackPatchFloats];
+        std::vector<float> heap_points;
+        float *patch_points = stack_points;
+        if (num_floats > static_cast<size_t>(kStackPatchFloats)) {
+            heap_points.resize(num_floats);
+            patch_points = heap_points.data();
+        }
         surface->surface.PreparePatchPoints(
-            mesh_points, mesh_desc, patch_points.data(), patch_desc);
+            mesh_points, mesh_desc, patch_points, patch_desc);
 
         float uv[2] = {u, v};
-        surface->surface.Evaluate(uv, patch_points.data(), patch_desc, out_p3);
+        surface->surface.Evaluate(uv, patch_points, patch_desc, out_p3);
         return true;
     }
 
@@ -129,6 +273,7 @@ extern "C"
         return surface->surface.GetNumPatchPoints();
     }
 
+    // Gather 3-component patch points straight into `out_patch_points`.
     bool Bfr_Surface_GatherPatchPoints(
         const Bfr_Surface_f *surface,
         const float *mesh_points,
@@ -142,21 +287,110 @@ extern "C"
         if (!surface->surface.IsValid()) {
             return false;
         }
-
-        const int num_patch_pts = surface->surface.GetNumPatchPoints();
-        if (num_patch_pts > max_points) {
+        if (surface->surface.GetNumPatchPoints() > max_points) {
             return false;
         }
 
-        Bfr::Surface<float>::PointDescriptor mesh_desc(3, mesh_stride);
-        Bfr::Surface<float>::PointDescriptor patch_desc(3);
+        surface->surface.PreparePatchPoints(
+            mesh_points, PointDescriptor(3, mesh_stride), out_patch_points,
+            PointDescriptor(3));
+        return true;
+    }
+
+    // Gather `point_size`-component patch points into caller memory.
+    //
+    // Mesh points are read with `mesh_stride`; patch points are written
+    // densely. `out_patch_points` must hold GetNumPatchPoints() points, of
+    // which at most `max_points` are allowed. Fails if the surface references
+    // a control point at or beyond `num_mesh_points`.
+    bool Bfr_Surface_PreparePatchPoints(
+        const Bfr_Surface_f *surface,
+        const float *mesh_points,
+        int num_mesh_points,
+        int point_size,
+        int mesh_stride,
+        float *out_patch_points,
+        int max_points)
+    {
+        if (!surface || !mesh_points || !out_patch_points || point_size <= 0 ||
+            mesh_stride < point_size) {
+            return false;
+        }
+        if (!surface->surface.IsValid() ||
+            surface->surface.GetNumPatchPoints() > max_points) {
+            return false;
+        }
+        if (!controlPointsInRange(surface->surface, num_mesh_points)) {
+            return false;
+        }
 
-        std::vector<float> patch_points(static_cast<size_t>(num_patch_pts) * 3);
         surface->surface.PreparePatchPoints(
-            mesh_points, mesh_desc, patch_points.data(), patch_desc);
+            mesh_points, PointDescriptor(point_size, mesh_stride), out_patch_points,
+            PointDescriptor(point_size));
+        return true;
+    }
+
+    // Evaluate `num_points` (u,v) pairs from prepared patch points.
+    //
+    // Every non-null output buffer receives one `point_size` element per
+    // point at `dst_desc.offset + i * dst_desc.stride`. Outputs that are not
+    // requested are written to per-call scratch, so nothing is allocated per
+    // point; second derivatives are only computed when one is requested.
+    bool Bfr_Surface_EvaluatePoints(
+        const Bfr_Surface_f *surface,
+        const float *patch_points,
+        int point_size,
+        int num_points,
+        const float *u,
+        const float *v,
+        float *dst_p,
+        float *dst_du,
+        float *dst_dv,
+        float *dst_duu,
+        float *dst_duv,
+        float *dst_dvv,
+        Osd::BufferDescriptor dst_desc)
+    {
+        if (!surface || !patch_points || point_size <= 0 || num_points < 0) {
+            return false;
+        }
+        if (num_points > 0 && !(u && v)) {
+            return false;
+        }
+        if (!surface->surface.IsValid() || !dst_desc.IsValid() ||
+            dst_desc.length != point_size) {
+            return false;
+        }
+
+        const bool second = dst_duu || dst_duv || dst_dvv;
+        const bool first = second || dst_du || dst_dv;
+        const PointDescriptor patch_desc(point_size);
 
-        std::memcpy(
-            out_patch_points, patch_points.data(), patch_points.size() * sizeof(float));
+        std::vector<float> scratch(static_cast<size_t>(point_size) * 6);
+        float *outputs[6] = {dst_p, dst_du, dst_dv, dst_duu, dst_duv, dst_dvv};
+
+        for (int i = 0; i < num_points; ++i) {
+            const size_t offset =
+                dst_desc.offset + static_cast<size_t>(i) * dst_desc.stride;
+            float *out[6];
+            for (int k = 0; k < 6; ++k) {
+                out[k] = outputs[k]
+                    ? outputs[k] + offset
+                    : scratch.data() + static_cast<size_t>(k) * point_size;
+            }
+
+            const float uv[2] = {u[i], v[i]};
+            if (second) {
+                surface->surface.Evaluate(
+                    uv, patch_points, patch_desc, out[0], out[1], out[2], out[3],
+                    out[4], out[5]);
+            } else if (first) {
+                surface->surface.Evaluate(
+                    uv, patch_points, patch_desc, out[0], out[1], out[2]);
+            } else {
+                surface->surface.Evaluate(uv, patch_points, patch_desc, out[0]);
+            }
+        }
         return true;
     }
 }
@@ -0,0 +1,183 @@
+// C API shim for tessellating Bfr surfaces with Bfr::Tessellation.
+#include "surface.hpp"
+
+#include <opensubdiv/bfr/parameterization.h>
+#include <opensubdiv/bfr/tessellation.h>
+#include <opensubdiv/far/topologyLevel.h>
+#include <opensubdiv/far/topologyRefiner.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+using namespace OpenSubdiv;          // NOLINT
+using namespace OPENSUBDIV_VERSION;  // NOLINT
+
+typedef Bfr::Surface<float>::PointDescriptor PointDescriptor;
+
+static Bfr::Tessellation::Options tessellationOptions(int facetSize)
+{
+    Bfr::Tessellation::Options options;
+    options.SetFacetSize(facetSize);
+    options.PreserveQuads(facetSize == 4);
+    return options;
+}
+
+static bool validRates(int numRates, const int *rates, int facetSize)
+{
+    if (numRates <= 0 || !rates || (facetSize != 3 && facetSize != 4)) {
+        return false;
+    }
+    for (int i = 0; i < numRates; ++i) {
+        if (rates[i] < 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Writes the normalized cross product of `du` and `dv`, or zero if the
+/// tangents are degenerate.
+static void writeNormal(const float du[3], const float dv[3], float *n)
+{
+    const float x = du[1] * dv[2] - du[2] * dv[1];
+    const float y = du[2] * dv[0] - du[0] * dv[2];
+    const float z = du[0] * dv[1] - du[1] * dv[0];
+    const float len = std::sqrt(x * x + y * y + z * z);
+    const float scale = len > 0.0f ? 1.0f / len : 0.0f;
+    n[0] = x * scale;
+    n[1] = y * scale;
+    n[2] = z * scale;
+}
+
+static void evaluateCoord(
+    Bfr::Surface<float> const &surface,
+    const float *uv,
+    const float *patchPoints,
+    float *dstPoint,
+    float *dstNormal)
+{
+    const PointDescriptor desc(3);
+    if (dstNormal) {
+        float du[3], dv[3];
+        surface.Evaluate(uv, patchPoints, desc, dstPoint, du, dv);
+        writeNormal(du, dv, dstNormal);
+    } else {
+        surface.Evaluate(uv, patchPoints, desc, dstPoint);
+    }
+}
+
+extern "C"
+{
+
+    // Whether `face` has a limit surface (i.e. is not a hole).
+    bool Bfr_SurfaceFactory_FaceHasLimitSurface(
+        const Bfr_SurfaceFactory_f *factory, int face)
+    {
+        return factory && factory->ptr && factory->ptr->FaceHasLimitSurface(face);
+    }
+
+    // Count the coordinates and facets tessellating `face` at `rates` would
+    // produce, without building its surface.
+    //
+    // `rates` holds one rate per face edge, optionally followed by an
+    // interior rate. `facetSize` is 3 (triangles) or 4 (quads).
+    bool Bfr_SurfaceFactory_GetTessellationCounts(
+        const Bfr_SurfaceFactory_f *factory,
+        int face,
+        int numRates,
+        const int *rates,
+        int facetSize,
+        int *numBoundaryCoords,
+        int *numInteriorCoords,
+        int *numFacets)
+    {
+        if (!factory || !factory->ptr || !numBoundaryCoords || !numInteriorCoords ||
+            !numFacets || !validRates(numRates, rates, facetSize)) {
+            return false;
+        }
+
+        const Far::TopologyRefiner &mesh = factory->ptr->GetMesh();
+        if (face < 0 || face >= mesh.GetLevel(0).GetNumFaces()) {
+            return false;
+        }
+        const Bfr::Parameterization param(
+            mesh.GetSchemeType(), mesh.GetLevel(0).GetFaceVertices(face).size());
+        if (!param.IsValid()) {
+            return false;
+        }
+
+        const Bfr::Tessellation tess(
+            param, numRates, rates, tessellationOptions(facetSize));
+        if (!tess.IsValid()) {
+            return false;
+        }
+        *numBoundaryCoords = tess.GetNumBoundaryCoords();
+        *numInteriorCoords = tess.GetNumInteriorCoords();
+        *numFacets = tess.GetNumFacets();
+        return true;
+    }
+
+    // Tessellate a prepared 3-component surface into shared mesh buffers.
+    //
+    // Boundary coordinate `i` becomes mesh point `boundaryIndices[i]` and is
+    // only evaluated if `boundaryOwned[i]` is set, so points on edges and
+    // vertices shared with other faces are written exactly once. Interior
+    // coordinates are written from mesh point `interiorOffset` on. Facets go
+    // to `dstFacets` with mesh point indices; unused quad corners are -1.
+    // `dstNormals` may be null.
+    bool Bfr_Surface_Tessellate(
+        const Bfr_Surface_f *surface,
+        const float *patchPoints,
+        int numRates,
+        const int *rates,
+        int facetSize,
+        const int *boundaryIndices,
+        const unsigned char *boundaryOwned,
+        int numBoundaryCoords,
+        int interiorOffset,
+        float *dstPoints,
+        float *dstNormals,
+        int *dstFacets)
+    {
+        if (!surface || !patchPoints || !boundaryIndices || !boundaryOwned ||
+            !dstPoints || !dstFacets || !validRates(numRates, rates, facetSize)) {
+            return false;
+        }
+        if (!surface->surface.IsValid()) {
+            return false;
+        }
+
+        Bfr::Tessellation tess(
+            surface->surface.GetParameterization(), numRates, rates,
+            tessellationOptions(facetSize));
+        if (!tess.IsValid() || tess.GetNumBoundaryCoords() != numBoundaryCoords) {
+            return false;
+        }
+
+        std::vector<float> uvs(static_cast<size_t>(tess.GetNumCoords()) * 2);
+        tess.GetBoundaryCoords(uvs.data());
+        tess.GetInteriorCoords(uvs.data() + static_cast<size_t>(numBoundaryCoords) * 2);
+
+        for (int i = 0; i < numBoundaryCoords; ++i) {
+            if (boundaryOwned[i]) {
+                const size_t dst = static_cast<size_t>(boundaryIndices[i]) * 3;
+                evaluateCoord(
+                    surface->surface, &uvs[static_cast<size_t>(i) * 2], patchPoints,
+                    dstPoints + dst, dstNormals ? dstNormals + dst : nullptr);
+            }
+        }
+        for (int i = 0; i < tess.GetNumInteriorCoords(); ++i) {
+            const size_t src = static_cast<size_t>(numBoundaryCoords + i) * 2;
+            const size_t dst = static_cast<size_t>(interiorOffset + i) * 3;
+            evaluateCoord(
+                surface->surface, &uvs[src], patchPoints, dstPoints + dst,
+                dstNormals ? dstNormals + dst : nullptr);
+        }
+
+        tess.GetFacets(dstFacets);
+        tess.TransformFacetCoordIndices(dstFacets, boundaryIndices, interiorOffset);
+        return true;
+    }
+
+}  // extern "C"
@@ -1,15 +1,21 @@
 #include <opensubdiv/far/patchTable.h>
+#include <opensubdiv/far/patchTableFactory.h>
 #include <opensubdiv/far/stencilTable.h>
 #include <opensubdiv/far/stencilTableFactory.h>
+#include <opensubdiv/far/topologyRefiner.h>
 #include <vector>
 
 #include "../vtr/types.hpp"
 
+typedef OpenSubdiv::Vtr::Index Index;
+
 typedef OpenSubdiv::Far::LimitStencilTable LimitStencilTable;
 typedef OpenSubdiv::Far::LimitStencilTableFactory LimitStencilTableFactory;
 typedef OpenSubdiv::Far::StencilTable StencilTable;
 typedef OpenSubdiv::Far::TopologyRefiner TopologyRefiner;
 typedef OpenSubdiv::Far::PatchTable PatchTable;
+typedef OpenSubdiv::Far::PatchTableFactory PatchTableFactory;
+typedef OpenSubdiv::Far::StencilTableFactory StencilTableFactory;
 
 /// Flat FFI-safe replacement for C++ LocationArray.
 struct LocationArrayDesc
@@ -20,9 +26,175 @@ struct LocationArrayDesc
     const float *t;
 };
 
+/// `Far::LimitStencilTable` only exposes its array constructor to subclasses.
+class ArrayLimitStencilTable : public LimitStencilTable
+{
+public:
+    ArrayLimitStencilTable(
+        int numControlVerts,
+        std::vector<int> const &offsets,
+        std::vector<int> const &sizes,
+        std::vector<int> const &sources,
+        std::vector<float> const &weights,
+        std::vector<float> const &duWeights,
+        std::vector<float> const &dvWeights,
+        std::vector<float> const &duuWeights,
+        std::vector<float> const &duvWeights,
+        std::vector<float> const &dvvWeights)
+        : LimitStencilTable(
+              numControlVerts,
+              offsets,
+              sizes,
+              sources,
+              weights,
+              duWeights,
+              dvWeights,
+              duuWeights,
+              duvWeights,
+              dvvWeights,
+              false,
+              0)
+    {
+    }
+
+    /// Joins `num_tables` tables, keeping the order of their stencils.
+    ///
+    /// Fills the arrays in place to hold each weight only once more. Returns
+    /// null if the tables differ in their control vertices or derivatives.
+    static ArrayLimitStencilTable *Concatenate(
+        const LimitStencilTable *const *tables, int num_tables)
+    {
+        if (num_tables <= 0 || !tables) {
+            return nullptr;
+        }
+
+        const LimitStencilTable &first = *tables[0];
+        size_t num_stencils = 0;
+        size_t num_weights = 0;
+        for (int i = 0; i < num_tables; ++i) {
+            const LimitStencilTable &table = *tables[i];
+            if (table.GetNumControlVertices() != first.GetNumControlVertices() ||
+                table.GetDuWeights().empty() != first.GetDuWeights().empty() ||
+                table.GetDuuWeights().empty() != first.GetDuuWeights().empty()) {
+                return nullptr;
+            }
+            num_stencils += table.GetNumStencils();
+            num_weights += table.GetWeights().size();
+        }
+
+        std::vector<int> none;
+        std::vector<float> noWeights;
+        ArrayLimitStencilTable *joined = new ArrayLimitStencilTable(
+            first.GetNumControlVertices(), none, none, none, noWeights, noWeights, noWeights,
+            noWeights, noWeights, noWeights);
+
+        joined->_sizes.reserve(num_stencils);
+        joined->_offsets.reserve(num_stencils);
+        joined->_indices.reserve(num_weights);
+        joined->_weights.reserve(num_weights);
+        for (int i = 0; i < num_tables; ++i) {
+            const LimitStencilTable &table = *tables[i];
+            Index const base = (Index)joined->_indices.size();
+            for (Index offset : table.GetOffsets()) {
+                joined->_offsets.push_back(base + offset);
+            }
+            append(joined->_sizes, table.GetSizes());
+            append(joined->_indices, table.GetControlIndices());
+            append(joined->_weights, table.GetWeights());
+            append(joined->_duWeights, table.GetDuWeights());
+            append(joined->_dvWeights, table.GetDvWeights());
+            append(joined->_duuWeights, table.GetDuuWeights());
+            append(joined->_duvWeights, table.GetDuvWeights());
+            append(joined->_dvvWeights, table.GetDvvWeights());
+        }
+        return joined;
+    }
+
+private:
+    template <typename T>
+    static void append(std::vector<T> &dst, std::vector<T> const &src)
+    {
+        dst.insert(dst.end(), src.begin(), src.end());
+    }
+};
+
+/// Copies `count` weights, or none if `weights` is null.
+static std::vector<float> weightVector(const float *weights, int count)
+{
+    return weights ? std::vector<float>(weights, weights + count) : std::vector<float>();
+}
+
+/// Unpacks the factory options passed as a bitfield.
+///
+/// `options_bitfield` layout: [1:0] interpolationMode, [2] generate1stDerivatives,
+/// [3] generate2ndDerivatives.
+static LimitStencilTableFactory::Options factoryOptions(
+    unsigned int options_bitfield, unsigned int fvar_channel)
+{
+    LimitStencilTableFactory::Options options;
+    options.interpolationMode = options_bitfield & 0x3;
+    options.generate1stDerivatives = (options_bitfield >> 2) & 0x1;
+    options.generate2ndDerivatives = (options_bitfield >> 3) & 0x1;
+    options.fvarChannel = fvar_channel;
+    return options;
+}
+
 extern "C"
 {
 
+    /// \brief Create a limit stencil table from `num_stencils` sizes and the
+    /// concatenated indices and weights of the stencils
+    ///
+    /// Each derivative weight array may be null, in which case the table has
+    /// no such weights. Returns null if a size is negative or an index is not
+    /// one of `num_control_vertices` control vertices.
+    const LimitStencilTable *LimitStencilTable_CreateFromArrays(
+        int num_control_vertices,
+        int num_stencils,
+        const int *sizes,
+        const Index *indices,
+        const float *weights,
+        const float *du_weights,
+        const float *dv_weights,
+        const float *duu_weights,
+        const float *duv_weights,
+        const float *dvv_weights)
+    {
+        if (num_control_vertices < 0 || num_stencils < 0 || (num_stencils > 0 && !sizes)) {
+            return nullptr;
+        }
+
+        std::vector<int> offsets(num_stencils);
+        int num_weights = 0;
+        for (int i = 0; i < num_stencils; ++i) {
+            if (sizes[i] < 0) {
+                return nullptr;
+            }
+            offsets[i] = num_weights;
+            num_weights += sizes[i];
+        }
+        if (num_weights > 0 && (!indices || !weights)) {
+            return nullptr;
+        }
+        for (int i = 0; i < num_weights; ++i) {
+            if (indices[i] < 0 || indices[i] >= num_control_vertices) {
+                return nullptr;
+            }
+        }
+
+        return new ArrayLimitStencilTable(
+            num_control_vertices,
+            offsets,
+            std::vector<int>(sizes, sizes + num_stencils),
+            std::vector<int>(indices, indices + num_weights),
+            std::vector<float>(weights, weights + num_weights),
+            weightVector(du_weights, num_weights),
+            weightVector(dv_weights, num_weights),
+            weightVector(duu_weights, num_weights),
+            weightVector(duv_weights, num_weights),
+            weightVector(dvv_weights, num_weights));
+    }
+
     void LimitStencilTable_destroy(const LimitStencilTable *table)
     {
         delete table;
@@ -88,15 +260,105 @@ extern "C"
             locations[i].t = location_descs[i].t;
         }
 
-        // Unpack bitfield into Options.
-        LimitStencilTableFactory::Options options;
-        options.interpolationMode = options_bitfield & 0x3;
-        options.generate1stDerivatives = (options_bitfield >> 2) & 0x1;
-        options.generate2ndDerivatives = (options_bitfield >> 3) & 0x1;
-        options.fvarChannel = fvar_channel;
-
         return LimitStencilTableFactory::Create(
-            *refiner, locations, cv_stencils, patch_table, options);
+            *refiner, locations, cv_stencils, patch_table,
+            factoryOptions(options_bitfield, fvar_channel));
+    }
+
+    /// \brief Build the control vertex stencils and the patch table
+    /// LimitStencilTableFactory_Create() builds when passed null
+    ///
+    /// Passing both to several calls shares them, e.g. between location
+    /// chunks built concurrently. The stencils include the local points of
+    /// the patch table, as the factory requires of caller-provided stencils.
+    /// Returns false, with both outputs null, on failure.
+    bool LimitStencilTableFactory_CreateSupport(
+        const TopologyRefiner *refiner,
+        unsigned int options_bitfield,
+        unsigned int fvar_channel,
+        const StencilTable **cv_stencils,
+        PatchTable **patch_table)
+    {
+        *cv_stencils = nullptr;
+        *patch_table = nullptr;
+
+        LimitStencilTableFactory::Options const options =
+            factoryOptions(options_bitfield, fvar_channel);
+        int const mode = options.interpolationMode;
+        bool const uniform = refiner->IsUniform();
+        int fvarChannel = options.fvarChannel;
+
+        // Mirrors the defaults of LimitStencilTableFactory::Create().
+        StencilTableFactory::Options stencilOptions;
+        stencilOptions.generateIntermediateLevels = !uniform;
+        stencilOptions.generateControlVerts = true;
+        stencilOptions.generateOffsets = true;
+        stencilOptions.interpolationMode = mode;
+        stencilOptions.fvarChannel = fvarChannel;
+        const StencilTable *stencils = StencilTableFactory::Create(*refiner, stencilOptions);
+        if (!stencils) {
+            return false;
+        }
+
+        PatchTableFactory::Options patchOptions;
+        patchOptions.SetEndCapType(PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+        patchOptions.useInfSharpPatch =
+            !uniform && refiner->GetAdaptiveOptions().useInfSharpPatch;
+        patchOptions.generateVaryingTables = mode == StencilTableFactory::INTERPOLATE_VARYING;
+        patchOptions.generateFVarTables = mode == StencilTableFactory::INTERPOLATE_FACE_VARYING;
+        if (patchOptions.generateFVarTables) {
+            patchOptions.numFVarChannels = 1;
+            patchOptions.fvarChannelIndices = &fvarChannel;
+        }
+        PatchTable *patches = PatchTableFactory::Create(*refiner, patchOptions);
+        if (!patches) {
+            delete stencils;
+            return false;
+        }
+
+        const StencilTable *local = nullptr;
+        const StencilTable *appended = nullptr;
+        switch (mode) {
+        case StencilTableFactory::INTERPOLATE_VARYING:
+            local = patches->GetLocalPointVaryingStencilTable();
+            if (local) {
+                appended = StencilTableFactory::AppendLocalPointStencilTableVarying(
+                    *refiner, stencils, local);
+            }
+            break;
+        case StencilTableFactory::INTERPOLATE_FACE_VARYING:
+            local = patches->GetLocalPointFaceVaryingStencilTable(0);
+            if (local) {
+                appended = StencilTableFactory::AppendLocalPointStencilTableFaceVarying(
+                    *refiner, stencils, local, fvarChannel);
+            }
+            break;
+        default:
+            local = patches->GetLocalPointStencilTable();
+            if (local) {
+                appended =
+                    StencilTableFactory::AppendLocalPointStencilTable(*refiner, stencils, local);
+            }
+            break;
+        }
+        if (appended) {
+            delete stencils;
+            stencils = appended;
+        }
+
+        *cv_stencils = stencils;
+        *patch_table = patches;
+        return true;
+    }
+
+    /// \brief Concatenate `num_tables` limit stencil tables into one
+    ///
+    /// The stencils keep their order. Returns null if there are no tables or
+    /// they differ in their control vertices or derivative weights.
+    const LimitStencilTable *LimitStencilTable_Concatenate(
+        const LimitStencilTable *const *tables, int num_tables)
+    {
+        return ArrayLimitStencilTable::Concatenate(tables, num_tables);
     }
 
 }  // extern "C"
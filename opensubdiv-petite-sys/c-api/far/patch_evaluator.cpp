@@ -2,11 +2,20 @@
 #include <opensubdiv/far/patchDescriptor.h>
 #include <opensubdiv/far/patchMap.h>
 #include <opensubdiv/far/patchTable.h>
+#include <opensubdiv/osd/bufferDescriptor.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
 #include <vector>
 
 typedef OpenSubdiv::Far::PatchTable PatchTable;
+typedef OpenSubdiv::Far::PatchTable::PatchHandle PatchHandle;
 typedef OpenSubdiv::Far::PatchMap PatchMap;
 typedef OpenSubdiv::Far::PatchParam PatchParam;
+typedef OpenSubdiv::Far::PatchDescriptor PatchDescriptor;
+typedef OpenSubdiv::Far::Index Index;
+typedef OpenSubdiv::Osd::BufferDescriptor BufferDescriptor;
 
 // Structure to hold evaluation results
 struct PatchEvalResult
@@ -19,10 +28,350 @@ struct PatchEvalResult
     float dvv[3];
 };
 
+/// Returns whether `Far::PatchTable::EvaluateBasis()` supports `type`.
+///
+/// Legacy Gregory patches (GREGORY, GREGORY_BOUNDARY, GREGORY_CORNER) have
+/// no basis evaluation in Far.
+static bool isEvaluable(PatchDescriptor::Type type)
+{
+    switch (type) {
+    case PatchDescriptor::QUADS:
+    case PatchDescriptor::TRIANGLES:
+    case PatchDescriptor::LOOP:
+    case PatchDescriptor::REGULAR:
+    case PatchDescriptor::GREGORY_BASIS:
+    case PatchDescriptor::GREGORY_TRIANGLE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// Resolves a table-global patch index into a handle.
+///
+/// Walks the patch arrays, so this is O(numArrays). Callers that evaluate
+/// many points should resolve handles once and use the handle entry points.
+static bool findPatchHandle(
+    const PatchTable *table, int patchIndex, PatchHandle *handle)
+{
+    if (patchIndex < 0 || patchIndex >= table->GetNumPatchesTotal()) {
+        return false;
+    }
+
+    int localPatchIndex = patchIndex;
+    int vertIndex = 0;
+    for (int i = 0; i < table->GetNumPatchArrays(); ++i) {
+        const int numPatches = table->GetNumPatches(i);
+        const int numCVs = table->GetPatchArrayDescriptor(i).GetNumControlVertices();
+        if (localPatchIndex < numPatches) {
+            handle->arrayIndex = i;
+            handle->patchIndex = patchIndex;
+            handle->vertIndex = vertIndex + localPatchIndex * numCVs;
+            return true;
+        }
+        localPatchIndex -= numPatches;
+        vertIndex += numPatches * numCVs;
+    }
+    return false;
+}
+
+/// Evaluates basis weights via `Far::PatchTable::EvaluateBasis()`.
+///
+/// `u`, `v` are face (ptex) coordinates; the patch's `PatchParam` maps them
+/// into the patch, applies boundary masks and scales derivatives. `wDu`/`wDv`
+/// must both be given or both be null; second derivatives require first
+/// derivatives and must all be given or all be null.
+static bool evaluateBasis(
+    const PatchTable *table,
+    const PatchHandle &handle,
+    float u,
+    float v,
+    float *wP,
+    float *wDu,
+    float *wDv,
+    float *wDuu,
+    float *wDuv,
+    float *wDvv)
+{
+    if (!wP || (!wDu != !wDv)) {
+        return false;
+    }
+    const bool second = wDuu || wDuv || wDvv;
+    if (second && !(wDu && wDuu && wDuv && wDvv)) {
+        return false;
+    }
+    if (handle.arrayIndex < 0 || handle.arrayIndex >= table->GetNumPatchArrays() ||
+        handle.patchIndex < 0 || handle.patchIndex >= table->GetNumPatchesTotal()) {
+        return false;
+    }
+    if (!isEvaluable(table->GetPatchArrayDescriptor(handle.arrayIndex).GetType())) {
+        return false;
+    }
+
+    table->EvaluateBasis(handle, u, v, wP, wDu, wDv, wDuu, wDuv, wDvv);
+    return true;
+}
+
+/// Maximum number of control vertices of any evaluable patch (GREGORY_BASIS).
+static const int kMaxPatchCVs = 20;
+
+/// Resolves table-global patch indices to handles in O(log numArrays).
+///
+/// Built once per batch call so per-point lookups do not walk the arrays.
+class PatchHandleLookup
+{
+  public:
+    explicit PatchHandleLookup(const PatchTable *table)
+    {
+        const int numArrays = table->GetNumPatchArrays();
+        _firstPatch.reserve(numArrays + 1);
+        _firstVertex.reserve(numArrays);
+        _numCVs.reserve(numArrays);
+
+        int firstPatch = 0;
+        int firstVertex = 0;
+        for (int i = 0; i < numArrays; ++i) {
+            const int numPatches = table->GetNumPatches(i);
+            const int numCVs =
+                table->GetPatchArrayDescriptor(i).GetNumControlVertices();
+            _firstPatch.push_back(firstPatch);
+            _firstVertex.push_back(firstVertex);
+            _numCVs.push_back(numCVs);
+            firstPatch += numPatches;
+            firstVertex += numPatches * numCVs;
+        }
+        _firstPatch.push_back(firstPatch);
+    }
+
+    bool Find(int patchIndex, PatchHandle *handle) const
+    {
+        if (patchIndex < 0 || patchIndex >= _firstPatch.back()) {
+            return false;
+        }
+        // First array whose start is past the patch, minus one.
+        const int array = static_cast<int>(
+            std::upper_bound(_firstPatch.begin(), _firstPatch.end(), patchIndex) -
+            _firstPatch.begin()) - 1;
+        handle->arrayIndex = array;
+        handle->patchIndex = patchIndex;
+        handle->vertIndex =
+            _firstVertex[array] + (patchIndex - _firstPatch[array]) * _numCVs[array];
+        return true;
+    }
+
+  private:
+    std::vector<int> _firstPatch;
+    std::vector<int> _firstVertex;
+    std::vector<int> _numCVs;
+};
+
+/// Basis weights of one patch evaluation, kept on the stack.
+struct PatchWeights
+{
+    float p[kMaxPatchCVs];
+    float du[kMaxPatchCVs];
+    float dv[kMaxPatchCVs];
+    float duu[kMaxPatchCVs];
+    float duv[kMaxPatchCVs];
+    float dvv[kMaxPatchCVs];
+};
+
+/// Output buffers of a batched evaluation. Any buffer may be null.
+struct PatchEvalBuffers
+{
+    float *p;
+    float *du;
+    float *dv;
+    float *duu;
+    float *duv;
+    float *dvv;
+};
+
+/// Writes `sum_j weights[j] * src[cvs[j]]` into `dst`.
+template <int N>
+static void combineFixed(
+    const float *weights,
+    const Index *cvs,
+    int numCVs,
+    const float *src,
+    int srcStride,
+    float *dst)
+{
+    float acc[N] = {};
+    for (int j = 0; j < numCVs; ++j) {
+        const float *s = src + static_cast<size_t>(cvs[j]) * srcStride;
+        const float w = weights[j];
+        for (int k = 0; k < N; ++k) {
+            acc[k] += s[k] * w;
+        }
+    }
+    for (int k = 0; k < N; ++k) {
+        dst[k] = acc[k];
+    }
+}
+
+static void combine(
+    const float *weights,
+    const Index *cvs,
+    int numCVs,
+    const float *src,
+    BufferDescriptor const &srcDesc,
+    float *dst)
+{
+    src += srcDesc.offset;
+    switch (srcDesc.length) {
+    case 1:
+        combineFixed<1>(weights, cvs, numCVs, src, srcDesc.stride, dst);
+        break;
+    case 2:
+        combineFixed<2>(weights, cvs, numCVs, src, srcDesc.stride, dst);
+        break;
+    case 3:
+        combineFixed<3>(weights, cvs, numCVs, src, srcDesc.stride, dst);
+        break;
+    case 4:
+        combineFixed<4>(weights, cvs, numCVs, src, srcDesc.stride, dst);
+        break;
+    default:
+        for (int k = 0; k < srcDesc.length; ++k) {
+            dst[k] = 0.0f;
+        }
+        for (int j = 0; j < numCVs; ++j) {
+            const float *s = src + static_cast<size_t>(cvs[j]) * srcDesc.stride;
+            for (int k = 0; k < srcDesc.length; ++k) {
+                dst[k] += s[k] * weights[j];
+            }
+        }
+        break;
+    }
+}
+
+static void fill(float *dst, int length, float value)
+{
+    for (int k = 0; k < length; ++k) {
+        dst[k] = value;
+    }
+}
+
+// AIDEV-NOTE: Batched patch evaluation core.
+// Each point computes its basis weights into a stack-resident PatchWeights
+// (at most 6 x 20 floats), so the weights never leave L1 before they are
+// combined with the control points; nothing is allocated per point. Points
+// whose handle cannot be resolved, or whose patch type has no basis, have
+// every requested output filled with NaN and are not counted.
+template <class HANDLE_FN>
+static int evaluatePoints(
+    const PatchTable *table,
+    int numPoints,
+    HANDLE_FN findHandle,
+    const float *u,
+    const float *v,
+    const float *src,
+    BufferDescriptor const &srcDesc,
+    PatchEvalBuffers const &dst,
+    BufferDescriptor const &dstDesc)
+{
+    const bool first = dst.du || dst.dv;
+    const bool second = dst.duu || dst.duv || dst.dvv;
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    PatchWeights w;
+    int evaluated = 0;
+    for (int i = 0; i < numPoints; ++i) {
+        const size_t dstOffset =
+            dstDesc.offset + static_cast<size_t>(i) * dstDesc.stride;
+
+        PatchHandle handle;
+        const bool found = findHandle(i, &handle);
+        const bool ok = found &&
+            evaluateBasis(
+                table, handle, u[i], v[i], w.p, (first || second) ? w.du : nullptr,
+                (first || second) ? w.dv : nullptr, second ? w.duu : nullptr,
+                second ? w.duv : nullptr, second ? w.dvv : nullptr);
+
+        float *outputs[6] = {dst.p, dst.du, dst.dv, dst.duu, dst.duv, dst.dvv};
+        const float *weights[6] = {w.p, w.du, w.dv, w.duu, w.duv, w.dvv};
+
+        if (!ok) {
+            for (int k = 0; k < 6; ++k) {
+                if (outputs[k]) {
+                    fill(outputs[k] + dstOffset, dstDesc.length, nan);
+                }
+            }
+            continue;
+        }
+
+        const OpenSubdiv::Far::ConstIndexArray cvs = table->GetPatchVertices(handle);
+        for (int k = 0; k < 6; ++k) {
+            if (outputs[k]) {
+                combine(
+                    weights[k], &cvs[0], cvs.size(), src, srcDesc,
+                    outputs[k] + dstOffset);
+            }
+        }
+        ++evaluated;
+    }
+    return evaluated;
+}
+
+/// Locates face coordinates `(u, v)` of `face` and converts them to the
+/// found patch's normalized coordinates using its `PatchParam`.
+///
+/// `patchU`/`patchV` may be null when only the patch index is needed.
+static bool locatePatch(
+    const PatchTable *table,
+    const PatchMap *map,
+    int face,
+    float u,
+    float v,
+    int *patchIndex,
+    float *patchU,
+    float *patchV)
+{
+    const PatchHandle *handle = map->FindPatch(face, u, v);
+    if (!handle) {
+        return false;
+    }
+
+    *patchIndex = handle->patchIndex;
+    if (patchU && patchV) {
+        const PatchParam param = table->GetPatchParam(*handle);
+        switch (table->GetPatchArrayDescriptor(handle->arrayIndex).GetType()) {
+        case PatchDescriptor::TRIANGLES:
+        case PatchDescriptor::LOOP:
+        case PatchDescriptor::GREGORY_TRIANGLE:
+            param.NormalizeTriangle(u, v);
+            break;
+        default:
+            param.Normalize(u, v);
+            break;
+        }
+        *patchU = u;
+        *patchV = v;
+    }
+    return true;
+}
+
+/// Validates the common arguments of the batched entry points.
+static bool validBatch(
+    const PatchTable *table,
+    int numPoints,
+    const void *locations,
+    const float *u,
+    const float *v,
+    const float *src,
+    BufferDescriptor const &srcDesc,
+    BufferDescriptor const &dstDesc)
+{
+    return table && numPoints >= 0 &&
+        (numPoints == 0 || (locations && u && v && src)) && srcDesc.IsValid() &&
+        dstDesc.IsValid() && srcDesc.length == dstDesc.length;
+}
+
 extern "C"
 {
 
-    // Evaluate a patch at given parametric coordinates
+    // Evaluate a patch's basis weights at given face coordinates
     bool PatchTable_EvaluateBasis(
         const PatchTable *table,
         int patchIndex,
@@ -36,79 +385,33 @@ extern "C"
         float *wDvv   // [out] weights for dvv derivative (optional, can be null)
     )
     {
-        if (!table || patchIndex < 0 || patchIndex >= table->GetNumPatchesTotal()) {
+        PatchHandle handle;
+        if (!table || !findPatchHandle(table, patchIndex, &handle)) {
             return false;
         }
+        return evaluateBasis(table, handle, u, v, wP, wDu, wDv, wDuu, wDuv, wDvv);
+    }
 
-        // Get patch array and local patch index
-        int patchArray = 0;
-        int localPatchIndex = patchIndex;
-        for (int i = 0; i < table->GetNumPatchArrays(); ++i) {
-            int numPatches = table->GetNumPatches(i);
-            if (localPatchIndex < numPatches) {
-                patchArray = i;
-                break;
-            }
-            localPatchIndex -= numPatches;
-        }
-
-        // Get patch descriptor
-        auto desc = table->GetPatchArrayDescriptor(patchArray);
-        int numControlVerts = desc.GetNumControlVertices();
-
-        // Get patch param
-        PatchParam param = table->GetPatchParam(patchArray, localPatchIndex);
-
-        // Normalize coordinates
-        param.Normalize(u, v);
-
-        // Evaluate basis functions based on patch type
-        typedef OpenSubdiv::Far::PatchDescriptor Descriptor;
-
-        if (desc.GetType() == Descriptor::REGULAR) {
-            // Regular B-spline patch - cubic B-spline basis
-
-            // Simplified cubic B-spline basis evaluation
-            // This is a placeholder - proper implementation would use OpenSubdiv's
-            // basis functions
-            if (wP) {
-                // Initialize weights to uniform values for now
-                float w = 1.0f / numControlVerts;
-                for (int i = 0; i < numControlVerts; ++i) {
-                    wP[i] = w;
-                }
-            }
-
-            // Zero out derivative weights if requested
-            if (wDu) {
-                for (int i = 0; i < numControlVerts; ++i)
-                    wDu[i] = 0.0f;
-            }
-            if (wDv) {
-                for (int i = 0; i < numControlVerts; ++i)
-                    wDv[i] = 0.0f;
-            }
-            if (wDuu) {
-                for (int i = 0; i < numControlVerts; ++i)
-                    wDuu[i] = 0.0f;
-            }
-            if (wDuv) {
-                for (int i = 0; i < numControlVerts; ++i)
-                    wDuv[i] = 0.0f;
-            }
-            if (wDvv) {
-                for (int i = 0; i < numControlVerts; ++i)
-                    wDvv[i] = 0.0f;
-            }
-
-            return true;
+    // Evaluate a patch's basis weights for an already resolved handle (O(1))
+    bool PatchTable_EvaluateBasisHandle(
+        const PatchTable *table,
+        const PatchHandle *handle,
+        float u,
+        float v,
+        float *wP,
+        float *wDu,
+        float *wDv,
+        float *wDuu,
+        float *wDuv,
+        float *wDvv)
+    {
+        if (!table || !handle) {
+            return false;
         }
-
-        // Other patch types not implemented yet
-        return false;
+        return evaluateBasis(table, *handle, u, v, wP, wDu, wDv, wDuu, wDuv, wDvv);
     }
 
-    // Helper function to evaluate patch and apply to control points
+    // Evaluate a single point from `numControlPoints` xyz control points
     bool PatchTable_EvaluatePoint(
         const PatchTable *table,
         int patchIndex,
@@ -118,78 +421,109 @@ extern "C"
         int numControlPoints,
         PatchEvalResult *result)
     {
-        if (!table || !controlPoints || !result) {
+        PatchHandle handle;
+        if (!table || !controlPoints || !result ||
+            !findPatchHandle(table, patchIndex, &handle)) {
             return false;
         }
 
-        // Get total patches
-        int totalPatches = table->GetNumPatchesTotal();
-        if (patchIndex < 0 || patchIndex >= totalPatches) {
+        PatchWeights w;
+        if (!evaluateBasis(table, handle, u, v, w.p, w.du, w.dv, w.duu, w.duv, w.dvv)) {
             return false;
         }
 
-        // Find which array this patch belongs to
-        int patchArray = 0;
-        int localPatchIndex = patchIndex;
-
-        for (int i = 0; i < table->GetNumPatchArrays(); ++i) {
-            int numPatches = table->GetNumPatches(i);
-            if (localPatchIndex < numPatches) {
-                patchArray = i;
-                break;
+        const OpenSubdiv::Far::ConstIndexArray cvs = table->GetPatchVertices(handle);
+        for (int cv = 0; cv < cvs.size(); ++cv) {
+            if (cvs[cv] < 0 || cvs[cv] >= numControlPoints) {
+                return false;
             }
-            localPatchIndex -= numPatches;
-        }
-
-        // Get patch info
-        auto desc = table->GetPatchArrayDescriptor(patchArray);
-        int numCVs = desc.GetNumControlVertices();
-
-        // Allocate space for basis weights
-        std::vector<float> wP(numCVs), wDu(numCVs), wDv(numCVs);
-        std::vector<float> wDuu(numCVs), wDuv(numCVs), wDvv(numCVs);
-
-        // Evaluate basis functions
-        if (!PatchTable_EvaluateBasis(
-                table, patchIndex, u, v, wP.data(), wDu.data(), wDv.data(), wDuu.data(),
-                wDuv.data(), wDvv.data())) {
-            return false;
         }
 
-        // Get control vertex indices for this patch
-        auto cvIndices = table->GetPatchArrayVertices(patchArray);
-        int cvStart = localPatchIndex * numCVs;
+        const BufferDescriptor desc(0, 3, 3);
+        combine(w.p, &cvs[0], cvs.size(), controlPoints, desc, result->point);
+        combine(w.du, &cvs[0], cvs.size(), controlPoints, desc, result->du);
+        combine(w.dv, &cvs[0], cvs.size(), controlPoints, desc, result->dv);
+        combine(w.duu, &cvs[0], cvs.size(), controlPoints, desc, result->duu);
+        combine(w.duv, &cvs[0], cvs.size(), controlPoints, desc, result->duv);
+        combine(w.dvv, &cvs[0], cvs.size(), controlPoints, desc, result->dvv);
+        return true;
+    }
 
-        // Initialize result
-        for (int i = 0; i < 3; ++i) {
-            result->point[i] = 0.0f;
-            result->du[i] = 0.0f;
-            result->dv[i] = 0.0f;
-            result->duu[i] = 0.0f;
-            result->duv[i] = 0.0f;
-            result->dvv[i] = 0.0f;
+    // Evaluate many points given as SoA (patch index, u, v) arrays.
+    //
+    // `u`, `v` are face coordinates. `src` holds interleaved control points
+    // described by `srcDesc`; every non-null output buffer is written with
+    // `dstDesc`. Second derivatives are only computed when requested. Returns
+    // the number of points evaluated; the outputs of the others are NaN.
+    int PatchTable_EvaluatePoints(
+        const PatchTable *table,
+        int numPoints,
+        const int *patchIndices,
+        const float *u,
+        const float *v,
+        const float *src,
+        BufferDescriptor srcDesc,
+        float *dstP,
+        float *dstDu,
+        float *dstDv,
+        float *dstDuu,
+        float *dstDuv,
+        float *dstDvv,
+        BufferDescriptor dstDesc)
+    {
+        if (!validBatch(table, numPoints, patchIndices, u, v, src, srcDesc, dstDesc)) {
+            return -1;
         }
 
-        // Apply weights to control points
-        for (int cv = 0; cv < numCVs; ++cv) {
-            int vertexIndex = cvIndices[cvStart + cv];
-            if (vertexIndex >= numControlPoints) {
-                return false;
-            }
-
-            const float *cp = &controlPoints[vertexIndex * 3];
+        const PatchHandleLookup lookup(table);
+        const PatchEvalBuffers dst = {dstP, dstDu, dstDv, dstDuu, dstDuv, dstDvv};
+        return evaluatePoints(
+            table, numPoints,
+            [&](int i, PatchHandle *handle) {
+                return lookup.Find(patchIndices[i], handle);
+            },
+            u, v, src, srcDesc, dst, dstDesc);
+    }
 
-            for (int i = 0; i < 3; ++i) {
-                result->point[i] += wP[cv] * cp[i];
-                result->du[i] += wDu[cv] * cp[i];
-                result->dv[i] += wDv[cv] * cp[i];
-                result->duu[i] += wDuu[cv] * cp[i];
-                result->duv[i] += wDuv[cv] * cp[i];
-                result->dvv[i] += wDvv[cv] * cp[i];
-            }
+    // Evaluate many points given as SoA (ptex face, u, v) arrays.
+    //
+    // Each point is located with `map`; points on faces without patches
+    // (holes) are not evaluated and their outputs are NaN. Otherwise identical
+    // to `PatchTable_EvaluatePoints`.
+    int PatchTable_EvaluateFacePoints(
+        const PatchTable *table,
+        const PatchMap *map,
+        int numPoints,
+        const int *faceIndices,
+        const float *u,
+        const float *v,
+        const float *src,
+        BufferDescriptor srcDesc,
+        float *dstP,
+        float *dstDu,
+        float *dstDv,
+        float *dstDuu,
+        float *dstDuv,
+        float *dstDvv,
+        BufferDescriptor dstDesc)
+    {
+        if (!map ||
+            !validBatch(table, numPoints, faceIndices, u, v, src, srcDesc, dstDesc)) {
+            return -1;
         }
 
-        return true;
+        const PatchEvalBuffers dst = {dstP, dstDu, dstDv, dstDuu, dstDuv, dstDvv};
+        return evaluatePoints(
+            table, numPoints,
+            [&](int i, PatchHandle *handle) {
+                const PatchHandle *found = map->FindPatch(faceIndices[i], u[i], v[i]);
+                if (!found) {
+                    return false;
+                }
+                *handle = *found;
+                return true;
+            },
+            u, v, src, srcDesc, dst, dstDesc);
     }
 
     // Create patch map for efficient patch location
@@ -205,8 +539,10 @@ extern "C"
         delete map;
     }
 
-    // Find patch containing given face and (u,v)
+    // Find the patch containing face coordinates (u,v) of a ptex face and
+    // return the patch-local (normalized) coordinates
     bool PatchMap_FindPatch(
+        const PatchTable *table,
         const PatchMap *map,
         int faceIndex,
         float u,
@@ -215,24 +551,51 @@ extern "C"
         float *patchU,
         float *patchV)
     {
-        if (!map || !patchIndex || !patchU || !patchV) {
+        if (!table || !map || !patchIndex || !patchU || !patchV) {
             return false;
         }
+        return locatePatch(table, map, faceIndex, u, v, patchIndex, patchU, patchV);
+    }
 
-        const PatchTable::PatchHandle *handle = map->FindPatch(faceIndex, u, v);
-        if (!handle) {
-            return false;
+    // Locate many (face, u, v) queries in one call.
+    //
+    // `patchU`/`patchV` may both be null. Queries on faces without patches get
+    // patch index -1 (and local coordinates 0). Returns the number of queries
+    // that were located, or -1 for invalid arguments.
+    int PatchMap_FindPatches(
+        const PatchTable *table,
+        const PatchMap *map,
+        int numQueries,
+        const int *faceIndices,
+        const float *u,
+        const float *v,
+        int *patchIndices,
+        float *patchU,
+        float *patchV)
+    {
+        if (!table || !map || numQueries < 0 || (!patchU != !patchV)) {
+            return -1;
+        }
+        if (numQueries > 0 && !(faceIndices && u && v && patchIndices)) {
+            return -1;
         }
 
-        *patchIndex = handle->patchIndex;
-
-        // Get patch param and transform coordinates
-        PatchParam param;
-        // Note: This is simplified - actual implementation would get param from patch
-        // table
-        param.Normalize(*patchU, *patchV);
-
-        return true;
+        int found = 0;
+        for (int i = 0; i < numQueries; ++i) {
+            float *pu = patchU ? patchU + i : nullptr;
+            float *pv = patchV ? patchV + i : nullptr;
+            if (locatePatch(
+                    table, map, faceIndices[i], u[i], v[i], patchIndices + i, pu, pv)) {
+                ++found;
+            } else {
+                patchIndices[i] = -1;
+                if (pu) {
+                    *pu = 0.0f;
+                    *pv = 0.0f;
+                }
+            }
+        }
+        return found;
     }
 
 }  // extern "C"
\ No newline at end of file
@@ -184,6 +184,11 @@ extern "C"
         *v = (float)param->GetV() / depth;
     }
 
+    int PatchParam_GetFaceId(const PatchParam *param)
+    {
+        return param->GetFaceId();
+    }
+
     int PatchParam_GetDepth(const PatchParam *param)
     {
         return param->GetDepth();
@@ -204,4 +209,36 @@ extern "C"
         return param->GetTransition();
     }
 
+    // Map face (ptex) coordinates into the patch's [0,1] parameter space
+    void PatchParam_Normalize(const PatchParam *param, float *u, float *v)
+    {
+        if (!u || !v)
+            return;
+        param->Normalize(*u, *v);
+    }
+
+    // Map patch-local coordinates back to face (ptex) coordinates
+    void PatchParam_Unnormalize(const PatchParam *param, float *u, float *v)
+    {
+        if (!u || !v)
+            return;
+        param->Unnormalize(*u, *v);
+    }
+
+    // Triangular variant of PatchParam_Normalize (Loop, GregoryTriangle)
+    void PatchParam_NormalizeTriangle(const PatchParam *param, float *u, float *v)
+    {
+        if (!u || !v)
+            return;
+        param->NormalizeTriangle(*u, *v);
+    }
+
+    // Triangular variant of PatchParam_Unnormalize (Loop, GregoryTriangle)
+    void PatchParam_UnnormalizeTriangle(const PatchParam *param, float *u, float *v)
+    {
+        if (!u || !v)
+            return;
+        param->UnnormalizeTriangle(*u, *v);
+    }
+
 }  // extern "C"
\ No newline at end of file
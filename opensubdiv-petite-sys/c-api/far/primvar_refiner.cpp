@@ -1,32 +1,228 @@
 #include <opensubdiv/far/primvarRefiner.h>
+#include <opensubdiv/osd/bufferDescriptor.h>
 #include <opensubdiv/sdc/options.h>
 #include <opensubdiv/sdc/types.h>
 
-#include <exception>
-#include <stdio.h>
+#include <cstddef>
 
 typedef OpenSubdiv::Far::PrimvarRefiner PrimvarRefiner;
 typedef OpenSubdiv::Far::TopologyRefiner TopologyRefiner;
+typedef OpenSubdiv::Osd::BufferDescriptor BufferDescriptor;
 
-template <int N> struct Primvar
+// AIDEV-NOTE: Strided primvar views.
+// `PrimvarRefiner` only needs `dst[i].Clear()`, `dst[i].AddWithWeight(src[j],
+// w)` and `dst[i] = src[j]`, so instead of reinterpreting packed buffers as
+// arrays of fixed-size structs these hand out lightweight element proxies
+// into the caller's interleaved buffers. `N > 0` fixes the width at compile
+// time so the element loops unroll; `N == 0` reads it at runtime.
+namespace
 {
-    float v[N];
+
+template <int N> struct ConstElement
+{
+    const float *v;
+    int width;
+};
+
+template <int N> struct Element
+{
+    float *v;
+    int width;
+
+    int size() const
+    {
+        return N > 0 ? N : width;
+    }
 
     void Clear()
     {
-        for (int i = 0; i < N; ++i) {
-            v[i] = 0.0f;
+        for (int k = 0; k < size(); ++k) {
+            v[k] = 0.0f;
         }
     }
 
-    void AddWithWeight(const Primvar &p, float weight)
+    void AddWithWeight(const ConstElement<N> &src, float weight)
     {
-        for (int i = 0; i < N; ++i) {
-            v[i] += p.v[i] * weight;
+        for (int k = 0; k < size(); ++k) {
+            v[k] += src.v[k] * weight;
         }
     }
+
+    Element &operator=(const ConstElement<N> &src)
+    {
+        for (int k = 0; k < size(); ++k) {
+            v[k] = src.v[k];
+        }
+        return *this;
+    }
+};
+
+template <int N> struct ConstBuffer
+{
+    const float *data;
+    int width;
+    int stride;
+
+    ConstElement<N> operator[](int i) const
+    {
+        return ConstElement<N>{data + static_cast<size_t>(i) * stride, width};
+    }
 };
 
+template <int N> struct Buffer
+{
+    float *data;
+    int width;
+    int stride;
+
+    Element<N> operator[](int i) const
+    {
+        return Element<N>{data + static_cast<size_t>(i) * stride, width};
+    }
+};
+
+/// Which `PrimvarRefiner::Interpolate*()` method to apply.
+enum Interpolation
+{
+    INTERPOLATE_VERTEX = 0,
+    INTERPOLATE_VARYING = 1,
+    INTERPOLATE_FACE_UNIFORM = 2,
+    INTERPOLATE_FACE_VARYING = 3,
+};
+
+/// Returns whether `interpolation` is known and, for face-varying
+/// interpolation, `channel` exists.
+bool isValidInterpolation(
+    const TopologyRefiner &refiner, int interpolation, int channel)
+{
+    if (interpolation < INTERPOLATE_VERTEX ||
+        interpolation > INTERPOLATE_FACE_VARYING) {
+        return false;
+    }
+    return interpolation != INTERPOLATE_FACE_VARYING ||
+        (channel >= 0 && channel < refiner.GetNumFVarChannels());
+}
+
+template <int N>
+void interpolate(
+    const PrimvarRefiner *pr,
+    int interpolation,
+    int level,
+    int channel,
+    const float *src,
+    BufferDescriptor srcDesc,
+    float *dst,
+    BufferDescriptor dstDesc)
+{
+    const ConstBuffer<N> srcBuffer = {
+        src + srcDesc.offset, srcDesc.length, srcDesc.stride};
+    Buffer<N> dstBuffer = {dst + dstDesc.offset, dstDesc.length, dstDesc.stride};
+
+    switch (interpolation) {
+    case INTERPOLATE_VERTEX:
+        pr->Interpolate(level, srcBuffer, dstBuffer);
+        break;
+    case INTERPOLATE_VARYING:
+        pr->InterpolateVarying(level, srcBuffer, dstBuffer);
+        break;
+    case INTERPOLATE_FACE_UNIFORM:
+        pr->InterpolateFaceUniform(level, srcBuffer, dstBuffer);
+        break;
+    case INTERPOLATE_FACE_VARYING:
+        pr->InterpolateFaceVarying(level, srcBuffer, dstBuffer, channel);
+        break;
+    }
+}
+
+/// Refines `level - 1` primvars in `src` into `level` primvars in `dst`,
+/// using a fixed-width kernel for common primvar widths.
+///
+/// Returns false, without touching `dst`, if the arguments are invalid.
+bool interpolateWithDescriptors(
+    const PrimvarRefiner *pr,
+    int interpolation,
+    int level,
+    int channel,
+    const float *src,
+    BufferDescriptor srcDesc,
+    float *dst,
+    BufferDescriptor dstDesc)
+{
+    if (!pr || !src || !dst) {
+        return false;
+    }
+    if (!srcDesc.IsValid() || !dstDesc.IsValid() || srcDesc.length != dstDesc.length) {
+        return false;
+    }
+
+    const TopologyRefiner &refiner = pr->GetTopologyRefiner();
+    if (level < 1 || level > refiner.GetMaxLevel()) {
+        return false;
+    }
+    if (!isValidInterpolation(refiner, interpolation, channel)) {
+        return false;
+    }
+
+    switch (srcDesc.length) {
+    case 1:
+        interpolate<1>(pr, interpolation, level, channel, src, srcDesc, dst, dstDesc);
+        break;
+    case 2:
+        interpolate<2>(pr, interpolation, level, channel, src, srcDesc, dst, dstDesc);
+        break;
+    case 3:
+        interpolate<3>(pr, interpolation, level, channel, src, srcDesc, dst, dstDesc);
+        break;
+    case 4:
+        interpolate<4>(pr, interpolation, level, channel, src, srcDesc, dst, dstDesc);
+        break;
+    case 8:
+        interpolate<8>(pr, interpolation, level, channel, src, srcDesc, dst, dstDesc);
+        break;
+    case 12:
+        interpolate<12>(pr, interpolation, level, channel, src, srcDesc, dst, dstDesc);
+        break;
+    case 16:
+        interpolate<16>(pr, interpolation, level, channel, src, srcDesc, dst, dstDesc);
+        break;
+    default:
+        interpolate<0>(pr, interpolation, level, channel, src, srcDesc, dst, dstDesc);
+        break;
+    }
+    return true;
+}
+
+/// Number of primvars `interpolation` reads or writes at `level`.
+int primvarCount(
+    const TopologyRefiner &refiner, int interpolation, int level, int channel)
+{
+    const OpenSubdiv::Far::TopologyLevel &topology = refiner.GetLevel(level);
+    switch (interpolation) {
+    case INTERPOLATE_FACE_UNIFORM:
+        return topology.GetNumFaces();
+    case INTERPOLATE_FACE_VARYING:
+        return topology.GetNumFVarValues(channel);
+    default:
+        return topology.GetNumVertices();
+    }
+}
+
+/// Interpolates densely packed primvars of `num_elements` floats each.
+bool interpolatePacked(
+    const PrimvarRefiner *pr,
+    int interpolation,
+    int num_elements,
+    int level,
+    const float *src,
+    float *dst)
+{
+    const BufferDescriptor desc(0, num_elements, num_elements);
+    return interpolateWithDescriptors(
+        pr, interpolation, level, 0, src, desc, dst, desc);
+}
+
+}  // namespace
+
 extern "C"
 {
     PrimvarRefiner *PrimvarRefiner_create(TopologyRefiner *tr)
@@ -46,151 +242,139 @@ extern "C"
         return &pr->GetTopologyRefiner();
     }
 
-    void PrimvarRefiner_Interpolate(
+    // The packed entry points below interpolate `num_elements` floats per
+    // primvar and return false instead of aborting on invalid arguments.
+
+    bool PrimvarRefiner_Interpolate(
         PrimvarRefiner *pr, int num_elements, int level, float *src, float *dst)
     {
-        Primvar<1> *dst1;
-        Primvar<2> *dst2;
-        Primvar<3> *dst3;
-        Primvar<4> *dst4;
-
-        switch (num_elements) {
-        case 1: {
-            dst1 = (Primvar<1> *)dst;
-            pr->Interpolate(level, (Primvar<1> *)src, dst1);
-            break;
-        }
-        case 2: {
-            dst2 = (Primvar<2> *)dst;
-            pr->Interpolate(level, (Primvar<2> *)src, dst2);
-            break;
-        }
-        case 3: {
-            dst3 = (Primvar<3> *)dst;
-            pr->Interpolate(level, (Primvar<3> *)src, dst3);
-            break;
-        }
-        case 4: {
-            dst4 = (Primvar<4> *)dst;
-            pr->Interpolate(level, (Primvar<4> *)src, dst4);
-            break;
-        }
-        default: {
-            printf("Invalid num elements for Interpolate: { %d\n", num_elements);
-            std::terminate();
-        }
-        }
+        return interpolatePacked(pr, INTERPOLATE_VERTEX, num_elements, level, src, dst);
     }
 
-    void PrimvarRefiner_InterpolateVarying(
+    bool PrimvarRefiner_InterpolateVarying(
         PrimvarRefiner *pr, int num_elements, int level, float *src, float *dst)
     {
-        Primvar<1> *dst1;
-        Primvar<2> *dst2;
-        Primvar<3> *dst3;
-        Primvar<4> *dst4;
-
-        switch (num_elements) {
-        case 1: {
-            dst1 = (Primvar<1> *)dst;
-            pr->InterpolateVarying(level, (Primvar<1> *)src, dst1);
-            break;
-        }
-        case 2: {
-            dst2 = (Primvar<2> *)dst;
-            pr->InterpolateVarying(level, (Primvar<2> *)src, dst2);
-            break;
-        }
-        case 3: {
-            dst3 = (Primvar<3> *)dst;
-            pr->InterpolateVarying(level, (Primvar<3> *)src, dst3);
-            break;
-        }
-        case 4: {
-            dst4 = (Primvar<4> *)dst;
-            pr->InterpolateVarying(level, (Primvar<4> *)src, dst4);
-            break;
-        }
-        default: {
-            printf("Invalid num elements for InterpolateVarying: { %d\n", num_elements);
-            std::terminate();
-        }
-        }
+        return interpolatePacked(
+            pr, INTERPOLATE_VARYING, num_elements, level, src, dst);
     }
 
-    void PrimvarRefiner_InterpolateFaceUniform(
+    bool PrimvarRefiner_InterpolateFaceUniform(
         PrimvarRefiner *pr, int num_elements, int level, float *src, float *dst)
     {
-        Primvar<1> *dst1;
-        Primvar<2> *dst2;
-        Primvar<3> *dst3;
-        Primvar<4> *dst4;
-
-        switch (num_elements) {
-        case 1: {
-            dst1 = (Primvar<1> *)dst;
-            pr->InterpolateFaceUniform(level, (Primvar<1> *)src, dst1);
-            break;
-        }
-        case 2: {
-            dst2 = (Primvar<2> *)dst;
-            pr->InterpolateFaceUniform(level, (Primvar<2> *)src, dst2);
-            break;
-        }
-        case 3: {
-            dst3 = (Primvar<3> *)dst;
-            pr->InterpolateFaceUniform(level, (Primvar<3> *)src, dst3);
-            break;
-        }
-        case 4: {
-            dst4 = (Primvar<4> *)dst;
-            pr->InterpolateFaceUniform(level, (Primvar<4> *)src, dst4);
-            break;
-        }
-        default: {
-            printf(
-                "Invalid num elements for InterpolateFaceUniform: { %d\n",
-                num_elements);
-            std::terminate();
-        }
-        }
+        return interpolatePacked(
+            pr, INTERPOLATE_FACE_UNIFORM, num_elements, level, src, dst);
     }
 
-    void PrimvarRefiner_InterpolateFaceVarying(
+    bool PrimvarRefiner_InterpolateFaceVarying(
         PrimvarRefiner *pr, int num_elements, int level, float *src, float *dst)
     {
-        Primvar<1> *dst1;
-        Primvar<2> *dst2;
-        Primvar<3> *dst3;
-        Primvar<4> *dst4;
+        return interpolatePacked(
+            pr, INTERPOLATE_FACE_VARYING, num_elements, level, src, dst);
+    }
+
+    /// \brief Refine interleaved primvars from `level - 1` to `level`
+    ///
+    /// `interpolation` selects vertex (0), varying (1), face-uniform (2) or
+    /// face-varying (3) interpolation; `channel` is the face-varying channel
+    /// and ignored otherwise. Reads `srcDesc.length` elements per source
+    /// primvar and writes as many per refined primvar, honoring each
+    /// descriptor's offset and stride, so several primvars packed into one
+    /// buffer are refined in a single pass without de-interleaving. Does not
+    /// allocate.
+    ///
+    /// Returns false if the descriptors are invalid or their lengths differ,
+    /// or if `level`, `channel` or `interpolation` is out of range.
+    bool PrimvarRefiner_InterpolateWithDescriptors(
+        const PrimvarRefiner *pr,
+        int interpolation,
+        int level,
+        int channel,
+        const float *src,
+        BufferDescriptor srcDesc,
+        float *dst,
+        BufferDescriptor dstDesc)
+    {
+        return interpolateWithDescriptors(
+            pr, interpolation, level, channel, src, srcDesc, dst, dstDesc);
+    }
 
-        switch (num_elements) {
-        case 1: {
-            dst1 = (Primvar<1> *)dst;
-            pr->InterpolateFaceVarying(level, (Primvar<1> *)src, dst1);
-            break;
-        }
-        case 2: {
-            dst2 = (Primvar<2> *)dst;
-            pr->InterpolateFaceVarying(level, (Primvar<2> *)src, dst2);
-            break;
+    /// \brief Refine primvars through levels `1..=max_level` in one call
+    ///
+    /// `buffer` holds every level's primvars back to back, laid out like
+    /// `TopologyRefiner::GetNumVerticesTotal()` (or the face or face-varying
+    /// value totals), with each primvar addressed through `desc`. The base
+    /// level must already be filled in; each level is then refined from the
+    /// one before it in place.
+    ///
+    /// Returns false if any level fails to refine; levels before it are
+    /// left refined.
+    bool PrimvarRefiner_InterpolateLevels(
+        const PrimvarRefiner *pr,
+        int interpolation,
+        int channel,
+        int max_level,
+        float *buffer,
+        BufferDescriptor desc)
+    {
+        if (!pr || !buffer) {
+            return false;
         }
-        case 3: {
-            dst3 = (Primvar<3> *)dst;
-            pr->InterpolateFaceVarying(level, (Primvar<3> *)src, dst3);
-            break;
+        const TopologyRefiner &refiner = pr->GetTopologyRefiner();
+        if (max_level > refiner.GetMaxLevel() ||
+            !isValidInterpolation(refiner, interpolation, channel)) {
+            return false;
         }
-        case 4: {
-            dst4 = (Primvar<4> *)dst;
-            pr->InterpolateFaceVarying(level, (Primvar<4> *)src, dst4);
-            break;
+
+        size_t src_start = 0;
+        for (int level = 1; level <= max_level; ++level) {
+            const size_t dst_start = src_start +
+                static_cast<size_t>(
+                    primvarCount(refiner, interpolation, level - 1, channel));
+            if (!interpolateWithDescriptors(
+                    pr, interpolation, level, channel, buffer + src_start * desc.stride,
+                    desc, buffer + dst_start * desc.stride, desc)) {
+                return false;
+            }
+            src_start = dst_start;
         }
-        default: {
-            printf(
-                "Invalid num elements for InterpolateFaceVarying: { %d\n",
-                num_elements);
-            std::terminate();
+        return true;
+    }
+
+    /// \brief Refine base level primvars straight to `level`
+    ///
+    /// Intermediate levels ping-pong between `scratch` and `dst`, both laid
+    /// out by `dstDesc`, so that `level` ends up in `dst`. `dst` must hold
+    /// the primvars of `level` and `scratch` those of `level - 1`; each
+    /// intermediate level is dropped as soon as the next one is computed.
+    bool PrimvarRefiner_InterpolateToLevel(
+        const PrimvarRefiner *pr,
+        int interpolation,
+        int channel,
+        int level,
+        const float *src,
+        BufferDescriptor srcDesc,
+        float *scratch,
+        float *dst,
+        BufferDescriptor dstDesc)
+    {
+        if (!pr || level < 1 || (level > 1 && !scratch)) {
+            return false;
         }
+
+        // Levels `level`, `level - 2`, ... go to `dst`, the others to
+        // `scratch`.
+        const float *level_src = src;
+        BufferDescriptor level_src_desc = srcDesc;
+        for (int l = 1; l <= level; ++l) {
+            float *level_dst = ((level - l) % 2 == 0) ? dst : scratch;
+            if (!interpolateWithDescriptors(
+                    pr, interpolation, l, channel, level_src, level_src_desc, level_dst,
+                    dstDesc)) {
+                return false;
+            }
+            level_src = level_dst;
+            level_src_desc = dstDesc;
         }
+        return true;
     }
-}
\ No newline at end of file
+}
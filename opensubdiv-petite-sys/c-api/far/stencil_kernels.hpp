@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <opensubdiv/vtr/types.h>
+
+// AIDEV-NOTE: Allocation-free stencil application kernels.
+// These read the caller's interleaved source buffer in place and write each
+// destination point exactly once. The fixed-width variants keep the
+// accumulator in registers so the compiler can fully unroll (and vectorize
+// across) the element loop; the generic variant accumulates straight into
+// the destination.
+namespace StencilKernels
+{
+
+typedef OpenSubdiv::Vtr::Index Index;
+
+template <int N>
+void applyFixed(
+    const int *sizes,
+    const Index *indices,
+    const float *weights,
+    int numStencils,
+    const float *src,
+    int srcStride,
+    float *dst,
+    int dstStride)
+{
+    for (int i = 0; i < numStencils; ++i) {
+        float acc[N] = {};
+        for (int j = 0; j < sizes[i]; ++j, ++indices, ++weights) {
+            const float *s = src + static_cast<size_t>(*indices) * srcStride;
+            const float w = *weights;
+            for (int k = 0; k < N; ++k) {
+                acc[k] += s[k] * w;
+            }
+        }
+        float *d = dst + static_cast<size_t>(i) * dstStride;
+        for (int k = 0; k < N; ++k) {
+            d[k] = acc[k];
+        }
+    }
+}
+
+inline void applyGeneric(
+    const int *sizes,
+    const Index *indices,
+    const float *weights,
+    int numStencils,
+    int numElements,
+    const float *src,
+    int srcStride,
+    float *dst,
+    int dstStride)
+{
+    for (int i = 0; i < numStencils; ++i) {
+        float *d = dst + static_cast<size_t>(i) * dstStride;
+        for (int k = 0; k < numElements; ++k) {
+            d[k] = 0.0f;
+        }
+        for (int j = 0; j < sizes[i]; ++j, ++indices, ++weights) {
+            const float *s = src + static_cast<size_t>(*indices) * srcStride;
+            const float w = *weights;
+            for (int k = 0; k < numElements; ++k) {
+                d[k] += s[k] * w;
+            }
+        }
+    }
+}
+
+/// Applies stencils `[0, numStencils)` of the given arrays, dispatching to a
+/// fixed-width kernel for 1--4 elements and to the generic one otherwise.
+///
+/// `sizes`, `indices` and `weights` must already point at the first stencil
+/// to apply. `dst` receives one point per stencil.
+inline void apply(
+    const int *sizes,
+    const Index *indices,
+    const float *weights,
+    int numStencils,
+    int numElements,
+    const float *src,
+    int srcStride,
+    float *dst,
+    int dstStride)
+{
+    switch (numElements) {
+    case 1:
+        applyFixed<1>(
+            sizes, indices, weights, numStencils, src, srcStride, dst, dstStride);
+        break;
+    case 2:
+        applyFixed<2>(
+            sizes, indices, weights, numStencils, src, srcStride, dst, dstStride);
+        break;
+    case 3:
+        applyFixed<3>(
+            sizes, indices, weights, numStencils, src, srcStride, dst, dstStride);
+        break;
+    case 4:
+        applyFixed<4>(
+            sizes, indices, weights, numStencils, src, srcStride, dst, dstStride);
+        break;
+    default:
+        applyGeneric(
+            sizes, indices, weights, numStencils, numElements, src, srcStride, dst,
+            dstStride);
+        break;
+    }
+}
+
+/// Returns the offset of stencil `stencil` into the index/weight arrays.
+///
+/// Uses the table's offsets when the factory generated them and falls back
+/// to summing the sizes of the preceding stencils otherwise.
+inline Index stencilOffset(
+    const int *sizes, const Index *offsets, size_t numOffsets, int stencil)
+{
+    if (stencil <= 0) {
+        return 0;
+    }
+    if (static_cast<size_t>(stencil) < numOffsets) {
+        return offsets[stencil];
+    }
+    Index offset = 0;
+    for (int i = 0; i < stencil; ++i) {
+        offset += sizes[i];
+    }
+    return offset;
+}
+
+}  // namespace StencilKernels
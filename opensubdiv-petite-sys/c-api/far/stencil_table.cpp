@@ -1,39 +1,123 @@
-#include <algorithm>
-#include <numeric>
 #include <opensubdiv/far/stencilTable.h>
+#include <opensubdiv/osd/bufferDescriptor.h>
 #include <vector>
 
 #include "../vtr/types.hpp"
+#include "stencil_kernels.hpp"
 
 typedef OpenSubdiv::Far::StencilTable StencilTable;
 typedef OpenSubdiv::Far::Stencil Stencil;
+typedef OpenSubdiv::Osd::BufferDescriptor BufferDescriptor;
 
 typedef OpenSubdiv::Vtr::Index Index;
 
-// Wrapper class that provides the required interface for UpdateValues
-class FloatValue
+/// Applies stencils `[start, end)` of `st` to interleaved buffers.
+///
+/// Negative `start`/`end` select the first/last stencil, as in
+/// `StencilTable::UpdateValues()`. Destination point `i` receives stencil
+/// `start + i`.
+static bool updateValues(
+    const StencilTable *st,
+    const float *src,
+    BufferDescriptor srcDesc,
+    float *dst,
+    BufferDescriptor dstDesc,
+    int start,
+    int end)
 {
-  public:
-    float value;
-
-    FloatValue() : value(0.0f)
-    {
+    const int numStencils = st->GetNumStencils();
+    if (start < 0) {
+        start = 0;
     }
-
-    void Clear()
-    {
-        value = 0.0f;
+    if (end < 0 || end > numStencils) {
+        end = numStencils;
+    }
+    if (start >= end) {
+        return start == end;
+    }
+    if (!srcDesc.IsValid() || !dstDesc.IsValid() || srcDesc.length != dstDesc.length) {
+        return false;
     }
 
-    void AddWithWeight(const FloatValue &src, float weight)
+    const auto &sizes = st->GetSizes();
+    const auto &offsets = st->GetOffsets();
+    const Index offset = StencilKernels::stencilOffset(
+        sizes.data(), offsets.data(), offsets.size(), start);
+
+    StencilKernels::apply(
+        sizes.data() + start,
+        st->GetControlIndices().data() + offset,
+        st->GetWeights().data() + offset,
+        end - start,
+        dstDesc.length,
+        src + srcDesc.offset,
+        srcDesc.stride,
+        dst + dstDesc.offset,
+        dstDesc.stride);
+
+    return true;
+}
+
+/// `Far::StencilTable` only exposes its array constructor to subclasses.
+class ArrayStencilTable : public StencilTable
+{
+public:
+    ArrayStencilTable(
+        int numControlVerts,
+        std::vector<int> const &offsets,
+        std::vector<int> const &sizes,
+        std::vector<int> const &sources,
+        std::vector<float> const &weights)
+        : StencilTable(numControlVerts, offsets, sizes, sources, weights, false, 0)
     {
-        value += src.value * weight;
     }
 };
 
 extern "C"
 {
 
+    /// \brief Create a stencil table from `num_stencils` sizes and the
+    /// concatenated indices and weights of the stencils
+    ///
+    /// Offsets are generated. Returns null if a size is negative or an index
+    /// is not one of `num_control_vertices` control vertices.
+    StencilTable *StencilTable_CreateFromArrays(
+        int num_control_vertices,
+        int num_stencils,
+        const int *sizes,
+        const Index *indices,
+        const float *weights)
+    {
+        if (num_control_vertices < 0 || num_stencils < 0 || (num_stencils > 0 && !sizes)) {
+            return nullptr;
+        }
+
+        std::vector<int> offsets(num_stencils);
+        int num_weights = 0;
+        for (int i = 0; i < num_stencils; ++i) {
+            if (sizes[i] < 0) {
+                return nullptr;
+            }
+            offsets[i] = num_weights;
+            num_weights += sizes[i];
+        }
+        if (num_weights > 0 && (!indices || !weights)) {
+            return nullptr;
+        }
+        for (int i = 0; i < num_weights; ++i) {
+            if (indices[i] < 0 || indices[i] >= num_control_vertices) {
+                return nullptr;
+            }
+        }
+
+        return new ArrayStencilTable(
+            num_control_vertices,
+            offsets,
+            std::vector<int>(sizes, sizes + num_stencils),
+            std::vector<int>(indices, indices + num_weights),
+            std::vector<float>(weights, weights + num_weights));
+    }
+
     void StencilTable_destroy(StencilTable *st)
     {
         delete st;
@@ -86,45 +170,32 @@ extern "C"
     }
 
     /// \brief Update values by applying the stencil table
+    ///
+    /// Single-element variant. `src` must hold every control vertex referenced
+    /// by the table; `dst` receives `end - start` values.
     void StencilTable_UpdateValues(
         StencilTable *st, const float *src, float *dst, int start, int end)
     {
-        int numControlVerts = st->GetNumControlVertices();
-        int numStencils = st->GetNumStencils();
-
-        // AIDEV-NOTE: Handle local point stencil tables
-        // Local point stencil tables may report 0 control vertices but still
-        // need to process data. In this case, we need to infer the actual
-        // number of control vertices from the stencil indices.
-
-        int actualNumControlVerts = numControlVerts;
-        if (numControlVerts == 0) {
-            // Find the maximum control vertex index referenced
-            const auto &indices = st->GetControlIndices();
-            if (!indices.empty()) {
-                actualNumControlVerts =
-                    *std::max_element(indices.begin(), indices.end()) + 1;
-            }
-        }
-
-        // Create wrapper arrays
-        std::vector<FloatValue> srcValues(actualNumControlVerts);
-        std::vector<FloatValue> dstValues(numStencils);
-
-        // Copy input data to wrapper
-        for (int i = 0; i < actualNumControlVerts; ++i) {
-            srcValues[i].value = src[i];
-        }
-
-        // Use the templated UpdateValues method with our wrapper type
-        st->UpdateValues(srcValues.data(), dstValues.data(), start, end);
-
-        // Copy results back
-        int actualStart = (start < 0) ? 0 : start;
-        int actualEnd = (end < 0 || end > numStencils) ? numStencils : end;
+        const BufferDescriptor desc(0, 1, 1);
+        updateValues(st, src, desc, dst, desc, start, end);
+    }
 
-        for (int i = actualStart; i < actualEnd; ++i) {
-            dst[i - actualStart] = dstValues[i].value;
-        }
+    /// \brief Update interleaved values in place by applying the stencil table
+    ///
+    /// Reads `srcDesc.length` elements per control vertex from `src` and writes
+    /// the same number per stencil into `dst`, honoring each descriptor's
+    /// offset and stride. Does not allocate.
+    ///
+    /// Returns false if the descriptors are invalid or their lengths differ.
+    bool StencilTable_UpdateValuesWithDescriptors(
+        const StencilTable *st,
+        const float *src,
+        BufferDescriptor srcDesc,
+        float *dst,
+        BufferDescriptor dstDesc,
+        int start,
+        int end)
+    {
+        return updateValues(st, src, srcDesc, dst, dstDesc, start, end);
     }
-}
\ No newline at end of file
+}
@@ -1,11 +1,66 @@
 #include <opensubdiv/far/stencilTableFactory.h>
+#include <opensubdiv/far/topologyLevel.h>
+
+typedef OpenSubdiv::Far::StencilTable StencilTable;
+typedef OpenSubdiv::Far::StencilTableFactory StencilTableFactory;
+typedef OpenSubdiv::Far::TopologyRefiner TopologyRefiner;
 
 extern "C"
 {
-    const OpenSubdiv::Far::StencilTable *StencilTableFactory_Create(
-        OpenSubdiv::Far::TopologyRefiner *refiner,
-        OpenSubdiv::Far::StencilTableFactory::Options options)
+    const StencilTable *StencilTableFactory_Create(
+        TopologyRefiner *refiner, StencilTableFactory::Options options)
+    {
+        return StencilTableFactory::Create(*refiner, options);
+    }
+
+    /// \brief Concatenate `num_tables` stencil tables into a new one
+    ///
+    /// The tables must all index the same number of control vertices; returns
+    /// null otherwise, or if there is nothing to concatenate.
+    const StencilTable *StencilTableFactory_CreateConcatenated(
+        int num_tables, const StencilTable **tables)
     {
-        return OpenSubdiv::Far::StencilTableFactory::Create(*refiner, options);
+        if (num_tables <= 0 || !tables) {
+            return nullptr;
+        }
+        for (int i = 0; i < num_tables; ++i) {
+            if (!tables[i] || tables[i]->GetNumControlVertices() !=
+                                  tables[0]->GetNumControlVertices()) {
+                return nullptr;
+            }
+        }
+        return StencilTableFactory::Create(num_tables, tables);
+    }
+
+    /// \brief Append the local point stencils of a patch table to `base`
+    ///
+    /// `base` must hold the stencils of all refined vertices, with or without
+    /// those of the base level, i.e. be created with intermediate levels.
+    /// With `factorize`, the local point stencils are rewritten in terms of
+    /// the base control vertices, so applying the returned table to them
+    /// yields every patch control vertex in one pass.
+    ///
+    /// Returns null if `local_points` is empty or `base` does not match
+    /// `refiner`.
+    const StencilTable *StencilTableFactory_AppendLocalPointStencilTable(
+        const TopologyRefiner *refiner,
+        const StencilTable *base,
+        const StencilTable *local_points,
+        bool factorize)
+    {
+        if (!refiner || !base || !local_points || local_points->GetNumStencils() == 0) {
+            return nullptr;
+        }
+
+        // Factorizing with any other layout trips an assertion in the
+        // factory.
+        const int num_refined = refiner->GetNumVerticesTotal();
+        const int num_base = refiner->GetLevel(0).GetNumVertices();
+        if (base->GetNumStencils() != num_refined &&
+            base->GetNumStencils() != num_refined - num_base) {
+            return nullptr;
+        }
+        return StencilTableFactory::AppendLocalPointStencilTable(
+            *refiner, base, local_points, factorize);
     }
-}
\ No newline at end of file
+}
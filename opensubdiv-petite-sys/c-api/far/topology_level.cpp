@@ -8,6 +8,46 @@ typedef OpenSubdiv::Vtr::ConstIndexArray ConstIndexArray;
 typedef OpenSubdiv::Vtr::ConstLocalIndexArray ConstLocalIndexArray;
 typedef OpenSubdiv::Vtr::Index Index;
 
+namespace
+{
+    /// \brief Fill the `count + 1` row offsets of a relation, if `offsets` is
+    /// not null, and return all rows as one array if they are stored back to
+    /// back, or an array without data of the total size otherwise
+    template <typename GetRow>
+    ConstIndexArray PackedRelation(int count, GetRow getRow, int *offsets)
+    {
+        if (offsets)
+            offsets[0] = 0;
+        if (count == 0)
+            return ConstIndexArray(nullptr, 0);
+
+        Index const *begin = getRow(0).begin();
+        bool packed = begin != nullptr;
+        int size = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            ConstIndexArray row = getRow(i);
+            packed = packed && row.begin() == begin + size;
+            size += row.size();
+            if (offsets)
+                offsets[i + 1] = size;
+        }
+        return ConstIndexArray(packed ? begin : nullptr, size);
+    }
+
+    /// \brief Copy all rows of a relation into `dst`, back to back
+    template <typename GetRow>
+    void CopyRelation(int count, GetRow getRow, Index *dst)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            ConstIndexArray row = getRow(i);
+            for (int j = 0; j < row.size(); ++j)
+                *dst++ = row[j];
+        }
+    }
+}
+
 extern "C"
 {
     /// \brief Return the number of vertices in this level
@@ -111,6 +151,53 @@ extern "C"
         return tl->GetEdgeFaceLocalIndices(e);
     }
 
+    /// \brief Fill the row offsets of the face-vertex relation and return all
+    /// face-vertices as one array, or an array without data if they are not
+    /// stored back to back
+    ConstIndexArray TopologyLevel_GetFaceVerticesCsr(TopologyLevel *tl, int *offsets)
+    {
+        return PackedRelation(
+            tl->GetNumFaces(), [tl](int f) { return tl->GetFaceVertices(f); }, offsets);
+    }
+
+    /// \brief Copy the face-vertices of all faces into `dst`
+    void TopologyLevel_CopyFaceVertices(TopologyLevel *tl, Index *dst)
+    {
+        CopyRelation(
+            tl->GetNumFaces(), [tl](int f) { return tl->GetFaceVertices(f); }, dst);
+    }
+
+    /// \brief Return the vertex pairs of all edges as one array, or an array
+    /// without data if they are not stored back to back
+    ConstIndexArray TopologyLevel_GetEdgeVerticesCsr(TopologyLevel *tl, int *offsets)
+    {
+        return PackedRelation(
+            tl->GetNumEdges(), [tl](int e) { return tl->GetEdgeVertices(e); }, offsets);
+    }
+
+    /// \brief Copy the vertex pairs of all edges into `dst`
+    void TopologyLevel_CopyEdgeVertices(TopologyLevel *tl, Index *dst)
+    {
+        CopyRelation(
+            tl->GetNumEdges(), [tl](int e) { return tl->GetEdgeVertices(e); }, dst);
+    }
+
+    /// \brief Fill the row offsets of the vertex-face relation and return the
+    /// incident faces of all vertices as one array, or an array without data
+    /// if they are not stored back to back
+    ConstIndexArray TopologyLevel_GetVertexFacesCsr(TopologyLevel *tl, int *offsets)
+    {
+        return PackedRelation(
+            tl->GetNumVertices(), [tl](int v) { return tl->GetVertexFaces(v); }, offsets);
+    }
+
+    /// \brief Copy the incident faces of all vertices into `dst`
+    void TopologyLevel_CopyVertexFaces(TopologyLevel *tl, Index *dst)
+    {
+        CopyRelation(
+            tl->GetNumVertices(), [tl](int v) { return tl->GetVertexFaces(v); }, dst);
+    }
+
     /// \brief Identify the edge matching the given vertex pair
     Index TopologyLevel_FindEdge(TopologyLevel *tl, Index v0, Index v1)
     {
@@ -166,6 +253,20 @@ extern "C"
         return tl->GetVertexSharpness(v);
     }
 
+    /// \brief Write the sharpness of every edge into `dst`
+    void TopologyLevel_GetEdgeSharpnesses(TopologyLevel *tl, float *dst)
+    {
+        for (int e = 0; e < tl->GetNumEdges(); ++e)
+            dst[e] = tl->GetEdgeSharpness(e);
+    }
+
+    /// \brief Write the sharpness of every vertex into `dst`
+    void TopologyLevel_GetVertexSharpnesses(TopologyLevel *tl, float *dst)
+    {
+        for (int v = 0; v < tl->GetNumVertices(); ++v)
+            dst[v] = tl->GetVertexSharpness(v);
+    }
+
     /// \brief Return if a given face has been tagged as a hole
     bool TopologyLevel_IsFaceHole(TopologyLevel *tl, Index f)
     {
@@ -233,6 +334,27 @@ extern "C"
         return tl->GetFaceFVarValues(f, channel);
     }
 
+    /// \brief Fill the row offsets of the face-varying values of a channel and
+    /// return the values of all faces as one array, or an array without data
+    /// if they are not stored back to back
+    ConstIndexArray
+    TopologyLevel_GetFaceFVarValuesCsr(TopologyLevel *tl, int channel, int *offsets)
+    {
+        return PackedRelation(
+            tl->GetNumFaces(),
+            [tl, channel](int f) { return tl->GetFaceFVarValues(f, channel); },
+            offsets);
+    }
+
+    /// \brief Copy the face-varying values of all faces of a channel into `dst`
+    void TopologyLevel_CopyFaceFVarValues(TopologyLevel *tl, int channel, Index *dst)
+    {
+        CopyRelation(
+            tl->GetNumFaces(),
+            [tl, channel](int f) { return tl->GetFaceFVarValues(f, channel); },
+            dst);
+    }
+
     /// \brief Return if face-varying topology around a vertex matches
     bool
     TopologyLevel_DoesVertexFVarTopologyMatch(TopologyLevel *tl, Index v, int channel)
@@ -1,11 +1,171 @@
+#include <opensubdiv/far/error.h>
 #include <opensubdiv/far/topologyDescriptor.h>
 #include <opensubdiv/far/topologyRefiner.h>
 #include <opensubdiv/far/topologyRefinerFactory.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
 typedef OpenSubdiv::Far::TopologyDescriptor TopologyDescriptor;
 typedef OpenSubdiv::Far::TopologyRefiner TopologyRefiner;
 typedef OpenSubdiv::Far::TopologyRefinerFactory<TopologyDescriptor>::Options Options;
 
+/// \brief A TopologyDescriptor whose arrays are copied into the base level in
+/// bulk instead of face by face
+///
+/// The arrays are borrowed from the caller and must outlive the call to
+/// Create().
+struct BulkTopologyDescriptor
+{
+    TopologyDescriptor const *descriptor;
+};
+
+namespace OpenSubdiv
+{
+namespace OPENSUBDIV_VERSION
+{
+namespace Far
+{
+    template <>
+    bool TopologyRefinerFactory<BulkTopologyDescriptor>::resizeComponentTopology(
+        TopologyRefiner &refiner, BulkTopologyDescriptor const &bulk)
+    {
+        TopologyDescriptor const &desc = *bulk.descriptor;
+
+        setNumBaseVertices(refiner, desc.numVertices);
+        setNumBaseFaces(refiner, desc.numFaces);
+        for (int face = 0; face < desc.numFaces; ++face)
+        {
+            setNumBaseFaceVertices(refiner, face, desc.numVertsPerFace[face]);
+        }
+        return true;
+    }
+
+    template <>
+    bool TopologyRefinerFactory<BulkTopologyDescriptor>::assignComponentTopology(
+        TopologyRefiner &refiner, BulkTopologyDescriptor const &bulk)
+    {
+        TopologyDescriptor const &desc = *bulk.descriptor;
+        if (desc.numFaces == 0)
+            return true;
+
+        // The face-vertices of the base level are stored back to back in the
+        // order of the faces, just like the descriptor's.
+        Index *dst = getBaseFaceVertices(refiner, 0).begin();
+        int faceVertexCount = 0;
+        for (int face = 0; face < desc.numFaces; ++face)
+            faceVertexCount += desc.numVertsPerFace[face];
+
+        if (!desc.isLeftHanded)
+        {
+            std::memcpy(dst, desc.vertIndicesPerFace, faceVertexCount * sizeof(Index));
+            return true;
+        }
+
+        // Keep the leading vertex and reverse the others.
+        Index const *src = desc.vertIndicesPerFace;
+        for (int face = 0; face < desc.numFaces; ++face)
+        {
+            int const size = desc.numVertsPerFace[face];
+            dst[0] = src[0];
+            std::reverse_copy(src + 1, src + size, dst + 1);
+            src += size;
+            dst += size;
+        }
+        return true;
+    }
+
+    template <>
+    bool TopologyRefinerFactory<BulkTopologyDescriptor>::assignComponentTags(
+        TopologyRefiner &refiner, BulkTopologyDescriptor const &bulk)
+    {
+        TopologyDescriptor const &desc = *bulk.descriptor;
+
+        for (int crease = 0; crease < desc.numCreases; ++crease)
+        {
+            Index const v0 = desc.creaseVertexIndexPairs[2 * crease];
+            Index const v1 = desc.creaseVertexIndexPairs[2 * crease + 1];
+            Index const edge = findBaseEdge(refiner, v0, v1);
+            if (edge == INDEX_INVALID)
+            {
+                char msg[1024];
+                snprintf(msg, 1024, "Edge %d specified to be sharp does not exist (%d, %d)",
+                         crease, v0, v1);
+                reportInvalidTopology(Vtr::internal::Level::TOPOLOGY_INVALID_CREASE_EDGE,
+                                      msg, bulk);
+                continue;
+            }
+            setBaseEdgeSharpness(refiner, edge, desc.creaseWeights[crease]);
+        }
+
+        for (int corner = 0; corner < desc.numCorners; ++corner)
+        {
+            Index const vertex = desc.cornerVertexIndices[corner];
+            if (vertex < 0 || vertex >= getNumBaseVertices(refiner))
+            {
+                char msg[1024];
+                snprintf(msg, 1024, "Vertex %d specified to be a corner does not exist",
+                         vertex);
+                reportInvalidTopology(Vtr::internal::Level::TOPOLOGY_INVALID_CREASE_VERT,
+                                      msg, bulk);
+                continue;
+            }
+            setBaseVertexSharpness(refiner, vertex, desc.cornerWeights[corner]);
+        }
+
+        for (int hole = 0; hole < desc.numHoles; ++hole)
+        {
+            setBaseFaceHole(refiner, desc.holeIndices[hole], true);
+        }
+        return true;
+    }
+
+    template <>
+    bool TopologyRefinerFactory<BulkTopologyDescriptor>::assignFaceVaryingTopology(
+        TopologyRefiner &refiner, BulkTopologyDescriptor const &bulk)
+    {
+        TopologyDescriptor const &desc = *bulk.descriptor;
+
+        for (int channel = 0; channel < desc.numFVarChannels; ++channel)
+        {
+            TopologyDescriptor::FVarChannel const &fvar = desc.fvarChannels[channel];
+            createBaseFVarChannel(refiner, fvar.numValues);
+            if (desc.numFaces == 0)
+                continue;
+
+            // Face-varying values are stored parallel to the face-vertices.
+            Index *dst = getBaseFaceFVarValues(refiner, 0, channel).begin();
+            Index const *src = fvar.valueIndices;
+            for (int face = 0; face < desc.numFaces; ++face)
+            {
+                int const size = desc.numVertsPerFace[face];
+                if (desc.isLeftHanded)
+                {
+                    dst[0] = src[0];
+                    std::reverse_copy(src + 1, src + size, dst + 1);
+                }
+                else
+                {
+                    std::memcpy(dst, src, size * sizeof(Index));
+                }
+                src += size;
+                dst += size;
+            }
+        }
+        return true;
+    }
+
+    template <>
+    void TopologyRefinerFactory<BulkTopologyDescriptor>::reportInvalidTopology(
+        TopologyError /* errCode */, char const *msg, BulkTopologyDescriptor const & /* bulk */)
+    {
+        Warning("%s", msg);
+    }
+} // namespace Far
+} // namespace OPENSUBDIV_VERSION
+} // namespace OpenSubdiv
+
 extern "C"
 {
     TopologyRefiner *TopologyRefinerFactory_TopologyDescriptor_Create(
@@ -14,4 +174,14 @@ extern "C"
         return OpenSubdiv::Far::TopologyRefinerFactory<TopologyDescriptor>::Create(
             *descriptor, options);
     }
-}
\ No newline at end of file
+
+    /// \brief Create a refiner from a descriptor, copying its arrays into the
+    /// base level in bulk
+    TopologyRefiner *TopologyRefinerFactory_TopologyDescriptor_CreateBulk(
+        TopologyDescriptor const *descriptor, Options options)
+    {
+        BulkTopologyDescriptor bulk = {descriptor};
+        return OpenSubdiv::Far::TopologyRefinerFactory<BulkTopologyDescriptor>::Create(
+            bulk, options);
+    }
+}
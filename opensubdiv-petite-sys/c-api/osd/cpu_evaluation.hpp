@@ -0,0 +1,148 @@
+#pragma once
+
+#include <opensubdiv/far/stencilTable.h>
+#include <opensubdiv/osd/bufferDescriptor.h>
+#include <opensubdiv/osd/cpuPatchTable.h>
+#include <opensubdiv/osd/cpuVertexBuffer.h>
+#include <opensubdiv/osd/types.h>
+
+// AIDEV-NOTE: Shared bodies of the CPU, OpenMP and TBB evaluator shims.
+// The three evaluators expose identical static APIs, so the derivative and
+// patch entry points are written once against `EVALUATOR`. Unrequested
+// outputs are passed as null and select the overload without them; all
+// derivatives of one order are requested together or not at all. The
+// bodies are also templated on the buffer so `CpuBufferView`s over caller
+// memory take the same path as `CpuVertexBuffer`s.
+namespace CpuEvaluation
+{
+
+typedef OpenSubdiv::Far::LimitStencilTable LimitStencilTable;
+typedef OpenSubdiv::Osd::BufferDescriptor BufferDescriptor;
+typedef OpenSubdiv::Osd::CpuPatchTable CpuPatchTable;
+typedef OpenSubdiv::Osd::CpuVertexBuffer CpuVertexBuffer;
+typedef OpenSubdiv::Osd::PatchCoord PatchCoord;
+
+/// A vertex buffer over memory owned by the caller, addressed by the
+/// evaluators like a `CpuVertexBuffer`.
+struct CpuBufferView
+{
+    float *data;
+
+    float *BindCpuBuffer() const
+    {
+        return data;
+    }
+};
+
+/// Points `view` at `data` and returns it, or null if `data` is null.
+inline CpuBufferView *bindView(CpuBufferView &view, const float *data)
+{
+    view.data = const_cast<float *>(data);
+    return data ? &view : nullptr;
+}
+
+/// Evaluates limit stencils with 1st and, if `duu` is given, 2nd
+/// derivatives.
+template <class EVALUATOR, class BUFFER>
+bool evalStencils(
+    BUFFER *src,
+    BufferDescriptor const &srcDesc,
+    BUFFER *dst,
+    BufferDescriptor const &dstDesc,
+    BUFFER *du,
+    BufferDescriptor const &duDesc,
+    BUFFER *dv,
+    BufferDescriptor const &dvDesc,
+    BUFFER *duu,
+    BufferDescriptor const &duuDesc,
+    BUFFER *duv,
+    BufferDescriptor const &duvDesc,
+    BUFFER *dvv,
+    BufferDescriptor const &dvvDesc,
+    const LimitStencilTable *stencilTable)
+{
+    if (!src || !dst || !du || !dv || !stencilTable) {
+        return false;
+    }
+    // The evaluators take the address of each weight vector's first
+    // element.
+    if (stencilTable->GetNumStencils() == 0) {
+        return true;
+    }
+    if (stencilTable->GetDuWeights().empty() || stencilTable->GetDvWeights().empty()) {
+        return false;
+    }
+    if (!duu) {
+        return EVALUATOR::EvalStencils(
+            src, srcDesc, dst, dstDesc, du, duDesc, dv, dvDesc, stencilTable);
+    }
+    if (!duv || !dvv || stencilTable->GetDuuWeights().empty() ||
+        stencilTable->GetDuvWeights().empty() ||
+        stencilTable->GetDvvWeights().empty()) {
+        return false;
+    }
+    return EVALUATOR::EvalStencils(
+        src, srcDesc, dst, dstDesc, du, duDesc, dv, dvDesc, duu, duuDesc, duv, duvDesc,
+        dvv, dvvDesc, stencilTable);
+}
+
+/// Evaluates `patchTable` at `numPatchCoords` locations, with 1st
+/// derivatives if `du` is given and 2nd derivatives if `duu` is given too.
+template <class EVALUATOR, class BUFFER>
+bool evalPatches(
+    BUFFER *src,
+    BufferDescriptor const &srcDesc,
+    BUFFER *dst,
+    BufferDescriptor const &dstDesc,
+    BUFFER *du,
+    BufferDescriptor const &duDesc,
+    BUFFER *dv,
+    BufferDescriptor const &dvDesc,
+    BUFFER *duu,
+    BufferDescriptor const &duuDesc,
+    BUFFER *duv,
+    BufferDescriptor const &duvDesc,
+    BUFFER *dvv,
+    BufferDescriptor const &dvvDesc,
+    int numPatchCoords,
+    const PatchCoord *patchCoords,
+    const CpuPatchTable *patchTable)
+{
+    if (!src || !dst || !patchTable || numPatchCoords < 0 ||
+        (numPatchCoords > 0 && !patchCoords)) {
+        return false;
+    }
+    if (numPatchCoords == 0) {
+        return true;
+    }
+
+    const float *srcData = src->BindCpuBuffer();
+    float *dstData = dst->BindCpuBuffer();
+    if (!du) {
+        return EVALUATOR::EvalPatches(
+            srcData, srcDesc, dstData, dstDesc, numPatchCoords, patchCoords,
+            patchTable->GetPatchArrayBuffer(), patchTable->GetPatchIndexBuffer(),
+            patchTable->GetPatchParamBuffer());
+    }
+    if (!dv) {
+        return false;
+    }
+    if (!duu) {
+        return EVALUATOR::EvalPatches(
+            srcData, srcDesc, dstData, dstDesc, du->BindCpuBuffer(), duDesc,
+            dv->BindCpuBuffer(), dvDesc, numPatchCoords, patchCoords,
+            patchTable->GetPatchArrayBuffer(), patchTable->GetPatchIndexBuffer(),
+            patchTable->GetPatchParamBuffer());
+    }
+    if (!duv || !dvv) {
+        return false;
+    }
+    return EVALUATOR::EvalPatches(
+        srcData, srcDesc, dstData, dstDesc, du->BindCpuBuffer(), duDesc,
+        dv->BindCpuBuffer(), dvDesc, duu->BindCpuBuffer(), duuDesc,
+        duv->BindCpuBuffer(), duvDesc, dvv->BindCpuBuffer(), dvvDesc, numPatchCoords,
+        patchCoords, patchTable->GetPatchArrayBuffer(),
+        patchTable->GetPatchIndexBuffer(), patchTable->GetPatchParamBuffer());
+}
+
+}  // namespace CpuEvaluation
@@ -2,9 +2,14 @@
 #include <opensubdiv/osd/cpuEvaluator.h>
 #include <opensubdiv/osd/cpuVertexBuffer.h>
 
+#include "cpu_evaluation.hpp"
+
+typedef OpenSubdiv::Far::LimitStencilTable LimitStencilTable;
 typedef OpenSubdiv::Far::StencilTable StencilTable;
 typedef OpenSubdiv::Osd::BufferDescriptor BufferDescriptor;
+typedef OpenSubdiv::Osd::CpuPatchTable CpuPatchTable;
 typedef OpenSubdiv::Osd::CpuVertexBuffer CpuVertexBuffer;
+typedef OpenSubdiv::Osd::PatchCoord PatchCoord;
 
 extern "C"
 {
@@ -18,4 +23,151 @@ extern "C"
         return OpenSubdiv::Osd::CpuEvaluator::EvalStencils(
             src_buffer, src_desc, dst_buffer, dst_desc, stencil_table);
     }
-}
\ No newline at end of file
+
+    /// \brief Evaluate limit stencils and their derivatives
+    ///
+    /// `du` and `dv` are required. `duu`, `duv` and `dvv` are either all
+    /// null or all given, in which case `stencil_table` must hold 2nd
+    /// derivative weights.
+    bool CpuEvaluator_EvalStencilsWithDerivatives(
+        CpuVertexBuffer *src_buffer,
+        BufferDescriptor src_desc,
+        CpuVertexBuffer *dst_buffer,
+        BufferDescriptor dst_desc,
+        CpuVertexBuffer *du_buffer,
+        BufferDescriptor du_desc,
+        CpuVertexBuffer *dv_buffer,
+        BufferDescriptor dv_desc,
+        CpuVertexBuffer *duu_buffer,
+        BufferDescriptor duu_desc,
+        CpuVertexBuffer *duv_buffer,
+        BufferDescriptor duv_desc,
+        CpuVertexBuffer *dvv_buffer,
+        BufferDescriptor dvv_desc,
+        const LimitStencilTable *stencil_table)
+    {
+        return CpuEvaluation::evalStencils<OpenSubdiv::Osd::CpuEvaluator>(
+            src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc, dv_buffer,
+            dv_desc, duu_buffer, duu_desc, duv_buffer, duv_desc, dvv_buffer, dvv_desc,
+            stencil_table);
+    }
+
+    /// \brief Evaluate the limit surface at `num_patch_coords` patch
+    /// coordinates
+    ///
+    /// Derivatives of an order are computed if their buffers are given;
+    /// `du` and `dv`, and `duu`, `duv` and `dvv`, go together.
+    bool CpuEvaluator_EvalPatches(
+        CpuVertexBuffer *src_buffer,
+        BufferDescriptor src_desc,
+        CpuVertexBuffer *dst_buffer,
+        BufferDescriptor dst_desc,
+        CpuVertexBuffer *du_buffer,
+        BufferDescriptor du_desc,
+        CpuVertexBuffer *dv_buffer,
+        BufferDescriptor dv_desc,
+        CpuVertexBuffer *duu_buffer,
+        BufferDescriptor duu_desc,
+        CpuVertexBuffer *duv_buffer,
+        BufferDescriptor duv_desc,
+        CpuVertexBuffer *dvv_buffer,
+        BufferDescriptor dvv_desc,
+        int num_patch_coords,
+        const PatchCoord *patch_coords,
+        const CpuPatchTable *patch_table)
+    {
+        return CpuEvaluation::evalPatches<OpenSubdiv::Osd::CpuEvaluator>(
+            src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc, dv_buffer,
+            dv_desc, duu_buffer, duu_desc, duv_buffer, duv_desc, dvv_buffer, dvv_desc,
+            num_patch_coords, patch_coords, patch_table);
+    }
+
+    /// \brief Evaluate stencils reading and writing caller memory in place
+    ///
+    /// Like CpuEvaluator_EvalStencils(), with the buffers given as the
+    /// addresses of their first floats.
+    bool CpuEvaluator_EvalStencilsView(
+        const float *src,
+        BufferDescriptor src_desc,
+        float *dst,
+        BufferDescriptor dst_desc,
+        StencilTable *stencil_table)
+    {
+        if (!src || !dst || !stencil_table) {
+            return false;
+        }
+        CpuEvaluation::CpuBufferView srcView = {const_cast<float *>(src)};
+        CpuEvaluation::CpuBufferView dstView = {dst};
+        return OpenSubdiv::Osd::CpuEvaluator::EvalStencils(
+            &srcView, src_desc, &dstView, dst_desc, stencil_table);
+    }
+
+    /// \brief Evaluate limit stencils and their derivatives reading and
+    /// writing caller memory in place
+    ///
+    /// Like CpuEvaluator_EvalStencilsWithDerivatives(), with the buffers
+    /// given as the addresses of their first floats.
+    bool CpuEvaluator_EvalStencilsWithDerivativesView(
+        const float *src,
+        BufferDescriptor src_desc,
+        float *dst,
+        BufferDescriptor dst_desc,
+        float *du,
+        BufferDescriptor du_desc,
+        float *dv,
+        BufferDescriptor dv_desc,
+        float *duu,
+        BufferDescriptor duu_desc,
+        float *duv,
+        BufferDescriptor duv_desc,
+        float *dvv,
+        BufferDescriptor dvv_desc,
+        const LimitStencilTable *stencil_table)
+    {
+        CpuEvaluation::CpuBufferView views[7];
+        return CpuEvaluation::evalStencils<OpenSubdiv::Osd::CpuEvaluator>(
+            CpuEvaluation::bindView(views[0], src), src_desc,
+            CpuEvaluation::bindView(views[1], dst), dst_desc,
+            CpuEvaluation::bindView(views[2], du), du_desc,
+            CpuEvaluation::bindView(views[3], dv), dv_desc,
+            CpuEvaluation::bindView(views[4], duu), duu_desc,
+            CpuEvaluation::bindView(views[5], duv), duv_desc,
+            CpuEvaluation::bindView(views[6], dvv), dvv_desc, stencil_table);
+    }
+
+    /// \brief Evaluate the limit surface at `num_patch_coords` patch
+    /// coordinates reading and writing caller memory in place
+    ///
+    /// Like CpuEvaluator_EvalPatches(), with the buffers given as the
+    /// addresses of their first floats.
+    bool CpuEvaluator_EvalPatchesView(
+        const float *src,
+        BufferDescriptor src_desc,
+        float *dst,
+        BufferDescriptor dst_desc,
+        float *du,
+        BufferDescriptor du_desc,
+        float *dv,
+        BufferDescriptor dv_desc,
+        float *duu,
+        BufferDescriptor duu_desc,
+        float *duv,
+        BufferDescriptor duv_desc,
+        float *dvv,
+        BufferDescriptor dvv_desc,
+        int num_patch_coords,
+        const PatchCoord *patch_coords,
+        const CpuPatchTable *patch_table)
+    {
+        CpuEvaluation::CpuBufferView views[7];
+        return CpuEvaluation::evalPatches<OpenSubdiv::Osd::CpuEvaluator>(
+            CpuEvaluation::bindView(views[0], src), src_desc,
+            CpuEvaluation::bindView(views[1], dst), dst_desc,
+            CpuEvaluation::bindView(views[2], du), du_desc,
+            CpuEvaluation::bindView(views[3], dv), dv_desc,
+            CpuEvaluation::bindView(views[4], duu), duu_desc,
+            CpuEvaluation::bindView(views[5], duv), duv_desc,
+            CpuEvaluation::bindView(views[6], dvv), dvv_desc, num_patch_coords,
+            patch_coords, patch_table);
+    }
+}
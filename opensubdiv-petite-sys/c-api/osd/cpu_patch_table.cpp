@@ -0,0 +1,25 @@
+#include <opensubdiv/far/patchTable.h>
+#include <opensubdiv/osd/cpuPatchTable.h>
+
+typedef OpenSubdiv::Far::PatchTable PatchTable;
+typedef OpenSubdiv::Osd::CpuPatchTable CpuPatchTable;
+
+extern "C"
+{
+    /// \brief Copy the patch arrays, indices and parameters of `patch_table`
+    /// into the layout the CPU, OpenMP and TBB evaluators read
+    ///
+    /// Returns null if `patch_table` is null.
+    CpuPatchTable *CpuPatchTable_Create(const PatchTable *patch_table)
+    {
+        if (!patch_table) {
+            return nullptr;
+        }
+        return CpuPatchTable::Create(patch_table);
+    }
+
+    void CpuPatchTable_destroy(CpuPatchTable *patch_table)
+    {
+        delete patch_table;
+    }
+}
@@ -1,12 +1,16 @@
 #include <opensubdiv/osd/cudaEvaluator.h>
+#include <opensubdiv/osd/cudaPatchTable.h>
 #include <opensubdiv/osd/cudaVertexBuffer.h>
 
+typedef OpenSubdiv::Far::PatchTable PatchTable;
 typedef OpenSubdiv::Far::StencilTable StencilTable;
 typedef OpenSubdiv::Far::LimitStencilTable LimitStencilTable;
+typedef OpenSubdiv::Osd::CudaPatchTable CudaPatchTable;
 typedef OpenSubdiv::Osd::CudaStencilTable CudaStencilTable;
 typedef OpenSubdiv::Osd::CudaEvaluator CudaEvaluator;
 typedef OpenSubdiv::Osd::CudaVertexBuffer CudaVertexBuffer;
 typedef OpenSubdiv::Osd::BufferDescriptor BufferDescriptor;
+typedef OpenSubdiv::Osd::PatchCoord PatchCoord;
 
 // CudaStencilTable
 extern "C"
@@ -16,10 +20,14 @@ extern "C"
         return CudaStencilTable::Create(st);
     }
 
-    // CudaStencilTable*
-    // CudaStencilTable_CreateFromLimit(const LimitStencilTable* st) {
-    //     return CudaStencilTable_Create(st);
-    // }
+    /// \brief Upload a limit stencil table, including its derivative weights
+    CudaStencilTable *CudaStencilTable_CreateFromLimit(const LimitStencilTable *st)
+    {
+        if (!st) {
+            return nullptr;
+        }
+        return CudaStencilTable::Create(st);
+    }
 
     void CudaStencilTable_destroy(CudaStencilTable *st)
     {
@@ -27,6 +35,23 @@ extern "C"
     }
 }
 
+// CudaPatchTable
+extern "C"
+{
+    CudaPatchTable *CudaPatchTable_Create(const PatchTable *pt)
+    {
+        if (!pt) {
+            return nullptr;
+        }
+        return CudaPatchTable::Create(pt);
+    }
+
+    void CudaPatchTable_destroy(CudaPatchTable *pt)
+    {
+        delete pt;
+    }
+}
+
 // CudaEvaluator
 extern "C"
 {
@@ -40,4 +65,108 @@ extern "C"
         return OpenSubdiv::Osd::CudaEvaluator::EvalStencils(
             src_buffer, src_desc, dst_buffer, dst_desc, stencil_table);
     }
-}
\ No newline at end of file
+
+    /// \brief Evaluate limit stencils and their derivatives
+    ///
+    /// `stencil_table` must have been created from a limit stencil table.
+    /// `du` and `dv` are required; `duu`, `duv` and `dvv` are either all null
+    /// or all given.
+    bool CudaEvaluator_EvalStencilsWithDerivatives(
+        CudaVertexBuffer *src_buffer,
+        BufferDescriptor src_desc,
+        CudaVertexBuffer *dst_buffer,
+        BufferDescriptor dst_desc,
+        CudaVertexBuffer *du_buffer,
+        BufferDescriptor du_desc,
+        CudaVertexBuffer *dv_buffer,
+        BufferDescriptor dv_desc,
+        CudaVertexBuffer *duu_buffer,
+        BufferDescriptor duu_desc,
+        CudaVertexBuffer *duv_buffer,
+        BufferDescriptor duv_desc,
+        CudaVertexBuffer *dvv_buffer,
+        BufferDescriptor dvv_desc,
+        CudaStencilTable *stencil_table)
+    {
+        if (!src_buffer || !dst_buffer || !du_buffer || !dv_buffer || !stencil_table) {
+            return false;
+        }
+        if (!duu_buffer) {
+            return CudaEvaluator::EvalStencils(
+                src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc,
+                dv_buffer, dv_desc, stencil_table);
+        }
+        if (!duv_buffer || !dvv_buffer) {
+            return false;
+        }
+        return CudaEvaluator::EvalStencils(
+            src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc, dv_buffer,
+            dv_desc, duu_buffer, duu_desc, duv_buffer, duv_desc, dvv_buffer, dvv_desc,
+            stencil_table);
+    }
+
+    /// \brief Evaluate the limit surface at `num_patch_coords` patch
+    /// coordinates
+    ///
+    /// `patch_coords` lives in host memory and is staged into a device
+    /// buffer of five floats per coordinate, the layout `PatchCoord` has.
+    /// Derivatives of an order are computed if their buffers are given.
+    bool CudaEvaluator_EvalPatches(
+        CudaVertexBuffer *src_buffer,
+        BufferDescriptor src_desc,
+        CudaVertexBuffer *dst_buffer,
+        BufferDescriptor dst_desc,
+        CudaVertexBuffer *du_buffer,
+        BufferDescriptor du_desc,
+        CudaVertexBuffer *dv_buffer,
+        BufferDescriptor dv_desc,
+        CudaVertexBuffer *duu_buffer,
+        BufferDescriptor duu_desc,
+        CudaVertexBuffer *duv_buffer,
+        BufferDescriptor duv_desc,
+        CudaVertexBuffer *dvv_buffer,
+        BufferDescriptor dvv_desc,
+        int num_patch_coords,
+        const PatchCoord *patch_coords,
+        CudaPatchTable *patch_table)
+    {
+        if (!src_buffer || !dst_buffer || !patch_table || num_patch_coords < 0 ||
+            (num_patch_coords > 0 && !patch_coords)) {
+            return false;
+        }
+        if (num_patch_coords == 0) {
+            return true;
+        }
+        if ((du_buffer && !dv_buffer) ||
+            (duu_buffer && (!du_buffer || !duv_buffer || !dvv_buffer))) {
+            return false;
+        }
+
+        static_assert(sizeof(PatchCoord) == 5 * sizeof(float), "");
+        CudaVertexBuffer *coords = CudaVertexBuffer::Create(5, num_patch_coords);
+        if (!coords) {
+            return false;
+        }
+        coords->UpdateData(
+            reinterpret_cast<const float *>(patch_coords), 0, num_patch_coords);
+
+        bool result;
+        if (!du_buffer) {
+            result = CudaEvaluator::EvalPatches(
+                src_buffer, src_desc, dst_buffer, dst_desc, num_patch_coords, coords,
+                patch_table);
+        } else if (!duu_buffer) {
+            result = CudaEvaluator::EvalPatches(
+                src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc,
+                dv_buffer, dv_desc, num_patch_coords, coords, patch_table);
+        } else {
+            result = CudaEvaluator::EvalPatches(
+                src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc,
+                dv_buffer, dv_desc, duu_buffer, duu_desc, duv_buffer, duv_desc,
+                dvv_buffer, dvv_desc, num_patch_coords, coords, patch_table);
+        }
+        // `cudaFree()` in the destructor waits for the kernel to finish.
+        delete coords;
+        return result;
+    }
+}
@@ -1,5 +1,9 @@
 #include <opensubdiv/osd/cudaVertexBuffer.h>
 
+#include <cuda_runtime.h>
+
+#include <cstddef>
+
 typedef OpenSubdiv::Osd::CudaVertexBuffer CudaVertexBuffer;
 
 extern "C"
@@ -47,4 +51,127 @@ extern "C"
     {
         return vb->BindCudaBuffer();
     }
+
+    /// \brief Asynchronously copy vertices from pinned host memory into the buffer
+    ///
+    /// The copy is enqueued on \p stream; \p src must stay valid until the
+    /// stream has reached it. Returns false if the range is out of bounds or
+    /// the copy could not be enqueued.
+    bool CudaVertexBuffer_UpdateDataAsync(
+        CudaVertexBuffer *vb,
+        const float *src,
+        int startVertex,
+        int numVertices,
+        cudaStream_t stream)
+    {
+        if (startVertex < 0 || numVertices < 0 ||
+            startVertex + numVertices > vb->GetNumVertices())
+            return false;
+        size_t const elements = (size_t)vb->GetNumElements();
+        float *dst = vb->BindCudaBuffer() + (size_t)startVertex * elements;
+        return cudaMemcpyAsync(dst, src, (size_t)numVertices * elements * sizeof(float),
+                               cudaMemcpyHostToDevice, stream) == cudaSuccess;
+    }
+
+    /// \brief Asynchronously copy vertices from the buffer into pinned host memory
+    ///
+    /// The copy is enqueued on \p stream; \p dst must stay valid until the
+    /// stream has reached it. Returns false if the range is out of bounds or
+    /// the copy could not be enqueued.
+    bool CudaVertexBuffer_ReadDataAsync(
+        CudaVertexBuffer *vb,
+        float *dst,
+        int startVertex,
+        int numVertices,
+        cudaStream_t stream)
+    {
+        if (startVertex < 0 || numVertices < 0 ||
+            startVertex + numVertices > vb->GetNumVertices())
+            return false;
+        size_t const elements = (size_t)vb->GetNumElements();
+        float const *src = vb->BindCudaBuffer() + (size_t)startVertex * elements;
+        return cudaMemcpyAsync(dst, src, (size_t)numVertices * elements * sizeof(float),
+                               cudaMemcpyDeviceToHost, stream) == cudaSuccess;
+    }
+
+    /// \brief Create a non-blocking stream. Returns NULL if error.
+    cudaStream_t CudaStream_Create()
+    {
+        cudaStream_t stream = nullptr;
+        if (cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking) != cudaSuccess)
+            return nullptr;
+        return stream;
+    }
+
+    /// \brief Destructor.
+    void CudaStream_destroy(cudaStream_t stream)
+    {
+        cudaStreamDestroy(stream);
+    }
+
+    /// \brief Block until all work enqueued on \p stream has finished
+    bool CudaStream_Synchronize(cudaStream_t stream)
+    {
+        return cudaStreamSynchronize(stream) == cudaSuccess;
+    }
+
+    /// \brief Make all future work on \p stream wait for \p event
+    bool CudaStream_WaitEvent(cudaStream_t stream, cudaEvent_t event)
+    {
+        return cudaStreamWaitEvent(stream, event, 0) == cudaSuccess;
+    }
+
+    /// \brief Create an event without timing data. Returns NULL if error.
+    cudaEvent_t CudaEvent_Create()
+    {
+        cudaEvent_t event = nullptr;
+        if (cudaEventCreateWithFlags(&event, cudaEventDisableTiming) != cudaSuccess)
+            return nullptr;
+        return event;
+    }
+
+    /// \brief Destructor.
+    void CudaEvent_destroy(cudaEvent_t event)
+    {
+        cudaEventDestroy(event);
+    }
+
+    /// \brief Record \p event at the current end of \p stream
+    bool CudaEvent_Record(cudaEvent_t event, cudaStream_t stream)
+    {
+        return cudaEventRecord(event, stream) == cudaSuccess;
+    }
+
+    /// \brief Returns 1 if the work before \p event has finished, 0 if it is
+    /// still pending and -1 on error
+    int CudaEvent_Query(cudaEvent_t event)
+    {
+        cudaError_t const status = cudaEventQuery(event);
+        if (status == cudaSuccess)
+            return 1;
+        if (status == cudaErrorNotReady)
+            return 0;
+        return -1;
+    }
+
+    /// \brief Block until the work before \p event has finished
+    bool CudaEvent_Synchronize(cudaEvent_t event)
+    {
+        return cudaEventSynchronize(event) == cudaSuccess;
+    }
+
+    /// \brief Allocate page-locked host memory. Returns NULL if error.
+    void *CudaHostBuffer_Create(size_t bytes)
+    {
+        void *ptr = nullptr;
+        if (cudaHostAlloc(&ptr, bytes, cudaHostAllocPortable) != cudaSuccess)
+            return nullptr;
+        return ptr;
+    }
+
+    /// \brief Destructor.
+    void CudaHostBuffer_destroy(void *ptr)
+    {
+        cudaFreeHost(ptr);
+    }
 }
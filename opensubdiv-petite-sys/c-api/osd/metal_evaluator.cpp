@@ -1,13 +1,18 @@
 #ifdef __APPLE__
 #include <opensubdiv/osd/mtlComputeEvaluator.h>
+#include <opensubdiv/osd/mtlPatchTable.h>
 #include <opensubdiv/osd/mtlVertexBuffer.h>
 
+typedef OpenSubdiv::Far::PatchTable PatchTable;
 typedef OpenSubdiv::Far::StencilTable StencilTable;
 typedef OpenSubdiv::Far::LimitStencilTable LimitStencilTable;
+typedef OpenSubdiv::Osd::MTLContext MTLContext;
+typedef OpenSubdiv::Osd::MTLPatchTable MTLPatchTable;
 typedef OpenSubdiv::Osd::MTLStencilTable MTLStencilTable;
 typedef OpenSubdiv::Osd::MTLComputeEvaluator MTLComputeEvaluator;
 typedef OpenSubdiv::Osd::MTLVertexBuffer MTLVertexBuffer;
 typedef OpenSubdiv::Osd::BufferDescriptor BufferDescriptor;
+typedef OpenSubdiv::Osd::PatchCoord PatchCoord;
 
 // MTLStencilTable
 extern "C"
@@ -17,15 +22,73 @@ extern "C"
         return MTLStencilTable::Create(st, context);
     }
 
+    /// \brief Upload a limit stencil table, including its derivative weights
+    ///
+    /// `context` is an `Osd::MTLContext`.
+    MTLStencilTable *
+    MTLStencilTable_CreateFromLimit(const LimitStencilTable *st, void *context)
+    {
+        if (!st || !context) {
+            return nullptr;
+        }
+        return MTLStencilTable::Create(st, static_cast<MTLContext *>(context));
+    }
+
     void MTLStencilTable_destroy(MTLStencilTable *st)
     {
         delete st;
     }
 }
 
+// MTLPatchTable
+extern "C"
+{
+    /// `context` is an `Osd::MTLContext`.
+    MTLPatchTable *MTLPatchTable_Create(const PatchTable *pt, void *context)
+    {
+        if (!pt || !context) {
+            return nullptr;
+        }
+        return MTLPatchTable::Create(pt, static_cast<MTLContext *>(context));
+    }
+
+    void MTLPatchTable_destroy(MTLPatchTable *pt)
+    {
+        delete pt;
+    }
+}
+
 // MTLComputeEvaluator
 extern "C"
 {
+    /// \brief Compile the compute pipelines for one buffer layout
+    ///
+    /// Derivative descriptors are empty for derivatives that are not
+    /// evaluated. `context` is an `Osd::MTLContext`. Returns null if
+    /// compilation fails.
+    MTLComputeEvaluator *MTLComputeEvaluator_Create(
+        BufferDescriptor src_desc,
+        BufferDescriptor dst_desc,
+        BufferDescriptor du_desc,
+        BufferDescriptor dv_desc,
+        BufferDescriptor duu_desc,
+        BufferDescriptor duv_desc,
+        BufferDescriptor dvv_desc,
+        void *context)
+    {
+        if (!context) {
+            return nullptr;
+        }
+        return MTLComputeEvaluator::Create(
+            src_desc, dst_desc, du_desc, dv_desc, duu_desc, duv_desc, dvv_desc,
+            static_cast<MTLContext *>(context));
+    }
+
+    void MTLComputeEvaluator_destroy(MTLComputeEvaluator *evaluator)
+    {
+        delete evaluator;
+    }
+
     bool MTLComputeEvaluator_EvalStencils(
         MTLVertexBuffer *src_buffer,
         BufferDescriptor src_desc,
@@ -39,5 +102,121 @@ extern "C"
             src_buffer, src_desc, dst_buffer, dst_desc, stencil_table, command_buffer,
             compute_encoder);
     }
+
+    /// \brief Evaluate limit stencils and their derivatives
+    ///
+    /// `stencil_table` must have been created from a limit stencil table.
+    /// `du` and `dv` are required; `duu`, `duv` and `dvv` are either all null
+    /// or all given.
+    bool MTLComputeEvaluator_EvalStencilsWithDerivatives(
+        const MTLComputeEvaluator *evaluator,
+        MTLVertexBuffer *src_buffer,
+        BufferDescriptor src_desc,
+        MTLVertexBuffer *dst_buffer,
+        BufferDescriptor dst_desc,
+        MTLVertexBuffer *du_buffer,
+        BufferDescriptor du_desc,
+        MTLVertexBuffer *dv_buffer,
+        BufferDescriptor dv_desc,
+        MTLVertexBuffer *duu_buffer,
+        BufferDescriptor duu_desc,
+        MTLVertexBuffer *duv_buffer,
+        BufferDescriptor duv_desc,
+        MTLVertexBuffer *dvv_buffer,
+        BufferDescriptor dvv_desc,
+        const MTLStencilTable *stencil_table,
+        void *context)
+    {
+        if (!evaluator || !src_buffer || !dst_buffer || !du_buffer || !dv_buffer ||
+            !stencil_table || !context) {
+            return false;
+        }
+        MTLContext *mtl_context = static_cast<MTLContext *>(context);
+        if (!duu_buffer) {
+            return evaluator->EvalStencils(
+                src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc,
+                dv_buffer, dv_desc, stencil_table, mtl_context);
+        }
+        if (!duv_buffer || !dvv_buffer) {
+            return false;
+        }
+        return evaluator->EvalStencils(
+            src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc, dv_buffer,
+            dv_desc, duu_buffer, duu_desc, duv_buffer, duv_desc, dvv_buffer, dvv_desc,
+            stencil_table, mtl_context);
+    }
+
+    /// \brief Evaluate the limit surface at `num_patch_coords` patch
+    /// coordinates
+    ///
+    /// `patch_coords` lives in host memory and is staged into a device
+    /// buffer of five floats per coordinate, the layout `PatchCoord` has.
+    /// Derivatives of an order are computed if their buffers are given.
+    bool MTLComputeEvaluator_EvalPatches(
+        const MTLComputeEvaluator *evaluator,
+        MTLVertexBuffer *src_buffer,
+        BufferDescriptor src_desc,
+        MTLVertexBuffer *dst_buffer,
+        BufferDescriptor dst_desc,
+        MTLVertexBuffer *du_buffer,
+        BufferDescriptor du_desc,
+        MTLVertexBuffer *dv_buffer,
+        BufferDescriptor dv_desc,
+        MTLVertexBuffer *duu_buffer,
+        BufferDescriptor duu_desc,
+        MTLVertexBuffer *duv_buffer,
+        BufferDescriptor duv_desc,
+        MTLVertexBuffer *dvv_buffer,
+        BufferDescriptor dvv_desc,
+        int num_patch_coords,
+        const PatchCoord *patch_coords,
+        MTLPatchTable *patch_table,
+        void *context)
+    {
+        if (!evaluator || !src_buffer || !dst_buffer || !patch_table || !context ||
+            num_patch_coords < 0 || (num_patch_coords > 0 && !patch_coords)) {
+            return false;
+        }
+        if (num_patch_coords == 0) {
+            return true;
+        }
+        if ((du_buffer && !dv_buffer) ||
+            (duu_buffer && (!du_buffer || !duv_buffer || !dvv_buffer))) {
+            return false;
+        }
+
+        MTLContext *mtl_context = static_cast<MTLContext *>(context);
+        static_assert(sizeof(PatchCoord) == 5 * sizeof(float), "");
+        MTLVertexBuffer *coords =
+            MTLVertexBuffer::Create(5, num_patch_coords, mtl_context);
+        if (!coords) {
+            return false;
+        }
+        coords->UpdateData(
+            reinterpret_cast<const float *>(patch_coords), 0, num_patch_coords,
+            mtl_context);
+
+        bool result;
+        if (!du_buffer) {
+            result = evaluator->EvalPatches(
+                src_buffer, src_desc, dst_buffer, dst_desc, num_patch_coords, coords,
+                patch_table, mtl_context);
+        } else if (!duu_buffer) {
+            result = evaluator->EvalPatches(
+                src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc,
+                dv_buffer, dv_desc, num_patch_coords, coords, patch_table,
+                mtl_context);
+        } else {
+            result = evaluator->EvalPatches(
+                src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc,
+                dv_buffer, dv_desc, duu_buffer, duu_desc, duv_buffer, duv_desc,
+                dvv_buffer, dvv_desc, num_patch_coords, coords, patch_table,
+                mtl_context);
+        }
+        // The command buffer retains the coordinate buffer until it has
+        // executed.
+        delete coords;
+        return result;
+    }
 }
-#endif  // __APPLE__
\ No newline at end of file
+#endif  // __APPLE__
@@ -1,6 +1,9 @@
 #ifdef __APPLE__
 #include <opensubdiv/osd/mtlVertexBuffer.h>
 
+#include <objc/message.h>
+#include <objc/runtime.h>
+
 typedef OpenSubdiv::Osd::MTLVertexBuffer MTLVertexBuffer;
 
 extern "C"
@@ -48,5 +51,27 @@ extern "C"
     {
         return vb->GetMTLBuffer();
     }
+
+    /// \brief Returns the CPU address of the buffer's storage
+    ///
+    /// Osd allocates its buffers in shared storage, which the CPU and the GPU
+    /// address directly on unified memory devices. Returns NULL if the buffer
+    /// is not in shared storage, in which case the contents must go through
+    /// UpdateData().
+    float *MTLVertexBuffer_GetContents(MTLVertexBuffer *vb)
+    {
+        // MTLStorageModeShared.
+        static unsigned long const storageModeShared = 0;
+
+        void *buffer = (void *)vb->GetMTLBuffer();
+        if (!buffer)
+            return nullptr;
+        typedef unsigned long (*StorageModeFn)(void *, SEL);
+        typedef void *(*ContentsFn)(void *, SEL);
+        if (((StorageModeFn)objc_msgSend)(buffer, sel_registerName("storageMode")) !=
+            storageModeShared)
+            return nullptr;
+        return (float *)((ContentsFn)objc_msgSend)(buffer, sel_registerName("contents"));
+    }
 }
 #endif  // __APPLE__
\ No newline at end of file
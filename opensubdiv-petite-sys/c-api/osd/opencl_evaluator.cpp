@@ -1,13 +1,17 @@
 #ifdef OPENSUBDIV_HAS_OPENCL
 #include <opensubdiv/osd/clEvaluator.h>
+#include <opensubdiv/osd/clPatchTable.h>
 #include <opensubdiv/osd/clVertexBuffer.h>
 
+typedef OpenSubdiv::Far::PatchTable PatchTable;
 typedef OpenSubdiv::Far::StencilTable StencilTable;
 typedef OpenSubdiv::Far::LimitStencilTable LimitStencilTable;
+typedef OpenSubdiv::Osd::CLPatchTable CLPatchTable;
 typedef OpenSubdiv::Osd::CLStencilTable CLStencilTable;
 typedef OpenSubdiv::Osd::CLEvaluator CLEvaluator;
 typedef OpenSubdiv::Osd::CLVertexBuffer CLVertexBuffer;
 typedef OpenSubdiv::Osd::BufferDescriptor BufferDescriptor;
+typedef OpenSubdiv::Osd::PatchCoord PatchCoord;
 
 // CLStencilTable
 extern "C"
@@ -17,15 +21,71 @@ extern "C"
         return CLStencilTable::Create(st, clContext);
     }
 
+    /// \brief Upload a limit stencil table, including its derivative weights
+    CLStencilTable *
+    CLStencilTable_CreateFromLimit(const LimitStencilTable *st, void *clContext)
+    {
+        if (!st || !clContext) {
+            return nullptr;
+        }
+        return new CLStencilTable(st, static_cast<cl_context>(clContext));
+    }
+
     void CLStencilTable_destroy(CLStencilTable *st)
     {
         delete st;
     }
 }
 
+// CLPatchTable
+extern "C"
+{
+    CLPatchTable *CLPatchTable_Create(const PatchTable *pt, void *clContext)
+    {
+        if (!pt || !clContext) {
+            return nullptr;
+        }
+        return CLPatchTable::Create(pt, static_cast<cl_context>(clContext));
+    }
+
+    void CLPatchTable_destroy(CLPatchTable *pt)
+    {
+        delete pt;
+    }
+}
+
 // CLEvaluator
 extern "C"
 {
+    /// \brief Compile the kernels for one buffer layout
+    ///
+    /// Derivative descriptors are empty for derivatives that are not
+    /// evaluated. Returns null if compilation fails.
+    CLEvaluator *CLEvaluator_Create(
+        BufferDescriptor src_desc,
+        BufferDescriptor dst_desc,
+        BufferDescriptor du_desc,
+        BufferDescriptor dv_desc,
+        BufferDescriptor duu_desc,
+        BufferDescriptor duv_desc,
+        BufferDescriptor dvv_desc,
+        void *clContext,
+        void *clCommandQueue)
+    {
+        if (!clContext || !clCommandQueue) {
+            return nullptr;
+        }
+        return CLEvaluator::Create(
+            src_desc, dst_desc, du_desc, dv_desc, duu_desc, duv_desc, dvv_desc,
+            static_cast<cl_context>(clContext),
+            static_cast<cl_command_queue>(clCommandQueue));
+    }
+
+    void CLEvaluator_destroy(CLEvaluator *evaluator)
+    {
+        delete evaluator;
+    }
+
     bool CLEvaluator_EvalStencils(
         CLVertexBuffer *src_buffer,
         BufferDescriptor src_desc,
@@ -39,9 +99,173 @@ extern "C"
             src_buffer, src_desc, dst_buffer, dst_desc, stencil_table, kernel,
             command_queue);
     }
+
+    /// \brief Evaluate limit stencils and their derivatives on the queue of
+    /// `evaluator`
+    ///
+    /// `stencil_table` must have been created from a limit stencil table.
+    /// `du` and `dv` are required; `duu`, `duv` and `dvv` are either all null
+    /// or all given.
+    bool CLEvaluator_EvalStencilsWithDerivatives(
+        const CLEvaluator *evaluator,
+        CLVertexBuffer *src_buffer,
+        BufferDescriptor src_desc,
+        CLVertexBuffer *dst_buffer,
+        BufferDescriptor dst_desc,
+        CLVertexBuffer *du_buffer,
+        BufferDescriptor du_desc,
+        CLVertexBuffer *dv_buffer,
+        BufferDescriptor dv_desc,
+        CLVertexBuffer *duu_buffer,
+        BufferDescriptor duu_desc,
+        CLVertexBuffer *duv_buffer,
+        BufferDescriptor duv_desc,
+        CLVertexBuffer *dvv_buffer,
+        BufferDescriptor dvv_desc,
+        const CLStencilTable *stencil_table)
+    {
+        if (!evaluator || !src_buffer || !dst_buffer || !du_buffer || !dv_buffer ||
+            !stencil_table) {
+            return false;
+        }
+        if (!duu_buffer) {
+            return evaluator->EvalStencils(
+                src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc,
+                dv_buffer, dv_desc, stencil_table);
+        }
+        if (!duv_buffer || !dvv_buffer) {
+            return false;
+        }
+        return evaluator->EvalStencils(
+            src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc, dv_buffer,
+            dv_desc, duu_buffer, duu_desc, duv_buffer, duv_desc, dvv_buffer, dvv_desc,
+            stencil_table);
+    }
+
+    /// \brief Enqueue an evaluation of limit stencils with derivatives
+    /// without waiting for it
+    ///
+    /// Like CLEvaluator_EvalStencilsWithDerivatives(), but the kernels wait
+    /// for the `num_wait_events` events in `wait_events` and, if `end_event`
+    /// is not NULL, it receives an event that completes with them.
+    bool CLEvaluator_EvalStencilsWithDerivativesAsync(
+        const CLEvaluator *evaluator,
+        CLVertexBuffer *src_buffer,
+        BufferDescriptor src_desc,
+        CLVertexBuffer *dst_buffer,
+        BufferDescriptor dst_desc,
+        CLVertexBuffer *du_buffer,
+        BufferDescriptor du_desc,
+        CLVertexBuffer *dv_buffer,
+        BufferDescriptor dv_desc,
+        CLVertexBuffer *duu_buffer,
+        BufferDescriptor duu_desc,
+        CLVertexBuffer *duv_buffer,
+        BufferDescriptor duv_desc,
+        CLVertexBuffer *dvv_buffer,
+        BufferDescriptor dvv_desc,
+        const CLStencilTable *stencil_table,
+        unsigned int num_wait_events,
+        void *const *wait_events,
+        void **end_event)
+    {
+        if (!evaluator || !src_buffer || !dst_buffer || !du_buffer || !dv_buffer ||
+            !stencil_table) {
+            return false;
+        }
+        const cl_event *start_events = (const cl_event *)wait_events;
+        cl_event *event = (cl_event *)end_event;
+        if (!duu_buffer) {
+            return evaluator->EvalStencils(
+                src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc,
+                dv_buffer, dv_desc, stencil_table, num_wait_events, start_events, event);
+        }
+        if (!duv_buffer || !dvv_buffer) {
+            return false;
+        }
+        return evaluator->EvalStencils(
+            src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc, dv_buffer,
+            dv_desc, duu_buffer, duu_desc, duv_buffer, duv_desc, dvv_buffer, dvv_desc,
+            stencil_table, num_wait_events, start_events, event);
+    }
+
+    /// \brief Evaluate the limit surface at `num_patch_coords` patch
+    /// coordinates on the queue of `evaluator`
+    ///
+    /// `patch_coords` lives in host memory and is staged through
+    /// `clCommandQueue` into a device buffer of five floats per coordinate,
+    /// the layout `PatchCoord` has. Derivatives of an order are computed if
+    /// their buffers are given.
+    bool CLEvaluator_EvalPatches(
+        const CLEvaluator *evaluator,
+        CLVertexBuffer *src_buffer,
+        BufferDescriptor src_desc,
+        CLVertexBuffer *dst_buffer,
+        BufferDescriptor dst_desc,
+        CLVertexBuffer *du_buffer,
+        BufferDescriptor du_desc,
+        CLVertexBuffer *dv_buffer,
+        BufferDescriptor dv_desc,
+        CLVertexBuffer *duu_buffer,
+        BufferDescriptor duu_desc,
+        CLVertexBuffer *duv_buffer,
+        BufferDescriptor duv_desc,
+        CLVertexBuffer *dvv_buffer,
+        BufferDescriptor dvv_desc,
+        int num_patch_coords,
+        const PatchCoord *patch_coords,
+        CLPatchTable *patch_table,
+        void *clContext,
+        void *clCommandQueue)
+    {
+        if (!evaluator || !src_buffer || !dst_buffer || !patch_table ||
+            !clContext || !clCommandQueue || num_patch_coords < 0 ||
+            (num_patch_coords > 0 && !patch_coords)) {
+            return false;
+        }
+        if (num_patch_coords == 0) {
+            return true;
+        }
+        if ((du_buffer && !dv_buffer) ||
+            (duu_buffer && (!du_buffer || !duv_buffer || !dvv_buffer))) {
+            return false;
+        }
+
+        static_assert(sizeof(PatchCoord) == 5 * sizeof(float), "");
+        CLVertexBuffer *coords = CLVertexBuffer::Create(
+            5, num_patch_coords, static_cast<cl_context>(clContext));
+        if (!coords) {
+            return false;
+        }
+        coords->UpdateData(
+            reinterpret_cast<const float *>(patch_coords), 0, num_patch_coords,
+            static_cast<cl_command_queue>(clCommandQueue));
+
+        bool result;
+        if (!du_buffer) {
+            result = evaluator->EvalPatches(
+                src_buffer, src_desc, dst_buffer, dst_desc, num_patch_coords, coords,
+                patch_table);
+        } else if (!duu_buffer) {
+            result = evaluator->EvalPatches(
+                src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc,
+                dv_buffer, dv_desc, num_patch_coords, coords, patch_table);
+        } else {
+            result = evaluator->EvalPatches(
+                src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc,
+                dv_buffer, dv_desc, duu_buffer, duu_desc, duv_buffer, duv_desc,
+                dvv_buffer, dvv_desc, num_patch_coords, coords, patch_table);
+        }
+        // OpenCL keeps the released buffer alive until the enqueued kernel
+        // is done with it.
+        delete coords;
+        return result;
+    }
 }
 #else
 // Stub implementations when OpenCL is not available
+typedef void CLEvaluator;
+typedef void CLPatchTable;
 typedef void CLStencilTable;
 typedef void CLVertexBuffer;
 struct BufferDescriptor
@@ -55,9 +279,36 @@ extern "C"
     {
         return nullptr;
     }
+    CLStencilTable *CLStencilTable_CreateFromLimit(const void *, void *)
+    {
+        return nullptr;
+    }
     void CLStencilTable_destroy(CLStencilTable *)
     {
     }
+    CLPatchTable *CLPatchTable_Create(const void *, void *)
+    {
+        return nullptr;
+    }
+    void CLPatchTable_destroy(CLPatchTable *)
+    {
+    }
+    CLEvaluator *CLEvaluator_Create(
+        BufferDescriptor,
+        BufferDescriptor,
+        BufferDescriptor,
+        BufferDescriptor,
+        BufferDescriptor,
+        BufferDescriptor,
+        BufferDescriptor,
+        void *,
+        void *)
+    {
+        return nullptr;
+    }
+    void CLEvaluator_destroy(CLEvaluator *)
+    {
+    }
     bool CLEvaluator_EvalStencils(
         CLVertexBuffer *,
         BufferDescriptor,
@@ -69,5 +320,72 @@ extern "C"
     {
         return false;
     }
+    bool CLEvaluator_EvalStencilsWithDerivatives(
+        const CLEvaluator *,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        const CLStencilTable *)
+    {
+        return false;
+    }
+    bool CLEvaluator_EvalStencilsWithDerivativesAsync(
+        const CLEvaluator *,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        const CLStencilTable *,
+        unsigned int,
+        void *const *,
+        void **)
+    {
+        return false;
+    }
+    bool CLEvaluator_EvalPatches(
+        const CLEvaluator *,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        CLVertexBuffer *,
+        BufferDescriptor,
+        int,
+        const void *,
+        CLPatchTable *,
+        void *,
+        void *)
+    {
+        return false;
+    }
 }
-#endif  // OPENSUBDIV_HAS_OPENCL
\ No newline at end of file
+#endif  // OPENSUBDIV_HAS_OPENCL
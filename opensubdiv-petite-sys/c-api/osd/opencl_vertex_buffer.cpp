@@ -48,9 +48,133 @@ extern "C"
     {
         return vb->BindCLBuffer(clCommandQueue);
     }
+
+    /// \brief Enqueue a non-blocking copy of vertices from host memory into
+    /// the buffer
+    ///
+    /// The copy waits for the \p numWaitEvents events in \p waitEvents. If
+    /// \p event is not NULL it receives an event that completes with the
+    /// copy. \p src must stay valid until then. Returns false if the range is
+    /// out of bounds or the copy could not be enqueued.
+    bool CLVertexBuffer_UpdateDataAsync(
+        CLVertexBuffer *vb,
+        const float *src,
+        int startVertex,
+        int numVertices,
+        void *clCommandQueue,
+        unsigned int numWaitEvents,
+        void *const *waitEvents,
+        void **event)
+    {
+        if (startVertex < 0 || numVertices < 0 ||
+            startVertex + numVertices > vb->GetNumVertices())
+            return false;
+        size_t const stride = (size_t)vb->GetNumElements() * sizeof(float);
+        cl_command_queue queue = (cl_command_queue)clCommandQueue;
+        return clEnqueueWriteBuffer(queue, vb->BindCLBuffer(queue), CL_FALSE,
+                                    (size_t)startVertex * stride,
+                                    (size_t)numVertices * stride, src, numWaitEvents,
+                                    (const cl_event *)waitEvents,
+                                    (cl_event *)event) == CL_SUCCESS;
+    }
+
+    /// \brief Enqueue a non-blocking copy of vertices from the buffer into host
+    /// memory
+    ///
+    /// See CLVertexBuffer_UpdateDataAsync() for the event arguments. \p dst
+    /// must stay valid until the copy has completed.
+    bool CLVertexBuffer_ReadDataAsync(
+        CLVertexBuffer *vb,
+        float *dst,
+        int startVertex,
+        int numVertices,
+        void *clCommandQueue,
+        unsigned int numWaitEvents,
+        void *const *waitEvents,
+        void **event)
+    {
+        if (startVertex < 0 || numVertices < 0 ||
+            startVertex + numVertices > vb->GetNumVertices())
+            return false;
+        size_t const stride = (size_t)vb->GetNumElements() * sizeof(float);
+        cl_command_queue queue = (cl_command_queue)clCommandQueue;
+        return clEnqueueReadBuffer(queue, vb->BindCLBuffer(queue), CL_FALSE,
+                                   (size_t)startVertex * stride,
+                                   (size_t)numVertices * stride, dst, numWaitEvents,
+                                   (const cl_event *)waitEvents,
+                                   (cl_event *)event) == CL_SUCCESS;
+    }
+
+    /// \brief Allocate host memory the device can transfer from directly
+    ///
+    /// Creates a CL_MEM_ALLOC_HOST_PTR buffer of \p bytes and maps it for
+    /// reading and writing. Returns the mapped host pointer and stores the
+    /// buffer object in \p mem, or returns NULL if error.
+    void *CLPinnedBuffer_Create(void *clContext, void *clCommandQueue, size_t bytes,
+                                void **mem)
+    {
+        cl_int err = CL_SUCCESS;
+        cl_mem buffer = clCreateBuffer((cl_context)clContext,
+                                       CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, bytes,
+                                       nullptr, &err);
+        if (err != CL_SUCCESS)
+            return nullptr;
+        void *host = clEnqueueMapBuffer((cl_command_queue)clCommandQueue, buffer, CL_TRUE,
+                                        CL_MAP_READ | CL_MAP_WRITE, 0, bytes, 0, nullptr,
+                                        nullptr, &err);
+        if (err != CL_SUCCESS)
+        {
+            clReleaseMemObject(buffer);
+            return nullptr;
+        }
+        *mem = buffer;
+        return host;
+    }
+
+    /// \brief Destructor. Unmaps \p host and releases \p mem.
+    void CLPinnedBuffer_destroy(void *clCommandQueue, void *mem, void *host)
+    {
+        cl_command_queue queue = (cl_command_queue)clCommandQueue;
+        clEnqueueUnmapMemObject(queue, (cl_mem)mem, host, 0, nullptr, nullptr);
+        clFinish(queue);
+        clReleaseMemObject((cl_mem)mem);
+    }
+
+    /// \brief Returns 1 if \p event has completed, 0 if it is still pending
+    /// and -1 on error
+    int CLEvent_Status(void *event)
+    {
+        cl_int status = CL_SUCCESS;
+        if (clGetEventInfo((cl_event)event, CL_EVENT_COMMAND_EXECUTION_STATUS,
+                           sizeof(status), &status, nullptr) != CL_SUCCESS ||
+            status < 0)
+            return -1;
+        return status == CL_COMPLETE ? 1 : 0;
+    }
+
+    /// \brief Block until \p event has completed
+    bool CLEvent_Wait(void *event)
+    {
+        cl_event e = (cl_event)event;
+        return clWaitForEvents(1, &e) == CL_SUCCESS;
+    }
+
+    /// \brief Add a reference to \p event
+    void CLEvent_retain(void *event)
+    {
+        clRetainEvent((cl_event)event);
+    }
+
+    /// \brief Destructor.
+    void CLEvent_release(void *event)
+    {
+        clReleaseEvent((cl_event)event);
+    }
 }
 #else
 // Stub implementations when OpenCL is not available
+#include <cstddef>
+
 typedef void CLVertexBuffer;
 
 extern "C"
@@ -77,5 +201,36 @@ extern "C"
     {
         return nullptr;
     }
+    bool CLVertexBuffer_UpdateDataAsync(CLVertexBuffer *, const float *, int, int, void *,
+                                        unsigned int, void *const *, void **)
+    {
+        return false;
+    }
+    bool CLVertexBuffer_ReadDataAsync(CLVertexBuffer *, float *, int, int, void *,
+                                      unsigned int, void *const *, void **)
+    {
+        return false;
+    }
+    void *CLPinnedBuffer_Create(void *, void *, size_t, void **)
+    {
+        return nullptr;
+    }
+    void CLPinnedBuffer_destroy(void *, void *, void *)
+    {
+    }
+    int CLEvent_Status(void *)
+    {
+        return -1;
+    }
+    bool CLEvent_Wait(void *)
+    {
+        return false;
+    }
+    void CLEvent_retain(void *)
+    {
+    }
+    void CLEvent_release(void *)
+    {
+    }
 }
 #endif  // OPENSUBDIV_HAS_OPENCL
\ No newline at end of file
@@ -2,9 +2,14 @@
 #include <opensubdiv/osd/cpuVertexBuffer.h>
 #include <opensubdiv/osd/tbbEvaluator.h>
 
+#include "cpu_evaluation.hpp"
+
+typedef OpenSubdiv::Far::LimitStencilTable LimitStencilTable;
 typedef OpenSubdiv::Far::StencilTable StencilTable;
 typedef OpenSubdiv::Osd::BufferDescriptor BufferDescriptor;
+typedef OpenSubdiv::Osd::CpuPatchTable CpuPatchTable;
 typedef OpenSubdiv::Osd::CpuVertexBuffer CpuVertexBuffer;
+typedef OpenSubdiv::Osd::PatchCoord PatchCoord;
 
 extern "C"
 {
@@ -18,4 +23,62 @@ extern "C"
         return OpenSubdiv::Osd::TbbEvaluator::EvalStencils(
             src_buffer, src_desc, dst_buffer, dst_desc, stencil_table);
     }
+
+    /// \brief Evaluate limit stencils and their derivatives
+    ///
+    /// `du` and `dv` are required. `duu`, `duv` and `dvv` are either all
+    /// null or all given, in which case `stencil_table` must hold 2nd
+    /// derivative weights.
+    bool TbbEvaluator_EvalStencilsWithDerivatives(
+        CpuVertexBuffer *src_buffer,
+        BufferDescriptor src_desc,
+        CpuVertexBuffer *dst_buffer,
+        BufferDescriptor dst_desc,
+        CpuVertexBuffer *du_buffer,
+        BufferDescriptor du_desc,
+        CpuVertexBuffer *dv_buffer,
+        BufferDescriptor dv_desc,
+        CpuVertexBuffer *duu_buffer,
+        BufferDescriptor duu_desc,
+        CpuVertexBuffer *duv_buffer,
+        BufferDescriptor duv_desc,
+        CpuVertexBuffer *dvv_buffer,
+        BufferDescriptor dvv_desc,
+        const LimitStencilTable *stencil_table)
+    {
+        return CpuEvaluation::evalStencils<OpenSubdiv::Osd::TbbEvaluator>(
+            src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc, dv_buffer,
+            dv_desc, duu_buffer, duu_desc, duv_buffer, duv_desc, dvv_buffer, dvv_desc,
+            stencil_table);
+    }
+
+    /// \brief Evaluate the limit surface at `num_patch_coords` patch
+    /// coordinates
+    ///
+    /// Derivatives of an order are computed if their buffers are given;
+    /// `du` and `dv`, and `duu`, `duv` and `dvv`, go together.
+    bool TbbEvaluator_EvalPatches(
+        CpuVertexBuffer *src_buffer,
+        BufferDescriptor src_desc,
+        CpuVertexBuffer *dst_buffer,
+        BufferDescriptor dst_desc,
+        CpuVertexBuffer *du_buffer,
+        BufferDescriptor du_desc,
+        CpuVertexBuffer *dv_buffer,
+        BufferDescriptor dv_desc,
+        CpuVertexBuffer *duu_buffer,
+        BufferDescriptor duu_desc,
+        CpuVertexBuffer *duv_buffer,
+        BufferDescriptor duv_desc,
+        CpuVertexBuffer *dvv_buffer,
+        BufferDescriptor dvv_desc,
+        int num_patch_coords,
+        const PatchCoord *patch_coords,
+        const CpuPatchTable *patch_table)
+    {
+        return CpuEvaluation::evalPatches<OpenSubdiv::Osd::TbbEvaluator>(
+            src_buffer, src_desc, dst_buffer, dst_desc, du_buffer, du_desc, dv_buffer,
+            dv_desc, duu_buffer, duu_desc, duv_buffer, duv_desc, dvv_buffer, dvv_desc,
+            num_patch_coords, patch_coords, patch_table);
+    }
 }
@@ -1,3 +1,4 @@
 //! Low-level bindings for OpenSubdiv's BFR module.
 
 pub mod surface_factory;
+pub mod tessellation;
@@ -1,6 +1,7 @@
 #![allow(non_camel_case_types)]
 
 use crate::far::topology_refiner::TopologyRefinerPtr;
+use crate::osd::BufferDescriptor;
 
 #[repr(C)]
 pub struct Bfr_SurfaceFactory_f {
@@ -12,6 +13,11 @@ pub struct Bfr_Surface_f {
     _private: [u8; 0],
 }
 
+#[repr(C)]
+pub struct Bfr_SurfaceFactoryCache_f {
+    _private: [u8; 0],
+}
+
 #[link(name = "osd-capi", kind = "static")]
 unsafe extern "C" {
     pub fn Bfr_SurfaceFactory_Create(
@@ -20,8 +26,23 @@ unsafe extern "C" {
         approx_level_sharp: ::std::os::raw::c_int,
     ) -> *mut Bfr_SurfaceFactory_f;
 
+    /// Creates a factory sharing `cache`, which must outlive it. A null
+    /// `cache` uses the factory's internal cache.
+    pub fn Bfr_SurfaceFactory_CreateWithCache(
+        refiner: TopologyRefinerPtr,
+        approx_level_smooth: ::std::os::raw::c_int,
+        approx_level_sharp: ::std::os::raw::c_int,
+        cache: *mut Bfr_SurfaceFactoryCache_f,
+    ) -> *mut Bfr_SurfaceFactory_f;
+
     pub fn Bfr_SurfaceFactory_Destroy(factory: *mut Bfr_SurfaceFactory_f);
 
+    pub fn Bfr_SurfaceFactoryCache_Create() -> *mut Bfr_SurfaceFactoryCache_f;
+    pub fn Bfr_SurfaceFactoryCache_Destroy(cache: *mut Bfr_SurfaceFactoryCache_f);
+    pub fn Bfr_SurfaceFactoryCache_GetNumEntries(
+        cache: *const Bfr_SurfaceFactoryCache_f,
+    ) -> ::std::os::raw::c_int;
+
     pub fn Bfr_Surface_Create() -> *mut Bfr_Surface_f;
     pub fn Bfr_Surface_Destroy(surface: *mut Bfr_Surface_f);
 
@@ -31,6 +52,39 @@ unsafe extern "C" {
         surface: *mut Bfr_Surface_f,
     ) -> bool;
 
+    /// Initializes the varying surface of a face, whose control points index
+    /// the mesh vertices.
+    pub fn Bfr_SurfaceFactory_InitVaryingSurface(
+        factory: *const Bfr_SurfaceFactory_f,
+        face_index: ::std::os::raw::c_int,
+        surface: *mut Bfr_Surface_f,
+    ) -> bool;
+
+    /// Initializes the surface of face-varying channel `fvar_channel` of a
+    /// face, whose control points index the channel's values.
+    pub fn Bfr_SurfaceFactory_InitFaceVaryingSurface(
+        factory: *const Bfr_SurfaceFactory_f,
+        face_index: ::std::os::raw::c_int,
+        fvar_channel: ::std::os::raw::c_int,
+        surface: *mut Bfr_Surface_f,
+    ) -> bool;
+
+    /// Initializes the vertex surface of a face and, if non-null, its
+    /// varying surface and the surface of face-varying channel
+    /// `fvar_channel` in one pass over the face's neighborhood.
+    pub fn Bfr_SurfaceFactory_InitSurfaces(
+        factory: *const Bfr_SurfaceFactory_f,
+        face_index: ::std::os::raw::c_int,
+        vertex_surface: *mut Bfr_Surface_f,
+        varying_surface: *mut Bfr_Surface_f,
+        fvar_channel: ::std::os::raw::c_int,
+        fvar_surface: *mut Bfr_Surface_f,
+    ) -> bool;
+
+    pub fn Bfr_SurfaceFactory_GetNumFVarChannels(
+        factory: *const Bfr_SurfaceFactory_f,
+    ) -> ::std::os::raw::c_int;
+
     pub fn Bfr_Surface_IsValid(surface: *const Bfr_Surface_f) -> bool;
 
     pub fn Bfr_Surface_IsRegular(surface: *const Bfr_Surface_f) -> bool;
@@ -61,4 +115,35 @@ unsafe extern "C" {
         mesh_stride: ::std::os::raw::c_int,
         out_p3: *mut f32,
     ) -> bool;
+
+    /// Gathers `point_size`-component patch points densely into caller
+    /// memory, reading mesh points with `mesh_stride`. Fails if the surface
+    /// references a control point at or beyond `num_mesh_points`.
+    pub fn Bfr_Surface_PreparePatchPoints(
+        surface: *const Bfr_Surface_f,
+        mesh_points: *const f32,
+        num_mesh_points: ::std::os::raw::c_int,
+        point_size: ::std::os::raw::c_int,
+        mesh_stride: ::std::os::raw::c_int,
+        out_patch_points: *mut f32,
+        max_points: ::std::os::raw::c_int,
+    ) -> bool;
+
+    /// Evaluates `num_points` (u,v) pairs from prepared patch points. Any
+    /// of the `dst_*` buffers may be null.
+    pub fn Bfr_Surface_EvaluatePoints(
+        surface: *const Bfr_Surface_f,
+        patch_points: *const f32,
+        point_size: ::std::os::raw::c_int,
+        num_points: ::std::os::raw::c_int,
+        u: *const f32,
+        v: *const f32,
+        dst_p: *mut f32,
+        dst_du: *mut f32,
+        dst_dv: *mut f32,
+        dst_duu: *mut f32,
+        dst_duv: *mut f32,
+        dst_dvv: *mut f32,
+        dst_desc: BufferDescriptor,
+    ) -> bool;
 }
@@ -0,0 +1,42 @@
+#![allow(non_camel_case_types)]
+
+use super::surface_factory::{Bfr_Surface_f, Bfr_SurfaceFactory_f};
+use std::os::raw::c_int;
+
+#[link(name = "osd-capi", kind = "static")]
+unsafe extern "C" {
+    pub fn Bfr_SurfaceFactory_FaceHasLimitSurface(
+        factory: *const Bfr_SurfaceFactory_f,
+        face: c_int,
+    ) -> bool;
+
+    /// Counts the coordinates and facets tessellating `face` at `rates`
+    /// would produce, without building its surface.
+    pub fn Bfr_SurfaceFactory_GetTessellationCounts(
+        factory: *const Bfr_SurfaceFactory_f,
+        face: c_int,
+        num_rates: c_int,
+        rates: *const c_int,
+        facet_size: c_int,
+        num_boundary_coords: *mut c_int,
+        num_interior_coords: *mut c_int,
+        num_facets: *mut c_int,
+    ) -> bool;
+
+    /// Tessellates a prepared 3-component surface into shared mesh buffers.
+    /// Only boundary coordinates flagged in `boundary_owned` are evaluated.
+    pub fn Bfr_Surface_Tessellate(
+        surface: *const Bfr_Surface_f,
+        patch_points: *const f32,
+        num_rates: c_int,
+        rates: *const c_int,
+        facet_size: c_int,
+        boundary_indices: *const c_int,
+        boundary_owned: *const u8,
+        num_boundary_coords: c_int,
+        interior_offset: c_int,
+        dst_points: *mut f32,
+        dst_normals: *mut f32,
+        dst_facets: *mut c_int,
+    ) -> bool;
+}
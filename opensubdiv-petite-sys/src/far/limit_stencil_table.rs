@@ -78,6 +78,23 @@ impl LimitStencilTableFactoryOptions {
 
 #[link(name = "osd-capi", kind = "static")]
 unsafe extern "C" {
+    /// Creates a table from `num_stencils` sizes and the concatenated indices
+    /// and weights of the stencils. Derivative weights may be null; null is
+    /// returned if a size is negative or an index is out of range.
+    #[allow(clippy::too_many_arguments)]
+    pub fn LimitStencilTable_CreateFromArrays(
+        num_control_vertices: i32,
+        num_stencils: i32,
+        sizes: *const i32,
+        indices: *const Index,
+        weights: *const f32,
+        du_weights: *const f32,
+        dv_weights: *const f32,
+        duu_weights: *const f32,
+        duv_weights: *const f32,
+        dvv_weights: *const f32,
+    ) -> LimitStencilTablePtr;
+
     pub fn LimitStencilTable_destroy(table: LimitStencilTablePtr);
 
     pub fn LimitStencilTable_GetDuWeights(table: LimitStencilTablePtr) -> FloatVectorRef;
@@ -95,4 +112,22 @@ unsafe extern "C" {
         options_bitfield: u32,
         fvar_channel: u32,
     ) -> LimitStencilTablePtr;
+
+    /// Builds the control vertex stencils, including local points, and the
+    /// patch table `LimitStencilTableFactory_Create()` builds when passed
+    /// null. Returns `false`, with both outputs null, on failure.
+    pub fn LimitStencilTableFactory_CreateSupport(
+        refiner: *const crate::OpenSubdiv_v3_7_0_Far_TopologyRefiner,
+        options_bitfield: u32,
+        fvar_channel: u32,
+        cv_stencils: *mut *const std::ffi::c_void,
+        patch_table: *mut *mut crate::far::patch_table::PatchTable,
+    ) -> bool;
+
+    /// Joins `num_tables` tables in order. Returns null if there are none or
+    /// they differ in their control vertices or derivative weights.
+    pub fn LimitStencilTable_Concatenate(
+        tables: *const LimitStencilTablePtr,
+        num_tables: i32,
+    ) -> LimitStencilTablePtr;
 }
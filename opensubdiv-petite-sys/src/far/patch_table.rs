@@ -1,6 +1,7 @@
 //! FFI bindings for OpenSubdiv Far::PatchTable and related types
 
 use crate::far::TopologyRefiner;
+use crate::osd::BufferDescriptor;
 use std::os::raw::{c_float, c_int};
 
 /// Opaque type for Far::PatchTable
@@ -29,6 +30,20 @@ pub struct PatchParam {
     _data: [u32; 3], // Size of actual C++ PatchParam
 }
 
+impl PatchParam {
+    /// Returns the packed `field0` and `field1` words of the C++ type.
+    pub fn bits(&self) -> [u32; 2] {
+        [self._data[0], self._data[1]]
+    }
+
+    /// Creates a parameter from words returned by [`bits()`](Self::bits).
+    pub fn from_bits(bits: [u32; 2]) -> Self {
+        Self {
+            _data: [bits[0], bits[1], 0],
+        }
+    }
+}
+
 /// PatchDescriptor types
 #[repr(C)]
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
@@ -145,10 +160,19 @@ unsafe extern "C" {
 
     // PatchParam functions
     pub fn PatchParam_GetUV(param: *const PatchParam, u: *mut c_float, v: *mut c_float);
+    pub fn PatchParam_GetFaceId(param: *const PatchParam) -> c_int;
     pub fn PatchParam_GetDepth(param: *const PatchParam) -> c_int;
     pub fn PatchParam_IsRegular(param: *const PatchParam) -> bool;
     pub fn PatchParam_GetBoundary(param: *const PatchParam) -> c_int;
     pub fn PatchParam_GetTransition(param: *const PatchParam) -> c_int;
+    pub fn PatchParam_Normalize(param: *const PatchParam, u: *mut c_float, v: *mut c_float);
+    pub fn PatchParam_Unnormalize(param: *const PatchParam, u: *mut c_float, v: *mut c_float);
+    pub fn PatchParam_NormalizeTriangle(param: *const PatchParam, u: *mut c_float, v: *mut c_float);
+    pub fn PatchParam_UnnormalizeTriangle(
+        param: *const PatchParam,
+        u: *mut c_float,
+        v: *mut c_float,
+    );
 }
 
 // Patch evaluation structures and functions
@@ -162,6 +186,18 @@ pub struct PatchEvalResult {
     pub dvv: [f32; 3],
 }
 
+/// Mirrors `Far::PatchTable::PatchHandle`.
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct PatchHandle {
+    /// Index of the patch array.
+    pub array_index: c_int,
+    /// Table-global index of the patch.
+    pub patch_index: c_int,
+    /// Offset of the patch's first control vertex in the CV table.
+    pub vert_index: c_int,
+}
+
 /// Opaque type for Far::PatchMap
 #[repr(C)]
 pub struct PatchMap {
@@ -183,6 +219,19 @@ unsafe extern "C" {
         w_dvv: *mut c_float,
     ) -> bool;
 
+    pub fn PatchTable_EvaluateBasisHandle(
+        table: *const PatchTable,
+        handle: *const PatchHandle,
+        u: c_float,
+        v: c_float,
+        w_p: *mut c_float,
+        w_du: *mut c_float,
+        w_dv: *mut c_float,
+        w_duu: *mut c_float,
+        w_duv: *mut c_float,
+        w_dvv: *mut c_float,
+    ) -> bool;
+
     pub fn PatchTable_EvaluatePoint(
         table: *const PatchTable,
         patch_index: c_int,
@@ -193,10 +242,54 @@ unsafe extern "C" {
         result: *mut PatchEvalResult,
     ) -> bool;
 
+    /// Evaluates `num_points` points given as SoA (patch index, u, v) arrays.
+    ///
+    /// Any of the `dst_*` buffers may be null. Returns the number of points
+    /// evaluated or `-1` for invalid arguments.
+    pub fn PatchTable_EvaluatePoints(
+        table: *const PatchTable,
+        num_points: c_int,
+        patch_indices: *const c_int,
+        u: *const c_float,
+        v: *const c_float,
+        src: *const c_float,
+        src_desc: BufferDescriptor,
+        dst_p: *mut c_float,
+        dst_du: *mut c_float,
+        dst_dv: *mut c_float,
+        dst_duu: *mut c_float,
+        dst_duv: *mut c_float,
+        dst_dvv: *mut c_float,
+        dst_desc: BufferDescriptor,
+    ) -> c_int;
+
+    /// Evaluates `num_points` points given as SoA (ptex face, u, v) arrays.
+    ///
+    /// Points that `map` cannot locate are not evaluated. Returns the number
+    /// of points evaluated or `-1` for invalid arguments.
+    pub fn PatchTable_EvaluateFacePoints(
+        table: *const PatchTable,
+        map: *const PatchMap,
+        num_points: c_int,
+        face_indices: *const c_int,
+        u: *const c_float,
+        v: *const c_float,
+        src: *const c_float,
+        src_desc: BufferDescriptor,
+        dst_p: *mut c_float,
+        dst_du: *mut c_float,
+        dst_dv: *mut c_float,
+        dst_duu: *mut c_float,
+        dst_duv: *mut c_float,
+        dst_dvv: *mut c_float,
+        dst_desc: BufferDescriptor,
+    ) -> c_int;
+
     // PatchMap functions
     pub fn PatchMap_Create(table: *const PatchTable) -> *mut PatchMap;
     pub fn PatchMap_delete(map: *mut PatchMap);
     pub fn PatchMap_FindPatch(
+        table: *const PatchTable,
         map: *const PatchMap,
         face_index: c_int,
         u: c_float,
@@ -205,4 +298,21 @@ unsafe extern "C" {
         patch_u: *mut c_float,
         patch_v: *mut c_float,
     ) -> bool;
+
+    /// Locates `num_queries` (face, u, v) queries in one call.
+    ///
+    /// `patch_u`/`patch_v` may both be null. Unlocated queries get patch
+    /// index `-1`. Returns the number of located queries or `-1` for invalid
+    /// arguments.
+    pub fn PatchMap_FindPatches(
+        table: *const PatchTable,
+        map: *const PatchMap,
+        num_queries: c_int,
+        face_indices: *const c_int,
+        u: *const c_float,
+        v: *const c_float,
+        patch_indices: *mut c_int,
+        patch_u: *mut c_float,
+        patch_v: *mut c_float,
+    ) -> c_int;
 }
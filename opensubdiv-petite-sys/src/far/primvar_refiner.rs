@@ -1,3 +1,5 @@
+use crate::osd::BufferDescriptor;
+
 pub type PrimvarRefinerPtr = *mut crate::OpenSubdiv_v3_7_0_Far_PrimvarRefiner;
 
 #[link(name = "osd-capi", kind = "static")]
@@ -11,26 +13,65 @@ unsafe extern "C" {
         level: i32,
         src: *const f32,
         dst: *mut f32,
-    );
+    ) -> bool;
     pub fn PrimvarRefiner_InterpolateVarying(
         pr: PrimvarRefinerPtr,
         num_elements: i32,
         level: i32,
         src: *const f32,
         dst: *mut f32,
-    );
+    ) -> bool;
     pub fn PrimvarRefiner_InterpolateFaceUniform(
         pr: PrimvarRefinerPtr,
         num_elements: i32,
         level: i32,
         src: *const f32,
         dst: *mut f32,
-    );
+    ) -> bool;
     pub fn PrimvarRefiner_InterpolateFaceVarying(
         pr: PrimvarRefinerPtr,
         num_elements: i32,
         level: i32,
         src: *const f32,
         dst: *mut f32,
-    );
+    ) -> bool;
+
+    /// Refines interleaved primvars from `level - 1` to `level` using vertex
+    /// (0), varying (1), face-uniform (2) or face-varying (3)
+    /// `interpolation`. `channel` is only used by face-varying interpolation.
+    pub fn PrimvarRefiner_InterpolateWithDescriptors(
+        pr: PrimvarRefinerPtr,
+        interpolation: i32,
+        level: i32,
+        channel: i32,
+        src: *const f32,
+        src_desc: BufferDescriptor,
+        dst: *mut f32,
+        dst_desc: BufferDescriptor,
+    ) -> bool;
+
+    /// Refines primvars through levels `1..=max_level` of one buffer that
+    /// holds all levels back to back; the base level must be filled in.
+    pub fn PrimvarRefiner_InterpolateLevels(
+        pr: PrimvarRefinerPtr,
+        interpolation: i32,
+        channel: i32,
+        max_level: i32,
+        buffer: *mut f32,
+        desc: BufferDescriptor,
+    ) -> bool;
+
+    /// Refines base level primvars straight to `level`, ping-ponging the
+    /// intermediate levels between `scratch` and `dst`.
+    pub fn PrimvarRefiner_InterpolateToLevel(
+        pr: PrimvarRefinerPtr,
+        interpolation: i32,
+        channel: i32,
+        level: i32,
+        src: *const f32,
+        src_desc: BufferDescriptor,
+        scratch: *mut f32,
+        dst: *mut f32,
+        dst_desc: BufferDescriptor,
+    ) -> bool;
 }
@@ -1,3 +1,4 @@
+use crate::osd::BufferDescriptor;
 use crate::vtr::types::*;
 
 // The C++ struct uses bitfields packed into two unsigned ints:
@@ -109,6 +110,34 @@ unsafe extern "C" {
         options: StencilTableOptions,
     ) -> StencilTablePtr;
 
+    /// Concatenates `num_tables` tables indexing the same number of control
+    /// vertices into a new table; null on mismatch.
+    pub fn StencilTableFactory_CreateConcatenated(
+        num_tables: i32,
+        tables: *const StencilTablePtr,
+    ) -> StencilTablePtr;
+
+    /// Appends `local_points` to `base`, which must hold the stencils of all
+    /// refined vertices. With `factorize`, the local point stencils are
+    /// expressed in terms of the base control vertices.
+    pub fn StencilTableFactory_AppendLocalPointStencilTable(
+        refiner: *const crate::OpenSubdiv_v3_7_0_Far_TopologyRefiner,
+        base: StencilTablePtr,
+        local_points: StencilTablePtr,
+        factorize: bool,
+    ) -> StencilTablePtr;
+
+    /// Creates a table from `num_stencils` sizes and the concatenated indices
+    /// and weights of the stencils; null if a size is negative or an index
+    /// is out of range.
+    pub fn StencilTable_CreateFromArrays(
+        num_control_vertices: i32,
+        num_stencils: i32,
+        sizes: *const i32,
+        indices: *const Index,
+        weights: *const f32,
+    ) -> StencilTablePtr;
+
     pub fn StencilTable_destroy(st: StencilTablePtr);
     /// Returns the number of stencils in the table
     pub fn StencilTable_GetNumStencils(st: StencilTablePtr) -> u32;
@@ -132,4 +161,18 @@ unsafe extern "C" {
         start: i32,
         end: i32,
     );
+    /// Update interleaved values in place by applying the stencil table.
+    ///
+    /// Reads and writes `src_desc.length` elements per point, honoring each
+    /// descriptor's offset and stride. Returns `false` if the descriptors are
+    /// invalid or their lengths differ.
+    pub fn StencilTable_UpdateValuesWithDescriptors(
+        st: StencilTablePtr,
+        src: *const f32,
+        src_desc: BufferDescriptor,
+        dst: *mut f32,
+        dst_desc: BufferDescriptor,
+        start: i32,
+        end: i32,
+    ) -> bool;
 }
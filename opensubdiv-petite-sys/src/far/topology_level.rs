@@ -69,6 +69,35 @@ unsafe extern "C" {
         e: Index,
     ) -> ConstLocalIndexArray;
 
+    /// Fill the `face count + 1` row offsets of the face-vertex relation and
+    /// return all face-vertices as one array, or an array without data if
+    /// they are not stored back to back
+    pub fn TopologyLevel_GetFaceVerticesCsr(
+        tl: TopologyLevelPtr,
+        offsets: *mut i32,
+    ) -> ConstIndexArray;
+    /// Copy the face-vertices of all faces into `dst`
+    pub fn TopologyLevel_CopyFaceVertices(tl: TopologyLevelPtr, dst: *mut Index);
+
+    /// Return the vertex pairs of all edges as one array, or an array without
+    /// data if they are not stored back to back; `offsets` may be null
+    pub fn TopologyLevel_GetEdgeVerticesCsr(
+        tl: TopologyLevelPtr,
+        offsets: *mut i32,
+    ) -> ConstIndexArray;
+    /// Copy the vertex pairs of all edges into `dst`
+    pub fn TopologyLevel_CopyEdgeVertices(tl: TopologyLevelPtr, dst: *mut Index);
+
+    /// Fill the `vertex count + 1` row offsets of the vertex-face relation and
+    /// return the incident faces of all vertices as one array, or an array
+    /// without data if they are not stored back to back
+    pub fn TopologyLevel_GetVertexFacesCsr(
+        tl: TopologyLevelPtr,
+        offsets: *mut i32,
+    ) -> ConstIndexArray;
+    /// Copy the incident faces of all vertices into `dst`
+    pub fn TopologyLevel_CopyVertexFaces(tl: TopologyLevelPtr, dst: *mut Index);
+
     /// Identify the edge matching the given vertex pair
     pub fn TopologyLevel_FindEdge(tl: TopologyLevelPtr, v0: Index, v1: Index) -> Index;
 
@@ -99,6 +128,12 @@ unsafe extern "C" {
     /// Return the sharpness assigned a given vertex
     pub fn TopologyLevel_GetVertexSharpness(tl: TopologyLevelPtr, v: Index) -> f32;
 
+    /// Write the sharpness of every edge into `dst`
+    pub fn TopologyLevel_GetEdgeSharpnesses(tl: TopologyLevelPtr, dst: *mut f32);
+
+    /// Write the sharpness of every vertex into `dst`
+    pub fn TopologyLevel_GetVertexSharpnesses(tl: TopologyLevelPtr, dst: *mut f32);
+
     /// Return if a given face has been tagged as a hole
     pub fn TopologyLevel_IsFaceHole(tl: TopologyLevelPtr, f: Index) -> bool;
 
@@ -152,6 +187,17 @@ unsafe extern "C" {
         channel: i32,
     ) -> ConstIndexArray;
 
+    /// Fill the `face count + 1` row offsets of the face-varying values of a
+    /// channel and return the values of all faces as one array, or an array
+    /// without data if they are not stored back to back
+    pub fn TopologyLevel_GetFaceFVarValuesCsr(
+        tl: TopologyLevelPtr,
+        channel: i32,
+        offsets: *mut i32,
+    ) -> ConstIndexArray;
+    /// Copy the face-varying values of all faces of a channel into `dst`
+    pub fn TopologyLevel_CopyFaceFVarValues(tl: TopologyLevelPtr, channel: i32, dst: *mut Index);
+
     /// Return if face-varying topology around a vertex matches
     pub fn TopologyLevel_DoesVertexFVarTopologyMatch(
         tl: TopologyLevelPtr,
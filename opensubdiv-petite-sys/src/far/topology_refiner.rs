@@ -95,6 +95,12 @@ unsafe extern "C" {
         descriptor: *const crate::OpenSubdiv_v3_7_0_Far_TopologyDescriptor,
         options: TopologyRefinerFactoryOptions,
     ) -> TopologyRefinerPtr;
+    /// \brief Create a refiner from a descriptor, copying its arrays into the
+    /// base level in bulk
+    pub fn TopologyRefinerFactory_TopologyDescriptor_CreateBulk(
+        descriptor: *const crate::OpenSubdiv_v3_7_0_Far_TopologyDescriptor,
+        options: TopologyRefinerFactoryOptions,
+    ) -> TopologyRefinerPtr;
     /// \brief Destroy a TopologyRefiner instance
     pub fn TopologyRefiner_destroy(refiner: TopologyRefinerPtr);
     /// \brief Returns true if uniform refinement has been applied
@@ -1,6 +1,7 @@
-use crate::far::StencilTablePtr;
+use crate::far::{LimitStencilTablePtr, StencilTablePtr};
 use crate::osd::BufferDescriptor;
 use crate::osd::CpuVertexBufferPtr;
+use crate::osd::{CpuPatchTablePtr, PatchCoord};
 
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
@@ -18,4 +19,92 @@ unsafe extern "C" {
         dst_desc: BufferDescriptor,
         stencil_table: StencilTablePtr,
     ) -> bool;
+    /// `du` and `dv` are required; `duu`, `duv` and `dvv` are all null or
+    /// all non-null.
+    pub fn CpuEvaluator_EvalStencilsWithDerivatives(
+        src_buffer: CpuVertexBufferPtr,
+        src_desc: BufferDescriptor,
+        dst_buffer: CpuVertexBufferPtr,
+        dst_desc: BufferDescriptor,
+        du_buffer: CpuVertexBufferPtr,
+        du_desc: BufferDescriptor,
+        dv_buffer: CpuVertexBufferPtr,
+        dv_desc: BufferDescriptor,
+        duu_buffer: CpuVertexBufferPtr,
+        duu_desc: BufferDescriptor,
+        duv_buffer: CpuVertexBufferPtr,
+        duv_desc: BufferDescriptor,
+        dvv_buffer: CpuVertexBufferPtr,
+        dvv_desc: BufferDescriptor,
+        stencil_table: LimitStencilTablePtr,
+    ) -> bool;
+    /// Null derivative buffers are not evaluated.
+    pub fn CpuEvaluator_EvalPatches(
+        src_buffer: CpuVertexBufferPtr,
+        src_desc: BufferDescriptor,
+        dst_buffer: CpuVertexBufferPtr,
+        dst_desc: BufferDescriptor,
+        du_buffer: CpuVertexBufferPtr,
+        du_desc: BufferDescriptor,
+        dv_buffer: CpuVertexBufferPtr,
+        dv_desc: BufferDescriptor,
+        duu_buffer: CpuVertexBufferPtr,
+        duu_desc: BufferDescriptor,
+        duv_buffer: CpuVertexBufferPtr,
+        duv_desc: BufferDescriptor,
+        dvv_buffer: CpuVertexBufferPtr,
+        dvv_desc: BufferDescriptor,
+        num_patch_coords: i32,
+        patch_coords: *const PatchCoord,
+        patch_table: CpuPatchTablePtr,
+    ) -> bool;
+    /// Like `CpuEvaluator_EvalStencils()`, reading and writing caller
+    /// memory in place.
+    pub fn CpuEvaluator_EvalStencilsView(
+        src: *const f32,
+        src_desc: BufferDescriptor,
+        dst: *mut f32,
+        dst_desc: BufferDescriptor,
+        stencil_table: StencilTablePtr,
+    ) -> bool;
+    /// Like `CpuEvaluator_EvalStencilsWithDerivatives()`, reading and writing
+    /// caller memory in place.
+    pub fn CpuEvaluator_EvalStencilsWithDerivativesView(
+        src: *const f32,
+        src_desc: BufferDescriptor,
+        dst: *mut f32,
+        dst_desc: BufferDescriptor,
+        du: *mut f32,
+        du_desc: BufferDescriptor,
+        dv: *mut f32,
+        dv_desc: BufferDescriptor,
+        duu: *mut f32,
+        duu_desc: BufferDescriptor,
+        duv: *mut f32,
+        duv_desc: BufferDescriptor,
+        dvv: *mut f32,
+        dvv_desc: BufferDescriptor,
+        stencil_table: LimitStencilTablePtr,
+    ) -> bool;
+    /// Like `CpuEvaluator_EvalPatches()`, reading and writing caller memory
+    /// in place.
+    pub fn CpuEvaluator_EvalPatchesView(
+        src: *const f32,
+        src_desc: BufferDescriptor,
+        dst: *mut f32,
+        dst_desc: BufferDescriptor,
+        du: *mut f32,
+        du_desc: BufferDescriptor,
+        dv: *mut f32,
+        dv_desc: BufferDescriptor,
+        duu: *mut f32,
+        duu_desc: BufferDescriptor,
+        duv: *mut f32,
+        duv_desc: BufferDescriptor,
+        dvv: *mut f32,
+        dvv_desc: BufferDescriptor,
+        num_patch_coords: i32,
+        patch_coords: *const PatchCoord,
+        patch_table: CpuPatchTablePtr,
+    ) -> bool;
 }
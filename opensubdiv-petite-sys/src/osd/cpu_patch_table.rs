@@ -0,0 +1,16 @@
+use crate::far::PatchTable;
+
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct CpuPatchTable_obj {
+    _unused: [u8; 0],
+}
+pub type CpuPatchTablePtr = *mut CpuPatchTable_obj;
+
+#[link(name = "osd-capi", kind = "static")]
+unsafe extern "C" {
+    /// Copies `patch_table` into the layout the CPU evaluators read. Returns
+    /// NULL if error.
+    pub fn CpuPatchTable_Create(patch_table: *const PatchTable) -> CpuPatchTablePtr;
+    pub fn CpuPatchTable_destroy(patch_table: CpuPatchTablePtr);
+}
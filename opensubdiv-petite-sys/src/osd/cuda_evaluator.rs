@@ -1,6 +1,7 @@
-use crate::far::StencilTablePtr;
+use crate::far::{LimitStencilTablePtr, PatchTable, StencilTablePtr};
 use crate::osd::BufferDescriptor;
 use crate::osd::CudaVertexBufferPtr;
+use crate::osd::PatchCoord;
 
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
@@ -12,11 +13,23 @@ pub type CudaStencilTablePtr = *mut CudaStencilTable_obj;
 #[link(name = "osd-capi", kind = "static")]
 unsafe extern "C" {
     pub fn CudaStencilTable_Create(st: StencilTablePtr) -> CudaStencilTablePtr;
-    // pub fn CudaStencilTable_CreateFromLimit(st: LimitStencilTablePtr) ->
-    // CudaStencilTablePtr;
+    pub fn CudaStencilTable_CreateFromLimit(st: LimitStencilTablePtr) -> CudaStencilTablePtr;
     pub fn CudaStencilTable_destroy(st: CudaStencilTablePtr);
 }
 
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct CudaPatchTable_obj {
+    _unused: [u8; 0],
+}
+pub type CudaPatchTablePtr = *mut CudaPatchTable_obj;
+
+#[link(name = "osd-capi", kind = "static")]
+unsafe extern "C" {
+    pub fn CudaPatchTable_Create(pt: *const PatchTable) -> CudaPatchTablePtr;
+    pub fn CudaPatchTable_destroy(pt: CudaPatchTablePtr);
+}
+
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
 pub struct CudaEvaluator_obj {
@@ -33,4 +46,43 @@ unsafe extern "C" {
         dst_desc: BufferDescriptor,
         stencil_table: CudaStencilTablePtr,
     ) -> bool;
+    /// `du` and `dv` are required; `duu`, `duv` and `dvv` are all null or
+    /// all non-null.
+    pub fn CudaEvaluator_EvalStencilsWithDerivatives(
+        src_buffer: CudaVertexBufferPtr,
+        src_desc: BufferDescriptor,
+        dst_buffer: CudaVertexBufferPtr,
+        dst_desc: BufferDescriptor,
+        du_buffer: CudaVertexBufferPtr,
+        du_desc: BufferDescriptor,
+        dv_buffer: CudaVertexBufferPtr,
+        dv_desc: BufferDescriptor,
+        duu_buffer: CudaVertexBufferPtr,
+        duu_desc: BufferDescriptor,
+        duv_buffer: CudaVertexBufferPtr,
+        duv_desc: BufferDescriptor,
+        dvv_buffer: CudaVertexBufferPtr,
+        dvv_desc: BufferDescriptor,
+        stencil_table: CudaStencilTablePtr,
+    ) -> bool;
+    /// Null derivative buffers are not evaluated.
+    pub fn CudaEvaluator_EvalPatches(
+        src_buffer: CudaVertexBufferPtr,
+        src_desc: BufferDescriptor,
+        dst_buffer: CudaVertexBufferPtr,
+        dst_desc: BufferDescriptor,
+        du_buffer: CudaVertexBufferPtr,
+        du_desc: BufferDescriptor,
+        dv_buffer: CudaVertexBufferPtr,
+        dv_desc: BufferDescriptor,
+        duu_buffer: CudaVertexBufferPtr,
+        duu_desc: BufferDescriptor,
+        duv_buffer: CudaVertexBufferPtr,
+        duv_desc: BufferDescriptor,
+        dvv_buffer: CudaVertexBufferPtr,
+        dvv_desc: BufferDescriptor,
+        num_patch_coords: i32,
+        patch_coords: *const PatchCoord,
+        patch_table: CudaPatchTablePtr,
+    ) -> bool;
 }
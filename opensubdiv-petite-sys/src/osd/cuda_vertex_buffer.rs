@@ -7,6 +7,11 @@ pub struct CudaVertexBuffer_obj {
 }
 pub type CudaVertexBufferPtr = *mut CudaVertexBuffer_obj;
 
+/// Opaque `cudaStream_t`.
+pub type CudaStreamPtr = *mut c_void;
+/// Opaque `cudaEvent_t`.
+pub type CudaEventPtr = *mut c_void;
+
 #[link(name = "osd-capi", kind = "static")]
 unsafe extern "C" {
     /// Creator. Returns NULL if error.
@@ -32,5 +37,52 @@ unsafe extern "C" {
     pub fn CudaVertexBuffer_GetNumVertices(vb: CudaVertexBufferPtr) -> i32;
     /// Returns the address of CPU buffer
     pub fn CudaVertexBuffer_BindCudaBuffer(vb: CudaVertexBufferPtr) -> *const f32;
+    /// Asynchronously copy vertices from pinned host memory into the buffer.
+    ///
+    /// Returns false if the range is out of bounds or the copy could not be
+    /// enqueued.
+    pub fn CudaVertexBuffer_UpdateDataAsync(
+        vb: CudaVertexBufferPtr,
+        src: *const f32,
+        start_vertex: i32,
+        num_vertices: i32,
+        stream: CudaStreamPtr,
+    ) -> bool;
+    /// Asynchronously copy vertices from the buffer into pinned host memory.
+    ///
+    /// Returns false if the range is out of bounds or the copy could not be
+    /// enqueued.
+    pub fn CudaVertexBuffer_ReadDataAsync(
+        vb: CudaVertexBufferPtr,
+        dst: *mut f32,
+        start_vertex: i32,
+        num_vertices: i32,
+        stream: CudaStreamPtr,
+    ) -> bool;
+
+    /// Create a non-blocking stream. Returns NULL if error.
+    pub fn CudaStream_Create() -> CudaStreamPtr;
+    /// Destructor.
+    pub fn CudaStream_destroy(stream: CudaStreamPtr);
+    /// Block until all work enqueued on `stream` has finished.
+    pub fn CudaStream_Synchronize(stream: CudaStreamPtr) -> bool;
+    /// Make all future work on `stream` wait for `event`.
+    pub fn CudaStream_WaitEvent(stream: CudaStreamPtr, event: CudaEventPtr) -> bool;
 
+    /// Create an event without timing data. Returns NULL if error.
+    pub fn CudaEvent_Create() -> CudaEventPtr;
+    /// Destructor.
+    pub fn CudaEvent_destroy(event: CudaEventPtr);
+    /// Record `event` at the current end of `stream`.
+    pub fn CudaEvent_Record(event: CudaEventPtr, stream: CudaStreamPtr) -> bool;
+    /// Returns 1 if the work before `event` has finished, 0 if it is still
+    /// pending and -1 on error.
+    pub fn CudaEvent_Query(event: CudaEventPtr) -> i32;
+    /// Block until the work before `event` has finished.
+    pub fn CudaEvent_Synchronize(event: CudaEventPtr) -> bool;
+
+    /// Allocate page-locked host memory. Returns NULL if error.
+    pub fn CudaHostBuffer_Create(bytes: usize) -> *mut c_void;
+    /// Destructor.
+    pub fn CudaHostBuffer_destroy(ptr: *mut c_void);
 }
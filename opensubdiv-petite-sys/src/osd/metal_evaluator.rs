@@ -1,6 +1,7 @@
-use crate::far::StencilTablePtr;
+use crate::far::{LimitStencilTablePtr, PatchTable, StencilTablePtr};
 use crate::osd::BufferDescriptor;
 use crate::osd::MetalVertexBufferPtr;
+use crate::osd::PatchCoord;
 use std::os::raw::c_void;
 
 #[repr(C)]
@@ -11,14 +12,34 @@ pub struct MetalStencilTable_obj {
 pub type MetalStencilTablePtr = *mut MetalStencilTable_obj;
 
 #[link(name = "osd-capi", kind = "static")]
-extern "C" {
+unsafe extern "C" {
     pub fn MTLStencilTable_Create(
         st: StencilTablePtr,
         context: *const c_void,
     ) -> MetalStencilTablePtr;
+    pub fn MTLStencilTable_CreateFromLimit(
+        st: LimitStencilTablePtr,
+        context: *const c_void,
+    ) -> MetalStencilTablePtr;
     pub fn MTLStencilTable_destroy(st: MetalStencilTablePtr);
 }
 
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct MetalPatchTable_obj {
+    _unused: [u8; 0],
+}
+pub type MetalPatchTablePtr = *mut MetalPatchTable_obj;
+
+#[link(name = "osd-capi", kind = "static")]
+unsafe extern "C" {
+    pub fn MTLPatchTable_Create(
+        pt: *const PatchTable,
+        context: *const c_void,
+    ) -> MetalPatchTablePtr;
+    pub fn MTLPatchTable_destroy(pt: MetalPatchTablePtr);
+}
+
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
 pub struct MetalComputeEvaluator_obj {
@@ -27,7 +48,20 @@ pub struct MetalComputeEvaluator_obj {
 pub type MetalComputeEvaluatorPtr = *mut MetalComputeEvaluator_obj;
 
 #[link(name = "osd-capi", kind = "static")]
-extern "C" {
+unsafe extern "C" {
+    /// Empty derivative descriptors disable those outputs. Returns NULL if
+    /// the pipelines fail to compile.
+    pub fn MTLComputeEvaluator_Create(
+        src_desc: BufferDescriptor,
+        dst_desc: BufferDescriptor,
+        du_desc: BufferDescriptor,
+        dv_desc: BufferDescriptor,
+        duu_desc: BufferDescriptor,
+        duv_desc: BufferDescriptor,
+        dvv_desc: BufferDescriptor,
+        context: *const c_void,
+    ) -> MetalComputeEvaluatorPtr;
+    pub fn MTLComputeEvaluator_destroy(evaluator: MetalComputeEvaluatorPtr);
     pub fn MTLComputeEvaluator_EvalStencils(
         src_buffer: MetalVertexBufferPtr,
         src_desc: BufferDescriptor,
@@ -37,4 +71,47 @@ extern "C" {
         command_buffer: *const c_void,
         compute_encoder: *const c_void,
     ) -> bool;
+    /// `du` and `dv` are required; `duu`, `duv` and `dvv` are all null or
+    /// all non-null.
+    pub fn MTLComputeEvaluator_EvalStencilsWithDerivatives(
+        evaluator: MetalComputeEvaluatorPtr,
+        src_buffer: MetalVertexBufferPtr,
+        src_desc: BufferDescriptor,
+        dst_buffer: MetalVertexBufferPtr,
+        dst_desc: BufferDescriptor,
+        du_buffer: MetalVertexBufferPtr,
+        du_desc: BufferDescriptor,
+        dv_buffer: MetalVertexBufferPtr,
+        dv_desc: BufferDescriptor,
+        duu_buffer: MetalVertexBufferPtr,
+        duu_desc: BufferDescriptor,
+        duv_buffer: MetalVertexBufferPtr,
+        duv_desc: BufferDescriptor,
+        dvv_buffer: MetalVertexBufferPtr,
+        dvv_desc: BufferDescriptor,
+        stencil_table: MetalStencilTablePtr,
+        context: *const c_void,
+    ) -> bool;
+    /// Null derivative buffers are not evaluated.
+    pub fn MTLComputeEvaluator_EvalPatches(
+        evaluator: MetalComputeEvaluatorPtr,
+        src_buffer: MetalVertexBufferPtr,
+        src_desc: BufferDescriptor,
+        dst_buffer: MetalVertexBufferPtr,
+        dst_desc: BufferDescriptor,
+        du_buffer: MetalVertexBufferPtr,
+        du_desc: BufferDescriptor,
+        dv_buffer: MetalVertexBufferPtr,
+        dv_desc: BufferDescriptor,
+        duu_buffer: MetalVertexBufferPtr,
+        duu_desc: BufferDescriptor,
+        duv_buffer: MetalVertexBufferPtr,
+        duv_desc: BufferDescriptor,
+        dvv_buffer: MetalVertexBufferPtr,
+        dvv_desc: BufferDescriptor,
+        num_patch_coords: i32,
+        patch_coords: *const PatchCoord,
+        patch_table: MetalPatchTablePtr,
+        context: *const c_void,
+    ) -> bool;
 }
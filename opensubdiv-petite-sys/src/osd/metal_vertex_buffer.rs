@@ -32,4 +32,7 @@ extern "C" {
     pub fn MTLVertexBuffer_GetNumVertices(vb: MetalVertexBufferPtr) -> i32;
     /// Returns the Metal buffer object
     pub fn MTLVertexBuffer_GetMTLBuffer(vb: MetalVertexBufferPtr) -> *const c_void;
+    /// Returns the CPU address of the buffer's shared storage, or NULL if it
+    /// is not in shared storage.
+    pub fn MTLVertexBuffer_GetContents(vb: MetalVertexBufferPtr) -> *mut f32;
 }
@@ -4,9 +4,15 @@ pub use cpu_vertex_buffer::*;
 pub mod buffer_descriptor;
 pub use buffer_descriptor::*;
 
+pub mod types;
+pub use types::*;
+
 pub mod cpu_evaluator;
 pub use cpu_evaluator::*;
 
+pub mod cpu_patch_table;
+pub use cpu_patch_table::*;
+
 pub mod cuda_evaluator;
 pub use cuda_evaluator::*;
 
@@ -1,6 +1,7 @@
-use crate::far::StencilTablePtr;
+use crate::far::{LimitStencilTablePtr, StencilTablePtr};
 use crate::osd::BufferDescriptor;
 use crate::osd::CpuVertexBufferPtr;
+use crate::osd::{CpuPatchTablePtr, PatchCoord};
 
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
@@ -18,4 +19,43 @@ unsafe extern "C" {
         dst_desc: BufferDescriptor,
         stencil_table: StencilTablePtr,
     ) -> bool;
+    /// `du` and `dv` are required; `duu`, `duv` and `dvv` are all null or
+    /// all non-null.
+    pub fn OmpEvaluator_EvalStencilsWithDerivatives(
+        src_buffer: CpuVertexBufferPtr,
+        src_desc: BufferDescriptor,
+        dst_buffer: CpuVertexBufferPtr,
+        dst_desc: BufferDescriptor,
+        du_buffer: CpuVertexBufferPtr,
+        du_desc: BufferDescriptor,
+        dv_buffer: CpuVertexBufferPtr,
+        dv_desc: BufferDescriptor,
+        duu_buffer: CpuVertexBufferPtr,
+        duu_desc: BufferDescriptor,
+        duv_buffer: CpuVertexBufferPtr,
+        duv_desc: BufferDescriptor,
+        dvv_buffer: CpuVertexBufferPtr,
+        dvv_desc: BufferDescriptor,
+        stencil_table: LimitStencilTablePtr,
+    ) -> bool;
+    /// Null derivative buffers are not evaluated.
+    pub fn OmpEvaluator_EvalPatches(
+        src_buffer: CpuVertexBufferPtr,
+        src_desc: BufferDescriptor,
+        dst_buffer: CpuVertexBufferPtr,
+        dst_desc: BufferDescriptor,
+        du_buffer: CpuVertexBufferPtr,
+        du_desc: BufferDescriptor,
+        dv_buffer: CpuVertexBufferPtr,
+        dv_desc: BufferDescriptor,
+        duu_buffer: CpuVertexBufferPtr,
+        duu_desc: BufferDescriptor,
+        duv_buffer: CpuVertexBufferPtr,
+        duv_desc: BufferDescriptor,
+        dvv_buffer: CpuVertexBufferPtr,
+        dvv_desc: BufferDescriptor,
+        num_patch_coords: i32,
+        patch_coords: *const PatchCoord,
+        patch_table: CpuPatchTablePtr,
+    ) -> bool;
 }
@@ -1,6 +1,7 @@
-use crate::far::StencilTablePtr;
+use crate::far::{LimitStencilTablePtr, PatchTable, StencilTablePtr};
 use crate::osd::BufferDescriptor;
 use crate::osd::OpenCLVertexBufferPtr;
+use crate::osd::PatchCoord;
 use std::os::raw::c_void;
 
 #[repr(C)]
@@ -11,14 +12,34 @@ pub struct OpenCLStencilTable_obj {
 pub type OpenCLStencilTablePtr = *mut OpenCLStencilTable_obj;
 
 #[link(name = "osd-capi", kind = "static")]
-extern "C" {
+unsafe extern "C" {
     pub fn CLStencilTable_Create(
         st: StencilTablePtr,
         cl_context: *const c_void,
     ) -> OpenCLStencilTablePtr;
+    pub fn CLStencilTable_CreateFromLimit(
+        st: LimitStencilTablePtr,
+        cl_context: *const c_void,
+    ) -> OpenCLStencilTablePtr;
     pub fn CLStencilTable_destroy(st: OpenCLStencilTablePtr);
 }
 
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct OpenCLPatchTable_obj {
+    _unused: [u8; 0],
+}
+pub type OpenCLPatchTablePtr = *mut OpenCLPatchTable_obj;
+
+#[link(name = "osd-capi", kind = "static")]
+unsafe extern "C" {
+    pub fn CLPatchTable_Create(
+        pt: *const PatchTable,
+        cl_context: *const c_void,
+    ) -> OpenCLPatchTablePtr;
+    pub fn CLPatchTable_destroy(pt: OpenCLPatchTablePtr);
+}
+
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
 pub struct OpenCLEvaluator_obj {
@@ -27,7 +48,21 @@ pub struct OpenCLEvaluator_obj {
 pub type OpenCLEvaluatorPtr = *mut OpenCLEvaluator_obj;
 
 #[link(name = "osd-capi", kind = "static")]
-extern "C" {
+unsafe extern "C" {
+    /// Empty derivative descriptors disable those outputs. Returns NULL if
+    /// the kernels fail to compile.
+    pub fn CLEvaluator_Create(
+        src_desc: BufferDescriptor,
+        dst_desc: BufferDescriptor,
+        du_desc: BufferDescriptor,
+        dv_desc: BufferDescriptor,
+        duu_desc: BufferDescriptor,
+        duv_desc: BufferDescriptor,
+        dvv_desc: BufferDescriptor,
+        cl_context: *const c_void,
+        cl_command_queue: *const c_void,
+    ) -> OpenCLEvaluatorPtr;
+    pub fn CLEvaluator_destroy(evaluator: OpenCLEvaluatorPtr);
     pub fn CLEvaluator_EvalStencils(
         src_buffer: OpenCLVertexBufferPtr,
         src_desc: BufferDescriptor,
@@ -37,4 +72,71 @@ extern "C" {
         kernel: *const c_void,
         command_queue: *const c_void,
     ) -> bool;
+    /// `du` and `dv` are required; `duu`, `duv` and `dvv` are all null or
+    /// all non-null.
+    pub fn CLEvaluator_EvalStencilsWithDerivatives(
+        evaluator: OpenCLEvaluatorPtr,
+        src_buffer: OpenCLVertexBufferPtr,
+        src_desc: BufferDescriptor,
+        dst_buffer: OpenCLVertexBufferPtr,
+        dst_desc: BufferDescriptor,
+        du_buffer: OpenCLVertexBufferPtr,
+        du_desc: BufferDescriptor,
+        dv_buffer: OpenCLVertexBufferPtr,
+        dv_desc: BufferDescriptor,
+        duu_buffer: OpenCLVertexBufferPtr,
+        duu_desc: BufferDescriptor,
+        duv_buffer: OpenCLVertexBufferPtr,
+        duv_desc: BufferDescriptor,
+        dvv_buffer: OpenCLVertexBufferPtr,
+        dvv_desc: BufferDescriptor,
+        stencil_table: OpenCLStencilTablePtr,
+    ) -> bool;
+    /// Like `CLEvaluator_EvalStencilsWithDerivatives()`, but the kernels wait
+    /// for `wait_events` and, if `end_event` is not null, it receives an
+    /// event that completes with them.
+    pub fn CLEvaluator_EvalStencilsWithDerivativesAsync(
+        evaluator: OpenCLEvaluatorPtr,
+        src_buffer: OpenCLVertexBufferPtr,
+        src_desc: BufferDescriptor,
+        dst_buffer: OpenCLVertexBufferPtr,
+        dst_desc: BufferDescriptor,
+        du_buffer: OpenCLVertexBufferPtr,
+        du_desc: BufferDescriptor,
+        dv_buffer: OpenCLVertexBufferPtr,
+        dv_desc: BufferDescriptor,
+        duu_buffer: OpenCLVertexBufferPtr,
+        duu_desc: BufferDescriptor,
+        duv_buffer: OpenCLVertexBufferPtr,
+        duv_desc: BufferDescriptor,
+        dvv_buffer: OpenCLVertexBufferPtr,
+        dvv_desc: BufferDescriptor,
+        stencil_table: OpenCLStencilTablePtr,
+        num_wait_events: u32,
+        wait_events: *const *mut c_void,
+        end_event: *mut *mut c_void,
+    ) -> bool;
+    /// Null derivative buffers are not evaluated.
+    pub fn CLEvaluator_EvalPatches(
+        evaluator: OpenCLEvaluatorPtr,
+        src_buffer: OpenCLVertexBufferPtr,
+        src_desc: BufferDescriptor,
+        dst_buffer: OpenCLVertexBufferPtr,
+        dst_desc: BufferDescriptor,
+        du_buffer: OpenCLVertexBufferPtr,
+        du_desc: BufferDescriptor,
+        dv_buffer: OpenCLVertexBufferPtr,
+        dv_desc: BufferDescriptor,
+        duu_buffer: OpenCLVertexBufferPtr,
+        duu_desc: BufferDescriptor,
+        duv_buffer: OpenCLVertexBufferPtr,
+        duv_desc: BufferDescriptor,
+        dvv_buffer: OpenCLVertexBufferPtr,
+        dvv_desc: BufferDescriptor,
+        num_patch_coords: i32,
+        patch_coords: *const PatchCoord,
+        patch_table: OpenCLPatchTablePtr,
+        cl_context: *const c_void,
+        cl_command_queue: *const c_void,
+    ) -> bool;
 }
@@ -35,4 +35,59 @@ extern "C" {
         vb: OpenCLVertexBufferPtr,
         cl_command_queue: *const c_void,
     ) -> *const c_void;
+    /// Enqueue a non-blocking copy of vertices from host memory into the
+    /// buffer.
+    ///
+    /// The copy waits for `wait_events`; if `event` is not null it receives
+    /// an event that completes with the copy. Returns false if the range is
+    /// out of bounds or the copy could not be enqueued.
+    pub fn CLVertexBuffer_UpdateDataAsync(
+        vb: OpenCLVertexBufferPtr,
+        src: *const f32,
+        start_vertex: i32,
+        num_vertices: i32,
+        cl_command_queue: *const c_void,
+        num_wait_events: u32,
+        wait_events: *const *mut c_void,
+        event: *mut *mut c_void,
+    ) -> bool;
+    /// Enqueue a non-blocking copy of vertices from the buffer into host
+    /// memory.
+    ///
+    /// See `CLVertexBuffer_UpdateDataAsync()` for the event arguments.
+    pub fn CLVertexBuffer_ReadDataAsync(
+        vb: OpenCLVertexBufferPtr,
+        dst: *mut f32,
+        start_vertex: i32,
+        num_vertices: i32,
+        cl_command_queue: *const c_void,
+        num_wait_events: u32,
+        wait_events: *const *mut c_void,
+        event: *mut *mut c_void,
+    ) -> bool;
+    /// Allocate mapped host memory the device can transfer from directly.
+    ///
+    /// Returns the host pointer and stores the buffer object in `mem`, or
+    /// returns NULL if error.
+    pub fn CLPinnedBuffer_Create(
+        cl_context: *const c_void,
+        cl_command_queue: *const c_void,
+        bytes: usize,
+        mem: *mut *mut c_void,
+    ) -> *mut c_void;
+    /// Destructor. Unmaps `host` and releases `mem`.
+    pub fn CLPinnedBuffer_destroy(
+        cl_command_queue: *const c_void,
+        mem: *mut c_void,
+        host: *mut c_void,
+    );
+    /// Returns 1 if `event` has completed, 0 if it is still pending and -1
+    /// on error.
+    pub fn CLEvent_Status(event: *mut c_void) -> i32;
+    /// Block until `event` has completed.
+    pub fn CLEvent_Wait(event: *mut c_void) -> bool;
+    /// Add a reference to `event`.
+    pub fn CLEvent_retain(event: *mut c_void);
+    /// Destructor.
+    pub fn CLEvent_release(event: *mut c_void);
 }
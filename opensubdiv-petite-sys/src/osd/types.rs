@@ -0,0 +1,14 @@
+use crate::far::PatchHandle;
+use std::os::raw::c_float;
+
+/// Mirrors `Osd::PatchCoord`.
+#[repr(C)]
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct PatchCoord {
+    /// Patch the coordinate lies on.
+    pub handle: PatchHandle,
+    /// Face `u` coordinate.
+    pub s: c_float,
+    /// Face `v` coordinate.
+    pub t: c_float,
+}
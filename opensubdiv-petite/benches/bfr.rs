@@ -0,0 +1,90 @@
+//! Benchmarks of limit surface evaluation with Bfr and of triangle mesh
+//! buffer generation.
+//!
+//! `to_triangle_mesh_buffers_par()` runs with the `tri_mesh_buffers` and
+//! `rayon` features.
+//!
+//! Throughput is reported in evaluated points or refined faces per second.
+
+mod common;
+
+use common::{Mesh, MeshKind};
+use criterion::{criterion_group, criterion_main, Criterion, Throughput};
+use opensubdiv_petite::bfr::SurfaceFactory;
+use opensubdiv_petite::Index;
+
+/// Samples per face, in each parametric direction.
+const SAMPLES: [f32; 4] = [0.125, 0.375, 0.625, 0.875];
+
+fn meshes() -> impl Iterator<Item = Mesh> {
+    common::mesh_sizes().into_iter().flat_map(|n| {
+        MeshKind::ALL
+            .into_iter()
+            .map(move |kind| Mesh::new(kind, n))
+    })
+}
+
+fn bfr_evaluation(c: &mut Criterion) {
+    let mut group = c.benchmark_group("bfr");
+    group.sample_size(10);
+    for mesh in meshes() {
+        let refiner = mesh.refiner();
+        let factory = SurfaceFactory::new(&refiner, 2, 6).unwrap();
+        let faces: Vec<Index> = (0..mesh.face_count() as u32)
+            .map(Index::from)
+            .filter(|&face| factory.face_has_limit_surface(face))
+            .collect();
+        group.throughput(Throughput::Elements(
+            (faces.len() * SAMPLES.len() * SAMPLES.len()) as u64,
+        ));
+
+        // Surface setup is part of every face's cost.
+        group.bench_function(format!("evaluate_position/{}", mesh.id()), |b| {
+            b.iter(|| {
+                let mut sum = [0.0f32; 3];
+                for &face in &faces {
+                    let surface = factory.init_vertex_surface(face).unwrap();
+                    for u in SAMPLES {
+                        for v in SAMPLES {
+                            let p = surface.evaluate_position(u, v, &mesh.positions).unwrap();
+                            sum = [sum[0] + p[0], sum[1] + p[1], sum[2] + p[2]];
+                        }
+                    }
+                }
+                sum
+            })
+        });
+    }
+    group.finish();
+}
+
+#[cfg(all(feature = "tri_mesh_buffers", feature = "rayon"))]
+fn triangle_mesh_buffers(c: &mut Criterion) {
+    use opensubdiv_petite::tri_mesh_buffers::to_triangle_mesh_buffers_par;
+
+    /// Uniform refinement level of the triangulated mesh.
+    const LEVEL: usize = 2;
+
+    let mut group = c.benchmark_group("tri_mesh_buffers");
+    group.sample_size(10);
+    for mesh in meshes() {
+        let refiner = mesh.uniform_refiner(LEVEL);
+        let positions = common::refined_positions(&refiner, mesh.flat_positions());
+        let level = refiner.level(LEVEL).unwrap();
+        // The last level's vertices come last.
+        let first = positions.len() - level.vertex_count();
+        let vertices: &[f32] = bytemuck::cast_slice(&positions[first..]);
+        group.throughput(Throughput::Elements(level.face_count() as u64));
+
+        group.bench_function(format!("par/{}", mesh.id()), |b| {
+            b.iter(|| to_triangle_mesh_buffers_par(vertices, level.face_vertices_par_iter()))
+        });
+    }
+    group.finish();
+}
+
+#[cfg(not(all(feature = "tri_mesh_buffers", feature = "rayon")))]
+fn triangle_mesh_buffers(_: &mut Criterion) {}
+
+criterion_group!(benches, bfr_evaluation, triangle_mesh_buffers);
+criterion_main!(benches);
@@ -0,0 +1,289 @@
+//! Scaling meshes and setup shared by the benchmarks.
+//!
+//! Every mesh is the unit cube of the examples with each side split into an
+//! `n`×`n` grid of quads, so the topology stays the same (eight valence-3
+//! corners) while the face count grows. The creased variants crease the three
+//! edges meeting at the corner at `(-0.5, -0.5, -0.5)` like
+//! `creased_cube_export.rs` and `infinite_crease_cube.rs` do.
+//!
+//! Mesh sizes default to about 1k, 16k and 262k faces. Set
+//! `OPENSUBDIV_BENCH_MAX_FACES` to change the upper bound; e.g. `5000000`
+//! adds the 5M face mesh.
+
+#![allow(dead_code)]
+
+use opensubdiv_petite::far::{
+    AdaptiveRefinementOptions, EndCapType, PatchTable, PatchTableOptions, StencilTable,
+    StencilTableOptions, TopologyDescriptor, TopologyRefiner, TopologyRefinerOptions,
+    UniformRefinementOptions,
+};
+use opensubdiv_petite::osd::BufferDescriptor;
+use std::collections::HashMap;
+
+/// Grid resolutions per cube side: 1k, 16k, 262k and 5M faces.
+const GRID_SIZES: [usize; 4] = [13, 52, 209, 913];
+
+/// Default upper bound of [`mesh_sizes()`].
+const DEFAULT_MAX_FACES: usize = 300_000;
+
+/// Which example cube a [`Mesh`] is built after.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum MeshKind {
+    /// Smooth cube (`cube_export.rs`).
+    Cube,
+    /// Three semi-sharp creases at one corner (`creased_cube_export.rs`).
+    CreasedCube,
+    /// Three infinitely sharp creases at one corner (`infinite_crease_cube.rs`).
+    InfiniteCreaseCube,
+}
+
+impl MeshKind {
+    /// All kinds, in benchmark order.
+    pub const ALL: [MeshKind; 3] = [
+        MeshKind::Cube,
+        MeshKind::CreasedCube,
+        MeshKind::InfiniteCreaseCube,
+    ];
+
+    /// Benchmark id of this kind.
+    pub fn name(self) -> &'static str {
+        match self {
+            MeshKind::Cube => "cube",
+            MeshKind::CreasedCube => "creased_cube",
+            MeshKind::InfiniteCreaseCube => "infinite_crease_cube",
+        }
+    }
+
+    /// Sharpness of the creased edges; `0.0` for none.
+    pub fn sharpness(self) -> f32 {
+        match self {
+            MeshKind::Cube => 0.0,
+            MeshKind::CreasedCube => 5.0,
+            MeshKind::InfiniteCreaseCube => 10.0,
+        }
+    }
+
+    /// Adaptive isolation level the examples use for this kind.
+    pub fn isolation_level(self) -> usize {
+        match self {
+            MeshKind::Cube => 3,
+            // Semi-sharp creases decay by 1.0 per level.
+            MeshKind::CreasedCube => self.sharpness().ceil() as usize + 1,
+            // Infinite creases act as boundaries and don't decay.
+            MeshKind::InfiniteCreaseCube => 1,
+        }
+    }
+}
+
+/// Grid resolutions to benchmark, honoring `OPENSUBDIV_BENCH_MAX_FACES`.
+pub fn mesh_sizes() -> Vec<usize> {
+    let max_faces = std::env::var("OPENSUBDIV_BENCH_MAX_FACES")
+        .ok()
+        .and_then(|value| value.parse().ok())
+        .unwrap_or(DEFAULT_MAX_FACES);
+    GRID_SIZES
+        .into_iter()
+        .filter(|&n| 6 * n * n <= max_faces)
+        .collect()
+}
+
+/// A quad mesh of a cube.
+pub struct Mesh {
+    pub kind: MeshKind,
+    pub positions: Vec<[f32; 3]>,
+    pub face_vertex_counts: Vec<u32>,
+    pub face_vertex_indices: Vec<u32>,
+    pub crease_indices: Vec<u32>,
+    pub crease_sharpness: Vec<f32>,
+}
+
+impl Mesh {
+    /// Build a cube of `kind` with `n`×`n` quads per side.
+    pub fn new(kind: MeshKind, n: usize) -> Self {
+        // Sides as (origin, a, b) in lattice coordinates with a × b pointing
+        // outwards, so all quads wind consistently.
+        const SIDES: [([usize; 3], usize, usize); 6] = [
+            ([0, 0, 0], 1, 0), // -z
+            ([0, 0, 1], 0, 1), // +z
+            ([0, 0, 0], 0, 2), // -y
+            ([0, 1, 0], 2, 0), // +y
+            ([0, 0, 0], 2, 1), // -x
+            ([1, 0, 0], 1, 2), // +x
+        ];
+
+        let mut positions = Vec::with_capacity(6 * n * n + 2);
+        let mut vertex_of = HashMap::with_capacity(6 * n * n + 2);
+        let mut vertex = |lattice: [usize; 3]| {
+            *vertex_of.entry(lattice).or_insert_with(|| {
+                positions.push(lattice.map(|c| c as f32 / n as f32 - 0.5));
+                (positions.len() - 1) as u32
+            })
+        };
+
+        let mut face_vertex_indices = Vec::with_capacity(4 * 6 * n * n);
+        for (origin, a, b) in SIDES {
+            let point = |i: usize, j: usize| {
+                let mut p = origin.map(|c| c * n);
+                p[a] += i;
+                p[b] += j;
+                p
+            };
+            for i in 0..n {
+                for j in 0..n {
+                    face_vertex_indices.extend([
+                        vertex(point(i, j)),
+                        vertex(point(i + 1, j)),
+                        vertex(point(i + 1, j + 1)),
+                        vertex(point(i, j + 1)),
+                    ]);
+                }
+            }
+        }
+
+        // Crease the three cube edges at the lattice origin.
+        let mut crease_indices = Vec::new();
+        if kind.sharpness() > 0.0 {
+            for axis in 0..3 {
+                for k in 0..n {
+                    let mut from = [0; 3];
+                    let mut to = [0; 3];
+                    from[axis] = k;
+                    to[axis] = k + 1;
+                    crease_indices.extend([vertex(from), vertex(to)]);
+                }
+            }
+        }
+        let crease_sharpness = vec![kind.sharpness(); crease_indices.len() / 2];
+
+        Self {
+            kind,
+            positions,
+            face_vertex_counts: vec![4; 6 * n * n],
+            face_vertex_indices,
+            crease_indices,
+            crease_sharpness,
+        }
+    }
+
+    /// Number of base faces.
+    pub fn face_count(&self) -> usize {
+        self.face_vertex_counts.len()
+    }
+
+    /// Benchmark parameter id, e.g. `creased_cube/16224`.
+    pub fn id(&self) -> String {
+        format!("{}/{}", self.kind.name(), self.face_count())
+    }
+
+    /// Flat control vertex positions.
+    pub fn flat_positions(&self) -> &[f32] {
+        bytemuck::cast_slice(&self.positions)
+    }
+
+    /// Describe the topology of this mesh.
+    pub fn descriptor(&self) -> TopologyDescriptor<'_> {
+        let descriptor = TopologyDescriptor::new(
+            self.positions.len(),
+            &self.face_vertex_counts,
+            &self.face_vertex_indices,
+        )
+        .expect("valid cube topology");
+        if self.crease_indices.is_empty() {
+            descriptor
+        } else {
+            descriptor
+                .creases(&self.crease_indices, &self.crease_sharpness)
+                .expect("valid creases")
+        }
+    }
+
+    /// Create an unrefined refiner.
+    pub fn refiner(&self) -> TopologyRefiner {
+        TopologyRefiner::new(self.descriptor(), TopologyRefinerOptions::default())
+            .expect("refiner creation")
+    }
+
+    /// Create a refiner refined uniformly to `level`.
+    pub fn uniform_refiner(&self, level: usize) -> TopologyRefiner {
+        let mut refiner = self.refiner();
+        refiner.refine_uniform(UniformRefinementOptions {
+            refinement_level: level,
+            ..Default::default()
+        });
+        refiner
+    }
+
+    /// Create a refiner refined adaptively like the examples.
+    pub fn adaptive_refiner(&self) -> TopologyRefiner {
+        let mut refiner = self.refiner();
+        refiner.refine_adaptive(self.adaptive_options(), None);
+        refiner
+    }
+
+    /// Adaptive refinement options of the examples for this kind.
+    pub fn adaptive_options(&self) -> AdaptiveRefinementOptions {
+        AdaptiveRefinementOptions {
+            isolation_level: self.kind.isolation_level(),
+            ..Default::default()
+        }
+    }
+
+    /// Build the patch table of an adaptive refiner and the control points
+    /// its patches index: all refined vertices followed by the local points.
+    pub fn patches(&self, refiner: &TopologyRefiner) -> (PatchTable, Vec<[f32; 3]>) {
+        let options = PatchTableOptions::new()
+            .end_cap_type(EndCapType::GregoryBasis)
+            .use_inf_sharp_patch(self.kind == MeshKind::InfiniteCreaseCube);
+        let patch_table = PatchTable::new(refiner, Some(options)).expect("patch table");
+
+        let mut control_points = refined_positions(refiner, self.flat_positions());
+        if let Some(local_points) = patch_table.local_point_stencil_table() {
+            let desc = position_desc();
+            let mut dst = vec![0.0f32; 3 * local_points.len()];
+            local_points
+                .update_values_interleaved(
+                    bytemuck::cast_slice(&control_points),
+                    desc,
+                    &mut dst,
+                    desc,
+                    None,
+                    None,
+                )
+                .expect("local point evaluation");
+            control_points.extend(dst.chunks_exact(3).map(|p| [p[0], p[1], p[2]]));
+        }
+        (patch_table, control_points)
+    }
+}
+
+/// Descriptor of tightly packed `[f32; 3]` positions.
+pub fn position_desc() -> BufferDescriptor {
+    BufferDescriptor::new(0, 3, 3).expect("valid descriptor")
+}
+
+/// Options of a stencil table that covers the base and every refined level.
+pub fn all_levels_stencil_options() -> StencilTableOptions {
+    StencilTableOptions {
+        generate_control_vertices: true,
+        generate_offsets: true,
+        ..Default::default()
+    }
+}
+
+/// Positions of the vertices of every level of `refiner`, base level first.
+pub fn refined_positions(refiner: &TopologyRefiner, base: &[f32]) -> Vec<[f32; 3]> {
+    let stencils = StencilTable::new(refiner, all_levels_stencil_options()).expect("stencil table");
+    let desc = position_desc();
+    let mut dst = vec![[0.0f32; 3]; stencils.len()];
+    stencils
+        .update_values_interleaved(
+            base,
+            desc,
+            bytemuck::cast_slice_mut(&mut dst),
+            desc,
+            None,
+            None,
+        )
+        .expect("stencil evaluation");
+    dst
+}
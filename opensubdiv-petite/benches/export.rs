@@ -0,0 +1,79 @@
+//! Benchmarks of B-spline surface export.
+//!
+//! IGES and OBJ always run; STEP runs with the `monstertruck` feature.
+//! Output is written to memory, so timings exclude disk I/O.
+//!
+//! Throughput is reported in bytes of output per second.
+
+mod common;
+
+use common::{Mesh, MeshKind};
+use criterion::{criterion_group, criterion_main, Criterion, Throughput};
+use opensubdiv_petite::iges_export::export_patches_as_iges;
+use opensubdiv_petite::obj_bspline_export::export_patches_as_bspline_surfaces;
+
+/// Largest mesh, in base faces, exported to STEP.
+///
+/// Building and serializing the B-rep makes STEP export far slower than the
+/// other formats.
+#[cfg(feature = "monstertruck")]
+const MAX_STEP_FACES: usize = 20_000;
+
+fn meshes() -> impl Iterator<Item = Mesh> {
+    common::mesh_sizes().into_iter().flat_map(|n| {
+        MeshKind::ALL
+            .into_iter()
+            .map(move |kind| Mesh::new(kind, n))
+    })
+}
+
+fn export(c: &mut Criterion) {
+    let mut group = c.benchmark_group("export");
+    group.sample_size(10);
+    for mesh in meshes() {
+        let refiner = mesh.adaptive_refiner();
+        let (patch_table, control_points) = mesh.patches(&refiner);
+
+        let mut iges = Vec::new();
+        export_patches_as_iges(&mut iges, &patch_table, &control_points).unwrap();
+        group.throughput(Throughput::Bytes(iges.len() as u64));
+        group.bench_function(format!("iges/{}", mesh.id()), |b| {
+            b.iter(|| {
+                iges.clear();
+                export_patches_as_iges(&mut iges, &patch_table, &control_points).unwrap();
+            })
+        });
+
+        let mut obj = Vec::new();
+        export_patches_as_bspline_surfaces(&mut obj, &patch_table, &control_points).unwrap();
+        group.throughput(Throughput::Bytes(obj.len() as u64));
+        group.bench_function(format!("obj/{}", mesh.id()), |b| {
+            b.iter(|| {
+                obj.clear();
+                export_patches_as_bspline_surfaces(&mut obj, &patch_table, &control_points)
+                    .unwrap();
+            })
+        });
+
+        #[cfg(feature = "monstertruck")]
+        if mesh.face_count() <= MAX_STEP_FACES {
+            use monstertruck::step::save::{CompleteStepDisplay, StepModel};
+            use opensubdiv_petite::monstertruck::PatchTableExt;
+
+            let step = || {
+                let shell = patch_table
+                    .to_step_shell(&control_points, Default::default())
+                    .unwrap();
+                let compressed = shell.compress();
+                CompleteStepDisplay::new(StepModel::from(&compressed), Default::default())
+                    .to_string()
+            };
+            group.throughput(Throughput::Bytes(step().len() as u64));
+            group.bench_function(format!("step/{}", mesh.id()), |b| b.iter(&step));
+        }
+    }
+    group.finish();
+}
+
+criterion_group!(benches, export);
+criterion_main!(benches);
@@ -0,0 +1,170 @@
+//! Benchmarks of topology refinement, stencil table construction and
+//! application, and patch queries.
+//!
+//! Throughput is reported in base faces, stencils or sample points per
+//! second. Criterion writes every result as JSON below
+//! `target/criterion/<group>/<id>/new/`, which is what trend tracking should
+//! read.
+
+mod common;
+
+use common::{Mesh, MeshKind};
+use criterion::{criterion_group, criterion_main, BatchSize, Criterion, Throughput};
+use opensubdiv_petite::far::{
+    LimitStencilTable, LimitStencilTableOptions, LocationArray, PatchMap, StencilTable,
+    TopologyRefiner, TopologyRefinerOptions, UniformRefinementOptions,
+};
+use std::hint::black_box;
+
+/// Uniform refinement level of the stencil benchmarks.
+const UNIFORM_LEVEL: usize = 2;
+
+/// Limit stencil samples per base face, in each parametric direction.
+const LIMIT_SAMPLES: [f32; 2] = [0.25, 0.75];
+
+fn meshes() -> impl Iterator<Item = Mesh> {
+    common::mesh_sizes().into_iter().flat_map(|n| {
+        MeshKind::ALL
+            .into_iter()
+            .map(move |kind| Mesh::new(kind, n))
+    })
+}
+
+fn refinement(c: &mut Criterion) {
+    let mut group = c.benchmark_group("far/refiner");
+    group.sample_size(10);
+    for mesh in meshes() {
+        group.throughput(Throughput::Elements(mesh.face_count() as u64));
+
+        group.bench_function(format!("create/{}", mesh.id()), |b| {
+            b.iter(|| {
+                TopologyRefiner::new(mesh.descriptor(), TopologyRefinerOptions::default()).unwrap()
+            })
+        });
+
+        group.bench_function(format!("refine_uniform/{}", mesh.id()), |b| {
+            b.iter_batched(
+                || mesh.refiner(),
+                |mut refiner| {
+                    refiner.refine_uniform(UniformRefinementOptions {
+                        refinement_level: UNIFORM_LEVEL,
+                        ..Default::default()
+                    });
+                    refiner
+                },
+                BatchSize::PerIteration,
+            )
+        });
+
+        group.bench_function(format!("refine_adaptive/{}", mesh.id()), |b| {
+            b.iter_batched(
+                || mesh.refiner(),
+                |mut refiner| {
+                    refiner.refine_adaptive(mesh.adaptive_options(), None);
+                    refiner
+                },
+                BatchSize::PerIteration,
+            )
+        });
+    }
+    group.finish();
+}
+
+fn stencils(c: &mut Criterion) {
+    let mut group = c.benchmark_group("far/stencils");
+    group.sample_size(10);
+    for mesh in meshes() {
+        let refiner = mesh.uniform_refiner(UNIFORM_LEVEL);
+        let table = StencilTable::new(&refiner, common::all_levels_stencil_options()).unwrap();
+        group.throughput(Throughput::Elements(table.len() as u64));
+
+        group.bench_function(format!("factory/{}", mesh.id()), |b| {
+            b.iter(|| StencilTable::new(&refiner, common::all_levels_stencil_options()).unwrap())
+        });
+
+        // One scalar per control vertex, as `update_values()` takes them.
+        let src: Vec<f32> = mesh.positions.iter().map(|p| p[0]).collect();
+        group.bench_function(format!("update_values/{}", mesh.id()), |b| {
+            b.iter(|| table.update_values(black_box(&src), None, None))
+        });
+    }
+    group.finish();
+}
+
+fn limit_stencils(c: &mut Criterion) {
+    let mut group = c.benchmark_group("far/limit_stencils");
+    group.sample_size(10);
+    for mesh in meshes() {
+        let refiner = mesh.adaptive_refiner();
+
+        // A grid of samples on every (quad, hence ptex) face.
+        let s: Vec<f32> = LIMIT_SAMPLES
+            .iter()
+            .flat_map(|&s| LIMIT_SAMPLES.map(|_| s))
+            .collect();
+        let t: Vec<f32> = LIMIT_SAMPLES.iter().flat_map(|_| LIMIT_SAMPLES).collect();
+        let locations: Vec<_> = (0..mesh.face_count())
+            .map(|ptex_index| LocationArray {
+                ptex_index,
+                s: &s,
+                t: &t,
+            })
+            .collect();
+        group.throughput(Throughput::Elements((locations.len() * s.len()) as u64));
+
+        group.bench_function(format!("factory/{}", mesh.id()), |b| {
+            b.iter(|| {
+                LimitStencilTable::new(
+                    &refiner,
+                    &locations,
+                    None,
+                    None,
+                    LimitStencilTableOptions::default(),
+                )
+                .unwrap()
+            })
+        });
+    }
+    group.finish();
+}
+
+fn patches(c: &mut Criterion) {
+    let mut group = c.benchmark_group("far/patches");
+    for mesh in meshes() {
+        let refiner = mesh.adaptive_refiner();
+        let (patch_table, control_points) = mesh.patches(&refiner);
+        let patch_map = PatchMap::new(&patch_table).unwrap();
+
+        // The center of every ptex face.
+        group.throughput(Throughput::Elements(mesh.face_count() as u64));
+        group.bench_function(format!("find_patch/{}", mesh.id()), |b| {
+            b.iter(|| {
+                (0..mesh.face_count())
+                    .filter_map(|face| {
+                        patch_map.find_patch(&patch_table, black_box(face), 0.5, 0.5)
+                    })
+                    .count()
+            })
+        });
+
+        let queries: Vec<usize> = (0..mesh.face_count())
+            .filter_map(|face| patch_map.find_patch(&patch_table, face, 0.5, 0.5))
+            .map(|(patch_index, ..)| patch_index)
+            .collect();
+        group.throughput(Throughput::Elements(queries.len() as u64));
+        group.bench_function(format!("evaluate_point/{}", mesh.id()), |b| {
+            b.iter(|| {
+                queries
+                    .iter()
+                    .filter_map(|&patch_index| {
+                        patch_table.evaluate_point(patch_index, 0.5, 0.5, &control_points)
+                    })
+                    .count()
+            })
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, refinement, stencils, limit_stencils, patches);
+criterion_main!(benches);
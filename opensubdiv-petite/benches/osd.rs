@@ -0,0 +1,124 @@
+//! Benchmarks of stencil evaluation on the OSD backends.
+//!
+//! The CPU evaluator always runs; TBB and wgpu run with their features
+//! (`--features tbb,wgpu`). wgpu timings include the submit and wait for the
+//! dispatch but not the readback; they are skipped if no adapter is
+//! available.
+//!
+//! Throughput is reported in evaluated points (stencils) per second.
+
+mod common;
+
+use common::{Mesh, MeshKind};
+use criterion::{criterion_group, criterion_main, Criterion, Throughput};
+use opensubdiv_petite::far::StencilTable;
+use opensubdiv_petite::osd::{self, CpuVertexBuffer};
+
+/// Uniform refinement level of the evaluated stencil tables.
+const UNIFORM_LEVEL: usize = 2;
+
+/// Refined stencil tables of every benchmark mesh with their control point
+/// positions.
+fn tables() -> Vec<(Mesh, StencilTable)> {
+    common::mesh_sizes()
+        .into_iter()
+        .flat_map(|n| {
+            MeshKind::ALL
+                .into_iter()
+                .map(move |kind| Mesh::new(kind, n))
+        })
+        .map(|mesh| {
+            let refiner = mesh.uniform_refiner(UNIFORM_LEVEL);
+            let table = StencilTable::new(&refiner, common::all_levels_stencil_options()).unwrap();
+            (mesh, table)
+        })
+        .collect()
+}
+
+fn cpu_evaluators(c: &mut Criterion) {
+    let desc = common::position_desc();
+    let mut group = c.benchmark_group("osd/eval_stencils");
+    group.sample_size(20);
+    for (mesh, table) in tables() {
+        let mut src = CpuVertexBuffer::new(3, mesh.positions.len()).unwrap();
+        src.update_data(mesh.flat_positions(), 0, mesh.positions.len())
+            .unwrap();
+        let mut dst = CpuVertexBuffer::new(3, table.len()).unwrap();
+        group.throughput(Throughput::Elements(table.len() as u64));
+
+        group.bench_function(format!("cpu/{}", mesh.id()), |b| {
+            b.iter(|| {
+                osd::cpu_evaluator::evaluate_stencils(&src, desc, &mut dst, desc, &table).unwrap()
+            })
+        });
+
+        #[cfg(feature = "tbb")]
+        group.bench_function(format!("tbb/{}", mesh.id()), |b| {
+            b.iter(|| {
+                osd::tbb_evaluator::evaluate_stencils(&src, desc, &mut dst, desc, &table).unwrap()
+            })
+        });
+    }
+    group.finish();
+}
+
+#[cfg(feature = "wgpu")]
+fn request_device() -> Option<(wgpu::Device, wgpu::Queue)> {
+    let instance = wgpu::Instance::default();
+    let adapter =
+        pollster::block_on(instance.request_adapter(&wgpu::RequestAdapterOptions::default()))
+            .ok()?;
+
+    let limits = wgpu::Limits {
+        max_storage_buffers_per_shader_stage: 16,
+        ..wgpu::Limits::downlevel_defaults()
+    };
+
+    pollster::block_on(adapter.request_device(&wgpu::DeviceDescriptor {
+        label: Some("opensubdiv-petite bench device"),
+        required_features: wgpu::Features::empty(),
+        required_limits: limits,
+        memory_hints: wgpu::MemoryHints::Performance,
+        trace: wgpu::Trace::Off,
+        experimental_features: wgpu::ExperimentalFeatures::default(),
+    }))
+    .ok()
+}
+
+#[cfg(feature = "wgpu")]
+fn wgpu_evaluator(c: &mut Criterion) {
+    let Some((device, queue)) = request_device() else {
+        eprintln!("osd/eval_stencils/wgpu: no adapter, skipping");
+        return;
+    };
+
+    let desc = common::position_desc();
+    let pipeline = osd::wgpu::StencilEvalPipeline::new(&device, Default::default());
+    let mut group = c.benchmark_group("osd/eval_stencils");
+    group.sample_size(20);
+    for (mesh, table) in tables() {
+        let context =
+            osd::wgpu::StencilEvalContext::new(&device, &pipeline, &table, desc, desc).unwrap();
+        context
+            .update_control_vertices(&queue, mesh.flat_positions(), 0)
+            .unwrap();
+        group.throughput(Throughput::Elements(table.len() as u64));
+
+        group.bench_function(format!("wgpu/{}", mesh.id()), |b| {
+            b.iter(|| {
+                let mut encoder =
+                    device.create_command_encoder(&wgpu::CommandEncoderDescriptor::default());
+                context.encode(&pipeline, &mut encoder);
+                queue.submit(std::iter::once(encoder.finish()));
+                device.poll(wgpu::PollType::wait_indefinitely()).unwrap();
+            })
+        });
+    }
+    group.finish();
+}
+
+#[cfg(not(feature = "wgpu"))]
+fn wgpu_evaluator(_: &mut Criterion) {}
+
+criterion_group!(benches, cpu_evaluators, wgpu_evaluator);
+criterion_main!(benches);
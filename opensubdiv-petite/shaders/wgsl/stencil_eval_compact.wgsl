@@ -0,0 +1,92 @@
+// Stencil evaluation over a compactly encoded stencil table.
+//
+// Same bindings 0-2 and parameters as stencil_eval.wgsl; the stencil table
+// is stored as:
+//   - offsets: first tap of each stencil plus a trailing end, so one word
+//     per stencil encodes both its offset and its size,
+//   - bases: lowest control vertex index of each stencil,
+//   - indices: control vertex indices relative to the base, two u16 per word,
+//   - weights: two f16 per word, unpacked with unpack2x16float.
+// Taps are numbered across the whole table; tap t lives in the low half of
+// word t / 2 if t is even and in the high half otherwise.
+
+override WORKGROUP_SIZE: u32 = 64u;
+
+struct Params {
+    src_offset: u32,
+    dst_offset: u32,
+    src_stride: u32,
+    dst_stride: u32,
+    length: u32,
+    batch_start: u32,
+    batch_end: u32,
+    du_offset: u32,
+    du_stride: u32,
+    du_length: u32,
+    dv_offset: u32,
+    dv_stride: u32,
+    dv_length: u32,
+    duu_offset: u32,
+    duu_stride: u32,
+    duu_length: u32,
+    duv_offset: u32,
+    duv_stride: u32,
+    duv_length: u32,
+    dvv_offset: u32,
+    dvv_stride: u32,
+    dvv_length: u32,
+}
+
+@group(0) @binding(0)
+var<uniform> params: Params;
+
+@group(0) @binding(1)
+var<storage, read> src_buffer: array<f32>;
+
+@group(0) @binding(2)
+var<storage, read_write> dst_buffer: array<f32>;
+
+@group(0) @binding(3)
+var<storage, read> stencil_offsets: array<u32>;
+
+@group(0) @binding(4)
+var<storage, read> stencil_bases: array<u32>;
+
+@group(0) @binding(5)
+var<storage, read> stencil_indices: array<u32>;
+
+@group(0) @binding(6)
+var<storage, read> stencil_weights: array<u32>;
+
+const MAX_LENGTH: u32 = 32u;
+
+fn tap_index(tap: u32) -> u32 {
+    return (stencil_indices[tap >> 1u] >> ((tap & 1u) * 16u)) & 0xffffu;
+}
+
+fn tap_weight(tap: u32) -> f32 {
+    let pair = unpack2x16float(stencil_weights[tap >> 1u]);
+    return select(pair.x, pair.y, (tap & 1u) == 1u);
+}
+
+@compute @workgroup_size(WORKGROUP_SIZE)
+fn eval_stencils(@builtin(global_invocation_id) gid: vec3<u32>) {
+    let current = gid.x + params.batch_start;
+    if (current >= params.batch_end) {
+        return;
+    }
+
+    let begin = stencil_offsets[current];
+    let end = stencil_offsets[current + 1u];
+    let src_base = params.src_offset + stencil_bases[current] * params.src_stride;
+    let dst_base = params.dst_offset + current * params.dst_stride;
+
+    for (var c: u32 = 0u; c < params.length && c < MAX_LENGTH; c = c + 1u) {
+        var sum: f32 = 0.0;
+        for (var t: u32 = begin; t < end; t = t + 1u) {
+            let vi = src_base + tap_index(t) * params.src_stride + c;
+            sum = sum + tap_weight(t) * src_buffer[vi];
+        }
+        dst_buffer[dst_base + c] = sum;
+    }
+}
@@ -1,5 +1,6 @@
 //! Thin safe wrapper for OpenSubdiv BFR surfaces (per-face limit patches).
 
+use crate::far::PatchEvalOutputs;
 use crate::{Error, Index};
 use opensubdiv_petite_sys as sys;
 
@@ -14,64 +15,254 @@ pub enum BfrError {
     BufferTooSmall,
     /// Unsupported patch point count for regular export.
     UnsupportedPatchPointCount(usize),
+    /// Output descriptor is invalid or does not match the point size.
+    InvalidBufferDescriptor,
+    /// Tessellation edge length is not positive.
+    InvalidTessellationRate,
+    /// The mesh has no face-varying channel with this index.
+    InvalidFaceVaryingChannel(usize),
+}
+
+pub mod tessellation;
+pub use tessellation::*;
+
+/// A topology cache that several [`SurfaceFactory`]s can share.
+///
+/// Surfaces with identical neighborhood topology, within one mesh or across
+/// meshes, are only built once. The cache is thread-safe.
+pub struct SurfaceFactoryCache {
+    ptr: *mut sys::bfr::surface_factory::Bfr_SurfaceFactoryCache_f,
+}
+
+unsafe impl Send for SurfaceFactoryCache {}
+unsafe impl Sync for SurfaceFactoryCache {}
+
+impl SurfaceFactoryCache {
+    /// Create an empty cache.
+    pub fn new() -> Result<Self, BfrError> {
+        let ptr = unsafe { sys::bfr::surface_factory::Bfr_SurfaceFactoryCache_Create() };
+        match ptr.is_null() {
+            true => Err(BfrError::InitializationFailed),
+            false => Ok(Self { ptr }),
+        }
+    }
+
+    /// Number of distinct surface topologies in the cache.
+    pub fn entry_count(&self) -> usize {
+        unsafe { sys::bfr::surface_factory::Bfr_SurfaceFactoryCache_GetNumEntries(self.ptr) as _ }
+    }
+}
+
+impl Drop for SurfaceFactoryCache {
+    fn drop(&mut self) {
+        unsafe { sys::bfr::surface_factory::Bfr_SurfaceFactoryCache_Destroy(self.ptr) }
+    }
 }
 
 /// Wrapper around `Bfr::RefinerSurfaceFactory` (float).
-pub struct SurfaceFactory {
+///
+/// Borrows the [`TopologyRefiner`](crate::far::TopologyRefiner) it reads the
+/// mesh from. Surfaces may be initialized from several threads at once.
+pub struct SurfaceFactory<'a> {
     ptr: *mut sys::bfr::surface_factory::Bfr_SurfaceFactory_f,
+    refiner: &'a crate::far::TopologyRefiner,
 }
 
-unsafe impl Send for SurfaceFactory {}
-unsafe impl Sync for SurfaceFactory {}
+unsafe impl Send for SurfaceFactory<'_> {}
+unsafe impl Sync for SurfaceFactory<'_> {}
 
-impl SurfaceFactory {
+impl<'a> SurfaceFactory<'a> {
     /// Create a factory from a `TopologyRefiner` with approximation levels for
     /// smooth and sharp features.
     pub fn new(
-        refiner: &crate::far::TopologyRefiner,
+        refiner: &'a crate::far::TopologyRefiner,
+        approx_smooth: i32,
+        approx_sharp: i32,
+    ) -> Result<Self, Error> {
+        Self::create(refiner, approx_smooth, approx_sharp, std::ptr::null_mut())
+    }
+
+    /// Create a factory that uses a shared `cache` instead of its own.
+    pub fn with_cache(
+        refiner: &'a crate::far::TopologyRefiner,
+        approx_smooth: i32,
+        approx_sharp: i32,
+        cache: &'a SurfaceFactoryCache,
+    ) -> Result<Self, Error> {
+        Self::create(refiner, approx_smooth, approx_sharp, cache.ptr)
+    }
+
+    fn create(
+        refiner: &'a crate::far::TopologyRefiner,
         approx_smooth: i32,
         approx_sharp: i32,
+        cache: *mut sys::bfr::surface_factory::Bfr_SurfaceFactoryCache_f,
     ) -> Result<Self, Error> {
         unsafe {
-            let ptr = sys::bfr::surface_factory::Bfr_SurfaceFactory_Create(
+            let ptr = sys::bfr::surface_factory::Bfr_SurfaceFactory_CreateWithCache(
                 refiner.as_ptr(),
                 approx_smooth as _,
                 approx_sharp as _,
+                cache,
             );
 
             if ptr.is_null() {
                 Err(Error::PatchTableCreation)
             } else {
-                Ok(Self { ptr })
+                Ok(Self { ptr, refiner })
             }
         }
     }
 
+    /// Returns the refiner this factory reads the mesh from.
+    #[inline]
+    pub fn refiner(&self) -> &'a crate::far::TopologyRefiner {
+        self.refiner
+    }
+
     /// Initialize a vertex surface for the given base face.
     pub fn init_vertex_surface(&self, face_index: Index) -> Result<Surface, BfrError> {
-        unsafe {
-            let surface = sys::bfr::surface_factory::Bfr_Surface_Create();
-            if surface.is_null() {
-                return Err(BfrError::InitializationFailed);
-            }
+        let mut surface = Surface::new()?;
+        self.init_vertex_surface_into(face_index, &mut surface)?;
+        Ok(surface)
+    }
 
-            let ok = sys::bfr::surface_factory::Bfr_SurfaceFactory_InitVertexSurface(
+    /// Re-initialize an existing `surface` as the vertex surface of the given
+    /// base face, reusing its allocations.
+    pub fn init_vertex_surface_into(
+        &self,
+        face_index: Index,
+        surface: &mut Surface,
+    ) -> Result<(), BfrError> {
+        let ok = unsafe {
+            sys::bfr::surface_factory::Bfr_SurfaceFactory_InitVertexSurface(
                 self.ptr,
                 face_index.0 as i32,
-                surface,
-            );
+                surface.ptr,
+            )
+        };
+        ok.then_some(()).ok_or(BfrError::InitializationFailed)
+    }
 
-            if !ok {
-                sys::bfr::surface_factory::Bfr_Surface_Destroy(surface);
-                return Err(BfrError::InitializationFailed);
-            }
+    /// Number of face-varying channels of the refiner's mesh.
+    pub fn face_varying_channel_count(&self) -> usize {
+        unsafe { sys::bfr::surface_factory::Bfr_SurfaceFactory_GetNumFVarChannels(self.ptr) as _ }
+    }
 
-            Ok(Surface { ptr: surface })
+    /// Initialize the varying surface for the given base face.
+    ///
+    /// Varying data is interpolated linearly over the face. Like the vertex
+    /// surface's, its control points index the mesh vertices.
+    pub fn init_varying_surface(&self, face_index: Index) -> Result<Surface, BfrError> {
+        let mut surface = Surface::new()?;
+        self.init_varying_surface_into(face_index, &mut surface)?;
+        Ok(surface)
+    }
+
+    /// Re-initialize an existing `surface` as the varying surface of the
+    /// given base face, reusing its allocations.
+    pub fn init_varying_surface_into(
+        &self,
+        face_index: Index,
+        surface: &mut Surface,
+    ) -> Result<(), BfrError> {
+        let ok = unsafe {
+            sys::bfr::surface_factory::Bfr_SurfaceFactory_InitVaryingSurface(
+                self.ptr,
+                face_index.0 as i32,
+                surface.ptr,
+            )
+        };
+        ok.then_some(()).ok_or(BfrError::InitializationFailed)
+    }
+
+    /// Initialize the surface of face-varying `channel` for the given base
+    /// face.
+    ///
+    /// Its control points index the channel's values, so pass those (e.g.
+    /// UVs with `point_size` 2) to
+    /// [`Surface::prepare_patch_points()`].
+    pub fn init_face_varying_surface(
+        &self,
+        face_index: Index,
+        channel: usize,
+    ) -> Result<Surface, BfrError> {
+        let mut surface = Surface::new()?;
+        self.init_face_varying_surface_into(face_index, channel, &mut surface)?;
+        Ok(surface)
+    }
+
+    /// Re-initialize an existing `surface` as the surface of face-varying
+    /// `channel` of the given base face, reusing its allocations.
+    pub fn init_face_varying_surface_into(
+        &self,
+        face_index: Index,
+        channel: usize,
+        surface: &mut Surface,
+    ) -> Result<(), BfrError> {
+        let channel_i32 = self.checked_face_varying_channel(channel)?;
+        let ok = unsafe {
+            sys::bfr::surface_factory::Bfr_SurfaceFactory_InitFaceVaryingSurface(
+                self.ptr,
+                face_index.0 as i32,
+                channel_i32,
+                surface.ptr,
+            )
+        };
+        ok.then_some(()).ok_or(BfrError::InitializationFailed)
+    }
+
+    /// Re-initialize the vertex surface of the given base face together with
+    /// its `varying` surface and the surface of a face-varying channel, given
+    /// as `(channel, surface)`.
+    ///
+    /// The face's neighborhood is only gathered once, which makes this
+    /// cheaper than initializing each surface separately when evaluating
+    /// e.g. positions and UVs at the same locations.
+    pub fn init_surfaces_into(
+        &self,
+        face_index: Index,
+        vertex: &mut Surface,
+        varying: Option<&mut Surface>,
+        face_varying: Option<(usize, &mut Surface)>,
+    ) -> Result<(), BfrError> {
+        let (channel_i32, face_varying_ptr) = match face_varying {
+            Some((channel, surface)) => (self.checked_face_varying_channel(channel)?, surface.ptr),
+            None => (0, std::ptr::null_mut()),
+        };
+        let ok = unsafe {
+            sys::bfr::surface_factory::Bfr_SurfaceFactory_InitSurfaces(
+                self.ptr,
+                face_index.0 as i32,
+                vertex.ptr,
+                varying.map_or(std::ptr::null_mut(), |surface| surface.ptr),
+                channel_i32,
+                face_varying_ptr,
+            )
+        };
+        ok.then_some(()).ok_or(BfrError::InitializationFailed)
+    }
+
+    fn checked_face_varying_channel(&self, channel: usize) -> Result<i32, BfrError> {
+        if channel >= self.face_varying_channel_count() {
+            return Err(BfrError::InvalidFaceVaryingChannel(channel));
+        }
+        Ok(channel as i32)
+    }
+
+    /// Returns `true` if the base face has a limit surface, i.e. is not a
+    /// hole.
+    pub fn face_has_limit_surface(&self, face_index: Index) -> bool {
+        unsafe {
+            sys::bfr::tessellation::Bfr_SurfaceFactory_FaceHasLimitSurface(
+                self.ptr,
+                face_index.0 as i32,
+            )
         }
     }
 }
 
-impl Drop for SurfaceFactory {
+impl Drop for SurfaceFactory<'_> {
     fn drop(&mut self) {
         unsafe {
             sys::bfr::surface_factory::Bfr_SurfaceFactory_Destroy(self.ptr);
@@ -88,6 +279,16 @@ unsafe impl Send for Surface {}
 unsafe impl Sync for Surface {}
 
 impl Surface {
+    /// Create an empty surface to be initialized with
+    /// [`SurfaceFactory::init_vertex_surface_into()`].
+    pub fn new() -> Result<Self, BfrError> {
+        let ptr = unsafe { sys::bfr::surface_factory::Bfr_Surface_Create() };
+        match ptr.is_null() {
+            true => Err(BfrError::InitializationFailed),
+            false => Ok(Self { ptr }),
+        }
+    }
+
     /// Check validity.
     pub fn is_valid(&self) -> bool {
         unsafe { sys::bfr::surface_factory::Bfr_Surface_IsValid(self.ptr) }
@@ -182,13 +383,115 @@ impl Surface {
 
         Ok(buf.chunks_exact(3).map(|c| [c[0], c[1], c[2]]).collect())
     }
+
+    /// Gather the surface's patch points into caller memory.
+    ///
+    /// `mesh_points` holds `point_size` floats per mesh vertex and
+    /// `patch_points` must hold at least
+    /// [`patch_point_count()`](Self::patch_point_count()) `* point_size`
+    /// floats. Prepare once per face and then evaluate all its samples with
+    /// [`evaluate_points()`](Self::evaluate_points()); reusing `patch_points`
+    /// across faces avoids allocation entirely.
+    pub fn prepare_patch_points(
+        &self,
+        mesh_points: &[f32],
+        point_size: usize,
+        patch_points: &mut [f32],
+    ) -> Result<(), BfrError> {
+        if !self.is_valid() {
+            return Err(BfrError::InvalidSurface);
+        }
+        let point_size_i32 = checked_point_size(point_size)?;
+        let patch_point_count = self.patch_point_count();
+        if patch_points.len() < patch_point_count * point_size {
+            return Err(BfrError::BufferTooSmall);
+        }
+
+        let ok = unsafe {
+            sys::bfr::surface_factory::Bfr_Surface_PreparePatchPoints(
+                self.ptr,
+                mesh_points.as_ptr(),
+                (mesh_points.len() / point_size).min(i32::MAX as usize) as _,
+                point_size_i32,
+                point_size_i32,
+                patch_points.as_mut_ptr(),
+                patch_point_count as _,
+            )
+        };
+
+        // The shim rejects surfaces referencing points beyond `mesh_points`.
+        ok.then_some(()).ok_or(BfrError::BufferTooSmall)
+    }
+
+    /// Evaluate many `(u, v)` locations from prepared patch points.
+    ///
+    /// `patch_points` must come from
+    /// [`prepare_patch_points()`](Self::prepare_patch_points()) with the same
+    /// `point_size`, which must also match `outputs.desc`'s length.
+    /// Derivatives whose outputs are `None` are not computed.
+    pub fn evaluate_points(
+        &self,
+        patch_points: &[f32],
+        point_size: usize,
+        u: &[f32],
+        v: &[f32],
+        mut outputs: PatchEvalOutputs<'_>,
+    ) -> Result<(), BfrError> {
+        if !self.is_valid() {
+            return Err(BfrError::InvalidSurface);
+        }
+        let point_size_i32 = checked_point_size(point_size)?;
+        let point_count = u.len();
+        if v.len() != point_count
+            || i32::try_from(point_count).is_err()
+            || patch_points.len() < self.patch_point_count() * point_size
+        {
+            return Err(BfrError::BufferTooSmall);
+        }
+        if !outputs.desc.is_valid() || outputs.desc.0.length as usize != point_size {
+            return Err(BfrError::InvalidBufferDescriptor);
+        }
+        outputs
+            .validate(point_count)
+            .map_err(|_| BfrError::BufferTooSmall)?;
+
+        let desc = outputs.desc;
+        let [p, du, dv, duu, duv, dvv] = outputs.as_mut_ptrs();
+        let ok = unsafe {
+            sys::bfr::surface_factory::Bfr_Surface_EvaluatePoints(
+                self.ptr,
+                patch_points.as_ptr(),
+                point_size_i32,
+                point_count as _,
+                u.as_ptr(),
+                v.as_ptr(),
+                p,
+                du,
+                dv,
+                duu,
+                duv,
+                dvv,
+                desc.0,
+            )
+        };
+
+        ok.then_some(()).ok_or(BfrError::InvalidSurface)
+    }
+}
+
+/// Converts a point size into the shims' `int`, rejecting zero.
+fn checked_point_size(point_size: usize) -> Result<i32, BfrError> {
+    i32::try_from(point_size)
+        .ok()
+        .filter(|&size| size > 0)
+        .ok_or(BfrError::InvalidBufferDescriptor)
 }
 
 #[cfg(feature = "monstertruck")]
 use monstertruck::geometry::prelude::{BsplineSurface, KnotVector, Point3};
 
 #[cfg(feature = "monstertruck")]
-impl SurfaceFactory {
+impl SurfaceFactory<'_> {
     /// Build B-spline surfaces for regular faces at the base level using BFR.
     /// Irregular faces are skipped.
     pub fn build_regular_surfaces(
@@ -0,0 +1,434 @@
+//! Watertight whole-mesh tessellation with `Bfr::Tessellation`.
+//!
+//! [`SurfaceFactory::tessellate()`] evaluates the limit surface of every base
+//! face at a uniform or edge-length-driven rate and stitches the results into
+//! one shared vertex/index buffer. Points on base vertices and edges are
+//! shared by all adjacent faces instead of being duplicated, and faces are
+//! processed in parallel when the `rayon` feature is enabled.
+use super::{BfrError, Surface, SurfaceFactory};
+use crate::Index;
+use opensubdiv_petite_sys as sys;
+use std::ops::Range;
+
+#[cfg(feature = "rayon")]
+use rayon::prelude::*;
+
+/// How many segments each base edge is split into.
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub enum TessellationRate {
+    /// Every edge is split into the same number of segments.
+    Uniform(usize),
+    /// Edges are split so that, on the control cage, no segment is longer
+    /// than `max_length`, using at most `max_rate` segments per edge.
+    EdgeLength {
+        /// Target segment length in mesh units.
+        max_length: f32,
+        /// Upper bound on the segments per edge.
+        max_rate: usize,
+    },
+}
+
+/// Facet type of a [`TessellatedMesh`].
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq, Hash)]
+pub enum FacetType {
+    /// Triangles only.
+    #[default]
+    Triangles,
+    /// Quads where the tessellation pattern allows, triangles elsewhere.
+    ///
+    /// Triangles have their last index set to
+    /// [`TessellatedMesh::NO_INDEX`].
+    Quads,
+}
+
+impl FacetType {
+    /// Number of indices per facet.
+    #[inline]
+    pub fn facet_size(self) -> usize {
+        match self {
+            FacetType::Triangles => 3,
+            FacetType::Quads => 4,
+        }
+    }
+}
+
+/// Options for [`SurfaceFactory::tessellate()`].
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub struct TessellationOptions {
+    /// Edge tessellation rate.
+    pub rate: TessellationRate,
+    /// Type of the generated facets.
+    pub facet_type: FacetType,
+    /// Whether to compute limit normals.
+    pub normals: bool,
+}
+
+impl Default for TessellationOptions {
+    fn default() -> Self {
+        Self {
+            rate: TessellationRate::Uniform(4),
+            facet_type: FacetType::default(),
+            normals: true,
+        }
+    }
+}
+
+/// Shared vertex/index buffers produced by [`SurfaceFactory::tessellate()`].
+#[derive(Clone, Debug, Default, PartialEq)]
+pub struct TessellatedMesh {
+    /// Limit positions.
+    pub positions: Vec<[f32; 3]>,
+    /// Unit limit normals matching `positions`; empty unless requested.
+    pub normals: Vec<[f32; 3]>,
+    /// Facet indices into `positions`, `facet_type.facet_size()` per facet.
+    pub indices: Vec<u32>,
+    /// Type of the facets in `indices`.
+    pub facet_type: FacetType,
+}
+
+impl TessellatedMesh {
+    /// Index marking the unused corner of a triangle in a quad mesh.
+    pub const NO_INDEX: u32 = u32::MAX;
+
+    /// Number of facets.
+    #[inline]
+    pub fn facet_count(&self) -> usize {
+        self.indices.len() / self.facet_type.facet_size()
+    }
+}
+
+/// Per-face slice of the tessellation layout.
+#[derive(Clone, Debug)]
+struct FaceJob {
+    face: usize,
+    rates: Range<usize>,
+    boundary: Range<usize>,
+    interior_offset: usize,
+    facet_offset: usize,
+}
+
+/// Global layout of the shared buffers, computed serially up front.
+#[derive(Debug, Default)]
+struct Layout {
+    jobs: Vec<FaceJob>,
+    rates: Vec<i32>,
+    boundary_indices: Vec<i32>,
+    boundary_owned: Vec<u8>,
+    point_count: usize,
+    facet_count: usize,
+}
+
+// AIDEV-NOTE: Disjoint parallel writes into the shared output buffers.
+// `Layout` assigns every mesh point to exactly one owning face (the lowest
+// indexed face touching it) and gives every face its own interior point and
+// facet ranges, so concurrent `Bfr_Surface_Tessellate()` calls never write
+// the same element. The pointers stay valid for the whole parallel section
+// since the buffers are neither moved nor resized while it runs.
+#[derive(Clone, Copy)]
+struct SharedOutput {
+    points: *mut f32,
+    normals: *mut f32,
+    facets: *mut i32,
+}
+
+unsafe impl Send for SharedOutput {}
+unsafe impl Sync for SharedOutput {}
+
+impl SurfaceFactory<'_> {
+    /// Tessellate the limit surface of the whole base mesh.
+    ///
+    /// `mesh_points` holds the base vertex positions. Holes are skipped.
+    /// Points on base vertices and edges are evaluated once and shared by
+    /// all adjacent faces, giving a watertight mesh without duplicate
+    /// boundary vertices. The surface factory's thread-safe cache means
+    /// faces whose neighborhoods have identical topology only build their
+    /// surface once.
+    ///
+    /// With the `rayon` feature, faces are tessellated in parallel, each
+    /// worker reusing its own [`Surface`] and patch point scratch buffer.
+    pub fn tessellate(
+        &self,
+        mesh_points: &[[f32; 3]],
+        options: TessellationOptions,
+    ) -> Result<TessellatedMesh, BfrError> {
+        let layout = self.tessellation_layout(mesh_points, options)?;
+        let facet_size = options.facet_type.facet_size();
+
+        let mut positions = vec![[0.0f32; 3]; layout.point_count];
+        let normal_count = if options.normals {
+            layout.point_count
+        } else {
+            0
+        };
+        let mut normals = vec![[0.0f32; 3]; normal_count];
+        let mut indices = vec![0u32; layout.facet_count * facet_size];
+
+        let output = SharedOutput {
+            points: positions.as_mut_ptr() as *mut f32,
+            normals: match options.normals {
+                true => normals.as_mut_ptr() as *mut f32,
+                false => std::ptr::null_mut(),
+            },
+            facets: indices.as_mut_ptr() as *mut i32,
+        };
+        let tessellator = FaceTessellator {
+            factory: self,
+            layout: &layout,
+            facet_size,
+            mesh_points: bytemuck::cast_slice(mesh_points),
+            output,
+        };
+        let tessellate_face =
+            |(surface, patch_points): &mut (Result<Surface, BfrError>, Vec<f32>), job: &FaceJob| {
+                let surface = surface.as_mut().map_err(|error| error.clone())?;
+                tessellator.tessellate(job, surface, patch_points)
+            };
+
+        #[cfg(feature = "rayon")]
+        layout
+            .jobs
+            .par_iter()
+            .try_for_each_init(|| (Surface::new(), Vec::new()), tessellate_face)?;
+
+        #[cfg(not(feature = "rayon"))]
+        {
+            let mut scratch = (Surface::new(), Vec::new());
+            layout
+                .jobs
+                .iter()
+                .try_for_each(|job| tessellate_face(&mut scratch, job))?;
+        }
+
+        Ok(TessellatedMesh {
+            positions,
+            normals,
+            indices,
+            facet_type: options.facet_type,
+        })
+    }
+
+    /// Assigns shared points on base vertices and edges to their lowest
+    /// indexed adjacent face and lays out every face's interior points and
+    /// facets.
+    fn tessellation_layout(
+        &self,
+        mesh_points: &[[f32; 3]],
+        options: TessellationOptions,
+    ) -> Result<Layout, BfrError> {
+        let base = self
+            .refiner()
+            .level(0)
+            .ok_or(BfrError::InitializationFailed)?;
+        let face_count = base.face_count();
+
+        let edge_rates = (0..base.edge_count())
+            .map(|edge| {
+                let vertices = base
+                    .edge_vertices(Index::from(edge))
+                    .ok_or(BfrError::InitializationFailed)?;
+                edge_rate(options.rate, mesh_points, vertices)
+            })
+            .collect::<Result<Vec<_>, _>>()?;
+
+        let faces = (0..face_count)
+            .filter(|&face| self.face_has_limit_surface(Index::from(face)))
+            .map(|face| {
+                let index = Index::from(face);
+                match (base.face_vertices(index), base.face_edges(index)) {
+                    (Some(vertices), Some(edges)) => Ok((face, vertices, edges)),
+                    _ => Err(BfrError::InitializationFailed),
+                }
+            })
+            .collect::<Result<Vec<_>, _>>()?;
+
+        // Faces are visited in ascending order, so the first face to touch a
+        // vertex or edge is its owner.
+        const UNOWNED: usize = usize::MAX;
+        let mut vertex_owner = vec![UNOWNED; base.vertex_count()];
+        let mut edge_owner = vec![UNOWNED; base.edge_count()];
+        for &(face, vertices, edges) in &faces {
+            for vertex in vertices {
+                let owner = &mut vertex_owner[vertex.0 as usize];
+                if *owner == UNOWNED {
+                    *owner = face;
+                }
+            }
+            for edge in edges {
+                let owner = &mut edge_owner[edge.0 as usize];
+                if *owner == UNOWNED {
+                    *owner = face;
+                }
+            }
+        }
+
+        let mut point_count = 0usize;
+        let vertex_point: Vec<usize> = vertex_owner
+            .iter()
+            .map(|&owner| {
+                let index = point_count;
+                point_count += (owner != UNOWNED) as usize;
+                index
+            })
+            .collect();
+        let edge_first_point: Vec<usize> = edge_owner
+            .iter()
+            .zip(&edge_rates)
+            .map(|(&owner, &rate)| {
+                let index = point_count;
+                if owner != UNOWNED {
+                    point_count += rate - 1;
+                }
+                index
+            })
+            .collect();
+
+        let mut layout = Layout::default();
+        for (face, vertices, edges) in faces {
+            let rates_start = layout.rates.len();
+            layout
+                .rates
+                .extend(edges.iter().map(|edge| edge_rates[edge.0 as usize] as i32));
+            let rates = &layout.rates[rates_start..];
+
+            let (mut boundary_count, mut interior_count, mut facet_count) = (0, 0, 0);
+            let ok = unsafe {
+                sys::bfr::tessellation::Bfr_SurfaceFactory_GetTessellationCounts(
+                    self.ptr,
+                    face as _,
+                    rates.len() as _,
+                    rates.as_ptr(),
+                    options.facet_type.facet_size() as _,
+                    &mut boundary_count,
+                    &mut interior_count,
+                    &mut facet_count,
+                )
+            };
+            if !ok {
+                return Err(BfrError::InvalidSurface);
+            }
+
+            // Boundary coordinates run from each corner along its outgoing
+            // edge; edge points are stored in the edge's own direction.
+            let boundary_start = layout.boundary_indices.len();
+            for (corner, (vertex, edge)) in vertices.iter().zip(edges).enumerate() {
+                let vertex = vertex.0 as usize;
+                let edge_index = edge.0 as usize;
+                layout.boundary_indices.push(vertex_point[vertex] as i32);
+                layout
+                    .boundary_owned
+                    .push((vertex_owner[vertex] == face) as u8);
+
+                let interior_points = edge_rates[edge_index] - 1;
+                let forward = base
+                    .edge_vertices(*edge)
+                    .is_some_and(|edge_vertices| edge_vertices[0] == vertices[corner]);
+                let first = edge_first_point[edge_index];
+                layout
+                    .boundary_indices
+                    .extend((0..interior_points).map(|i| match forward {
+                        true => (first + i) as i32,
+                        false => (first + interior_points - 1 - i) as i32,
+                    }));
+                layout.boundary_owned.extend(std::iter::repeat_n(
+                    (edge_owner[edge_index] == face) as u8,
+                    interior_points,
+                ));
+            }
+            if layout.boundary_indices.len() - boundary_start != boundary_count as usize {
+                return Err(BfrError::InvalidSurface);
+            }
+
+            layout.jobs.push(FaceJob {
+                face,
+                rates: rates_start..layout.rates.len(),
+                boundary: boundary_start..layout.boundary_indices.len(),
+                interior_offset: point_count,
+                facet_offset: layout.facet_count,
+            });
+            point_count += interior_count as usize;
+            layout.facet_count += facet_count as usize;
+        }
+
+        if i32::try_from(point_count).is_err() {
+            return Err(BfrError::BufferTooSmall);
+        }
+        layout.point_count = point_count;
+        Ok(layout)
+    }
+}
+
+/// Everything a worker needs to tessellate one face into the shared output.
+#[derive(Clone, Copy)]
+struct FaceTessellator<'a> {
+    factory: &'a SurfaceFactory<'a>,
+    layout: &'a Layout,
+    facet_size: usize,
+    mesh_points: &'a [f32],
+    output: SharedOutput,
+}
+
+impl FaceTessellator<'_> {
+    fn tessellate(
+        &self,
+        job: &FaceJob,
+        surface: &mut Surface,
+        patch_points: &mut Vec<f32>,
+    ) -> Result<(), BfrError> {
+        let (layout, output, facet_size) = (self.layout, self.output, self.facet_size);
+        self.factory
+            .init_vertex_surface_into(Index::from(job.face), surface)?;
+        patch_points.resize(surface.patch_point_count() * 3, 0.0);
+        surface.prepare_patch_points(self.mesh_points, 3, patch_points)?;
+
+        let rates = &layout.rates[job.rates.clone()];
+        let ok = unsafe {
+            sys::bfr::tessellation::Bfr_Surface_Tessellate(
+                surface.ptr,
+                patch_points.as_ptr(),
+                rates.len() as _,
+                rates.as_ptr(),
+                facet_size as _,
+                layout.boundary_indices[job.boundary.clone()].as_ptr(),
+                layout.boundary_owned[job.boundary.clone()].as_ptr(),
+                job.boundary.len() as _,
+                job.interior_offset as _,
+                output.points,
+                output.normals,
+                output.facets.add(job.facet_offset * facet_size),
+            )
+        };
+        ok.then_some(()).ok_or(BfrError::InvalidSurface)
+    }
+}
+
+/// Number of segments `rate` splits the edge between `vertices` into.
+fn edge_rate(
+    rate: TessellationRate,
+    mesh_points: &[[f32; 3]],
+    vertices: &[Index],
+) -> Result<usize, BfrError> {
+    match rate {
+        TessellationRate::Uniform(rate) => Ok(rate.max(1)),
+        TessellationRate::EdgeLength {
+            max_length,
+            max_rate,
+        } => {
+            if max_length.is_nan() || max_length <= 0.0 {
+                return Err(BfrError::InvalidTessellationRate);
+            }
+            let point = |index: Index| {
+                mesh_points
+                    .get(index.0 as usize)
+                    .ok_or(BfrError::BufferTooSmall)
+            };
+            let (a, b) = (point(vertices[0])?, point(vertices[1])?);
+            let length = a
+                .iter()
+                .zip(b)
+                .map(|(a, b)| (a - b) * (a - b))
+                .sum::<f32>()
+                .sqrt();
+            Ok(((length / max_length).ceil() as usize).clamp(1, max_rate.max(1)))
+        }
+    }
+}
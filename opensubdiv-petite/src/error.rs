@@ -21,6 +21,10 @@ pub enum Error {
     #[error("Stencil evaluation failed")]
     EvalStencilsFailed,
 
+    /// Patch evaluation failed.
+    #[error("Patch evaluation failed")]
+    EvalPatchesFailed,
+
     /// Invalid topology descriptor.
     #[error("Invalid topology descriptor: {0}")]
     InvalidTopology(String),
@@ -37,6 +41,22 @@ pub enum Error {
     #[error("Invalid buffer size: expected {expected}, got {actual}")]
     InvalidBufferSize { expected: usize, actual: usize },
 
+    /// A mapping meant to be a permutation is not one.
+    #[error("Invalid permutation: {0}")]
+    InvalidPermutation(String),
+
+    /// A table cache file is malformed or of another format version.
+    #[error("Invalid table cache: {0}")]
+    InvalidCache(String),
+
+    /// A reverse stencil index was built from another stencil table.
+    #[error("Reverse stencil index does not match the stencil table")]
+    ReverseIndexMismatch,
+
+    /// Invalid or mismatched buffer descriptor(s).
+    #[error("Invalid buffer descriptor")]
+    InvalidBufferDescriptor,
+
     /// FFI error from OpenSubdiv C++ library.
     #[error("OpenSubdiv FFI error: {0}")]
     Ffi(String),
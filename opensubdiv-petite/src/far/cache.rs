@@ -0,0 +1,1012 @@
+//! Binary cache of stencil and patch tables.
+//!
+//! Building a [`TopologyRefiner`](super::TopologyRefiner), refining it and
+//! creating the tables can take seconds per asset and gives the same result
+//! every time the topology is the same. A [`TableCacheWriter`] stores the
+//! result in a versioned file keyed by a topology hash;
+//! [`TableCache::open()`] loads it again.
+//!
+//! The arrays are stored in the layout the tables use in memory, each
+//! section aligned, so a loaded cache hands out plain slices into the file
+//! contents: [`StencilTableArrays`], [`LimitStencilTableArrays`] and
+//! [`PatchTableArrays`] borrow the cache the way
+//! [`StencilTable::sizes()`] and friends borrow the table. With the `mmap`
+//! feature the file is memory mapped, which turns loading into page faults
+//! on first access.
+//!
+//! Stencil tables can be turned back into [`StencilTable`] and
+//! [`LimitStencilTable`], which copies the arrays into *OpenSubdiv*. A
+//! [`PatchTable`] cannot be rebuilt -- *OpenSubdiv* only creates it through
+//! its factory -- but [`PatchTableArrays`] holds everything needed to
+//! evaluate the patches and to locate them on the base faces, like
+//! [`PatchMap`](super::PatchMap) does.
+//!
+//! ## File Layout
+//!
+//! All values are in the byte order of the writing machine, which is
+//! recorded in the header; a cache written on a machine of the other byte
+//! order is rejected.
+//!
+//! | Bytes          | Content                                             |
+//! | -------------- | --------------------------------------------------- |
+//! | 0..8           | Magic `OSDPTBL\0`                                   |
+//! | 8..12          | Format version ([`CACHE_VERSION`])                  |
+//! | 12..16         | Byte order mark `0x01020304`                        |
+//! | 16..24         | Topology hash                                       |
+//! | 24..28         | Section count                                       |
+//! | 28..32         | Reserved                                            |
+//! | 32..           | Sections: kind (`u32`), reserved, offset and length |
+//! |                | in bytes (`u64` each)                               |
+//! | ...            | Section data, each aligned to 8 bytes               |
+use super::{LimitStencilTable, PatchParam, PatchTable, PatchType, StencilTable, StencilTableRef};
+use crate::{Error, Index, Result};
+use opensubdiv_petite_sys as sys;
+use std::borrow::Cow;
+use std::io::{Read, Write};
+use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicU64, Ordering};
+
+/// Version of the cache format written by this crate.
+///
+/// Caches of other versions are rejected on load.
+pub const CACHE_VERSION: u32 = 1;
+
+const MAGIC: [u8; 8] = *b"OSDPTBL\0";
+const BYTE_ORDER_MARK: u32 = 0x0102_0304;
+const HEADER_LEN: usize = 32;
+const SECTION_RECORD_LEN: usize = 24;
+const SECTION_ALIGN: usize = 8;
+
+// Distinguishes the temporary files of concurrent writers in one process.
+static NEXT_TEMPORARY_ID: AtomicU64 = AtomicU64::new(0);
+
+// AIDEV-NOTE: Section kinds are a table group in the high byte and an array
+// of that table in the low byte. Add new kinds, never renumber them; readers
+// ignore kinds they don't know.
+const GROUP_STENCIL: u32 = 0x100;
+const GROUP_LIMIT: u32 = 0x200;
+const GROUP_PATCH: u32 = 0x300;
+const GROUP_LOCAL_POINT: u32 = 0x400;
+
+const INFO: u32 = 0;
+const SIZES: u32 = 1;
+const OFFSETS: u32 = 2;
+const INDICES: u32 = 3;
+const WEIGHTS: u32 = 4;
+const DERIVATIVE_WEIGHTS: [u32; 5] = [5, 6, 7, 8, 9];
+
+const PATCH_ARRAYS: u32 = 1;
+const PATCH_VERTICES: u32 = 2;
+const PATCH_PARAMS: u32 = 3;
+const FACE_OFFSETS: u32 = 4;
+const FACE_PATCHES: u32 = 5;
+
+/// Returns the file name the cache of `topology_hash` is stored under.
+pub fn cache_file_name(topology_hash: u64) -> String {
+    format!("{topology_hash:016x}.osdcache")
+}
+
+/// Writes the tables of one topology to a cache file.
+///
+/// ## Example
+///
+/// ```no_run
+/// # use opensubdiv_petite::far::{PatchTable, StencilTable, TableCacheWriter};
+/// # fn example(hash: u64, stencils: &StencilTable, patches: &PatchTable)
+/// # -> opensubdiv_petite::Result<()> {
+/// TableCacheWriter::new(hash)
+///     .stencil_table(stencils)
+///     .patch_table(patches)
+///     .write_to_dir("cache")?;
+/// # Ok(())
+/// # }
+/// ```
+#[derive(Clone, Copy)]
+pub struct TableCacheWriter<'a> {
+    topology_hash: u64,
+    stencil_table: Option<&'a StencilTable>,
+    limit_stencil_table: Option<&'a LimitStencilTable>,
+    patch_table: Option<&'a PatchTable>,
+}
+
+impl std::fmt::Debug for TableCacheWriter<'_> {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("TableCacheWriter")
+            .field(
+                "topology_hash",
+                &format_args!("{:#018x}", self.topology_hash),
+            )
+            .field("stencil_table", &self.stencil_table.is_some())
+            .field("limit_stencil_table", &self.limit_stencil_table.is_some())
+            .field("patch_table", &self.patch_table.is_some())
+            .finish()
+    }
+}
+
+impl<'a> TableCacheWriter<'a> {
+    /// Creates a writer for the tables of the topology `topology_hash`
+    /// identifies.
+    pub fn new(topology_hash: u64) -> Self {
+        Self {
+            topology_hash,
+            stencil_table: None,
+            limit_stencil_table: None,
+            patch_table: None,
+        }
+    }
+
+    /// Stores the refinement stencils.
+    pub fn stencil_table(mut self, stencil_table: &'a StencilTable) -> Self {
+        self.stencil_table = Some(stencil_table);
+        self
+    }
+
+    /// Stores limit stencils, with whatever derivatives they hold.
+    pub fn limit_stencil_table(mut self, limit_stencil_table: &'a LimitStencilTable) -> Self {
+        self.limit_stencil_table = Some(limit_stencil_table);
+        self
+    }
+
+    /// Stores the patch arrays and parameters, the local point stencils and
+    /// a face-to-patch map.
+    pub fn patch_table(mut self, patch_table: &'a PatchTable) -> Self {
+        self.patch_table = Some(patch_table);
+        self
+    }
+
+    /// Writes the cache to `writer`.
+    pub fn write_to(&self, mut writer: impl Write) -> Result<()> {
+        let sections = self.sections()?;
+
+        let mut offset = HEADER_LEN + sections.len() * SECTION_RECORD_LEN;
+        let mut header = Vec::with_capacity(offset);
+        header.extend_from_slice(&MAGIC);
+        header.extend_from_slice(&CACHE_VERSION.to_ne_bytes());
+        header.extend_from_slice(&BYTE_ORDER_MARK.to_ne_bytes());
+        header.extend_from_slice(&self.topology_hash.to_ne_bytes());
+        header.extend_from_slice(&(sections.len() as u32).to_ne_bytes());
+        header.extend_from_slice(&0u32.to_ne_bytes());
+
+        let mut offsets = Vec::with_capacity(sections.len());
+        for (kind, data) in &sections {
+            offset = offset.next_multiple_of(SECTION_ALIGN);
+            offsets.push(offset);
+            header.extend_from_slice(&kind.to_ne_bytes());
+            header.extend_from_slice(&0u32.to_ne_bytes());
+            header.extend_from_slice(&(offset as u64).to_ne_bytes());
+            header.extend_from_slice(&(data.len() as u64).to_ne_bytes());
+            offset += data.len();
+        }
+        writer.write_all(&header)?;
+
+        let mut position = header.len();
+        for ((_, data), offset) in sections.iter().zip(offsets) {
+            writer.write_all(&[0; SECTION_ALIGN][..offset - position])?;
+            writer.write_all(data)?;
+            position = offset + data.len();
+        }
+        writer.flush()?;
+        Ok(())
+    }
+
+    /// Writes the cache to `path`.
+    ///
+    /// The file is written under a temporary name, flushed to disk and then
+    /// renamed, so processes loading the same cache concurrently never see a
+    /// partial file. Every call uses its own temporary file; concurrent
+    /// writers of the same path each replace it with a complete cache.
+    pub fn write(&self, path: impl AsRef<Path>) -> Result<()> {
+        let path = path.as_ref();
+        let mut temporary = path.as_os_str().to_owned();
+        temporary.push(format!(
+            ".{}.{}.tmp",
+            std::process::id(),
+            NEXT_TEMPORARY_ID.fetch_add(1, Ordering::Relaxed)
+        ));
+        let temporary = PathBuf::from(temporary);
+
+        let result = std::fs::OpenOptions::new()
+            .write(true)
+            .create_new(true)
+            .open(&temporary)
+            .map_err(Error::from)
+            .and_then(|file| {
+                let mut writer = std::io::BufWriter::new(file);
+                self.write_to(&mut writer)?;
+                let file = writer.into_inner().map_err(|error| error.into_error())?;
+                file.sync_all()?;
+                Ok(())
+            })
+            .and_then(|()| std::fs::rename(&temporary, path).map_err(Error::from));
+        if result.is_err() {
+            let _ = std::fs::remove_file(&temporary);
+        }
+        result
+    }
+
+    /// Writes the cache to `dir`, named after the topology hash (see
+    /// [`cache_file_name()`]), and returns its path.
+    pub fn write_to_dir(&self, dir: impl AsRef<Path>) -> Result<PathBuf> {
+        let path = dir.as_ref().join(cache_file_name(self.topology_hash));
+        self.write(&path)?;
+        Ok(path)
+    }
+
+    fn sections(&self) -> Result<Vec<(u32, Cow<'a, [u8]>)>> {
+        let mut sections = Vec::new();
+
+        if let Some(table) = self.stencil_table {
+            push_stencils(&mut sections, GROUP_STENCIL, table.as_table_ref())?;
+        }
+
+        if let Some(table) = self.limit_stencil_table {
+            push_stencil_arrays(
+                &mut sections,
+                GROUP_LIMIT,
+                table.control_vertex_count(),
+                table.sizes(),
+                table.control_indices(),
+                table.weights(),
+            )?;
+            let mut derivatives = Vec::new();
+            if table.has_1st_derivatives() {
+                derivatives.extend([table.du_weights(), table.dv_weights()]);
+                if table.has_2nd_derivatives() {
+                    derivatives.extend([
+                        table.duu_weights(),
+                        table.duv_weights(),
+                        table.dvv_weights(),
+                    ]);
+                }
+            }
+            for (kind, weights) in DERIVATIVE_WEIGHTS.iter().zip(derivatives) {
+                sections.push((
+                    GROUP_LIMIT | kind,
+                    Cow::Borrowed(bytemuck::cast_slice(weights)),
+                ));
+            }
+        }
+
+        if let Some(table) = self.patch_table {
+            push_patches(&mut sections, table)?;
+            if let Some(local_points) = table.local_point_stencil_table() {
+                push_stencils(&mut sections, GROUP_LOCAL_POINT, local_points)?;
+            }
+        }
+
+        Ok(sections)
+    }
+}
+
+fn push_stencils<'a>(
+    sections: &mut Vec<(u32, Cow<'a, [u8]>)>,
+    group: u32,
+    table: StencilTableRef<'a>,
+) -> Result<()> {
+    push_stencil_arrays(
+        sections,
+        group,
+        table.control_vertex_count(),
+        table.sizes(),
+        table.control_indices(),
+        table.weights(),
+    )
+}
+
+fn push_stencil_arrays<'a>(
+    sections: &mut Vec<(u32, Cow<'a, [u8]>)>,
+    group: u32,
+    control_vertex_count: usize,
+    sizes: &'a [u32],
+    control_indices: &'a [Index],
+    weights: &'a [f32],
+) -> Result<()> {
+    // Tables only carry offsets if the factory was asked for them.
+    let mut offsets = Vec::with_capacity(sizes.len());
+    let mut offset = 0u32;
+    for &size in sizes {
+        offsets.push(offset);
+        offset = offset
+            .checked_add(size)
+            .ok_or(Error::StencilTableCreation)?;
+    }
+
+    sections.push((group | INFO, owned(&[to_u32(control_vertex_count)?])));
+    sections.push((group | SIZES, Cow::Borrowed(bytemuck::cast_slice(sizes))));
+    sections.push((group | OFFSETS, owned(&offsets)));
+    sections.push((
+        group | INDICES,
+        Cow::Borrowed(bytemuck::cast_slice(control_indices)),
+    ));
+    sections.push((
+        group | WEIGHTS,
+        Cow::Borrowed(bytemuck::cast_slice(weights)),
+    ));
+    Ok(())
+}
+
+fn push_patches<'a>(sections: &mut Vec<(u32, Cow<'a, [u8]>)>, table: &'a PatchTable) -> Result<()> {
+    let mut arrays = Vec::with_capacity(table.patch_array_count());
+    let mut params = Vec::with_capacity(table.patch_count());
+    let mut face_ids = Vec::with_capacity(table.patch_count());
+    let mut first_vertex = 0;
+    for array_index in 0..table.patch_array_count() {
+        let descriptor = table
+            .patch_array_descriptor(array_index)
+            .ok_or(Error::PatchTableCreation)?;
+        let patch_count = table.patch_array_patch_count(array_index);
+        let control_vertex_count = descriptor.control_vertex_count();
+        arrays.push(PatchArrayRecord {
+            patch_type: descriptor.patch_type() as u32,
+            control_vertex_count: to_u32(control_vertex_count)?,
+            patch_count: to_u32(patch_count)?,
+            first_patch: to_u32(params.len())?,
+            first_vertex: to_u32(first_vertex)?,
+        });
+        first_vertex += patch_count * control_vertex_count;
+
+        for patch_index in 0..patch_count {
+            let param = table
+                .patch_param(array_index, patch_index)
+                .ok_or(Error::PatchTableCreation)?;
+            face_ids.push(param.face_id());
+            params.push(param.bits());
+        }
+    }
+
+    // Face-to-patch map in CSR layout: the patches of face `f` are
+    // `face_patches[face_offsets[f]..face_offsets[f + 1]]`.
+    let face_count = face_ids.iter().max().map_or(0, |&face| face + 1);
+    let mut face_offsets = vec![0u32; face_count + 1];
+    for &face in &face_ids {
+        face_offsets[face + 1] += 1;
+    }
+    for face in 0..face_count {
+        face_offsets[face + 1] += face_offsets[face];
+    }
+    let mut cursor = face_offsets.clone();
+    let mut face_patches = vec![0u32; face_ids.len()];
+    for (patch, &face) in face_ids.iter().enumerate() {
+        face_patches[cursor[face] as usize] = patch as u32;
+        cursor[face] += 1;
+    }
+
+    let info = [to_u32(table.max_valence())?, to_u32(table.point_count())?];
+    sections.push((GROUP_PATCH | INFO, owned(&info)));
+    sections.push((GROUP_PATCH | PATCH_ARRAYS, owned(&arrays)));
+    sections.push((
+        GROUP_PATCH | PATCH_VERTICES,
+        Cow::Borrowed(bytemuck::cast_slice(
+            table.control_vertices_table().unwrap_or(&[]),
+        )),
+    ));
+    sections.push((GROUP_PATCH | PATCH_PARAMS, owned(&params)));
+    sections.push((GROUP_PATCH | FACE_OFFSETS, owned(&face_offsets)));
+    sections.push((GROUP_PATCH | FACE_PATCHES, owned(&face_patches)));
+    Ok(())
+}
+
+fn owned<T: bytemuck::Pod>(values: &[T]) -> Cow<'static, [u8]> {
+    Cow::Owned(bytemuck::cast_slice(values).to_vec())
+}
+
+fn to_u32(value: usize) -> Result<u32> {
+    u32::try_from(value).map_err(|_| Error::IndexOutOfBounds {
+        index: value,
+        max: u32::MAX as usize,
+    })
+}
+
+/// A loaded table cache.
+///
+/// All sections are validated on load; the table views borrow the cache.
+pub struct TableCache {
+    storage: Storage,
+    topology_hash: u64,
+    sections: Vec<Section>,
+}
+
+enum Storage {
+    // `u64` words keep the sections aligned.
+    Heap {
+        words: Vec<u64>,
+        len: usize,
+    },
+    #[cfg(feature = "mmap")]
+    Mapped(memmap2::Mmap),
+}
+
+impl std::fmt::Debug for TableCache {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("TableCache")
+            .field(
+                "topology_hash",
+                &format_args!("{:#018x}", self.topology_hash),
+            )
+            .field("byte_len", &self.byte_len())
+            .field("sections", &self.sections)
+            .finish()
+    }
+}
+
+impl Storage {
+    fn bytes(&self) -> &[u8] {
+        match self {
+            Storage::Heap { words, len } => &bytemuck::cast_slice(words)[..*len],
+            #[cfg(feature = "mmap")]
+            Storage::Mapped(map) => &map[..],
+        }
+    }
+}
+
+#[derive(Clone, Copy, Debug)]
+struct Section {
+    kind: u32,
+    offset: usize,
+    len: usize,
+}
+
+impl TableCache {
+    /// Loads the cache at `path`.
+    ///
+    /// With the `mmap` feature the file is mapped instead of read; it must
+    /// not be modified while the cache is alive. [`TableCacheWriter::write()`]
+    /// replaces files instead of modifying them.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::Io`] if the file cannot be read and
+    /// [`Error::InvalidCache`] if it is not a valid cache of this version.
+    pub fn open(path: impl AsRef<Path>) -> Result<Self> {
+        let file = std::fs::File::open(path)?;
+
+        #[cfg(feature = "mmap")]
+        let storage = Storage::Mapped(unsafe { memmap2::Mmap::map(&file)? });
+        #[cfg(not(feature = "mmap"))]
+        let storage = read_storage(file)?;
+
+        Self::from_storage(storage)
+    }
+
+    /// Loads the cache of `topology_hash` from `dir`.
+    ///
+    /// Returns `None` if there is no such cache or it was written for a
+    /// different hash.
+    ///
+    /// # Errors
+    ///
+    /// See [`open()`](Self::open).
+    pub fn open_in_dir(dir: impl AsRef<Path>, topology_hash: u64) -> Result<Option<Self>> {
+        match Self::open(dir.as_ref().join(cache_file_name(topology_hash))) {
+            Ok(cache) if cache.topology_hash == topology_hash => Ok(Some(cache)),
+            Ok(_) => Ok(None),
+            Err(Error::Io(error)) if error.kind() == std::io::ErrorKind::NotFound => Ok(None),
+            Err(error) => Err(error),
+        }
+    }
+
+    /// Loads a cache from `reader`.
+    ///
+    /// # Errors
+    ///
+    /// See [`open()`](Self::open).
+    pub fn read_from(reader: impl Read) -> Result<Self> {
+        Self::from_storage(read_storage(reader)?)
+    }
+
+    fn from_storage(storage: Storage) -> Result<Self> {
+        let bytes = storage.bytes();
+        if bytes.len() < HEADER_LEN || bytes[..8] != MAGIC {
+            return Err(invalid("not a table cache"));
+        }
+        let version = read_u32(bytes, 8);
+        if version != CACHE_VERSION {
+            return Err(invalid(format!(
+                "version {version}, expected {CACHE_VERSION}"
+            )));
+        }
+        if read_u32(bytes, 12) != BYTE_ORDER_MARK {
+            return Err(invalid("written with a different byte order"));
+        }
+        let topology_hash = read_u64(bytes, 16);
+        let section_count = read_u32(bytes, 24) as usize;
+
+        let table_end = section_count
+            .checked_mul(SECTION_RECORD_LEN)
+            .and_then(|len| len.checked_add(HEADER_LEN))
+            .filter(|&end| end <= bytes.len())
+            .ok_or_else(|| invalid("section table is truncated"))?;
+        let sections = (HEADER_LEN..table_end)
+            .step_by(SECTION_RECORD_LEN)
+            .map(|record| {
+                let section = Section {
+                    kind: read_u32(bytes, record),
+                    offset: read_u64(bytes, record + 8) as usize,
+                    len: read_u64(bytes, record + 16) as usize,
+                };
+                let in_bounds = section
+                    .offset
+                    .checked_add(section.len)
+                    .is_some_and(|end| end <= bytes.len());
+                if !in_bounds || section.offset % SECTION_ALIGN != 0 || section.len % 4 != 0 {
+                    return Err(invalid(format!("section {:#x} is malformed", section.kind)));
+                }
+                Ok(section)
+            })
+            .collect::<Result<Vec<_>>>()?;
+
+        let cache = Self {
+            storage,
+            topology_hash,
+            sections,
+        };
+        if let Some(stencils) = cache.stencil_arrays(GROUP_STENCIL)? {
+            stencils.validate()?;
+        }
+        if let Some(limit_stencils) = cache.limit_stencil_arrays()? {
+            limit_stencils.stencils.validate()?;
+        }
+        if let Some(patches) = cache.patch_arrays()? {
+            patches.validate()?;
+        }
+        Ok(cache)
+    }
+
+    /// Returns the topology hash the cache was written for.
+    #[inline]
+    pub fn topology_hash(&self) -> u64 {
+        self.topology_hash
+    }
+
+    /// Returns the size of the cache in bytes.
+    #[inline]
+    pub fn byte_len(&self) -> usize {
+        self.storage.bytes().len()
+    }
+
+    // AIDEV-NOTE: The views below are rebuilt from the section table on
+    // every call. Only the cheap section lookups run again; the walks over
+    // the arrays ran once in `from_storage()` and the storage is immutable.
+    // The lookups still return their errors instead of assuming success.
+
+    /// Returns the refinement stencils, if the cache holds them.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::InvalidCache`] if a section of the table is missing
+    /// or malformed.
+    pub fn stencil_table(&self) -> Result<Option<StencilTableArrays<'_>>> {
+        self.stencil_arrays(GROUP_STENCIL)
+    }
+
+    /// Returns the limit stencils, if the cache holds them.
+    ///
+    /// # Errors
+    ///
+    /// See [`stencil_table()`](Self::stencil_table).
+    pub fn limit_stencil_table(&self) -> Result<Option<LimitStencilTableArrays<'_>>> {
+        self.limit_stencil_arrays()
+    }
+
+    /// Returns the patch table, if the cache holds one.
+    ///
+    /// # Errors
+    ///
+    /// See [`stencil_table()`](Self::stencil_table).
+    pub fn patch_table(&self) -> Result<Option<PatchTableArrays<'_>>> {
+        self.patch_arrays()
+    }
+
+    fn section(&self, kind: u32) -> Option<&[u8]> {
+        self.sections
+            .iter()
+            .find(|section| section.kind == kind)
+            .map(|section| &self.storage.bytes()[section.offset..section.offset + section.len])
+    }
+
+    fn array<T: bytemuck::Pod>(&self, kind: u32) -> Result<Option<&[T]>> {
+        self.section(kind)
+            .map(|bytes| {
+                bytemuck::try_cast_slice(bytes)
+                    .map_err(|_| invalid(format!("section {kind:#x} has a partial element")))
+            })
+            .transpose()
+    }
+
+    fn required<T: bytemuck::Pod>(&self, kind: u32) -> Result<&[T]> {
+        self.array(kind)?
+            .ok_or_else(|| invalid(format!("section {kind:#x} is missing")))
+    }
+
+    fn stencil_arrays(&self, group: u32) -> Result<Option<StencilTableArrays<'_>>> {
+        let Some(info) = self.array::<u32>(group | INFO)? else {
+            return Ok(None);
+        };
+        let arrays = StencilTableArrays {
+            control_vertex_count: info.first().copied().unwrap_or(0) as usize,
+            sizes: self.required(group | SIZES)?,
+            offsets: self.required(group | OFFSETS)?,
+            control_indices: self.required(group | INDICES)?,
+            weights: self.required(group | WEIGHTS)?,
+        };
+        Ok(Some(arrays))
+    }
+
+    fn limit_stencil_arrays(&self) -> Result<Option<LimitStencilTableArrays<'_>>> {
+        let Some(stencils) = self.stencil_arrays(GROUP_LIMIT)? else {
+            return Ok(None);
+        };
+        let mut derivatives = [&[][..]; 5];
+        for (weights, kind) in derivatives.iter_mut().zip(DERIVATIVE_WEIGHTS) {
+            if let Some(array) = self.array::<f32>(GROUP_LIMIT | kind)? {
+                if array.len() != stencils.weights.len() {
+                    return Err(invalid(format!(
+                        "derivative section {kind:#x} does not match the weights"
+                    )));
+                }
+                *weights = array;
+            }
+        }
+        let [du_weights, dv_weights, duu_weights, duv_weights, dvv_weights] = derivatives;
+        if du_weights.is_empty() != dv_weights.is_empty()
+            || duu_weights.is_empty() != duv_weights.is_empty()
+            || duu_weights.is_empty() != dvv_weights.is_empty()
+        {
+            return Err(invalid("derivative weights are incomplete"));
+        }
+
+        Ok(Some(LimitStencilTableArrays {
+            stencils,
+            du_weights,
+            dv_weights,
+            duu_weights,
+            duv_weights,
+            dvv_weights,
+        }))
+    }
+
+    fn patch_arrays(&self) -> Result<Option<PatchTableArrays<'_>>> {
+        let Some(info) = self.array::<u32>(GROUP_PATCH | INFO)? else {
+            return Ok(None);
+        };
+        let &[max_valence, point_count, ..] = info else {
+            return Err(invalid("patch table info is truncated"));
+        };
+        let arrays = PatchTableArrays {
+            max_valence: max_valence as usize,
+            point_count: point_count as usize,
+            arrays: self.required(GROUP_PATCH | PATCH_ARRAYS)?,
+            control_vertices: self.required(GROUP_PATCH | PATCH_VERTICES)?,
+            params: self.required(GROUP_PATCH | PATCH_PARAMS)?,
+            face_offsets: self.required(GROUP_PATCH | FACE_OFFSETS)?,
+            face_patches: self.required(GROUP_PATCH | FACE_PATCHES)?,
+            local_points: self.stencil_arrays(GROUP_LOCAL_POINT)?,
+        };
+        Ok(Some(arrays))
+    }
+}
+
+fn read_storage(mut reader: impl Read) -> Result<Storage> {
+    let mut bytes = Vec::new();
+    reader.read_to_end(&mut bytes)?;
+    let mut words = vec![0u64; bytes.len().div_ceil(8)];
+    bytemuck::cast_slice_mut::<u64, u8>(&mut words)[..bytes.len()].copy_from_slice(&bytes);
+    Ok(Storage::Heap {
+        words,
+        len: bytes.len(),
+    })
+}
+
+fn read_u32(bytes: &[u8], at: usize) -> u32 {
+    u32::from_ne_bytes(bytes[at..at + 4].try_into().unwrap())
+}
+
+fn read_u64(bytes: &[u8], at: usize) -> u64 {
+    u64::from_ne_bytes(bytes[at..at + 8].try_into().unwrap())
+}
+
+fn invalid(message: impl Into<String>) -> Error {
+    Error::InvalidCache(message.into())
+}
+
+/// Checks that all `indices` are below `bound`, so a corrupted cache
+/// cannot send consumers of the arrays out of bounds.
+fn check_indices(indices: &[Index], bound: usize, what: &str) -> Result<()> {
+    match indices.iter().find(|index| index.0 as usize >= bound) {
+        Some(index) => Err(invalid(format!(
+            "{what} control index {} is out of range (should be < {bound})",
+            index.0
+        ))),
+        None => Ok(()),
+    }
+}
+
+/// Borrowed arrays of a stencil table.
+///
+/// The arrays have the layout of [`StencilTable`]'s, so they can be handed
+/// to code reading a table's [`sizes()`](StencilTable::sizes),
+/// [`offsets()`](StencilTable::offsets),
+/// [`control_indices()`](StencilTable::control_indices) and
+/// [`weights()`](StencilTable::weights) directly.
+#[derive(Clone, Copy, Debug)]
+pub struct StencilTableArrays<'a> {
+    /// Number of control vertices the stencils read.
+    pub control_vertex_count: usize,
+    /// Number of control vertices of each stencil.
+    pub sizes: &'a [u32],
+    /// Offset of the first index and weight of each stencil.
+    pub offsets: &'a [Index],
+    /// Control vertex indices of all stencils.
+    pub control_indices: &'a [Index],
+    /// Weights of all stencils.
+    pub weights: &'a [f32],
+}
+
+impl StencilTableArrays<'_> {
+    /// Returns the number of stencils.
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.sizes.len()
+    }
+
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.sizes.is_empty()
+    }
+
+    /// Creates an *OpenSubdiv* stencil table from the arrays.
+    ///
+    /// Tables that report no control vertices, like some local point
+    /// tables, are given as many as their largest index requires.
+    pub fn to_stencil_table(&self) -> Result<StencilTable> {
+        let (vertex_count, stencil_count) = self.counts()?;
+        let ptr = unsafe {
+            sys::far::stencil_table::StencilTable_CreateFromArrays(
+                vertex_count,
+                stencil_count,
+                self.sizes.as_ptr() as *const i32,
+                self.control_indices.as_ptr() as *const sys::vtr::Index,
+                self.weights.as_ptr(),
+            )
+        };
+        if ptr.is_null() {
+            return Err(Error::StencilTableCreation);
+        }
+        Ok(StencilTable(ptr))
+    }
+
+    fn counts(&self) -> Result<(i32, i32)> {
+        let vertex_count = self
+            .control_indices
+            .iter()
+            .max()
+            .map_or(0, |index| index.0 as usize + 1)
+            .max(self.control_vertex_count);
+        let to_i32 = |count: usize| {
+            i32::try_from(count).map_err(|_| Error::IndexOutOfBounds {
+                index: count,
+                max: i32::MAX as usize,
+            })
+        };
+        Ok((to_i32(vertex_count)?, to_i32(self.len())?))
+    }
+
+    fn validate(&self) -> Result<()> {
+        if self.offsets.len() != self.sizes.len() {
+            return Err(invalid("stencil offsets do not match the sizes"));
+        }
+        let mut weight_count = 0usize;
+        for (&size, &offset) in self.sizes.iter().zip(self.offsets) {
+            if offset.0 as usize != weight_count {
+                return Err(invalid("stencil offsets do not match the sizes"));
+            }
+            weight_count += size as usize;
+        }
+        if self.control_indices.len() != weight_count || self.weights.len() != weight_count {
+            return Err(invalid("stencil sizes do not match the weights"));
+        }
+        // Tables built without a control vertex count, like the local point
+        // stencils of a patch table, are bounded by their owner instead.
+        if self.control_vertex_count > 0 {
+            check_indices(self.control_indices, self.control_vertex_count, "stencil")?;
+        }
+        Ok(())
+    }
+}
+
+/// Borrowed arrays of a limit stencil table.
+///
+/// Derivative weights the table was built without are empty.
+#[derive(Clone, Copy, Debug)]
+pub struct LimitStencilTableArrays<'a> {
+    /// Control indices and position weights.
+    pub stencils: StencilTableArrays<'a>,
+    pub du_weights: &'a [f32],
+    pub dv_weights: &'a [f32],
+    pub duu_weights: &'a [f32],
+    pub duv_weights: &'a [f32],
+    pub dvv_weights: &'a [f32],
+}
+
+impl LimitStencilTableArrays<'_> {
+    /// Creates an *OpenSubdiv* limit stencil table from the arrays.
+    pub fn to_limit_stencil_table(&self) -> Result<LimitStencilTable> {
+        let (vertex_count, stencil_count) = self.stencils.counts()?;
+        let has_1st = !self.du_weights.is_empty();
+        let has_2nd = has_1st && !self.duu_weights.is_empty();
+        let pointer = |weights: &[f32]| {
+            if weights.is_empty() {
+                std::ptr::null()
+            } else {
+                weights.as_ptr()
+            }
+        };
+
+        let ptr = unsafe {
+            sys::far::limit_stencil_table::LimitStencilTable_CreateFromArrays(
+                vertex_count,
+                stencil_count,
+                self.stencils.sizes.as_ptr() as *const i32,
+                self.stencils.control_indices.as_ptr() as *const sys::vtr::Index,
+                self.stencils.weights.as_ptr(),
+                pointer(self.du_weights),
+                pointer(self.dv_weights),
+                pointer(self.duu_weights),
+                pointer(self.duv_weights),
+                pointer(self.dvv_weights),
+            )
+        };
+        if ptr.is_null() {
+            return Err(Error::StencilTableCreation);
+        }
+        Ok(LimitStencilTable::from_raw(ptr, has_1st, has_2nd))
+    }
+}
+
+/// One patch array of a cached patch table.
+#[repr(C)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq, bytemuck::Pod, bytemuck::Zeroable)]
+pub struct PatchArrayRecord {
+    /// `Far::PatchDescriptor::Type` of the patches.
+    pub patch_type: u32,
+    /// Number of control vertices of each patch.
+    pub control_vertex_count: u32,
+    /// Number of patches in the array.
+    pub patch_count: u32,
+    /// Table-global index of the first patch.
+    pub first_patch: u32,
+    /// Offset of the first control vertex in the control vertex table.
+    pub first_vertex: u32,
+}
+
+impl PatchArrayRecord {
+    /// Returns the type of the patches.
+    #[inline]
+    pub fn patch_type(&self) -> PatchType {
+        PatchType::from_raw(self.patch_type as i32)
+    }
+}
+
+/// Borrowed arrays of a patch table.
+#[derive(Clone, Copy, Debug)]
+pub struct PatchTableArrays<'a> {
+    /// Highest vertex valence of the refined mesh.
+    pub max_valence: usize,
+    /// Number of points the control vertex indices address: the refined
+    /// vertices followed by the local points.
+    pub point_count: usize,
+    /// The patch arrays.
+    pub arrays: &'a [PatchArrayRecord],
+    /// Control vertex indices of all patches.
+    pub control_vertices: &'a [Index],
+    /// Stencils computing the local points from the refined vertices.
+    pub local_points: Option<StencilTableArrays<'a>>,
+    params: &'a [[u32; 2]],
+    face_offsets: &'a [u32],
+    face_patches: &'a [u32],
+}
+
+impl PatchTableArrays<'_> {
+    /// Returns the number of patches.
+    #[inline]
+    pub fn patch_count(&self) -> usize {
+        self.params.len()
+    }
+
+    /// Returns the array of the patch `patch_index` and its index within it.
+    pub fn patch_array(&self, patch_index: usize) -> Option<(&PatchArrayRecord, usize)> {
+        let position = self
+            .arrays
+            .partition_point(|array| array.first_patch as usize <= patch_index);
+        let array = self.arrays.get(position.checked_sub(1)?)?;
+        let local = patch_index - array.first_patch as usize;
+        (local < array.patch_count as usize).then_some((array, local))
+    }
+
+    /// Returns the control vertex indices of the patch `patch_index`.
+    pub fn patch_vertices(&self, patch_index: usize) -> Option<&[Index]> {
+        let (array, local) = self.patch_array(patch_index)?;
+        let count = array.control_vertex_count as usize;
+        let start = array.first_vertex as usize + local * count;
+        self.control_vertices.get(start..start + count)
+    }
+
+    /// Returns the parameterization of the patch `patch_index`.
+    pub fn patch_param(&self, patch_index: usize) -> Option<PatchParam> {
+        self.params
+            .get(patch_index)
+            .map(|&bits| PatchParam::from_bits(bits))
+    }
+
+    /// Returns the patches covering the base face `face_index`.
+    pub fn face_patches(&self, face_index: usize) -> &[u32] {
+        match self.face_offsets.get(face_index..face_index + 2) {
+            Some(&[start, end]) => &self.face_patches[start as usize..end as usize],
+            _ => &[],
+        }
+    }
+
+    /// Finds the patch containing the point `(u, v)` of the base face
+    /// `face_index`.
+    ///
+    /// Returns the patch index and the point's coordinates within the patch,
+    /// like [`PatchMap::find_patch()`](super::PatchMap::find_patch).
+    pub fn find_patch(&self, face_index: usize, u: f32, v: f32) -> Option<(usize, f32, f32)> {
+        if !(0.0..=1.0).contains(&u) || !(0.0..=1.0).contains(&v) {
+            return None;
+        }
+        self.face_patches(face_index).iter().find_map(|&patch| {
+            let patch = patch as usize;
+            let param = self.patch_param(patch)?;
+            let triangular = self.patch_array(patch)?.0.patch_type().is_triangular();
+            let (s, t) = if triangular {
+                param.normalize_triangle(u, v)
+            } else {
+                param.normalize(u, v)
+            };
+            let inside = (0.0..=1.0).contains(&s)
+                && (0.0..=1.0).contains(&t)
+                && (!triangular || s + t <= 1.0);
+            inside.then_some((patch, s, t))
+        })
+    }
+
+    fn validate(&self) -> Result<()> {
+        let mut first_patch = 0usize;
+        let mut first_vertex = 0usize;
+        for array in self.arrays {
+            if array.first_patch as usize != first_patch
+                || array.first_vertex as usize != first_vertex
+            {
+                return Err(invalid("patch arrays are not contiguous"));
+            }
+            first_patch += array.patch_count as usize;
+            first_vertex += array.patch_count as usize * array.control_vertex_count as usize;
+        }
+        if first_patch != self.params.len() || first_vertex != self.control_vertices.len() {
+            return Err(invalid("patch arrays do not match the patches"));
+        }
+
+        let offsets_valid = self.face_offsets.first() == Some(&0)
+            && self.face_offsets.windows(2).all(|pair| pair[0] <= pair[1])
+            && self.face_offsets.last().map(|&end| end as usize) == Some(self.face_patches.len());
+        if !offsets_valid
+            || self
+                .face_patches
+                .iter()
+                .any(|&patch| patch as usize >= self.params.len())
+        {
+            return Err(invalid("face-to-patch map is malformed"));
+        }
+        check_indices(self.control_vertices, self.point_count, "patch")?;
+        if let Some(local_points) = &self.local_points {
+            local_points.validate()?;
+            check_indices(
+                local_points.control_indices,
+                self.point_count,
+                "local point",
+            )?;
+        }
+        Ok(())
+    }
+}
@@ -0,0 +1,479 @@
+//! Incremental re-evaluation of stencils after a few control vertices moved.
+//!
+//! Dragging a vertex or simulating a handful of points changes only the
+//! stencils that read them. A [`StencilReverseIndex`] maps each control
+//! vertex to the stencils depending on it, so the `update_dirty_*()` methods
+//! of [`StencilTable`] and [`LimitStencilTable`] recompute just those
+//! stencils in place and leave the rest of the destination untouched.
+//!
+//! ## Example
+//!
+//! ```no_run
+//! # use opensubdiv_petite::far::*;
+//! # use opensubdiv_petite::osd::BufferDescriptor;
+//! # use opensubdiv_petite::Index;
+//! # fn example(table: &StencilTable, positions: &[f32], refined: &mut [f32]) -> opensubdiv_petite::Result<()> {
+//! // Built once per table.
+//! let reverse_index = StencilReverseIndex::new(table)?;
+//!
+//! // After moving control vertices 7 and 12 in `positions`.
+//! let desc = BufferDescriptor::new(0, 3, 3)?;
+//! table.update_dirty_values(
+//!     &reverse_index,
+//!     &[Index::from(7u32), Index::from(12u32)],
+//!     positions,
+//!     desc,
+//!     refined,
+//!     desc,
+//! )?;
+//! # Ok(())
+//! # }
+//! ```
+use crate::far::limit_stencil_table::check_limit_stencils;
+use crate::far::{LimitStencilTable, StencilTable};
+use crate::osd::BufferDescriptor;
+use crate::{Error, Index, Result};
+
+/// Maps control vertices to the stencils reading them.
+///
+/// Both directions are stored in CSR layout: the taps of stencil `s` are
+/// `stencil_offsets[s]..stencil_offsets[s + 1]` and the stencils reading
+/// control vertex `v` are `stencils[vertex_offsets[v]..vertex_offsets[v +
+/// 1]]`, in ascending order.
+#[derive(Clone, Debug, PartialEq, Eq)]
+pub struct StencilReverseIndex {
+    stencil_offsets: Vec<u32>,
+    vertex_offsets: Vec<u32>,
+    stencils: Vec<Index>,
+}
+
+impl StencilReverseIndex {
+    /// Build the reverse index of `table`.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::InvalidBufferSize`] if the stencil sizes do not add
+    /// up to the number of control indices.
+    pub fn new(table: &StencilTable) -> Result<Self> {
+        Self::from_arrays(
+            table.sizes(),
+            table.control_indices(),
+            table.control_vertex_count(),
+        )
+    }
+
+    /// Build the reverse index of a limit stencil table.
+    ///
+    /// # Errors
+    ///
+    /// See [`new()`](Self::new()).
+    pub fn from_limit_stencil_table(table: &LimitStencilTable) -> Result<Self> {
+        Self::from_arrays(
+            table.sizes(),
+            table.control_indices(),
+            table.control_vertex_count(),
+        )
+    }
+
+    fn from_arrays(
+        sizes: &[u32],
+        control_indices: &[Index],
+        control_vertex_count: usize,
+    ) -> Result<Self> {
+        let mut stencil_offsets = Vec::with_capacity(sizes.len() + 1);
+        let mut offset = 0usize;
+        stencil_offsets.push(0);
+        for &size in sizes {
+            offset += size as usize;
+            stencil_offsets.push(u32::try_from(offset).map_err(|_| Error::IndexOutOfBounds {
+                index: offset,
+                max: u32::MAX as usize,
+            })?);
+        }
+        if offset != control_indices.len() {
+            return Err(Error::InvalidBufferSize {
+                expected: offset,
+                actual: control_indices.len(),
+            });
+        }
+
+        // AIDEV-NOTE: Local point stencil tables report 0 control vertices;
+        // the indices then tell how many there are.
+        let control_vertex_count = control_vertex_count.max(
+            control_indices
+                .iter()
+                .max()
+                .map_or(0, |index| index.0 as usize + 1),
+        );
+
+        // Counting sort of the taps by control vertex. Visiting the stencils
+        // in order keeps each row sorted; a vertex read twice by one stencil
+        // is recorded once.
+        let mut last_stencil = vec![u32::MAX; control_vertex_count];
+        let mut counts = vec![0u32; control_vertex_count + 1];
+        for stencil in 0..sizes.len() {
+            let taps = stencil_offsets[stencil] as usize..stencil_offsets[stencil + 1] as usize;
+            for index in &control_indices[taps] {
+                let vertex = index.0 as usize;
+                if last_stencil[vertex] != stencil as u32 {
+                    last_stencil[vertex] = stencil as u32;
+                    counts[vertex + 1] += 1;
+                }
+            }
+        }
+        for vertex in 0..control_vertex_count {
+            counts[vertex + 1] += counts[vertex];
+        }
+        let vertex_offsets = counts;
+
+        let mut cursor = vertex_offsets[..control_vertex_count].to_vec();
+        let mut stencils = vec![Index(0); vertex_offsets[control_vertex_count] as usize];
+        last_stencil.fill(u32::MAX);
+        for stencil in 0..sizes.len() {
+            let taps = stencil_offsets[stencil] as usize..stencil_offsets[stencil + 1] as usize;
+            for index in &control_indices[taps] {
+                let vertex = index.0 as usize;
+                if last_stencil[vertex] != stencil as u32 {
+                    last_stencil[vertex] = stencil as u32;
+                    stencils[cursor[vertex] as usize] = Index(stencil as u32);
+                    cursor[vertex] += 1;
+                }
+            }
+        }
+
+        Ok(Self {
+            stencil_offsets,
+            vertex_offsets,
+            stencils,
+        })
+    }
+
+    /// Returns the number of stencils of the indexed table.
+    #[inline]
+    pub fn stencil_count(&self) -> usize {
+        self.stencil_offsets.len() - 1
+    }
+
+    /// Returns the number of control vertices the indexed table reads.
+    #[inline]
+    pub fn control_vertex_count(&self) -> usize {
+        self.vertex_offsets.len() - 1
+    }
+
+    /// Returns the stencils reading `control_vertex`, in ascending order.
+    ///
+    /// Empty if the control vertex is out of range.
+    #[inline]
+    pub fn dependent_stencils(&self, control_vertex: Index) -> &[Index] {
+        let vertex = control_vertex.0 as usize;
+        match (
+            self.vertex_offsets.get(vertex),
+            self.vertex_offsets.get(vertex + 1),
+        ) {
+            (Some(&begin), Some(&end)) => &self.stencils[begin as usize..end as usize],
+            _ => &[],
+        }
+    }
+
+    /// Returns the stencils reading any of `dirty_vertices`, in ascending
+    /// order and without duplicates.
+    ///
+    /// This is what the `update_dirty_*()` methods recompute; its cost
+    /// depends on the number of dirty stencils, not the size of the table.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::IndexOutOfBounds`] if a dirty vertex is not a control
+    /// vertex of the table.
+    pub fn dirty_stencils(&self, dirty_vertices: &[Index]) -> Result<Vec<Index>> {
+        let mut stencils = Vec::new();
+        for &vertex in dirty_vertices {
+            if vertex.0 as usize >= self.control_vertex_count() {
+                return Err(Error::IndexOutOfBounds {
+                    index: vertex.0 as usize,
+                    max: self.control_vertex_count(),
+                });
+            }
+            stencils.extend_from_slice(self.dependent_stencils(vertex));
+        }
+        if dirty_vertices.len() > 1 {
+            stencils.sort_unstable();
+            stencils.dedup();
+        }
+        Ok(stencils)
+    }
+
+    fn check_table(&self, stencil_count: usize, control_indices: &[Index]) -> Result<()> {
+        if self.stencil_count() != stencil_count
+            || self.stencil_offsets[stencil_count] as usize != control_indices.len()
+        {
+            return Err(Error::ReverseIndexMismatch);
+        }
+        Ok(())
+    }
+}
+
+/// One set of weights and where the values it produces go.
+struct DirtyOutput<'a> {
+    weights: &'a [f32],
+    dst: &'a mut [f32],
+    desc: BufferDescriptor,
+}
+
+/// Recomputes the stencils reading `dirty_vertices` into each output.
+///
+/// Returns the number of stencils recomputed.
+fn update_dirty(
+    reverse_index: &StencilReverseIndex,
+    control_indices: &[Index],
+    dirty_vertices: &[Index],
+    src: &[f32],
+    src_desc: BufferDescriptor,
+    outputs: &mut [DirtyOutput<'_>],
+) -> Result<usize> {
+    if !src_desc.is_valid()
+        || outputs
+            .iter()
+            .any(|output| !output.desc.is_valid() || output.desc.0.length != src_desc.0.length)
+    {
+        return Err(Error::InvalidBufferDescriptor);
+    }
+
+    let src_len = src_desc.buffer_len(reverse_index.control_vertex_count());
+    if src.len() < src_len {
+        return Err(Error::InvalidBufferSize {
+            expected: src_len,
+            actual: src.len(),
+        });
+    }
+    for output in outputs.iter() {
+        if output.weights.len() != control_indices.len() {
+            return Err(Error::ReverseIndexMismatch);
+        }
+        let dst_len = output.desc.buffer_len(reverse_index.stencil_count());
+        if output.dst.len() < dst_len {
+            return Err(Error::InvalidBufferSize {
+                expected: dst_len,
+                actual: output.dst.len(),
+            });
+        }
+    }
+
+    let stencils = reverse_index.dirty_stencils(dirty_vertices)?;
+    // AIDEV-NOTE: `check_table()` only compares counts, which another table
+    // can share. Before anything is written, every tap of the dirty stencils
+    // must be listed by the reverse index; that also bounds the indices
+    // read from `src` below.
+    for &stencil in &stencils {
+        let taps = reverse_index.stencil_offsets[stencil.0 as usize] as usize
+            ..reverse_index.stencil_offsets[stencil.0 as usize + 1] as usize;
+        if control_indices[taps].iter().any(|&index| {
+            reverse_index
+                .dependent_stencils(index)
+                .binary_search(&stencil)
+                .is_err()
+        }) {
+            return Err(Error::ReverseIndexMismatch);
+        }
+    }
+    let length = src_desc.0.length as usize;
+    let src_offset = src_desc.0.offset as usize;
+    let src_stride = src_desc.0.stride as usize;
+    let mut sum = vec![0.0f32; length];
+    for &stencil in &stencils {
+        let stencil = stencil.0 as usize;
+        let taps = reverse_index.stencil_offsets[stencil] as usize
+            ..reverse_index.stencil_offsets[stencil + 1] as usize;
+        for output in outputs.iter_mut() {
+            sum.fill(0.0);
+            for (index, &weight) in control_indices[taps.clone()]
+                .iter()
+                .zip(&output.weights[taps.clone()])
+            {
+                let base = src_offset + index.0 as usize * src_stride;
+                for (sum, &value) in sum.iter_mut().zip(&src[base..base + length]) {
+                    *sum += weight * value;
+                }
+            }
+            let base = output.desc.0.offset as usize + stencil * output.desc.0.stride as usize;
+            output.dst[base..base + length].copy_from_slice(&sum);
+        }
+    }
+    Ok(stencils.len())
+}
+
+impl StencilTable {
+    /// Recompute only the stencils reading any of `dirty_vertices`.
+    ///
+    /// `src` holds all control vertex values, already updated; `dst` holds
+    /// the values of all stencils, as written by a previous full
+    /// evaluation, with stencil `i` at point `i` of `dst_desc`. Only the
+    /// points of the dirty stencils are written.
+    ///
+    /// Returns the number of stencils recomputed.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `reverse_index` was built from another table, if
+    /// the descriptors are invalid or differ in length, if either slice is
+    /// too short for all control vertices or stencils or if a dirty vertex
+    /// is out of range.
+    pub fn update_dirty_values(
+        &self,
+        reverse_index: &StencilReverseIndex,
+        dirty_vertices: &[Index],
+        src: &[f32],
+        src_desc: BufferDescriptor,
+        dst: &mut [f32],
+        dst_desc: BufferDescriptor,
+    ) -> Result<usize> {
+        let control_indices = self.control_indices();
+        reverse_index.check_table(self.len(), control_indices)?;
+        update_dirty(
+            reverse_index,
+            control_indices,
+            dirty_vertices,
+            src,
+            src_desc,
+            &mut [DirtyOutput {
+                weights: self.weights(),
+                dst,
+                desc: dst_desc,
+            }],
+        )
+    }
+}
+
+impl LimitStencilTable {
+    /// Recompute only the limit positions reading any of `dirty_vertices`.
+    ///
+    /// See [`StencilTable::update_dirty_values()`].
+    ///
+    /// # Errors
+    ///
+    /// See [`StencilTable::update_dirty_values()`].
+    pub fn update_dirty_values(
+        &self,
+        reverse_index: &StencilReverseIndex,
+        dirty_vertices: &[Index],
+        src: &[f32],
+        src_desc: BufferDescriptor,
+        dst: &mut [f32],
+        dst_desc: BufferDescriptor,
+    ) -> Result<usize> {
+        let control_indices = self.control_indices();
+        reverse_index.check_table(self.len(), control_indices)?;
+        update_dirty(
+            reverse_index,
+            control_indices,
+            dirty_vertices,
+            src,
+            src_desc,
+            &mut [DirtyOutput {
+                weights: self.weights(),
+                dst,
+                desc: dst_desc,
+            }],
+        )
+    }
+
+    /// Recompute only the first derivatives reading any of
+    /// `dirty_vertices`.
+    ///
+    /// `du` and `dv` are laid out like `dst` in
+    /// [`StencilTable::update_dirty_values()`].
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::FeatureNotAvailable`] if the table has no first
+    /// derivative weights; otherwise see
+    /// [`StencilTable::update_dirty_values()`].
+    #[allow(clippy::too_many_arguments)]
+    pub fn update_dirty_derivatives(
+        &self,
+        reverse_index: &StencilReverseIndex,
+        dirty_vertices: &[Index],
+        src: &[f32],
+        src_desc: BufferDescriptor,
+        du: &mut [f32],
+        du_desc: BufferDescriptor,
+        dv: &mut [f32],
+        dv_desc: BufferDescriptor,
+    ) -> Result<usize> {
+        check_limit_stencils(self, false)?;
+        let control_indices = self.control_indices();
+        reverse_index.check_table(self.len(), control_indices)?;
+        update_dirty(
+            reverse_index,
+            control_indices,
+            dirty_vertices,
+            src,
+            src_desc,
+            &mut [
+                DirtyOutput {
+                    weights: self.du_weights(),
+                    dst: du,
+                    desc: du_desc,
+                },
+                DirtyOutput {
+                    weights: self.dv_weights(),
+                    dst: dv,
+                    desc: dv_desc,
+                },
+            ],
+        )
+    }
+
+    /// Recompute only the second derivatives reading any of
+    /// `dirty_vertices`.
+    ///
+    /// See [`update_dirty_derivatives()`](Self::update_dirty_derivatives()).
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::FeatureNotAvailable`] if the table has no second
+    /// derivative weights; otherwise see
+    /// [`StencilTable::update_dirty_values()`].
+    #[allow(clippy::too_many_arguments)]
+    pub fn update_dirty_2nd_derivatives(
+        &self,
+        reverse_index: &StencilReverseIndex,
+        dirty_vertices: &[Index],
+        src: &[f32],
+        src_desc: BufferDescriptor,
+        duu: &mut [f32],
+        duu_desc: BufferDescriptor,
+        duv: &mut [f32],
+        duv_desc: BufferDescriptor,
+        dvv: &mut [f32],
+        dvv_desc: BufferDescriptor,
+    ) -> Result<usize> {
+        check_limit_stencils(self, true)?;
+        let control_indices = self.control_indices();
+        reverse_index.check_table(self.len(), control_indices)?;
+        update_dirty(
+            reverse_index,
+            control_indices,
+            dirty_vertices,
+            src,
+            src_desc,
+            &mut [
+                DirtyOutput {
+                    weights: self.duu_weights(),
+                    dst: duu,
+                    desc: duu_desc,
+                },
+                DirtyOutput {
+                    weights: self.duv_weights(),
+                    dst: duv,
+                    desc: duv_desc,
+                },
+                DirtyOutput {
+                    weights: self.dvv_weights(),
+                    dst: dvv,
+                    desc: dvv_desc,
+                },
+            ],
+        )
+    }
+}
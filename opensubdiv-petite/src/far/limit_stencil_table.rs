@@ -5,11 +5,21 @@
 //! vectors and curvature can be evaluated efficiently on the limit surface.
 
 use opensubdiv_petite_sys as sys;
+use std::marker::PhantomData;
+use std::ops::Range;
 
 use crate::far::stencil_table::InterpolationMode;
 use crate::far::{PatchTable, StencilTable, TopologyRefiner};
+use crate::instrument::{self, MemoryFootprint, Stage};
 use crate::Index;
 
+#[cfg(feature = "rayon")]
+use rayon::prelude::*;
+
+/// Default number of locations per chunk of
+/// [`LimitStencilTable::new_chunked()`] and [`LimitStencilTable::chunks()`].
+pub const DEFAULT_LIMIT_STENCIL_CHUNK_LOCATIONS: usize = 1 << 16;
+
 /// Describes a set of sample locations on a single ptex face.
 #[derive(Debug, Clone)]
 pub struct LocationArray<'a> {
@@ -45,6 +55,17 @@ impl Default for LimitStencilTableOptions {
     }
 }
 
+impl LimitStencilTableOptions {
+    fn factory_options(&self) -> sys::far::limit_stencil_table::LimitStencilTableFactoryOptions {
+        let mut options = sys::far::limit_stencil_table::LimitStencilTableFactoryOptions::new();
+        options.set_interpolation_mode(self.interpolation_mode as u32);
+        options.set_generate_1st_derivatives(self.generate_1st_derivatives);
+        options.set_generate_2nd_derivatives(self.generate_2nd_derivatives);
+        options.fvar_channel = self.face_varying_channel as u32;
+        options
+    }
+}
+
 /// Table of limit stencils with derivative weights.
 ///
 /// Created via [`LimitStencilTable::new`] from a [`TopologyRefiner`] and a set
@@ -89,51 +110,203 @@ impl LimitStencilTable {
         patch_table: Option<&PatchTable>,
         options: LimitStencilTableOptions,
     ) -> crate::Result<Self> {
-        // Validate that s and t slices match in each location array.
-        for loc in locations {
-            if loc.s.len() != loc.t.len() {
-                return Err(crate::Error::InvalidTopology(format!(
-                    "LocationArray for ptex face {}: s.len()={} != t.len()={}",
-                    loc.ptex_index,
-                    loc.s.len(),
-                    loc.t.len()
-                )));
-            }
-        }
+        validate_locations(locations)?;
 
         let ffi_descs: Vec<sys::far::limit_stencil_table::LocationArrayDesc> = locations
             .iter()
-            .map(|loc| sys::far::limit_stencil_table::LocationArrayDesc {
-                ptex_idx: loc.ptex_index as i32,
-                num_locations: loc.s.len() as i32,
-                s: loc.s.as_ptr(),
-                t: loc.t.as_ptr(),
-            })
+            .map(|loc| location_desc(loc, 0..loc.s.len()))
             .collect();
 
-        let mut opts = sys::far::limit_stencil_table::LimitStencilTableFactoryOptions::new();
-        opts.set_interpolation_mode(options.interpolation_mode as u32);
-        opts.set_generate_1st_derivatives(options.generate_1st_derivatives);
-        opts.set_generate_2nd_derivatives(options.generate_2nd_derivatives);
-        opts.fvar_channel = options.face_varying_channel as u32;
+        let sources = SharedSources {
+            refiner: refiner.as_ptr() as *const _,
+            cv_stencils: cv_stencils
+                .map(|s| s.0 as *const std::ffi::c_void)
+                .unwrap_or(std::ptr::null()),
+            patch_table: patch_table.map(|p| p.as_ptr()).unwrap_or(std::ptr::null()),
+        };
+
+        let table = unsafe { Self::create(sources, &ffi_descs, &options) }?;
+        instrument::table(Stage::LimitStencilTableFactory, || table.memory_footprint());
+        Ok(table)
+    }
+
+    /// Create a limit stencil table like [`new()`](Self::new()), building
+    /// chunks of about `chunk_locations` locations each concurrently when
+    /// the `rayon` feature is enabled.
+    ///
+    /// If neither `cv_stencils` nor `patch_table` is given, both are built
+    /// once and shared by all chunks. The chunks are concatenated in order,
+    /// so the stencils match those of [`new()`](Self::new()) one for one.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::StencilTableCreation`](crate::Error::StencilTableCreation)
+    /// if a chunk cannot be built, and the errors of [`new()`](Self::new()).
+    pub fn new_chunked(
+        refiner: &TopologyRefiner,
+        locations: &[LocationArray<'_>],
+        cv_stencils: Option<&StencilTable>,
+        patch_table: Option<&PatchTable>,
+        options: LimitStencilTableOptions,
+        chunk_locations: usize,
+    ) -> crate::Result<Self> {
+        let chunks = Self::chunks(
+            refiner,
+            locations,
+            cv_stencils,
+            patch_table,
+            options,
+            chunk_locations,
+        )?;
+
+        // The shared tables are not `Sync`; borrow the rest on its own.
+        let (sources, locations, options) = (chunks.sources, chunks.locations, &chunks.options);
+        let build =
+            |chunk: &Vec<(usize, Range<usize>)>| build_chunk(sources, locations, chunk, options);
+        #[cfg(feature = "rayon")]
+        let tables = chunks
+            .chunks
+            .as_slice()
+            .par_iter()
+            .map(build)
+            .collect::<crate::Result<Vec<_>>>()?;
+        #[cfg(not(feature = "rayon"))]
+        let tables = chunks
+            .chunks
+            .as_slice()
+            .iter()
+            .map(build)
+            .collect::<crate::Result<Vec<_>>>()?;
+
+        let table = match tables.len() {
+            0 => unsafe { Self::create(chunks.sources, &[], &chunks.options) },
+            1 => Ok(tables.into_iter().next().unwrap()),
+            _ => Self::concatenate(&tables),
+        }?;
+        instrument::table(Stage::LimitStencilTableFactory, || table.memory_footprint());
+        Ok(table)
+    }
+
+    /// Returns an iterator building the limit stencils of `locations` one
+    /// chunk of about `chunk_locations` locations at a time.
+    ///
+    /// Lets tables too large for memory be evaluated chunk by chunk. Chunks
+    /// follow the order of `locations`; an array of more than
+    /// `chunk_locations` locations is split over several chunks. See
+    /// [`new_chunked()`](Self::new_chunked()) for `cv_stencils` and
+    /// `patch_table`.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::StencilTableCreation`](crate::Error::StencilTableCreation)
+    /// if the shared stencils or patch table cannot be built, and the errors of
+    /// [`new()`](Self::new()).
+    pub fn chunks<'a>(
+        refiner: &'a TopologyRefiner,
+        locations: &'a [LocationArray<'a>],
+        cv_stencils: Option<&'a StencilTable>,
+        patch_table: Option<&'a PatchTable>,
+        options: LimitStencilTableOptions,
+        chunk_locations: usize,
+    ) -> crate::Result<LimitStencilChunks<'a>> {
+        validate_locations(locations)?;
+
+        let mut sources = SharedSources {
+            refiner: refiner.as_ptr() as *const _,
+            cv_stencils: cv_stencils
+                .map(|s| s.0 as *const std::ffi::c_void)
+                .unwrap_or(std::ptr::null()),
+            patch_table: patch_table.map(|p| p.as_ptr()).unwrap_or(std::ptr::null()),
+        };
 
-        let cv_ptr = cv_stencils
-            .map(|s| s.0 as *const std::ffi::c_void)
-            .unwrap_or(std::ptr::null());
+        // Build what the factory would build on every call once. With only
+        // one of the two given, the factory still builds the other per chunk,
+        // as it would have to match the given one.
+        let mut support = None;
+        if cv_stencils.is_none() && patch_table.is_none() && !locations.is_empty() {
+            let factory_options = options.factory_options();
+            let mut cv_ptr = std::ptr::null();
+            let mut patch_ptr = std::ptr::null_mut();
+            let built = unsafe {
+                sys::far::limit_stencil_table::LimitStencilTableFactory_CreateSupport(
+                    sources.refiner,
+                    factory_options.bitfield,
+                    factory_options.fvar_channel,
+                    &mut cv_ptr,
+                    &mut patch_ptr,
+                )
+            };
+            if !built {
+                return Err(crate::Error::StencilTableCreation);
+            }
+            let cv_stencils = StencilTable(cv_ptr as _);
+            let patch_table = unsafe { PatchTable::from_raw(patch_ptr) };
+            sources.cv_stencils = cv_stencils.0 as *const _;
+            sources.patch_table = patch_table.as_ptr();
+            support = Some((cv_stencils, patch_table));
+        }
 
-        let patch_ptr = patch_table.map(|p| p.as_ptr()).unwrap_or(std::ptr::null());
+        Ok(LimitStencilChunks {
+            sources,
+            locations,
+            chunks: split_chunks(locations, chunk_locations).into_iter(),
+            options,
+            first_stencil: 0,
+            _support: support,
+            _borrow: PhantomData,
+        })
+    }
 
+    /// Join `tables` into one table, keeping the order of their stencils.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::StencilTableCreation`](crate::Error::StencilTableCreation)
+    /// if `tables` is empty or the tables differ in their control vertices or
+    /// derivative weights.
+    pub fn concatenate(tables: &[LimitStencilTable]) -> crate::Result<Self> {
+        let first = tables.first().ok_or(crate::Error::StencilTableCreation)?;
+        let ptrs: Vec<sys::far::LimitStencilTablePtr> =
+            tables.iter().map(|table| table.ptr).collect();
         let ptr = unsafe {
-            sys::far::limit_stencil_table::LimitStencilTableFactory_Create(
-                refiner.as_ptr() as *const _,
-                ffi_descs.as_ptr(),
-                ffi_descs.len() as i32,
-                cv_ptr,
-                patch_ptr,
-                opts.bitfield,
-                opts.fvar_channel,
+            sys::far::limit_stencil_table::LimitStencilTable_Concatenate(
+                ptrs.as_ptr(),
+                ptrs.len().min(i32::MAX as usize) as i32,
             )
         };
+        if ptr.is_null() {
+            return Err(crate::Error::StencilTableCreation);
+        }
+
+        Ok(Self {
+            ptr,
+            has_1st_derivs: first.has_1st_derivs,
+            has_2nd_derivs: first.has_2nd_derivs,
+        })
+    }
+
+    /// Calls the factory on `descs`.
+    ///
+    /// # Safety
+    ///
+    /// The pointers of `sources` and `descs` must be valid for the call.
+    unsafe fn create(
+        sources: SharedSources,
+        descs: &[sys::far::limit_stencil_table::LocationArrayDesc],
+        options: &LimitStencilTableOptions,
+    ) -> crate::Result<Self> {
+        let factory_options = options.factory_options();
+        let ptr = instrument::stage(Stage::LimitStencilTableFactory, 0, || unsafe {
+            sys::far::limit_stencil_table::LimitStencilTableFactory_Create(
+                sources.refiner,
+                descs.as_ptr(),
+                descs.len() as i32,
+                sources.cv_stencils,
+                sources.patch_table,
+                factory_options.bitfield,
+                factory_options.fvar_channel,
+            )
+        });
 
         if ptr.is_null() {
             return Err(crate::Error::StencilTableCreation);
@@ -146,6 +319,24 @@ impl LimitStencilTable {
         })
     }
 
+    /// Take ownership of a table created by the shims.
+    pub(crate) fn from_raw(
+        ptr: sys::far::LimitStencilTablePtr,
+        has_1st_derivs: bool,
+        has_2nd_derivs: bool,
+    ) -> Self {
+        Self {
+            ptr,
+            has_1st_derivs,
+            has_2nd_derivs,
+        }
+    }
+
+    #[inline]
+    pub(crate) fn as_ptr(&self) -> sys::far::LimitStencilTablePtr {
+        self.ptr
+    }
+
     /// Cast to base `StencilTablePtr` for base-class FFI accessors.
     #[inline]
     fn as_base_ptr(&self) -> sys::far::StencilTablePtr {
@@ -286,6 +477,24 @@ impl LimitStencilTable {
     pub fn has_2nd_derivatives(&self) -> bool {
         self.has_2nd_derivs
     }
+
+    /// Returns the bytes held by the arrays of the table, derivative weights
+    /// included.
+    pub fn memory_footprint(&self) -> MemoryFootprint {
+        let weight_count = self.weights().len()
+            + self.du_weights().len()
+            + self.dv_weights().len()
+            + self.duu_weights().len()
+            + self.duv_weights().len()
+            + self.dvv_weights().len();
+        MemoryFootprint {
+            sizes: std::mem::size_of_val(self.sizes()),
+            offsets: std::mem::size_of_val(self.offsets()),
+            indices: std::mem::size_of_val(self.control_indices()),
+            weights: weight_count * std::mem::size_of::<f32>(),
+            ..Default::default()
+        }
+    }
 }
 
 impl std::fmt::Debug for LimitStencilTable {
@@ -298,3 +507,161 @@ impl std::fmt::Debug for LimitStencilTable {
             .finish()
     }
 }
+
+/// Checks that `stencil_table` has the derivative weights an evaluation
+/// needs.
+pub(crate) fn check_limit_stencils(
+    stencil_table: &LimitStencilTable,
+    second_derivatives: bool,
+) -> crate::Result<()> {
+    if !stencil_table.has_1st_derivatives() {
+        return Err(crate::Error::FeatureNotAvailable(
+            "limit stencil table has no 1st derivative weights".to_string(),
+        ));
+    }
+    if second_derivatives && !stencil_table.has_2nd_derivatives() {
+        return Err(crate::Error::FeatureNotAvailable(
+            "limit stencil table has no 2nd derivative weights".to_string(),
+        ));
+    }
+    Ok(())
+}
+
+/// Limit stencils of consecutive locations, see
+/// [`LimitStencilTable::chunks()`].
+#[derive(Debug)]
+pub struct LimitStencilChunk {
+    /// Index the first stencil of the chunk would have in the whole table.
+    pub first_stencil: usize,
+    /// The stencils of the chunk.
+    pub table: LimitStencilTable,
+}
+
+/// Iterator building limit stencil tables chunk by chunk, returned by
+/// [`LimitStencilTable::chunks()`].
+pub struct LimitStencilChunks<'a> {
+    sources: SharedSources,
+    locations: &'a [LocationArray<'a>],
+    chunks: std::vec::IntoIter<Vec<(usize, Range<usize>)>>,
+    options: LimitStencilTableOptions,
+    first_stencil: usize,
+    // Stencils and patch table built for the chunks to share.
+    _support: Option<(StencilTable, PatchTable)>,
+    _borrow: PhantomData<&'a TopologyRefiner>,
+}
+
+impl Iterator for LimitStencilChunks<'_> {
+    type Item = crate::Result<LimitStencilChunk>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        let chunk = self.chunks.next()?;
+        let first_stencil = self.first_stencil;
+        self.first_stencil += chunk.iter().map(|(_, range)| range.len()).sum::<usize>();
+        Some(
+            build_chunk(self.sources, self.locations, &chunk, &self.options).map(|table| {
+                LimitStencilChunk {
+                    first_stencil,
+                    table,
+                }
+            }),
+        )
+    }
+
+    fn size_hint(&self) -> (usize, Option<usize>) {
+        self.chunks.size_hint()
+    }
+}
+
+impl ExactSizeIterator for LimitStencilChunks<'_> {}
+
+impl std::fmt::Debug for LimitStencilChunks<'_> {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("LimitStencilChunks")
+            .field("remaining_chunks", &self.chunks.len())
+            .field("first_stencil", &self.first_stencil)
+            .finish()
+    }
+}
+
+// AIDEV-NOTE: Raw pointers so chunks can be built from rayon tasks. The
+// factory only reads the refiner, stencils and patch table, and whoever
+// owns them outlives every call that uses them.
+#[derive(Clone, Copy)]
+struct SharedSources {
+    refiner: *const sys::topology_refiner::TopologyRefiner,
+    cv_stencils: *const std::ffi::c_void,
+    patch_table: *const sys::far::PatchTable,
+}
+
+unsafe impl Send for SharedSources {}
+unsafe impl Sync for SharedSources {}
+
+/// Builds the limit stencils of one chunk.
+fn build_chunk(
+    sources: SharedSources,
+    locations: &[LocationArray<'_>],
+    chunk: &[(usize, Range<usize>)],
+    options: &LimitStencilTableOptions,
+) -> crate::Result<LimitStencilTable> {
+    let descs: Vec<_> = chunk
+        .iter()
+        .map(|(array, range)| location_desc(&locations[*array], range.clone()))
+        .collect();
+    unsafe { LimitStencilTable::create(sources, &descs, options) }
+}
+
+/// Checks that the `s` and `t` slices of each location array match.
+fn validate_locations(locations: &[LocationArray<'_>]) -> crate::Result<()> {
+    for loc in locations {
+        if loc.s.len() != loc.t.len() {
+            return Err(crate::Error::InvalidTopology(format!(
+                "LocationArray for ptex face {}: s.len()={} != t.len()={}",
+                loc.ptex_index,
+                loc.s.len(),
+                loc.t.len()
+            )));
+        }
+    }
+    Ok(())
+}
+
+fn location_desc(
+    location: &LocationArray<'_>,
+    range: Range<usize>,
+) -> sys::far::limit_stencil_table::LocationArrayDesc {
+    sys::far::limit_stencil_table::LocationArrayDesc {
+        ptex_idx: location.ptex_index as i32,
+        num_locations: range.len() as i32,
+        s: location.s[range.clone()].as_ptr(),
+        t: location.t[range].as_ptr(),
+    }
+}
+
+/// Splits `locations` into chunks of `chunk_locations` locations, the last
+/// one possibly shorter, as `(array, range of locations)` lists.
+fn split_chunks(
+    locations: &[LocationArray<'_>],
+    chunk_locations: usize,
+) -> Vec<Vec<(usize, Range<usize>)>> {
+    let chunk_locations = chunk_locations.max(1);
+    let mut chunks = Vec::new();
+    let mut chunk = Vec::new();
+    let mut len = 0;
+    for (array, location) in locations.iter().enumerate() {
+        let mut start = 0;
+        while start < location.s.len() {
+            let end = location.s.len().min(start + chunk_locations - len);
+            chunk.push((array, start..end));
+            len += end - start;
+            start = end;
+            if chunk_locations == len {
+                chunks.push(std::mem::take(&mut chunk));
+                len = 0;
+            }
+        }
+    }
+    if !chunk.is_empty() {
+        chunks.push(chunk);
+    }
+    chunks
+}
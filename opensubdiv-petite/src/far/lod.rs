@@ -0,0 +1,515 @@
+//! Level-of-detail selection for feature adaptive refinement.
+//!
+//! Refining every face of a distant mesh to the isolation level a close-up
+//! needs wastes most of the patch memory. A [`LodRefiner`] picks a level of
+//! detail (LOD) for each base face from a [`LodMetric`] -- e.g. the
+//! [`ScreenSpaceMetric`] of a camera -- and keeps one [`PatchTable`] and
+//! [`PatchMap`] per LOD. The table of a LOD isolates only the faces assigned
+//! to it, to that LOD's depth.
+//!
+//! The base level is built once and re-refined for each LOD. When the camera
+//! moves, [`LodRefiner::update()`] only rebuilds the LODs whose faces
+//! changed.
+//!
+//! ## Example
+//!
+//! ```no_run
+//! # use opensubdiv_petite::far::*;
+//! # fn example(refiner: TopologyRefiner, positions: &[f32]) -> opensubdiv_petite::Result<()> {
+//! let metric = ScreenSpaceMetric {
+//!     eye: [0.0, 0.0, 10.0],
+//!     fov_y: 0.8,
+//!     viewport_height: 1080.0,
+//!     target_edge_pixels: 8.0,
+//! };
+//! let mut lod_refiner =
+//!     LodRefiner::new(refiner, LodOptions::default(), PatchTableOptions::new())?;
+//! lod_refiner.update(positions, &metric)?;
+//!
+//! for lod in lod_refiner.lods() {
+//!     // Draw `lod.patch_indices()` of `lod.patch_table()`.
+//! }
+//! # Ok(())
+//! # }
+//! ```
+use super::{
+    AdaptiveRefinementOptions, PatchMap, PatchTable, PatchTableOptions, Scheme, TopologyRefiner,
+};
+use crate::{Error, Index, Result};
+
+#[cfg(feature = "rayon")]
+use rayon::prelude::*;
+
+/// Picks the refinement a base face needs.
+pub trait LodMetric: Sync {
+    /// Returns the isolation level the face with the given corner positions
+    /// should be refined to.
+    ///
+    /// The level is continuous; a [`LodRefiner`] rounds it up to the next
+    /// LOD and uses the fraction for hysteresis.
+    fn face_level(&self, corners: &[[f32; 3]]) -> f32;
+}
+
+impl<F> LodMetric for F
+where
+    F: Fn(&[[f32; 3]]) -> f32 + Sync,
+{
+    #[inline]
+    fn face_level(&self, corners: &[[f32; 3]]) -> f32 {
+        self(corners)
+    }
+}
+
+/// Refines faces until their edges cover a given number of pixels on
+/// screen.
+///
+/// Each level halves the edges of a face, so a face whose longest edge
+/// covers `p` pixels needs `log2(p / target_edge_pixels)` levels.
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub struct ScreenSpaceMetric {
+    /// Position of the camera.
+    pub eye: [f32; 3],
+    /// Vertical field of view, in radians.
+    pub fov_y: f32,
+    /// Height of the viewport, in pixels.
+    pub viewport_height: f32,
+    /// Length of the edges of the limit surface tessellation, in pixels.
+    pub target_edge_pixels: f32,
+}
+
+impl LodMetric for ScreenSpaceMetric {
+    fn face_level(&self, corners: &[[f32; 3]]) -> f32 {
+        let Some(&last) = corners.last() else {
+            return 0.0;
+        };
+
+        let mut centroid = [0.0f32; 3];
+        let mut longest_edge = 0.0f32;
+        let mut previous = last;
+        for &corner in corners {
+            longest_edge = longest_edge.max(distance(previous, corner));
+            for (sum, coordinate) in centroid.iter_mut().zip(corner) {
+                *sum += coordinate;
+            }
+            previous = corner;
+        }
+        let centroid = centroid.map(|sum| sum / corners.len() as f32);
+
+        // Faces the camera is inside of get no closer than their own size.
+        let distance = distance(centroid, self.eye)
+            .max(longest_edge)
+            .max(f32::MIN_POSITIVE);
+        let pixels =
+            longest_edge * self.viewport_height / (2.0 * (0.5 * self.fov_y).tan() * distance);
+
+        (pixels / self.target_edge_pixels).log2().max(0.0)
+    }
+}
+
+#[inline]
+fn distance(a: [f32; 3], b: [f32; 3]) -> f32 {
+    ((a[0] - b[0]).powi(2) + (a[1] - b[1]).powi(2) + (a[2] - b[2]).powi(2)).sqrt()
+}
+
+/// Options of a [`LodRefiner`].
+#[derive(Clone, Debug)]
+pub struct LodOptions {
+    /// Isolation level of each LOD, strictly ascending.
+    ///
+    /// A face goes to the first LOD whose level is at least the level its
+    /// metric asks for, or the last LOD.
+    pub isolation_levels: Vec<usize>,
+    /// How far, in levels, a face's metric must move past the boundary of
+    /// its current LOD before it changes LOD.
+    ///
+    /// Keeps faces near a boundary from flipping, and their LODs from being
+    /// rebuilt, with every small camera move.
+    pub hysteresis: f32,
+    /// Options of the adaptive refinement of every LOD. The isolation level
+    /// is taken from `isolation_levels`.
+    pub refinement: AdaptiveRefinementOptions,
+}
+
+impl Default for LodOptions {
+    /// Create LOD options with the following defaults:
+    ///
+    /// | Property           | Value                                        |
+    /// |--------------------|----------------------------------------------|
+    /// | `isolation_levels` | `[0, 1, 2, 3, 4]`                            |
+    /// | `hysteresis`       | `0.25`                                       |
+    /// | `refinement`       | [`AdaptiveRefinementOptions::default()`]     |
+    fn default() -> Self {
+        Self {
+            isolation_levels: vec![0, 1, 2, 3, 4],
+            hysteresis: 0.25,
+            refinement: AdaptiveRefinementOptions::default(),
+        }
+    }
+}
+
+impl LodOptions {
+    /// Returns the LOD a face asking for `level` goes to.
+    fn lod_of(&self, level: f32) -> usize {
+        self.isolation_levels
+            .partition_point(|&isolation_level| (isolation_level as f32) < level)
+            .min(self.isolation_levels.len() - 1)
+    }
+
+    /// Returns the LOD of a face asking for `level` that is currently in
+    /// `current`.
+    fn next_lod(&self, current: usize, level: f32) -> usize {
+        let lod = self.lod_of(level);
+        if (lod > current && self.lod_of(level - self.hysteresis) <= current)
+            || (lod < current && self.lod_of(level + self.hysteresis) >= current)
+        {
+            current
+        } else {
+            lod
+        }
+    }
+}
+
+/// The patches of one level of detail.
+pub struct LodPatches {
+    patch_map: PatchMap,
+    patch_table: PatchTable,
+    isolation_level: usize,
+    faces: Vec<Index>,
+    patch_indices: Vec<u32>,
+}
+
+impl LodPatches {
+    /// Returns the isolation level the faces of this LOD are refined to.
+    #[inline]
+    pub fn isolation_level(&self) -> usize {
+        self.isolation_level
+    }
+
+    /// Returns the base faces assigned to this LOD, ascending.
+    #[inline]
+    pub fn faces(&self) -> &[Index] {
+        &self.faces
+    }
+
+    /// Returns the patch table.
+    ///
+    /// The table covers the whole mesh; faces of other LODs appear
+    /// unrefined. Use [`patch_indices()`](Self::patch_indices()) to draw
+    /// only the patches of this LOD.
+    #[inline]
+    pub fn patch_table(&self) -> &PatchTable {
+        &self.patch_table
+    }
+
+    /// Returns the map locating the patches of the patch table.
+    ///
+    /// Pass [`patch_table()`](Self::patch_table()) to its lookups.
+    #[inline]
+    pub fn patch_map(&self) -> &PatchMap {
+        &self.patch_map
+    }
+
+    /// Returns the table-global indices of the patches of the faces of this
+    /// LOD, ascending.
+    #[inline]
+    pub fn patch_indices(&self) -> &[u32] {
+        &self.patch_indices
+    }
+}
+
+impl std::fmt::Debug for LodPatches {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("LodPatches")
+            .field("isolation_level", &self.isolation_level)
+            .field("face_count", &self.faces.len())
+            .field("patch_count", &self.patch_indices.len())
+            .finish()
+    }
+}
+
+/// What a call to [`LodRefiner::update()`] changed.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct LodUpdate {
+    /// Faces that moved to another LOD.
+    pub changed_faces: usize,
+    /// LODs whose patch table was rebuilt or dropped.
+    pub rebuilt_lods: usize,
+}
+
+/// Builds and maintains per-LOD patch tables of one mesh.
+///
+/// See the [module level documentation](crate::far::lod) for an example.
+pub struct LodRefiner {
+    lods: Vec<Option<LodPatches>>,
+    refiner: TopologyRefiner,
+    options: LodOptions,
+    patch_options: PatchTableOptions,
+    face_offsets: Vec<u32>,
+    face_vertices: Vec<Index>,
+    ptex_offsets: Vec<u32>,
+    face_lods: Vec<u8>,
+}
+
+impl std::fmt::Debug for LodRefiner {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("LodRefiner")
+            .field("options", &self.options)
+            .field("face_count", &self.face_lods.len())
+            .field("lods", &self.lods)
+            .finish()
+    }
+}
+
+impl LodRefiner {
+    /// Wraps `refiner`, unrefining it to its base level.
+    ///
+    /// All faces start out in the first LOD; call [`update()`](Self::update())
+    /// or [`assign()`](Self::assign()) to build the tables.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::InvalidPatch`] if the isolation levels are empty,
+    /// not strictly ascending, or there are more than 256 of them.
+    pub fn new(
+        mut refiner: TopologyRefiner,
+        options: LodOptions,
+        patch_options: PatchTableOptions,
+    ) -> Result<Self> {
+        let levels = &options.isolation_levels;
+        if levels.is_empty()
+            || 256 < levels.len()
+            || levels.windows(2).any(|pair| pair[1] <= pair[0])
+        {
+            return Err(Error::InvalidPatch(format!(
+                "LOD isolation levels must be 1 to 256 strictly ascending values, got {levels:?}."
+            )));
+        }
+
+        refiner.unrefine();
+        let (face_offsets, face_vertices) = {
+            let base = refiner.level(0).ok_or(Error::CreateTopologyRefinerFailed)?;
+            let relation = base.face_vertex_relation();
+            (relation.offsets().to_vec(), relation.indices().to_vec())
+        };
+
+        // Patch parameters refer to ptex faces; non-regular faces are split
+        // into one ptex face per corner.
+        let regular_size = match refiner.options().scheme {
+            Scheme::Loop => 3,
+            _ => 4,
+        };
+        let ptex_offsets = std::iter::once(0)
+            .chain(face_offsets.windows(2).scan(0u32, |ptex_count, pair| {
+                let size = pair[1] - pair[0];
+                *ptex_count += if regular_size == size { 1 } else { size };
+                Some(*ptex_count)
+            }))
+            .collect();
+
+        let face_count = face_offsets.len() - 1;
+        let lod_count = options.isolation_levels.len();
+        Ok(Self {
+            lods: (0..lod_count).map(|_| None).collect(),
+            refiner,
+            options,
+            patch_options,
+            face_offsets,
+            face_vertices,
+            ptex_offsets,
+            face_lods: vec![0; face_count],
+        })
+    }
+
+    /// Returns the options.
+    #[inline]
+    pub fn options(&self) -> &LodOptions {
+        &self.options
+    }
+
+    /// Returns the refiner, refined for the LOD built last.
+    #[inline]
+    pub fn refiner(&self) -> &TopologyRefiner {
+        &self.refiner
+    }
+
+    /// Returns the LOD of every base face.
+    #[inline]
+    pub fn face_lods(&self) -> &[u8] {
+        &self.face_lods
+    }
+
+    /// Returns a LOD, or `None` if no face is assigned to it.
+    #[inline]
+    pub fn lod(&self, lod: usize) -> Option<&LodPatches> {
+        self.lods.get(lod)?.as_ref()
+    }
+
+    /// Returns the LODs faces are assigned to.
+    pub fn lods(&self) -> impl Iterator<Item = &LodPatches> {
+        self.lods.iter().flatten()
+    }
+
+    /// Returns the LOD every base face goes to under `metric`, without
+    /// changing anything.
+    ///
+    /// `positions` holds three `f32`s per base vertex. Faces are measured in
+    /// parallel when the `rayon` feature is enabled.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::InvalidBufferSize`] if `positions` is too short.
+    pub fn select(&self, positions: &[f32], metric: &impl LodMetric) -> Result<Vec<u8>> {
+        let positions: &[[f32; 3]] =
+            bytemuck::cast_slice(&positions[..positions.len() - positions.len() % 3]);
+        let vertex_count = self
+            .face_vertices
+            .iter()
+            .max()
+            .map_or(0, |&vertex| vertex.0 as usize + 1);
+        if positions.len() < vertex_count {
+            return Err(Error::InvalidBufferSize {
+                expected: 3 * vertex_count,
+                actual: 3 * positions.len(),
+            });
+        }
+
+        // Borrow the fields on their own; the refiner is not `Sync`.
+        let (options, face_offsets, face_vertices) =
+            (&self.options, &self.face_offsets, &self.face_vertices);
+        let face_lod = |(face, &current): (usize, &u8)| {
+            let vertices =
+                &face_vertices[face_offsets[face] as usize..face_offsets[face + 1] as usize];
+            let corners: Vec<[f32; 3]> = vertices
+                .iter()
+                .map(|&vertex| positions[vertex.0 as usize])
+                .collect();
+            options.next_lod(current as usize, metric.face_level(&corners)) as u8
+        };
+
+        #[cfg(feature = "rayon")]
+        let face_lods = self
+            .face_lods
+            .par_iter()
+            .enumerate()
+            .map(face_lod)
+            .collect();
+        #[cfg(not(feature = "rayon"))]
+        let face_lods = self.face_lods.iter().enumerate().map(face_lod).collect();
+
+        Ok(face_lods)
+    }
+
+    /// Measures every base face with `metric` and rebuilds the LODs whose
+    /// faces changed.
+    ///
+    /// # Errors
+    ///
+    /// See [`select()`](Self::select()) and [`assign()`](Self::assign()).
+    pub fn update(&mut self, positions: &[f32], metric: &impl LodMetric) -> Result<LodUpdate> {
+        let face_lods = self.select(positions, metric)?;
+        self.assign(&face_lods)
+    }
+
+    /// Assigns a LOD to every base face, e.g. from an error metric computed
+    /// elsewhere, and rebuilds the LODs whose faces changed.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::InvalidBufferSize`] if `face_lods` does not hold one
+    /// entry per base face, [`Error::IndexOutOfBounds`] if an entry is not a
+    /// LOD, and [`Error::PatchTableCreation`] if a table cannot be built.
+    pub fn assign(&mut self, face_lods: &[u8]) -> Result<LodUpdate> {
+        if face_lods.len() != self.face_lods.len() {
+            return Err(Error::InvalidBufferSize {
+                expected: self.face_lods.len(),
+                actual: face_lods.len(),
+            });
+        }
+        let lod_count = self.lods.len();
+        if let Some(&lod) = face_lods.iter().find(|&&lod| lod_count <= lod as usize) {
+            return Err(Error::IndexOutOfBounds {
+                index: lod as usize,
+                max: lod_count - 1,
+            });
+        }
+
+        let mut stale = vec![false; lod_count];
+        let mut changed_faces = 0;
+        for (&old, &new) in self.face_lods.iter().zip(face_lods) {
+            if old != new {
+                stale[old as usize] = true;
+                stale[new as usize] = true;
+                changed_faces += 1;
+            }
+        }
+        // LODs that were never built but have faces.
+        for &lod in face_lods {
+            stale[lod as usize] |= self.lods[lod as usize].is_none();
+        }
+        self.face_lods.copy_from_slice(face_lods);
+
+        let mut rebuilt_lods = 0;
+        for lod in (0..lod_count).filter(|&lod| stale[lod]) {
+            self.lods[lod] = None;
+            self.lods[lod] = self.build(lod)?;
+            rebuilt_lods += 1;
+        }
+
+        Ok(LodUpdate {
+            changed_faces,
+            rebuilt_lods,
+        })
+    }
+
+    /// Builds the patches of `lod`, or returns `None` if it has no faces.
+    fn build(&mut self, lod: usize) -> Result<Option<LodPatches>> {
+        let faces: Vec<Index> = (0..self.face_lods.len())
+            .filter(|&face| lod == self.face_lods[face] as usize)
+            .map(Index::from)
+            .collect();
+        if faces.is_empty() {
+            return Ok(None);
+        }
+
+        let isolation_level = self.options.isolation_levels[lod];
+        let refinement = AdaptiveRefinementOptions {
+            isolation_level,
+            ..self.options.refinement
+        };
+        // AIDEV-NOTE: An empty selection makes OpenSubdiv refine every face,
+        // which is also what a level of zero wants.
+        let selection = (0 < isolation_level).then_some(faces.as_slice());
+        self.refiner.unrefine();
+        self.refiner.refine_adaptive(refinement, selection);
+
+        let patch_table = PatchTable::with_options(&self.refiner, Some(&self.patch_options))?;
+        let patch_indices = (0..patch_table.patch_count())
+            .filter(|&patch| {
+                patch_table
+                    .patch_handle(patch)
+                    .and_then(|handle| patch_table.patch_param_with_handle(handle))
+                    .is_some_and(|param| lod == self.face_lod_of_ptex_face(param.face_id()))
+            })
+            .map(|patch| patch as u32)
+            .collect();
+
+        Ok(Some(LodPatches {
+            patch_map: PatchMap::new(&patch_table).ok_or(Error::PatchTableCreation)?,
+            patch_table,
+            isolation_level,
+            faces,
+            patch_indices,
+        }))
+    }
+
+    /// Returns the LOD of the base face a ptex face belongs to.
+    fn face_lod_of_ptex_face(&self, ptex_face: usize) -> usize {
+        let face = self
+            .ptex_offsets
+            .partition_point(|&offset| offset as usize <= ptex_face)
+            - 1;
+        self.face_lods
+            .get(face)
+            .map_or(usize::MAX, |&lod| lod as usize)
+    }
+}
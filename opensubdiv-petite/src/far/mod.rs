@@ -46,6 +46,14 @@
 //! * `LimitStencilTable` -- A representation of refinement weights suitable for
 //!   efficient parallel processing of primvar refinement at arbitrary limit
 //!   surface locations.
+//! * [`StencilReverseIndex`] -- Maps control vertices to the stencils reading
+//!   them, to recompute only those after a few control vertices moved.
+//! * [`TableCache`] -- Stores the tables of a topology in a file that loads
+//!   without rebuilding them.
+//! * [`TopologyCache`] -- Shares the refiner and tables of identical
+//!   topologies across assets and threads.
+//! * [`LodRefiner`] -- Keeps one patch table per level of detail, isolating
+//!   each face only as deep as a camera or error metric asks for.
 pub mod topology_descriptor;
 pub use topology_descriptor::*;
 
@@ -61,8 +69,23 @@ pub use stencil_table::*;
 pub mod limit_stencil_table;
 pub use limit_stencil_table::*;
 
+pub mod reorder;
+pub use reorder::*;
+
+pub mod incremental;
+pub use incremental::*;
+
 pub mod primvar_refiner;
 pub use primvar_refiner::*;
 
 pub mod patch_table;
 pub use patch_table::*;
+
+pub mod cache;
+pub use cache::*;
+
+pub mod topology_cache;
+pub use topology_cache::*;
+
+pub mod lod;
+pub use lod::*;
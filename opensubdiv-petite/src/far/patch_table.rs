@@ -10,6 +10,8 @@
 //! patch's parameterization.
 
 use super::StencilTableRef;
+use crate::instrument::{self, MemoryFootprint, Stage};
+use crate::osd::BufferDescriptor;
 use crate::{Error, Index};
 use opensubdiv_petite_sys as sys;
 use std::marker::PhantomData;
@@ -153,34 +155,215 @@ pub use crate::far::topology_refiner::TriangleSubdivision;
 /// of working with local points and their stencil tables.
 pub struct PatchTable {
     ptr: *mut sys::far::PatchTable,
+    // AIDEV-NOTE: Prefix sums over the patch arrays, cached at construction so
+    // patch-index -> handle lookups don't walk the arrays through FFI.
+    patch_arrays: Vec<PatchArrayLayout>,
+    // Number of points the control vertex indices address (refined vertices
+    // plus local points), used to validate batched evaluation input.
+    point_count: usize,
+    // Identifies the table to the `PatchMap`s built from it.
+    id: u64,
     _phantom: PhantomData<sys::far::PatchTable>,
 }
 
+/// Source of [`PatchTable`] ids.
+static NEXT_PATCH_TABLE_ID: std::sync::atomic::AtomicU64 = std::sync::atomic::AtomicU64::new(0);
+
+/// Position of one patch array within the table-global patch and control
+/// vertex index spaces.
+#[derive(Clone, Copy, Debug)]
+struct PatchArrayLayout {
+    first_patch: usize,
+    patch_count: usize,
+    first_vertex: usize,
+    control_vertex_count: usize,
+}
+
+/// Identifies a patch within a [`PatchTable`].
+///
+/// Resolving a patch index into a handle once (via
+/// [`PatchTable::patch_handle()`]) makes subsequent evaluation O(1).
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Hash)]
+pub struct PatchHandle {
+    array_index: usize,
+    patch_index: usize,
+    vertex_index: usize,
+}
+
+impl PatchHandle {
+    /// Returns the index of the patch array containing the patch.
+    #[inline]
+    pub fn array_index(&self) -> usize {
+        self.array_index
+    }
+
+    /// Returns the table-global index of the patch.
+    #[inline]
+    pub fn patch_index(&self) -> usize {
+        self.patch_index
+    }
+
+    /// Returns the offset of the patch's first control vertex in
+    /// [`PatchTable::control_vertices_table()`].
+    #[inline]
+    pub fn vertex_index(&self) -> usize {
+        self.vertex_index
+    }
+
+    pub(crate) fn from_sys(handle: sys::far::PatchHandle) -> Self {
+        Self {
+            array_index: handle.array_index as _,
+            patch_index: handle.patch_index as _,
+            vertex_index: handle.vert_index as _,
+        }
+    }
+
+    pub(crate) fn to_sys(self) -> sys::far::PatchHandle {
+        sys::far::PatchHandle {
+            array_index: self.array_index as _,
+            patch_index: self.patch_index as _,
+            vert_index: self.vertex_index as _,
+        }
+    }
+}
+
 impl PatchTable {
     /// Create a new patch table from a topology refiner
     pub fn new(
         refiner: &crate::far::TopologyRefiner,
         options: Option<PatchTableOptions>,
+    ) -> Result<Self, Error> {
+        Self::with_options(refiner, options.as_ref())
+    }
+
+    /// Create a new patch table, borrowing the options to build several
+    /// tables with them.
+    pub(crate) fn with_options(
+        refiner: &crate::far::TopologyRefiner,
+        options: Option<&PatchTableOptions>,
     ) -> Result<Self, Error> {
         unsafe {
-            let options_ptr = options
-                .as_ref()
-                .map(|o| o.as_ptr())
-                .unwrap_or(std::ptr::null());
+            let options_ptr = options.map(|o| o.as_ptr()).unwrap_or(std::ptr::null());
 
-            let ptr = sys::far::PatchTableFactory_Create(refiner.as_ptr(), options_ptr);
+            let ptr = instrument::stage(Stage::PatchTableFactory, 0, || {
+                sys::far::PatchTableFactory_Create(refiner.as_ptr(), options_ptr)
+            });
 
             if ptr.is_null() {
                 Err(Error::PatchTableCreation)
             } else {
-                Ok(Self {
-                    ptr,
-                    _phantom: PhantomData,
-                })
+                let table = Self::from_raw(ptr);
+                instrument::table(Stage::PatchTableFactory, || table.memory_footprint());
+                Ok(table)
             }
         }
     }
 
+    /// Take ownership of a table created by the shims.
+    ///
+    /// # Safety
+    ///
+    /// `ptr` must be a non-null table allocated with `new` on the C++ side
+    /// and not owned elsewhere.
+    pub(crate) unsafe fn from_raw(ptr: *mut sys::far::PatchTable) -> Self {
+        let mut table = Self {
+            ptr,
+            patch_arrays: Self::patch_array_layouts(ptr),
+            point_count: 0,
+            id: NEXT_PATCH_TABLE_ID.fetch_add(1, std::sync::atomic::Ordering::Relaxed),
+            _phantom: PhantomData,
+        };
+        table.point_count = table
+            .control_vertices_table()
+            .and_then(|indices| indices.iter().max())
+            .map_or(0, |&max| max as usize + 1);
+        table
+    }
+
+    fn patch_array_layouts(ptr: *const sys::far::PatchTable) -> Vec<PatchArrayLayout> {
+        let array_count = unsafe { sys::far::PatchTable_GetNumPatchArrays(ptr) } as usize;
+
+        (0..array_count)
+            .scan(
+                (0usize, 0usize),
+                |(first_patch, first_vertex), array_index| {
+                    let (patch_count, control_vertex_count) = unsafe {
+                        let mut desc = std::mem::zeroed::<sys::far::PatchDescriptor>();
+                        sys::far::PatchTable_GetPatchArrayDescriptor(
+                            ptr,
+                            array_index as _,
+                            &mut desc,
+                        );
+                        (
+                            sys::far::PatchTable_GetNumPatches_PatchArray(ptr, array_index as _)
+                                as usize,
+                            sys::far::PatchDescriptor_GetNumControlVertices(&desc) as usize,
+                        )
+                    };
+                    let layout = PatchArrayLayout {
+                        first_patch: *first_patch,
+                        patch_count,
+                        first_vertex: *first_vertex,
+                        control_vertex_count,
+                    };
+                    *first_patch += patch_count;
+                    *first_vertex += patch_count * control_vertex_count;
+                    Some(layout)
+                },
+            )
+            .collect()
+    }
+
+    /// Resolves a table-global patch index into a [`PatchHandle`].
+    ///
+    /// Returns `None` if `patch_index` is out of range.
+    pub fn patch_handle(&self, patch_index: usize) -> Option<PatchHandle> {
+        let array_index = self
+            .patch_arrays
+            .partition_point(|layout| layout.first_patch + layout.patch_count <= patch_index);
+        self.patch_arrays
+            .get(array_index)
+            .map(|layout| PatchHandle {
+                array_index,
+                patch_index,
+                vertex_index: layout.first_vertex
+                    + (patch_index - layout.first_patch) * layout.control_vertex_count,
+            })
+    }
+
+    /// Returns the layout of the array `handle` refers to if `handle` is
+    /// consistent with this table.
+    fn patch_array_layout(&self, handle: PatchHandle) -> Option<&PatchArrayLayout> {
+        self.patch_arrays.get(handle.array_index).filter(|layout| {
+            (layout.first_patch..layout.first_patch + layout.patch_count)
+                .contains(&handle.patch_index)
+                && handle.vertex_index
+                    == layout.first_vertex
+                        + (handle.patch_index - layout.first_patch) * layout.control_vertex_count
+        })
+    }
+
+    /// Returns `true` if `handle` refers to a patch of this table.
+    #[inline]
+    pub(crate) fn is_valid_handle(&self, handle: PatchHandle) -> bool {
+        self.patch_array_layout(handle).is_some()
+    }
+
+    /// Returns the number of points the control vertex indices address, i.e.
+    /// the refined vertices plus the local points.
+    #[inline]
+    pub(crate) fn point_count(&self) -> usize {
+        self.point_count
+    }
+
+    /// Returns the control vertex indices of the patch `handle` refers to.
+    pub fn patch_vertices(&self, handle: PatchHandle) -> Option<&[Index]> {
+        let layout = self.patch_array_layout(handle)?;
+        self.control_vertices_table().and_then(|table| {
+            table.get(handle.vertex_index..handle.vertex_index + layout.control_vertex_count)
+        })
+    }
+
     /// Get the number of patch arrays
     pub fn patch_array_count(&self) -> usize {
         unsafe { sys::far::PatchTable_GetNumPatchArrays(self.ptr) as usize }
@@ -342,6 +525,12 @@ impl PatchTable {
         }
     }
 
+    /// Get the patch parameter for an already resolved patch.
+    pub fn patch_param_with_handle(&self, handle: PatchHandle) -> Option<PatchParam> {
+        let layout = self.patch_array_layout(handle)?;
+        self.patch_param(handle.array_index, handle.patch_index - layout.first_patch)
+    }
+
     /// Get all patch control vertex indices
     pub fn control_vertices_table(&self) -> Option<&[Index]> {
         unsafe {
@@ -356,6 +545,19 @@ impl PatchTable {
         }
     }
 
+    /// Returns the bytes held by the control vertex indices, the patch
+    /// parameters and the local point stencils of the table.
+    pub fn memory_footprint(&self) -> MemoryFootprint {
+        MemoryFootprint {
+            indices: self.control_vertex_count() * std::mem::size_of::<Index>(),
+            patch_params: self.patch_count() * std::mem::size_of::<sys::far::PatchParam>(),
+            local_points: self
+                .local_point_stencil_table()
+                .map_or(0, |stencils| stencils.memory_footprint().total()),
+            ..Default::default()
+        }
+    }
+
     pub(crate) fn as_ptr(&self) -> *const sys::far::PatchTable {
         self.ptr
     }
@@ -381,34 +583,7 @@ pub struct PatchDescriptor {
 impl PatchDescriptor {
     /// Get the patch type
     pub fn patch_type(&self) -> PatchType {
-        unsafe {
-            let patch_type = sys::far::PatchDescriptor_GetType(&self.inner);
-            match patch_type {
-                0 => PatchType::NonPatch,
-                1 => PatchType::Points,
-                2 => PatchType::Lines,
-                3 => PatchType::Quads,
-                4 => PatchType::Triangles,
-                5 => PatchType::Loop,
-                6 => PatchType::Regular,
-                7 => PatchType::BoundaryPattern0,
-                8 => PatchType::BoundaryPattern1,
-                9 => PatchType::BoundaryPattern2,
-                10 => PatchType::BoundaryPattern3,
-                11 => PatchType::BoundaryPattern4,
-                12 => PatchType::CornerPattern0,
-                13 => PatchType::CornerPattern1,
-                14 => PatchType::CornerPattern2,
-                15 => PatchType::CornerPattern3,
-                16 => PatchType::CornerPattern4,
-                17 => PatchType::Gregory,
-                18 => PatchType::GregoryBoundary,
-                19 => PatchType::GregoryCorner,
-                20 => PatchType::GregoryBasis,
-                21 => PatchType::GregoryTriangle,
-                _ => PatchType::NonPatch,
-            }
-        }
+        PatchType::from_raw(unsafe { sys::far::PatchDescriptor_GetType(&self.inner) })
     }
 
     /// Get the number of control vertices for this patch type
@@ -466,6 +641,45 @@ pub enum PatchType {
     GregoryTriangle,
 }
 
+impl PatchType {
+    /// Maps a `Far::PatchDescriptor::Type` value to a patch type.
+    pub(crate) fn from_raw(patch_type: i32) -> Self {
+        match patch_type {
+            0 => PatchType::NonPatch,
+            1 => PatchType::Points,
+            2 => PatchType::Lines,
+            3 => PatchType::Quads,
+            4 => PatchType::Triangles,
+            5 => PatchType::Loop,
+            6 => PatchType::Regular,
+            7 => PatchType::BoundaryPattern0,
+            8 => PatchType::BoundaryPattern1,
+            9 => PatchType::BoundaryPattern2,
+            10 => PatchType::BoundaryPattern3,
+            11 => PatchType::BoundaryPattern4,
+            12 => PatchType::CornerPattern0,
+            13 => PatchType::CornerPattern1,
+            14 => PatchType::CornerPattern2,
+            15 => PatchType::CornerPattern3,
+            16 => PatchType::CornerPattern4,
+            17 => PatchType::Gregory,
+            18 => PatchType::GregoryBoundary,
+            19 => PatchType::GregoryCorner,
+            20 => PatchType::GregoryBasis,
+            21 => PatchType::GregoryTriangle,
+            _ => PatchType::NonPatch,
+        }
+    }
+
+    /// Returns `true` for patches parameterized over a triangle.
+    pub fn is_triangular(&self) -> bool {
+        matches!(
+            self,
+            PatchType::Triangles | PatchType::Loop | PatchType::GregoryTriangle
+        )
+    }
+}
+
 /// Parameters for a patch
 #[derive(Clone, Copy)]
 pub struct PatchParam {
@@ -483,6 +697,11 @@ impl PatchParam {
         }
     }
 
+    /// Get the index of the base face (ptex face) the patch lies on
+    pub fn face_id(&self) -> usize {
+        unsafe { sys::far::PatchParam_GetFaceId(&self.inner) as usize }
+    }
+
     /// Get the subdivision depth of the patch
     pub fn depth(&self) -> usize {
         unsafe { sys::far::PatchParam_GetDepth(&self.inner) as usize }
@@ -502,6 +721,47 @@ impl PatchParam {
     pub fn transition(&self) -> i32 {
         unsafe { sys::far::PatchParam_GetTransition(&self.inner) }
     }
+
+    /// Map face (ptex) coordinates into this patch's `[0, 1]` parameter space.
+    pub fn normalize(&self, u: f32, v: f32) -> (f32, f32) {
+        let (mut u, mut v) = (u, v);
+        unsafe { sys::far::PatchParam_Normalize(&self.inner, &mut u, &mut v) };
+        (u, v)
+    }
+
+    /// Map patch-local coordinates back to face (ptex) coordinates.
+    pub fn unnormalize(&self, u: f32, v: f32) -> (f32, f32) {
+        let (mut u, mut v) = (u, v);
+        unsafe { sys::far::PatchParam_Unnormalize(&self.inner, &mut u, &mut v) };
+        (u, v)
+    }
+
+    /// Triangular variant of [`normalize()`](Self::normalize()) for
+    /// [`PatchType::Loop`] and [`PatchType::GregoryTriangle`] patches.
+    pub fn normalize_triangle(&self, u: f32, v: f32) -> (f32, f32) {
+        let (mut u, mut v) = (u, v);
+        unsafe { sys::far::PatchParam_NormalizeTriangle(&self.inner, &mut u, &mut v) };
+        (u, v)
+    }
+
+    /// Triangular variant of [`unnormalize()`](Self::unnormalize()) for
+    /// [`PatchType::Loop`] and [`PatchType::GregoryTriangle`] patches.
+    pub fn unnormalize_triangle(&self, u: f32, v: f32) -> (f32, f32) {
+        let (mut u, mut v) = (u, v);
+        unsafe { sys::far::PatchParam_UnnormalizeTriangle(&self.inner, &mut u, &mut v) };
+        (u, v)
+    }
+
+    /// Returns the packed representation, e.g. for caching.
+    pub(crate) fn bits(&self) -> [u32; 2] {
+        self.inner.bits()
+    }
+
+    pub(crate) fn from_bits(bits: [u32; 2]) -> Self {
+        Self {
+            inner: sys::far::PatchParam::from_bits(bits),
+        }
+    }
 }
 
 /// Result of patch evaluation containing point and derivatives
@@ -538,30 +798,31 @@ impl From<sys::far::PatchEvalResult> for PatchEvalResult {
 pub type BasisWeights = (Vec<f32>, Vec<f32>, Vec<f32>, Vec<f32>, Vec<f32>, Vec<f32>);
 
 impl PatchTable {
-    /// Evaluate basis functions for a patch at given parametric coordinates
+    /// Evaluate basis functions for a patch at given parametric coordinates.
+    ///
+    /// `u` and `v` are face (ptex) coordinates, as passed to
+    /// [`PatchMap::find_patch()`]. Use [`PatchParam::unnormalize()`] to
+    /// convert patch-local coordinates first. The patch's [`PatchParam`] maps
+    /// them into the patch, applies its boundary mask and scales derivatives
+    /// accordingly.
+    ///
+    /// Returns `None` for out-of-range patches and for legacy Gregory patch
+    /// types, which have no basis evaluation in *OpenSubdiv*.
     pub fn evaluate_basis(&self, patch_index: usize, u: f32, v: f32) -> Option<BasisWeights> {
-        if patch_index >= self.patch_count() {
-            return None;
-        }
-
-        // Find which patch array this patch belongs to
-        let mut array_index = 0;
-        let mut local_patch_index = patch_index;
-
-        for i in 0..self.patch_array_count() {
-            let num_patches = self.patch_array_patch_count(i);
-            if local_patch_index < num_patches {
-                array_index = i;
-                break;
-            }
-            local_patch_index -= num_patches;
-        }
+        self.evaluate_basis_with_handle(self.patch_handle(patch_index)?, u, v)
+    }
 
-        // Get the number of control vertices for this patch
-        let desc = self.patch_array_descriptor(array_index)?;
-        let num_cvs = desc.control_vertex_count();
+    /// Evaluate basis functions for an already resolved patch.
+    ///
+    /// See [`evaluate_basis()`](Self::evaluate_basis()).
+    pub fn evaluate_basis_with_handle(
+        &self,
+        handle: PatchHandle,
+        u: f32,
+        v: f32,
+    ) -> Option<BasisWeights> {
+        let num_cvs = self.patch_array_layout(handle)?.control_vertex_count;
 
-        // Allocate vectors for weights
         let mut w_p = vec![0.0f32; num_cvs];
         let mut w_du = vec![0.0f32; num_cvs];
         let mut w_dv = vec![0.0f32; num_cvs];
@@ -569,10 +830,11 @@ impl PatchTable {
         let mut w_duv = vec![0.0f32; num_cvs];
         let mut w_dvv = vec![0.0f32; num_cvs];
 
-        unsafe {
-            let success = sys::far::PatchTable_EvaluateBasis(
+        let handle = handle.to_sys();
+        let success = unsafe {
+            sys::far::PatchTable_EvaluateBasisHandle(
                 self.ptr,
-                patch_index as i32,
+                &handle,
                 u,
                 v,
                 w_p.as_mut_ptr(),
@@ -581,17 +843,16 @@ impl PatchTable {
                 w_duu.as_mut_ptr(),
                 w_duv.as_mut_ptr(),
                 w_dvv.as_mut_ptr(),
-            );
+            )
+        };
 
-            if success {
-                Some((w_p, w_du, w_dv, w_duu, w_duv, w_dvv))
-            } else {
-                None
-            }
-        }
+        success.then_some((w_p, w_du, w_dv, w_duu, w_duv, w_dvv))
     }
 
-    /// Evaluate a patch at given parametric coordinates using control points
+    /// Evaluate a patch at given parametric coordinates using control points.
+    ///
+    /// `u` and `v` are face (ptex) coordinates; see
+    /// [`evaluate_basis()`](Self::evaluate_basis()).
     pub fn evaluate_point(
         &self,
         patch_index: usize,
@@ -625,13 +886,465 @@ impl PatchTable {
     }
 }
 
-/// Map for efficient patch location from face coordinates
+/// Structure-of-arrays patch locations for batched evaluation.
+///
+/// `u` and `v` are face (ptex) coordinates; see
+/// [`PatchTable::evaluate_basis()`]. All slices must have the same length.
+#[derive(Clone, Copy, Debug)]
+pub struct PatchPoints<'a> {
+    /// Table-global patch index of each point.
+    pub patch_indices: &'a [u32],
+    /// Face `u` coordinate of each point.
+    pub u: &'a [f32],
+    /// Face `v` coordinate of each point.
+    pub v: &'a [f32],
+}
+
+/// Structure-of-arrays face locations for batched evaluation.
+///
+/// Each point is located with a [`PatchMap`]. All slices must have the same
+/// length.
+#[derive(Clone, Copy, Debug)]
+pub struct FacePoints<'a> {
+    /// Ptex face index of each point.
+    pub face_indices: &'a [u32],
+    /// Face `u` coordinate of each point.
+    pub u: &'a [f32],
+    /// Face `v` coordinate of each point.
+    pub v: &'a [f32],
+}
+
+/// Caller-owned output buffers for batched patch evaluation.
+///
+/// Every buffer that is `Some` receives one element per point, laid out as
+/// described by `desc`. Derivatives whose buffers are `None` are not
+/// computed.
+#[derive(Debug, Default)]
+pub struct PatchEvalOutputs<'a> {
+    /// Layout shared by all output buffers.
+    pub desc: BufferDescriptor,
+    /// Limit positions.
+    pub position: Option<&'a mut [f32]>,
+    /// First derivatives with respect to `u`.
+    pub du: Option<&'a mut [f32]>,
+    /// First derivatives with respect to `v`.
+    pub dv: Option<&'a mut [f32]>,
+    /// Second derivatives with respect to `u`.
+    pub duu: Option<&'a mut [f32]>,
+    /// Mixed second derivatives.
+    pub duv: Option<&'a mut [f32]>,
+    /// Second derivatives with respect to `v`.
+    pub dvv: Option<&'a mut [f32]>,
+}
+
+impl<'a> PatchEvalOutputs<'a> {
+    fn buffers(&self) -> [Option<&[f32]>; 6] {
+        [
+            self.position.as_deref(),
+            self.du.as_deref(),
+            self.dv.as_deref(),
+            self.duu.as_deref(),
+            self.duv.as_deref(),
+            self.dvv.as_deref(),
+        ]
+    }
+
+    pub(crate) fn as_mut_ptrs(&mut self) -> [*mut f32; 6] {
+        [
+            &mut self.position,
+            &mut self.du,
+            &mut self.dv,
+            &mut self.duu,
+            &mut self.duv,
+            &mut self.dvv,
+        ]
+        .map(|buffer| {
+            buffer
+                .as_deref_mut()
+                .map_or(std::ptr::null_mut(), |buffer| buffer.as_mut_ptr())
+        })
+    }
+
+    pub(crate) fn validate(&self, point_count: usize) -> crate::Result<()> {
+        let expected = self.desc.buffer_len(point_count);
+        self.buffers()
+            .into_iter()
+            .flatten()
+            .try_for_each(|buffer| match buffer.len() < expected {
+                true => Err(Error::InvalidBufferSize {
+                    expected,
+                    actual: buffer.len(),
+                }),
+                false => Ok(()),
+            })
+    }
+
+    // AIDEV-NOTE: Splits the outputs into disjoint per-chunk views so rayon
+    // tasks can write them concurrently without unsafe code. Whole strides of
+    // the descriptor's offset are dropped first; since `is_valid()` holds the
+    // remaining local offset plus length within one stride, chunk `i` then
+    // starts exactly at `i * chunk_points * stride`.
+    #[cfg(feature = "rayon")]
+    fn split(mut self, point_count: usize, chunk_points: usize) -> Vec<PatchEvalOutputs<'a>> {
+        let stride = self.desc.0.stride as usize;
+        let local_offset = self.desc.local_offset();
+        let skip = self.desc.0.offset as usize - local_offset;
+        let desc = BufferDescriptor(sys::osd::BufferDescriptor {
+            offset: local_offset as _,
+            ..self.desc.0
+        });
+
+        let mut buffers = [
+            self.position.take(),
+            self.du.take(),
+            self.dv.take(),
+            self.duu.take(),
+            self.duv.take(),
+            self.dvv.take(),
+        ]
+        .map(|buffer| buffer.map(|buffer| &mut buffer[skip..]));
+
+        let chunk_len = chunk_points * stride;
+        (0..point_count.div_ceil(chunk_points))
+            .map(|_| {
+                let [position, du, dv, duu, duv, dvv] = buffers.each_mut().map(|buffer| {
+                    buffer.take().map(|rest| {
+                        let (head, tail) = rest.split_at_mut(chunk_len.min(rest.len()));
+                        *buffer = Some(tail);
+                        head
+                    })
+                });
+                PatchEvalOutputs {
+                    desc,
+                    position,
+                    du,
+                    dv,
+                    duu,
+                    duv,
+                    dvv,
+                }
+            })
+            .collect()
+    }
+}
+
+/// Number of points each rayon task evaluates in the parallel batch entry
+/// points.
+#[cfg(feature = "rayon")]
+const PAR_CHUNK_POINTS: usize = 1024;
+
+/// Checks the parts common to all batched evaluations and returns the number
+/// of points.
+fn validate_batch(
+    indices: &[u32],
+    u: &[f32],
+    v: &[f32],
+    control_points: &[f32],
+    src_desc: BufferDescriptor,
+    src_point_count: usize,
+    outputs: &PatchEvalOutputs<'_>,
+) -> crate::Result<usize> {
+    let point_count = indices.len();
+    if i32::try_from(point_count).is_err() {
+        return Err(Error::InvalidBufferSize {
+            expected: i32::MAX as usize,
+            actual: point_count,
+        });
+    }
+    if let Some(len) = [u.len(), v.len()]
+        .into_iter()
+        .find(|&len| len != point_count)
+    {
+        return Err(Error::InvalidBufferSize {
+            expected: point_count,
+            actual: len,
+        });
+    }
+    if !src_desc.is_valid()
+        || !outputs.desc.is_valid()
+        || src_desc.0.length != outputs.desc.0.length
+    {
+        return Err(Error::InvalidBufferDescriptor);
+    }
+    let src_len = src_desc.buffer_len(src_point_count);
+    if control_points.len() < src_len {
+        return Err(Error::InvalidBufferSize {
+            expected: src_len,
+            actual: control_points.len(),
+        });
+    }
+    outputs.validate(point_count)?;
+    Ok(point_count)
+}
+
+impl PatchTable {
+    /// Evaluate many points in one call.
+    ///
+    /// `control_points` holds the refined vertices followed by the local
+    /// points, interleaved as described by `src_desc`, whose `length` must
+    /// match `outputs.desc`. Basis weights live on the stack and nothing is
+    /// allocated per point, so this is the preferred way to sample a surface
+    /// densely.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the slices have mismatched or insufficient
+    /// lengths, the descriptors are invalid, a patch index is out of range or
+    /// a patch has no basis evaluation (legacy Gregory patches).
+    pub fn evaluate_points(
+        &self,
+        points: PatchPoints<'_>,
+        control_points: &[f32],
+        src_desc: BufferDescriptor,
+        mut outputs: PatchEvalOutputs<'_>,
+    ) -> crate::Result<()> {
+        self.validate_patch_points(points, control_points, src_desc, &outputs)?;
+        self.evaluate_points_unchecked(points, control_points, src_desc, &mut outputs)
+    }
+
+    /// Parallel version of [`evaluate_points()`](Self::evaluate_points()).
+    ///
+    /// Splits the batch into chunks that are evaluated on the rayon thread
+    /// pool.
+    ///
+    /// This method is only available when the `rayon` feature is enabled.
+    #[cfg(feature = "rayon")]
+    pub fn evaluate_points_par(
+        &self,
+        points: PatchPoints<'_>,
+        control_points: &[f32],
+        src_desc: BufferDescriptor,
+        outputs: PatchEvalOutputs<'_>,
+    ) -> crate::Result<()> {
+        use rayon::prelude::*;
+
+        let point_count = points.patch_indices.len();
+        self.validate_patch_points(points, control_points, src_desc, &outputs)?;
+        outputs
+            .split(point_count, PAR_CHUNK_POINTS)
+            .into_par_iter()
+            .zip(points.patch_indices.par_chunks(PAR_CHUNK_POINTS))
+            .zip(points.u.par_chunks(PAR_CHUNK_POINTS))
+            .zip(points.v.par_chunks(PAR_CHUNK_POINTS))
+            .try_for_each(|(((mut outputs, patch_indices), u), v)| {
+                self.evaluate_points_unchecked(
+                    PatchPoints {
+                        patch_indices,
+                        u,
+                        v,
+                    },
+                    control_points,
+                    src_desc,
+                    &mut outputs,
+                )
+            })
+    }
+
+    /// Evaluate many points given by ptex face and face coordinates.
+    ///
+    /// Each point is located with `patch_map`, which must have been built
+    /// from this table. Points on faces without patches (holes) are skipped
+    /// and every requested output of theirs is set to NaN.
+    ///
+    /// Returns the number of points evaluated.
+    ///
+    /// # Errors
+    ///
+    /// See [`evaluate_points()`](Self::evaluate_points()).
+    pub fn evaluate_face_points(
+        &self,
+        patch_map: &PatchMap,
+        points: FacePoints<'_>,
+        control_points: &[f32],
+        src_desc: BufferDescriptor,
+        mut outputs: PatchEvalOutputs<'_>,
+    ) -> crate::Result<usize> {
+        self.validate_patch_map(patch_map)?;
+        validate_batch(
+            points.face_indices,
+            points.u,
+            points.v,
+            control_points,
+            src_desc,
+            self.point_count,
+            &outputs,
+        )?;
+        self.evaluate_face_points_unchecked(
+            patch_map,
+            points,
+            control_points,
+            src_desc,
+            &mut outputs,
+        )
+    }
+
+    /// Parallel version of
+    /// [`evaluate_face_points()`](Self::evaluate_face_points()).
+    ///
+    /// This method is only available when the `rayon` feature is enabled.
+    #[cfg(feature = "rayon")]
+    pub fn evaluate_face_points_par(
+        &self,
+        patch_map: &PatchMap,
+        points: FacePoints<'_>,
+        control_points: &[f32],
+        src_desc: BufferDescriptor,
+        outputs: PatchEvalOutputs<'_>,
+    ) -> crate::Result<usize> {
+        use rayon::prelude::*;
+
+        self.validate_patch_map(patch_map)?;
+        let point_count = validate_batch(
+            points.face_indices,
+            points.u,
+            points.v,
+            control_points,
+            src_desc,
+            self.point_count,
+            &outputs,
+        )?;
+        outputs
+            .split(point_count, PAR_CHUNK_POINTS)
+            .into_par_iter()
+            .zip(points.face_indices.par_chunks(PAR_CHUNK_POINTS))
+            .zip(points.u.par_chunks(PAR_CHUNK_POINTS))
+            .zip(points.v.par_chunks(PAR_CHUNK_POINTS))
+            .map(|(((mut outputs, face_indices), u), v)| {
+                self.evaluate_face_points_unchecked(
+                    patch_map,
+                    FacePoints { face_indices, u, v },
+                    control_points,
+                    src_desc,
+                    &mut outputs,
+                )
+            })
+            .try_reduce(|| 0, |a, b| Ok(a + b))
+    }
+
+    fn validate_patch_map(&self, patch_map: &PatchMap) -> crate::Result<()> {
+        match patch_map.is_built_from(self) {
+            true => Ok(()),
+            false => Err(Error::InvalidPatch(
+                "patch map was built from a different patch table".to_string(),
+            )),
+        }
+    }
+
+    fn validate_patch_points(
+        &self,
+        points: PatchPoints<'_>,
+        control_points: &[f32],
+        src_desc: BufferDescriptor,
+        outputs: &PatchEvalOutputs<'_>,
+    ) -> crate::Result<()> {
+        validate_batch(
+            points.patch_indices,
+            points.u,
+            points.v,
+            control_points,
+            src_desc,
+            self.point_count,
+            outputs,
+        )?;
+        let patch_count = self.patch_count();
+        match points
+            .patch_indices
+            .iter()
+            .find(|&&index| index as usize >= patch_count)
+        {
+            Some(&index) => Err(Error::IndexOutOfBounds {
+                index: index as usize,
+                max: patch_count,
+            }),
+            None => Ok(()),
+        }
+    }
+
+    fn evaluate_points_unchecked(
+        &self,
+        points: PatchPoints<'_>,
+        control_points: &[f32],
+        src_desc: BufferDescriptor,
+        outputs: &mut PatchEvalOutputs<'_>,
+    ) -> crate::Result<()> {
+        let desc = outputs.desc;
+        let [p, du, dv, duu, duv, dvv] = outputs.as_mut_ptrs();
+        let evaluated = unsafe {
+            sys::far::PatchTable_EvaluatePoints(
+                self.ptr,
+                points.patch_indices.len() as _,
+                points.patch_indices.as_ptr() as *const _,
+                points.u.as_ptr(),
+                points.v.as_ptr(),
+                control_points.as_ptr(),
+                src_desc.0,
+                p,
+                du,
+                dv,
+                duu,
+                duv,
+                dvv,
+                desc.0,
+            )
+        };
+        match evaluated as usize == points.patch_indices.len() {
+            true => Ok(()),
+            false => Err(Error::InvalidPatch(
+                "patch type has no basis evaluation".to_string(),
+            )),
+        }
+    }
+
+    fn evaluate_face_points_unchecked(
+        &self,
+        patch_map: &PatchMap,
+        points: FacePoints<'_>,
+        control_points: &[f32],
+        src_desc: BufferDescriptor,
+        outputs: &mut PatchEvalOutputs<'_>,
+    ) -> crate::Result<usize> {
+        let desc = outputs.desc;
+        let [p, du, dv, duu, duv, dvv] = outputs.as_mut_ptrs();
+        let evaluated = unsafe {
+            sys::far::PatchTable_EvaluateFacePoints(
+                self.ptr,
+                patch_map.ptr,
+                points.face_indices.len() as _,
+                points.face_indices.as_ptr() as *const _,
+                points.u.as_ptr(),
+                points.v.as_ptr(),
+                control_points.as_ptr(),
+                src_desc.0,
+                p,
+                du,
+                dv,
+                duu,
+                duv,
+                dvv,
+                desc.0,
+            )
+        };
+        usize::try_from(evaluated)
+            .map_err(|_| Error::Ffi("PatchTable_EvaluateFacePoints failed".to_string()))
+    }
+}
+
+/// Map for efficient patch location from face coordinates.
+///
+/// The map does not borrow the [`PatchTable`] it was built from. Lookups
+/// that convert face coordinates into patch-local ones take the table, and
+/// fail if it is not the one the map was built from.
 pub struct PatchMap {
     ptr: *mut sys::far::PatchMap,
+    patch_table_id: u64,
     _phantom: PhantomData<sys::far::PatchMap>,
 }
 
 impl PatchMap {
+    /// Index stored by [`find_patches()`](Self::find_patches()) for queries
+    /// on faces without patches (holes).
+    pub const NOT_FOUND: u32 = u32::MAX;
+
     /// Create a new patch map from a patch table
     pub fn new(patch_table: &PatchTable) -> Option<Self> {
         unsafe {
@@ -641,35 +1354,127 @@ impl PatchMap {
             } else {
                 Some(Self {
                     ptr,
+                    patch_table_id: patch_table.id,
                     _phantom: PhantomData,
                 })
             }
         }
     }
 
-    /// Find the patch containing a given face at parametric coordinates
-    pub fn find_patch(&self, face_index: usize, u: f32, v: f32) -> Option<(usize, f32, f32)> {
-        unsafe {
-            let mut patch_index = 0i32;
-            let mut patch_u = 0.0f32;
-            let mut patch_v = 0.0f32;
+    /// Returns `true` if the map was built from `patch_table`.
+    #[inline]
+    pub fn is_built_from(&self, patch_table: &PatchTable) -> bool {
+        self.patch_table_id == patch_table.id
+    }
 
-            let found = sys::far::PatchMap_FindPatch(
+    /// Find the patch containing face coordinates `(u, v)` of a ptex face.
+    ///
+    /// Returns the table-global patch index and the patch-local (normalized)
+    /// coordinates, or `None` if the face has no patches or `patch_table` is
+    /// not the table the map was built from.
+    ///
+    /// Note that [`PatchTable::evaluate_basis()`] and friends take the face
+    /// coordinates, not the returned local ones.
+    pub fn find_patch(
+        &self,
+        patch_table: &PatchTable,
+        face_index: usize,
+        u: f32,
+        v: f32,
+    ) -> Option<(usize, f32, f32)> {
+        if !self.is_built_from(patch_table) {
+            return None;
+        }
+        let face_index = i32::try_from(face_index).ok()?;
+        let mut patch_index = 0i32;
+        let mut patch_u = 0.0f32;
+        let mut patch_v = 0.0f32;
+
+        let found = unsafe {
+            sys::far::PatchMap_FindPatch(
+                patch_table.as_ptr(),
                 self.ptr,
-                face_index as i32,
+                face_index,
                 u,
                 v,
                 &mut patch_index,
                 &mut patch_u,
                 &mut patch_v,
-            );
+            )
+        };
 
-            if found {
-                Some((patch_index as usize, patch_u, patch_v))
-            } else {
-                None
-            }
+        found.then_some((patch_index as usize, patch_u, patch_v))
+    }
+
+    /// Locate many face queries in one call.
+    ///
+    /// Writes the table-global patch index of each query to `patch_indices`,
+    /// or [`NOT_FOUND`](Self::NOT_FOUND) if its face has no patches. If
+    /// `local_uv` is given, the patch-local coordinates are written there.
+    /// The located indices can be fed straight to
+    /// [`PatchTable::evaluate_points()`] together with the original face
+    /// coordinates.
+    ///
+    /// Returns the number of located queries.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::InvalidPatch`] if `patch_table` is not the table the
+    /// map was built from and [`Error::InvalidBufferSize`] if any output slice
+    /// is shorter than the query slices or the query slices differ in length.
+    pub fn find_patches(
+        &self,
+        patch_table: &PatchTable,
+        points: FacePoints<'_>,
+        patch_indices: &mut [u32],
+        local_uv: Option<(&mut [f32], &mut [f32])>,
+    ) -> crate::Result<usize> {
+        patch_table.validate_patch_map(self)?;
+        let query_count = points.face_indices.len();
+        if i32::try_from(query_count).is_err() {
+            return Err(Error::InvalidBufferSize {
+                expected: i32::MAX as usize,
+                actual: query_count,
+            });
+        }
+
+        if let Some(len) = [points.u.len(), points.v.len()]
+            .into_iter()
+            .find(|&len| len != query_count)
+        {
+            return Err(Error::InvalidBufferSize {
+                expected: query_count,
+                actual: len,
+            });
         }
+        if let Some(len) = std::iter::once(patch_indices.len())
+            .chain(local_uv.iter().flat_map(|(u, v)| [u.len(), v.len()]))
+            .find(|&len| len < query_count)
+        {
+            return Err(Error::InvalidBufferSize {
+                expected: query_count,
+                actual: len,
+            });
+        }
+
+        let (patch_u, patch_v) = local_uv
+            .map_or((std::ptr::null_mut(), std::ptr::null_mut()), |(u, v)| {
+                (u.as_mut_ptr(), v.as_mut_ptr())
+            });
+        let found = unsafe {
+            sys::far::PatchMap_FindPatches(
+                patch_table.as_ptr(),
+                self.ptr,
+                query_count as _,
+                points.face_indices.as_ptr() as *const _,
+                points.u.as_ptr(),
+                points.v.as_ptr(),
+                patch_indices.as_mut_ptr() as *mut _,
+                patch_u,
+                patch_v,
+            )
+        };
+        usize::try_from(found).map_err(|_| Error::Ffi("PatchMap_FindPatches failed".to_string()))
     }
 }
 
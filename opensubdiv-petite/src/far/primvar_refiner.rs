@@ -34,6 +34,39 @@
 use opensubdiv_petite_sys as sys;
 
 use super::TopologyRefiner;
+use crate::osd::BufferDescriptor;
+
+/// How [`PrimvarRefiner::interpolate_interleaved()`] refines primvars.
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Hash)]
+pub enum PrimvarInterpolation {
+    /// Vertex interpolation weights; one primvar per vertex.
+    Vertex,
+    /// Linear interpolation weights; one primvar per vertex.
+    Varying,
+    /// Data copied down from parent faces; one primvar per face.
+    FaceUniform,
+    /// Face-varying interpolation weights of the given channel; one primvar
+    /// per face-varying value.
+    FaceVarying(usize),
+}
+
+impl PrimvarInterpolation {
+    fn as_sys(self) -> i32 {
+        match self {
+            PrimvarInterpolation::Vertex => 0,
+            PrimvarInterpolation::Varying => 1,
+            PrimvarInterpolation::FaceUniform => 2,
+            PrimvarInterpolation::FaceVarying(_) => 3,
+        }
+    }
+
+    fn channel(self) -> usize {
+        match self {
+            PrimvarInterpolation::FaceVarying(channel) => channel,
+            _ => 0,
+        }
+    }
+}
 
 /// Applies refinement operations to generic primvar data.
 pub struct PrimvarRefiner<'a> {
@@ -70,33 +103,22 @@ impl<'a> PrimvarRefiner<'a> {
     /// # Returns
     ///
     /// Returns a flat [`Vec`] of interpolated values or [`None`] if the
-    /// `refinement_level` exceeds the
+    /// `refinement_level` is zero or exceeds the
     /// [`max_level()`](TopologyRefiner::max_level())
-    /// of the [`TopologyRefiner`] fed to [`PrimvarRefiner::new()`].
+    /// of the [`TopologyRefiner`] fed to [`PrimvarRefiner::new()`], or if
+    /// `source` is too short.
     pub fn interpolate(
         &self,
         refinement_level: usize,
         tuple_len: usize,
         source: &[f32],
     ) -> Option<Vec<f32>> {
-        match self.topology_refiner.level(refinement_level) {
-            Some(refiner_level) => {
-                let dest_len = tuple_len * refiner_level.vertex_count();
-                let mut dest = Vec::<f32>::with_capacity(dest_len);
-                unsafe {
-                    sys::far::PrimvarRefiner_Interpolate(
-                        self.ptr,
-                        tuple_len.min(i32::MAX as usize) as i32,
-                        refinement_level.min(i32::MAX as usize) as i32,
-                        source.as_ptr(),
-                        dest.as_mut_ptr(),
-                    );
-                    dest.set_len(dest_len);
-                }
-                Some(dest)
-            }
-            None => None,
-        }
+        self.interpolate_packed(
+            PrimvarInterpolation::Vertex,
+            refinement_level,
+            tuple_len,
+            source,
+        )
     }
 
     /// Apply face-varying interpolation weights to a primvar buffer associated
@@ -116,33 +138,22 @@ impl<'a> PrimvarRefiner<'a> {
     /// # Returns
     ///
     /// Returns a flat [`Vec`] of interpolated values or [`None`] if the
-    /// `refinement_level` exceeds the
+    /// `refinement_level` is zero or exceeds the
     /// [`max_level()`](TopologyRefiner::max_level())
-    /// of the [`TopologyRefiner`] fed to [`PrimvarRefiner::new()`].
+    /// of the [`TopologyRefiner`] fed to [`PrimvarRefiner::new()`], or if
+    /// `source` is too short.
     pub fn interpolate_face_varying(
         &self,
         refinement_level: usize,
         tuple_len: usize,
         source: &[f32],
     ) -> Option<Vec<f32>> {
-        match self.topology_refiner.level(refinement_level) {
-            Some(refiner_level) => {
-                let dest_len = tuple_len * refiner_level.vertex_count();
-                let mut dest = Vec::<f32>::with_capacity(dest_len);
-                unsafe {
-                    sys::far::PrimvarRefiner_InterpolateFaceVarying(
-                        self.ptr,
-                        tuple_len.min(i32::MAX as usize) as i32,
-                        refinement_level.min(i32::MAX as usize) as i32,
-                        source.as_ptr(),
-                        dest.as_mut_ptr(),
-                    );
-                    dest.set_len(dest_len);
-                }
-                Some(dest)
-            }
-            None => None,
-        }
+        self.interpolate_packed(
+            PrimvarInterpolation::FaceVarying(0),
+            refinement_level,
+            tuple_len,
+            source,
+        )
     }
 
     /// Refine uniform (per-face) primvar data between levels.
@@ -161,33 +172,22 @@ impl<'a> PrimvarRefiner<'a> {
     /// # Returns
     ///
     /// Returns a flat [`Vec`] of interpolated values or [`None`] if the
-    /// `refinement_level` exceeds the
+    /// `refinement_level` is zero or exceeds the
     /// [`max_level()`](TopologyRefiner::max_level())
-    /// of the [`TopologyRefiner`] fed to [`PrimvarRefiner::new()`].
+    /// of the [`TopologyRefiner`] fed to [`PrimvarRefiner::new()`], or if
+    /// `source` is too short.
     pub fn interpolate_face_uniform(
         &self,
         refinement_level: usize,
         tuple_len: usize,
         source: &[f32],
     ) -> Option<Vec<f32>> {
-        match self.topology_refiner.level(refinement_level) {
-            Some(refiner_level) => {
-                let dest_len = tuple_len * refiner_level.vertex_count();
-                let mut dest = Vec::<f32>::with_capacity(dest_len);
-                unsafe {
-                    sys::far::PrimvarRefiner_InterpolateFaceUniform(
-                        self.ptr,
-                        tuple_len.min(i32::MAX as usize) as i32,
-                        refinement_level.min(i32::MAX as usize) as i32,
-                        source.as_ptr(),
-                        dest.as_mut_ptr(),
-                    );
-                    dest.set_len(dest_len);
-                }
-                Some(dest)
-            }
-            None => None,
-        }
+        self.interpolate_packed(
+            PrimvarInterpolation::FaceUniform,
+            refinement_level,
+            tuple_len,
+            source,
+        )
     }
 
     /// Apply only varying interpolation weights to a primvar buffer for a
@@ -205,33 +205,296 @@ impl<'a> PrimvarRefiner<'a> {
     /// # Returns
     ///
     /// Returns a flat [`Vec`] of interpolated values or [`None`] if the
-    /// `refinement_level` exceeds the
+    /// `refinement_level` is zero or exceeds the
     /// [`max_level()`](TopologyRefiner::max_level())
-    /// of the [`TopologyRefiner`] fed to [`PrimvarRefiner::new()`].
+    /// of the [`TopologyRefiner`] fed to [`PrimvarRefiner::new()`], or if
+    /// `source` is too short.
     pub fn interpolate_varying(
         &self,
         refinement_level: usize,
         tuple_len: usize,
         source: &[f32],
     ) -> Option<Vec<f32>> {
-        match self.topology_refiner.level(refinement_level) {
-            Some(refiner_level) => {
-                let dest_len = tuple_len * refiner_level.vertex_count();
-                let mut dest = Vec::<f32>::with_capacity(dest_len);
-                unsafe {
-                    sys::far::PrimvarRefiner_InterpolateVarying(
-                        self.ptr,
-                        tuple_len.min(i32::MAX as usize) as i32,
-                        refinement_level.min(i32::MAX as usize) as i32,
-                        source.as_ptr(),
-                        dest.as_mut_ptr(),
-                    );
-                    dest.set_len(dest_len);
-                }
-                Some(dest)
+        self.interpolate_packed(
+            PrimvarInterpolation::Varying,
+            refinement_level,
+            tuple_len,
+            source,
+        )
+    }
+
+    /// Refine interleaved primvars from `refinement_level - 1` to
+    /// `refinement_level` in place.
+    ///
+    /// Reads `src_desc.length` elements per source primvar from `src` and
+    /// writes the same number per refined primvar into `dst`, honoring both
+    /// descriptors' offsets and strides. Positions, normals, colors and
+    /// custom data packed into one buffer are thus refined in a single call
+    /// without de-interleaving. `src` and `dst` hold one primvar per vertex,
+    /// face or face-varying value of their level, depending on
+    /// `interpolation`.
+    ///
+    /// Widths of 1--4, 8, 12 and 16 elements use fixed-width kernels; any
+    /// other width uses a generic one. Nothing is allocated.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the descriptors are invalid or differ in length,
+    /// if `refinement_level` is zero or exceeds the refiner's
+    /// [`max_level()`](TopologyRefiner::max_level()), if the face-varying
+    /// channel does not exist or if either slice is too short for the
+    /// descriptor it is paired with.
+    pub fn interpolate_interleaved(
+        &self,
+        interpolation: PrimvarInterpolation,
+        refinement_level: usize,
+        src: &[f32],
+        src_desc: BufferDescriptor,
+        dst: &mut [f32],
+        dst_desc: BufferDescriptor,
+    ) -> crate::Result<()> {
+        if !src_desc.is_valid() || !dst_desc.is_valid() || src_desc.0.length != dst_desc.0.length {
+            return Err(crate::Error::InvalidBufferDescriptor);
+        }
+        let max_level = self.topology_refiner.max_level();
+        if refinement_level == 0 || refinement_level > max_level {
+            return Err(crate::Error::IndexOutOfBounds {
+                index: refinement_level,
+                max: max_level,
+            });
+        }
+
+        let src_len = src_desc.buffer_len(self.primvar_count(interpolation, refinement_level - 1)?);
+        if src.len() < src_len {
+            return Err(crate::Error::InvalidBufferSize {
+                expected: src_len,
+                actual: src.len(),
+            });
+        }
+        let dst_len = dst_desc.buffer_len(self.primvar_count(interpolation, refinement_level)?);
+        if dst.len() < dst_len {
+            return Err(crate::Error::InvalidBufferSize {
+                expected: dst_len,
+                actual: dst.len(),
+            });
+        }
+
+        let ok = unsafe {
+            sys::far::PrimvarRefiner_InterpolateWithDescriptors(
+                self.ptr,
+                interpolation.as_sys(),
+                refinement_level as i32,
+                interpolation.channel() as i32,
+                src.as_ptr(),
+                src_desc.0,
+                dst.as_mut_ptr(),
+                dst_desc.0,
+            )
+        };
+        ok.then_some(()).ok_or_else(|| {
+            crate::Error::Ffi("PrimvarRefiner_InterpolateWithDescriptors() failed".to_string())
+        })
+    }
+
+    /// Returns where each level's primvars start in a buffer holding levels
+    /// `0..=max_level()` back to back, as used by
+    /// [`interpolate_levels()`](Self::interpolate_levels()).
+    ///
+    /// Offsets count primvars, not floats; the last of the
+    /// [`max_level()`](TopologyRefiner::max_level())` + 2` entries is the
+    /// total number of primvars. For vertex interpolation this matches
+    /// [`vertex_count_all_levels()`](TopologyRefiner::vertex_count_all_levels()).
+    pub fn level_offsets(&self, interpolation: PrimvarInterpolation) -> crate::Result<Vec<usize>> {
+        let mut offset = 0;
+        let mut offsets = vec![0];
+        for level in 0..=self.topology_refiner.max_level() {
+            offset += self.primvar_count(interpolation, level)?;
+            offsets.push(offset);
+        }
+        Ok(offsets)
+    }
+
+    /// Refine primvars through all levels in a single call.
+    ///
+    /// `buffer` holds the primvars of every level back to back, starting at
+    /// the [`level_offsets()`](Self::level_offsets()), with each primvar
+    /// addressed through `desc`. Fill in the base level and every other
+    /// level is refined from the one before it in place, without any
+    /// allocation.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `desc` is invalid, if the face-varying channel does
+    /// not exist or if `buffer` is too short for all levels.
+    pub fn interpolate_levels(
+        &self,
+        interpolation: PrimvarInterpolation,
+        buffer: &mut [f32],
+        desc: BufferDescriptor,
+    ) -> crate::Result<()> {
+        if !desc.is_valid() {
+            return Err(crate::Error::InvalidBufferDescriptor);
+        }
+        let total = *self.level_offsets(interpolation)?.last().unwrap();
+        let len = desc.buffer_len(total);
+        if buffer.len() < len {
+            return Err(crate::Error::InvalidBufferSize {
+                expected: len,
+                actual: buffer.len(),
+            });
+        }
+
+        let ok = unsafe {
+            sys::far::PrimvarRefiner_InterpolateLevels(
+                self.ptr,
+                interpolation.as_sys(),
+                interpolation.channel() as i32,
+                self.topology_refiner.max_level() as i32,
+                buffer.as_mut_ptr(),
+                desc.0,
+            )
+        };
+        ok.then_some(()).ok_or_else(|| {
+            crate::Error::Ffi("PrimvarRefiner_InterpolateLevels() failed".to_string())
+        })
+    }
+
+    /// Refine base level primvars straight to `refinement_level`.
+    ///
+    /// Only the finest level ends up in `dst`. Intermediate levels alternate
+    /// between `dst` and `scratch` and are dropped as soon as the next one is
+    /// computed, so peak memory is that of the last two levels rather than
+    /// of all of them. `dst` must hold level `refinement_level` as laid out
+    /// by `dst_desc`. `scratch` is grown as needed, usually to hold level
+    /// `refinement_level - 1`; reuse it across calls to avoid allocating.
+    ///
+    /// # Errors
+    ///
+    /// Returns the same errors as
+    /// [`interpolate_interleaved()`](Self::interpolate_interleaved()).
+    #[allow(clippy::too_many_arguments)]
+    pub fn interpolate_to_level(
+        &self,
+        interpolation: PrimvarInterpolation,
+        refinement_level: usize,
+        src: &[f32],
+        src_desc: BufferDescriptor,
+        scratch: &mut Vec<f32>,
+        dst: &mut [f32],
+        dst_desc: BufferDescriptor,
+    ) -> crate::Result<()> {
+        if !src_desc.is_valid() || !dst_desc.is_valid() || src_desc.0.length != dst_desc.0.length {
+            return Err(crate::Error::InvalidBufferDescriptor);
+        }
+        let max_level = self.topology_refiner.max_level();
+        if refinement_level == 0 || refinement_level > max_level {
+            return Err(crate::Error::IndexOutOfBounds {
+                index: refinement_level,
+                max: max_level,
+            });
+        }
+
+        let src_len = src_desc.buffer_len(self.primvar_count(interpolation, 0)?);
+        if src.len() < src_len {
+            return Err(crate::Error::InvalidBufferSize {
+                expected: src_len,
+                actual: src.len(),
+            });
+        }
+        // Levels `refinement_level`, `refinement_level - 2`, ... are written
+        // to `dst`, the others to `scratch`. Adaptively refined levels can
+        // shrink, so each buffer must hold the largest of its levels.
+        let (mut dst_len, mut scratch_len) = (0, 0);
+        for level in 1..=refinement_level {
+            let len = dst_desc.buffer_len(self.primvar_count(interpolation, level)?);
+            match (refinement_level - level) % 2 {
+                0 => dst_len = dst_len.max(len),
+                _ => scratch_len = scratch_len.max(len),
             }
-            None => None,
         }
+        if dst.len() < dst_len {
+            return Err(crate::Error::InvalidBufferSize {
+                expected: dst_len,
+                actual: dst.len(),
+            });
+        }
+        if scratch.len() < scratch_len {
+            scratch.resize(scratch_len, 0.0);
+        }
+
+        let ok = unsafe {
+            sys::far::PrimvarRefiner_InterpolateToLevel(
+                self.ptr,
+                interpolation.as_sys(),
+                interpolation.channel() as i32,
+                refinement_level as i32,
+                src.as_ptr(),
+                src_desc.0,
+                scratch.as_mut_ptr(),
+                dst.as_mut_ptr(),
+                dst_desc.0,
+            )
+        };
+        ok.then_some(()).ok_or_else(|| {
+            crate::Error::Ffi("PrimvarRefiner_InterpolateToLevel() failed".to_string())
+        })
+    }
+
+    /// Number of primvars `interpolation` reads or writes at `level`.
+    fn primvar_count(
+        &self,
+        interpolation: PrimvarInterpolation,
+        level: usize,
+    ) -> crate::Result<usize> {
+        let max_level = self.topology_refiner.max_level();
+        let topology_level =
+            self.topology_refiner
+                .level(level)
+                .ok_or(crate::Error::IndexOutOfBounds {
+                    index: level,
+                    max: max_level,
+                })?;
+
+        Ok(match interpolation {
+            PrimvarInterpolation::Vertex | PrimvarInterpolation::Varying => {
+                topology_level.vertex_count()
+            }
+            PrimvarInterpolation::FaceUniform => topology_level.face_count(),
+            PrimvarInterpolation::FaceVarying(channel) => {
+                let channel_count = topology_level.face_varying_channel_count();
+                if channel >= channel_count {
+                    return Err(crate::Error::IndexOutOfBounds {
+                        index: channel,
+                        max: channel_count,
+                    });
+                }
+                topology_level.face_varying_value_count(channel)
+            }
+        })
+    }
+
+    /// Refines densely packed primvars of `tuple_len` elements into a new
+    /// buffer.
+    fn interpolate_packed(
+        &self,
+        interpolation: PrimvarInterpolation,
+        refinement_level: usize,
+        tuple_len: usize,
+        source: &[f32],
+    ) -> Option<Vec<f32>> {
+        let desc = BufferDescriptor::new(0, tuple_len, tuple_len).ok()?;
+        let dest_len = desc.buffer_len(self.primvar_count(interpolation, refinement_level).ok()?);
+        let mut dest = vec![0.0; dest_len];
+        self.interpolate_interleaved(
+            interpolation,
+            refinement_level,
+            source,
+            desc,
+            &mut dest,
+            desc,
+        )
+        .ok()?;
+        Some(dest)
     }
 }
 
@@ -0,0 +1,476 @@
+//! Reordering of stencil tables for memory locality.
+//!
+//! The factories emit stencils in refinement order and their control indices
+//! jump across the source buffer. Renumbering the control vertices with a
+//! bandwidth-reducing order, such as [`reverse_cuthill_mckee_order()`] or
+//! [`morton_order()`], and sorting the stencils by the control vertices they
+//! read makes consecutive stencils read neighbouring source primvars. That
+//! keeps CPU caches warm and GPU reads coalesced.
+//!
+//! The reordered table evaluates into a permuted layout; the returned
+//! [`StencilPermutation`] maps between it and the original one.
+use opensubdiv_petite_sys as sys;
+
+use crate::far::{LimitStencilTable, StencilTable, TopologyLevel};
+use crate::{Error, Index, Result};
+
+/// Order of the stencils of a reordered table.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub enum StencilOrder {
+    /// Keep the stencils, and hence the destination layout, unchanged.
+    #[default]
+    Original,
+    /// Sort the stencils by the lowest control vertex they read, so
+    /// neighbouring destination primvars read neighbouring source primvars.
+    BySource,
+}
+
+/// Maps between a stencil table and its reordered copy.
+#[derive(Clone, Debug, PartialEq, Eq)]
+pub struct StencilPermutation {
+    control_vertices: Vec<Index>,
+    stencils: Vec<Index>,
+}
+
+impl StencilPermutation {
+    /// Returns the new index of each original control vertex.
+    #[inline]
+    pub fn control_vertices(&self) -> &[Index] {
+        &self.control_vertices
+    }
+
+    /// Returns the original stencil of each stencil of the reordered table.
+    #[inline]
+    pub fn stencils(&self) -> &[Index] {
+        &self.stencils
+    }
+
+    /// Returns the new index of each original stencil, e.g. to remap an
+    /// index buffer referencing the refined vertices.
+    pub fn stencil_positions(&self) -> Vec<Index> {
+        let mut positions = vec![Index(0); self.stencils.len()];
+        for (new, old) in self.stencils.iter().enumerate() {
+            positions[old.0 as usize] = Index::from(new);
+        }
+        positions
+    }
+
+    /// Reorder control vertex values of `width` elements each into the
+    /// layout the reordered table reads.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::InvalidBufferSize`] if `values` does not hold a value
+    /// for each control vertex.
+    pub fn permute_control_values(&self, values: &[f32], width: usize) -> Result<Vec<f32>> {
+        check_values_len(values, self.control_vertices.len(), width)?;
+        let mut permuted = vec![0.0; values.len()];
+        for (old, new) in self.control_vertices.iter().enumerate() {
+            let new = new.0 as usize;
+            permuted[new * width..(new + 1) * width]
+                .copy_from_slice(&values[old * width..(old + 1) * width]);
+        }
+        Ok(permuted)
+    }
+
+    /// Restore values of `width` elements each, evaluated with the reordered
+    /// table, to the stencil order of the original table.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::InvalidBufferSize`] if `values` does not hold a value
+    /// for each stencil.
+    pub fn restore_stencil_values(&self, values: &[f32], width: usize) -> Result<Vec<f32>> {
+        check_values_len(values, self.stencils.len(), width)?;
+        let mut restored = vec![0.0; values.len()];
+        for (new, old) in self.stencils.iter().enumerate() {
+            let old = old.0 as usize;
+            restored[old * width..(old + 1) * width]
+                .copy_from_slice(&values[new * width..(new + 1) * width]);
+        }
+        Ok(restored)
+    }
+}
+
+fn check_values_len(values: &[f32], count: usize, width: usize) -> Result<()> {
+    match values.len() == count * width {
+        true => Ok(()),
+        false => Err(Error::InvalidBufferSize {
+            expected: count * width,
+            actual: values.len(),
+        }),
+    }
+}
+
+/// Returns a reverse Cuthill--McKee order of the vertices of `level`: the new
+/// index of each vertex.
+///
+/// The order keeps the vertices of each edge close, which bounds how far
+/// apart the control vertices of one stencil are.
+pub fn reverse_cuthill_mckee_order(level: &TopologyLevel<'_>) -> Vec<Index> {
+    let vertex_count = level.vertex_count();
+    let neighbors = move |vertex: usize| {
+        let vertex = Index::from(vertex);
+        level
+            .vertex_edges(vertex)
+            .unwrap_or(&[])
+            .iter()
+            .filter_map(move |&edge| {
+                let ends = level.edge_vertices(edge)?;
+                Some(if ends[0] == vertex { ends[1] } else { ends[0] })
+            })
+    };
+    let degree = move |vertex: usize| {
+        level
+            .vertex_edges(Index::from(vertex))
+            .map_or(0, <[_]>::len)
+    };
+
+    // Components are started from their lowest degree vertex, a cheap
+    // stand-in for a pseudo-peripheral one.
+    let mut seeds: Vec<usize> = (0..vertex_count).collect();
+    seeds.sort_by_key(|&vertex| degree(vertex));
+
+    let mut visited = vec![false; vertex_count];
+    let mut order = Vec::with_capacity(vertex_count);
+    let mut candidates = Vec::new();
+    for seed in seeds {
+        if visited[seed] {
+            continue;
+        }
+        visited[seed] = true;
+        let mut head = order.len();
+        order.push(seed);
+        while head < order.len() {
+            candidates.clear();
+            candidates.extend(
+                neighbors(order[head])
+                    .map(|vertex| vertex.0 as usize)
+                    .filter(|&vertex| !visited[vertex]),
+            );
+            candidates.sort_by_key(|&vertex| degree(vertex));
+            for &vertex in &candidates {
+                if !visited[vertex] {
+                    visited[vertex] = true;
+                    order.push(vertex);
+                }
+            }
+            head += 1;
+        }
+    }
+
+    positions_of(order.into_iter().rev())
+}
+
+/// Returns the Morton (Z-curve) order of points: the new index of each point.
+///
+/// `positions` holds the points with `stride` elements each, of which the
+/// first three (or fewer, if `stride` is smaller) are the coordinates.
+///
+/// # Panics
+///
+/// Panics if `stride` is zero.
+pub fn morton_order(positions: &[f32], stride: usize) -> Vec<Index> {
+    assert!(stride > 0, "stride must not be zero");
+    let dimensions = stride.min(3);
+    let points: Vec<&[f32]> = positions
+        .chunks_exact(stride)
+        .map(|point| &point[..dimensions])
+        .collect();
+
+    let mut min = [f32::MAX; 3];
+    let mut max = [f32::MIN; 3];
+    for point in &points {
+        for (axis, &value) in point.iter().enumerate() {
+            min[axis] = min[axis].min(value);
+            max[axis] = max[axis].max(value);
+        }
+    }
+
+    // 21 bits per axis interleave into a 63 bit code.
+    const CELLS: f32 = ((1u32 << 21) - 1) as f32;
+    let code = |point: &[f32]| {
+        let mut code = 0u64;
+        for (axis, &value) in point.iter().enumerate() {
+            let extent = max[axis] - min[axis];
+            let cell = match extent > 0.0 {
+                true => ((value - min[axis]) / extent * CELLS) as u64,
+                false => 0,
+            };
+            code |= spread_bits(cell) << axis;
+        }
+        code
+    };
+
+    let mut order: Vec<usize> = (0..points.len()).collect();
+    order.sort_by_cached_key(|&point| code(points[point]));
+    positions_of(order.into_iter())
+}
+
+/// Spreads the low 21 bits of `value` so two zero bits follow each.
+fn spread_bits(value: u64) -> u64 {
+    let mut x = value & 0x1f_ffff;
+    x = (x | x << 32) & 0x001f_0000_0000_ffff;
+    x = (x | x << 16) & 0x001f_0000_ff00_00ff;
+    x = (x | x << 8) & 0x100f_00f0_0f00_f00f;
+    x = (x | x << 4) & 0x10c3_0c30_c30c_30c3;
+    x = (x | x << 2) & 0x1249_2492_4924_9249;
+    x
+}
+
+/// Inverts a sequence of old indices into the new index of each.
+fn positions_of(order: impl ExactSizeIterator<Item = usize>) -> Vec<Index> {
+    let mut positions = vec![Index(0); order.len()];
+    for (new, old) in order.enumerate() {
+        positions[old] = Index::from(new);
+    }
+    positions
+}
+
+/// Reordered stencil arrays, ready for `*_CreateFromArrays()`.
+struct ReorderedArrays {
+    sizes: Vec<i32>,
+    indices: Vec<Index>,
+    /// Base weights followed by any derivative weights, in input order.
+    weights: Vec<Vec<f32>>,
+    permutation: StencilPermutation,
+}
+
+// AIDEV-NOTE: The stencils are rebuilt rather than permuted in place: every
+// stencil gets its control indices renumbered and sorted, so its weights
+// have to be gathered in the same order anyway. Offsets are recomputed by
+// the shims, which also works for tables created without them.
+fn reorder_arrays(
+    sizes: &[u32],
+    indices: &[Index],
+    weights: &[&[f32]],
+    control_vertex_count: usize,
+    control_vertex_order: &[Index],
+    stencil_order: StencilOrder,
+) -> Result<ReorderedArrays> {
+    let vertex_count = control_vertex_order.len();
+    if vertex_count < control_vertex_count {
+        return Err(Error::InvalidBufferSize {
+            expected: control_vertex_count,
+            actual: vertex_count,
+        });
+    }
+    let mut seen = vec![false; vertex_count];
+    for &new in control_vertex_order {
+        let new = new.0 as usize;
+        if new >= vertex_count {
+            return Err(Error::IndexOutOfBounds {
+                index: new,
+                max: vertex_count,
+            });
+        }
+        if std::mem::replace(&mut seen[new], true) {
+            return Err(Error::InvalidPermutation(format!(
+                "control vertex index {new} is assigned twice"
+            )));
+        }
+    }
+    if let Some(w) = weights.iter().find(|w| w.len() != indices.len()) {
+        return Err(Error::InvalidBufferSize {
+            expected: indices.len(),
+            actual: w.len(),
+        });
+    }
+    if let Some(index) = indices
+        .iter()
+        .find(|index| index.0 as usize >= vertex_count)
+    {
+        return Err(Error::IndexOutOfBounds {
+            index: index.0 as usize,
+            max: vertex_count,
+        });
+    }
+
+    let mut offsets = Vec::with_capacity(sizes.len());
+    let mut offset = 0;
+    for &size in sizes {
+        offsets.push(offset);
+        offset += size as usize;
+    }
+    if offset != indices.len() {
+        return Err(Error::InvalidBufferSize {
+            expected: offset,
+            actual: indices.len(),
+        });
+    }
+    let renumbered: Vec<Index> = indices
+        .iter()
+        .map(|index| control_vertex_order[index.0 as usize])
+        .collect();
+
+    let mut stencils: Vec<usize> = (0..sizes.len()).collect();
+    if stencil_order == StencilOrder::BySource {
+        stencils.sort_by_key(|&stencil| {
+            let taps = offsets[stencil]..offsets[stencil] + sizes[stencil] as usize;
+            renumbered[taps]
+                .iter()
+                .min()
+                .copied()
+                .unwrap_or(Index(u32::MAX))
+        });
+    }
+
+    let mut arrays = ReorderedArrays {
+        sizes: Vec::with_capacity(sizes.len()),
+        indices: Vec::with_capacity(indices.len()),
+        weights: weights
+            .iter()
+            .map(|w| Vec::with_capacity(w.len()))
+            .collect(),
+        permutation: StencilPermutation {
+            control_vertices: control_vertex_order.to_vec(),
+            stencils: stencils
+                .iter()
+                .map(|&stencil| Index::from(stencil))
+                .collect(),
+        },
+    };
+    let mut taps = Vec::new();
+    for &stencil in &stencils {
+        taps.clear();
+        taps.extend(offsets[stencil]..offsets[stencil] + sizes[stencil] as usize);
+        taps.sort_by_key(|&tap| renumbered[tap]);
+
+        arrays.sizes.push(sizes[stencil] as i32);
+        arrays
+            .indices
+            .extend(taps.iter().map(|&tap| renumbered[tap]));
+        for (reordered, original) in arrays.weights.iter_mut().zip(weights) {
+            reordered.extend(taps.iter().map(|&tap| original[tap]));
+        }
+    }
+
+    Ok(arrays)
+}
+
+impl StencilTable {
+    /// Create a copy of the table that reads control vertices in
+    /// `control_vertex_order`, e.g. one returned by
+    /// [`reverse_cuthill_mckee_order()`] or [`morton_order()`].
+    ///
+    /// `control_vertex_order` holds the new index of each control vertex.
+    /// The stencils of the copy read their control vertices in ascending
+    /// order and, with [`StencilOrder::BySource`], are sorted by them.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `control_vertex_order` is not a permutation of the
+    /// control vertices of the table.
+    pub fn reordered(
+        &self,
+        control_vertex_order: &[Index],
+        stencil_order: StencilOrder,
+    ) -> Result<(StencilTable, StencilPermutation)> {
+        let arrays = reorder_arrays(
+            self.sizes(),
+            self.control_indices(),
+            &[self.weights()],
+            self.control_vertex_count(),
+            control_vertex_order,
+            stencil_order,
+        )?;
+        let (vertex_count, stencil_count) = table_counts(&arrays)?;
+
+        let ptr = unsafe {
+            sys::far::stencil_table::StencilTable_CreateFromArrays(
+                vertex_count,
+                stencil_count,
+                arrays.sizes.as_ptr(),
+                arrays.indices.as_ptr() as *const sys::vtr::Index,
+                arrays.weights[0].as_ptr(),
+            )
+        };
+        if ptr.is_null() {
+            return Err(Error::StencilTableCreation);
+        }
+        Ok((StencilTable(ptr), arrays.permutation))
+    }
+}
+
+impl LimitStencilTable {
+    /// Create a copy of the table that reads control vertices in
+    /// `control_vertex_order`.
+    ///
+    /// See [`StencilTable::reordered()`]. Derivative weights are reordered
+    /// along with the base weights.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `control_vertex_order` is not a permutation of the
+    /// control vertices of the table.
+    pub fn reordered(
+        &self,
+        control_vertex_order: &[Index],
+        stencil_order: StencilOrder,
+    ) -> Result<(LimitStencilTable, StencilPermutation)> {
+        let has_1st = self.has_1st_derivatives();
+        let has_2nd = has_1st && self.has_2nd_derivatives();
+        let mut weights = vec![self.weights()];
+        if has_1st {
+            weights.extend([self.du_weights(), self.dv_weights()]);
+        }
+        if has_2nd {
+            weights.extend([self.duu_weights(), self.duv_weights(), self.dvv_weights()]);
+        }
+
+        let arrays = reorder_arrays(
+            self.sizes(),
+            self.control_indices(),
+            &weights,
+            self.control_vertex_count(),
+            control_vertex_order,
+            stencil_order,
+        )?;
+        let (vertex_count, stencil_count) = table_counts(&arrays)?;
+
+        // Derivatives that were not generated are passed as null.
+        let derivative = |slot: usize| {
+            arrays
+                .weights
+                .get(slot)
+                .map_or(std::ptr::null(), |w| w.as_ptr())
+        };
+
+        let ptr = unsafe {
+            sys::far::limit_stencil_table::LimitStencilTable_CreateFromArrays(
+                vertex_count,
+                stencil_count,
+                arrays.sizes.as_ptr(),
+                arrays.indices.as_ptr() as *const sys::vtr::Index,
+                arrays.weights[0].as_ptr(),
+                derivative(1),
+                derivative(2),
+                derivative(3),
+                derivative(4),
+                derivative(5),
+            )
+        };
+        if ptr.is_null() {
+            return Err(Error::StencilTableCreation);
+        }
+        Ok((
+            LimitStencilTable::from_raw(ptr, has_1st, has_2nd),
+            arrays.permutation,
+        ))
+    }
+}
+
+/// Returns the control vertex and stencil counts of reordered arrays as the
+/// shims take them.
+fn table_counts(arrays: &ReorderedArrays) -> Result<(i32, i32)> {
+    let to_i32 = |count: usize| {
+        i32::try_from(count).map_err(|_| Error::InvalidBufferSize {
+            expected: i32::MAX as usize,
+            actual: count,
+        })
+    };
+    Ok((
+        to_i32(arrays.permutation.control_vertices.len())?,
+        to_i32(arrays.sizes.len())?,
+    ))
+}
@@ -14,6 +14,8 @@ use opensubdiv_petite_sys as sys;
 use crate::Index;
 
 use crate::far::TopologyRefiner;
+use crate::instrument::{self, MemoryFootprint, Stage};
+use crate::osd::BufferDescriptor;
 
 /// Gives read access to a single stencil in a [`StencilTable`].
 pub struct Stencil<'a> {
@@ -37,6 +39,7 @@ impl<'a> Stencil<'a> {
 pub struct StencilTable(pub(crate) sys::far::StencilTablePtr);
 
 /// Borrowed reference to a stencil table.
+#[derive(Clone, Copy)]
 pub struct StencilTableRef<'a> {
     pub(crate) ptr: sys::far::StencilTablePtr,
     pub(crate) _marker: std::marker::PhantomData<&'a ()>,
@@ -66,16 +69,112 @@ impl StencilTable {
         sys_options.set_max_level(options.max_level.min(u32::MAX as usize) as u32);
         sys_options.fvar_channel = options.face_varying_channel.min(u32::MAX as usize) as u32;
 
-        let ptr =
-            unsafe { sys::far::stencil_table::StencilTableFactory_Create(refiner.0, sys_options) };
+        let ptr = instrument::stage(Stage::StencilTableFactory, 0, || unsafe {
+            sys::far::stencil_table::StencilTableFactory_Create(refiner.0, sys_options)
+        });
 
         if ptr.is_null() {
             return Err(crate::Error::StencilTableCreation);
         }
 
+        let table = StencilTable(ptr);
+        instrument::table(Stage::StencilTableFactory, || table.memory_footprint());
+        Ok(table)
+    }
+
+    /// Concatenate `tables` into a new table.
+    ///
+    /// Stencil `i` of the `n`th table becomes stencil `i` plus the combined
+    /// length of the tables before it, so e.g. refined vertex and local point
+    /// stencils can be applied in a single pass.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `tables` is empty or the tables do not all index
+    /// the same number of control vertices.
+    pub fn concatenate(tables: &[StencilTableRef<'_>]) -> crate::Result<StencilTable> {
+        let control_vertex_count = tables
+            .first()
+            .ok_or(crate::Error::StencilTableCreation)?
+            .control_vertex_count();
+        if tables
+            .iter()
+            .any(|table| table.control_vertex_count() != control_vertex_count)
+        {
+            return Err(crate::Error::StencilTableCreation);
+        }
+        let table_count =
+            i32::try_from(tables.len()).map_err(|_| crate::Error::StencilTableCreation)?;
+
+        // `StencilTableRef` is a pointer plus a marker, so the pointers are
+        // gathered into their own array for the shim.
+        let ptrs: Vec<sys::far::StencilTablePtr> = tables.iter().map(|table| table.ptr).collect();
+        let ptr = unsafe {
+            sys::far::stencil_table::StencilTableFactory_CreateConcatenated(
+                table_count,
+                ptrs.as_ptr(),
+            )
+        };
+        if ptr.is_null() {
+            return Err(crate::Error::StencilTableCreation);
+        }
+        Ok(StencilTable(ptr))
+    }
+
+    /// Append a patch table's
+    /// [`local_point_stencil_table()`](crate::far::PatchTable::local_point_stencil_table())
+    /// to this table.
+    ///
+    /// This table must hold the stencils of all refined vertices of
+    /// `refiner`, with or without the base level, i.e. be created with
+    /// [`generate_intermediate_levels`](StencilTableOptions::generate_intermediate_levels).
+    /// With `factorize`, the local point stencils are rewritten in terms of
+    /// the base control vertices: applying the result to those then yields
+    /// every refined vertex and local point -- all patch control vertices --
+    /// in one pass.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `local_points` is empty or this table was not
+    /// created for `refiner` with intermediate levels.
+    pub fn append_local_points(
+        &self,
+        refiner: &TopologyRefiner,
+        local_points: StencilTableRef<'_>,
+        factorize: bool,
+    ) -> crate::Result<StencilTable> {
+        let refined_count = refiner.vertex_count_all_levels();
+        let base_count = refiner.level(0).map_or(0, |level| level.vertex_count());
+        if local_points.is_empty()
+            || (self.len() != refined_count && self.len() != refined_count - base_count)
+        {
+            return Err(crate::Error::StencilTableCreation);
+        }
+
+        let ptr = unsafe {
+            sys::far::stencil_table::StencilTableFactory_AppendLocalPointStencilTable(
+                refiner.0,
+                self.0,
+                local_points.ptr,
+                factorize,
+            )
+        };
+        if ptr.is_null() {
+            return Err(crate::Error::StencilTableCreation);
+        }
         Ok(StencilTable(ptr))
     }
 
+    /// Returns a borrowed reference to the table, e.g. to
+    /// [`concatenate()`](Self::concatenate()) it with others.
+    #[inline]
+    pub fn as_table_ref(&self) -> StencilTableRef<'_> {
+        StencilTableRef {
+            ptr: self.0,
+            _marker: std::marker::PhantomData,
+        }
+    }
+
     /// Returns the number of stencils in the table.
     #[inline]
     pub fn len(&self) -> usize {
@@ -158,6 +257,12 @@ impl StencilTable {
         }
     }
 
+    /// Returns the bytes held by the arrays of the table.
+    #[inline]
+    pub fn memory_footprint(&self) -> MemoryFootprint {
+        self.as_table_ref().memory_footprint()
+    }
+
     /// Update values by applying the stencil table.
     ///
     /// # Arguments
@@ -209,6 +314,142 @@ impl StencilTable {
 
         dst
     }
+
+    /// Update interleaved values in place by applying the stencil table.
+    ///
+    /// Reads `src_desc.length` elements per control vertex from `src` and
+    /// writes the same number of elements per stencil into `dst`. Both
+    /// descriptors' offsets and strides are honored, so e.g. positions and
+    /// normals packed into one buffer can be updated in a single call without
+    /// de-interleaving. Destination point `i` receives stencil `start + i`.
+    ///
+    /// Widths of 1--4 elements use fixed-width kernels. Nothing is allocated.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the descriptors are invalid or differ in length,
+    /// if `[start, end)` is not a valid stencil range or if either slice is
+    /// too short for the descriptor it is paired with.
+    pub fn update_values_interleaved(
+        &self,
+        src: &[f32],
+        src_desc: BufferDescriptor,
+        dst: &mut [f32],
+        dst_desc: BufferDescriptor,
+        start: Option<usize>,
+        end: Option<usize>,
+    ) -> crate::Result<()> {
+        update_values_interleaved_impl(self.0, src, src_desc, dst, dst_desc, start, end)
+    }
+}
+
+/// Returns the offset of `stencil` into the control index/weight arrays.
+///
+/// Falls back to summing the preceding sizes if the factory did not generate
+/// offsets.
+fn stencil_offset(ptr: sys::far::StencilTablePtr, stencil: usize) -> usize {
+    unsafe {
+        let sizes = sys::far::stencil_table::StencilTable_GetSizes(ptr);
+        let sizes = std::slice::from_raw_parts(sizes.data(), sizes.size());
+        let offsets = sys::far::stencil_table::StencilTable_GetOffsets(ptr);
+        let offsets = std::slice::from_raw_parts(offsets.data(), offsets.size());
+
+        offsets
+            .get(stencil)
+            .map(|&offset| offset as usize)
+            .unwrap_or_else(|| sizes[..stencil].iter().map(|&size| size as usize).sum())
+    }
+}
+
+fn update_values_interleaved_impl(
+    ptr: sys::far::StencilTablePtr,
+    src: &[f32],
+    src_desc: BufferDescriptor,
+    dst: &mut [f32],
+    dst_desc: BufferDescriptor,
+    start: Option<usize>,
+    end: Option<usize>,
+) -> crate::Result<()> {
+    if !src_desc.is_valid() || !dst_desc.is_valid() || src_desc.0.length != dst_desc.0.length {
+        return Err(crate::Error::InvalidBufferDescriptor);
+    }
+
+    let stencil_count =
+        unsafe { sys::far::stencil_table::StencilTable_GetNumStencils(ptr) as usize };
+    let start = start.unwrap_or(0);
+    let end = end.unwrap_or(stencil_count);
+    if end > stencil_count {
+        return Err(crate::Error::IndexOutOfBounds {
+            index: end,
+            max: stencil_count,
+        });
+    }
+    if start > end {
+        return Err(crate::Error::IndexOutOfBounds {
+            index: start,
+            max: end,
+        });
+    }
+
+    let dst_len = dst_desc.buffer_len(end - start);
+    if dst.len() < dst_len {
+        return Err(crate::Error::InvalidBufferSize {
+            expected: dst_len,
+            actual: dst.len(),
+        });
+    }
+
+    // AIDEV-NOTE: Local point stencil tables report 0 control vertices.
+    // Only then do we derive the source size from the indices, and only from
+    // those referenced by `[start, end)`.
+    let control_vertex_count =
+        match unsafe { sys::far::stencil_table::StencilTable_GetNumControlVertices(ptr) } {
+            0 => {
+                let indices = unsafe {
+                    let vr = sys::far::stencil_table::StencilTable_GetControlIndices(ptr);
+                    std::slice::from_raw_parts(vr.data(), vr.size())
+                };
+                let tap_start = stencil_offset(ptr, start);
+                let tap_end = if end == stencil_count {
+                    indices.len()
+                } else {
+                    stencil_offset(ptr, end)
+                };
+                indices[tap_start..tap_end]
+                    .iter()
+                    .max()
+                    .map_or(0, |&index| index as usize + 1)
+            }
+            count => count as usize,
+        };
+
+    let src_len = src_desc.buffer_len(control_vertex_count);
+    if src.len() < src_len {
+        return Err(crate::Error::InvalidBufferSize {
+            expected: src_len,
+            actual: src.len(),
+        });
+    }
+
+    if start == end {
+        return Ok(());
+    }
+
+    if unsafe {
+        sys::far::stencil_table::StencilTable_UpdateValuesWithDescriptors(
+            ptr,
+            src.as_ptr(),
+            src_desc.0,
+            dst.as_mut_ptr(),
+            dst_desc.0,
+            start as i32,
+            end as i32,
+        )
+    } {
+        Ok(())
+    } else {
+        Err(crate::Error::EvalStencilsFailed)
+    }
 }
 
 //
@@ -250,11 +491,73 @@ impl<'a> StencilTableRef<'a> {
         unsafe { sys::far::stencil_table::StencilTable_GetNumControlVertices(self.ptr) as _ }
     }
 
+    /// Returns the number of control vertices of each stencil in the table.
+    #[inline]
+    pub fn sizes(&self) -> &'a [u32] {
+        unsafe {
+            let vr = sys::far::stencil_table::StencilTable_GetSizes(self.ptr);
+            std::slice::from_raw_parts(vr.data(), vr.size())
+        }
+    }
+
+    /// Returns the offset to a given stencil (factory may leave empty).
+    #[inline]
+    pub fn offsets(&self) -> &'a [Index] {
+        unsafe {
+            let vr = sys::far::stencil_table::StencilTable_GetOffsets(self.ptr);
+            std::slice::from_raw_parts(vr.data() as *const Index, vr.size())
+        }
+    }
+
+    /// Returns the indices of the control vertices.
+    #[inline]
+    pub fn control_indices(&self) -> &'a [Index] {
+        unsafe {
+            let vr = sys::far::stencil_table::StencilTable_GetControlIndices(self.ptr);
+            std::slice::from_raw_parts(vr.data() as *const Index, vr.size())
+        }
+    }
+
+    /// Returns the stencil interpolation weights.
+    #[inline]
+    pub fn weights(&self) -> &'a [f32] {
+        unsafe {
+            let vr = sys::far::stencil_table::StencilTable_GetWeights(self.ptr);
+            std::slice::from_raw_parts(vr.data(), vr.size())
+        }
+    }
+
+    /// Returns the bytes held by the arrays of the table.
+    pub fn memory_footprint(&self) -> MemoryFootprint {
+        MemoryFootprint {
+            sizes: std::mem::size_of_val(self.sizes()),
+            offsets: std::mem::size_of_val(self.offsets()),
+            indices: std::mem::size_of_val(self.control_indices()),
+            weights: std::mem::size_of_val(self.weights()),
+            ..Default::default()
+        }
+    }
+
     /// Update values by applying the stencil table
     pub fn update_values(&self, src: &[f32], start: Option<usize>, end: Option<usize>) -> Vec<f32> {
         // Use the same implementation as StencilTable
         StencilTable(std::ptr::null_mut()).update_values_impl(self.ptr, src, start, end)
     }
+
+    /// Update interleaved values in place by applying the stencil table.
+    ///
+    /// See [`StencilTable::update_values_interleaved()`].
+    pub fn update_values_interleaved(
+        &self,
+        src: &[f32],
+        src_desc: BufferDescriptor,
+        dst: &mut [f32],
+        dst_desc: BufferDescriptor,
+        start: Option<usize>,
+        end: Option<usize>,
+    ) -> crate::Result<()> {
+        update_values_interleaved_impl(self.ptr, src, src_desc, dst, dst_desc, start, end)
+    }
 }
 
 impl Default for StencilTableOptions {
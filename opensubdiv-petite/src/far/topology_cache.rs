@@ -0,0 +1,561 @@
+//! Topology hashing and a process-wide cache of refined topology.
+//!
+//! Assets that share their topology and only differ in vertex positions --
+//! crowd variants, simulation caches -- need the same refiner and tables.
+//! [`TopologyHasher`] computes a content hash over a [`TopologyDescriptor`]
+//! and the options it is refined with; [`TopologyCache`] builds the
+//! [`TopologyTables`] of each hash once and hands out shared [`Arc`]s to
+//! them.
+//!
+//! ## Example
+//!
+//! ```no_run
+//! # use opensubdiv_petite::far::*;
+//! # fn example(descriptor: TopologyDescriptor) -> opensubdiv_petite::Result<()> {
+//! let options = TopologyRefinerOptions::default();
+//! let refinement = UniformRefinementOptions::default();
+//! let hash = TopologyHasher::new()
+//!     .descriptor(&descriptor)
+//!     .refiner_options(&options)
+//!     .uniform_refinement(&refinement)
+//!     .finish();
+//!
+//! let tables = TopologyCache::global().get_or_build(hash, || {
+//!     let mut refiner = TopologyRefiner::new(descriptor, options)?;
+//!     refiner.refine_uniform(refinement);
+//!     let stencil_table = StencilTable::new(&refiner, StencilTableOptions::default())?;
+//!     Ok(TopologyTables::new(refiner).stencil_table(stencil_table))
+//! })?;
+//! # Ok(())
+//! # }
+//! ```
+use super::{
+    AdaptiveRefinementOptions, LimitStencilTable, PatchMap, PatchTable, StencilTable,
+    StencilTableOptions, TopologyDescriptor, TopologyRefiner, TopologyRefinerOptions,
+    UniformRefinementOptions,
+};
+use crate::{Error, Index, Result};
+use std::collections::HashMap;
+use std::sync::{Arc, Mutex, OnceLock};
+
+const PRIME_1: u64 = 0x9E37_79B1_85EB_CA87;
+const PRIME_2: u64 = 0xC2B2_AE3D_27D4_EB4F;
+const PRIME_3: u64 = 0x1656_67B1_9E37_79F9;
+const PRIME_4: u64 = 0x85EB_CA77_C2B2_AE63;
+
+/// Streaming content hash of topology and refinement settings.
+///
+/// The hash only depends on the values fed in, not on the platform, the
+/// process or the version of Rust, so it can key caches on disk (see
+/// [`TableCacheWriter`](super::TableCacheWriter)). Each array is prefixed
+/// with its length, so the same values split differently hash differently.
+#[derive(Clone, Debug)]
+pub struct TopologyHasher {
+    state: u64,
+    word_count: u64,
+}
+
+// AIDEV-NOTE: The mixing is the 8-byte step and the avalanche of XXH64 on a
+// single lane. Changing it invalidates every cache on disk; bump
+// `CACHE_VERSION` if you do.
+impl TopologyHasher {
+    /// Creates a hasher with nothing fed in.
+    pub fn new() -> Self {
+        Self {
+            state: PRIME_1 ^ PRIME_4,
+            word_count: 0,
+        }
+    }
+
+    /// Feeds the vertex counts and indices of the faces, the creases,
+    /// corners, holes, handedness and face-varying channels of `descriptor`.
+    pub fn descriptor(&mut self, descriptor: &TopologyDescriptor<'_>) -> &mut Self {
+        self.u64(0x7d);
+        descriptor.hash_into(self);
+        self
+    }
+
+    /// Feeds the scheme and the rules it is configured with.
+    pub fn refiner_options(&mut self, options: &TopologyRefinerOptions) -> &mut Self {
+        self.u64(0x7e);
+        self.u64(options.scheme as u64);
+        self.u64(
+            options
+                .boundary_interpolation
+                .map_or(u64::MAX, |value| value as u64),
+        );
+        self.u64(
+            options
+                .face_varying_linear_interpolation
+                .map_or(u64::MAX, |value| value as u64),
+        );
+        self.u64(options.creasing_method as u64);
+        self.u64(options.triangle_subdivision as u64)
+    }
+
+    /// Feeds uniform refinement settings.
+    pub fn uniform_refinement(&mut self, options: &UniformRefinementOptions) -> &mut Self {
+        self.u64(0x7f);
+        self.u64(options.refinement_level as u64);
+        self.u64(options.order_vertices_from_faces_first as u64);
+        self.u64(options.full_topology_in_last_level as u64)
+    }
+
+    /// Feeds adaptive refinement settings and the faces refinement is
+    /// restricted to, if any.
+    pub fn adaptive_refinement(
+        &mut self,
+        options: &AdaptiveRefinementOptions,
+        selected_faces: Option<&[Index]>,
+    ) -> &mut Self {
+        self.u64(0x80);
+        self.u64(options.isolation_level as u64);
+        self.u64(options.secondary_level as u64);
+        self.u64(options.single_crease_patch as u64);
+        self.u64(options.infintely_sharp_patch as u64);
+        self.u64(options.consider_face_varying_channels as u64);
+        self.u64(options.order_vertices_from_faces_first as u64);
+        match selected_faces {
+            Some(faces) => self.u32s(bytemuck::cast_slice(faces)),
+            None => self.u64(u64::MAX),
+        }
+    }
+
+    /// Feeds stencil table settings.
+    pub fn stencil_table_options(&mut self, options: &StencilTableOptions) -> &mut Self {
+        self.u64(0x81);
+        self.u64(options.interpolation_mode as u64);
+        self.u64(options.generate_offsets as u64);
+        self.u64(options.generate_control_vertices as u64);
+        self.u64(options.generate_intermediate_levels as u64);
+        self.u64(options.factorize_intermediate_levels as u64);
+        self.u64(options.max_level as u64);
+        self.u64(options.face_varying_channel as u64)
+    }
+
+    /// Feeds a single value, e.g. a setting without a dedicated method.
+    #[inline]
+    pub fn u64(&mut self, value: u64) -> &mut Self {
+        let mut lane = value.wrapping_mul(PRIME_2);
+        lane = lane.rotate_left(31).wrapping_mul(PRIME_1);
+        self.state ^= lane;
+        self.state = self
+            .state
+            .rotate_left(27)
+            .wrapping_mul(PRIME_1)
+            .wrapping_add(PRIME_4);
+        self.word_count += 1;
+        self
+    }
+
+    /// Feeds the length and the values of `values`.
+    pub fn u32s(&mut self, values: &[u32]) -> &mut Self {
+        self.u64(values.len() as u64);
+        let mut pairs = values.chunks_exact(2);
+        for pair in &mut pairs {
+            self.u64(u64::from(pair[0]) | u64::from(pair[1]) << 32);
+        }
+        if let [last] = pairs.remainder() {
+            self.u64(u64::from(*last));
+        }
+        self
+    }
+
+    /// Feeds the length and the bit patterns of `values`.
+    pub fn f32s(&mut self, values: &[f32]) -> &mut Self {
+        self.u32s(bytemuck::cast_slice(values))
+    }
+
+    /// Returns the hash of everything fed in so far.
+    pub fn finish(&self) -> u64 {
+        let mut hash = self.state.wrapping_add(self.word_count);
+        hash ^= hash >> 33;
+        hash = hash.wrapping_mul(PRIME_2);
+        hash ^= hash >> 29;
+        hash = hash.wrapping_mul(PRIME_3);
+        hash ^ (hash >> 32)
+    }
+}
+
+impl Default for TopologyHasher {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Returns the hash of `descriptor` refined with `options`.
+///
+/// Feed refinement and table settings through a [`TopologyHasher`] in
+/// addition if they vary.
+pub fn topology_hash(descriptor: &TopologyDescriptor<'_>, options: &TopologyRefinerOptions) -> u64 {
+    TopologyHasher::new()
+        .descriptor(descriptor)
+        .refiner_options(options)
+        .finish()
+}
+
+/// A refined topology and the tables built from it.
+///
+/// Handed out by [`TopologyCache`] behind an [`Arc`]; everything is
+/// read-only once built.
+pub struct TopologyTables {
+    patch_map: Option<PatchMap>,
+    patch_table: Option<PatchTable>,
+    limit_stencil_table: Option<LimitStencilTable>,
+    stencil_table: Option<StencilTable>,
+    refiner: TopologyRefiner,
+}
+
+// AIDEV-NOTE: `TopologyRefiner` and `StencilTable` are not `Send`/`Sync` on
+// their own, because their `&mut self` methods (refinement) and the raw
+// pointers they hand to evaluators must not race. `TopologyTables` takes
+// them by value and only ever hands out `&` references, so per field:
+// - `refiner`: only `const` `Far::TopologyRefiner` members are reachable
+//   (level accessors, and the table and surface factories, which take
+//   `TopologyRefiner const&`). Refinement, the only mutation, needs
+//   `&mut TopologyRefiner`, which cannot be obtained from here.
+// - `stencil_table`: `Far::StencilTable` is immutable after creation;
+//   reachable methods only read its arrays (`update_values()` writes into
+//   caller buffers).
+// - `limit_stencil_table`, `patch_table`, `patch_map`: already `Send` and
+//   `Sync`.
+// Both C++ objects are plain heap allocations without thread affinity, so
+// dropping them on another thread is fine as well.
+unsafe impl Send for TopologyTables {}
+unsafe impl Sync for TopologyTables {}
+
+impl std::fmt::Debug for TopologyTables {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("TopologyTables")
+            .field("max_level", &self.refiner.max_level())
+            .field("stencil_table", &self.stencil_table.is_some())
+            .field("limit_stencil_table", &self.limit_stencil_table.is_some())
+            .field("patch_table", &self.patch_table.is_some())
+            .field("byte_size", &self.byte_size())
+            .finish()
+    }
+}
+
+impl TopologyTables {
+    /// Wraps a refined `refiner`.
+    pub fn new(refiner: TopologyRefiner) -> Self {
+        Self {
+            patch_map: None,
+            patch_table: None,
+            limit_stencil_table: None,
+            stencil_table: None,
+            refiner,
+        }
+    }
+
+    /// Adds the refinement stencils.
+    pub fn stencil_table(mut self, stencil_table: StencilTable) -> Self {
+        self.stencil_table = Some(stencil_table);
+        self
+    }
+
+    /// Adds limit stencils.
+    pub fn limit_stencil_table(mut self, limit_stencil_table: LimitStencilTable) -> Self {
+        self.limit_stencil_table = Some(limit_stencil_table);
+        self
+    }
+
+    /// Adds a patch table and builds its [`PatchMap`].
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::PatchTableCreation`] if the map cannot be built.
+    pub fn patch_table(mut self, patch_table: PatchTable) -> Result<Self> {
+        self.patch_map = Some(PatchMap::new(&patch_table).ok_or(Error::PatchTableCreation)?);
+        self.patch_table = Some(patch_table);
+        Ok(self)
+    }
+
+    /// Returns the refiner.
+    #[inline]
+    pub fn refiner(&self) -> &TopologyRefiner {
+        &self.refiner
+    }
+
+    /// Returns the refinement stencils, if built.
+    #[inline]
+    pub fn stencils(&self) -> Option<&StencilTable> {
+        self.stencil_table.as_ref()
+    }
+
+    /// Returns the limit stencils, if built.
+    #[inline]
+    pub fn limit_stencils(&self) -> Option<&LimitStencilTable> {
+        self.limit_stencil_table.as_ref()
+    }
+
+    /// Returns the patch table, if built.
+    #[inline]
+    pub fn patches(&self) -> Option<&PatchTable> {
+        self.patch_table.as_ref()
+    }
+
+    /// Returns the map locating the patches of the patch table, if built.
+    ///
+    /// Pass [`patches()`](Self::patches()) to its lookups.
+    #[inline]
+    pub fn patch_map(&self) -> Option<&PatchMap> {
+        self.patch_map.as_ref()
+    }
+
+    /// Returns an estimate of the memory held, in bytes.
+    ///
+    /// Table arrays are counted exactly; the refiner is estimated from its
+    /// component counts.
+    pub fn byte_size(&self) -> usize {
+        let word = std::mem::size_of::<u32>();
+        let refiner = 16
+            * (self.refiner.vertex_count_all_levels() + self.refiner.face_count_all_levels())
+            + 24 * (self.refiner.edge_count_all_levels()
+                + self.refiner.face_vertex_count_all_levels());
+        let stencils = self.stencil_table.as_ref().map_or(0, |table| {
+            word * (2 * table.len() + table.control_indices().len() + table.weights().len())
+        });
+        let limit_stencils = self.limit_stencil_table.as_ref().map_or(0, |table| {
+            let derivatives = [
+                table.du_weights(),
+                table.dv_weights(),
+                table.duu_weights(),
+                table.duv_weights(),
+                table.dvv_weights(),
+            ];
+            word * (2 * table.len()
+                + table.control_indices().len()
+                + table.weights().len()
+                + derivatives
+                    .iter()
+                    .map(|weights| weights.len())
+                    .sum::<usize>())
+        });
+        let patches = self.patch_table.as_ref().map_or(0, |table| {
+            let local_points = table.local_point_stencil_table().map_or(0, |stencils| {
+                2 * stencils.len() + stencils.control_indices().len() + stencils.weights().len()
+            });
+            word * (table.control_vertex_count() + 2 * table.patch_count() + local_points)
+        });
+        refiner + stencils + limit_stencils + patches
+    }
+}
+
+/// Counters of a [`TopologyCache`].
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct TopologyCacheStats {
+    /// Lookups answered from the cache.
+    pub hits: u64,
+    /// Lookups that had to build the tables.
+    pub misses: u64,
+    /// Entries dropped to stay within the budget.
+    pub evictions: u64,
+    /// Entries currently cached.
+    pub entries: usize,
+    /// Estimated memory of the cached entries, in bytes.
+    pub bytes: usize,
+    /// Memory budget, in bytes.
+    pub budget: usize,
+}
+
+/// Thread-safe LRU cache of [`TopologyTables`] keyed by topology hash.
+///
+/// Each hash is built once: concurrent lookups of a hash that is being
+/// built wait for it instead of building it again. When the estimated
+/// memory of the cached entries exceeds the budget, the least recently used
+/// entries are dropped from the cache; handles already given out stay
+/// valid.
+pub struct TopologyCache {
+    state: Mutex<CacheState>,
+}
+
+impl std::fmt::Debug for TopologyCache {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("TopologyCache")
+            .field("stats", &self.stats())
+            .finish()
+    }
+}
+
+struct CacheState {
+    entries: HashMap<u64, CacheEntry>,
+    budget: usize,
+    bytes: usize,
+    clock: u64,
+    stats: TopologyCacheStats,
+}
+
+struct CacheEntry {
+    slot: Arc<Mutex<Option<Arc<TopologyTables>>>>,
+    last_used: u64,
+    bytes: usize,
+}
+
+/// Default budget of [`TopologyCache::global()`]: 1 GiB.
+pub const DEFAULT_TOPOLOGY_CACHE_BUDGET: usize = 1 << 30;
+
+impl TopologyCache {
+    /// Creates an empty cache holding at most `budget` bytes.
+    pub fn new(budget: usize) -> Self {
+        Self {
+            state: Mutex::new(CacheState {
+                entries: HashMap::new(),
+                budget,
+                bytes: 0,
+                clock: 0,
+                stats: TopologyCacheStats::default(),
+            }),
+        }
+    }
+
+    /// Returns the process-wide cache.
+    ///
+    /// Its budget starts at [`DEFAULT_TOPOLOGY_CACHE_BUDGET`].
+    pub fn global() -> &'static TopologyCache {
+        static GLOBAL: OnceLock<TopologyCache> = OnceLock::new();
+        GLOBAL.get_or_init(|| TopologyCache::new(DEFAULT_TOPOLOGY_CACHE_BUDGET))
+    }
+
+    /// Returns the tables of `hash`, calling `build` if they are not cached.
+    ///
+    /// An entry larger than the whole budget is returned but not kept.
+    ///
+    /// # Errors
+    ///
+    /// Returns the error of `build`; nothing is cached then, and the next
+    /// lookup builds again.
+    pub fn get_or_build(
+        &self,
+        hash: u64,
+        build: impl FnOnce() -> Result<TopologyTables>,
+    ) -> Result<Arc<TopologyTables>> {
+        let slot = {
+            let mut state = self.lock();
+            state.clock += 1;
+            let clock = state.clock;
+            let entry = state.entries.entry(hash).or_insert_with(|| CacheEntry {
+                slot: Arc::default(),
+                last_used: clock,
+                bytes: 0,
+            });
+            entry.last_used = clock;
+            entry.slot.clone()
+        };
+
+        // AIDEV-NOTE: Building holds only the entry's lock, so lookups of
+        // other hashes proceed and lookups of this one wait for the result.
+        let mut tables = slot.lock().unwrap_or_else(|poisoned| poisoned.into_inner());
+        if let Some(tables) = tables.as_ref() {
+            self.lock().stats.hits += 1;
+            return Ok(tables.clone());
+        }
+
+        let built = match build() {
+            Ok(built) => Arc::new(built),
+            Err(error) => {
+                let mut state = self.lock();
+                state.stats.misses += 1;
+                if state
+                    .entries
+                    .get(&hash)
+                    .is_some_and(|entry| Arc::ptr_eq(&entry.slot, &slot))
+                {
+                    state.entries.remove(&hash);
+                }
+                return Err(error);
+            }
+        };
+        *tables = Some(built.clone());
+        drop(tables);
+
+        let bytes = built.byte_size();
+        let mut state = self.lock();
+        state.stats.misses += 1;
+        match state.entries.get_mut(&hash) {
+            Some(entry) if Arc::ptr_eq(&entry.slot, &slot) => {
+                entry.bytes = bytes;
+                state.bytes += bytes;
+            }
+            // Cleared while building.
+            _ => return Ok(built),
+        }
+        state.evict(hash);
+        Ok(built)
+    }
+
+    /// Returns the cached tables of `hash` without building them.
+    pub fn get(&self, hash: u64) -> Option<Arc<TopologyTables>> {
+        let mut state = self.lock();
+        state.clock += 1;
+        let clock = state.clock;
+        let entry = state.entries.get_mut(&hash)?;
+        let tables = entry.slot.try_lock().ok()?.clone()?;
+        entry.last_used = clock;
+        state.stats.hits += 1;
+        Some(tables)
+    }
+
+    /// Changes the memory budget, evicting entries if needed.
+    pub fn set_budget(&self, budget: usize) {
+        let mut state = self.lock();
+        state.budget = budget;
+        state.evict_all_but(None);
+    }
+
+    /// Drops all entries from the cache.
+    pub fn clear(&self) {
+        let mut state = self.lock();
+        state.entries.clear();
+        state.bytes = 0;
+    }
+
+    /// Returns the counters of the cache.
+    pub fn stats(&self) -> TopologyCacheStats {
+        let state = self.lock();
+        TopologyCacheStats {
+            entries: state.entries.len(),
+            bytes: state.bytes,
+            budget: state.budget,
+            ..state.stats
+        }
+    }
+
+    fn lock(&self) -> std::sync::MutexGuard<'_, CacheState> {
+        self.state
+            .lock()
+            .unwrap_or_else(|poisoned| poisoned.into_inner())
+    }
+}
+
+impl CacheState {
+    /// Evicts least recently used entries other than `keep` until the cache
+    /// fits its budget, then `keep` itself if it alone exceeds the budget.
+    fn evict(&mut self, keep: u64) {
+        self.evict_all_but(Some(keep));
+        if self.bytes > self.budget {
+            if let Some(entry) = self.entries.remove(&keep) {
+                self.bytes -= entry.bytes;
+                self.stats.evictions += 1;
+            }
+        }
+    }
+
+    fn evict_all_but(&mut self, keep: Option<u64>) {
+        while self.bytes > self.budget {
+            // Entries still being built have no size yet and are skipped.
+            let oldest = self
+                .entries
+                .iter()
+                .filter(|(&hash, entry)| Some(hash) != keep && entry.bytes > 0)
+                .min_by_key(|(_, entry)| entry.last_used)
+                .map(|(&hash, _)| hash);
+            let Some(hash) = oldest else {
+                break;
+            };
+            let entry = self.entries.remove(&hash).unwrap();
+            self.bytes -= entry.bytes;
+            self.stats.evictions += 1;
+        }
+    }
+}
@@ -52,6 +52,9 @@
 use opensubdiv_petite_sys as sys;
 use std::marker::PhantomData;
 
+#[cfg(feature = "rayon")]
+use rayon::prelude::*;
+
 /// A `TopologyDescriptor` holds references to raw topology data as flat index
 /// buffers.
 ///
@@ -70,6 +73,13 @@ use std::marker::PhantomData;
 #[derive(Debug, Clone, Hash, PartialEq, Eq)]
 pub struct TopologyDescriptor<'a> {
     pub(crate) descriptor: sys::OpenSubdiv_v3_7_0_Far_TopologyDescriptor,
+    // Owned so the builder can add channels one at a time; `descriptor`'s
+    // `fvarChannels` is only pointed at this in `as_sys()`, which keeps
+    // clones from sharing (and outliving) the original's buffer.
+    face_varying_channels: Vec<sys::OpenSubdiv_v3_7_0_Far_TopologyDescriptor_FVarChannel>,
+    // Length of the `vertex_indices_per_face` slice, which the raw
+    // descriptor does not record.
+    vertex_index_len: usize,
     // _marker needs to be invariant in 'a.
     // See "Making a struct outlive a parameter given to a method of
     // that struct": https://stackoverflow.com/questions/62374326/
@@ -122,6 +132,8 @@ impl<'a> TopologyDescriptor<'a> {
 
         Ok(TopologyDescriptor {
             descriptor,
+            face_varying_channels: Vec::new(),
+            vertex_index_len: vertex_indices_per_face.len(),
             _marker: PhantomData,
         })
     }
@@ -180,7 +192,7 @@ impl<'a> TopologyDescriptor<'a> {
             }
         }
 
-        self.descriptor.numCorners = sharpness.len().min(i32::MAX as usize) as i32;
+        self.descriptor.numCorners = corners.len().min(i32::MAX as usize) as i32;
         self.descriptor.cornerVertexIndices = corners.as_ptr() as _;
         self.descriptor.cornerWeights = sharpness.as_ptr();
         Ok(self)
@@ -206,6 +218,47 @@ impl<'a> TopologyDescriptor<'a> {
         Ok(self)
     }
 
+    /// Add a face-varying channel, e.g. UVs with seams.
+    ///
+    /// `value_indices` holds one index into the channel's `values_len` values
+    /// per face-vertex, in the same order as `vertex_indices_per_face`.
+    /// Channels are numbered in the order they are added.
+    #[inline]
+    pub fn face_varying_channel(
+        mut self,
+        values_len: usize,
+        value_indices: &'a [u32],
+    ) -> crate::Result<Self> {
+        let face_vertex_len = self.face_vertex_len();
+        if value_indices.len() != face_vertex_len {
+            return Err(crate::Error::InvalidTopology(format!(
+                "Face-varying value index list has {} entries (should be {}).",
+                value_indices.len(),
+                face_vertex_len
+            )));
+        }
+
+        #[cfg(feature = "topology_validation")]
+        {
+            for (i, &value_index) in value_indices.iter().enumerate() {
+                if values_len <= value_index as usize {
+                    return Err(crate::Error::InvalidTopology(format!(
+                        "Face-varying value index[{}] = {} is out of range (should be < {}).",
+                        i, value_index, values_len
+                    )));
+                }
+            }
+        }
+
+        self.face_varying_channels.push(
+            sys::OpenSubdiv_v3_7_0_Far_TopologyDescriptor_FVarChannel {
+                numValues: values_len.min(i32::MAX as usize) as i32,
+                valueIndices: value_indices.as_ptr() as _,
+            },
+        );
+        Ok(self)
+    }
+
     /// Set if the topology describes faces with left handed (counter-clockwise)
     /// winding.
     #[inline]
@@ -213,4 +266,139 @@ impl<'a> TopologyDescriptor<'a> {
         self.descriptor.isLeftHanded = left_handed;
         self
     }
+
+    /// The raw descriptor, with the face-varying channels attached. Must not
+    /// outlive `self`.
+    pub(crate) fn as_sys(&self) -> sys::OpenSubdiv_v3_7_0_Far_TopologyDescriptor {
+        let mut descriptor = self.descriptor;
+        descriptor.numFVarChannels = self.face_varying_channels.len().min(i32::MAX as usize) as i32;
+        descriptor.fvarChannels = self.face_varying_channels.as_ptr();
+        descriptor
+    }
+
+    /// Feeds every array of the descriptor into `hasher`.
+    pub(crate) fn hash_into(&self, hasher: &mut super::TopologyHasher) {
+        let d = &self.descriptor;
+        // The pointers come from slices borrowed for `'a`; counts of zero may
+        // come with null pointers.
+        unsafe {
+            hasher.u64(d.numVertices as u64);
+            hasher.u32s(raw_slice(d.numVertsPerFace as *const u32, d.numFaces));
+            let face_vertex_len = self.face_vertex_len() as i32;
+            hasher.u32s(raw_slice(
+                d.vertIndicesPerFace as *const u32,
+                face_vertex_len.min(self.vertex_index_len as i32),
+            ));
+            hasher.u32s(raw_slice(
+                d.creaseVertexIndexPairs as *const u32,
+                d.numCreases * 2,
+            ));
+            hasher.f32s(raw_slice(d.creaseWeights, d.numCreases));
+            hasher.u32s(raw_slice(d.cornerVertexIndices as *const u32, d.numCorners));
+            hasher.f32s(raw_slice(d.cornerWeights, d.numCorners));
+            hasher.u32s(raw_slice(d.holeIndices as *const u32, d.numHoles));
+            hasher.u64(d.isLeftHanded as u64);
+            hasher.u64(self.face_varying_channels.len() as u64);
+            for channel in &self.face_varying_channels {
+                hasher.u64(channel.numValues as u64);
+                hasher.u32s(raw_slice(
+                    channel.valueIndices as *const u32,
+                    face_vertex_len,
+                ));
+            }
+        }
+    }
+
+    /// Checks that the index arrays are as long as the face sizes require and
+    /// that every index refers to an existing vertex, face or face-varying
+    /// value.
+    ///
+    /// The face-vertex and face-varying indices are checked in parallel when
+    /// the `rayon` feature is enabled.
+    pub(crate) fn validate_indices(&self) -> crate::Result<()> {
+        let d = &self.descriptor;
+        let face_vertex_len = self.face_vertex_len();
+        if self.vertex_index_len != face_vertex_len {
+            return Err(crate::Error::InvalidTopology(format!(
+                "The number of vertex indices ({}) is not equal to the sum of face arities ({}).",
+                self.vertex_index_len, face_vertex_len
+            )));
+        }
+
+        let vertex_count = d.numVertices as usize;
+        // Lengths were checked when the arrays were added.
+        let arrays = unsafe {
+            [
+                (
+                    "Vertex",
+                    raw_slice(d.vertIndicesPerFace as *const u32, face_vertex_len as i32),
+                    vertex_count,
+                ),
+                (
+                    "Crease vertex",
+                    raw_slice(d.creaseVertexIndexPairs as *const u32, d.numCreases * 2),
+                    vertex_count,
+                ),
+                (
+                    "Corner vertex",
+                    raw_slice(d.cornerVertexIndices as *const u32, d.numCorners),
+                    vertex_count,
+                ),
+                (
+                    "Hole face",
+                    raw_slice(d.holeIndices as *const u32, d.numHoles),
+                    d.numFaces as usize,
+                ),
+            ]
+        };
+        for (name, indices, len) in arrays {
+            check_index_range(name, indices, len)?;
+        }
+        for channel in &self.face_varying_channels {
+            let indices =
+                unsafe { raw_slice(channel.valueIndices as *const u32, face_vertex_len as i32) };
+            check_index_range("Face-varying value", indices, channel.numValues as usize)?;
+        }
+        Ok(())
+    }
+
+    /// Total number of face-vertices, i.e. the length of
+    /// `vertex_indices_per_face`.
+    fn face_vertex_len(&self) -> usize {
+        // Both come from the `vertices_per_face` slice passed to `new()`.
+        let vertices_per_face = unsafe {
+            std::slice::from_raw_parts(
+                self.descriptor.numVertsPerFace,
+                self.descriptor.numFaces as usize,
+            )
+        };
+        vertices_per_face.iter().map(|&count| count as usize).sum()
+    }
+}
+
+/// Returns an error naming the first of `indices` that is not below `len`.
+fn check_index_range(name: &str, indices: &[u32], len: usize) -> crate::Result<()> {
+    #[cfg(feature = "rayon")]
+    let position = indices
+        .par_iter()
+        .position_first(|&index| len <= index as usize);
+    #[cfg(not(feature = "rayon"))]
+    let position = indices.iter().position(|&index| len <= index as usize);
+
+    match position {
+        Some(i) => Err(crate::Error::InvalidTopology(format!(
+            "{} index[{}] = {} is out of range (should be < {}).",
+            name, i, indices[i], len
+        ))),
+        None => Ok(()),
+    }
+}
+
+/// A slice of `len` elements at `ptr`, or an empty one if there are none.
+unsafe fn raw_slice<'b, T>(ptr: *const T, len: i32) -> &'b [T] {
+    if ptr.is_null() || len <= 0 {
+        &[]
+    } else {
+        unsafe { std::slice::from_raw_parts(ptr, len as usize) }
+    }
 }
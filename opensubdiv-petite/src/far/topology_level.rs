@@ -4,6 +4,7 @@ use super::topology_refiner::TopologyRefiner;
 use opensubdiv_petite_sys as sys;
 
 use crate::Index;
+use std::borrow::Cow;
 use sys::vtr::types::LocalIndex;
 
 const INVALID_INDEX: u32 = u32::MAX; // aka: -1i32
@@ -355,6 +356,220 @@ impl<'a> IndexedParallelIterator for FaceVerticesParIter<'a> {
     }
 }
 
+/// A relation of all components of a [`TopologyLevel`] in compressed sparse
+/// row (CSR) layout.
+///
+/// Row `i`, e.g. the vertices of face `i`, is
+/// `indices()[offsets()[i]..offsets()[i + 1]]`. The indices borrow the arrays
+/// of the refiner when they are stored that way, which is the case for all
+/// relations of uniformly refined levels; otherwise they are copied in one
+/// call.
+#[derive(Clone, Debug)]
+pub struct LevelRelation<'a> {
+    offsets: Vec<u32>,
+    indices: Cow<'a, [Index]>,
+}
+
+impl<'a> LevelRelation<'a> {
+    /// Fetches a relation with `row_count` rows in one call to `get`, falling
+    /// back to one call to `copy` if the rows are not stored back to back.
+    fn fetch(
+        row_count: usize,
+        get: impl FnOnce(*mut i32) -> sys::vtr::types::ConstIndexArray,
+        copy: impl FnOnce(*mut sys::vtr::Index),
+    ) -> Self {
+        let mut offsets = vec![0u32; row_count + 1];
+        let packed = get(offsets.as_mut_ptr() as *mut i32);
+        let len = offsets[row_count] as usize;
+        let indices = if 0 == len {
+            Cow::Borrowed(&[][..])
+        } else if !packed.begin().is_null() {
+            // SAFETY: The rows are stored back to back in an array owned by
+            // the refiner, which outlives `'a`.
+            Cow::Borrowed(unsafe {
+                std::slice::from_raw_parts(packed.begin() as *const Index, len)
+            })
+        } else {
+            let mut indices = vec![Index(0); len];
+            copy(indices.as_mut_ptr() as *mut sys::vtr::Index);
+            Cow::Owned(indices)
+        };
+        Self { offsets, indices }
+    }
+
+    /// Returns the number of rows.
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.offsets.len() - 1
+    }
+
+    /// Returns `true` if there are no rows.
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        0 == self.len()
+    }
+
+    /// Returns the `len() + 1` offsets of the rows into
+    /// [`indices()`](Self::indices()).
+    #[inline]
+    pub fn offsets(&self) -> &[u32] {
+        &self.offsets
+    }
+
+    /// Returns the indices of all rows, back to back.
+    #[inline]
+    pub fn indices(&self) -> &[Index] {
+        &self.indices
+    }
+
+    /// Returns `true` if the indices borrow the arrays of the refiner instead
+    /// of being copied.
+    #[inline]
+    pub fn is_borrowed(&self) -> bool {
+        matches!(self.indices, Cow::Borrowed(_))
+    }
+
+    /// Returns row `i`.
+    #[inline]
+    pub fn row(&self, i: usize) -> Option<&[Index]> {
+        let begin = *self.offsets.get(i)? as usize;
+        let end = *self.offsets.get(i + 1)? as usize;
+        Some(&self.indices[begin..end])
+    }
+
+    /// Returns an iterator over the rows.
+    #[inline]
+    pub fn iter(&self) -> impl ExactSizeIterator<Item = &[Index]> + Clone + '_ {
+        self.offsets
+            .windows(2)
+            .map(|range| &self.indices[range[0] as usize..range[1] as usize])
+    }
+
+    /// Returns a parallel iterator over the rows.
+    ///
+    /// This method is only available when the `rayon` feature is enabled.
+    #[cfg(feature = "rayon")]
+    #[inline]
+    pub fn par_iter(&self) -> impl IndexedParallelIterator<Item = &[Index]> + '_ {
+        self.offsets
+            .par_windows(2)
+            .map(|range| &self.indices[range[0] as usize..range[1] as usize])
+    }
+
+    /// Drops the first `count` rows.
+    fn skip_rows(self, count: usize) -> Self {
+        if 0 == count {
+            return self;
+        }
+        let begin = self.offsets[count];
+        Self {
+            indices: Cow::Owned(self.indices[begin as usize..].to_vec()),
+            offsets: self.offsets[count..]
+                .iter()
+                .map(|offset| offset - begin)
+                .collect(),
+        }
+    }
+}
+
+impl<'a> FaceVerticesIter<'a> {
+    /// Fetches the face-vertices of the faces not yet visited at once.
+    pub(crate) fn remaining_relation(&self) -> LevelRelation<'a> {
+        self.level
+            .face_vertex_relation()
+            .skip_rows(self.current as usize)
+    }
+}
+
+#[cfg(feature = "rayon")]
+impl<'a> FaceVerticesParIter<'a> {
+    /// Fetches the face-vertices of all faces at once.
+    pub(crate) fn relation(&self) -> LevelRelation<'a> {
+        self.level.face_vertex_relation()
+    }
+}
+
+/// ### Methods to Access the Relations of All Components at Once
+///
+/// Each of these makes a single call into *OpenSubdiv* instead of one per
+/// component, and borrows the arrays of the refiner where possible. Prefer
+/// them to the per-component methods when walking a whole level.
+impl<'a> TopologyLevel<'a> {
+    /// Returns the vertices of all faces.
+    pub fn face_vertex_relation(&self) -> LevelRelation<'a> {
+        LevelRelation::fetch(
+            self.face_count(),
+            |offsets| unsafe { sys::far::TopologyLevel_GetFaceVerticesCsr(self.ptr, offsets) },
+            |dst| unsafe { sys::far::TopologyLevel_CopyFaceVertices(self.ptr, dst) },
+        )
+    }
+
+    /// Returns the faces incident to all vertices.
+    pub fn vertex_face_relation(&self) -> LevelRelation<'a> {
+        LevelRelation::fetch(
+            self.vertex_count(),
+            |offsets| unsafe { sys::far::TopologyLevel_GetVertexFacesCsr(self.ptr, offsets) },
+            |dst| unsafe { sys::far::TopologyLevel_CopyVertexFaces(self.ptr, dst) },
+        )
+    }
+
+    /// Returns the face-varying values of all faces in a channel, with the
+    /// same offsets as [`face_vertex_relation()`](Self::face_vertex_relation()).
+    ///
+    /// Returns `None` if the channel does not exist.
+    pub fn face_varying_value_relation(&self, channel: usize) -> Option<LevelRelation<'a>> {
+        if self.face_varying_channel_count() <= channel {
+            return None;
+        }
+        let channel = channel as i32;
+        Some(LevelRelation::fetch(
+            self.face_count(),
+            |offsets| unsafe {
+                sys::far::TopologyLevel_GetFaceFVarValuesCsr(self.ptr, channel, offsets)
+            },
+            |dst| unsafe { sys::far::TopologyLevel_CopyFaceFVarValues(self.ptr, channel, dst) },
+        ))
+    }
+
+    /// Returns the two vertices of every edge.
+    pub fn edge_vertex_pairs(&self) -> Cow<'a, [[Index; 2]]> {
+        let edge_count = self.edge_count();
+        let packed =
+            unsafe { sys::far::TopologyLevel_GetEdgeVerticesCsr(self.ptr, std::ptr::null_mut()) };
+        if 0 == edge_count {
+            Cow::Borrowed(&[])
+        } else if !packed.begin().is_null() && packed.size() as usize == 2 * edge_count {
+            // SAFETY: See `LevelRelation::fetch()`.
+            Cow::Borrowed(bytemuck::cast_slice(unsafe {
+                std::slice::from_raw_parts(packed.begin() as *const Index, 2 * edge_count)
+            }))
+        } else {
+            let mut pairs = vec![[Index(0); 2]; edge_count];
+            unsafe {
+                sys::far::TopologyLevel_CopyEdgeVertices(
+                    self.ptr,
+                    pairs.as_mut_ptr() as *mut sys::vtr::Index,
+                )
+            };
+            Cow::Owned(pairs)
+        }
+    }
+
+    /// Returns the sharpness of every edge.
+    pub fn edge_sharpnesses(&self) -> Vec<f32> {
+        let mut sharpnesses = vec![0.0; self.edge_count()];
+        unsafe { sys::far::TopologyLevel_GetEdgeSharpnesses(self.ptr, sharpnesses.as_mut_ptr()) };
+        sharpnesses
+    }
+
+    /// Returns the sharpness of every vertex.
+    pub fn vertex_sharpnesses(&self) -> Vec<f32> {
+        let mut sharpnesses = vec![0.0; self.vertex_count()];
+        unsafe { sys::far::TopologyLevel_GetVertexSharpnesses(self.ptr, sharpnesses.as_mut_ptr()) };
+        sharpnesses
+    }
+}
+
 /// ### Methods to Inspect Other Topological Properties of Individual Components
 impl<'a> TopologyLevel<'a> {
     /// Returns `true` if the edge is non-manifold.
@@ -23,6 +23,7 @@ use opensubdiv_petite_sys as sys;
 use std::convert::TryInto;
 
 use crate::far::TopologyDescriptor;
+use crate::instrument::{self, LevelRecord, Stage};
 use crate::{Error, Index};
 type Result<T, E = Error> = std::result::Result<T, E>;
 
@@ -32,33 +33,84 @@ pub struct TopologyRefiner(pub(crate) sys::topology_refiner::TopologyRefinerPtr)
 impl TopologyRefiner {
     /// Create a new topology refiner.
     pub fn new(descriptor: TopologyDescriptor, options: TopologyRefinerOptions) -> Result<Self> {
-        let sdc_options = sys::sdc::Options {
-            _vtxBoundInterp: match options.boundary_interpolation {
-                Some(interp) => interp as _,
-                None => sys::far::topology_refiner::VTX_BOUNDARY_NONE,
-            },
-            _fvarLinInterp: match options.face_varying_linear_interpolation {
-                Some(interp) => interp as _,
-                None => sys::far::topology_refiner::FVAR_LINEAR_NONE,
-            },
-            _creasingMethod: options.creasing_method as _,
-            _triangleSub: options.triangle_subdivision as _,
-        };
-
-        let mut sys_options: sys::far::topology_refiner::TopologyRefinerFactoryOptions =
-            unsafe { std::mem::zeroed() };
-        sys_options.schemeType = options.scheme as _;
-        sys_options.schemeOptions = sdc_options;
+        #[allow(unused_mut)]
+        let mut sys_options = factory_options(options);
 
         #[cfg(feature = "topology_validation")]
         sys_options.set_validateFullTopology(true as _);
 
-        let ptr = unsafe {
+        let sys_descriptor = descriptor.as_sys();
+        let ptr = instrument::stage(Stage::RefinerCreation, 0, || unsafe {
             sys::far::topology_refiner::TopologyRefinerFactory_TopologyDescriptor_Create(
-                &descriptor.descriptor as _,
+                &sys_descriptor as _,
                 sys_options,
             )
-        };
+        });
+
+        if ptr.is_null() {
+            Err(Error::CreateTopologyRefinerFailed)
+        } else {
+            Ok(Self(ptr))
+        }
+    }
+
+    /// Create a new topology refiner, checking the descriptor as thoroughly
+    /// as `validation` asks for.
+    ///
+    /// The descriptor's arrays are copied into the refiner in bulk rather
+    /// than face by face, which helps with meshes of millions of faces.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::InvalidTopology`] if an index is out of range and
+    /// [`Error::CreateTopologyRefinerFailed`] if *OpenSubdiv* rejects the
+    /// topology.
+    pub fn with_validation(
+        descriptor: TopologyDescriptor,
+        options: TopologyRefinerOptions,
+        validation: TopologyValidation,
+    ) -> Result<Self> {
+        descriptor.validate_indices()?;
+        let mut sys_options = factory_options(options);
+        if TopologyValidation::Full == validation {
+            sys_options.set_validateFullTopology(true as _);
+        }
+        unsafe { Self::create_bulk(&descriptor, sys_options) }
+    }
+
+    /// Create a new topology refiner without checking the descriptor.
+    ///
+    /// Like [`with_validation()`](Self::with_validation()), but skips even
+    /// the index range checks, for input that is known to be valid, e.g.
+    /// because it was exported by a trusted tool or checked before.
+    ///
+    /// # Safety
+    ///
+    /// Every index of `descriptor` must refer to an existing vertex, face or
+    /// face-varying value and the vertex index array must be as long as the
+    /// face sizes add up to. Otherwise *OpenSubdiv* reads and writes out of
+    /// bounds.
+    pub unsafe fn new_trusted(
+        descriptor: TopologyDescriptor,
+        options: TopologyRefinerOptions,
+    ) -> Result<Self> {
+        unsafe { Self::create_bulk(&descriptor, factory_options(options)) }
+    }
+
+    /// # Safety
+    ///
+    /// See [`new_trusted()`](Self::new_trusted()).
+    unsafe fn create_bulk(
+        descriptor: &TopologyDescriptor,
+        sys_options: sys::far::topology_refiner::TopologyRefinerFactoryOptions,
+    ) -> Result<Self> {
+        let sys_descriptor = descriptor.as_sys();
+        let ptr = instrument::stage(Stage::RefinerCreation, 0, || unsafe {
+            sys::far::topology_refiner::TopologyRefinerFactory_TopologyDescriptor_CreateBulk(
+                &sys_descriptor as _,
+                sys_options,
+            )
+        });
 
         if ptr.is_null() {
             Err(Error::CreateTopologyRefinerFailed)
@@ -264,9 +316,10 @@ impl TopologyRefiner {
                 options.full_topology_in_last_level as _,
             );
 
-        unsafe {
+        instrument::stage(Stage::UniformRefinement, 0, || unsafe {
             (*self.0).RefineUniform(sys_options);
-        }
+        });
+        instrument::levels(|| self.level_records());
     }
 
     /// Refine the topology adaptively.
@@ -306,9 +359,25 @@ impl TopologyRefiner {
             _phantom_0: std::marker::PhantomData,
         };
 
-        unsafe {
+        instrument::stage(Stage::AdaptiveRefinement, 0, || unsafe {
             (*self.0).RefineAdaptive(sys_options, const_array);
-        }
+        });
+        instrument::levels(|| self.level_records());
+    }
+
+    // AIDEV-NOTE: OpenSubdiv refines all levels in one call, so levels are
+    // reported by size only; their times are not separable.
+    fn level_records(&self) -> Vec<LevelRecord> {
+        (0..=self.max_level())
+            .filter_map(|level| {
+                self.level(level).map(|topology| LevelRecord {
+                    level,
+                    vertex_count: topology.vertex_count(),
+                    face_count: topology.face_count(),
+                    edge_count: topology.edge_count(),
+                })
+            })
+            .collect()
     }
 
     /// Unrefine the topology, keeping only the base level.
@@ -405,6 +474,43 @@ impl Default for TopologyRefinerOptions {
     }
 }
 
+/// How thoroughly [`TopologyRefiner::with_validation()`] checks a
+/// descriptor.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq, Hash)]
+pub enum TopologyValidation {
+    /// Check that every index refers to an existing component, in parallel
+    /// when the `rayon` feature is enabled.
+    #[default]
+    Indices,
+    /// Additionally run *OpenSubdiv*'s full topology validation, which
+    /// reports e.g. non-manifold or degenerate components.
+    Full,
+}
+
+/// Converts `options` into the options of the refiner factory.
+fn factory_options(
+    options: TopologyRefinerOptions,
+) -> sys::far::topology_refiner::TopologyRefinerFactoryOptions {
+    let sdc_options = sys::sdc::Options {
+        _vtxBoundInterp: match options.boundary_interpolation {
+            Some(interp) => interp as _,
+            None => sys::far::topology_refiner::VTX_BOUNDARY_NONE,
+        },
+        _fvarLinInterp: match options.face_varying_linear_interpolation {
+            Some(interp) => interp as _,
+            None => sys::far::topology_refiner::FVAR_LINEAR_NONE,
+        },
+        _creasingMethod: options.creasing_method as _,
+        _triangleSub: options.triangle_subdivision as _,
+    };
+
+    let mut sys_options: sys::far::topology_refiner::TopologyRefinerFactoryOptions =
+        unsafe { std::mem::zeroed() };
+    sys_options.schemeType = options.scheme as _;
+    sys_options.schemeOptions = sdc_options;
+    sys_options
+}
+
 /// Uniform topology refinement options.
 #[repr(C)]
 #[derive(Copy, Clone, Debug)]
@@ -5,6 +5,10 @@
 //! rational B-spline surface.
 
 use crate::far::{PatchTable, PatchType};
+use crate::Index;
+#[cfg(feature = "rayon")]
+use rayon::prelude::*;
+use std::fmt::Write as _;
 use std::io::{self, Write};
 
 /// Error type for IGES export
@@ -121,20 +125,6 @@ impl<W: Write> IgesWriter<W> {
         Ok(de_number)
     }
 
-    /// Write a Parameter Data (P) line
-    fn write_parameter_line(&mut self, de_pointer: i32, line: &str) -> io::Result<()> {
-        // Parameter lines: 64 chars data + space + 8 chars DE pointer + P + 7 chars
-        // sequence
-        let padded_line = format!("{line:<64}");
-        writeln!(
-            self.writer,
-            "{} {:7}P{:7}",
-            padded_line, de_pointer, self.sequence
-        )?;
-        self.sequence += 1;
-        Ok(())
-    }
-
     /// Write the Terminate section (T)
     fn write_terminate(
         &mut self,
@@ -192,13 +182,161 @@ impl DirectoryEntry {
     }
 }
 
+/// Characters of parameter data per Parameter Data (P) line.
+const PARAMETER_LINE_DATA: usize = 64;
+
+/// Patches whose parameter data is formatted before it is written.
+///
+/// Bounds the memory held by formatted records independently of the patch
+/// count.
+const PATCHES_PER_BATCH: usize = 4096;
+
+/// Patches formatted into one buffer by one worker.
+#[cfg(feature = "rayon")]
+const PATCHES_PER_BLOCK: usize = 64;
+
+/// Uniform cubic knot vector of every exported surface.
+const KNOTS: [f64; 8] = [-3.0, -2.0, -1.0, 0.0, 1.0, 2.0, 3.0, 4.0];
+
+/// Control vertices of every regular patch, in export order.
+fn regular_patches(patch_table: &PatchTable) -> Vec<&[Index]> {
+    const REGULAR_PATCH_SIZE: usize = 16; // 4x4 control points
+
+    let mut patches = Vec::new();
+    for array_idx in 0..patch_table.patch_array_count() {
+        if let Some(desc) = patch_table.patch_array_descriptor(array_idx) {
+            if desc.patch_type() != PatchType::Regular {
+                continue;
+            }
+
+            let num_patches = patch_table.patch_array_patch_count(array_idx);
+            if let Some(cv_indices) = patch_table.patch_array_vertices(array_idx) {
+                patches.extend((0..num_patches).map(|patch_idx| {
+                    let start = patch_idx * REGULAR_PATCH_SIZE;
+                    &cv_indices[start..start + REGULAR_PATCH_SIZE]
+                }));
+            }
+        }
+    }
+    patches
+}
+
+/// Format the entity 128 parameter data of one regular patch into `line`.
+fn format_bspline_parameters(
+    line: &mut String,
+    patch_cvs: &[Index],
+    control_points: &[[f32; 3]],
+) -> Result<()> {
+    // Entity 128: Rational B-Spline Surface
+    // Format: 128,K1,K2,M1,M2,PROP1,PROP2,PROP3,PROP4,PROP5,
+    //         S(1),S(2),...,S(K1+K2+2),
+    //         T(1),T(2),...,T(M1+M2+2),
+    //         W(1,1),W(1,2),...,W(K2+1,M2+1),
+    //         X(1,1),X(1,2),...,X(K2+1,M2+1),
+    //         Y(1,1),Y(1,2),...,Y(K2+1,M2+1),
+    //         Z(1,1),Z(1,2),...,Z(K2+1,M2+1),
+    //         U0,U1,V0,V1;
+
+    let k1 = 3; // upper index of control points in u (0-based, so 4 points)
+    let k2 = 3; // upper index of control points in v
+    let m1 = 3; // degree in u
+    let m2 = 3; // degree in v
+
+    // PROP1 = 0: polynomial (non-rational), 1: rational
+    // PROP2 = 0: non-periodic in u, 1: periodic in u
+    // PROP3 = 0: non-periodic in v, 1: periodic in v
+    // PROP4 = 0: non-uniform knots in u, 1: uniform knots in u
+    // PROP5 = 0: non-uniform knots in v, 1: uniform knots in v
+    // Writing to a `String` cannot fail.
+    let _ = write!(line, "128,{k1},{k2},{m1},{m2},0,0,0,1,1,");
+
+    // U and V knot vectors: -3,-2,-1,0,1,2,3,4
+    for knot in KNOTS.iter().chain(&KNOTS) {
+        let _ = write!(line, "{knot},");
+    }
+
+    // Weights (all 1.0 for non-rational)
+    for _ in 0..16 {
+        line.push_str("1.0,");
+    }
+
+    // Control points X, Y, Z coordinates
+    // Control points are in row-major order (V varies fastest)
+    // Write X, Y, Z coordinates separately as required by IGES format
+    for coord_idx in 0..3 {
+        for cv in patch_cvs.iter().take(16) {
+            let cp = control_points
+                .get(cv.0 as usize)
+                .ok_or(IgesExportError::InvalidControlPoints)?;
+            let _ = write!(line, "{:.6},", cp[coord_idx]);
+        }
+    }
+
+    // Parameter range [U0,U1,V0,V1]
+    // Using the actual evaluation range for the surface
+    line.push_str("0.0,1.0,0.0,1.0;");
+    Ok(())
+}
+
+/// Number of Parameter Data lines the formatted `record` spans.
+fn parameter_line_count(record: &str) -> usize {
+    record.len().div_ceil(PARAMETER_LINE_DATA)
+}
+
+/// Where the parameter data of every patch goes.
+struct ParameterLayout {
+    /// Sequence number of the first Directory Entry.
+    d_start: i32,
+    /// Sequence number of the first Parameter Data line.
+    p_start: i32,
+    /// Parameter Data lines before each patch's record; one extra trailing
+    /// entry holds the total.
+    line_offsets: Vec<usize>,
+}
+
+impl ParameterLayout {
+    /// Format the Parameter Data lines of `patches`, the first of which is
+    /// patch `first_patch`.
+    fn render(
+        &self,
+        patches: &[&[Index]],
+        first_patch: usize,
+        control_points: &[[f32; 3]],
+    ) -> Result<Vec<u8>> {
+        let mut out = Vec::new();
+        let mut record = String::new();
+        for (i, patch_cvs) in (first_patch..).zip(patches) {
+            record.clear();
+            format_bspline_parameters(&mut record, patch_cvs, control_points)?;
+
+            let de_pointer = self.d_start + i as i32 * 2;
+            let mut sequence = self.p_start + self.line_offsets[i] as i32;
+            // Records are ASCII, so byte offsets are character boundaries.
+            for start in (0..record.len()).step_by(PARAMETER_LINE_DATA) {
+                let line = &record[start..(start + PARAMETER_LINE_DATA).min(record.len())];
+                // Parameter lines: 64 chars data + space + 8 chars DE pointer + P + 7
+                // chars sequence
+                writeln!(out, "{line:<64} {de_pointer:7}P{sequence:7}")?;
+                sequence += 1;
+            }
+        }
+        Ok(out)
+    }
+}
+
 /// Export OpenSubdiv patches as B-spline surfaces to IGES format
+///
+/// Output is streamed: the size of every patch's parameter data is measured
+/// first so the Directory section can be written up front, then records are
+/// formatted in batches (in parallel with the `rayon` feature) and written in
+/// order. Memory use does not grow with the patch count beyond one entry per
+/// patch.
 pub fn export_patches_as_iges<W: Write>(
     writer: &mut W,
     patch_table: &PatchTable,
     control_points: &[[f32; 3]],
 ) -> Result<()> {
-    let mut iges = IgesWriter::new(writer);
+    let mut iges = IgesWriter::new(io::BufWriter::new(writer));
 
     // Start section
     iges.write_start_line("OpenSubdiv B-spline Surface Export")?;
@@ -214,132 +352,83 @@ pub fn export_patches_as_iges<W: Write>(
     iges.write_global_line("0.001,1000.0,6HAuthor,10HOpenSubdiv,11,0,15H20250126.120000;")?;
     let g_count = iges.sequence - s_count - 1;
 
-    // Track directory and parameter counts
-    let mut d_count = 0;
+    let patches = regular_patches(patch_table);
+
+    // Measure every record, validating its control points on the way.
+    let measure = |record: &mut String, patch_cvs: &&[Index]| {
+        record.clear();
+        format_bspline_parameters(record, patch_cvs, control_points)?;
+        Ok(parameter_line_count(record))
+    };
+    #[cfg(feature = "rayon")]
+    let line_counts = patches
+        .par_iter()
+        .map_init(String::new, measure)
+        .collect::<Result<Vec<_>>>()?;
+    #[cfg(not(feature = "rayon"))]
+    let line_counts = {
+        let mut record = String::new();
+        patches
+            .iter()
+            .map(|patch_cvs| measure(&mut record, patch_cvs))
+            .collect::<Result<Vec<_>>>()?
+    };
+
+    // Prefix sum of the line counts gives every record's position.
+    let mut line_offsets = Vec::with_capacity(line_counts.len() + 1);
     let mut p_count = 0;
-    let mut parameter_data = Vec::new();
-    let mut directory_entries = Vec::new();
-
-    // Process patches
-    let mut _patch_global_idx = 0;
-    for array_idx in 0..patch_table.patch_array_count() {
-        if let Some(desc) = patch_table.patch_array_descriptor(array_idx) {
-            if desc.patch_type() != PatchType::Regular {
-                continue;
-            }
-
-            let num_patches = patch_table.patch_array_patch_count(array_idx);
-            if let Some(cv_indices) = patch_table.patch_array_vertices(array_idx) {
-                const REGULAR_PATCH_SIZE: usize = 16; // 4x4 control points
-
-                for patch_idx in 0..num_patches {
-                    let start = patch_idx * REGULAR_PATCH_SIZE;
-                    let patch_cvs = &cv_indices[start..start + REGULAR_PATCH_SIZE];
-
-                    // Build parameter data for this surface
-                    let mut param_lines = Vec::new();
-
-                    // Entity 128: Rational B-Spline Surface
-                    // Format: 128,K1,K2,M1,M2,PROP1,PROP2,PROP3,PROP4,PROP5,
-                    //         S(1),S(2),...,S(K1+K2+2),
-                    //         T(1),T(2),...,T(M1+M2+2),
-                    //         W(1,1),W(1,2),...,W(K2+1,M2+1),
-                    //         X(1,1),X(1,2),...,X(K2+1,M2+1),
-                    //         Y(1,1),Y(1,2),...,Y(K2+1,M2+1),
-                    //         Z(1,1),Z(1,2),...,Z(K2+1,M2+1),
-                    //         U0,U1,V0,V1;
-
-                    let k1 = 3; // upper index of control points in u (0-based, so 4 points)
-                    let k2 = 3; // upper index of control points in v
-                    let m1 = 3; // degree in u
-                    let m2 = 3; // degree in v
-
-                    // PROP1 = 0: polynomial (non-rational), 1: rational
-                    // PROP2 = 0: non-periodic in u, 1: periodic in u
-                    // PROP3 = 0: non-periodic in v, 1: periodic in v
-                    // PROP4 = 0: non-uniform knots in u, 1: uniform knots in u
-                    // PROP5 = 0: non-uniform knots in v, 1: uniform knots in v
-                    let mut line = format!("128,{k1},{k2},{m1},{m2},0,0,0,1,1,");
-
-                    // U knot vector: -3,-2,-1,0,1,2,3,4
-                    let u_knots = vec![-3.0, -2.0, -1.0, 0.0, 1.0, 2.0, 3.0, 4.0];
-                    for knot in &u_knots {
-                        line.push_str(&format!("{knot},"));
-                    }
-
-                    // V knot vector: -3,-2,-1,0,1,2,3,4
-                    let v_knots = vec![-3.0, -2.0, -1.0, 0.0, 1.0, 2.0, 3.0, 4.0];
-                    for knot in &v_knots {
-                        line.push_str(&format!("{knot},"));
-                    }
-
-                    // Weights (all 1.0 for non-rational)
-                    for _ in 0..16 {
-                        line.push_str("1.0,");
-                    }
-
-                    // Control points X, Y, Z coordinates
-                    // Control points are in row-major order (V varies fastest)
-                    // Write X, Y, Z coordinates separately as required by IGES format
-                    for coord_idx in 0..3 {
-                        for cv in patch_cvs.iter().take(16) {
-                            let cv_idx = cv.0 as usize;
-                            if cv_idx >= control_points.len() {
-                                return Err(IgesExportError::InvalidControlPoints);
-                            }
-                            let cp = &control_points[cv_idx];
-                            line.push_str(&format!("{:.6},", cp[coord_idx]));
-                        }
-                    }
-
-                    // Parameter range [U0,U1,V0,V1]
-                    // Using the actual evaluation range for the surface
-                    line.push_str("0.0,1.0,0.0,1.0;");
-
-                    // Split into 64-character chunks for parameter section
-                    let mut param_chars = line.chars().collect::<Vec<_>>();
-                    while !param_chars.is_empty() {
-                        let chunk_size = param_chars.len().min(64);
-                        let chunk: String = param_chars.drain(..chunk_size).collect();
-                        param_lines.push(chunk);
-                    }
-
-                    // Create directory entry
-                    // Parameter pointer must point to the correct sequence number in P section
-                    // P section starts after S, G, and D sections
-                    let param_pointer = s_count + g_count + d_count + p_count + 1;
-                    let entry =
-                        DirectoryEntry::bspline_surface(param_pointer, param_lines.len() as i32);
-
-                    directory_entries.push(entry);
-                    let param_lines_len = param_lines.len();
-                    parameter_data.push(param_lines);
-
-                    p_count += param_lines_len as i32;
-                    d_count += 2; // Each directory entry takes 2 lines
-
-                    _patch_global_idx += 1;
-                }
-            }
-        }
+    line_offsets.push(0);
+    for &count in &line_counts {
+        p_count += count;
+        line_offsets.push(p_count);
     }
+    drop(line_counts);
 
     // Write Directory section
+    // Parameter pointer must point to the correct sequence number in P section
+    // P section starts after S, G, and D sections
     let d_start = iges.sequence;
-    for entry in &directory_entries {
-        iges.write_directory_entry(entry)?;
+    for (i, window) in line_offsets.windows(2).enumerate() {
+        let param_pointer = s_count + g_count + i as i32 * 2 + window[0] as i32 + 1;
+        let entry = DirectoryEntry::bspline_surface(param_pointer, (window[1] - window[0]) as i32);
+        iges.write_directory_entry(&entry)?;
     }
+    let d_count = iges.sequence - d_start; // Each directory entry takes 2 lines
 
     // Write Parameter section
-    for (i, param_lines) in parameter_data.iter().enumerate() {
-        let de_pointer = d_start + i as i32 * 2;
-        for line in param_lines {
-            iges.write_parameter_line(de_pointer, line)?;
+    let layout = ParameterLayout {
+        d_start,
+        p_start: iges.sequence,
+        line_offsets,
+    };
+    for (batch_idx, batch) in patches.chunks(PATCHES_PER_BATCH).enumerate() {
+        let first_patch = batch_idx * PATCHES_PER_BATCH;
+
+        #[cfg(feature = "rayon")]
+        let blocks = batch
+            .par_chunks(PATCHES_PER_BLOCK)
+            .enumerate()
+            .map(|(block_idx, block)| {
+                layout.render(
+                    block,
+                    first_patch + block_idx * PATCHES_PER_BLOCK,
+                    control_points,
+                )
+            })
+            .collect::<Result<Vec<_>>>()?;
+        #[cfg(not(feature = "rayon"))]
+        let blocks = [layout.render(batch, first_patch, control_points)?];
+
+        for block in &blocks {
+            iges.writer.write_all(block)?;
         }
     }
+    let p_count = p_count as i32;
+    iges.sequence += p_count;
 
     // Terminate section
     iges.write_terminate(s_count, g_count, d_count, p_count)?;
+    iges.writer.flush()?;
 
     Ok(())
 }
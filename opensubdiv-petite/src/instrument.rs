@@ -0,0 +1,417 @@
+//! Opt-in instrumentation of the refinement and evaluation pipeline.
+//!
+//! Wrap the work on a mesh in [`record()`] to get a [`Report`] of how long
+//! each stage took, how often it crossed into *OpenSubdiv*, how much memory
+//! the tables it built hold and how large each refinement level came out:
+//!
+//! ```no_run
+//! # use opensubdiv_petite::far::*;
+//! # fn example(descriptor: TopologyDescriptor) -> opensubdiv_petite::Result<()> {
+//! let (table, report) = opensubdiv_petite::instrument::record(|| {
+//!     let mut refiner = TopologyRefiner::new(descriptor, Default::default())?;
+//!     refiner.refine_uniform(UniformRefinementOptions::default());
+//!     StencilTable::new(&refiner, StencilTableOptions::default())
+//! });
+//! let _table = table?;
+//! println!("{report}");
+//! std::fs::write("report.json", report.to_json()).ok();
+//! # Ok(())
+//! # }
+//! ```
+//!
+//! Outside of [`record()`] the probes cost a thread-local lookup each. With
+//! the `tracing` feature every stage also opens a `tracing` span, and table
+//! footprints are emitted as `DEBUG` events, whether or not a report is
+//! being recorded.
+//!
+//! Reports are per thread: stages run on other threads, e.g. the chunks of
+//! [`LimitStencilTable::new_chunked()`](crate::far::LimitStencilTable::new_chunked())
+//! built by `rayon`, only show up as part of the stage that spawned them.
+//! Stage times are inclusive, so a stage that builds another table, e.g. a
+//! limit stencil table building its patch table, contains that time too.
+use std::cell::RefCell;
+use std::fmt;
+use std::time::{Duration, Instant};
+
+/// A stage of the pipeline timed by [`record()`].
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Hash, PartialOrd, Ord)]
+pub enum Stage {
+    /// Building a [`TopologyRefiner`](crate::far::TopologyRefiner) from a
+    /// descriptor.
+    RefinerCreation,
+    /// [`TopologyRefiner::refine_uniform()`](crate::far::TopologyRefiner::refine_uniform()).
+    UniformRefinement,
+    /// [`TopologyRefiner::refine_adaptive()`](crate::far::TopologyRefiner::refine_adaptive()).
+    AdaptiveRefinement,
+    /// Building a [`StencilTable`](crate::far::StencilTable).
+    StencilTableFactory,
+    /// Building a [`LimitStencilTable`](crate::far::LimitStencilTable).
+    LimitStencilTableFactory,
+    /// Building a [`PatchTable`](crate::far::PatchTable).
+    PatchTableFactory,
+    /// Creating and filling GPU buffers.
+    GpuUpload,
+    /// Recording compute dispatches into a command encoder.
+    GpuEncode,
+    /// Submitting work and waiting for the device to finish it.
+    GpuWait,
+}
+
+impl Stage {
+    /// Returns the name of the stage as used in reports and spans.
+    pub fn name(self) -> &'static str {
+        match self {
+            Stage::RefinerCreation => "refiner_creation",
+            Stage::UniformRefinement => "uniform_refinement",
+            Stage::AdaptiveRefinement => "adaptive_refinement",
+            Stage::StencilTableFactory => "stencil_table_factory",
+            Stage::LimitStencilTableFactory => "limit_stencil_table_factory",
+            Stage::PatchTableFactory => "patch_table_factory",
+            Stage::GpuUpload => "gpu_upload",
+            Stage::GpuEncode => "gpu_encode",
+            Stage::GpuWait => "gpu_wait",
+        }
+    }
+}
+
+impl fmt::Display for Stage {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        f.write_str(self.name())
+    }
+}
+
+/// Bytes held by the arrays of a table.
+///
+/// Counts the element storage of the arrays only, not the allocator's
+/// overhead or spare capacity.
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct MemoryFootprint {
+    /// Stencil sizes.
+    pub sizes: usize,
+    /// Stencil offsets.
+    pub offsets: usize,
+    /// Control vertex indices, of stencils or patches.
+    pub indices: usize,
+    /// Stencil weights, including derivative weights.
+    pub weights: usize,
+    /// Per-patch parameterization.
+    pub patch_params: usize,
+    /// The stencils computing the local points of a patch table.
+    pub local_points: usize,
+}
+
+impl MemoryFootprint {
+    /// Returns the sum of all arrays, in bytes.
+    pub fn total(&self) -> usize {
+        self.sizes
+            + self.offsets
+            + self.indices
+            + self.weights
+            + self.patch_params
+            + self.local_points
+    }
+}
+
+/// Time spent in one [`Stage`].
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub struct StageRecord {
+    pub stage: Stage,
+    /// Number of times the stage ran, i.e. of calls into *OpenSubdiv* or
+    /// into the GPU API made for it.
+    pub calls: u64,
+    /// Total wall clock time of all calls.
+    pub elapsed: Duration,
+    /// Bytes moved by the stage, for uploads.
+    pub bytes: u64,
+}
+
+/// Size of one refinement level of a refiner.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub struct LevelRecord {
+    pub level: usize,
+    pub vertex_count: usize,
+    pub face_count: usize,
+    pub edge_count: usize,
+}
+
+/// Footprint of a table built in a [`Stage`].
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub struct TableRecord {
+    /// The stage that built the table.
+    pub stage: Stage,
+    pub footprint: MemoryFootprint,
+}
+
+/// What [`record()`] observed.
+#[derive(Clone, Debug, Default, PartialEq, Eq)]
+pub struct Report {
+    /// Stages in the order they first ran.
+    pub stages: Vec<StageRecord>,
+    /// Levels of each refinement, in the order the refinements ran.
+    pub levels: Vec<LevelRecord>,
+    /// Tables in the order they were built.
+    pub tables: Vec<TableRecord>,
+}
+
+impl Report {
+    /// Returns the record of `stage`, if it ran.
+    pub fn stage(&self, stage: Stage) -> Option<&StageRecord> {
+        self.stages.iter().find(|record| record.stage == stage)
+    }
+
+    /// Returns the number of calls made by all stages.
+    pub fn call_count(&self) -> u64 {
+        self.stages.iter().map(|record| record.calls).sum()
+    }
+
+    /// Returns the bytes held by all tables built.
+    pub fn table_bytes(&self) -> usize {
+        self.tables
+            .iter()
+            .map(|table| table.footprint.total())
+            .sum()
+    }
+
+    /// Returns the report as a JSON object.
+    ///
+    /// Times are in nanoseconds, sizes in bytes.
+    pub fn to_json(&self) -> String {
+        let stages = self
+            .stages
+            .iter()
+            .map(|record| {
+                format!(
+                    "{{\"stage\":\"{}\",\"calls\":{},\"nanos\":{},\"bytes\":{}}}",
+                    record.stage,
+                    record.calls,
+                    record.elapsed.as_nanos(),
+                    record.bytes
+                )
+            })
+            .collect::<Vec<_>>();
+        let levels = self
+            .levels
+            .iter()
+            .map(|level| {
+                format!(
+                    "{{\"level\":{},\"vertices\":{},\"faces\":{},\"edges\":{}}}",
+                    level.level, level.vertex_count, level.face_count, level.edge_count
+                )
+            })
+            .collect::<Vec<_>>();
+        let tables = self
+            .tables
+            .iter()
+            .map(|table| {
+                let footprint = &table.footprint;
+                format!(
+                    "{{\"stage\":\"{}\",\"sizes\":{},\"offsets\":{},\"indices\":{},\
+                     \"weights\":{},\"patch_params\":{},\"local_points\":{},\"total\":{}}}",
+                    table.stage,
+                    footprint.sizes,
+                    footprint.offsets,
+                    footprint.indices,
+                    footprint.weights,
+                    footprint.patch_params,
+                    footprint.local_points,
+                    footprint.total()
+                )
+            })
+            .collect::<Vec<_>>();
+        format!(
+            "{{\"stages\":[{}],\"levels\":[{}],\"tables\":[{}]}}",
+            stages.join(","),
+            levels.join(","),
+            tables.join(",")
+        )
+    }
+
+    fn add_stage(&mut self, stage: Stage, elapsed: Duration, bytes: u64) {
+        match self.stages.iter_mut().find(|record| record.stage == stage) {
+            Some(record) => {
+                record.calls += 1;
+                record.elapsed += elapsed;
+                record.bytes += bytes;
+            }
+            None => self.stages.push(StageRecord {
+                stage,
+                calls: 1,
+                elapsed,
+                bytes,
+            }),
+        }
+    }
+
+    fn merge(&mut self, other: &Report) {
+        for record in &other.stages {
+            match self.stages.iter_mut().find(|r| r.stage == record.stage) {
+                Some(r) => {
+                    r.calls += record.calls;
+                    r.elapsed += record.elapsed;
+                    r.bytes += record.bytes;
+                }
+                None => self.stages.push(*record),
+            }
+        }
+        self.levels.extend_from_slice(&other.levels);
+        self.tables.extend_from_slice(&other.tables);
+    }
+}
+
+impl fmt::Display for Report {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        for record in &self.stages {
+            writeln!(
+                f,
+                "{:<28} {:>6} calls {:>12.3} ms {:>12} bytes",
+                record.stage.name(),
+                record.calls,
+                record.elapsed.as_secs_f64() * 1e3,
+                record.bytes
+            )?;
+        }
+        for level in &self.levels {
+            writeln!(
+                f,
+                "level {:<2} {:>10} vertices {:>10} faces {:>10} edges",
+                level.level, level.vertex_count, level.face_count, level.edge_count
+            )?;
+        }
+        for table in &self.tables {
+            writeln!(
+                f,
+                "{:<28} {:>12} bytes",
+                table.stage.name(),
+                table.footprint.total()
+            )?;
+        }
+        Ok(())
+    }
+}
+
+thread_local! {
+    static RECORDER: RefCell<Option<Report>> = const { RefCell::new(None) };
+}
+
+/// Run `f`, recording a [`Report`] of the instrumented stages it runs on
+/// this thread.
+///
+/// Calls may be nested; an inner report is also added to the outer one.
+pub fn record<R>(f: impl FnOnce() -> R) -> (R, Report) {
+    let mut scope = Scope {
+        outer: Some(RECORDER.with(|r| r.replace(Some(Report::default())))),
+    };
+    let result = f();
+    (result, scope.finish())
+}
+
+/// Restores the enclosing recorder, also if the recorded closure panics.
+struct Scope {
+    outer: Option<Option<Report>>,
+}
+
+impl Scope {
+    fn finish(&mut self) -> Report {
+        let mut outer = self.outer.take().flatten();
+        let report = RECORDER.with(|r| r.replace(None)).unwrap_or_default();
+        if let Some(outer) = outer.as_mut() {
+            outer.merge(&report);
+        }
+        RECORDER.with(|r| r.replace(outer));
+        report
+    }
+}
+
+impl Drop for Scope {
+    fn drop(&mut self) {
+        if let Some(outer) = self.outer.take() {
+            RECORDER.with(|r| r.replace(outer));
+        }
+    }
+}
+
+#[inline]
+pub(crate) fn is_recording() -> bool {
+    RECORDER.with(|r| r.borrow().is_some())
+}
+
+fn with_report(f: impl FnOnce(&mut Report)) {
+    RECORDER.with(|r| {
+        if let Some(report) = r.borrow_mut().as_mut() {
+            f(report);
+        }
+    });
+}
+
+/// Time `f` as one call of `stage` that moves `bytes`.
+#[inline]
+pub(crate) fn stage<R>(stage: Stage, bytes: usize, f: impl FnOnce() -> R) -> R {
+    let _timer = Timer::start(stage, bytes);
+    f()
+}
+
+/// Times one call of a stage until it is dropped, for stages spanning a
+/// whole function body.
+pub(crate) struct Timer {
+    stage: Stage,
+    bytes: u64,
+    start: Option<Instant>,
+    #[cfg(feature = "tracing")]
+    _span: tracing::span::EnteredSpan,
+}
+
+impl Timer {
+    #[inline]
+    pub(crate) fn start(stage: Stage, bytes: usize) -> Self {
+        Self {
+            stage,
+            bytes: bytes as u64,
+            #[cfg(feature = "tracing")]
+            _span: tracing::info_span!("opensubdiv", stage = stage.name(), bytes = bytes as u64)
+                .entered(),
+            start: is_recording().then(Instant::now),
+        }
+    }
+}
+
+impl Drop for Timer {
+    fn drop(&mut self) {
+        if let Some(start) = self.start {
+            let elapsed = start.elapsed();
+            with_report(|report| report.add_stage(self.stage, elapsed, self.bytes));
+        }
+    }
+}
+
+/// Record the footprint of a table built in `stage`.
+///
+/// `footprint` is only called if someone is listening.
+pub(crate) fn table(stage: Stage, footprint: impl FnOnce() -> MemoryFootprint) {
+    let recording = is_recording();
+    #[cfg(feature = "tracing")]
+    let traced = tracing::enabled!(tracing::Level::DEBUG);
+    #[cfg(not(feature = "tracing"))]
+    let traced = false;
+    if !(recording || traced) {
+        return;
+    }
+
+    let footprint = footprint();
+    #[cfg(feature = "tracing")]
+    tracing::debug!(
+        stage = stage.name(),
+        bytes = footprint.total() as u64,
+        "table footprint"
+    );
+    if recording {
+        with_report(|report| report.tables.push(TableRecord { stage, footprint }));
+    }
+}
+
+/// Record the levels of a refinement, if a report is being recorded.
+pub(crate) fn levels(levels: impl FnOnce() -> Vec<LevelRecord>) {
+    if is_recording() {
+        let levels = levels();
+        with_report(|report| report.levels.extend(levels));
+    }
+}
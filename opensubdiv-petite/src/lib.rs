@@ -86,6 +86,29 @@
 //! )?;
 //! ```
 //!
+//! For animated meshes, a `StencilEvalContext` keeps the uploaded table, the
+//! coarse and refined vertex buffers and the bind group alive across frames.
+//! Only the deformed control vertices are written per frame, and any number
+//! of contexts are evaluated in one compute pass:
+//!
+//! ```rust,ignore
+//! let context = StencilEvalContext::new(&device, &pipeline, &stencil_table, desc, desc)?;
+//!
+//! // Every frame.
+//! context.update_control_vertices(&queue, &deformed_positions, 0)?;
+//! pipeline.encode_contexts(&mut encoder, [&context]);
+//! ```
+//!
+//! Many small meshes can be packed into one context with
+//! `StencilEvalContext::new_batched()`, which rebases their stencils onto
+//! shared buffers and evaluates all of them with a single dispatch.
+//!
+//! Where memory bandwidth matters more than the last bits of precision,
+//! `CompactStencilTableGpu` stores weights as `f16` and control indices as
+//! `u16` relative to each stencil's lowest index, at a little over half the
+//! size. Its `report` bounds the error against the `f32` path; evaluate it
+//! with a `CompactStencilEvalPipeline`.
+//!
 //! ## Cargo Features
 #![doc = document_features::document_features!()]
 //!
@@ -102,6 +125,7 @@
 pub mod bfr;
 pub mod error;
 pub mod far;
+pub mod instrument;
 pub mod osd;
 
 // Re-export error types for convenience
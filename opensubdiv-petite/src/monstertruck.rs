@@ -14,7 +14,7 @@ use monstertruck::modeling::{
 };
 #[cfg(feature = "rayon")]
 use rayon::prelude::*;
-use std::{convert::TryFrom, panic};
+use std::{convert::TryFrom, panic, sync::OnceLock};
 use thiserror::Error;
 
 /// Type alias for results in this module.
@@ -170,28 +170,22 @@ impl From<StepExportOptions> for MonstertruckShellOptions {
     }
 }
 
-/// Apply OpenSubdiv regular-patch boundary adjustments to control points.
+/// Sparse transpose of the boundary weight transform of one boundary mask:
+/// for every exported control point, the source control points it blends
+/// and their weights, in ascending source order.
+type BoundaryTransform = [Vec<(usize, f64)>; 16];
+
+/// Build the control point transform for `boundary_mask`.
 ///
 /// OpenSubdiv evaluates regular patches by first computing uniform bicubic
 /// B-spline weights, then applying `adjustBSplineBoundaryWeights` based on the
 /// boundary mask (see far/patchBasis.cpp). To export an equivalent surface
 /// using the plain uniform basis, we transpose that weight transform and apply
 /// it to the control points instead.
-fn adjust_regular_control_points(
-    control_matrix: Vec<Vec<Point3>>,
-    boundary_mask: i32,
-) -> Vec<Vec<Point3>> {
-    if boundary_mask == 0 {
-        return control_matrix;
-    }
-
-    // Flatten 4×4 control matrix in the same order as OpenSubdiv weights:
+fn build_boundary_transform(boundary_mask: i32) -> BoundaryTransform {
+    // Control points are flattened in the same order as OpenSubdiv weights:
     // w[4*i + j] = sWeights[j] * tWeights[i], where i is v-row, j is u-col.
-    let cps: Vec<_> = control_matrix
-        .iter()
-        .flat_map(|row| row.iter().copied())
-        .collect();
-
+    //
     // Build transformation matrix (16×16) starting as identity, then run the
     // same boundary adjustments on its rows as adjustBSplineBoundaryWeights.
     let mut trans = [[0.0f64; 16]; 16];
@@ -247,30 +241,55 @@ fn adjust_regular_control_points(
         }
     }
 
-    // Apply transpose(trans) to control points: P' = trans^T * P.
-    let mut new_cps = vec![Point3::origin(); 16];
-    for new_idx in 0..16 {
-        let mut acc = Point3::origin();
-        for old_idx in 0..16 {
-            let w = trans[old_idx][new_idx];
-            if w != 0.0 {
-                let p = cps[old_idx];
-                acc.x += p.x * w;
-                acc.y += p.y * w;
-                acc.z += p.z * w;
-            }
-        }
-        new_cps[new_idx] = acc;
-    }
+    // Keep the non-zero entries of transpose(trans): P' = trans^T * P.
+    std::array::from_fn(|new_idx| {
+        (0..16)
+            .filter_map(|old_idx| {
+                let w = trans[old_idx][new_idx];
+                (w != 0.0).then_some((old_idx, w))
+            })
+            .collect()
+    })
+}
 
-    // Unflatten back to 4×4.
-    let mut adjusted = vec![vec![Point3::origin(); 4]; 4];
-    for row in 0..4 {
-        for col in 0..4 {
-            adjusted[row][col] = new_cps[row * 4 + col];
-        }
+/// Returns the transform of `boundary_mask`.
+///
+/// Only the four edge bits take part, so the transforms of all 16 masks are
+/// built once and shared by every patch.
+fn boundary_transform(boundary_mask: i32) -> &'static BoundaryTransform {
+    static TRANSFORMS: OnceLock<[BoundaryTransform; 16]> = OnceLock::new();
+    &TRANSFORMS.get_or_init(|| std::array::from_fn(|mask| build_boundary_transform(mask as i32)))
+        [(boundary_mask & 0b1111) as usize]
+}
+
+/// Apply OpenSubdiv regular-patch boundary adjustments to control points.
+///
+/// See [`build_boundary_transform()`].
+fn adjust_regular_control_points(
+    control_matrix: Vec<Vec<Point3>>,
+    boundary_mask: i32,
+) -> Vec<Vec<Point3>> {
+    if boundary_mask == 0 {
+        return control_matrix;
     }
-    adjusted
+
+    let transform = boundary_transform(boundary_mask);
+    (0..4)
+        .map(|row| {
+            (0..4)
+                .map(|col| {
+                    let mut acc = Point3::origin();
+                    for &(old_idx, w) in &transform[row * 4 + col] {
+                        let p = control_matrix[old_idx / 4][old_idx % 4];
+                        acc.x += p.x * w;
+                        acc.y += p.y * w;
+                        acc.z += p.z * w;
+                    }
+                    acc
+                })
+                .collect()
+        })
+        .collect()
 }
 
 /// A wrapper around a single patch with its associated data
@@ -319,6 +338,24 @@ impl<'a> PatchRef<'a> {
         matches!(self.patch_type(), Ok(PatchType::Regular))
     }
 
+    /// Map patch-local `(u, v)` to the face coordinates expected by
+    /// [`PatchTable::evaluate_point()`].
+    fn face_uv(&self, u: f32, v: f32) -> (f32, f32) {
+        self.patch_info()
+            .ok()
+            .and_then(|(array_index, local_index, patch_type)| {
+                self.patch_table
+                    .patch_param(array_index, local_index)
+                    .map(|param| match patch_type {
+                        PatchType::Loop | PatchType::GregoryTriangle => {
+                            param.unnormalize_triangle(u, v)
+                        }
+                        _ => param.unnormalize(u, v),
+                    })
+            })
+            .unwrap_or((u, v))
+    }
+
     /// Get the boundary mask for this patch.
     ///
     /// Returns a bitmask indicating which edges are boundaries (including
@@ -360,23 +397,35 @@ impl<'a> PatchRef<'a> {
 
     /// Extract control points for this patch
     fn control_points(&self) -> std::result::Result<Vec<Vec<Point3>>, MonstertruckError> {
+        self.control_points_cached(None)
+    }
+
+    /// Extract control points for this patch, taking Gregory sample weights
+    /// from `cache` if it has them.
+    fn control_points_cached(
+        &self,
+        cache: Option<&SampleWeightCache>,
+    ) -> std::result::Result<Vec<Vec<Point3>>, MonstertruckError> {
         let (array_index, local_index, patch_type) = self.patch_info()?;
         let boundary_mask = self.boundary_mask();
 
         // AIDEV-NOTE: Gregory patch support
         // Currently we only support Regular B-spline patches and Gregory patches.
         // Gregory patches are used at extraordinary vertices (valence != 4).
-        // For now, we approximate Gregory patches as B-spline patches.
+        // For now, we approximate Gregory patches as B-spline patches by
+        // sampling them at a 4x4 grid, see `sample_uv()`.
         match patch_type {
             PatchType::Regular => {
                 self.extract_regular_patch_control_points(array_index, local_index, boundary_mask)
             }
-            PatchType::GregoryBasis => {
-                self.extract_gregory_basis_patch_control_points(array_index, local_index)
-            }
-            PatchType::GregoryTriangle => {
-                self.extract_gregory_triangle_patch_control_points(array_index, local_index)
-            }
+            PatchType::GregoryBasis | PatchType::GregoryTriangle => self.sample_grid(
+                SampleKey {
+                    patch_type,
+                    boundary_mask,
+                    high_precision: false,
+                },
+                cache,
+            ),
             _ => Err(MonstertruckError::UnsupportedPatchType(patch_type)),
         }
     }
@@ -448,96 +497,109 @@ impl<'a> PatchRef<'a> {
         Ok(adjust_regular_control_points(control_matrix, boundary_mask))
     }
 
-    /// Extract control points for a Gregory basis patch (20 control points)
-    fn extract_gregory_basis_patch_control_points(
-        &self,
-        _array_index: usize,
-        _local_index: usize,
-    ) -> std::result::Result<Vec<Vec<Point3>>, MonstertruckError> {
-        // AIDEV-NOTE: Gregory basis patch approximation
-        // Gregory basis patches have 20 control points arranged in a special pattern.
-        // For now, we evaluate the patch at a 4x4 grid to create an approximation.
-        // This is not ideal but allows us to export something at extraordinary
-        // vertices.
-
-        // Evaluate the patch at 16 points to create a 4x4 control point grid
-        let mut control_matrix = vec![vec![Point3::origin(); 4]; 4];
-
-        #[allow(clippy::needless_range_loop)]
-        for i in 0..4 {
-            for j in 0..4 {
-                // Map to parameter space [0,1]
-                let u = i as f32 / 3.0;
-                let v = j as f32 / 3.0;
-
-                // Evaluate the patch at this parameter location
-                if let Some(result) =
-                    self.patch_table
-                        .evaluate_point(self.patch_index, u, v, self.control_points)
-                {
-                    control_matrix[i][j] = Point3::new(
-                        result.point[0] as f64,
-                        result.point[1] as f64,
-                        result.point[2] as f64,
-                    );
-                } else {
-                    return Err(MonstertruckError::EvaluationFailed);
-                }
-            }
-        }
+    /// Returns the key of the sample weights this patch's conversion uses,
+    /// or `None` if it does not sample its basis.
+    fn sample_key(&self, high_precision: bool) -> Option<SampleKey> {
+        let patch_type = self.patch_type().ok()?;
+        matches!(
+            patch_type,
+            PatchType::GregoryBasis | PatchType::GregoryTriangle
+        )
+        .then(|| SampleKey {
+            patch_type,
+            boundary_mask: self.boundary_mask(),
+            high_precision,
+        })
+    }
 
-        Ok(control_matrix)
+    /// Evaluate the basis weights of this patch at the sample grid of `key`.
+    fn sample_weights(&self, key: SampleKey) -> Option<Vec<Vec<f32>>> {
+        let grid = key.grid_size();
+        (0..grid * grid)
+            .map(|sample| {
+                let (u, v) = sample_uv(key, sample / grid, sample % grid);
+                let (u, v) = self.face_uv(u, v);
+                self.patch_table
+                    .evaluate_basis(self.patch_index, u, v)
+                    .map(|(weights, ..)| weights)
+            })
+            .collect()
     }
 
-    /// Extract control points for a Gregory triangle patch (18 control points)
-    fn extract_gregory_triangle_patch_control_points(
+    /// Sample this patch at the grid of `key`, `grid[i][j]` holding the
+    /// sample at `sample_uv(key, i, j)`.
+    ///
+    /// With weights for `key` in `cache` the samples are blended from the
+    /// control points directly; otherwise every sample evaluates the patch
+    /// basis.
+    fn sample_grid(
         &self,
-        _array_index: usize,
-        _local_index: usize,
+        key: SampleKey,
+        cache: Option<&SampleWeightCache>,
     ) -> std::result::Result<Vec<Vec<Point3>>, MonstertruckError> {
-        // AIDEV-NOTE: Gregory triangle patch approximation
-        // Gregory triangle patches have 18 control points for triangular domains.
-        // For now, we evaluate the patch at a 4x4 grid to create a quad approximation.
-        // This converts the triangular patch to a degenerate quad patch.
-
-        // Evaluate the patch at 16 points to create a 4x4 control point grid
-        let mut control_matrix = vec![vec![Point3::origin(); 4]; 4];
+        let grid = key.grid_size();
+        if let Some(weights) = cache.and_then(|cache| cache.get(key)) {
+            let cvs = self
+                .patch_table
+                .patch_handle(self.patch_index)
+                .and_then(|handle| self.patch_table.patch_vertices(handle))
+                .ok_or(MonstertruckError::EvaluationFailed)?;
+            return weights
+                .chunks(grid)
+                .map(|row| {
+                    row.iter()
+                        .map(|w| self.blend(w, cvs))
+                        .collect::<std::result::Result<Vec<_>, _>>()
+                })
+                .collect();
+        }
 
-        #[allow(clippy::needless_range_loop)]
-        for i in 0..4 {
-            for j in 0..4 {
-                // For triangular patches, we need to ensure u + v <= 1
-                let u = i as f32 / 3.0;
-                let v = j as f32 / 3.0;
-
-                // If we're outside the triangular domain, collapse to the edge
-                let (u_eval, v_eval) = if u + v > 1.0 {
-                    // Project back onto the triangle edge
-                    let sum = u + v;
-                    (u / sum, v / sum)
-                } else {
-                    (u, v)
-                };
+        (0..grid)
+            .map(|i| {
+                (0..grid)
+                    .map(|j| {
+                        let (u, v) = sample_uv(key, i, j);
+                        let (u, v) = self.face_uv(u, v);
+                        self.patch_table
+                            .evaluate_point(self.patch_index, u, v, self.control_points)
+                            .map(|result| {
+                                Point3::new(
+                                    result.point[0] as f64,
+                                    result.point[1] as f64,
+                                    result.point[2] as f64,
+                                )
+                            })
+                            .ok_or(MonstertruckError::EvaluationFailed)
+                    })
+                    .collect::<Result<Vec<_>>>()
+            })
+            .collect()
+    }
 
-                // Evaluate the patch at this parameter location
-                if let Some(result) = self.patch_table.evaluate_point(
-                    self.patch_index,
-                    u_eval,
-                    v_eval,
-                    self.control_points,
-                ) {
-                    control_matrix[i][j] = Point3::new(
-                        result.point[0] as f64,
-                        result.point[1] as f64,
-                        result.point[2] as f64,
-                    );
-                } else {
-                    return Err(MonstertruckError::EvaluationFailed);
-                }
+    /// Blend the control points `cvs` of this patch with `weights`.
+    ///
+    /// Accumulates in `f32` in control vertex order, like
+    /// [`PatchTable::evaluate_point()`].
+    fn blend(
+        &self,
+        weights: &[f32],
+        cvs: &[crate::Index],
+    ) -> std::result::Result<Point3, MonstertruckError> {
+        if weights.len() != cvs.len() {
+            return Err(MonstertruckError::EvaluationFailed);
+        }
+        let mut acc = [0.0f32; 3];
+        for (&w, &cv) in weights.iter().zip(cvs) {
+            let idx: usize = cv.into();
+            let cp = self
+                .control_points
+                .get(idx)
+                .ok_or(MonstertruckError::InvalidControlPoints)?;
+            for k in 0..3 {
+                acc[k] += cp[k] * w;
             }
         }
-
-        Ok(control_matrix)
+        Ok(Point3::new(acc[0] as f64, acc[1] as f64, acc[2] as f64))
     }
 
     /// Convert a Gregory patch to a B-spline surface using high-precision
@@ -557,29 +619,22 @@ impl<'a> PatchRef<'a> {
     /// exactly represented as B-splines. However, the denser sampling captures
     /// more of the surface curvature at extraordinary vertices.
     pub fn to_bspline_high_precision(&self) -> Result<BsplineSurface<Point3>> {
-        const GRID_SIZE: usize = 8;
+        self.to_bspline_high_precision_cached(None)
+    }
 
+    /// Like [`to_bspline_high_precision()`](Self::to_bspline_high_precision()),
+    /// taking sample weights from `cache` if it has them.
+    fn to_bspline_high_precision_cached(
+        &self,
+        cache: Option<&SampleWeightCache>,
+    ) -> Result<BsplineSurface<Point3>> {
         // Evaluate the Gregory patch at an 8×8 grid.
-        let samples: Vec<Vec<Point3>> = (0..GRID_SIZE)
-            .map(|i| {
-                let u = i as f32 / (GRID_SIZE - 1) as f32;
-                (0..GRID_SIZE)
-                    .map(|j| {
-                        let v = j as f32 / (GRID_SIZE - 1) as f32;
-                        self.patch_table
-                            .evaluate_point(self.patch_index, u, v, self.control_points)
-                            .map(|result| {
-                                Point3::new(
-                                    result.point[0] as f64,
-                                    result.point[1] as f64,
-                                    result.point[2] as f64,
-                                )
-                            })
-                            .ok_or(MonstertruckError::EvaluationFailed)
-                    })
-                    .collect::<Result<Vec<_>>>()
-            })
-            .collect::<Result<Vec<_>>>()?;
+        let key = SampleKey {
+            patch_type: self.patch_type()?,
+            boundary_mask: self.boundary_mask(),
+            high_precision: true,
+        };
+        let samples = self.sample_grid(key, cache)?;
 
         // Create knot vectors for an 8×8 control point grid with degree 3.
         // For n control points and degree p, we need n + p + 1 knots.
@@ -591,6 +646,146 @@ impl<'a> PatchRef<'a> {
 
         Ok(BsplineSurface::new((knots.clone(), knots), samples))
     }
+
+    /// Convert this patch the way [`PatchTableExt::to_monstertruck_surfaces_with_options()`]
+    /// does, taking sample weights from `cache` if it has them.
+    fn to_bspline_cached(
+        &self,
+        gregory_accuracy: GregoryAccuracy,
+        cache: Option<&SampleWeightCache>,
+    ) -> Result<BsplineSurface<Point3>> {
+        if self.is_gregory() && gregory_accuracy == GregoryAccuracy::HighPrecision {
+            // Use high-precision 8×8 sampling for Gregory patches.
+            self.to_bspline_high_precision_cached(cache)
+        } else {
+            // Use standard conversion for regular patches or when using
+            // BSplineEndCaps accuracy (the patch table should already have
+            // B-spline end caps if configured that way).
+            Ok(uniform_bicubic_surface(self.control_points_cached(cache)?))
+        }
+    }
+}
+
+/// Patch-local `(u, v)` of sample `(i, j)` of the grid of `key`.
+fn sample_uv(key: SampleKey, i: usize, j: usize) -> (f32, f32) {
+    let n = (key.grid_size() - 1) as f32;
+    let (u, v) = (i as f32 / n, j as f32 / n);
+
+    // The 4x4 approximation of triangular patches collapses samples outside
+    // the u + v <= 1 domain onto its edge, making a degenerate quad.
+    if !key.high_precision && key.patch_type == PatchType::GregoryTriangle && u + v > 1.0 {
+        let sum = u + v;
+        (u / sum, v / sum)
+    } else {
+        (u, v)
+    }
+}
+
+/// Identifies patches whose B-spline conversion samples the same basis
+/// weights.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+struct SampleKey {
+    patch_type: PatchType,
+    boundary_mask: i32,
+    /// Whether the 8×8 grid of `to_bspline_high_precision()` is sampled
+    /// instead of the 4×4 one.
+    high_precision: bool,
+}
+
+impl SampleKey {
+    fn grid_size(&self) -> usize {
+        if self.high_precision {
+            8
+        } else {
+            4
+        }
+    }
+}
+
+/// Patch basis weights at the sample grid of each [`SampleKey`], one
+/// weight vector per sample, row-major.
+///
+/// Gregory bases only depend on the patch type and the patch-local sample
+/// locations, not on the control points, so one basis evaluation per key
+/// replaces one per sample of every patch.
+#[derive(Default)]
+struct SampleWeightCache {
+    entries: Vec<(SampleKey, Vec<Vec<f32>>)>,
+}
+
+impl SampleWeightCache {
+    // AIDEV-NOTE: Built serially in patch order before any parallel
+    // conversion, so the weights of every key come from the same patch for
+    // any thread count and exports stay byte-stable.
+    /// Collect the sample weights the conversion of `patch_indices` uses.
+    fn new(
+        patch_table: &PatchTable,
+        control_points: &[[f32; 3]],
+        patch_indices: &[usize],
+        gregory_accuracy: GregoryAccuracy,
+    ) -> Self {
+        let high_precision = gregory_accuracy == GregoryAccuracy::HighPrecision;
+        let mut cache = Self::default();
+        for &patch_index in patch_indices {
+            let patch = PatchRef::new(patch_table, patch_index, control_points);
+            let Some(key) = patch.sample_key(high_precision) else {
+                continue;
+            };
+            if cache.get(key).is_none() {
+                if let Some(weights) = patch.sample_weights(key) {
+                    cache.entries.push((key, weights));
+                }
+            }
+        }
+        cache
+    }
+
+    fn get(&self, key: SampleKey) -> Option<&[Vec<f32>]> {
+        self.entries
+            .iter()
+            .find(|(entry_key, _)| *entry_key == key)
+            .map(|(_, weights)| weights.as_slice())
+    }
+}
+
+/// Convert `patch_indices` of `patch_table` to B-spline surfaces, in order.
+///
+/// Sample weights are cached across patches and, with the `rayon` feature,
+/// patches are converted in parallel.
+fn convert_patches(
+    patch_table: &PatchTable,
+    control_points: &[[f32; 3]],
+    patch_indices: &[usize],
+    gregory_accuracy: GregoryAccuracy,
+) -> Vec<Result<BsplineSurface<Point3>>> {
+    let cache =
+        SampleWeightCache::new(patch_table, control_points, patch_indices, gregory_accuracy);
+    let convert = |&patch_index: &usize| {
+        PatchRef::new(patch_table, patch_index, control_points)
+            .to_bspline_cached(gregory_accuracy, Some(&cache))
+    };
+
+    #[cfg(feature = "rayon")]
+    {
+        patch_indices.par_iter().map(convert).collect()
+    }
+    #[cfg(not(feature = "rayon"))]
+    {
+        patch_indices.iter().map(convert).collect()
+    }
+}
+
+/// Build a bicubic surface over a 4×4 control net with OpenSubdiv's uniform
+/// knots.
+fn uniform_bicubic_surface(control_matrix: Vec<Vec<Point3>>) -> BsplineSurface<Point3> {
+    // AIDEV-NOTE: OpenSubdiv B-spline patch knot vectors
+    // Export patches exactly as OpenSubdiv defines them: uniform knots with
+    // phantom rows/columns. Boundary masks affect evaluation inside OSD, but
+    // the control net is authored for this uniform basis, so we keep it.
+    let u_knots = KnotVector::from(vec![-3.0, -2.0, -1.0, 0.0, 1.0, 2.0, 3.0, 4.0]);
+    let v_knots = KnotVector::from(vec![-3.0, -2.0, -1.0, 0.0, 1.0, 2.0, 3.0, 4.0]);
+
+    BsplineSurface::new((u_knots, v_knots), control_matrix)
 }
 
 /// Convert a regular B-spline patch to a monstertruck BsplineSurface
@@ -598,16 +793,7 @@ impl<'a> TryFrom<PatchRef<'a>> for BsplineSurface<Point3> {
     type Error = MonstertruckError;
 
     fn try_from(patch: PatchRef<'a>) -> std::result::Result<Self, Self::Error> {
-        let control_matrix = patch.control_points()?;
-
-        // AIDEV-NOTE: OpenSubdiv B-spline patch knot vectors
-        // Export patches exactly as OpenSubdiv defines them: uniform knots with
-        // phantom rows/columns. Boundary masks affect evaluation inside OSD, but
-        // the control net is authored for this uniform basis, so we keep it.
-        let u_knots = KnotVector::from(vec![-3.0, -2.0, -1.0, 0.0, 1.0, 2.0, 3.0, 4.0]);
-        let v_knots = KnotVector::from(vec![-3.0, -2.0, -1.0, 0.0, 1.0, 2.0, 3.0, 4.0]);
-
-        Ok(BsplineSurface::new((u_knots, v_knots), control_matrix))
+        Ok(uniform_bicubic_surface(patch.control_points()?))
     }
 }
 
@@ -693,51 +879,75 @@ impl<'a> TryFrom<PatchTableWithControlPointsRef<'a>> for Vec<BsplineSurface<Poin
     fn try_from(
         patches: PatchTableWithControlPointsRef<'a>,
     ) -> std::result::Result<Self, Self::Error> {
-        let mut surfaces = Vec::new();
+        let mut patch_indices = Vec::new();
+        let mut patch_types = Vec::new();
         let mut patch_index = 0;
 
         for array_idx in 0..patches.patch_table.patch_array_count() {
             if let Some(desc) = patches.patch_table.patch_array_descriptor(array_idx) {
                 let patch_type = desc.patch_type();
+                let num_patches = patches.patch_table.patch_array_patch_count(array_idx);
                 // Handle Regular, GregoryBasis, and GregoryTriangle patches
                 if matches!(
                     patch_type,
                     PatchType::Regular | PatchType::GregoryBasis | PatchType::GregoryTriangle
                 ) {
-                    for _ in 0..patches.patch_table.patch_array_patch_count(array_idx) {
-                        let patch =
-                            PatchRef::new(patches.patch_table, patch_index, patches.control_points);
-                        match BsplineSurface::try_from(patch) {
-                            Ok(surface) => surfaces.push(surface),
-                            Err(e) => eprintln!(
-                                "Failed to convert patch {} (type {:?}): {:?}",
-                                patch_index, patch_type, e
-                            ),
-                        }
-                        patch_index += 1;
-                    }
+                    patch_indices.extend(patch_index..patch_index + num_patches);
+                    patch_types.extend(std::iter::repeat(patch_type).take(num_patches));
                 } else {
                     eprintln!(
                         "Skipping patch array {} with type {:?} ({} patches)",
-                        array_idx,
-                        patch_type,
-                        patches.patch_table.patch_array_patch_count(array_idx)
+                        array_idx, patch_type, num_patches
                     );
-                    patch_index += patches.patch_table.patch_array_patch_count(array_idx);
                 }
+                patch_index += num_patches;
             }
         }
 
-        if surfaces.is_empty() {
-            // No non-regular patches to convert; return an empty list so callers
-            // can rely on BFR-regular surfaces alone.
-            Ok(surfaces)
-        } else {
-            Ok(surfaces)
-        }
+        // Without high precision every patch converts through its 4×4
+        // control net, exactly like `BsplineSurface::try_from(PatchRef)`.
+        let converted = convert_patches(
+            patches.patch_table,
+            patches.control_points,
+            &patch_indices,
+            GregoryAccuracy::BSplineEndCaps,
+        );
+
+        // No convertible patches yields an empty list so callers can rely on
+        // BFR-regular surfaces alone.
+        Ok(collect_converted(
+            converted,
+            &patch_indices,
+            &patch_types,
+            "Failed to convert patch",
+        ))
     }
 }
 
+/// Keep the successfully converted surfaces of `convert_patches()`,
+/// reporting failures in patch order.
+fn collect_converted(
+    converted: Vec<Result<BsplineSurface<Point3>>>,
+    patch_indices: &[usize],
+    patch_types: &[PatchType],
+    message: &str,
+) -> Vec<BsplineSurface<Point3>> {
+    converted
+        .into_iter()
+        .zip(patch_indices.iter().zip(patch_types))
+        .filter_map(|(surface, (patch_index, patch_type))| match surface {
+            Ok(surface) => Some(surface),
+            Err(e) => {
+                eprintln!(
+                    "{} {} (type {:?}): {:?}",
+                    message, patch_index, patch_type, e
+                );
+                None
+            }
+        })
+        .collect()
+}
+
 /// Convert only non-regular patches to B-spline surfaces (skip regular to allow
 /// BFR substitution).
 pub fn patch_table_surfaces_non_regular(
@@ -758,7 +968,8 @@ pub fn patch_table_surfaces_non_regular_with_options(
     control_points: &[[f32; 3]],
     gregory_accuracy: GregoryAccuracy,
 ) -> Result<Vec<BsplineSurface<Point3>>> {
-    let mut surfaces = Vec::new();
+    let mut patch_indices = Vec::new();
+    let mut patch_types = Vec::new();
     let mut patch_index = 0;
 
     for array_idx in 0..patch_table.patch_array_count() {
@@ -766,11 +977,7 @@ pub fn patch_table_surfaces_non_regular_with_options(
             let patch_type = desc.patch_type();
             let num_patches = patch_table.patch_array_patch_count(array_idx);
 
-            if patch_type == PatchType::Regular {
-                patch_index += num_patches;
-                continue;
-            }
-
+            // Regular and unsupported types are skipped.
             if matches!(
                 patch_type,
                 PatchType::GregoryBasis
@@ -779,32 +986,25 @@ pub fn patch_table_surfaces_non_regular_with_options(
                     | PatchType::GregoryBoundary
                     | PatchType::GregoryCorner
             ) {
-                for _ in 0..num_patches {
-                    let patch = PatchRef::new(patch_table, patch_index, control_points);
-                    let surface = if patch.is_gregory()
-                        && gregory_accuracy == GregoryAccuracy::HighPrecision
-                    {
-                        patch.to_bspline_high_precision()
-                    } else {
-                        BsplineSurface::try_from(patch)
-                    };
-                    match surface {
-                        Ok(surface) => surfaces.push(surface),
-                        Err(e) => eprintln!(
-                            "Failed to convert non-regular patch {} (type {:?}): {:?}",
-                            patch_index, patch_type, e
-                        ),
-                    }
-                    patch_index += 1;
-                }
-            } else {
-                // Unsupported types skipped
-                patch_index += num_patches;
+                patch_indices.extend(patch_index..patch_index + num_patches);
+                patch_types.extend(std::iter::repeat(patch_type).take(num_patches));
             }
+            patch_index += num_patches;
         }
     }
 
-    Ok(surfaces)
+    let converted = convert_patches(
+        patch_table,
+        control_points,
+        &patch_indices,
+        gregory_accuracy,
+    );
+    Ok(collect_converted(
+        converted,
+        &patch_indices,
+        &patch_types,
+        "Failed to convert non-regular patch",
+    ))
 }
 
 /// Merge adjacent regular patches into larger bicubic superpatches to reduce
@@ -949,32 +1149,31 @@ pub fn superpatch_surfaces(
     }
 
     // Collect regular patches and build adjacency.
-    let mut regular = Vec::<RegPatch>::new();
+    let mut regular_indices = Vec::new();
     let mut patch_index = 0usize;
 
     for array_idx in 0..patch_table.patch_array_count() {
         if let Some(desc) = patch_table.patch_array_descriptor(array_idx) {
-            let patch_type = desc.patch_type();
             let num_patches = patch_table.patch_array_patch_count(array_idx);
-            if patch_type == PatchType::Regular {
-                for _ in 0..num_patches {
-                    let patch = PatchRef::new(patch_table, patch_index, control_points);
-                    if let Ok(cm) = patch.control_points() {
-                        regular.push(RegPatch {
-                            _index: patch_index,
-                            control: cm,
-                            boundary_mask: patch.boundary_mask(),
-                        });
-                    }
-                    patch_index += 1;
-                }
-            } else {
-                patch_index += num_patches;
+            if desc.patch_type() == PatchType::Regular {
+                regular_indices.extend(patch_index..patch_index + num_patches);
             }
+            patch_index += num_patches;
         }
     }
 
-    let mut adjacency = vec![Adjacency::default(); regular.len()];
+    let extract = |&patch_index: &usize| {
+        let patch = PatchRef::new(patch_table, patch_index, control_points);
+        patch.control_points().ok().map(|cm| RegPatch {
+            _index: patch_index,
+            control: cm,
+            boundary_mask: patch.boundary_mask(),
+        })
+    };
+    #[cfg(feature = "rayon")]
+    let regular: Vec<RegPatch> = regular_indices.par_iter().filter_map(extract).collect();
+    #[cfg(not(feature = "rayon"))]
+    let regular: Vec<RegPatch> = regular_indices.iter().filter_map(extract).collect();
 
     // AIDEV-NOTE: Boundary edge constants for superpatch merging.
     // Patches with boundary edges (including infinite creases) have clamped knot
@@ -984,43 +1183,75 @@ pub fn superpatch_surfaces(
     const BOUNDARY_V_MAX: i32 = 0b0100; // top edge (v=1)
     const BOUNDARY_U_MIN: i32 = 0b1000; // left edge (u=0)
 
-    for i in 0..regular.len() {
-        let r_i = &regular[i];
-        let bottom_i = edge_row(&r_i.control, "bottom");
-        let right_i = edge_row(&r_i.control, "right");
-
-        for (j, r_j) in regular.iter().enumerate() {
-            if i == j {
-                continue;
-            }
-            let top_j = edge_row(&r_j.control, "top");
-            let left_j = edge_row(&r_j.control, "left");
-
-            // Bottom adjacency: i's bottom connects to j's top.
-            // Skip if either edge is a boundary (clamped knots incompatible).
-            let i_bottom_boundary = r_i.boundary_mask & BOUNDARY_V_MIN != 0;
-            let j_top_boundary = r_j.boundary_mask & BOUNDARY_V_MAX != 0;
-            if adjacency[i].bottom.is_none()
-                && !i_bottom_boundary
-                && !j_top_boundary
-                && rows_match(&bottom_i, &top_j, tol)
-            {
-                adjacency[i].bottom = Some(j);
+    // AIDEV-NOTE: Matching rows have their first points within `tol`, so they
+    // land in the same or a neighboring cell of a grid with cell size >= `tol`.
+    // Candidates are checked with `rows_match()` exactly as before and the
+    // lowest matching index wins, which is what the former all-pairs scan
+    // picked.
+    let cell_size = tol.max(1e-9);
+    let cell_of = |p: Point3| {
+        [
+            (p.x / cell_size).floor() as i64,
+            (p.y / cell_size).floor() as i64,
+            (p.z / cell_size).floor() as i64,
+        ]
+    };
+    let mut tops = std::collections::HashMap::<[i64; 3], Vec<usize>>::new();
+    let mut lefts = std::collections::HashMap::<[i64; 3], Vec<usize>>::new();
+    for (j, r_j) in regular.iter().enumerate() {
+        if r_j.boundary_mask & BOUNDARY_V_MAX == 0 {
+            tops.entry(cell_of(r_j.control[0][0])).or_default().push(j);
+        }
+        if r_j.boundary_mask & BOUNDARY_U_MIN == 0 {
+            lefts.entry(cell_of(r_j.control[0][0])).or_default().push(j);
+        }
+    }
+
+    // Lowest `j != i` in `cells` around `row[0]` whose `edge` matches `row`.
+    let find_neighbor = |cells: &std::collections::HashMap<[i64; 3], Vec<usize>>,
+                         i: usize,
+                         row: &[Point3; 4],
+                         edge: &str| {
+        let [x, y, z] = cell_of(row[0]);
+        let mut best: Option<usize> = None;
+        for dx in -1..=1 {
+            for dy in -1..=1 {
+                for dz in -1..=1 {
+                    let Some(candidates) = cells.get(&[x + dx, y + dy, z + dz]) else {
+                        continue;
+                    };
+                    for &j in candidates {
+                        if j != i
+                            && best.map_or(true, |b| j < b)
+                            && rows_match(row, &edge_row(&regular[j].control, edge), tol)
+                        {
+                            best = Some(j);
+                        }
+                    }
+                }
             }
+        }
+        best
+    };
 
-            // Right adjacency: i's right connects to j's left.
-            // Skip if either edge is a boundary (clamped knots incompatible).
-            let i_right_boundary = r_i.boundary_mask & BOUNDARY_U_MAX != 0;
-            let j_left_boundary = r_j.boundary_mask & BOUNDARY_U_MIN != 0;
-            if adjacency[i].right.is_none()
-                && !i_right_boundary
-                && !j_left_boundary
-                && rows_match(&right_i, &left_j, tol)
-            {
-                adjacency[i].right = Some(j);
-            }
+    let adjacent = |i: usize| {
+        let r_i = &regular[i];
+        // Bottom adjacency: i's bottom connects to j's top.
+        // Right adjacency: i's right connects to j's left.
+        // Skip if either edge is a boundary (clamped knots incompatible).
+        Adjacency {
+            right: (r_i.boundary_mask & BOUNDARY_U_MAX == 0)
+                .then(|| find_neighbor(&lefts, i, &edge_row(&r_i.control, "right"), "left"))
+                .flatten(),
+            bottom: (r_i.boundary_mask & BOUNDARY_V_MIN == 0)
+                .then(|| find_neighbor(&tops, i, &edge_row(&r_i.control, "bottom"), "top"))
+                .flatten(),
         }
-    }
+    };
+    #[cfg(feature = "rayon")]
+    let adjacency: Vec<Adjacency> = (0..regular.len()).into_par_iter().map(adjacent).collect();
+    #[cfg(not(feature = "rayon"))]
+    let adjacency: Vec<Adjacency> = (0..regular.len()).map(adjacent).collect();
 
     // Reverse adjacency to walk both directions.
     let mut left_of = vec![None; regular.len()];
@@ -1246,6 +1477,20 @@ pub fn superpatch_surfaces(
         // Sort ascending by area to prioritize smaller patches.
         superpatches.sort_by_key(|sp| sp.width_cells * sp.height_cells);
 
+        #[cfg(feature = "rayon")]
+        let edges: Vec<SuperpatchEdges> = superpatches.par_iter().map(superpatch_edges).collect();
+        #[cfg(not(feature = "rayon"))]
+        let edges: Vec<SuperpatchEdges> = superpatches.iter().map(superpatch_edges).collect();
+
+        // Superpatches by component and grid origin; indices ascend.
+        let mut by_origin = std::collections::HashMap::<(usize, i32, i32), Vec<usize>>::new();
+        for (j, sp) in superpatches.iter().enumerate() {
+            by_origin
+                .entry((sp.component, sp.origin_x, sp.origin_y))
+                .or_default()
+                .push(j);
+        }
+
         let mut used = vec![false; superpatches.len()];
         let mut next = Vec::<Superpatch>::new();
         let mut merged_any = false;
@@ -1255,50 +1500,63 @@ pub fn superpatch_surfaces(
                 continue;
             }
             let sp_i = &superpatches[i];
-            let (_left_i, right_i, bottom_i, _top_i) = superpatch_edges(sp_i);
-            let mut merged = false;
+            let (_left_i, right_i, bottom_i, _top_i) = &edges[i];
 
-            for j in (i + 1)..superpatches.len() {
-                if used[j] {
-                    continue;
-                }
-                let sp_j = &superpatches[j];
-                let (left_j, _right_j, _bottom_j, top_j) = superpatch_edges(sp_j);
-
-                // Horizontal merge: same component and height, touching in grid.
-                if sp_i.component == sp_j.component
-                    && sp_i.height_cells == sp_j.height_cells
-                    && sp_i.origin_y == sp_j.origin_y
-                    && sp_i.origin_x + sp_i.width_cells as i32 == sp_j.origin_x
-                    && edges_match(&right_i, &left_j, tol)
-                {
-                    let combined = merge_horizontal(sp_i, sp_j);
-                    used[i] = true;
-                    used[j] = true;
-                    merged = true;
-                    merged_any = true;
-                    next.push(combined);
-                    break;
-                }
+            // First unused `j > i` at `origin` accepted by `fits`.
+            let first_at = |origin: (usize, i32, i32), fits: &dyn Fn(usize) -> bool| {
+                by_origin.get(&origin).and_then(|candidates| {
+                    candidates
+                        .iter()
+                        .copied()
+                        .find(|&j| j > i && !used[j] && fits(j))
+                })
+            };
 
-                // Vertical merge: same component and width, touching in grid.
-                if sp_i.component == sp_j.component
-                    && sp_i.width_cells == sp_j.width_cells
-                    && sp_i.origin_x == sp_j.origin_x
-                    && sp_i.origin_y + sp_i.height_cells as i32 == sp_j.origin_y
-                    && edges_match(&bottom_i, &top_j, tol)
-                {
-                    let combined = merge_vertical(sp_i, sp_j);
-                    used[i] = true;
-                    used[j] = true;
-                    merged = true;
-                    merged_any = true;
-                    next.push(combined);
-                    break;
-                }
-            }
+            // Horizontal merge: same component and height, touching in grid.
+            let horizontal = first_at(
+                (
+                    sp_i.component,
+                    sp_i.origin_x + sp_i.width_cells as i32,
+                    sp_i.origin_y,
+                ),
+                &|j| {
+                    superpatches[j].height_cells == sp_i.height_cells
+                        && edges_match(right_i, &edges[j].0, tol)
+                },
+            );
+            // Vertical merge: same component and width, touching in grid.
+            let vertical = first_at(
+                (
+                    sp_i.component,
+                    sp_i.origin_x,
+                    sp_i.origin_y + sp_i.height_cells as i32,
+                ),
+                &|j| {
+                    superpatches[j].width_cells == sp_i.width_cells
+                        && edges_match(bottom_i, &edges[j].3, tol)
+                },
+            );
+
+            // The lowest candidate wins, horizontal first on a tie.
+            let merge = match (horizontal, vertical) {
+                (Some(h), Some(v)) if v < h => Some((v, false)),
+                (Some(h), _) => Some((h, true)),
+                (None, Some(v)) => Some((v, false)),
+                (None, None) => None,
+            };
 
-            if !merged {
+            if let Some((j, is_horizontal)) = merge {
+                let sp_j = &superpatches[j];
+                let combined = if is_horizontal {
+                    merge_horizontal(sp_i, sp_j)
+                } else {
+                    merge_vertical(sp_i, sp_j)
+                };
+                used[i] = true;
+                used[j] = true;
+                merged_any = true;
+                next.push(combined);
+            } else {
                 used[i] = true;
                 next.push(sp_i.clone());
             }
@@ -1311,24 +1569,26 @@ pub fn superpatch_surfaces(
         superpatches = next;
     }
 
-    let surfaces = superpatches
-        .into_iter()
-        .map(|sp| {
-            let ctrl_u = sp.control.len();
-            let ctrl_v = sp.control.first().map(|c| c.len()).unwrap_or(0);
-            // Use uniform knot vectors - OpenSubdiv control points are computed for this.
-            let knot_u: Vec<f64> = (0..(ctrl_u + DEGREE + 1))
-                .map(|k| k as f64 - DEGREE as f64)
-                .collect();
-            let knot_v: Vec<f64> = (0..(ctrl_v + DEGREE + 1))
-                .map(|k| k as f64 - DEGREE as f64)
-                .collect();
-            BsplineSurface::new(
-                (KnotVector::from(knot_u), KnotVector::from(knot_v)),
-                sp.control,
-            )
-        })
-        .collect();
+    let to_surface = |sp: Superpatch| {
+        let ctrl_u = sp.control.len();
+        let ctrl_v = sp.control.first().map(|c| c.len()).unwrap_or(0);
+        // Use uniform knot vectors - OpenSubdiv control points are computed for this.
+        let knot_u: Vec<f64> = (0..(ctrl_u + DEGREE + 1))
+            .map(|k| k as f64 - DEGREE as f64)
+            .collect();
+        let knot_v: Vec<f64> = (0..(ctrl_v + DEGREE + 1))
+            .map(|k| k as f64 - DEGREE as f64)
+            .collect();
+        BsplineSurface::new(
+            (KnotVector::from(knot_u), KnotVector::from(knot_v)),
+            sp.control,
+        )
+    };
+
+    #[cfg(feature = "rayon")]
+    let surfaces = superpatches.into_par_iter().map(to_surface).collect();
+    #[cfg(not(feature = "rayon"))]
+    let surfaces = superpatches.into_iter().map(to_surface).collect();
 
     Ok(surfaces)
 }
@@ -1957,30 +2217,10 @@ impl PatchTableExt for PatchTable {
         control_points: &[[f32; 3]],
         gregory_accuracy: GregoryAccuracy,
     ) -> Result<Vec<BsplineSurface<Point3>>> {
-        let convert_patch = |patch_index: usize| {
-            let patch_ref = self.patch(patch_index, control_points);
-            if patch_ref.is_gregory() && gregory_accuracy == GregoryAccuracy::HighPrecision {
-                // Use high-precision 8×8 sampling for Gregory patches.
-                patch_ref.to_bspline_high_precision()
-            } else {
-                // Use standard conversion for regular patches or when using
-                // BSplineEndCaps accuracy (the patch table should already have
-                // B-spline end caps if configured that way).
-                BsplineSurface::try_from(patch_ref)
-            }
-        };
-
-        #[cfg(feature = "rayon")]
-        {
-            (0..self.patch_count())
-                .into_par_iter()
-                .map(convert_patch)
-                .collect()
-        }
-        #[cfg(not(feature = "rayon"))]
-        {
-            (0..self.patch_count()).map(convert_patch).collect()
-        }
+        let patch_indices: Vec<usize> = (0..self.patch_count()).collect();
+        convert_patches(self, control_points, &patch_indices, gregory_accuracy)
+            .into_iter()
+            .collect()
     }
 
     /// Prefer BFR for regular faces and fall back to PatchTable for non-regular
@@ -2708,6 +2948,7 @@ mod tests {
         AdaptiveRefinementOptions, EndCapType, PatchTable, PatchTableOptions, PrimvarRefiner,
         TopologyDescriptor, TopologyRefiner, TopologyRefinerOptions,
     };
+    use crate::osd::BufferDescriptor;
 
     fn creased_cube_patch_table() -> (TopologyRefiner, PatchTable, Vec<[f32; 3]>) {
         let vertex_positions = vec![
@@ -2803,20 +3044,19 @@ mod tests {
         });
 
         if let Some(stencil_table) = patch_table.local_point_stencil_table() {
-            let mut local_points = Vec::with_capacity(patch_table.local_point_count());
-
-            (0..3).for_each(|dim| {
-                let src_dim: Vec<f32> = all_vertices.iter().map(|vertex| vertex[dim]).collect();
-                let dst_dim = stencil_table.update_values(&src_dim, None, None);
-
-                dst_dim.iter().enumerate().for_each(|(index, &value)| {
-                    if dim == 0 {
-                        local_points.push([value, 0.0, 0.0]);
-                    } else {
-                        local_points[index][dim] = value;
-                    }
-                });
-            });
+            let mut local_points = vec![[0.0f32; 3]; stencil_table.len()];
+            let desc = BufferDescriptor::new(0, 3, 3).expect("Invalid buffer descriptor.");
+
+            stencil_table
+                .update_values_interleaved(
+                    bytemuck::cast_slice(&all_vertices),
+                    desc,
+                    bytemuck::cast_slice_mut(&mut local_points),
+                    desc,
+                    None,
+                    None,
+                )
+                .expect("Failed to compute local points.");
 
             all_vertices.extend_from_slice(&local_points);
         }
@@ -5,6 +5,9 @@
 //! B-spline surface features of the OBJ format.
 
 use crate::far::{PatchTable, PatchType};
+use crate::Index;
+#[cfg(feature = "rayon")]
+use rayon::prelude::*;
 use std::io::{self, Write};
 
 /// Error type for OBJ export
@@ -39,28 +42,28 @@ impl std::error::Error for ObjExportError {}
 /// Result type for OBJ export
 pub type Result<T> = std::result::Result<T, ObjExportError>;
 
-/// Export OpenSubdiv patches as B-spline surfaces to OBJ format
-pub fn export_patches_as_bspline_surfaces<W: Write>(
-    writer: &mut W,
-    patch_table: &PatchTable,
-    control_points: &[[f32; 3]],
-) -> Result<()> {
-    writeln!(writer, "# OpenSubdiv B-spline Surface Export")?;
-    writeln!(writer, "# Generated by opensubdiv-petite")?;
-    writeln!(writer, "# Number of patches: {}", patch_table.patch_count())?;
-    writeln!(writer, "#")?;
-
-    // Write all control points first
-    writeln!(writer, "# Control points")?;
-    control_points.iter().enumerate().try_for_each(|(i, cp)| {
-        writeln!(writer, "v {} {} {}  # vertex {}", cp[0], cp[1], cp[2], i)
-    })?;
-    writeln!(writer)?;
+/// Records (vertices or patches) formatted before they are written.
+///
+/// Bounds the memory held by formatted records independently of the mesh
+/// size.
+const RECORDS_PER_BATCH: usize = 16384;
+
+/// Records formatted into one buffer by one worker.
+#[cfg(feature = "rayon")]
+const RECORDS_PER_BLOCK: usize = 256;
+
+/// A regular patch to export.
+struct RegularPatch<'a> {
+    array_idx: usize,
+    patch_idx: usize,
+    cvs: &'a [Index],
+}
 
-    // Track global patch index
-    let mut patch_global_idx = 0;
+/// Every regular patch, in export order.
+fn regular_patches(patch_table: &PatchTable) -> Vec<RegularPatch<'_>> {
+    const REGULAR_PATCH_SIZE: usize = 16; // 4x4 control points
 
-    // Process each patch array
+    let mut patches = Vec::new();
     for array_idx in 0..patch_table.patch_array_count() {
         if let Some(desc) = patch_table.patch_array_descriptor(array_idx) {
             if desc.patch_type() != PatchType::Regular {
@@ -70,55 +73,143 @@ pub fn export_patches_as_bspline_surfaces<W: Write>(
 
             let num_patches = patch_table.patch_array_patch_count(array_idx);
             if let Some(cv_indices) = patch_table.patch_array_vertices(array_idx) {
-                const REGULAR_PATCH_SIZE: usize = 16; // 4x4 control points
-
-                for patch_idx in 0..num_patches {
-                    writeln!(
-                        writer,
-                        "# Patch {patch_global_idx} (array {array_idx}, local {patch_idx})"
-                    )?;
-
-                    // Write B-spline surface type
-                    writeln!(writer, "cstype bspline")?;
-
-                    // Degree 3 in both directions (cubic)
-                    writeln!(writer, "deg 3 3")?;
-
+                patches.extend((0..num_patches).map(|patch_idx| {
                     // Get control point indices for this patch
                     let start = patch_idx * REGULAR_PATCH_SIZE;
-                    let patch_cvs = &cv_indices[start..start + REGULAR_PATCH_SIZE];
-
-                    // Write surface with parameter range [0,1] and control points
-                    // Note: OBJ uses 1-based indexing, and negative indices for relative indexing
-                    write!(writer, "surf 0.0 1.0 0.0 1.0")?;
-
-                    // Write control point indices in row-major order
-                    for cv in patch_cvs.iter().take(16) {
-                        let cv_idx = cv.0 as usize;
-                        if cv_idx >= control_points.len() {
-                            return Err(ObjExportError::InvalidControlPoints);
-                        }
-                        // Use 1-based index
-                        write!(writer, " {}", cv_idx + 1)?;
+                    RegularPatch {
+                        array_idx,
+                        patch_idx,
+                        cvs: &cv_indices[start..start + REGULAR_PATCH_SIZE],
                     }
-                    writeln!(writer)?;
+                }));
+            }
+        }
+    }
+    patches
+}
 
-                    // Write knot vectors
-                    // Use the same knot vector we fixed for monstertruck: [-3, -2, -1, 0, 1, 2, 3,
-                    // 4]
-                    writeln!(writer, "parm u -3.0 -2.0 -1.0 0.0 1.0 2.0 3.0 4.0")?;
-                    writeln!(writer, "parm v -3.0 -2.0 -1.0 0.0 1.0 2.0 3.0 4.0")?;
+/// Write one control point record.
+fn write_vertex(out: &mut Vec<u8>, i: usize, cp: &[f32; 3]) -> Result<()> {
+    writeln!(out, "v {} {} {}  # vertex {}", cp[0], cp[1], cp[2], i)?;
+    Ok(())
+}
 
-                    // End the surface definition
-                    writeln!(writer, "end")?;
-                    writeln!(writer)?;
+/// Write the surface record of patch `patch_global_idx`.
+fn write_patch(
+    out: &mut Vec<u8>,
+    patch_global_idx: usize,
+    patch: &RegularPatch<'_>,
+    control_points: &[[f32; 3]],
+) -> Result<()> {
+    writeln!(
+        out,
+        "# Patch {patch_global_idx} (array {}, local {})",
+        patch.array_idx, patch.patch_idx
+    )?;
+
+    // Write B-spline surface type
+    writeln!(out, "cstype bspline")?;
+
+    // Degree 3 in both directions (cubic)
+    writeln!(out, "deg 3 3")?;
+
+    // Write surface with parameter range [0,1] and control points
+    // Note: OBJ uses 1-based indexing, and negative indices for relative indexing
+    write!(out, "surf 0.0 1.0 0.0 1.0")?;
+
+    // Write control point indices in row-major order
+    for cv in patch.cvs.iter().take(16) {
+        let cv_idx = cv.0 as usize;
+        if cv_idx >= control_points.len() {
+            return Err(ObjExportError::InvalidControlPoints);
+        }
+        // Use 1-based index
+        write!(out, " {}", cv_idx + 1)?;
+    }
+    writeln!(out)?;
 
-                    patch_global_idx += 1;
-                }
-            }
+    // Write knot vectors
+    // Use the same knot vector we fixed for monstertruck: [-3, -2, -1, 0, 1, 2, 3,
+    // 4]
+    writeln!(out, "parm u -3.0 -2.0 -1.0 0.0 1.0 2.0 3.0 4.0")?;
+    writeln!(out, "parm v -3.0 -2.0 -1.0 0.0 1.0 2.0 3.0 4.0")?;
+
+    // End the surface definition
+    writeln!(out, "end")?;
+    writeln!(out)?;
+    Ok(())
+}
+
+/// Format `records` in batches with `format` and write them to `writer` in
+/// order.
+///
+/// `format` receives each record's index in `records`. With the `rayon`
+/// feature every batch is formatted in parallel. Records before the first
+/// one that fails to format are written.
+fn write_records<W, T, F>(writer: &mut W, records: &[T], format: F) -> Result<()>
+where
+    W: Write,
+    T: Sync,
+    F: Fn(&mut Vec<u8>, usize, &T) -> Result<()> + Sync,
+{
+    // Format the records of `block`, the first of which is `records[first]`.
+    let render = |first: usize, block: &[T]| {
+        let mut out = Vec::new();
+        let result = (first..)
+            .zip(block)
+            .try_for_each(|(i, record)| format(&mut out, i, record));
+        (out, result)
+    };
+
+    for (batch_idx, batch) in records.chunks(RECORDS_PER_BATCH).enumerate() {
+        let first = batch_idx * RECORDS_PER_BATCH;
+
+        #[cfg(feature = "rayon")]
+        let blocks: Vec<_> = batch
+            .par_chunks(RECORDS_PER_BLOCK)
+            .enumerate()
+            .map(|(block_idx, block)| render(first + block_idx * RECORDS_PER_BLOCK, block))
+            .collect();
+        #[cfg(not(feature = "rayon"))]
+        let blocks = [render(first, batch)];
+
+        for (out, result) in blocks {
+            writer.write_all(&out)?;
+            result?;
         }
     }
+    Ok(())
+}
+
+/// Export OpenSubdiv patches as B-spline surfaces to OBJ format
+///
+/// Output is streamed: vertex and surface records are formatted in batches
+/// (in parallel with the `rayon` feature) and written in order, so memory use
+/// does not grow with the mesh size beyond one entry per patch.
+pub fn export_patches_as_bspline_surfaces<W: Write>(
+    writer: &mut W,
+    patch_table: &PatchTable,
+    control_points: &[[f32; 3]],
+) -> Result<()> {
+    let mut writer = io::BufWriter::new(writer);
+
+    writeln!(writer, "# OpenSubdiv B-spline Surface Export")?;
+    writeln!(writer, "# Generated by opensubdiv-petite")?;
+    writeln!(writer, "# Number of patches: {}", patch_table.patch_count())?;
+    writeln!(writer, "#")?;
+
+    // Write all control points first
+    writeln!(writer, "# Control points")?;
+    write_records(&mut writer, control_points, write_vertex)?;
+    writeln!(writer)?;
+
+    // Write every regular patch, numbered in export order
+    let patches = regular_patches(patch_table);
+    write_records(&mut writer, &patches, |out, patch_global_idx, patch| {
+        write_patch(out, patch_global_idx, patch, control_points)
+    })?;
 
+    writer.flush()?;
     Ok(())
 }
 
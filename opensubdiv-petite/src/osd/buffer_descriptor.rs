@@ -75,6 +75,20 @@ impl BufferDescriptor {
     pub fn is_empty(&self) -> bool {
         0 == self.0.length
     }
+
+    /// Returns the number of `f32`s a buffer needs to hold `point_count`
+    /// points laid out as described by this descriptor.
+    #[inline]
+    pub fn buffer_len(&self, point_count: usize) -> usize {
+        match point_count {
+            0 => 0,
+            _ => {
+                self.0.offset as usize
+                    + (point_count - 1) * self.0.stride as usize
+                    + self.0.length as usize
+            }
+        }
+    }
 }
 
 impl Default for BufferDescriptor {
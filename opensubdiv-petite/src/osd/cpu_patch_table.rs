@@ -0,0 +1,44 @@
+use crate::far::PatchTable;
+use crate::{Error, Result};
+use opensubdiv_petite_sys as sys;
+
+/// [`PatchTable`] laid out for patch evaluation on the CPU backends.
+///
+/// An instance can be passed to the `evaluate_patches*()` functions of
+/// [`cpu_evaluator`](crate::osd::cpu_evaluator),
+/// [`omp_evaluator`](crate::osd::omp_evaluator) and
+/// [`tbb_evaluator`](crate::osd::tbb_evaluator). Borrows the patch table it
+/// was created from, which validates patch coordinates before evaluation.
+pub struct CpuPatchTable<'a> {
+    pub(crate) ptr: sys::osd::CpuPatchTablePtr,
+    patch_table: &'a PatchTable,
+}
+
+impl<'a> CpuPatchTable<'a> {
+    /// Create a CPU patch table from a [`PatchTable`].
+    pub fn new(patch_table: &'a PatchTable) -> Result<Self> {
+        let ptr = unsafe { sys::osd::CpuPatchTable_Create(patch_table.as_ptr()) };
+        if ptr.is_null() {
+            return Err(Error::Ffi("CpuPatchTable_Create returned null".to_string()));
+        }
+
+        Ok(Self { ptr, patch_table })
+    }
+
+    /// Returns the patch table this table was created from.
+    #[inline]
+    pub fn patch_table(&self) -> &'a PatchTable {
+        self.patch_table
+    }
+}
+
+impl Drop for CpuPatchTable<'_> {
+    #[inline]
+    fn drop(&mut self) {
+        unsafe { sys::osd::CpuPatchTable_destroy(self.ptr) }
+    }
+}
+
+// The table is immutable after creation.
+unsafe impl Send for CpuPatchTable<'_> {}
+unsafe impl Sync for CpuPatchTable<'_> {}
@@ -66,6 +66,36 @@ impl CpuVertexBuffer {
         Ok(unsafe { std::slice::from_raw_parts(ptr, self.element_count() * self.vertex_count()) })
     }
 
+    /// Get the contents of this vertex buffer as a mutable slice of [`f32`].
+    #[inline]
+    pub fn bind_cpu_buffer_mut(&mut self) -> Result<&mut [f32]> {
+        let ptr = unsafe { sys::osd::CpuVertexBuffer_BindCpuBuffer(self.0) };
+        if ptr.is_null() {
+            return Err(Error::NullPointer);
+        }
+
+        // `BindCpuBuffer()` hands out the buffer's mutable storage.
+        Ok(unsafe {
+            std::slice::from_raw_parts_mut(
+                ptr as *mut f32,
+                self.element_count() * self.vertex_count(),
+            )
+        })
+    }
+
+    /// Borrow the contents of this vertex buffer as a [`CpuVertexView`].
+    #[inline]
+    pub fn as_view(&self) -> Result<CpuVertexView<'_>> {
+        CpuVertexView::new(self.bind_cpu_buffer()?, self.element_count())
+    }
+
+    /// Borrow the contents of this vertex buffer as a [`CpuVertexViewMut`].
+    #[inline]
+    pub fn as_view_mut(&mut self) -> Result<CpuVertexViewMut<'_>> {
+        let element_count = self.element_count();
+        CpuVertexViewMut::new(self.bind_cpu_buffer_mut()?, element_count)
+    }
+
     /// This method is meant to be used in client code in order to provide
     /// coarse vertices data to Osd.
     #[inline]
@@ -118,3 +148,194 @@ impl CpuVertexBuffer {
         Ok(())
     }
 }
+
+impl super::types::VertexBuffer for CpuVertexBuffer {
+    type Raw = sys::osd::CpuVertexBuffer_obj;
+
+    #[inline]
+    fn as_raw(&self) -> *mut Self::Raw {
+        self.0
+    }
+
+    #[inline]
+    fn float_count(&self) -> usize {
+        self.element_count() * self.vertex_count()
+    }
+}
+
+/// Checks that `len` floats hold a whole number of `element_count`-float
+/// vertices.
+fn check_view_len(len: usize, element_count: usize) -> Result<()> {
+    if element_count == 0 || len % element_count != 0 {
+        return Err(Error::InvalidBufferSize {
+            expected: len.next_multiple_of(element_count.max(1)),
+            actual: len,
+        });
+    }
+    Ok(())
+}
+
+/// A read-only vertex buffer over memory owned by the caller.
+///
+/// The `evaluate_*_view()` functions of the
+/// [`cpu_evaluator`](crate::osd::cpu_evaluator) read the control vertices
+/// from a view in place, so mesh positions need not be copied into a
+/// [`CpuVertexBuffer`] first.
+#[derive(Clone, Copy, Debug)]
+pub struct CpuVertexView<'a> {
+    data: &'a [f32],
+    element_count: usize,
+}
+
+impl<'a> CpuVertexView<'a> {
+    /// Wrap `data`, which holds vertices of `element_count` floats back to
+    /// back.
+    ///
+    /// # Errors
+    /// Returns [`Error::InvalidBufferSize`] if `data` does not hold a whole
+    /// number of vertices.
+    #[inline]
+    pub fn new(data: &'a [f32], element_count: usize) -> Result<Self> {
+        check_view_len(data.len(), element_count)?;
+        Ok(Self {
+            data,
+            element_count,
+        })
+    }
+
+    /// Wrap `vertices` of `N` floats each.
+    #[inline]
+    pub fn from_vertices<const N: usize>(vertices: &'a [[f32; N]]) -> Self {
+        Self {
+            data: bytemuck::cast_slice(vertices),
+            element_count: N,
+        }
+    }
+
+    /// Returns how many elements each vertex has.
+    #[inline]
+    pub fn element_count(&self) -> usize {
+        self.element_count
+    }
+
+    /// Returns how many vertices the view holds.
+    #[inline]
+    pub fn vertex_count(&self) -> usize {
+        self.data.len() / self.element_count.max(1)
+    }
+
+    /// Get the viewed memory.
+    #[inline]
+    pub fn as_slice(&self) -> &'a [f32] {
+        self.data
+    }
+}
+
+/// A vertex buffer over mutable memory owned by the caller.
+///
+/// The `evaluate_*_view()` functions of the
+/// [`cpu_evaluator`](crate::osd::cpu_evaluator) write their results into a
+/// view in place, e.g. straight into the position array of a mesh.
+#[derive(Debug)]
+pub struct CpuVertexViewMut<'a> {
+    data: &'a mut [f32],
+    element_count: usize,
+}
+
+impl<'a> CpuVertexViewMut<'a> {
+    /// Wrap `data`, which holds vertices of `element_count` floats back to
+    /// back.
+    ///
+    /// # Errors
+    /// Returns [`Error::InvalidBufferSize`] if `data` does not hold a whole
+    /// number of vertices.
+    #[inline]
+    pub fn new(data: &'a mut [f32], element_count: usize) -> Result<Self> {
+        check_view_len(data.len(), element_count)?;
+        Ok(Self {
+            data,
+            element_count,
+        })
+    }
+
+    /// Wrap `vertices` of `N` floats each.
+    #[inline]
+    pub fn from_vertices<const N: usize>(vertices: &'a mut [[f32; N]]) -> Self {
+        Self {
+            data: bytemuck::cast_slice_mut(vertices),
+            element_count: N,
+        }
+    }
+
+    /// Returns how many elements each vertex has.
+    #[inline]
+    pub fn element_count(&self) -> usize {
+        self.element_count
+    }
+
+    /// Returns how many vertices the view holds.
+    #[inline]
+    pub fn vertex_count(&self) -> usize {
+        self.data.len() / self.element_count.max(1)
+    }
+
+    /// Reborrow as a read-only view, e.g. to use results as the source of
+    /// another evaluation.
+    #[inline]
+    pub fn as_view(&self) -> CpuVertexView<'_> {
+        CpuVertexView {
+            data: self.data,
+            element_count: self.element_count,
+        }
+    }
+
+    /// Get the viewed memory.
+    #[inline]
+    pub fn as_slice(&self) -> &[f32] {
+        self.data
+    }
+
+    /// Get the viewed memory for writing.
+    #[inline]
+    pub fn as_mut_slice(&mut self) -> &mut [f32] {
+        self.data
+    }
+}
+
+// AIDEV-NOTE: Views hand the evaluators the address of their first float.
+// The view shims only ever read through the source pointer, so casting the
+// shared slice of a `CpuVertexView` to `*mut` is sound. Destinations are
+// written, so `CpuVertexViewMut` takes its pointer from the unique slice in
+// `as_raw_mut()`; its `as_raw()` is read-only like the view's.
+impl super::types::VertexBuffer for CpuVertexView<'_> {
+    type Raw = f32;
+
+    #[inline]
+    fn as_raw(&self) -> *mut Self::Raw {
+        self.data.as_ptr() as *mut f32
+    }
+
+    #[inline]
+    fn float_count(&self) -> usize {
+        self.data.len()
+    }
+}
+
+impl super::types::VertexBuffer for CpuVertexViewMut<'_> {
+    type Raw = f32;
+
+    #[inline]
+    fn as_raw(&self) -> *mut Self::Raw {
+        self.data.as_ptr() as *mut f32
+    }
+
+    #[inline]
+    fn as_raw_mut(&mut self) -> *mut Self::Raw {
+        self.data.as_mut_ptr()
+    }
+
+    #[inline]
+    fn float_count(&self) -> usize {
+        self.data.len()
+    }
+}
@@ -1,6 +1,10 @@
 use super::buffer_descriptor::BufferDescriptor;
 use super::cuda_vertex_buffer::CudaVertexBuffer;
-use crate::far::StencilTable;
+use super::types::{
+    check_limit_stencils, check_patch_coords, resolve_outputs, Derivatives, PatchCoord,
+    SecondDerivatives,
+};
+use crate::far::{LimitStencilTable, PatchTable, StencilTable};
 
 use opensubdiv_petite_sys as sys;
 
@@ -73,3 +77,245 @@ impl<'a> CudaStencilTable<'a> {
         })
     }
 }
+
+/// Evaluate limit stencils with derivatives on the GPU.
+///
+/// Writes limit positions to `dst_buffer` and 1st derivatives to
+/// `derivatives`; 2nd derivatives are written to `second_derivatives` if
+/// given.
+///
+/// # Errors
+///
+/// Returns [`Error::FeatureNotAvailable`] if the stencil table lacks the
+/// requested derivative weights, [`Error::InvalidBufferDescriptor`] if a
+/// descriptor does not match `src_desc` or interleaved outputs overlap and
+/// [`Error::InvalidBufferSize`] if a buffer is too small.
+pub fn evaluate_stencils_with_derivatives(
+    src_buffer: &CudaVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut CudaVertexBuffer,
+    dst_desc: BufferDescriptor,
+    derivatives: Derivatives<'_, CudaVertexBuffer>,
+    second_derivatives: Option<SecondDerivatives<'_, CudaVertexBuffer>>,
+    stencil_table: &CudaLimitStencilTable,
+) -> Result<()> {
+    let st = stencil_table.stencil_table;
+    check_limit_stencils(st, second_derivatives.is_some())?;
+    let outputs = resolve_outputs(
+        src_buffer,
+        src_desc,
+        st.control_vertex_count(),
+        dst_buffer,
+        dst_desc,
+        Some(derivatives),
+        second_derivatives,
+        st.len(),
+    )?;
+    let [dst, du, dv, duu, duv, dvv] = outputs.buffers;
+    let [dst_desc, du_desc, dv_desc, duu_desc, duv_desc, dvv_desc] = outputs.descs;
+
+    unsafe {
+        if sys::osd::CudaEvaluator_EvalStencilsWithDerivatives(
+            src_buffer.0,
+            src_desc.0,
+            dst,
+            dst_desc,
+            du,
+            du_desc,
+            dv,
+            dv_desc,
+            duu,
+            duu_desc,
+            duv,
+            duv_desc,
+            dvv,
+            dvv_desc,
+            stencil_table.ptr,
+        ) {
+            Ok(())
+        } else {
+            Err(Error::EvalStencilsFailed)
+        }
+    }
+}
+
+/// Evaluate the limit surface of a patch table at `patch_coords` on the GPU.
+///
+/// `src_buffer` holds the patch control points: the refined vertices
+/// followed by the local points of the patch table. `patch_coords` are
+/// uploaded for the duration of the call.
+///
+/// # Errors
+///
+/// Returns [`Error::InvalidPatch`] if a coordinate refers to a patch not in
+/// the patch table; see [`evaluate_stencils_with_derivatives()`] for the
+/// buffer errors.
+pub fn evaluate_patches(
+    src_buffer: &CudaVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut CudaVertexBuffer,
+    dst_desc: BufferDescriptor,
+    patch_coords: &[PatchCoord],
+    patch_table: &CudaPatchTable,
+) -> Result<()> {
+    eval_patches(
+        src_buffer,
+        src_desc,
+        dst_buffer,
+        dst_desc,
+        None,
+        None,
+        patch_coords,
+        patch_table,
+    )
+}
+
+/// Evaluate the limit surface of a patch table and its derivatives at
+/// `patch_coords` on the GPU.
+///
+/// Like [`evaluate_patches()`], also writing 1st derivatives to
+/// `derivatives` and, if given, 2nd derivatives to `second_derivatives`.
+#[allow(clippy::too_many_arguments)]
+pub fn evaluate_patches_with_derivatives(
+    src_buffer: &CudaVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut CudaVertexBuffer,
+    dst_desc: BufferDescriptor,
+    derivatives: Derivatives<'_, CudaVertexBuffer>,
+    second_derivatives: Option<SecondDerivatives<'_, CudaVertexBuffer>>,
+    patch_coords: &[PatchCoord],
+    patch_table: &CudaPatchTable,
+) -> Result<()> {
+    eval_patches(
+        src_buffer,
+        src_desc,
+        dst_buffer,
+        dst_desc,
+        Some(derivatives),
+        second_derivatives,
+        patch_coords,
+        patch_table,
+    )
+}
+
+#[allow(clippy::too_many_arguments)]
+fn eval_patches(
+    src_buffer: &CudaVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut CudaVertexBuffer,
+    dst_desc: BufferDescriptor,
+    derivatives: Option<Derivatives<'_, CudaVertexBuffer>>,
+    second_derivatives: Option<SecondDerivatives<'_, CudaVertexBuffer>>,
+    patch_coords: &[PatchCoord],
+    patch_table: &CudaPatchTable,
+) -> Result<()> {
+    let coord_count = check_patch_coords(patch_table.patch_table, patch_coords)?;
+    let outputs = resolve_outputs(
+        src_buffer,
+        src_desc,
+        patch_table.patch_table.point_count(),
+        dst_buffer,
+        dst_desc,
+        derivatives,
+        second_derivatives,
+        patch_coords.len(),
+    )?;
+    let [dst, du, dv, duu, duv, dvv] = outputs.buffers;
+    let [dst_desc, du_desc, dv_desc, duu_desc, duv_desc, dvv_desc] = outputs.descs;
+
+    unsafe {
+        if sys::osd::CudaEvaluator_EvalPatches(
+            src_buffer.0,
+            src_desc.0,
+            dst,
+            dst_desc,
+            du,
+            du_desc,
+            dv,
+            dv_desc,
+            duu,
+            duu_desc,
+            duv,
+            duv_desc,
+            dvv,
+            dvv_desc,
+            coord_count,
+            patch_coords.as_ptr() as *const _,
+            patch_table.ptr,
+        ) {
+            Ok(())
+        } else {
+            Err(Error::EvalPatchesFailed)
+        }
+    }
+}
+
+/// CUDA-specific limit stencil table, including derivative weights.
+///
+/// This wraps a [`LimitStencilTable`] for use with
+/// [`evaluate_stencils_with_derivatives()`].
+pub struct CudaLimitStencilTable<'a> {
+    pub(crate) ptr: sys::osd::CudaStencilTablePtr,
+    stencil_table: &'a LimitStencilTable,
+}
+
+impl<'a> CudaLimitStencilTable<'a> {
+    /// Upload a [`LimitStencilTable`] to the GPU.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the CUDA stencil table creation fails.
+    pub fn new(stencil_table: &'a LimitStencilTable) -> Result<Self> {
+        let ptr = unsafe { sys::osd::CudaStencilTable_CreateFromLimit(stencil_table.as_ptr()) };
+        if ptr.is_null() {
+            return Err(Error::GpuBackend(
+                "Could not create CudaStencilTable".to_string(),
+            ));
+        }
+
+        Ok(Self { ptr, stencil_table })
+    }
+}
+
+impl Drop for CudaLimitStencilTable<'_> {
+    fn drop(&mut self) {
+        unsafe {
+            sys::osd::CudaStencilTable_destroy(self.ptr);
+        }
+    }
+}
+
+/// CUDA-specific patch table for GPU patch evaluation.
+///
+/// This wraps a [`PatchTable`] for use with [`evaluate_patches()`]. The
+/// patch table is kept borrowed to validate patch coordinates.
+pub struct CudaPatchTable<'a> {
+    pub(crate) ptr: sys::osd::CudaPatchTablePtr,
+    patch_table: &'a PatchTable,
+}
+
+impl<'a> CudaPatchTable<'a> {
+    /// Upload a [`PatchTable`] to the GPU.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the CUDA patch table creation fails.
+    pub fn new(patch_table: &'a PatchTable) -> Result<Self> {
+        let ptr = unsafe { sys::osd::CudaPatchTable_Create(patch_table.as_ptr()) };
+        if ptr.is_null() {
+            return Err(Error::GpuBackend(
+                "Could not create CudaPatchTable".to_string(),
+            ));
+        }
+
+        Ok(Self { ptr, patch_table })
+    }
+}
+
+impl Drop for CudaPatchTable<'_> {
+    fn drop(&mut self) {
+        unsafe {
+            sys::osd::CudaPatchTable_destroy(self.ptr);
+        }
+    }
+}
@@ -175,3 +175,343 @@ impl CudaVertexBuffer {
         Ok(())
     }
 }
+
+impl super::types::VertexBuffer for CudaVertexBuffer {
+    type Raw = sys::osd::CudaVertexBuffer_obj;
+
+    #[inline]
+    fn as_raw(&self) -> *mut Self::Raw {
+        self.0
+    }
+
+    #[inline]
+    fn float_count(&self) -> usize {
+        self.element_count() * self.vertex_count()
+    }
+}
+
+impl CudaVertexBuffer {
+    /// Enqueue an upload of `vertex_count` vertices from `src` on `stream`.
+    ///
+    /// `src` holds the vertices back to back, `element_count()` floats each,
+    /// starting at its first float. The copy does not block the host; `src`
+    /// records the transfer and waits for it before it is next accessed or
+    /// dropped, so it can be refilled safely once
+    /// [`CudaPinnedBuffer::as_mut_slice()`] returns.
+    ///
+    /// # Errors
+    /// Returns error if `src` is too small, if the range is out of bounds or
+    /// if the copy could not be enqueued.
+    pub fn update_data_async(
+        &mut self,
+        src: &mut CudaPinnedBuffer,
+        start_vertex: usize,
+        vertex_count: usize,
+        stream: &CudaStream,
+    ) -> Result<()> {
+        let (start, count) = self.check_async_range(src, start_vertex, vertex_count)?;
+        if !unsafe {
+            sys::osd::CudaVertexBuffer_UpdateDataAsync(
+                self.0,
+                src.ptr.as_ptr(),
+                start,
+                count,
+                stream.ptr,
+            )
+        } {
+            return Err(Error::GpuBackend(
+                "Failed to enqueue CUDA vertex buffer upload".to_string(),
+            ));
+        }
+        src.pending = Some(stream.record()?);
+        Ok(())
+    }
+
+    /// Enqueue a readback of `vertex_count` vertices into `dst` on `stream`.
+    ///
+    /// The vertices are written to the front of `dst`. The copy does not
+    /// block the host; `dst` records the transfer and waits for it before
+    /// it is next accessed or dropped.
+    ///
+    /// # Errors
+    /// Returns error if `dst` is too small, if the range is out of bounds or
+    /// if the copy could not be enqueued.
+    pub fn read_data_async(
+        &self,
+        dst: &mut CudaPinnedBuffer,
+        start_vertex: usize,
+        vertex_count: usize,
+        stream: &CudaStream,
+    ) -> Result<()> {
+        let (start, count) = self.check_async_range(dst, start_vertex, vertex_count)?;
+        if !unsafe {
+            sys::osd::CudaVertexBuffer_ReadDataAsync(
+                self.0,
+                dst.ptr.as_ptr(),
+                start,
+                count,
+                stream.ptr,
+            )
+        } {
+            return Err(Error::GpuBackend(
+                "Failed to enqueue CUDA vertex buffer readback".to_string(),
+            ));
+        }
+        dst.pending = Some(stream.record()?);
+        Ok(())
+    }
+
+    /// Checks an async transfer range against this buffer and `staging`.
+    fn check_async_range(
+        &self,
+        staging: &mut CudaPinnedBuffer,
+        start_vertex: usize,
+        vertex_count: usize,
+    ) -> Result<(i32, i32)> {
+        let total_vertices = self.vertex_count();
+        if start_vertex + vertex_count > total_vertices {
+            return Err(Error::IndexOutOfBounds {
+                index: start_vertex + vertex_count,
+                max: total_vertices,
+            });
+        }
+        let floats = vertex_count * self.element_count();
+        if floats > staging.len() {
+            return Err(Error::InvalidBufferSize {
+                expected: floats,
+                actual: staging.len(),
+            });
+        }
+        // A previous transfer may still be reading or writing the range.
+        staging.wait()?;
+
+        // Both fit an i32 since they are bounded by `vertex_count()`.
+        Ok((start_vertex as i32, vertex_count as i32))
+    }
+}
+
+/// A CUDA stream that uploads and readbacks can be enqueued on.
+///
+/// Work on different streams may overlap; use [`CudaStream::record()`] and
+/// [`CudaStream::wait_event()`] to order it.
+///
+/// OpenSubdiv's CUDA kernels always run on the legacy default stream, see
+/// [`CudaStream::legacy()`]. To pipeline frames, upload frame N+1 on one
+/// stream while frame N evaluates, make the default stream wait for the
+/// upload before evaluating it, and read the results back on another stream
+/// that waits for an event recorded on the default stream after the
+/// evaluation.
+#[derive(Debug)]
+pub struct CudaStream {
+    ptr: sys::osd::CudaStreamPtr,
+    owned: bool,
+}
+
+// AIDEV-NOTE: CUDA streams can be used from any host thread; the runtime
+// serializes calls on the same stream itself.
+unsafe impl Send for CudaStream {}
+unsafe impl Sync for CudaStream {}
+
+impl Drop for CudaStream {
+    #[inline]
+    fn drop(&mut self) {
+        if self.owned {
+            unsafe { sys::osd::CudaStream_destroy(self.ptr) }
+        }
+    }
+}
+
+impl CudaStream {
+    /// Create a new non-blocking stream.
+    ///
+    /// Work on it does not implicitly synchronize with the legacy default
+    /// stream.
+    pub fn new() -> Result<CudaStream> {
+        let ptr = unsafe { sys::osd::CudaStream_Create() };
+        if ptr.is_null() {
+            return Err(Error::GpuBackend(
+                "Failed to create CUDA stream".to_string(),
+            ));
+        }
+        Ok(CudaStream { ptr, owned: true })
+    }
+
+    /// The legacy default stream the
+    /// [`evaluate_stencils()`](crate::osd::cuda_evaluator::evaluate_stencils())
+    /// family of functions runs on.
+    #[inline]
+    pub fn legacy() -> CudaStream {
+        CudaStream {
+            ptr: std::ptr::null_mut(),
+            owned: false,
+        }
+    }
+
+    /// Record an event that completes once all work enqueued on this stream
+    /// so far has finished.
+    pub fn record(&self) -> Result<CudaEvent> {
+        let event = CudaEvent::new()?;
+        if !unsafe { sys::osd::CudaEvent_Record(event.0, self.ptr) } {
+            return Err(Error::GpuBackend("Failed to record CUDA event".to_string()));
+        }
+        Ok(event)
+    }
+
+    /// Make all work enqueued on this stream from now on wait for `event`.
+    ///
+    /// This does not block the host.
+    pub fn wait_event(&self, event: &CudaEvent) -> Result<()> {
+        if !unsafe { sys::osd::CudaStream_WaitEvent(self.ptr, event.0) } {
+            return Err(Error::GpuBackend(
+                "Failed to make CUDA stream wait for event".to_string(),
+            ));
+        }
+        Ok(())
+    }
+
+    /// Block until all work enqueued on this stream has finished.
+    pub fn synchronize(&self) -> Result<()> {
+        if !unsafe { sys::osd::CudaStream_Synchronize(self.ptr) } {
+            return Err(Error::GpuBackend(
+                "Failed to synchronize CUDA stream".to_string(),
+            ));
+        }
+        Ok(())
+    }
+}
+
+/// A point in a [`CudaStream`] returned by [`CudaStream::record()`].
+#[derive(Debug)]
+pub struct CudaEvent(sys::osd::CudaEventPtr);
+
+// AIDEV-NOTE: See the note on `CudaStream`.
+unsafe impl Send for CudaEvent {}
+unsafe impl Sync for CudaEvent {}
+
+impl Drop for CudaEvent {
+    #[inline]
+    fn drop(&mut self) {
+        unsafe { sys::osd::CudaEvent_destroy(self.0) }
+    }
+}
+
+impl CudaEvent {
+    fn new() -> Result<CudaEvent> {
+        let ptr = unsafe { sys::osd::CudaEvent_Create() };
+        if ptr.is_null() {
+            return Err(Error::GpuBackend("Failed to create CUDA event".to_string()));
+        }
+        Ok(CudaEvent(ptr))
+    }
+
+    /// Returns whether the work before this event has finished, without
+    /// blocking.
+    pub fn is_complete(&self) -> Result<bool> {
+        match unsafe { sys::osd::CudaEvent_Query(self.0) } {
+            1 => Ok(true),
+            0 => Ok(false),
+            _ => Err(Error::GpuBackend("Failed to query CUDA event".to_string())),
+        }
+    }
+
+    /// Block until the work before this event has finished.
+    pub fn synchronize(&self) -> Result<()> {
+        if !unsafe { sys::osd::CudaEvent_Synchronize(self.0) } {
+            return Err(Error::GpuBackend(
+                "Failed to synchronize CUDA event".to_string(),
+            ));
+        }
+        Ok(())
+    }
+}
+
+/// Page-locked host memory to stage asynchronous transfers through.
+///
+/// Copies from and to pageable memory are synchronous; only pinned memory
+/// lets [`CudaVertexBuffer::update_data_async()`] and
+/// [`CudaVertexBuffer::read_data_async()`] overlap with other work. The
+/// buffer remembers its last transfer and waits for it before handing out
+/// its contents.
+#[derive(Debug)]
+pub struct CudaPinnedBuffer {
+    ptr: NonNull<f32>,
+    len: usize,
+    pending: Option<CudaEvent>,
+}
+
+// AIDEV-NOTE: The memory is only reachable through `&mut self` accessors
+// that wait for pending transfers first.
+unsafe impl Send for CudaPinnedBuffer {}
+unsafe impl Sync for CudaPinnedBuffer {}
+
+impl Drop for CudaPinnedBuffer {
+    fn drop(&mut self) {
+        // The device may still be copying from or to the memory.
+        let _ = self.wait();
+        unsafe { sys::osd::CudaHostBuffer_destroy(self.ptr.as_ptr() as *mut _) }
+    }
+}
+
+impl CudaPinnedBuffer {
+    /// Allocate `len` zeroed floats of pinned host memory.
+    pub fn new(len: usize) -> Result<CudaPinnedBuffer> {
+        let bytes =
+            len.max(1)
+                .checked_mul(std::mem::size_of::<f32>())
+                .ok_or(Error::InvalidBufferSize {
+                    expected: len,
+                    actual: usize::MAX / std::mem::size_of::<f32>(),
+                })?;
+        let ptr = NonNull::new(unsafe { sys::osd::CudaHostBuffer_Create(bytes) } as *mut f32)
+            .ok_or_else(|| {
+                Error::GpuBackend("Failed to allocate pinned host memory".to_string())
+            })?;
+        unsafe { std::ptr::write_bytes(ptr.as_ptr(), 0, len) };
+        Ok(CudaPinnedBuffer {
+            ptr,
+            len,
+            pending: None,
+        })
+    }
+
+    /// Returns the number of floats in this buffer.
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    /// Returns `true` if this buffer holds no floats.
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// Returns whether the last transfer through this buffer has finished,
+    /// without blocking.
+    pub fn is_ready(&self) -> Result<bool> {
+        self.pending
+            .as_ref()
+            .map_or(Ok(true), CudaEvent::is_complete)
+    }
+
+    /// Block until the last transfer through this buffer has finished.
+    pub fn wait(&mut self) -> Result<()> {
+        if let Some(event) = self.pending.take() {
+            event.synchronize()?;
+        }
+        Ok(())
+    }
+
+    /// Get the contents of this buffer, waiting for a pending readback.
+    pub fn as_slice(&mut self) -> Result<&[f32]> {
+        self.wait()?;
+        Ok(unsafe { std::slice::from_raw_parts(self.ptr.as_ptr(), self.len) })
+    }
+
+    /// Get the contents of this buffer for filling, waiting for a pending
+    /// upload.
+    pub fn as_mut_slice(&mut self) -> Result<&mut [f32]> {
+        self.wait()?;
+        Ok(unsafe { std::slice::from_raw_parts_mut(self.ptr.as_ptr(), self.len) })
+    }
+}
@@ -1,6 +1,10 @@
 use super::buffer_descriptor::BufferDescriptor;
 use super::metal_vertex_buffer::{MetalCommandBuffer, MetalDevice, MetalVertexBuffer};
-use crate::far::StencilTable;
+use super::types::{
+    check_compiled_layout, check_limit_stencils, check_patch_coords, resolve_outputs, Derivatives,
+    PatchCoord, SecondDerivatives,
+};
+use crate::far::{LimitStencilTable, PatchTable, StencilTable};
 
 use opensubdiv_petite_sys as sys;
 
@@ -107,3 +111,365 @@ impl Drop for MetalStencilTable<'_> {
         }
     }
 }
+
+/// Safe wrapper for an `Osd::MTLContext`, the device and command queue the
+/// Metal evaluators and tables are created on.
+#[derive(Debug)]
+pub struct MetalContext<'a> {
+    ptr: NonNull<std::ffi::c_void>,
+    _marker: PhantomData<&'a std::ffi::c_void>,
+}
+
+impl<'a> MetalContext<'a> {
+    /// Create a new Metal context wrapper from a raw pointer.
+    ///
+    /// # Safety
+    ///
+    /// The caller must ensure that the pointer is a valid `Osd::MTLContext`
+    /// and remains valid for the lifetime 'a.
+    pub unsafe fn from_ptr(ptr: *mut std::ffi::c_void) -> Option<MetalContext<'a>> {
+        NonNull::new(ptr).map(|ptr| MetalContext {
+            ptr,
+            _marker: PhantomData,
+        })
+    }
+
+    /// Get the raw pointer for FFI calls.
+    pub(crate) fn as_ptr(&self) -> *mut std::ffi::c_void {
+        self.ptr.as_ptr()
+    }
+}
+
+/// Metal evaluator compiled for one buffer layout.
+///
+/// The evaluator kernels are specialized for the lengths and strides of the
+/// descriptors given at creation; evaluations must use the same layouts,
+/// with any offsets.
+pub struct MetalComputeEvaluator<'a> {
+    ptr: sys::osd::MetalComputeEvaluatorPtr,
+    descs: [BufferDescriptor; 7],
+    _marker: PhantomData<&'a std::ffi::c_void>,
+}
+
+impl<'a> MetalComputeEvaluator<'a> {
+    /// Compile an evaluator for the given layouts.
+    ///
+    /// `derivative_descs` holds the `du` and `dv` layouts and
+    /// `second_derivative_descs` the `duu`, `duv` and `dvv` layouts; `None`
+    /// compiles the evaluator without those outputs.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the kernels fail to compile.
+    pub fn new(
+        src_desc: BufferDescriptor,
+        dst_desc: BufferDescriptor,
+        derivative_descs: Option<[BufferDescriptor; 2]>,
+        second_derivative_descs: Option<[BufferDescriptor; 3]>,
+        context: &MetalContext,
+    ) -> Result<Self> {
+        let [du_desc, dv_desc] = derivative_descs.unwrap_or_default();
+        let [duu_desc, duv_desc, dvv_desc] = second_derivative_descs.unwrap_or_default();
+        let descs = [
+            src_desc, dst_desc, du_desc, dv_desc, duu_desc, duv_desc, dvv_desc,
+        ];
+        let ptr = unsafe {
+            sys::osd::MTLComputeEvaluator_Create(
+                src_desc.0,
+                dst_desc.0,
+                du_desc.0,
+                dv_desc.0,
+                duu_desc.0,
+                duv_desc.0,
+                dvv_desc.0,
+                context.as_ptr() as *const _,
+            )
+        };
+        if ptr.is_null() {
+            return Err(Error::GpuBackend(
+                "Could not create MTLComputeEvaluator".to_string(),
+            ));
+        }
+
+        Ok(Self {
+            ptr,
+            descs,
+            _marker: PhantomData,
+        })
+    }
+}
+
+impl Drop for MetalComputeEvaluator<'_> {
+    fn drop(&mut self) {
+        unsafe {
+            sys::osd::MTLComputeEvaluator_destroy(self.ptr);
+        }
+    }
+}
+
+/// Metal-specific limit stencil table, including derivative weights.
+pub struct MetalLimitStencilTable<'a> {
+    pub(crate) ptr: sys::osd::MetalStencilTablePtr,
+    stencil_table: &'a LimitStencilTable,
+}
+
+impl<'a> MetalLimitStencilTable<'a> {
+    /// Upload a [`LimitStencilTable`] to the GPU.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the stencil table creation fails.
+    pub fn new(stencil_table: &'a LimitStencilTable, context: &MetalContext) -> Result<Self> {
+        let ptr = unsafe {
+            sys::osd::MTLStencilTable_CreateFromLimit(
+                stencil_table.as_ptr(),
+                context.as_ptr() as *const _,
+            )
+        };
+        if ptr.is_null() {
+            return Err(Error::GpuBackend(
+                "Could not create MTLStencilTable".to_string(),
+            ));
+        }
+
+        Ok(Self { ptr, stencil_table })
+    }
+}
+
+impl Drop for MetalLimitStencilTable<'_> {
+    fn drop(&mut self) {
+        unsafe {
+            sys::osd::MTLStencilTable_destroy(self.ptr);
+        }
+    }
+}
+
+/// Metal-specific patch table for GPU patch evaluation.
+///
+/// The patch table is kept borrowed to validate patch coordinates.
+pub struct MetalPatchTable<'a> {
+    pub(crate) ptr: sys::osd::MetalPatchTablePtr,
+    patch_table: &'a PatchTable,
+}
+
+impl<'a> MetalPatchTable<'a> {
+    /// Upload a [`PatchTable`] to the GPU.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the patch table creation fails.
+    pub fn new(patch_table: &'a PatchTable, context: &MetalContext) -> Result<Self> {
+        let ptr = unsafe {
+            sys::osd::MTLPatchTable_Create(patch_table.as_ptr(), context.as_ptr() as *const _)
+        };
+        if ptr.is_null() {
+            return Err(Error::GpuBackend(
+                "Could not create MTLPatchTable".to_string(),
+            ));
+        }
+
+        Ok(Self { ptr, patch_table })
+    }
+}
+
+impl Drop for MetalPatchTable<'_> {
+    fn drop(&mut self) {
+        unsafe {
+            sys::osd::MTLPatchTable_destroy(self.ptr);
+        }
+    }
+}
+
+/// Evaluate limit stencils with derivatives with `evaluator`.
+///
+/// Writes limit positions to `dst_buffer` and 1st derivatives to
+/// `derivatives`; 2nd derivatives are written to `second_derivatives` if
+/// given.
+///
+/// # Errors
+///
+/// Returns [`Error::FeatureNotAvailable`] if the stencil table lacks the
+/// requested derivative weights or `evaluator` was compiled without them,
+/// [`Error::InvalidBufferDescriptor`] if a descriptor does not match the
+/// layout `evaluator` was compiled for or interleaved outputs overlap and
+/// [`Error::InvalidBufferSize`] if a buffer is too small.
+#[allow(clippy::too_many_arguments)]
+pub fn evaluate_stencils_with_derivatives(
+    evaluator: &MetalComputeEvaluator,
+    src_buffer: &MetalVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut MetalVertexBuffer,
+    dst_desc: BufferDescriptor,
+    derivatives: Derivatives<'_, MetalVertexBuffer>,
+    second_derivatives: Option<SecondDerivatives<'_, MetalVertexBuffer>>,
+    stencil_table: &MetalLimitStencilTable,
+    context: &MetalContext,
+) -> Result<()> {
+    let st = stencil_table.stencil_table;
+    check_limit_stencils(st, second_derivatives.is_some())?;
+    let outputs = resolve_outputs(
+        src_buffer,
+        src_desc,
+        st.control_vertex_count(),
+        dst_buffer,
+        dst_desc,
+        Some(derivatives),
+        second_derivatives,
+        st.len(),
+    )?;
+    check_compiled_layout(&evaluator.descs, src_desc, &outputs)?;
+    let [dst, du, dv, duu, duv, dvv] = outputs.buffers;
+    let [dst_desc, du_desc, dv_desc, duu_desc, duv_desc, dvv_desc] = outputs.descs;
+
+    unsafe {
+        if sys::osd::MTLComputeEvaluator_EvalStencilsWithDerivatives(
+            evaluator.ptr,
+            src_buffer.0,
+            src_desc.0,
+            dst,
+            dst_desc,
+            du,
+            du_desc,
+            dv,
+            dv_desc,
+            duu,
+            duu_desc,
+            duv,
+            duv_desc,
+            dvv,
+            dvv_desc,
+            stencil_table.ptr,
+            context.as_ptr() as *const _,
+        ) {
+            Ok(())
+        } else {
+            Err(Error::EvalStencilsFailed)
+        }
+    }
+}
+
+/// Evaluate the limit surface of a patch table at `patch_coords` with
+/// `evaluator`.
+///
+/// `src_buffer` holds the patch control points: the refined vertices
+/// followed by the local points of the patch table. `patch_coords` are
+/// uploaded for the duration of the call.
+///
+/// # Errors
+///
+/// Returns [`Error::InvalidPatch`] if a coordinate refers to a patch not in
+/// the patch table; see [`evaluate_stencils_with_derivatives()`] for the
+/// buffer errors.
+#[allow(clippy::too_many_arguments)]
+pub fn evaluate_patches(
+    evaluator: &MetalComputeEvaluator,
+    src_buffer: &MetalVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut MetalVertexBuffer,
+    dst_desc: BufferDescriptor,
+    patch_coords: &[PatchCoord],
+    patch_table: &MetalPatchTable,
+    context: &MetalContext,
+) -> Result<()> {
+    eval_patches(
+        evaluator,
+        src_buffer,
+        src_desc,
+        dst_buffer,
+        dst_desc,
+        None,
+        None,
+        patch_coords,
+        patch_table,
+        context,
+    )
+}
+
+/// Evaluate the limit surface of a patch table and its derivatives at
+/// `patch_coords` with `evaluator`.
+///
+/// Like [`evaluate_patches()`], also writing 1st derivatives to
+/// `derivatives` and, if given, 2nd derivatives to `second_derivatives`.
+#[allow(clippy::too_many_arguments)]
+pub fn evaluate_patches_with_derivatives(
+    evaluator: &MetalComputeEvaluator,
+    src_buffer: &MetalVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut MetalVertexBuffer,
+    dst_desc: BufferDescriptor,
+    derivatives: Derivatives<'_, MetalVertexBuffer>,
+    second_derivatives: Option<SecondDerivatives<'_, MetalVertexBuffer>>,
+    patch_coords: &[PatchCoord],
+    patch_table: &MetalPatchTable,
+    context: &MetalContext,
+) -> Result<()> {
+    eval_patches(
+        evaluator,
+        src_buffer,
+        src_desc,
+        dst_buffer,
+        dst_desc,
+        Some(derivatives),
+        second_derivatives,
+        patch_coords,
+        patch_table,
+        context,
+    )
+}
+
+#[allow(clippy::too_many_arguments)]
+fn eval_patches(
+    evaluator: &MetalComputeEvaluator,
+    src_buffer: &MetalVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut MetalVertexBuffer,
+    dst_desc: BufferDescriptor,
+    derivatives: Option<Derivatives<'_, MetalVertexBuffer>>,
+    second_derivatives: Option<SecondDerivatives<'_, MetalVertexBuffer>>,
+    patch_coords: &[PatchCoord],
+    patch_table: &MetalPatchTable,
+    context: &MetalContext,
+) -> Result<()> {
+    let coord_count = check_patch_coords(patch_table.patch_table, patch_coords)?;
+    let outputs = resolve_outputs(
+        src_buffer,
+        src_desc,
+        patch_table.patch_table.point_count(),
+        dst_buffer,
+        dst_desc,
+        derivatives,
+        second_derivatives,
+        patch_coords.len(),
+    )?;
+    check_compiled_layout(&evaluator.descs, src_desc, &outputs)?;
+    let [dst, du, dv, duu, duv, dvv] = outputs.buffers;
+    let [dst_desc, du_desc, dv_desc, duu_desc, duv_desc, dvv_desc] = outputs.descs;
+
+    unsafe {
+        if sys::osd::MTLComputeEvaluator_EvalPatches(
+            evaluator.ptr,
+            src_buffer.0,
+            src_desc.0,
+            dst,
+            dst_desc,
+            du,
+            du_desc,
+            dv,
+            dv_desc,
+            duu,
+            duu_desc,
+            duv,
+            duv_desc,
+            dvv,
+            dvv_desc,
+            coord_count,
+            patch_coords.as_ptr() as *const _,
+            patch_table.ptr,
+            context.as_ptr() as *const _,
+        ) {
+            Ok(())
+        } else {
+            Err(Error::EvalPatchesFailed)
+        }
+    }
+}
@@ -127,6 +127,49 @@ impl MetalVertexBuffer {
         unsafe { sys::osd::MTLVertexBuffer_GetMTLBuffer(self.0) }
     }
 
+    /// Get the shared storage of this vertex buffer as a slice of [`f32`]s.
+    ///
+    /// On unified memory devices the CPU reads the results of an evaluation
+    /// here in place instead of copying them out. The contents are only
+    /// meaningful once the command buffers writing them have completed.
+    ///
+    /// # Errors
+    /// Returns [`Error::FeatureNotAvailable`] if the buffer is not in shared
+    /// storage.
+    #[inline]
+    pub fn contents(&self) -> Result<&[f32]> {
+        let ptr = self.contents_ptr()?;
+        Ok(unsafe { std::slice::from_raw_parts(ptr, self.element_count() * self.vertex_count()) })
+    }
+
+    /// Get the shared storage of this vertex buffer as a mutable slice of
+    /// [`f32`]s.
+    ///
+    /// Writing coarse vertices here replaces
+    /// [`update_data()`](Self::update_data()) and its copy. Do not write
+    /// while command buffers reading the buffer are in flight.
+    ///
+    /// # Errors
+    /// Returns [`Error::FeatureNotAvailable`] if the buffer is not in shared
+    /// storage.
+    #[inline]
+    pub fn contents_mut(&mut self) -> Result<&mut [f32]> {
+        let ptr = self.contents_ptr()?;
+        Ok(unsafe {
+            std::slice::from_raw_parts_mut(ptr, self.element_count() * self.vertex_count())
+        })
+    }
+
+    fn contents_ptr(&self) -> Result<*mut f32> {
+        let ptr = unsafe { sys::osd::MTLVertexBuffer_GetContents(self.0) };
+        if ptr.is_null() {
+            return Err(Error::FeatureNotAvailable(
+                "Metal vertex buffer is not in shared storage".to_string(),
+            ));
+        }
+        Ok(ptr)
+    }
+
     /// This method is meant to be used in client code in order to provide
     /// coarse vertices data to *OpenSubdiv*.
     #[inline]
@@ -177,3 +220,17 @@ impl MetalVertexBuffer {
         Ok(())
     }
 }
+
+impl super::types::VertexBuffer for MetalVertexBuffer {
+    type Raw = sys::osd::MetalVertexBuffer_obj;
+
+    #[inline]
+    fn as_raw(&self) -> *mut Self::Raw {
+        self.0
+    }
+
+    #[inline]
+    fn float_count(&self) -> usize {
+        self.element_count() * self.vertex_count()
+    }
+}
@@ -35,8 +35,14 @@
 pub mod buffer_descriptor;
 pub use buffer_descriptor::*;
 
+pub mod types;
+pub use types::*;
+
 pub mod cpu_evaluator;
 
+pub mod cpu_patch_table;
+pub use cpu_patch_table::*;
+
 pub mod cpu_vertex_buffer;
 pub use cpu_vertex_buffer::*;
 
@@ -49,7 +55,7 @@ pub use cuda_vertex_buffer::*;
 pub mod cuda_evaluator;
 // Don't use wildcard export to avoid evaluate_stencils name conflicts
 #[cfg(feature = "cuda")]
-pub use cuda_evaluator::CudaStencilTable;
+pub use cuda_evaluator::{CudaLimitStencilTable, CudaPatchTable, CudaStencilTable};
 
 #[cfg(feature = "metal")]
 pub mod metal_vertex_buffer;
@@ -60,7 +66,9 @@ pub use metal_vertex_buffer::*;
 pub mod metal_evaluator;
 // Don't use wildcard export to avoid evaluate_stencils name conflicts
 #[cfg(feature = "metal")]
-pub use metal_evaluator::MetalStencilTable;
+pub use metal_evaluator::{
+    MetalComputeEvaluator, MetalContext, MetalLimitStencilTable, MetalPatchTable, MetalStencilTable,
+};
 
 #[cfg(feature = "opencl")]
 pub mod opencl_vertex_buffer;
@@ -71,11 +79,16 @@ pub use opencl_vertex_buffer::*;
 pub mod opencl_evaluator;
 // Don't use wildcard export to avoid evaluate_stencils name conflicts
 #[cfg(feature = "opencl")]
-pub use opencl_evaluator::OpenClStencilTable;
+pub use opencl_evaluator::{
+    OpenClEvaluator, OpenClLimitStencilTable, OpenClPatchTable, OpenClStencilTable,
+};
 
 #[cfg(feature = "openmp")]
 pub mod omp_evaluator;
 
+#[cfg(feature = "rayon")]
+pub mod rayon_evaluator;
+
 #[cfg(feature = "tbb")]
 pub mod tbb_evaluator;
 
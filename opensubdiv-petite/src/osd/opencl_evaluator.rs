@@ -1,6 +1,12 @@
 use super::buffer_descriptor::BufferDescriptor;
-use super::opencl_vertex_buffer::{OpenClCommandQueue, OpenClContext, OpenClVertexBuffer};
-use crate::far::StencilTable;
+use super::opencl_vertex_buffer::{
+    raw_events, OpenClCommandQueue, OpenClContext, OpenClEvent, OpenClVertexBuffer,
+};
+use super::types::{
+    check_compiled_layout, check_limit_stencils, check_patch_coords, resolve_outputs, Derivatives,
+    PatchCoord, SecondDerivatives,
+};
+use crate::far::{LimitStencilTable, PatchTable, StencilTable};
 
 use opensubdiv_petite_sys as sys;
 
@@ -124,3 +130,414 @@ impl Drop for OpenClStencilTable<'_> {
         }
     }
 }
+
+/// OpenCL evaluator compiled for one buffer layout.
+///
+/// The evaluator kernels are specialized for the lengths and strides of the
+/// descriptors given at creation; evaluations must use the same layouts,
+/// with any offsets.
+pub struct OpenClEvaluator<'a> {
+    ptr: sys::osd::OpenCLEvaluatorPtr,
+    descs: [BufferDescriptor; 7],
+    _marker: PhantomData<&'a std::ffi::c_void>,
+}
+
+impl<'a> OpenClEvaluator<'a> {
+    /// Compile an evaluator for the given layouts.
+    ///
+    /// `derivative_descs` holds the `du` and `dv` layouts and
+    /// `second_derivative_descs` the `duu`, `duv` and `dvv` layouts; `None`
+    /// compiles the evaluator without those outputs.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the kernels fail to compile.
+    pub fn new(
+        src_desc: BufferDescriptor,
+        dst_desc: BufferDescriptor,
+        derivative_descs: Option<[BufferDescriptor; 2]>,
+        second_derivative_descs: Option<[BufferDescriptor; 3]>,
+        context: &OpenClContext,
+        command_queue: &OpenClCommandQueue,
+    ) -> Result<Self> {
+        let [du_desc, dv_desc] = derivative_descs.unwrap_or_default();
+        let [duu_desc, duv_desc, dvv_desc] = second_derivative_descs.unwrap_or_default();
+        let descs = [
+            src_desc, dst_desc, du_desc, dv_desc, duu_desc, duv_desc, dvv_desc,
+        ];
+        let ptr = unsafe {
+            sys::osd::CLEvaluator_Create(
+                src_desc.0,
+                dst_desc.0,
+                du_desc.0,
+                dv_desc.0,
+                duu_desc.0,
+                duv_desc.0,
+                dvv_desc.0,
+                context.as_ptr() as *const _,
+                command_queue.as_ptr() as *const _,
+            )
+        };
+        if ptr.is_null() {
+            return Err(Error::GpuBackend(
+                "Could not create CLEvaluator".to_string(),
+            ));
+        }
+
+        Ok(Self {
+            ptr,
+            descs,
+            _marker: PhantomData,
+        })
+    }
+}
+
+impl Drop for OpenClEvaluator<'_> {
+    fn drop(&mut self) {
+        unsafe {
+            sys::osd::CLEvaluator_destroy(self.ptr);
+        }
+    }
+}
+
+/// OpenCL-specific limit stencil table, including derivative weights.
+pub struct OpenClLimitStencilTable<'a> {
+    pub(crate) ptr: sys::osd::OpenCLStencilTablePtr,
+    stencil_table: &'a LimitStencilTable,
+}
+
+impl<'a> OpenClLimitStencilTable<'a> {
+    /// Upload a [`LimitStencilTable`] to the GPU.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the stencil table creation fails.
+    pub fn new(stencil_table: &'a LimitStencilTable, context: &OpenClContext) -> Result<Self> {
+        let ptr = unsafe {
+            sys::osd::CLStencilTable_CreateFromLimit(
+                stencil_table.as_ptr(),
+                context.as_ptr() as *const _,
+            )
+        };
+        if ptr.is_null() {
+            return Err(Error::GpuBackend(
+                "Could not create CLStencilTable".to_string(),
+            ));
+        }
+
+        Ok(Self { ptr, stencil_table })
+    }
+}
+
+impl Drop for OpenClLimitStencilTable<'_> {
+    fn drop(&mut self) {
+        unsafe {
+            sys::osd::CLStencilTable_destroy(self.ptr);
+        }
+    }
+}
+
+/// OpenCL-specific patch table for GPU patch evaluation.
+///
+/// The patch table is kept borrowed to validate patch coordinates.
+pub struct OpenClPatchTable<'a> {
+    pub(crate) ptr: sys::osd::OpenCLPatchTablePtr,
+    patch_table: &'a PatchTable,
+}
+
+impl<'a> OpenClPatchTable<'a> {
+    /// Upload a [`PatchTable`] to the GPU.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the patch table creation fails.
+    pub fn new(patch_table: &'a PatchTable, context: &OpenClContext) -> Result<Self> {
+        let ptr = unsafe {
+            sys::osd::CLPatchTable_Create(patch_table.as_ptr(), context.as_ptr() as *const _)
+        };
+        if ptr.is_null() {
+            return Err(Error::GpuBackend(
+                "Could not create CLPatchTable".to_string(),
+            ));
+        }
+
+        Ok(Self { ptr, patch_table })
+    }
+}
+
+impl Drop for OpenClPatchTable<'_> {
+    fn drop(&mut self) {
+        unsafe {
+            sys::osd::CLPatchTable_destroy(self.ptr);
+        }
+    }
+}
+
+/// Evaluate limit stencils with derivatives with `evaluator`.
+///
+/// Writes limit positions to `dst_buffer` and 1st derivatives to
+/// `derivatives`; 2nd derivatives are written to `second_derivatives` if
+/// given.
+///
+/// # Errors
+///
+/// Returns [`Error::FeatureNotAvailable`] if the stencil table lacks the
+/// requested derivative weights or `evaluator` was compiled without them,
+/// [`Error::InvalidBufferDescriptor`] if a descriptor does not match the
+/// layout `evaluator` was compiled for or interleaved outputs overlap and
+/// [`Error::InvalidBufferSize`] if a buffer is too small.
+#[allow(clippy::too_many_arguments)]
+pub fn evaluate_stencils_with_derivatives(
+    evaluator: &OpenClEvaluator,
+    src_buffer: &OpenClVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut OpenClVertexBuffer,
+    dst_desc: BufferDescriptor,
+    derivatives: Derivatives<'_, OpenClVertexBuffer>,
+    second_derivatives: Option<SecondDerivatives<'_, OpenClVertexBuffer>>,
+    stencil_table: &OpenClLimitStencilTable,
+) -> Result<()> {
+    let st = stencil_table.stencil_table;
+    check_limit_stencils(st, second_derivatives.is_some())?;
+    let outputs = resolve_outputs(
+        src_buffer,
+        src_desc,
+        st.control_vertex_count(),
+        dst_buffer,
+        dst_desc,
+        Some(derivatives),
+        second_derivatives,
+        st.len(),
+    )?;
+    check_compiled_layout(&evaluator.descs, src_desc, &outputs)?;
+    let [dst, du, dv, duu, duv, dvv] = outputs.buffers;
+    let [dst_desc, du_desc, dv_desc, duu_desc, duv_desc, dvv_desc] = outputs.descs;
+
+    unsafe {
+        if sys::osd::CLEvaluator_EvalStencilsWithDerivatives(
+            evaluator.ptr,
+            src_buffer.0,
+            src_desc.0,
+            dst,
+            dst_desc,
+            du,
+            du_desc,
+            dv,
+            dv_desc,
+            duu,
+            duu_desc,
+            duv,
+            duv_desc,
+            dvv,
+            dvv_desc,
+            stencil_table.ptr,
+        ) {
+            Ok(())
+        } else {
+            Err(Error::EvalStencilsFailed)
+        }
+    }
+}
+
+/// Enqueue an evaluation of limit stencils with derivatives on the command
+/// queue of `evaluator` without waiting for it.
+///
+/// Like [`evaluate_stencils_with_derivatives()`], but the kernels wait for
+/// `wait_for`, e.g. the event of an
+/// [`update_data_async()`](OpenClVertexBuffer::update_data_async()) on
+/// another queue, and the returned event completes with them. Pass it to
+/// [`read_data_async()`](OpenClVertexBuffer::read_data_async()) to read the
+/// results back while the next frame is uploaded.
+///
+/// # Errors
+///
+/// See [`evaluate_stencils_with_derivatives()`].
+#[allow(clippy::too_many_arguments)]
+pub fn evaluate_stencils_with_derivatives_async(
+    evaluator: &OpenClEvaluator,
+    src_buffer: &OpenClVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut OpenClVertexBuffer,
+    dst_desc: BufferDescriptor,
+    derivatives: Derivatives<'_, OpenClVertexBuffer>,
+    second_derivatives: Option<SecondDerivatives<'_, OpenClVertexBuffer>>,
+    stencil_table: &OpenClLimitStencilTable,
+    wait_for: &[&OpenClEvent],
+) -> Result<OpenClEvent> {
+    let st = stencil_table.stencil_table;
+    check_limit_stencils(st, second_derivatives.is_some())?;
+    let outputs = resolve_outputs(
+        src_buffer,
+        src_desc,
+        st.control_vertex_count(),
+        dst_buffer,
+        dst_desc,
+        Some(derivatives),
+        second_derivatives,
+        st.len(),
+    )?;
+    check_compiled_layout(&evaluator.descs, src_desc, &outputs)?;
+    let [dst, du, dv, duu, duv, dvv] = outputs.buffers;
+    let [dst_desc, du_desc, dv_desc, duu_desc, duv_desc, dvv_desc] = outputs.descs;
+    let wait_events = raw_events(wait_for);
+    let mut end_event = std::ptr::null_mut();
+
+    if !unsafe {
+        sys::osd::CLEvaluator_EvalStencilsWithDerivativesAsync(
+            evaluator.ptr,
+            src_buffer.0,
+            src_desc.0,
+            dst,
+            dst_desc,
+            du,
+            du_desc,
+            dv,
+            dv_desc,
+            duu,
+            duu_desc,
+            duv,
+            duv_desc,
+            dvv,
+            dvv_desc,
+            stencil_table.ptr,
+            wait_events.len() as _,
+            wait_events.as_ptr(),
+            &mut end_event,
+        )
+    } {
+        return Err(Error::EvalStencilsFailed);
+    }
+    OpenClEvent::from_raw(end_event)
+}
+
+/// Evaluate the limit surface of a patch table at `patch_coords` with
+/// `evaluator`.
+///
+/// `src_buffer` holds the patch control points: the refined vertices
+/// followed by the local points of the patch table. `patch_coords` are
+/// uploaded for the duration of the call.
+///
+/// # Errors
+///
+/// Returns [`Error::InvalidPatch`] if a coordinate refers to a patch not in
+/// the patch table; see [`evaluate_stencils_with_derivatives()`] for the
+/// buffer errors.
+#[allow(clippy::too_many_arguments)]
+pub fn evaluate_patches(
+    evaluator: &OpenClEvaluator,
+    src_buffer: &OpenClVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut OpenClVertexBuffer,
+    dst_desc: BufferDescriptor,
+    patch_coords: &[PatchCoord],
+    patch_table: &OpenClPatchTable,
+    context: &OpenClContext,
+    command_queue: &OpenClCommandQueue,
+) -> Result<()> {
+    eval_patches(
+        evaluator,
+        src_buffer,
+        src_desc,
+        dst_buffer,
+        dst_desc,
+        None,
+        None,
+        patch_coords,
+        patch_table,
+        context,
+        command_queue,
+    )
+}
+
+/// Evaluate the limit surface of a patch table and its derivatives at
+/// `patch_coords` with `evaluator`.
+///
+/// Like [`evaluate_patches()`], also writing 1st derivatives to
+/// `derivatives` and, if given, 2nd derivatives to `second_derivatives`.
+#[allow(clippy::too_many_arguments)]
+pub fn evaluate_patches_with_derivatives(
+    evaluator: &OpenClEvaluator,
+    src_buffer: &OpenClVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut OpenClVertexBuffer,
+    dst_desc: BufferDescriptor,
+    derivatives: Derivatives<'_, OpenClVertexBuffer>,
+    second_derivatives: Option<SecondDerivatives<'_, OpenClVertexBuffer>>,
+    patch_coords: &[PatchCoord],
+    patch_table: &OpenClPatchTable,
+    context: &OpenClContext,
+    command_queue: &OpenClCommandQueue,
+) -> Result<()> {
+    eval_patches(
+        evaluator,
+        src_buffer,
+        src_desc,
+        dst_buffer,
+        dst_desc,
+        Some(derivatives),
+        second_derivatives,
+        patch_coords,
+        patch_table,
+        context,
+        command_queue,
+    )
+}
+
+#[allow(clippy::too_many_arguments)]
+fn eval_patches(
+    evaluator: &OpenClEvaluator,
+    src_buffer: &OpenClVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut OpenClVertexBuffer,
+    dst_desc: BufferDescriptor,
+    derivatives: Option<Derivatives<'_, OpenClVertexBuffer>>,
+    second_derivatives: Option<SecondDerivatives<'_, OpenClVertexBuffer>>,
+    patch_coords: &[PatchCoord],
+    patch_table: &OpenClPatchTable,
+    context: &OpenClContext,
+    command_queue: &OpenClCommandQueue,
+) -> Result<()> {
+    let coord_count = check_patch_coords(patch_table.patch_table, patch_coords)?;
+    let outputs = resolve_outputs(
+        src_buffer,
+        src_desc,
+        patch_table.patch_table.point_count(),
+        dst_buffer,
+        dst_desc,
+        derivatives,
+        second_derivatives,
+        patch_coords.len(),
+    )?;
+    check_compiled_layout(&evaluator.descs, src_desc, &outputs)?;
+    let [dst, du, dv, duu, duv, dvv] = outputs.buffers;
+    let [dst_desc, du_desc, dv_desc, duu_desc, duv_desc, dvv_desc] = outputs.descs;
+
+    unsafe {
+        if sys::osd::CLEvaluator_EvalPatches(
+            evaluator.ptr,
+            src_buffer.0,
+            src_desc.0,
+            dst,
+            dst_desc,
+            du,
+            du_desc,
+            dv,
+            dv_desc,
+            duu,
+            duu_desc,
+            duv,
+            duv_desc,
+            dvv,
+            dvv_desc,
+            coord_count,
+            patch_coords.as_ptr() as *const _,
+            patch_table.ptr,
+            context.as_ptr() as *const _,
+            command_queue.as_ptr() as *const _,
+        ) {
+            Ok(())
+        } else {
+            Err(Error::EvalPatchesFailed)
+        }
+    }
+}
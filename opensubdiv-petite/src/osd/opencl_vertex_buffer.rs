@@ -174,3 +174,309 @@ impl OpenClVertexBuffer {
         Ok(())
     }
 }
+
+impl super::types::VertexBuffer for OpenClVertexBuffer {
+    type Raw = sys::osd::OpenCLVertexBuffer_obj;
+
+    #[inline]
+    fn as_raw(&self) -> *mut Self::Raw {
+        self.0
+    }
+
+    #[inline]
+    fn float_count(&self) -> usize {
+        self.element_count() * self.vertex_count()
+    }
+}
+
+impl OpenClVertexBuffer {
+    /// Enqueue a non-blocking upload of `vertex_count` vertices from `src`
+    /// on `command_queue`.
+    ///
+    /// `src` holds the vertices back to back, `element_count()` floats each,
+    /// starting at its first float. The upload waits for `wait_for`. The
+    /// returned event completes with the upload; `src` also keeps it and
+    /// waits for it before it is next accessed or dropped.
+    ///
+    /// # Errors
+    /// Returns error if `src` is too small, if the range is out of bounds or
+    /// if the upload could not be enqueued.
+    pub fn update_data_async(
+        &mut self,
+        src: &mut OpenClPinnedBuffer,
+        start_vertex: usize,
+        vertex_count: usize,
+        command_queue: &OpenClCommandQueue,
+        wait_for: &[&OpenClEvent],
+    ) -> Result<OpenClEvent> {
+        let (start, count) = self.check_async_range(src, start_vertex, vertex_count)?;
+        let wait_events = raw_events(wait_for);
+        let mut event = std::ptr::null_mut();
+        if !unsafe {
+            sys::osd::CLVertexBuffer_UpdateDataAsync(
+                self.0,
+                src.ptr.as_ptr(),
+                start,
+                count,
+                command_queue.as_ptr() as *const _,
+                wait_events.len() as _,
+                wait_events.as_ptr(),
+                &mut event,
+            )
+        } {
+            return Err(Error::GpuBackend(
+                "Failed to enqueue OpenCL vertex buffer upload".to_string(),
+            ));
+        }
+        let event = OpenClEvent::from_raw(event)?;
+        src.pending = Some(event.clone());
+        Ok(event)
+    }
+
+    /// Enqueue a non-blocking readback of `vertex_count` vertices into `dst`
+    /// on `command_queue`.
+    ///
+    /// The vertices are written to the front of `dst` once `wait_for` have
+    /// completed, e.g. the event returned by
+    /// [`evaluate_stencils_with_derivatives_async()`](crate::osd::opencl_evaluator::evaluate_stencils_with_derivatives_async()).
+    /// The returned event completes with the readback; `dst` also keeps it
+    /// and waits for it before it is next accessed or dropped.
+    ///
+    /// # Errors
+    /// Returns error if `dst` is too small, if the range is out of bounds or
+    /// if the readback could not be enqueued.
+    pub fn read_data_async(
+        &self,
+        dst: &mut OpenClPinnedBuffer,
+        start_vertex: usize,
+        vertex_count: usize,
+        command_queue: &OpenClCommandQueue,
+        wait_for: &[&OpenClEvent],
+    ) -> Result<OpenClEvent> {
+        let (start, count) = self.check_async_range(dst, start_vertex, vertex_count)?;
+        let wait_events = raw_events(wait_for);
+        let mut event = std::ptr::null_mut();
+        if !unsafe {
+            sys::osd::CLVertexBuffer_ReadDataAsync(
+                self.0,
+                dst.ptr.as_ptr(),
+                start,
+                count,
+                command_queue.as_ptr() as *const _,
+                wait_events.len() as _,
+                wait_events.as_ptr(),
+                &mut event,
+            )
+        } {
+            return Err(Error::GpuBackend(
+                "Failed to enqueue OpenCL vertex buffer readback".to_string(),
+            ));
+        }
+        let event = OpenClEvent::from_raw(event)?;
+        dst.pending = Some(event.clone());
+        Ok(event)
+    }
+
+    /// Checks an async transfer range against this buffer and `staging`.
+    fn check_async_range(
+        &self,
+        staging: &mut OpenClPinnedBuffer,
+        start_vertex: usize,
+        vertex_count: usize,
+    ) -> Result<(i32, i32)> {
+        let total_vertices = self.vertex_count();
+        if start_vertex + vertex_count > total_vertices {
+            return Err(Error::IndexOutOfBounds {
+                index: start_vertex + vertex_count,
+                max: total_vertices,
+            });
+        }
+        let floats = vertex_count * self.element_count();
+        if floats > staging.len() {
+            return Err(Error::InvalidBufferSize {
+                expected: floats,
+                actual: staging.len(),
+            });
+        }
+        // A previous transfer may still be reading or writing the range.
+        staging.wait()?;
+
+        // Both fit an i32 since they are bounded by `vertex_count()`.
+        Ok((start_vertex as i32, vertex_count as i32))
+    }
+}
+
+/// Collects the raw handles of `events` for FFI calls.
+pub(crate) fn raw_events(events: &[&OpenClEvent]) -> Vec<*mut std::ffi::c_void> {
+    events.iter().map(|event| event.0.as_ptr()).collect()
+}
+
+/// An OpenCL event returned by an asynchronous upload, evaluation or
+/// readback.
+///
+/// Pass it in the `wait_for` list of the next step to order work across
+/// command queues without blocking the host. Cloning adds a reference to the
+/// same event.
+#[derive(Debug)]
+pub struct OpenClEvent(NonNull<std::ffi::c_void>);
+
+// AIDEV-NOTE: OpenCL event objects are reference counted and thread-safe.
+unsafe impl Send for OpenClEvent {}
+unsafe impl Sync for OpenClEvent {}
+
+impl Clone for OpenClEvent {
+    fn clone(&self) -> Self {
+        unsafe { sys::osd::CLEvent_retain(self.0.as_ptr()) };
+        OpenClEvent(self.0)
+    }
+}
+
+impl Drop for OpenClEvent {
+    #[inline]
+    fn drop(&mut self) {
+        unsafe { sys::osd::CLEvent_release(self.0.as_ptr()) }
+    }
+}
+
+impl OpenClEvent {
+    /// Takes ownership of an event returned through an FFI out-parameter.
+    pub(crate) fn from_raw(ptr: *mut std::ffi::c_void) -> Result<OpenClEvent> {
+        NonNull::new(ptr).map(OpenClEvent).ok_or(Error::NullPointer)
+    }
+
+    /// Returns whether the command this event belongs to has completed,
+    /// without blocking.
+    pub fn is_complete(&self) -> Result<bool> {
+        match unsafe { sys::osd::CLEvent_Status(self.0.as_ptr()) } {
+            1 => Ok(true),
+            0 => Ok(false),
+            _ => Err(Error::GpuBackend("OpenCL command failed".to_string())),
+        }
+    }
+
+    /// Block until the command this event belongs to has completed.
+    pub fn wait(&self) -> Result<()> {
+        if !unsafe { sys::osd::CLEvent_Wait(self.0.as_ptr()) } {
+            return Err(Error::GpuBackend(
+                "Failed to wait for OpenCL event".to_string(),
+            ));
+        }
+        Ok(())
+    }
+}
+
+/// Mapped host memory to stage asynchronous transfers through.
+///
+/// The memory is allocated by the OpenCL runtime
+/// (`CL_MEM_ALLOC_HOST_PTR`), which lets drivers transfer it without an
+/// intermediate copy. The buffer remembers its last transfer and waits for
+/// it before handing out its contents.
+#[derive(Debug)]
+pub struct OpenClPinnedBuffer<'a> {
+    ptr: NonNull<f32>,
+    len: usize,
+    mem: *mut std::ffi::c_void,
+    command_queue: NonNull<std::ffi::c_void>,
+    pending: Option<OpenClEvent>,
+    _marker: PhantomData<&'a std::ffi::c_void>,
+}
+
+// AIDEV-NOTE: The memory is only reachable through `&mut self` accessors
+// that wait for pending transfers first.
+unsafe impl Send for OpenClPinnedBuffer<'_> {}
+unsafe impl Sync for OpenClPinnedBuffer<'_> {}
+
+impl Drop for OpenClPinnedBuffer<'_> {
+    fn drop(&mut self) {
+        // The device may still be copying from or to the memory.
+        let _ = self.wait();
+        unsafe {
+            sys::osd::CLPinnedBuffer_destroy(
+                self.command_queue.as_ptr() as *const _,
+                self.mem,
+                self.ptr.as_ptr() as *mut _,
+            )
+        }
+    }
+}
+
+impl<'a> OpenClPinnedBuffer<'a> {
+    /// Allocate and map `len` zeroed floats of host memory.
+    ///
+    /// `command_queue` is used to map the memory now and to unmap it on drop.
+    pub fn new(
+        len: usize,
+        context: &OpenClContext,
+        command_queue: &OpenClCommandQueue<'a>,
+    ) -> Result<OpenClPinnedBuffer<'a>> {
+        let bytes =
+            len.max(1)
+                .checked_mul(std::mem::size_of::<f32>())
+                .ok_or(Error::InvalidBufferSize {
+                    expected: len,
+                    actual: usize::MAX / std::mem::size_of::<f32>(),
+                })?;
+        let mut mem = std::ptr::null_mut();
+        let host = unsafe {
+            sys::osd::CLPinnedBuffer_Create(
+                context.as_ptr() as *const _,
+                command_queue.as_ptr() as *const _,
+                bytes,
+                &mut mem,
+            )
+        };
+        let ptr = NonNull::new(host as *mut f32).ok_or_else(|| {
+            Error::GpuBackend("Failed to allocate mapped OpenCL host memory".to_string())
+        })?;
+        unsafe { std::ptr::write_bytes(ptr.as_ptr(), 0, len) };
+        Ok(OpenClPinnedBuffer {
+            ptr,
+            len,
+            mem,
+            command_queue: command_queue.ptr,
+            pending: None,
+            _marker: PhantomData,
+        })
+    }
+
+    /// Returns the number of floats in this buffer.
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.len
+    }
+
+    /// Returns `true` if this buffer holds no floats.
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.len == 0
+    }
+
+    /// Returns whether the last transfer through this buffer has finished,
+    /// without blocking.
+    pub fn is_ready(&self) -> Result<bool> {
+        self.pending
+            .as_ref()
+            .map_or(Ok(true), OpenClEvent::is_complete)
+    }
+
+    /// Block until the last transfer through this buffer has finished.
+    pub fn wait(&mut self) -> Result<()> {
+        if let Some(event) = self.pending.take() {
+            event.wait()?;
+        }
+        Ok(())
+    }
+
+    /// Get the contents of this buffer, waiting for a pending readback.
+    pub fn as_slice(&mut self) -> Result<&[f32]> {
+        self.wait()?;
+        Ok(unsafe { std::slice::from_raw_parts(self.ptr.as_ptr(), self.len) })
+    }
+
+    /// Get the contents of this buffer for filling, waiting for a pending
+    /// upload.
+    pub fn as_mut_slice(&mut self) -> Result<&mut [f32]> {
+        self.wait()?;
+        Ok(unsafe { std::slice::from_raw_parts_mut(self.ptr.as_ptr(), self.len) })
+    }
+}
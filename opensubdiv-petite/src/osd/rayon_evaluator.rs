@@ -0,0 +1,236 @@
+//! Stencil evaluation in Rust on the rayon thread pool.
+//!
+//! A drop-in replacement for [`cpu_evaluator`](super::cpu_evaluator) that
+//! needs neither TBB nor OpenMP, e.g. on ARM or in wasm-threads builds. The
+//! stencils are applied straight from the slices [`StencilTable`] exposes;
+//! nothing is copied.
+use super::buffer_descriptor::BufferDescriptor;
+use super::cpu_vertex_buffer::CpuVertexBuffer;
+use crate::far::StencilTable;
+use crate::Index;
+use crate::{Error, Result};
+use rayon::prelude::*;
+
+/// Number of stencil weights each rayon task applies at least.
+const MIN_CHUNK_WEIGHTS: usize = 16 * 1024;
+
+/// Evaluate stencils using rayon for CPU parallelism.
+///
+/// This is a drop-in replacement for
+/// [`super::cpu_evaluator::evaluate_stencils`] that runs in Rust. It operates
+/// on the same [`CpuVertexBuffer`] type --- no separate vertex buffer is
+/// needed.
+///
+/// * `src_buffer` -- Input primvar buffer.
+/// * `src_desc` -- Vertex buffer descriptor for the input buffer.
+/// * `dst_buffer` -- Output primvar buffer.
+/// * `dst_desc` -- Vertex buffer descriptor for the output buffer.
+/// * `stencil_table` -- A [`StencilTable`].
+///
+/// # Errors
+///
+/// See [`evaluate_stencils_slice()`].
+pub fn evaluate_stencils(
+    src_buffer: &CpuVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut CpuVertexBuffer,
+    dst_desc: BufferDescriptor,
+    stencil_table: &StencilTable,
+) -> Result<()> {
+    evaluate_stencils_slice(
+        src_buffer.bind_cpu_buffer()?,
+        src_desc,
+        dst_buffer.bind_cpu_buffer_mut()?,
+        dst_desc,
+        stencil_table,
+    )
+}
+
+/// Evaluate stencils from and into plain slices using rayon.
+///
+/// Reads `src_desc.length` elements per control vertex from `src` and
+/// writes the same number of elements per stencil into `dst`. The stencils
+/// are split into contiguous ranges of roughly equal weight counts, so
+/// tables mixing small and large stencils keep all threads busy. Widths of
+/// 1--4 elements use fixed-width kernels.
+///
+/// # Errors
+///
+/// Returns an error if the descriptors are invalid or differ in length, or
+/// if either slice is too short for the descriptor it is paired with.
+pub fn evaluate_stencils_slice(
+    src: &[f32],
+    src_desc: BufferDescriptor,
+    dst: &mut [f32],
+    dst_desc: BufferDescriptor,
+    stencil_table: &StencilTable,
+) -> Result<()> {
+    if !src_desc.is_valid() || !dst_desc.is_valid() || src_desc.0.length != dst_desc.0.length {
+        return Err(Error::InvalidBufferDescriptor);
+    }
+
+    let sizes = stencil_table.sizes();
+    let indices = stencil_table.control_indices();
+    let weights = stencil_table.weights();
+    let stencil_count = sizes.len();
+
+    let dst_len = dst_desc.buffer_len(stencil_count);
+    if dst.len() < dst_len {
+        return Err(Error::InvalidBufferSize {
+            expected: dst_len,
+            actual: dst.len(),
+        });
+    }
+
+    // AIDEV-NOTE: Local point stencil tables report 0 control vertices.
+    // Only then is the source size derived from the indices; the serial scan
+    // would otherwise cost a good part of the parallel speedup.
+    let control_vertex_count = match stencil_table.control_vertex_count() {
+        0 => indices.iter().max().map_or(0, |index| index.0 as usize + 1),
+        count => count,
+    };
+    let src_len = src_desc.buffer_len(control_vertex_count);
+    if src.len() < src_len {
+        return Err(Error::InvalidBufferSize {
+            expected: src_len,
+            actual: src.len(),
+        });
+    }
+
+    if stencil_count == 0 {
+        return Ok(());
+    }
+
+    let src = Source {
+        data: src,
+        offset: src_desc.0.offset as usize,
+        stride: src_desc.0.stride as usize,
+    };
+    let width = src_desc.0.length as usize;
+    let stride = dst_desc.0.stride as usize;
+    let local_offset = dst_desc.local_offset();
+    let skip = dst_desc.0.offset as usize - local_offset;
+
+    let chunks = weight_balanced_chunks(sizes, weights.len());
+    let mut rest = &mut dst[skip..];
+    let mut dst_chunks = Vec::with_capacity(chunks.len());
+    for chunk in &chunks {
+        let len = ((chunk.stencils.end - chunk.stencils.start) * stride).min(rest.len());
+        let (head, tail) = std::mem::take(&mut rest).split_at_mut(len);
+        dst_chunks.push(head);
+        rest = tail;
+    }
+
+    chunks
+        .into_par_iter()
+        .zip(dst_chunks)
+        .for_each(|(chunk, dst)| {
+            let dst = Destination {
+                data: dst,
+                offset: local_offset,
+                stride,
+            };
+            match width {
+                1 => apply_chunk::<1>(&chunk, sizes, indices, weights, &src, dst, width),
+                2 => apply_chunk::<2>(&chunk, sizes, indices, weights, &src, dst, width),
+                3 => apply_chunk::<3>(&chunk, sizes, indices, weights, &src, dst, width),
+                4 => apply_chunk::<4>(&chunk, sizes, indices, weights, &src, dst, width),
+                _ => apply_chunk::<0>(&chunk, sizes, indices, weights, &src, dst, width),
+            }
+        });
+
+    Ok(())
+}
+
+/// A contiguous range of stencils and the range of their weights.
+struct Chunk {
+    stencils: std::ops::Range<usize>,
+    first_weight: usize,
+}
+
+/// Splits the stencils into ranges of at least [`MIN_CHUNK_WEIGHTS`]
+/// weights, about four per thread.
+fn weight_balanced_chunks(sizes: &[u32], weight_count: usize) -> Vec<Chunk> {
+    let target = (weight_count / (4 * rayon::current_num_threads())).max(MIN_CHUNK_WEIGHTS);
+
+    let mut chunks = Vec::new();
+    let mut start = 0;
+    let mut first_weight = 0;
+    let mut weights = 0;
+    for (stencil, &size) in sizes.iter().enumerate() {
+        weights += size as usize;
+        if weights >= target {
+            chunks.push(Chunk {
+                stencils: start..stencil + 1,
+                first_weight,
+            });
+            start = stencil + 1;
+            first_weight += weights;
+            weights = 0;
+        }
+    }
+    if start < sizes.len() {
+        chunks.push(Chunk {
+            stencils: start..sizes.len(),
+            first_weight,
+        });
+    }
+    chunks
+}
+
+struct Source<'a> {
+    data: &'a [f32],
+    offset: usize,
+    stride: usize,
+}
+
+struct Destination<'a> {
+    data: &'a mut [f32],
+    offset: usize,
+    stride: usize,
+}
+
+// AIDEV-NOTE: `N > 0` fixes the primvar width at compile time so the
+// element loops unroll and the accumulator stays in registers, which lets
+// LLVM vectorize the common xyz/xyzw layouts for the target (SSE/AVX,
+// NEON, wasm SIMD) without platform-specific code. `N == 0` reads the
+// width at runtime.
+fn apply_chunk<const N: usize>(
+    chunk: &Chunk,
+    sizes: &[u32],
+    indices: &[Index],
+    weights: &[f32],
+    src: &Source<'_>,
+    dst: Destination<'_>,
+    width: usize,
+) {
+    let width = if N > 0 { N } else { width };
+    let mut tap = chunk.first_weight;
+    for (i, &size) in sizes[chunk.stencils.clone()].iter().enumerate() {
+        let taps = tap..tap + size as usize;
+        tap = taps.end;
+        let out_start = dst.offset + i * dst.stride;
+        let out = &mut dst.data[out_start..out_start + width];
+
+        if N > 0 {
+            let mut acc = [0.0f32; N];
+            for (&index, &weight) in indices[taps.clone()].iter().zip(&weights[taps]) {
+                let start = src.offset + index.0 as usize * src.stride;
+                let values = &src.data[start..start + N];
+                for (acc, &value) in acc.iter_mut().zip(values) {
+                    *acc += value * weight;
+                }
+            }
+            out.copy_from_slice(&acc);
+        } else {
+            out.fill(0.0);
+            for (&index, &weight) in indices[taps.clone()].iter().zip(&weights[taps]) {
+                let start = src.offset + index.0 as usize * src.stride;
+                let values = &src.data[start..start + width];
+                for (out, &value) in out.iter_mut().zip(values) {
+                    *out += value * weight;
+                }
+            }
+        }
+    }
+}
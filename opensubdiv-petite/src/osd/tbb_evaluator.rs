@@ -1,6 +1,11 @@
 use super::buffer_descriptor::BufferDescriptor;
+use super::cpu_patch_table::CpuPatchTable;
 use super::cpu_vertex_buffer::CpuVertexBuffer;
-use crate::far::StencilTable;
+use super::types::{
+    check_limit_stencils, check_patch_coords, resolve_outputs, Derivatives, PatchCoord,
+    SecondDerivatives,
+};
+use crate::far::{LimitStencilTable, StencilTable};
 
 use opensubdiv_petite_sys as sys;
 
@@ -40,3 +45,187 @@ pub fn evaluate_stencils(
         }
     }
 }
+
+/// Evaluate limit stencils with derivatives using TBB.
+///
+/// Writes limit positions to `dst_buffer` and 1st derivatives to
+/// `derivatives`; 2nd derivatives are written to `second_derivatives` if
+/// given.
+///
+/// * `src_buffer` -- Control vertices the stencils read.
+/// * `src_desc` -- Vertex buffer descriptor for the input buffer.
+/// * `dst_buffer` -- Output buffer for the limit positions.
+/// * `dst_desc` -- Vertex buffer descriptor for the output buffer.
+/// * `derivatives` -- Outputs for the 1st derivatives.
+/// * `second_derivatives` -- Outputs for the 2nd derivatives, if any.
+/// * `stencil_table` -- A [`LimitStencilTable`] created with the
+///   derivatives to evaluate.
+///
+/// # Errors
+///
+/// Returns [`Error::FeatureNotAvailable`] if `stencil_table` lacks the
+/// requested derivative weights, [`Error::InvalidBufferDescriptor`] if a
+/// descriptor does not match `src_desc` or interleaved outputs overlap and
+/// [`Error::InvalidBufferSize`] if a buffer is too small.
+pub fn evaluate_stencils_with_derivatives(
+    src_buffer: &CpuVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut CpuVertexBuffer,
+    dst_desc: BufferDescriptor,
+    derivatives: Derivatives<'_, CpuVertexBuffer>,
+    second_derivatives: Option<SecondDerivatives<'_, CpuVertexBuffer>>,
+    stencil_table: &LimitStencilTable,
+) -> Result<()> {
+    check_limit_stencils(stencil_table, second_derivatives.is_some())?;
+    let outputs = resolve_outputs(
+        src_buffer,
+        src_desc,
+        stencil_table.control_vertex_count(),
+        dst_buffer,
+        dst_desc,
+        Some(derivatives),
+        second_derivatives,
+        stencil_table.len(),
+    )?;
+    let [dst, du, dv, duu, duv, dvv] = outputs.buffers;
+    let [dst_desc, du_desc, dv_desc, duu_desc, duv_desc, dvv_desc] = outputs.descs;
+
+    unsafe {
+        if sys::osd::TbbEvaluator_EvalStencilsWithDerivatives(
+            src_buffer.0,
+            src_desc.0,
+            dst,
+            dst_desc,
+            du,
+            du_desc,
+            dv,
+            dv_desc,
+            duu,
+            duu_desc,
+            duv,
+            duv_desc,
+            dvv,
+            dvv_desc,
+            stencil_table.as_ptr(),
+        ) {
+            Ok(())
+        } else {
+            Err(Error::EvalStencilsFailed)
+        }
+    }
+}
+
+/// Evaluate the limit surface of a patch table at `patch_coords` using TBB.
+///
+/// * `src_buffer` -- Patch control points: the refined vertices followed by
+///   the local points of the patch table.
+/// * `src_desc` -- Vertex buffer descriptor for the input buffer.
+/// * `dst_buffer` -- Output buffer, one primvar per patch coordinate.
+/// * `dst_desc` -- Vertex buffer descriptor for the output buffer.
+/// * `patch_coords` -- Locations to evaluate.
+/// * `patch_table` -- A [`CpuPatchTable`].
+///
+/// # Errors
+///
+/// Returns [`Error::InvalidPatch`] if a coordinate refers to a patch not in
+/// `patch_table`; see
+/// [`evaluate_stencils_with_derivatives()`] for the buffer errors.
+pub fn evaluate_patches(
+    src_buffer: &CpuVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut CpuVertexBuffer,
+    dst_desc: BufferDescriptor,
+    patch_coords: &[PatchCoord],
+    patch_table: &CpuPatchTable,
+) -> Result<()> {
+    eval_patches(
+        src_buffer,
+        src_desc,
+        dst_buffer,
+        dst_desc,
+        None,
+        None,
+        patch_coords,
+        patch_table,
+    )
+}
+
+/// Evaluate the limit surface of a patch table and its derivatives at
+/// `patch_coords` using TBB.
+///
+/// Like [`evaluate_patches()`], also writing 1st derivatives to
+/// `derivatives` and, if given, 2nd derivatives to `second_derivatives`.
+#[allow(clippy::too_many_arguments)]
+pub fn evaluate_patches_with_derivatives(
+    src_buffer: &CpuVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut CpuVertexBuffer,
+    dst_desc: BufferDescriptor,
+    derivatives: Derivatives<'_, CpuVertexBuffer>,
+    second_derivatives: Option<SecondDerivatives<'_, CpuVertexBuffer>>,
+    patch_coords: &[PatchCoord],
+    patch_table: &CpuPatchTable,
+) -> Result<()> {
+    eval_patches(
+        src_buffer,
+        src_desc,
+        dst_buffer,
+        dst_desc,
+        Some(derivatives),
+        second_derivatives,
+        patch_coords,
+        patch_table,
+    )
+}
+
+#[allow(clippy::too_many_arguments)]
+fn eval_patches(
+    src_buffer: &CpuVertexBuffer,
+    src_desc: BufferDescriptor,
+    dst_buffer: &mut CpuVertexBuffer,
+    dst_desc: BufferDescriptor,
+    derivatives: Option<Derivatives<'_, CpuVertexBuffer>>,
+    second_derivatives: Option<SecondDerivatives<'_, CpuVertexBuffer>>,
+    patch_coords: &[PatchCoord],
+    patch_table: &CpuPatchTable,
+) -> Result<()> {
+    let coord_count = check_patch_coords(patch_table.patch_table(), patch_coords)?;
+    let outputs = resolve_outputs(
+        src_buffer,
+        src_desc,
+        patch_table.patch_table().point_count(),
+        dst_buffer,
+        dst_desc,
+        derivatives,
+        second_derivatives,
+        patch_coords.len(),
+    )?;
+    let [dst, du, dv, duu, duv, dvv] = outputs.buffers;
+    let [dst_desc, du_desc, dv_desc, duu_desc, duv_desc, dvv_desc] = outputs.descs;
+
+    unsafe {
+        if sys::osd::TbbEvaluator_EvalPatches(
+            src_buffer.0,
+            src_desc.0,
+            dst,
+            dst_desc,
+            du,
+            du_desc,
+            dv,
+            dv_desc,
+            duu,
+            duu_desc,
+            duv,
+            duv_desc,
+            dvv,
+            dvv_desc,
+            coord_count,
+            patch_coords.as_ptr() as *const _,
+            patch_table.ptr,
+        ) {
+            Ok(())
+        } else {
+            Err(Error::EvalPatchesFailed)
+        }
+    }
+}
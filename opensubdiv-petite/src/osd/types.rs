@@ -0,0 +1,298 @@
+//! Types shared by the evaluators of all backends.
+
+use super::buffer_descriptor::BufferDescriptor;
+use crate::far::{PatchHandle, PatchMap, PatchTable};
+use crate::{Error, Result};
+use opensubdiv_petite_sys as sys;
+
+pub(crate) use crate::far::limit_stencil_table::check_limit_stencils;
+
+/// A location on the limit surface: a patch and face coordinates on it.
+///
+/// Arrays of these are what the `evaluate_patches*()` functions of every
+/// backend evaluate.
+#[repr(transparent)]
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct PatchCoord(pub(crate) sys::osd::PatchCoord);
+
+impl PatchCoord {
+    /// Create a patch coordinate.
+    ///
+    /// `s` and `t` are face (ptex) coordinates, as passed to
+    /// [`PatchMap::find_patch()`], not patch-local ones.
+    #[inline]
+    pub fn new(handle: PatchHandle, s: f32, t: f32) -> Self {
+        Self(sys::osd::PatchCoord {
+            handle: handle.to_sys(),
+            s,
+            t,
+        })
+    }
+
+    /// Locate face coordinates `(s, t)` of a ptex face with `patch_map`,
+    /// built from `patch_table`.
+    ///
+    /// Returns `None` if the face has no patches.
+    pub fn locate(
+        patch_table: &PatchTable,
+        patch_map: &PatchMap,
+        face_index: usize,
+        s: f32,
+        t: f32,
+    ) -> Option<Self> {
+        let (patch_index, ..) = patch_map.find_patch(patch_table, face_index, s, t)?;
+        let handle = patch_table.patch_handle(patch_index)?;
+        Some(Self::new(handle, s, t))
+    }
+
+    /// Returns the patch the coordinate lies on.
+    #[inline]
+    pub fn handle(&self) -> PatchHandle {
+        PatchHandle::from_sys(self.0.handle)
+    }
+
+    /// Returns the face `u` coordinate.
+    #[inline]
+    pub fn s(&self) -> f32 {
+        self.0.s
+    }
+
+    /// Returns the face `v` coordinate.
+    #[inline]
+    pub fn t(&self) -> f32 {
+        self.0.t
+    }
+}
+
+/// Where an evaluator writes one of its results.
+#[derive(Debug)]
+pub struct EvalOutput<'a, B> {
+    /// Buffer to write to.
+    ///
+    /// `None` writes into the destination buffer of the evaluation, so
+    /// positions and derivatives can be interleaved in one buffer. Outputs
+    /// sharing that buffer must have the same stride and must not overlap.
+    pub buffer: Option<&'a mut B>,
+    /// Layout of the output in its buffer.
+    pub desc: BufferDescriptor,
+}
+
+impl<'a, B> EvalOutput<'a, B> {
+    /// Write to `buffer`, laid out as described by `desc`.
+    #[inline]
+    pub fn new(buffer: &'a mut B, desc: BufferDescriptor) -> Self {
+        Self {
+            buffer: Some(buffer),
+            desc,
+        }
+    }
+
+    /// Write into the destination buffer, laid out as described by `desc`.
+    #[inline]
+    pub fn interleaved(desc: BufferDescriptor) -> Self {
+        Self { buffer: None, desc }
+    }
+}
+
+/// First derivative outputs of a limit evaluation.
+#[derive(Debug)]
+pub struct Derivatives<'a, B> {
+    /// Derivatives with respect to `u`.
+    pub du: EvalOutput<'a, B>,
+    /// Derivatives with respect to `v`.
+    pub dv: EvalOutput<'a, B>,
+}
+
+/// Second derivative outputs of a limit evaluation.
+#[derive(Debug)]
+pub struct SecondDerivatives<'a, B> {
+    /// Second derivatives with respect to `u`.
+    pub duu: EvalOutput<'a, B>,
+    /// Mixed second derivatives.
+    pub duv: EvalOutput<'a, B>,
+    /// Second derivatives with respect to `v`.
+    pub dvv: EvalOutput<'a, B>,
+}
+
+/// Vertex buffer of one backend, as the evaluators address it.
+pub(crate) trait VertexBuffer {
+    /// Type the FFI pointer of the buffer points to.
+    type Raw;
+
+    fn as_raw(&self) -> *mut Self::Raw;
+
+    /// Returns the FFI pointer of a buffer the evaluator writes to.
+    ///
+    /// Buffers wrapping borrowed memory must derive it from a unique borrow.
+    #[inline]
+    fn as_raw_mut(&mut self) -> *mut Self::Raw {
+        self.as_raw()
+    }
+
+    /// Returns the number of `f32`s the buffer holds.
+    fn float_count(&self) -> usize;
+}
+
+/// Raw buffers and descriptors of an evaluation in the order destination,
+/// du, dv, duu, duv, dvv. Outputs that are not evaluated are null.
+pub(crate) struct RawOutputs<T> {
+    pub(crate) buffers: [*mut T; 6],
+    pub(crate) descs: [sys::osd::BufferDescriptor; 6],
+}
+
+fn check_buffer_len(len: usize, desc: BufferDescriptor, point_count: usize) -> Result<()> {
+    let expected = desc.buffer_len(point_count);
+    match len < expected {
+        true => Err(Error::InvalidBufferSize {
+            expected,
+            actual: len,
+        }),
+        false => Ok(()),
+    }
+}
+
+/// Checks that no two outputs sharing one buffer write the same elements.
+fn check_disjoint(descs: &[BufferDescriptor]) -> Result<()> {
+    let elements =
+        |desc: &BufferDescriptor| desc.local_offset()..desc.local_offset() + desc.0.length as usize;
+    for (i, a) in descs.iter().enumerate() {
+        for b in &descs[i + 1..] {
+            let (a_elements, b_elements) = (elements(a), elements(b));
+            if a.0.stride != b.0.stride
+                || (a_elements.start < b_elements.end && b_elements.start < a_elements.end)
+            {
+                return Err(Error::InvalidBufferDescriptor);
+            }
+        }
+    }
+    Ok(())
+}
+
+// AIDEV-NOTE: Single validation path for every evaluator of every backend.
+// The OpenSubdiv kernels index the buffers without any bounds checks, so
+// every output must hold `point_count` primvars of the source's length and
+// the source must hold `src_count` primvars.
+/// Validates the buffers of an evaluation and flattens them for FFI.
+///
+/// `second_derivatives` is only evaluated together with `derivatives`.
+#[allow(clippy::too_many_arguments)]
+pub(crate) fn resolve_outputs<S: VertexBuffer, B: VertexBuffer>(
+    src: &S,
+    src_desc: BufferDescriptor,
+    src_count: usize,
+    dst: &mut B,
+    dst_desc: BufferDescriptor,
+    derivatives: Option<Derivatives<'_, B>>,
+    second_derivatives: Option<SecondDerivatives<'_, B>>,
+    point_count: usize,
+) -> Result<RawOutputs<B::Raw>> {
+    if !src_desc.is_valid() {
+        return Err(Error::InvalidBufferDescriptor);
+    }
+    check_buffer_len(src.float_count(), src_desc, src_count)?;
+
+    let check_desc =
+        |desc: BufferDescriptor| match desc.is_valid() && desc.0.length == src_desc.0.length {
+            true => Ok(()),
+            false => Err(Error::InvalidBufferDescriptor),
+        };
+    check_desc(dst_desc)?;
+    let dst_len = dst.float_count();
+    let dst_raw = dst.as_raw_mut();
+    check_buffer_len(dst_len, dst_desc, point_count)?;
+
+    let mut outputs = RawOutputs {
+        buffers: [std::ptr::null_mut(); 6],
+        descs: [BufferDescriptor::default().0; 6],
+    };
+    outputs.buffers[0] = dst_raw;
+    outputs.descs[0] = dst_desc.0;
+
+    let mut interleaved = vec![dst_desc];
+    let has_derivatives = derivatives.is_some();
+    let derivative_outputs = derivatives
+        .into_iter()
+        .flat_map(|d| [(1, d.du), (2, d.dv)])
+        .chain(
+            second_derivatives
+                .filter(|_| has_derivatives)
+                .into_iter()
+                .flat_map(|d| [(3, d.duu), (4, d.duv), (5, d.dvv)]),
+        );
+    for (slot, output) in derivative_outputs {
+        check_desc(output.desc)?;
+        let (raw, len) = match output.buffer {
+            Some(buffer) => (buffer.as_raw_mut(), buffer.float_count()),
+            None => {
+                interleaved.push(output.desc);
+                (dst_raw, dst_len)
+            }
+        };
+        check_buffer_len(len, output.desc, point_count)?;
+        outputs.buffers[slot] = raw;
+        outputs.descs[slot] = output.desc.0;
+    }
+    check_disjoint(&interleaved)?;
+
+    Ok(outputs)
+}
+
+/// Checks that every coordinate refers to a patch of `patch_table` and
+/// returns their count.
+pub(crate) fn check_patch_coords(
+    patch_table: &PatchTable,
+    patch_coords: &[PatchCoord],
+) -> Result<i32> {
+    let count = i32::try_from(patch_coords.len()).map_err(|_| Error::InvalidBufferSize {
+        expected: i32::MAX as usize,
+        actual: patch_coords.len(),
+    })?;
+    match patch_coords
+        .iter()
+        .find(|coord| !patch_table.is_valid_handle(coord.handle()))
+    {
+        Some(coord) => Err(Error::InvalidPatch(format!(
+            "patch coordinate refers to patch {} which is not in the patch table",
+            coord.handle().patch_index()
+        ))),
+        None => Ok(count),
+    }
+}
+
+/// Checks that an evaluation matches the buffer layout an evaluator
+/// instance was compiled for.
+///
+/// `compiled` holds the source descriptor followed by the output
+/// descriptors in the order of [`RawOutputs`]; outputs compiled with empty
+/// descriptors are not available.
+#[cfg(any(feature = "opencl", feature = "metal"))]
+pub(crate) fn check_compiled_layout<T>(
+    compiled: &[BufferDescriptor; 7],
+    src_desc: BufferDescriptor,
+    outputs: &RawOutputs<T>,
+) -> Result<()> {
+    let same_layout = |a: &sys::osd::BufferDescriptor, b: &sys::osd::BufferDescriptor| {
+        a.length == b.length && a.stride == b.stride
+    };
+    if !same_layout(&compiled[0].0, &src_desc.0) {
+        return Err(Error::InvalidBufferDescriptor);
+    }
+    for ((compiled, desc), buffer) in compiled[1..]
+        .iter()
+        .zip(&outputs.descs)
+        .zip(&outputs.buffers)
+    {
+        if buffer.is_null() {
+            continue;
+        }
+        if compiled.is_empty() {
+            return Err(Error::FeatureNotAvailable(
+                "evaluator was not compiled for these derivatives".to_string(),
+            ));
+        }
+        if !same_layout(&compiled.0, desc) {
+            return Err(Error::InvalidBufferDescriptor);
+        }
+    }
+    Ok(())
+}
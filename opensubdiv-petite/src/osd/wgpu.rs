@@ -5,9 +5,10 @@
 //! Pipeline setup and Bevy systems will live here; the shader source is the
 //! canonical version.
 
-use crate::far::{LimitStencilTable, StencilTable};
+use crate::far::{LimitStencilTable, StencilTable, StencilTableArrays};
+use crate::instrument::{self, Stage};
 use crate::osd::BufferDescriptor;
-use crate::{Error, Result};
+use crate::{Error, Index, Result};
 
 use std::borrow::Cow;
 use std::num::NonZeroU32;
@@ -19,6 +20,11 @@ use wgpu::util::DeviceExt;
 /// Canonical WGSL for stencil evaluation (positions + optional derivatives).
 pub const STENCIL_EVAL_WGSL: &str = include_str!("../../shaders/wgsl/stencil_eval.wgsl");
 
+/// WGSL for stencil evaluation over a [`CompactStencilTableGpu`] (positions
+/// only).
+pub const STENCIL_EVAL_COMPACT_WGSL: &str =
+    include_str!("../../shaders/wgsl/stencil_eval_compact.wgsl");
+
 /// Parameters used to configure the WGSL module creation.
 #[derive(Debug, Clone)]
 pub struct WgslModuleConfig {
@@ -61,6 +67,18 @@ pub enum WgpuError {
     #[error("Stencil table entry {value} exceeds u32 capacity")]
     StencilEntryTooLarge { value: usize },
 
+    /// A stencil reads control vertices too far apart for 16-bit local
+    /// indices.
+    #[error(
+        "Stencil {stencil} spans {span} control vertices; compact tables allow at most 65536 \
+         (reorder the control vertices to shrink it)"
+    )]
+    LocalIndexRangeExceeded { stencil: usize, span: usize },
+
+    /// A stencil weight is outside the range of `f16`.
+    #[error("Stencil weight {value} cannot be represented as f16")]
+    WeightNotRepresentable { value: f32 },
+
     /// Stencil offsets are missing but required for compute evaluation.
     #[error("Stencil table is missing offsets; enable generate_offsets in StencilTableOptions")]
     MissingOffsets,
@@ -95,6 +113,46 @@ impl StencilTableGpu {
         let offsets_u32: Vec<u32> = offsets.iter().map(|v| v.0).collect();
         let indices_u32: Vec<u32> = indices.iter().map(|v| v.0).collect();
 
+        Ok(Self::from_packed(
+            device,
+            sizes,
+            &offsets_u32,
+            &indices_u32,
+            weights,
+        ))
+    }
+
+    /// Upload stencil arrays borrowed from a
+    /// [`TableCache`](crate::far::TableCache).
+    ///
+    /// The arrays are uploaded as they are, straight from a mapped cache
+    /// file.
+    pub fn from_arrays(device: &wgpu::Device, arrays: &StencilTableArrays<'_>) -> Self {
+        Self::from_packed(
+            device,
+            arrays.sizes,
+            bytemuck::cast_slice(arrays.offsets),
+            bytemuck::cast_slice(arrays.control_indices),
+            arrays.weights,
+        )
+    }
+
+    /// Upload stencil table arrays that are already in the layout of the
+    /// shader.
+    fn from_packed(
+        device: &wgpu::Device,
+        sizes: &[u32],
+        offsets: &[u32],
+        indices: &[u32],
+        weights: &[f32],
+    ) -> Self {
+        let _timer = instrument::Timer::start(
+            Stage::GpuUpload,
+            std::mem::size_of_val(sizes)
+                + std::mem::size_of_val(offsets)
+                + std::mem::size_of_val(indices)
+                + std::mem::size_of_val(weights),
+        );
         let sizes_buf = device.create_buffer_init(&wgpu::util::BufferInitDescriptor {
             label: Some("opensubdiv-petite::stencil_sizes"),
             contents: bytemuck::cast_slice(sizes),
@@ -102,12 +160,12 @@ impl StencilTableGpu {
         });
         let offsets_buf = device.create_buffer_init(&wgpu::util::BufferInitDescriptor {
             label: Some("opensubdiv-petite::stencil_offsets"),
-            contents: bytemuck::cast_slice(&offsets_u32),
+            contents: bytemuck::cast_slice(offsets),
             usage: wgpu::BufferUsages::STORAGE | wgpu::BufferUsages::COPY_DST,
         });
         let indices_buf = device.create_buffer_init(&wgpu::util::BufferInitDescriptor {
             label: Some("opensubdiv-petite::stencil_indices"),
-            contents: bytemuck::cast_slice(&indices_u32),
+            contents: bytemuck::cast_slice(indices),
             usage: wgpu::BufferUsages::STORAGE | wgpu::BufferUsages::COPY_DST,
         });
         let weights_buf = device.create_buffer_init(&wgpu::util::BufferInitDescriptor {
@@ -116,14 +174,125 @@ impl StencilTableGpu {
             usage: wgpu::BufferUsages::STORAGE | wgpu::BufferUsages::COPY_DST,
         });
 
-        Ok(Self {
-            stencil_count: table.len() as u32,
+        Self {
+            stencil_count: sizes.len() as u32,
             sizes: sizes_buf,
             offsets: offsets_buf,
             indices: indices_buf,
             weights: weights_buf,
+        }
+    }
+}
+
+/// One mesh of a [`StencilBatchGpu`].
+#[derive(Debug, Clone, Copy)]
+pub struct StencilBatchEntry<'a> {
+    /// Stencils of the mesh.
+    pub table: &'a StencilTable,
+    /// First control vertex of the mesh in the shared source buffer.
+    ///
+    /// Meshes may share control vertices, e.g. instances of one cage.
+    pub src_vertex: usize,
+}
+
+/// Where one mesh of a [`StencilBatchGpu`] reads and writes, in primvars.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct StencilBatchRange {
+    /// Control vertices of the mesh in the shared source buffer.
+    pub src: std::ops::Range<usize>,
+    /// Primvars the mesh writes in the shared destination buffer.
+    pub dst: std::ops::Range<usize>,
+}
+
+/// The stencil tables of many meshes packed into one table, so that all of
+/// them are evaluated by a single dispatch.
+///
+/// The control indices of each mesh are rebased onto its
+/// [`src_vertex`](StencilBatchEntry::src_vertex) and its stencils follow
+/// those of the previous mesh, so the packed table is an ordinary
+/// [`StencilTableGpu`] for the shared source and destination buffers.
+/// [`meshes()`](Self::meshes) is the per-mesh offset table.
+#[derive(Debug)]
+pub struct StencilBatchGpu {
+    /// Packed stencils of all meshes.
+    pub table: StencilTableGpu,
+    meshes: Vec<StencilBatchRange>,
+    control_vertex_count: usize,
+}
+
+impl StencilBatchGpu {
+    /// Pack the stencil tables of `entries` and upload them.
+    ///
+    /// The tables need no offsets; they are recomputed while packing.
+    pub fn from_cpu(device: &wgpu::Device, entries: &[StencilBatchEntry<'_>]) -> WgpuResult<Self> {
+        let weight_count: usize = entries.iter().map(|e| e.table.weights().len()).sum();
+        let stencil_count: usize = entries.iter().map(|e| e.table.len()).sum();
+        let to_u32 = |value: usize| {
+            u32::try_from(value).map_err(|_| WgpuError::StencilEntryTooLarge { value })
+        };
+        to_u32(weight_count)?;
+        to_u32(stencil_count)?;
+
+        let mut sizes = Vec::with_capacity(stencil_count);
+        let mut offsets = Vec::with_capacity(stencil_count);
+        let mut indices = Vec::with_capacity(weight_count);
+        let mut weights = Vec::with_capacity(weight_count);
+        let mut meshes = Vec::with_capacity(entries.len());
+        let mut control_vertex_count = 0;
+
+        for entry in entries {
+            let table = entry.table;
+            let src_base = to_u32(entry.src_vertex)?;
+            let max_index = table.control_indices().iter().map(|i| i.0).max();
+            let src_end = match max_index {
+                Some(max) => entry.src_vertex + max as usize + 1,
+                None => entry.src_vertex,
+            }
+            .max(entry.src_vertex + table.control_vertex_count());
+            to_u32(src_end)?;
+
+            // Weights are stored in stencil order, so offsets are the running
+            // sum of the sizes.
+            let mut offset = weights.len() as u32;
+            for &size in table.sizes() {
+                offsets.push(offset);
+                offset += size;
+            }
+            sizes.extend_from_slice(table.sizes());
+            indices.extend(table.control_indices().iter().map(|i| i.0 + src_base));
+            weights.extend_from_slice(table.weights());
+
+            let dst_start = meshes.last().map_or(0, |m: &StencilBatchRange| m.dst.end);
+            meshes.push(StencilBatchRange {
+                src: entry.src_vertex..src_end,
+                dst: dst_start..dst_start + table.len(),
+            });
+            control_vertex_count = control_vertex_count.max(src_end);
+        }
+
+        Ok(Self {
+            table: StencilTableGpu::from_packed(device, &sizes, &offsets, &indices, &weights),
+            meshes,
+            control_vertex_count,
         })
     }
+
+    /// Returns the source and destination ranges of each mesh, in the order
+    /// of the entries the batch was created from.
+    pub fn meshes(&self) -> &[StencilBatchRange] {
+        &self.meshes
+    }
+
+    /// Returns the number of control vertices the shared source buffer must
+    /// hold.
+    pub fn control_vertex_count(&self) -> usize {
+        self.control_vertex_count
+    }
+
+    /// Returns the total number of stencils, i.e. of primvars written.
+    pub fn stencil_count(&self) -> usize {
+        self.table.stencil_count as usize
+    }
 }
 
 /// Upload a float slice as a storage buffer, or a 4-byte zero buffer if empty.
@@ -175,6 +344,7 @@ impl LimitStencilTableGpu {
         let offsets_u32: Vec<u32> = offsets.iter().map(|v| v.0).collect();
         let indices_u32: Vec<u32> = indices.iter().map(|v| v.0).collect();
 
+        let _timer = instrument::Timer::start(Stage::GpuUpload, table.memory_footprint().total());
         let sizes_buf = device.create_buffer_init(&wgpu::util::BufferInitDescriptor {
             label: Some("opensubdiv-petite::limit_stencil_sizes"),
             contents: bytemuck::cast_slice(sizes),
@@ -604,6 +774,54 @@ impl StencilEvalPipeline {
         })
     }
 
+    /// Create a bind group matching the layout of `stencil_eval.wgsl`.
+    ///
+    /// `derivative_weights` and `derivative_outputs` are bound in the order
+    /// du, dv, duu, duv, dvv.
+    #[allow(clippy::too_many_arguments)]
+    fn create_bind_group(
+        &self,
+        device: &wgpu::Device,
+        label: &str,
+        params: &wgpu::Buffer,
+        src_buffer: &wgpu::Buffer,
+        dst_buffer: &wgpu::Buffer,
+        gpu_table: &StencilTableGpu,
+        derivative_weights: [&wgpu::Buffer; 5],
+        derivative_outputs: [&wgpu::Buffer; 5],
+    ) -> wgpu::BindGroup {
+        let buffers = [
+            params,
+            src_buffer,
+            dst_buffer,
+            &gpu_table.sizes,
+            &gpu_table.offsets,
+            &gpu_table.indices,
+            &gpu_table.weights,
+        ]
+        .into_iter()
+        .chain(derivative_weights)
+        .chain(derivative_outputs);
+        let entries: Vec<wgpu::BindGroupEntry<'_>> = buffers
+            .enumerate()
+            .map(|(binding, buffer)| wgpu::BindGroupEntry {
+                binding: binding as u32,
+                resource: buffer.as_entire_binding(),
+            })
+            .collect();
+
+        device.create_bind_group(&wgpu::BindGroupDescriptor {
+            label: Some(label),
+            layout: &self.bind_group_layout,
+            entries: &entries,
+        })
+    }
+
+    /// Number of workgroups covering `invocations` threads.
+    fn workgroup_count(&self, invocations: u32) -> u32 {
+        invocations.div_ceil(self.workgroup_size.get())
+    }
+
     /// Encode a stencil evaluation dispatch.
     #[allow(clippy::too_many_arguments)]
     pub fn encode(
@@ -617,6 +835,7 @@ impl StencilEvalPipeline {
         dst_desc: BufferDescriptor,
         batch_range: std::ops::Range<u32>,
     ) -> Result<()> {
+        let _timer = instrument::Timer::start(Stage::GpuEncode, 0);
         let params =
             ShaderParams::from_descriptors(src_desc, dst_desc, batch_range.start, batch_range.end)
                 .map_err(|e| Error::Ffi(e.to_string()))?;
@@ -626,85 +845,20 @@ impl StencilEvalPipeline {
             usage: wgpu::BufferUsages::UNIFORM | wgpu::BufferUsages::COPY_DST,
         });
 
+        // Derivatives are not evaluated; bind zero buffers.
         let zero_weights = Self::empty_buffer(device, "opensubdiv-petite::zero_weights");
         let zero_output = Self::empty_buffer(device, "opensubdiv-petite::zero_derivative");
 
-        let bind_group = device.create_bind_group(&wgpu::BindGroupDescriptor {
-            label: Some("opensubdiv-petite::stencil_eval_bg"),
-            layout: &self.bind_group_layout,
-            entries: &[
-                wgpu::BindGroupEntry {
-                    binding: 0,
-                    resource: params_buf.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 1,
-                    resource: src_buffer.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 2,
-                    resource: dst_buffer.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 3,
-                    resource: gpu_table.sizes.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 4,
-                    resource: gpu_table.offsets.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 5,
-                    resource: gpu_table.indices.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 6,
-                    resource: gpu_table.weights.as_entire_binding(),
-                },
-                // Derivative weights: not yet wired; bind zero buffers.
-                wgpu::BindGroupEntry {
-                    binding: 7,
-                    resource: zero_weights.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 8,
-                    resource: zero_weights.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 9,
-                    resource: zero_weights.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 10,
-                    resource: zero_weights.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 11,
-                    resource: zero_weights.as_entire_binding(),
-                },
-                // Derivative outputs: not yet wired; bind dummy outputs.
-                wgpu::BindGroupEntry {
-                    binding: 12,
-                    resource: zero_output.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 13,
-                    resource: zero_output.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 14,
-                    resource: zero_output.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 15,
-                    resource: zero_output.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 16,
-                    resource: zero_output.as_entire_binding(),
-                },
-            ],
-        });
+        let bind_group = self.create_bind_group(
+            device,
+            "opensubdiv-petite::stencil_eval_bg",
+            &params_buf,
+            src_buffer,
+            dst_buffer,
+            gpu_table,
+            [&zero_weights; 5],
+            [&zero_output; 5],
+        );
 
         let mut pass = encoder.begin_compute_pass(&wgpu::ComputePassDescriptor {
             label: Some("opensubdiv-petite::stencil_eval"),
@@ -712,10 +866,11 @@ impl StencilEvalPipeline {
         });
         pass.set_pipeline(&self.pipeline);
         pass.set_bind_group(0, &bind_group, &[]);
-
-        let invocations = batch_range.end - batch_range.start;
-        let groups = invocations.div_ceil(self.workgroup_size.get());
-        pass.dispatch_workgroups(groups, 1, 1);
+        pass.dispatch_workgroups(
+            self.workgroup_count(batch_range.end - batch_range.start),
+            1,
+            1,
+        );
         drop(pass);
 
         Ok(())
@@ -742,6 +897,7 @@ impl StencilEvalPipeline {
         deriv_descs: Option<&DerivativeDescriptors>,
         batch_range: std::ops::Range<u32>,
     ) -> Result<()> {
+        let _timer = instrument::Timer::start(Stage::GpuEncode, 0);
         let params = ShaderParams::from_descriptors_with_derivatives(
             src_desc,
             dst_desc,
@@ -765,82 +921,22 @@ impl StencilEvalPipeline {
         let duv_out = deriv_outputs.and_then(|d| d.duv).unwrap_or(&zero_buf);
         let dvv_out = deriv_outputs.and_then(|d| d.dvv).unwrap_or(&zero_buf);
 
-        let bind_group = device.create_bind_group(&wgpu::BindGroupDescriptor {
-            label: Some("opensubdiv-petite::stencil_eval_deriv_bg"),
-            layout: &self.bind_group_layout,
-            entries: &[
-                wgpu::BindGroupEntry {
-                    binding: 0,
-                    resource: params_buf.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 1,
-                    resource: src_buffer.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 2,
-                    resource: dst_buffer.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 3,
-                    resource: gpu_table.base.sizes.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 4,
-                    resource: gpu_table.base.offsets.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 5,
-                    resource: gpu_table.base.indices.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 6,
-                    resource: gpu_table.base.weights.as_entire_binding(),
-                },
-                // Derivative weight buffers.
-                wgpu::BindGroupEntry {
-                    binding: 7,
-                    resource: gpu_table.du_weights.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 8,
-                    resource: gpu_table.dv_weights.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 9,
-                    resource: gpu_table.duu_weights.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 10,
-                    resource: gpu_table.duv_weights.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 11,
-                    resource: gpu_table.dvv_weights.as_entire_binding(),
-                },
-                // Derivative output buffers.
-                wgpu::BindGroupEntry {
-                    binding: 12,
-                    resource: du_out.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 13,
-                    resource: dv_out.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 14,
-                    resource: duu_out.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 15,
-                    resource: duv_out.as_entire_binding(),
-                },
-                wgpu::BindGroupEntry {
-                    binding: 16,
-                    resource: dvv_out.as_entire_binding(),
-                },
+        let bind_group = self.create_bind_group(
+            device,
+            "opensubdiv-petite::stencil_eval_deriv_bg",
+            &params_buf,
+            src_buffer,
+            dst_buffer,
+            &gpu_table.base,
+            [
+                &gpu_table.du_weights,
+                &gpu_table.dv_weights,
+                &gpu_table.duu_weights,
+                &gpu_table.duv_weights,
+                &gpu_table.dvv_weights,
             ],
-        });
+            [du_out, dv_out, duu_out, duv_out, dvv_out],
+        );
 
         let mut pass = encoder.begin_compute_pass(&wgpu::ComputePassDescriptor {
             label: Some("opensubdiv-petite::stencil_eval_derivs"),
@@ -848,14 +944,301 @@ impl StencilEvalPipeline {
         });
         pass.set_pipeline(&self.pipeline);
         pass.set_bind_group(0, &bind_group, &[]);
-
-        let invocations = batch_range.end - batch_range.start;
-        let groups = invocations.div_ceil(self.workgroup_size.get());
-        pass.dispatch_workgroups(groups, 1, 1);
+        pass.dispatch_workgroups(
+            self.workgroup_count(batch_range.end - batch_range.start),
+            1,
+            1,
+        );
         drop(pass);
 
         Ok(())
     }
+
+    /// Encode the evaluation of several [`StencilEvalContext`]s into one
+    /// compute pass.
+    ///
+    /// The pipeline is bound once; each context only binds its cached bind
+    /// group and dispatches. Nothing is allocated on the device.
+    pub fn encode_contexts<'c>(
+        &self,
+        encoder: &mut wgpu::CommandEncoder,
+        contexts: impl IntoIterator<Item = &'c StencilEvalContext>,
+    ) {
+        let _timer = instrument::Timer::start(Stage::GpuEncode, 0);
+        let mut pass = encoder.begin_compute_pass(&wgpu::ComputePassDescriptor {
+            label: Some("opensubdiv-petite::stencil_eval_contexts"),
+            timestamp_writes: None,
+        });
+        pass.set_pipeline(&self.pipeline);
+        for context in contexts {
+            if context.table.stencil_count == 0 {
+                continue;
+            }
+            pass.set_bind_group(0, &context.bind_group, &[]);
+            pass.dispatch_workgroups(self.workgroup_count(context.table.stencil_count), 1, 1);
+        }
+    }
+}
+
+/// Long-lived stencil evaluation state of one mesh, or of a batch of meshes
+/// (see [`new_batched()`](Self::new_batched)).
+///
+/// Uploads the stencil table and creates the coarse (source) and refined
+/// (destination) vertex buffers, the shader parameters and the bind group
+/// once. Per frame only the coarse vertices are written with
+/// [`update_control_vertices()`](Self::update_control_vertices) before the
+/// context is encoded, alone or together with other meshes through
+/// [`StencilEvalPipeline::encode_contexts()`].
+///
+/// ```rust,ignore
+/// let pipeline = StencilEvalPipeline::new(&device, WgslModuleConfig::default());
+/// let context = StencilEvalContext::new(&device, &pipeline, &stencil_table, desc, desc)?;
+///
+/// // Every frame:
+/// context.update_control_vertices(&queue, &deformed_positions, 0)?;
+/// pipeline.encode_contexts(&mut encoder, [&context]);
+/// ```
+#[derive(Debug)]
+pub struct StencilEvalContext {
+    table: StencilTableGpu,
+    src_buffer: wgpu::Buffer,
+    dst_buffer: wgpu::Buffer,
+    bind_group: wgpu::BindGroup,
+    src_desc: BufferDescriptor,
+    dst_desc: BufferDescriptor,
+    meshes: Vec<StencilBatchRange>,
+    control_vertex_count: usize,
+}
+
+impl StencilEvalContext {
+    /// Upload `table` and create the buffers to evaluate it with `pipeline`.
+    ///
+    /// The source buffer holds the control vertices of `table` laid out as
+    /// described by `src_desc`; the destination buffer holds one primvar per
+    /// stencil laid out as described by `dst_desc`. The destination buffer
+    /// can also be bound as a vertex buffer.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the descriptors are invalid or differ in length,
+    /// or if the table is missing offsets or has primvars wider than the
+    /// WGSL kernel supports.
+    pub fn new(
+        device: &wgpu::Device,
+        pipeline: &StencilEvalPipeline,
+        table: &StencilTable,
+        src_desc: BufferDescriptor,
+        dst_desc: BufferDescriptor,
+    ) -> Result<Self> {
+        let gpu_table =
+            StencilTableGpu::from_cpu(device, table).map_err(|e| Error::Ffi(e.to_string()))?;
+        let meshes = vec![StencilBatchRange {
+            src: 0..table.control_vertex_count(),
+            dst: 0..table.len(),
+        }];
+        Self::from_gpu_table(
+            device,
+            pipeline,
+            gpu_table,
+            meshes,
+            table.control_vertex_count(),
+            src_desc,
+            dst_desc,
+        )
+    }
+
+    /// Pack the stencil tables of many meshes into one context that
+    /// evaluates all of them with a single dispatch.
+    ///
+    /// All meshes share the source and destination buffers; where each mesh
+    /// reads and writes is returned by [`meshes()`](Self::meshes). This
+    /// removes the per-dispatch overhead that dominates when evaluating many
+    /// small meshes.
+    ///
+    /// # Errors
+    ///
+    /// See [`new()`](Self::new).
+    pub fn new_batched(
+        device: &wgpu::Device,
+        pipeline: &StencilEvalPipeline,
+        entries: &[StencilBatchEntry<'_>],
+        src_desc: BufferDescriptor,
+        dst_desc: BufferDescriptor,
+    ) -> Result<Self> {
+        let batch =
+            StencilBatchGpu::from_cpu(device, entries).map_err(|e| Error::Ffi(e.to_string()))?;
+        Self::from_gpu_table(
+            device,
+            pipeline,
+            batch.table,
+            batch.meshes,
+            batch.control_vertex_count,
+            src_desc,
+            dst_desc,
+        )
+    }
+
+    fn from_gpu_table(
+        device: &wgpu::Device,
+        pipeline: &StencilEvalPipeline,
+        gpu_table: StencilTableGpu,
+        meshes: Vec<StencilBatchRange>,
+        control_vertex_count: usize,
+        src_desc: BufferDescriptor,
+        dst_desc: BufferDescriptor,
+    ) -> Result<Self> {
+        if !src_desc.is_valid() || !dst_desc.is_valid() || src_desc.0.length != dst_desc.0.length {
+            return Err(Error::InvalidBufferDescriptor);
+        }
+
+        let params = ShaderParams::from_descriptors(src_desc, dst_desc, 0, gpu_table.stencil_count)
+            .map_err(|e| Error::Ffi(e.to_string()))?;
+        let params_buf = device.create_buffer_init(&wgpu::util::BufferInitDescriptor {
+            label: Some("opensubdiv-petite::context_params"),
+            contents: bytes_of(&params),
+            usage: wgpu::BufferUsages::UNIFORM,
+        });
+
+        let src_buffer = create_float_buffer(
+            device,
+            "opensubdiv-petite::context_src",
+            src_desc.buffer_len(control_vertex_count),
+            wgpu::BufferUsages::STORAGE | wgpu::BufferUsages::COPY_DST,
+        );
+        let dst_buffer = create_float_buffer(
+            device,
+            "opensubdiv-petite::context_dst",
+            dst_desc.buffer_len(gpu_table.stencil_count as usize),
+            wgpu::BufferUsages::STORAGE | wgpu::BufferUsages::COPY_SRC | wgpu::BufferUsages::VERTEX,
+        );
+
+        let zero_weights =
+            StencilEvalPipeline::empty_buffer(device, "opensubdiv-petite::zero_weights");
+        let zero_output =
+            StencilEvalPipeline::empty_buffer(device, "opensubdiv-petite::zero_derivative");
+        let bind_group = pipeline.create_bind_group(
+            device,
+            "opensubdiv-petite::context_bg",
+            &params_buf,
+            &src_buffer,
+            &dst_buffer,
+            &gpu_table,
+            [&zero_weights; 5],
+            [&zero_output; 5],
+        );
+
+        Ok(Self {
+            table: gpu_table,
+            src_buffer,
+            dst_buffer,
+            bind_group,
+            src_desc,
+            dst_desc,
+            meshes,
+            control_vertex_count,
+        })
+    }
+
+    /// Write control vertex data into the source buffer, starting at control
+    /// vertex `start_vertex`.
+    ///
+    /// `data` is laid out like the source buffer, i.e. with the stride of the
+    /// source descriptor. The write is staged by the queue and lands before
+    /// the next submitted command buffer executes.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`Error::InvalidBufferSize`] if `data` does not fit into the
+    /// source buffer.
+    pub fn update_control_vertices(
+        &self,
+        queue: &wgpu::Queue,
+        data: &[f32],
+        start_vertex: usize,
+    ) -> Result<()> {
+        let start = start_vertex * self.src_desc.0.stride as usize;
+        let capacity = self.src_desc.buffer_len(self.control_vertex_count);
+        if start + data.len() > capacity {
+            return Err(Error::InvalidBufferSize {
+                expected: capacity.saturating_sub(start),
+                actual: data.len(),
+            });
+        }
+        if !data.is_empty() {
+            instrument::stage(Stage::GpuUpload, std::mem::size_of_val(data), || {
+                queue.write_buffer(
+                    &self.src_buffer,
+                    (start * std::mem::size_of::<f32>()) as u64,
+                    bytemuck::cast_slice(data),
+                )
+            });
+        }
+        Ok(())
+    }
+
+    /// Encode the evaluation of this context into its own compute pass.
+    pub fn encode(&self, pipeline: &StencilEvalPipeline, encoder: &mut wgpu::CommandEncoder) {
+        pipeline.encode_contexts(encoder, std::iter::once(self));
+    }
+
+    /// Returns the uploaded stencil table.
+    pub fn stencil_table(&self) -> &StencilTableGpu {
+        &self.table
+    }
+
+    /// Returns the number of stencils, i.e. of primvars written per
+    /// evaluation.
+    pub fn stencil_count(&self) -> usize {
+        self.table.stencil_count as usize
+    }
+
+    /// Returns the source and destination ranges of each mesh, in primvars.
+    ///
+    /// A context created with [`new()`](Self::new) has a single mesh
+    /// covering both buffers.
+    pub fn meshes(&self) -> &[StencilBatchRange] {
+        &self.meshes
+    }
+
+    /// Returns the number of control vertices the source buffer holds.
+    pub fn control_vertex_count(&self) -> usize {
+        self.control_vertex_count
+    }
+
+    /// Returns the source (coarse vertex) buffer.
+    pub fn src_buffer(&self) -> &wgpu::Buffer {
+        &self.src_buffer
+    }
+
+    /// Returns the destination (refined vertex) buffer.
+    pub fn dst_buffer(&self) -> &wgpu::Buffer {
+        &self.dst_buffer
+    }
+
+    /// Returns the layout of the source buffer.
+    pub fn src_desc(&self) -> BufferDescriptor {
+        self.src_desc
+    }
+
+    /// Returns the layout of the destination buffer.
+    pub fn dst_desc(&self) -> BufferDescriptor {
+        self.dst_desc
+    }
+}
+
+/// Create an uninitialized buffer of `len` floats (at least one).
+fn create_float_buffer(
+    device: &wgpu::Device,
+    label: &str,
+    len: usize,
+    usage: wgpu::BufferUsages,
+) -> wgpu::Buffer {
+    device.create_buffer(&wgpu::BufferDescriptor {
+        label: Some(label),
+        size: (len.max(1) * std::mem::size_of::<f32>()) as u64,
+        usage,
+        mapped_at_creation: false,
+    })
 }
 
 /// One-shot convenience: encode, submit, and wait for stencil evaluation.
@@ -884,8 +1267,10 @@ pub fn evaluate_stencils(
         dst_desc,
         batch_range,
     )?;
-    queue.submit(std::iter::once(encoder.finish()));
-    device.poll(wgpu::PollType::wait_indefinitely()).ok();
+    instrument::stage(Stage::GpuWait, 0, || {
+        queue.submit(std::iter::once(encoder.finish()));
+        device.poll(wgpu::PollType::wait_indefinitely()).ok();
+    });
     Ok(())
 }
 
@@ -920,7 +1305,389 @@ pub fn evaluate_stencils_with_derivatives(
         deriv_descs,
         batch_range,
     )?;
-    queue.submit(std::iter::once(encoder.finish()));
-    device.poll(wgpu::PollType::wait_indefinitely()).ok();
+    instrument::stage(Stage::GpuWait, 0, || {
+        queue.submit(std::iter::once(encoder.finish()));
+        device.poll(wgpu::PollType::wait_indefinitely()).ok();
+    });
+    Ok(())
+}
+
+/// How closely a [`CompactStencilTable`] reproduces the `f32` table it was
+/// encoded from, and what it saves.
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct CompactEncodingReport {
+    /// Largest absolute difference between a weight and its `f16` encoding.
+    pub max_weight_error: f32,
+    /// Largest sum of the absolute weight errors of one stencil.
+    ///
+    /// Bounds the difference to the `f32` path relative to the largest
+    /// magnitude among the source primvars.
+    pub max_stencil_error: f32,
+    /// Size of the compact stencil buffers, in bytes.
+    pub compact_bytes: usize,
+    /// Size of the buffers of the equivalent [`StencilTableGpu`], in bytes.
+    pub full_bytes: usize,
+}
+
+/// Host-side compact encoding of a [`StencilTable`].
+///
+/// Weights are stored as `f16` and control indices as `u16` relative to the
+/// lowest index of their stencil, two per word, and the sizes are folded
+/// into the offsets. This takes a little over half the memory of the `f32`
+/// encoding, and the kernel, which is bound by memory bandwidth, reads half
+/// the bytes.
+#[derive(Debug, Clone)]
+pub struct CompactStencilTable {
+    offsets: Vec<u32>,
+    bases: Vec<u32>,
+    indices: Vec<u32>,
+    weights: Vec<u32>,
+    report: CompactEncodingReport,
+}
+
+impl CompactStencilTable {
+    /// Encode `table`.
+    ///
+    /// The tables need no offsets; they are recomputed from the sizes.
+    ///
+    /// # Errors
+    ///
+    /// Returns [`WgpuError::LocalIndexRangeExceeded`] if a stencil reads
+    /// control vertices more than 65535 apart, e.g. before being
+    /// [reordered](crate::far::StencilTable::reordered), and
+    /// [`WgpuError::WeightNotRepresentable`] if a weight overflows `f16`.
+    pub fn encode(table: &StencilTable) -> WgpuResult<Self> {
+        let sizes = table.sizes();
+        let indices = table.control_indices();
+        let weights = table.weights();
+        u32::try_from(weights.len()).map_err(|_| WgpuError::StencilEntryTooLarge {
+            value: weights.len(),
+        })?;
+
+        let mut offsets = Vec::with_capacity(sizes.len() + 1);
+        let mut bases = Vec::with_capacity(sizes.len());
+        let mut local_indices = Vec::with_capacity(indices.len());
+        let mut max_weight_error = 0.0f32;
+        let mut max_stencil_error = 0.0f32;
+
+        let mut begin = 0;
+        for (stencil, &size) in sizes.iter().enumerate() {
+            let end = begin + size as usize;
+            let stencil_indices = &indices[begin..end];
+            let base = stencil_indices.iter().map(|i| i.0).min().unwrap_or(0);
+            let top = stencil_indices.iter().map(|i| i.0).max().unwrap_or(0);
+            let span = (top - base) as usize + 1;
+            if span > 1 << 16 {
+                return Err(WgpuError::LocalIndexRangeExceeded { stencil, span });
+            }
+
+            let mut stencil_error = 0.0f32;
+            for &weight in &weights[begin..end] {
+                let error = (half::f16::from_f32(weight).to_f32() - weight).abs();
+                if !error.is_finite() {
+                    return Err(WgpuError::WeightNotRepresentable { value: weight });
+                }
+                max_weight_error = max_weight_error.max(error);
+                stencil_error += error;
+            }
+            max_stencil_error = max_stencil_error.max(stencil_error);
+
+            offsets.push(begin as u32);
+            bases.push(base);
+            local_indices.extend(stencil_indices.iter().map(|i| (i.0 - base) as u16));
+            begin = end;
+        }
+        offsets.push(begin as u32);
+
+        let pack = |halves: &mut dyn Iterator<Item = u16>| -> Vec<u32> {
+            let mut words = Vec::new();
+            while let Some(low) = halves.next() {
+                let high = halves.next().unwrap_or(0);
+                words.push(u32::from(low) | u32::from(high) << 16);
+            }
+            words
+        };
+        let indices_packed = pack(&mut local_indices.into_iter());
+        let weights_packed = pack(&mut weights.iter().map(|&w| half::f16::from_f32(w).to_bits()));
+
+        let word = std::mem::size_of::<u32>();
+        let compact_bytes =
+            (offsets.len() + bases.len() + indices_packed.len() + weights_packed.len()) * word;
+        let full_bytes = (2 * sizes.len() + indices.len() + weights.len()) * word;
+
+        Ok(Self {
+            offsets,
+            bases,
+            indices: indices_packed,
+            weights: weights_packed,
+            report: CompactEncodingReport {
+                max_weight_error,
+                max_stencil_error,
+                compact_bytes,
+                full_bytes,
+            },
+        })
+    }
+
+    /// Returns the number of stencils.
+    pub fn len(&self) -> usize {
+        self.bases.len()
+    }
+
+    /// Returns `true` if the table holds no stencils.
+    pub fn is_empty(&self) -> bool {
+        self.bases.is_empty()
+    }
+
+    /// Returns the accuracy and size of the encoding.
+    pub fn report(&self) -> CompactEncodingReport {
+        self.report
+    }
+
+    /// Returns control index and weight of each tap of `stencil` as the
+    /// kernel decodes them.
+    pub fn decode_stencil(&self, stencil: usize) -> Option<Vec<(Index, f32)>> {
+        let base = *self.bases.get(stencil)?;
+        let taps = self.offsets[stencil] as usize..self.offsets[stencil + 1] as usize;
+        Some(
+            taps.map(|tap| {
+                let shift = (tap & 1) * 16;
+                let index = (self.indices[tap / 2] >> shift) & 0xffff;
+                let weight = half::f16::from_bits((self.weights[tap / 2] >> shift) as u16);
+                (Index(base + index), weight.to_f32())
+            })
+            .collect(),
+        )
+    }
+}
+
+/// GPU-side compact stencil table buffers (see [`CompactStencilTable`]).
+#[derive(Debug)]
+pub struct CompactStencilTableGpu {
+    pub stencil_count: u32,
+    pub offsets: wgpu::Buffer,
+    pub bases: wgpu::Buffer,
+    pub indices: wgpu::Buffer,
+    pub weights: wgpu::Buffer,
+    /// Accuracy and size of the uploaded encoding.
+    pub report: CompactEncodingReport,
+}
+
+impl CompactStencilTableGpu {
+    /// Encode `table` compactly and upload it.
+    ///
+    /// # Errors
+    ///
+    /// See [`CompactStencilTable::encode()`].
+    pub fn from_cpu(device: &wgpu::Device, table: &StencilTable) -> WgpuResult<Self> {
+        Ok(Self::upload(device, &CompactStencilTable::encode(table)?))
+    }
+
+    /// Upload an already encoded table.
+    pub fn upload(device: &wgpu::Device, table: &CompactStencilTable) -> Self {
+        let _timer = instrument::Timer::start(
+            Stage::GpuUpload,
+            std::mem::size_of_val(table.offsets.as_slice())
+                + std::mem::size_of_val(table.bases.as_slice())
+                + std::mem::size_of_val(table.indices.as_slice())
+                + std::mem::size_of_val(table.weights.as_slice()),
+        );
+        let buffer = |label: &str, words: &[u32]| {
+            // Storage bindings must not be empty.
+            let contents: &[u32] = if words.is_empty() { &[0] } else { words };
+            device.create_buffer_init(&wgpu::util::BufferInitDescriptor {
+                label: Some(label),
+                contents: bytemuck::cast_slice(contents),
+                usage: wgpu::BufferUsages::STORAGE | wgpu::BufferUsages::COPY_DST,
+            })
+        };
+        Self {
+            stencil_count: table.len() as u32,
+            offsets: buffer("opensubdiv-petite::compact_stencil_offsets", &table.offsets),
+            bases: buffer("opensubdiv-petite::compact_stencil_bases", &table.bases),
+            indices: buffer("opensubdiv-petite::compact_stencil_indices", &table.indices),
+            weights: buffer("opensubdiv-petite::compact_stencil_weights", &table.weights),
+            report: table.report,
+        }
+    }
+}
+
+/// Compute pipeline + layout for stencil evaluation over a
+/// [`CompactStencilTableGpu`].
+#[derive(Debug)]
+pub struct CompactStencilEvalPipeline {
+    _shader: wgpu::ShaderModule,
+    bind_group_layout: wgpu::BindGroupLayout,
+    pipeline: wgpu::ComputePipeline,
+    workgroup_size: NonZeroU32,
+}
+
+impl CompactStencilEvalPipeline {
+    pub fn new(device: &wgpu::Device, config: WgslModuleConfig) -> Self {
+        let shader = device.create_shader_module(wgpu::ShaderModuleDescriptor {
+            label: Some("opensubdiv-petite::stencil_eval_compact_wgsl"),
+            source: wgpu::ShaderSource::Wgsl(Cow::Borrowed(STENCIL_EVAL_COMPACT_WGSL)),
+        });
+
+        let storage = |binding: u32, read_only: bool| wgpu::BindGroupLayoutEntry {
+            binding,
+            visibility: wgpu::ShaderStages::COMPUTE,
+            ty: wgpu::BindingType::Buffer {
+                ty: wgpu::BufferBindingType::Storage { read_only },
+                has_dynamic_offset: false,
+                min_binding_size: None,
+            },
+            count: None,
+        };
+        let bind_group_layout = device.create_bind_group_layout(&wgpu::BindGroupLayoutDescriptor {
+            label: Some("opensubdiv-petite::stencil_eval_compact_bgl"),
+            entries: &[
+                // 0: uniform params
+                wgpu::BindGroupLayoutEntry {
+                    binding: 0,
+                    visibility: wgpu::ShaderStages::COMPUTE,
+                    ty: wgpu::BindingType::Buffer {
+                        ty: wgpu::BufferBindingType::Uniform,
+                        has_dynamic_offset: false,
+                        min_binding_size: std::num::NonZeroU64::new(
+                            std::mem::size_of::<ShaderParams>() as u64,
+                        ),
+                    },
+                    count: None,
+                },
+                // 1: src, 2: dst
+                storage(1, true),
+                storage(2, false),
+                // 3-6: offsets, bases, indices, weights
+                storage(3, true),
+                storage(4, true),
+                storage(5, true),
+                storage(6, true),
+            ],
+        });
+
+        let pipeline_layout = device.create_pipeline_layout(&wgpu::PipelineLayoutDescriptor {
+            label: Some("opensubdiv-petite::stencil_eval_compact_pipeline_layout"),
+            bind_group_layouts: &[Some(&bind_group_layout)],
+            immediate_size: 0,
+        });
+
+        let constants = config.pipeline_constants();
+        let constants_refs: Vec<(&str, f64)> =
+            constants.iter().map(|(k, v)| (k.as_str(), *v)).collect();
+        let pipeline = device.create_compute_pipeline(&wgpu::ComputePipelineDescriptor {
+            label: Some("opensubdiv-petite::stencil_eval_compact_pipeline"),
+            layout: Some(&pipeline_layout),
+            module: &shader,
+            entry_point: Some("eval_stencils"),
+            compilation_options: wgpu::PipelineCompilationOptions {
+                constants: &constants_refs,
+                zero_initialize_workgroup_memory: true,
+            },
+            cache: None,
+        });
+
+        Self {
+            _shader: shader,
+            bind_group_layout,
+            pipeline,
+            workgroup_size: config.workgroup_size,
+        }
+    }
+
+    /// Encode a stencil evaluation dispatch.
+    #[allow(clippy::too_many_arguments)]
+    pub fn encode(
+        &self,
+        device: &wgpu::Device,
+        encoder: &mut wgpu::CommandEncoder,
+        gpu_table: &CompactStencilTableGpu,
+        src_buffer: &wgpu::Buffer,
+        dst_buffer: &wgpu::Buffer,
+        src_desc: BufferDescriptor,
+        dst_desc: BufferDescriptor,
+        batch_range: std::ops::Range<u32>,
+    ) -> Result<()> {
+        let _timer = instrument::Timer::start(Stage::GpuEncode, 0);
+        let params =
+            ShaderParams::from_descriptors(src_desc, dst_desc, batch_range.start, batch_range.end)
+                .map_err(|e| Error::Ffi(e.to_string()))?;
+        let params_buf = device.create_buffer_init(&wgpu::util::BufferInitDescriptor {
+            label: Some("opensubdiv-petite::compact_stencil_params"),
+            contents: bytes_of(&params),
+            usage: wgpu::BufferUsages::UNIFORM | wgpu::BufferUsages::COPY_DST,
+        });
+
+        let buffers = [
+            &params_buf,
+            src_buffer,
+            dst_buffer,
+            &gpu_table.offsets,
+            &gpu_table.bases,
+            &gpu_table.indices,
+            &gpu_table.weights,
+        ];
+        let entries: Vec<wgpu::BindGroupEntry<'_>> = buffers
+            .iter()
+            .enumerate()
+            .map(|(binding, buffer)| wgpu::BindGroupEntry {
+                binding: binding as u32,
+                resource: buffer.as_entire_binding(),
+            })
+            .collect();
+        let bind_group = device.create_bind_group(&wgpu::BindGroupDescriptor {
+            label: Some("opensubdiv-petite::stencil_eval_compact_bg"),
+            layout: &self.bind_group_layout,
+            entries: &entries,
+        });
+
+        let mut pass = encoder.begin_compute_pass(&wgpu::ComputePassDescriptor {
+            label: Some("opensubdiv-petite::stencil_eval_compact"),
+            timestamp_writes: None,
+        });
+        pass.set_pipeline(&self.pipeline);
+        pass.set_bind_group(0, &bind_group, &[]);
+        pass.dispatch_workgroups(
+            (batch_range.end - batch_range.start).div_ceil(self.workgroup_size.get()),
+            1,
+            1,
+        );
+        drop(pass);
+
+        Ok(())
+    }
+}
+
+/// One-shot convenience: encode, submit, and wait for stencil evaluation over
+/// a compact table.
+#[allow(clippy::too_many_arguments)]
+pub fn evaluate_compact_stencils(
+    device: &wgpu::Device,
+    queue: &wgpu::Queue,
+    pipeline: &CompactStencilEvalPipeline,
+    gpu_table: &CompactStencilTableGpu,
+    src_buffer: &wgpu::Buffer,
+    dst_buffer: &wgpu::Buffer,
+    src_desc: BufferDescriptor,
+    dst_desc: BufferDescriptor,
+    batch_range: std::ops::Range<u32>,
+) -> Result<()> {
+    let mut encoder = device.create_command_encoder(&wgpu::CommandEncoderDescriptor {
+        label: Some("opensubdiv-petite::evaluate_compact_stencils"),
+    });
+    pipeline.encode(
+        device,
+        &mut encoder,
+        gpu_table,
+        src_buffer,
+        dst_buffer,
+        src_desc,
+        dst_desc,
+        batch_range,
+    )?;
+    instrument::stage(Stage::GpuWait, 0, || {
+        queue.submit(std::iter::once(encoder.finish()));
+        device.poll(wgpu::PollType::wait_indefinitely()).ok();
+    });
     Ok(())
 }
@@ -29,20 +29,20 @@ pub fn to_triangle_mesh_buffers<'a>(
     vertices: &[f32],
     face_vertices: impl Into<FaceVerticesIter<'a>> + Iterator,
 ) -> (Vec<u32>, Vec<[f32; 3]>, Vec<[f32; 3]>) {
-    let face_vertices_iter = face_vertices.into();
+    // Fetch all faces at once instead of one FFI call per face and pass.
+    let relation = face_vertices.into().remaining_relation();
 
     #[cfg(feature = "topology_validation")]
-    for face in face_vertices_iter {
-        for index in face {
-            if vertices.len() <= (3 * index.0 + 2) as usize {
-                panic!("Vertex index {} is out of bounds.", index.0);
-            }
+    for index in relation.indices() {
+        if vertices.len() <= (3 * index.0 + 2) as usize {
+            panic!("Vertex index {} is out of bounds.", index.0);
         }
     }
 
     let points_nested = vertices.nest::<[_; 3]>();
 
-    let (points_nested, normals_nested): (Vec<[f32; 3]>, Vec<[f32; 3]>) = face_vertices_iter
+    let (points_nested, normals_nested): (Vec<[f32; 3]>, Vec<[f32; 3]>) = relation
+        .iter()
         .flat_map(|face| {
             face.iter()
                 // Grab the three vertex index entries.
@@ -92,7 +92,8 @@ pub fn to_triangle_mesh_buffers<'a>(
         .unzip();
 
     // Build a new face index. Same topology as the old one, only with new keys.
-    let triangle_face_index = face_vertices_iter
+    let triangle_face_index = relation
+        .iter()
         // Build a new index where each face has the original arity and the new
         // numbering.
         .scan(0.., |counter, face| {
@@ -138,8 +139,9 @@ pub fn to_triangle_mesh_buffers_par<'a>(
     vertices: &[f32],
     face_vertices: FaceVerticesParIter<'a>,
 ) -> (Vec<u32>, Vec<[f32; 3]>, Vec<[f32; 3]>) {
-    // Collect faces into a vector first for validation and indexing
-    let faces: Vec<_> = face_vertices.collect();
+    // Fetch all faces at once for validation and indexing.
+    let relation = face_vertices.relation();
+    let faces: Vec<_> = relation.iter().collect();
 
     #[cfg(feature = "topology_validation")]
     {
@@ -0,0 +1,297 @@
+//! Tests for `Bfr` surface evaluation.
+
+use opensubdiv_petite::bfr::{
+    BfrError, Surface, SurfaceFactory, SurfaceFactoryCache, TessellatedMesh, TessellationOptions,
+    TessellationRate,
+};
+use opensubdiv_petite::far::{
+    PatchEvalOutputs, TopologyDescriptor, TopologyRefiner, TopologyRefinerOptions,
+};
+use opensubdiv_petite::osd::BufferDescriptor;
+use opensubdiv_petite::Index;
+
+const CUBE_POSITIONS: [[f32; 3]; 8] = [
+    [-0.5, -0.5, 0.5],
+    [0.5, -0.5, 0.5],
+    [-0.5, 0.5, 0.5],
+    [0.5, 0.5, 0.5],
+    [-0.5, 0.5, -0.5],
+    [0.5, 0.5, -0.5],
+    [-0.5, -0.5, -0.5],
+    [0.5, -0.5, -0.5],
+];
+
+const CUBE_VERTICES_PER_FACE: [u32; 6] = [4; 6];
+const CUBE_FACE_VERTICES: [u32; 24] = [
+    0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+];
+
+fn cube_refiner() -> TopologyRefiner {
+    let descriptor =
+        TopologyDescriptor::new(8, &CUBE_VERTICES_PER_FACE, &CUBE_FACE_VERTICES).unwrap();
+    TopologyRefiner::new(descriptor, TopologyRefinerOptions::default()).unwrap()
+}
+
+/// The cube with one face-varying UV channel that maps every face to the
+/// full unit square, so all edges are UV seams.
+fn cube_refiner_with_uvs() -> (TopologyRefiner, Vec<f32>) {
+    let uv_indices: Vec<u32> = (0..24).collect();
+    let uvs: Vec<f32> = (0..6)
+        .flat_map(|_| [0.0, 0.0, 1.0, 0.0, 1.0, 1.0, 0.0, 1.0])
+        .collect();
+
+    let descriptor = TopologyDescriptor::new(8, &CUBE_VERTICES_PER_FACE, &CUBE_FACE_VERTICES)
+        .unwrap()
+        .face_varying_channel(24, &uv_indices)
+        .unwrap();
+    let refiner = TopologyRefiner::new(descriptor, TopologyRefinerOptions::default()).unwrap();
+    (refiner, uvs)
+}
+
+#[test]
+fn evaluate_points_matches_evaluate_position() {
+    let refiner = cube_refiner();
+    let factory = SurfaceFactory::new(&refiner, 2, 6).unwrap();
+    let mesh_points: Vec<f32> = CUBE_POSITIONS.iter().flatten().copied().collect();
+
+    let (u, v): (Vec<f32>, Vec<f32>) = (0..25)
+        .map(|i| ((i % 5) as f32 / 4.0, (i / 5) as f32 / 4.0))
+        .unzip();
+    let desc = BufferDescriptor::new(0, 3, 3).unwrap();
+
+    // One scratch buffer serves all faces.
+    let mut patch_points = Vec::new();
+    let mut position = vec![0.0; u.len() * 3];
+    let mut du = vec![0.0; u.len() * 3];
+    let mut dv = vec![0.0; u.len() * 3];
+
+    for face in 0..6u32 {
+        let surface = factory.init_vertex_surface(Index::from(face)).unwrap();
+        patch_points.resize(surface.patch_point_count() * 3, 0.0);
+        surface
+            .prepare_patch_points(&mesh_points, 3, &mut patch_points)
+            .unwrap();
+        surface
+            .evaluate_points(
+                &patch_points,
+                3,
+                &u,
+                &v,
+                PatchEvalOutputs {
+                    desc,
+                    position: Some(&mut position),
+                    du: Some(&mut du),
+                    dv: Some(&mut dv),
+                    ..Default::default()
+                },
+            )
+            .unwrap();
+
+        for i in 0..u.len() {
+            let expected = surface
+                .evaluate_position(u[i], v[i], &CUBE_POSITIONS)
+                .unwrap();
+            assert_eq!(&position[i * 3..i * 3 + 3], &expected);
+
+            // The cube's limit surface is convex, so the tangents are never
+            // degenerate.
+            let tangent_len = |d: &[f32]| d.iter().map(|c| c * c).sum::<f32>().sqrt();
+            assert!(tangent_len(&du[i * 3..i * 3 + 3]) > 1e-3);
+            assert!(tangent_len(&dv[i * 3..i * 3 + 3]) > 1e-3);
+        }
+    }
+}
+
+#[test]
+fn prepare_patch_points_validates_buffers() {
+    let refiner = cube_refiner();
+    let factory = SurfaceFactory::new(&refiner, 2, 6).unwrap();
+    let mesh_points: Vec<f32> = CUBE_POSITIONS.iter().flatten().copied().collect();
+    let surface = factory.init_vertex_surface(Index::from(0u32)).unwrap();
+
+    let mut patch_points = vec![0.0; surface.patch_point_count() * 3];
+    // Too few mesh points for the face's neighborhood.
+    assert!(surface
+        .prepare_patch_points(&mesh_points[..9], 3, &mut patch_points)
+        .is_err());
+    // Too small a patch point buffer.
+    assert!(surface
+        .prepare_patch_points(&mesh_points, 3, &mut patch_points[..3])
+        .is_err());
+
+    surface
+        .prepare_patch_points(&mesh_points, 3, &mut patch_points)
+        .unwrap();
+    // Output descriptor length must match the point size.
+    let mut position = vec![0.0; 4];
+    assert!(surface
+        .evaluate_points(
+            &patch_points,
+            3,
+            &[0.5],
+            &[0.5],
+            PatchEvalOutputs {
+                desc: BufferDescriptor::new(0, 4, 4).unwrap(),
+                position: Some(&mut position),
+                ..Default::default()
+            },
+        )
+        .is_err());
+}
+
+#[test]
+fn tessellate_shares_boundary_points() {
+    let refiner = cube_refiner();
+    let cache = SurfaceFactoryCache::new().unwrap();
+    let factory = SurfaceFactory::with_cache(&refiner, 2, 6, &cache).unwrap();
+
+    let mesh = factory
+        .tessellate(
+            &CUBE_POSITIONS,
+            TessellationOptions {
+                rate: TessellationRate::Uniform(4),
+                ..Default::default()
+            },
+        )
+        .unwrap();
+
+    // 8 corners, 3 points inside each of the 12 edges and 3x3 inside each
+    // of the 6 faces -- nothing on a shared boundary is duplicated.
+    assert_eq!(mesh.positions.len(), 8 + 12 * 3 + 6 * 9);
+    assert_eq!(mesh.normals.len(), mesh.positions.len());
+    assert_eq!(mesh.facet_count(), 6 * 4 * 4 * 2);
+
+    // Every point is referenced and every index is in range.
+    let mut referenced = vec![false; mesh.positions.len()];
+    for &index in &mesh.indices {
+        assert_ne!(index, TessellatedMesh::NO_INDEX);
+        referenced[index as usize] = true;
+    }
+    assert!(referenced.iter().all(|&r| r));
+
+    for normal in &mesh.normals {
+        let len = normal.iter().map(|c| c * c).sum::<f32>().sqrt();
+        assert!((len - 1.0).abs() < 1e-4, "{normal:?}");
+    }
+    // Surfaces were built through the shared cache.
+    assert!(cache.entry_count() > 0);
+
+    // Edge-length-driven rates split the unit cube's edges in two.
+    let mesh = factory
+        .tessellate(
+            &CUBE_POSITIONS,
+            TessellationOptions {
+                rate: TessellationRate::EdgeLength {
+                    max_length: 0.5,
+                    max_rate: 8,
+                },
+                normals: false,
+                ..Default::default()
+            },
+        )
+        .unwrap();
+    assert_eq!(mesh.positions.len(), 8 + 12 + 6);
+    assert!(mesh.normals.is_empty());
+}
+
+#[test]
+fn evaluate_positions_and_face_varying_uvs() {
+    let (refiner, uvs) = cube_refiner_with_uvs();
+    let factory = SurfaceFactory::new(&refiner, 2, 6).unwrap();
+    assert_eq!(factory.face_varying_channel_count(), 1);
+    let mesh_points: Vec<f32> = CUBE_POSITIONS.iter().flatten().copied().collect();
+
+    let (u, v): (Vec<f32>, Vec<f32>) = (0..9)
+        .map(|i| ((i % 3) as f32 / 2.0, (i / 3) as f32 / 2.0))
+        .unzip();
+    let mut vertex = Surface::new().unwrap();
+    let mut varying = Surface::new().unwrap();
+    let mut face_varying = Surface::new().unwrap();
+    let (mut vertex_points, mut varying_points, mut uv_points) =
+        (Vec::new(), Vec::new(), Vec::new());
+    let mut position = vec![0.0; u.len() * 3];
+    let mut linear_position = vec![0.0; u.len() * 3];
+    let mut uv = vec![0.0; u.len() * 2];
+
+    for face in 0..6u32 {
+        factory
+            .init_surfaces_into(
+                Index::from(face),
+                &mut vertex,
+                Some(&mut varying),
+                Some((0, &mut face_varying)),
+            )
+            .unwrap();
+
+        for (surface, mesh, point_size, patch_points, output) in [
+            (&vertex, &mesh_points, 3, &mut vertex_points, &mut position),
+            (
+                &varying,
+                &mesh_points,
+                3,
+                &mut varying_points,
+                &mut linear_position,
+            ),
+            (&face_varying, &uvs, 2, &mut uv_points, &mut uv),
+        ] {
+            patch_points.resize(surface.patch_point_count() * point_size, 0.0);
+            surface
+                .prepare_patch_points(mesh, point_size, patch_points)
+                .unwrap();
+            let desc = BufferDescriptor::new(0, point_size, point_size).unwrap();
+            surface
+                .evaluate_points(
+                    patch_points,
+                    point_size,
+                    &u,
+                    &v,
+                    PatchEvalOutputs {
+                        desc,
+                        position: Some(output.as_mut_slice()),
+                        ..Default::default()
+                    },
+                )
+                .unwrap();
+        }
+
+        // The UVs are linear and span the unit square on every face.
+        for i in 0..u.len() {
+            assert!((uv[i * 2] - u[i]).abs() < 1e-5, "face {face}: {uv:?}");
+            assert!((uv[i * 2 + 1] - v[i]).abs() < 1e-5, "face {face}: {uv:?}");
+        }
+
+        // Varying data interpolates the face's corners bilinearly; the
+        // corners themselves sit on the cage.
+        let corner = &CUBE_POSITIONS[CUBE_FACE_VERTICES[face as usize * 4] as usize];
+        for k in 0..3 {
+            assert!((linear_position[k] - corner[k]).abs() < 1e-5);
+            let center = (0..4)
+                .map(|c| CUBE_POSITIONS[CUBE_FACE_VERTICES[face as usize * 4 + c] as usize][k])
+                .sum::<f32>()
+                / 4.0;
+            assert!((linear_position[4 * 3 + k] - center).abs() < 1e-5);
+        }
+
+        // The same position comes out of a separately initialized surface.
+        let separate = factory.init_vertex_surface(Index::from(face)).unwrap();
+        assert_eq!(
+            separate
+                .evaluate_position(u[4], v[4], &CUBE_POSITIONS)
+                .unwrap(),
+            position[4 * 3..5 * 3]
+        );
+    }
+
+    // Channels are validated up front.
+    assert!(matches!(
+        factory.init_face_varying_surface(Index::from(0u32), 1),
+        Err(BfrError::InvalidFaceVaryingChannel(1))
+    ));
+    let short_indices = [0u32; 3];
+    assert!(
+        TopologyDescriptor::new(8, &CUBE_VERTICES_PER_FACE, &CUBE_FACE_VERTICES)
+            .unwrap()
+            .face_varying_channel(24, &short_indices)
+            .is_err()
+    );
+}
@@ -2,6 +2,7 @@
 
 use anyhow::Result;
 use opensubdiv_petite::far::*;
+use opensubdiv_petite::osd::BufferDescriptor;
 use opensubdiv_petite::Index;
 
 #[test]
@@ -101,6 +102,60 @@ fn topology_refiner_creation() -> Result<()> {
     Ok(())
 }
 
+#[test]
+fn topology_refiner_bulk_creation_matches_descriptor() -> Result<()> {
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+    let crease_vertices = [0, 1];
+    let crease_weights = [3.0];
+    let uv_indices: Vec<u32> = (0..face_vertices.len() as u32).collect();
+
+    for left_handed in [false, true] {
+        let descriptor = || {
+            TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?
+                .creases(&crease_vertices, &crease_weights)?
+                .face_varying_channel(uv_indices.len(), &uv_indices)
+                .map(|descriptor| descriptor.left_handed(left_handed))
+        };
+        let options = TopologyRefinerOptions::default();
+        let expected = TopologyRefiner::new(descriptor()?, options)?;
+        let validated =
+            TopologyRefiner::with_validation(descriptor()?, options, TopologyValidation::Full)?;
+        let trusted = unsafe { TopologyRefiner::new_trusted(descriptor()?, options)? };
+
+        let expected = expected.level(0).unwrap();
+        for refiner in [&validated, &trusted] {
+            let level = refiner.level(0).unwrap();
+            assert_eq!(level.edge_count(), expected.edge_count());
+            assert_eq!(
+                level.face_vertex_relation().indices(),
+                expected.face_vertex_relation().indices()
+            );
+            assert_eq!(
+                level.face_varying_value_relation(0).unwrap().indices(),
+                expected.face_varying_value_relation(0).unwrap().indices()
+            );
+            assert_eq!(level.edge_sharpnesses(), expected.edge_sharpnesses());
+        }
+    }
+
+    // Out-of-range indices are caught before reaching OpenSubdiv.
+    let bad_face_vertices = [0, 1, 2, 8];
+    // With `topology_validation` the descriptor already rejects them.
+    #[cfg(feature = "topology_validation")]
+    assert!(TopologyDescriptor::new(8, &[4], &bad_face_vertices).is_err());
+    #[cfg(not(feature = "topology_validation"))]
+    assert!(TopologyRefiner::with_validation(
+        TopologyDescriptor::new(8, &[4], &bad_face_vertices)?,
+        TopologyRefinerOptions::default(),
+        TopologyValidation::Indices,
+    )
+    .is_err());
+    Ok(())
+}
+
 #[test]
 fn topology_refiner_uniform_refinement() -> Result<()> {
     let vertices_per_face = [4, 4, 4, 4, 4, 4];
@@ -216,6 +271,80 @@ fn topology_level_relationships() -> Result<()> {
     Ok(())
 }
 
+#[test]
+fn topology_level_bulk_relations() -> Result<()> {
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+    let crease_vertices = [0, 1];
+    let crease_weights = [2.0];
+    // One UV per face-vertex.
+    let uv_indices: Vec<u32> = (0..face_vertices.len() as u32).collect();
+
+    let descriptor = TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?
+        .creases(&crease_vertices, &crease_weights)?
+        .face_varying_channel(uv_indices.len(), &uv_indices)?;
+    let mut refiner = TopologyRefiner::new(descriptor, TopologyRefinerOptions::default())?;
+    refiner.refine_uniform(UniformRefinementOptions {
+        refinement_level: 2,
+        ..Default::default()
+    });
+
+    for level_index in 0..=2 {
+        let level = refiner.level(level_index).unwrap();
+
+        let faces = level.face_vertex_relation();
+        assert_eq!(faces.len(), level.face_count());
+        assert_eq!(faces.indices().len(), level.face_vertex_count());
+        for (face, row) in faces.iter().enumerate() {
+            assert_eq!(Some(row), level.face_vertices(Index::from(face)));
+        }
+
+        let vertex_faces = level.vertex_face_relation();
+        assert_eq!(vertex_faces.len(), level.vertex_count());
+        for vertex in 0..level.vertex_count() {
+            assert_eq!(
+                vertex_faces.row(vertex),
+                level.vertex_faces(Index::from(vertex))
+            );
+        }
+
+        let uvs = level.face_varying_value_relation(0).unwrap();
+        assert_eq!(uvs.offsets(), faces.offsets());
+        for face in 0..level.face_count() {
+            assert_eq!(
+                uvs.row(face),
+                level.face_varying_values_on_face(Index::from(face), 0)
+            );
+        }
+        assert!(level.face_varying_value_relation(1).is_none());
+
+        let edges = level.edge_vertex_pairs();
+        assert_eq!(edges.len(), level.edge_count());
+        let edge_sharpnesses = level.edge_sharpnesses();
+        for (edge, pair) in edges.iter().enumerate() {
+            assert_eq!(Some(&pair[..]), level.edge_vertices(Index::from(edge)));
+            assert_eq!(
+                edge_sharpnesses[edge],
+                level.edge_sharpness(Index::from(edge))
+            );
+        }
+        let vertex_sharpnesses = level.vertex_sharpnesses();
+        for (vertex, &sharpness) in vertex_sharpnesses.iter().enumerate() {
+            assert_eq!(sharpness, level.vertex_sharpness(Index::from(vertex)));
+        }
+    }
+
+    // The crease is assigned at the base level.
+    let level0 = refiner.level(0).unwrap();
+    let edge = level0
+        .find_edge(Index::from(0u32), Index::from(1u32))
+        .unwrap();
+    assert_eq!(level0.edge_sharpnesses()[edge.0 as usize], 2.0);
+    Ok(())
+}
+
 #[test]
 fn primvar_refiner() -> Result<()> {
     let vertices_per_face = [4, 4, 4, 4, 4, 4];
@@ -260,6 +389,182 @@ fn primvar_refiner() -> Result<()> {
     Ok(())
 }
 
+#[test]
+fn primvar_refiner_interleaved() -> Result<()> {
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+    let descriptor = TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?;
+    let mut refiner = TopologyRefiner::new(descriptor, TopologyRefinerOptions::default())?;
+    refiner.refine_uniform(UniformRefinementOptions {
+        refinement_level: 2,
+        ..Default::default()
+    });
+    let primvar_refiner = PrimvarRefiner::new(&refiner)?;
+    let level1_count = refiner.level(1).unwrap().vertex_count();
+
+    // 12 (fixed-width) and 13 (generic) elements per vertex, the latter
+    // padded and offset inside a stride of 16.
+    for (width, offset, stride) in [(12, 0, 12), (13, 1, 16)] {
+        let src: Vec<f32> = (0..8 * stride)
+            .map(|i| ((i * 7919) % 101) as f32 * 0.01)
+            .collect();
+        let src_desc = BufferDescriptor::new(offset, width, stride)?;
+        let dst_desc = BufferDescriptor::new(0, width, width)?;
+        let mut dst = vec![0.0; level1_count * width];
+        primvar_refiner.interpolate_interleaved(
+            PrimvarInterpolation::Vertex,
+            1,
+            &src,
+            src_desc,
+            &mut dst,
+            dst_desc,
+        )?;
+
+        // Every element matches refining its column on its own.
+        for k in 0..width {
+            let column: Vec<f32> = (0..8).map(|v| src[v * stride + offset + k]).collect();
+            let expected = primvar_refiner.interpolate(1, 1, &column).unwrap();
+            for v in 0..level1_count {
+                assert!((dst[v * width + k] - expected[v]).abs() < 1e-6);
+            }
+        }
+    }
+
+    // Face-uniform data is copied from the parent faces.
+    let face_ids: Vec<f32> = (0..6).map(|face| face as f32).collect();
+    let child_ids = primvar_refiner
+        .interpolate_face_uniform(1, 1, &face_ids)
+        .unwrap();
+    assert_eq!(child_ids.len(), refiner.level(1).unwrap().face_count());
+    assert!(child_ids.iter().all(|&id| (0.0..6.0).contains(&id)));
+
+    // Invalid levels, descriptors and buffers are rejected instead of
+    // aborting.
+    let desc = BufferDescriptor::new(0, 9, 9)?;
+    let src = vec![0.0; 8 * 9];
+    let mut dst = vec![0.0; level1_count * 9];
+    for level in [0, 3] {
+        assert!(primvar_refiner
+            .interpolate_interleaved(
+                PrimvarInterpolation::Vertex,
+                level,
+                &src,
+                desc,
+                &mut dst,
+                desc
+            )
+            .is_err());
+    }
+    assert!(primvar_refiner
+        .interpolate_interleaved(
+            PrimvarInterpolation::Vertex,
+            1,
+            &src,
+            desc,
+            &mut dst,
+            BufferDescriptor::new(0, 3, 9)?,
+        )
+        .is_err());
+    assert!(primvar_refiner
+        .interpolate_interleaved(
+            PrimvarInterpolation::Vertex,
+            1,
+            &src[..8 * 9 - 1],
+            desc,
+            &mut dst,
+            desc,
+        )
+        .is_err());
+    assert!(primvar_refiner
+        .interpolate_interleaved(
+            PrimvarInterpolation::FaceVarying(0),
+            1,
+            &src,
+            desc,
+            &mut dst,
+            desc,
+        )
+        .is_err());
+    assert!(primvar_refiner.interpolate(1, 9, &src[..9]).is_none());
+    Ok(())
+}
+
+#[test]
+fn primvar_refiner_levels() -> Result<()> {
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+    let positions = [
+        -0.5, -0.5, 0.5, 0.5, -0.5, 0.5, -0.5, 0.5, 0.5, 0.5, 0.5, 0.5, -0.5, 0.5, -0.5, 0.5, 0.5,
+        -0.5, -0.5, -0.5, -0.5, 0.5, -0.5, -0.5,
+    ];
+    let descriptor = TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?;
+    let mut refiner = TopologyRefiner::new(descriptor, TopologyRefinerOptions::default())?;
+    refiner.refine_uniform(UniformRefinementOptions {
+        refinement_level: 3,
+        ..Default::default()
+    });
+    let primvar_refiner = PrimvarRefiner::new(&refiner)?;
+
+    let offsets = primvar_refiner.level_offsets(PrimvarInterpolation::Vertex)?;
+    assert_eq!(offsets.len(), 5);
+    assert_eq!(offsets[4], refiner.vertex_count_all_levels());
+
+    // All levels in one buffer.
+    let desc = BufferDescriptor::new(0, 3, 3)?;
+    let mut all_levels = vec![0.0; offsets[4] * 3];
+    all_levels[..24].copy_from_slice(&positions);
+    primvar_refiner.interpolate_levels(PrimvarInterpolation::Vertex, &mut all_levels, desc)?;
+
+    let mut expected = positions.to_vec();
+    for level in 1..=3 {
+        expected = primvar_refiner.interpolate(level, 3, &expected).unwrap();
+        assert_eq!(
+            &all_levels[offsets[level] * 3..offsets[level + 1] * 3],
+            expected.as_slice()
+        );
+    }
+
+    // Only the finest level, ping-ponging through a reusable scratch buffer.
+    let mut scratch = Vec::new();
+    let mut finest = vec![0.0; (offsets[4] - offsets[3]) * 3];
+    primvar_refiner.interpolate_to_level(
+        PrimvarInterpolation::Vertex,
+        3,
+        &positions,
+        desc,
+        &mut scratch,
+        &mut finest,
+        desc,
+    )?;
+    assert_eq!(finest, expected);
+    assert_eq!(scratch.len(), (offsets[3] - offsets[2]) * 3);
+
+    // Short buffers are rejected.
+    assert!(primvar_refiner
+        .interpolate_levels(
+            PrimvarInterpolation::Vertex,
+            &mut all_levels[..offsets[4] * 3 - 1],
+            desc
+        )
+        .is_err());
+    assert!(primvar_refiner
+        .interpolate_to_level(
+            PrimvarInterpolation::Vertex,
+            3,
+            &positions,
+            desc,
+            &mut scratch,
+            &mut finest[..3],
+            desc,
+        )
+        .is_err());
+    Ok(())
+}
+
 #[test]
 fn stencil_table() -> Result<()> {
     let vertices_per_face = [4, 4, 4, 4, 4, 4];
@@ -331,6 +636,534 @@ fn stencil_table() -> Result<()> {
     Ok(())
 }
 
+#[test]
+fn stencil_table_update_values_interleaved() -> Result<()> {
+    use opensubdiv_petite::osd::BufferDescriptor;
+
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+    // Position (xyz) interleaved with one extra channel.
+    let primvars: Vec<f32> = (0..8)
+        .flat_map(|vertex| {
+            let vertex = vertex as f32;
+            [vertex, vertex * 2.0, -vertex, vertex * 0.5]
+        })
+        .collect();
+
+    let descriptor = TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?;
+    let mut refiner = TopologyRefiner::new(descriptor, TopologyRefinerOptions::default())?;
+    refiner.refine_uniform(UniformRefinementOptions {
+        refinement_level: 2,
+        ..Default::default()
+    });
+
+    let stencil_table = StencilTable::new(
+        &refiner,
+        StencilTableOptions {
+            generate_intermediate_levels: false,
+            ..Default::default()
+        },
+    )?;
+    let stencil_count = stencil_table.len();
+
+    // Write xyz with a stride of 4, leaving the last element untouched.
+    let mut dst = vec![f32::NAN; stencil_count * 4];
+    stencil_table.update_values_interleaved(
+        &primvars,
+        BufferDescriptor::new(0, 3, 4)?,
+        &mut dst,
+        BufferDescriptor::new(0, 3, 4)?,
+        None,
+        None,
+    )?;
+
+    for dim in 0..3 {
+        let src_dim: Vec<f32> = primvars.chunks_exact(4).map(|p| p[dim]).collect();
+        let expected = stencil_table.update_values(&src_dim, None, None);
+        for (stencil, &value) in expected.iter().enumerate() {
+            assert!((dst[stencil * 4 + dim] - value).abs() < 1e-5);
+        }
+    }
+    assert!(dst.chunks_exact(4).all(|p| p[3].is_nan()));
+
+    // A sub-range writes `end - start` points starting at `dst[0]`.
+    let mut slice = vec![0.0f32; 5 * 4];
+    stencil_table.update_values_interleaved(
+        &primvars,
+        BufferDescriptor::new(0, 4, 4)?,
+        &mut slice,
+        BufferDescriptor::new(0, 4, 4)?,
+        Some(10),
+        Some(15),
+    )?;
+    for (point, chunk) in slice.chunks_exact(4).enumerate() {
+        for dim in 0..3 {
+            assert!((chunk[dim] - dst[(10 + point) * 4 + dim]).abs() < 1e-5);
+        }
+    }
+
+    // Mismatched lengths and short buffers are rejected.
+    assert!(stencil_table
+        .update_values_interleaved(
+            &primvars,
+            BufferDescriptor::new(0, 3, 4)?,
+            &mut dst,
+            BufferDescriptor::new(0, 4, 4)?,
+            None,
+            None,
+        )
+        .is_err());
+    assert!(stencil_table
+        .update_values_interleaved(
+            &primvars[..8],
+            BufferDescriptor::new(0, 3, 4)?,
+            &mut dst,
+            BufferDescriptor::new(0, 3, 4)?,
+            None,
+            None,
+        )
+        .is_err());
+
+    Ok(())
+}
+
+#[test]
+fn stencil_table_dirty_update_matches_full() -> Result<()> {
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+    let mut positions: Vec<f32> = (0..8 * 3).map(|i| i as f32 * 0.25).collect();
+
+    let descriptor = TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?;
+    let mut refiner = TopologyRefiner::new(descriptor, TopologyRefinerOptions::default())?;
+    refiner.refine_uniform(UniformRefinementOptions {
+        refinement_level: 3,
+        ..Default::default()
+    });
+    let stencil_table = StencilTable::new(
+        &refiner,
+        StencilTableOptions {
+            generate_intermediate_levels: false,
+            ..Default::default()
+        },
+    )?;
+    let reverse_index = StencilReverseIndex::new(&stencil_table)?;
+    assert_eq!(reverse_index.stencil_count(), stencil_table.len());
+    assert_eq!(reverse_index.control_vertex_count(), 8);
+
+    // Every stencil reading a vertex is listed under it.
+    let sizes = stencil_table.sizes();
+    let indices = stencil_table.control_indices();
+    let mut begin = 0;
+    for (stencil, &size) in sizes.iter().enumerate() {
+        for index in &indices[begin..begin + size as usize] {
+            assert!(reverse_index
+                .dependent_stencils(*index)
+                .contains(&Index::from(stencil)));
+        }
+        begin += size as usize;
+    }
+
+    let desc = BufferDescriptor::new(0, 3, 3)?;
+    let mut refined = vec![0.0; stencil_table.len() * 3];
+    stencil_table.update_values_interleaved(&positions, desc, &mut refined, desc, None, None)?;
+
+    positions[3 * 3 + 1] += 1.0;
+    positions[6 * 3] -= 0.5;
+    let dirty = [Index::from(3u32), Index::from(6u32)];
+    let updated = stencil_table.update_dirty_values(
+        &reverse_index,
+        &dirty,
+        &positions,
+        desc,
+        &mut refined,
+        desc,
+    )?;
+    assert_eq!(updated, reverse_index.dirty_stencils(&dirty)?.len());
+    assert!(updated < stencil_table.len());
+
+    let mut expected = vec![0.0; stencil_table.len() * 3];
+    stencil_table.update_values_interleaved(&positions, desc, &mut expected, desc, None, None)?;
+    for (value, expected) in refined.iter().zip(&expected) {
+        assert!((value - expected).abs() < 1e-5);
+    }
+
+    assert!(stencil_table
+        .update_dirty_values(
+            &reverse_index,
+            &[Index::from(8u32)],
+            &positions,
+            desc,
+            &mut refined,
+            desc,
+        )
+        .is_err());
+
+    // A table of the relabeled cube has the same counts but other taps.
+    let relabeled: Vec<u32> = face_vertices.iter().map(|&vertex| 7 - vertex).collect();
+    let descriptor = TopologyDescriptor::new(8, &vertices_per_face, &relabeled)?;
+    let mut refiner = TopologyRefiner::new(descriptor, TopologyRefinerOptions::default())?;
+    refiner.refine_uniform(UniformRefinementOptions {
+        refinement_level: 3,
+        ..Default::default()
+    });
+    let other_table = StencilTable::new(
+        &refiner,
+        StencilTableOptions {
+            generate_intermediate_levels: false,
+            ..Default::default()
+        },
+    )?;
+    assert_eq!(other_table.len(), stencil_table.len());
+    let all_vertices: Vec<Index> = (0..8u32).map(Index::from).collect();
+    assert!(matches!(
+        other_table.update_dirty_values(
+            &reverse_index,
+            &all_vertices,
+            &positions,
+            desc,
+            &mut refined,
+            desc,
+        ),
+        Err(opensubdiv_petite::Error::ReverseIndexMismatch)
+    ));
+    Ok(())
+}
+
+#[test]
+fn stencil_table_reordered_matches_original() -> Result<()> {
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+    let positions = [
+        -0.5_f32, -0.5, 0.5, 0.5, -0.5, 0.5, -0.5, 0.5, 0.5, 0.5, 0.5, 0.5, -0.5, 0.5, -0.5, 0.5,
+        0.5, -0.5, -0.5, -0.5, -0.5, 0.5, -0.5, -0.5,
+    ];
+
+    let descriptor = TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?;
+    let mut refiner = TopologyRefiner::new(descriptor, TopologyRefinerOptions::default())?;
+    refiner.refine_uniform(UniformRefinementOptions {
+        refinement_level: 2,
+        ..Default::default()
+    });
+    let stencil_table = StencilTable::new(&refiner, StencilTableOptions::default())?;
+    let desc = BufferDescriptor::new(0, 3, 3)?;
+    let evaluate = |table: &StencilTable, src: &[f32]| -> Result<Vec<f32>> {
+        let mut dst = vec![0.0; table.len() * 3];
+        table.update_values_interleaved(src, desc, &mut dst, desc, None, None)?;
+        Ok(dst)
+    };
+    let expected = evaluate(&stencil_table, &positions)?;
+
+    let orders = [
+        reverse_cuthill_mckee_order(&refiner.level(0).unwrap()),
+        morton_order(&positions, 3),
+    ];
+    for control_vertex_order in &orders {
+        for stencil_order in [StencilOrder::Original, StencilOrder::BySource] {
+            let (reordered, permutation) =
+                stencil_table.reordered(control_vertex_order, stencil_order)?;
+            assert_eq!(reordered.len(), stencil_table.len());
+            assert_eq!(permutation.control_vertices(), &control_vertex_order[..]);
+
+            // Each stencil reads its control vertices in ascending order.
+            for i in 0..reordered.len() {
+                let indices = reordered.stencil(Index::from(i)).unwrap().indices();
+                assert!(indices.windows(2).all(|pair| pair[0] <= pair[1]));
+            }
+
+            let src = permutation.permute_control_values(&positions, 3)?;
+            let values = evaluate(&reordered, &src)?;
+            let restored = permutation.restore_stencil_values(&values, 3)?;
+            assert_eq!(restored.len(), expected.len());
+            for (a, b) in expected.iter().zip(&restored) {
+                assert!((a - b).abs() < 1e-6, "{a} vs {b}");
+            }
+        }
+    }
+
+    // Non-permutations are rejected.
+    assert!(stencil_table
+        .reordered(&[Index(0); 8], StencilOrder::Original)
+        .is_err());
+    Ok(())
+}
+
+#[test]
+fn table_cache_round_trips() -> Result<()> {
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+
+    let descriptor = TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?;
+    let mut refiner = TopologyRefiner::new(descriptor, TopologyRefinerOptions::default())?;
+    refiner.refine_adaptive(
+        AdaptiveRefinementOptions {
+            isolation_level: 2,
+            ..Default::default()
+        },
+        None,
+    );
+    let stencil_table = StencilTable::new(&refiner, StencilTableOptions::default())?;
+    let patch_table = PatchTable::new(&refiner, None)?;
+
+    let hash = 0x0123_4567_89ab_cdef;
+    let mut bytes = Vec::new();
+    TableCacheWriter::new(hash)
+        .stencil_table(&stencil_table)
+        .patch_table(&patch_table)
+        .write_to(&mut bytes)?;
+    let cache = TableCache::read_from(&bytes[..])?;
+    assert_eq!(cache.topology_hash(), hash);
+    assert!(format!("{cache:?}").contains("0x0123456789abcdef"));
+    assert!(cache.limit_stencil_table()?.is_none());
+
+    let stencils = cache.stencil_table()?.unwrap();
+    assert_eq!(stencils.sizes, stencil_table.sizes());
+    assert_eq!(stencils.control_indices, stencil_table.control_indices());
+    assert_eq!(stencils.weights, stencil_table.weights());
+    let restored = stencils.to_stencil_table()?;
+    assert_eq!(restored.len(), stencil_table.len());
+    assert_eq!(restored.weights(), stencil_table.weights());
+
+    let patches = cache.patch_table()?.unwrap();
+    assert_eq!(patches.patch_count(), patch_table.patch_count());
+    assert_eq!(
+        patches.control_vertices,
+        patch_table.control_vertices_table().unwrap()
+    );
+    assert_eq!(
+        patches.local_points.map_or(0, |table| table.len()),
+        patch_table.local_point_count()
+    );
+    for patch in 0..patches.patch_count() {
+        let handle = patch_table.patch_handle(patch).unwrap();
+        assert_eq!(
+            patches.patch_vertices(patch),
+            patch_table.patch_vertices(handle)
+        );
+    }
+
+    // The cached face map locates the same patches as `PatchMap`.
+    let patch_map = PatchMap::new(&patch_table).unwrap();
+    for face in 0..6 {
+        for (u, v) in [(0.1, 0.2), (0.6, 0.4), (0.9, 0.3), (0.3, 0.85)] {
+            let expected = patch_map.find_patch(&patch_table, face, u, v).unwrap();
+            let (patch, s, t) = patches.find_patch(face, u, v).unwrap();
+            assert_eq!(patch, expected.0);
+            assert!((s - expected.1).abs() < 1e-6 && (t - expected.2).abs() < 1e-6);
+        }
+    }
+
+    // Files are named after the hash; other versions are rejected.
+    let dir = std::env::temp_dir().join(format!("osd-table-cache-{}", std::process::id()));
+    std::fs::create_dir_all(&dir)?;
+    let path = TableCacheWriter::new(hash)
+        .stencil_table(&stencil_table)
+        .write_to_dir(&dir)?;
+    assert!(TableCache::open_in_dir(&dir, hash)?.is_some());
+    assert!(TableCache::open_in_dir(&dir, hash + 1)?.is_none());
+
+    // Concurrent writers of one path each replace it with a whole file.
+    std::thread::scope(|scope| {
+        for _ in 0..4 {
+            scope.spawn(|| {
+                TableCacheWriter::new(hash)
+                    .patch_table(&patch_table)
+                    .write(&path)
+                    .unwrap()
+            });
+        }
+    });
+    assert!(TableCache::open(&path)?.patch_table()?.is_some());
+    std::fs::remove_file(path)?;
+    std::fs::remove_dir(&dir)?;
+
+    // Out-of-range control indices are rejected on load. Section records
+    // follow the 32 byte header; 0x103 holds the refinement stencil indices.
+    let read_u32 = |at: usize| u32::from_ne_bytes(bytes[at..at + 4].try_into().unwrap());
+    let record = (0..read_u32(24) as usize)
+        .map(|section| 32 + 24 * section)
+        .find(|&record| read_u32(record) == 0x103)
+        .unwrap();
+    let indices = u64::from_ne_bytes(bytes[record + 8..record + 16].try_into().unwrap()) as usize;
+    let mut corrupted = bytes.clone();
+    corrupted[indices..indices + 4].copy_from_slice(&u32::MAX.to_ne_bytes());
+    assert!(TableCache::read_from(&corrupted[..]).is_err());
+
+    bytes[8] ^= 0xff;
+    assert!(TableCache::read_from(&bytes[..]).is_err());
+    Ok(())
+}
+
+#[test]
+fn topology_hash_of_short_descriptor() -> Result<()> {
+    // Two quads but only one quad's worth of vertex indices.
+    let vertices_per_face = [4, 4];
+    let face_vertices = [0, 1, 2, 3];
+
+    let descriptor = TopologyDescriptor::new(4, &vertices_per_face, &face_vertices);
+    #[cfg(feature = "topology_validation")]
+    assert!(descriptor.is_err());
+    #[cfg(not(feature = "topology_validation"))]
+    {
+        // Hashing reads no further than the slice.
+        let descriptor = descriptor?;
+        let hash = TopologyHasher::new().descriptor(&descriptor).finish();
+        assert_eq!(hash, TopologyHasher::new().descriptor(&descriptor).finish());
+    }
+    Ok(())
+}
+
+#[test]
+fn topology_cache_shares_tables() -> Result<()> {
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+    let crease_vertices = [0, 1];
+    let options = TopologyRefinerOptions::default();
+    let refinement = UniformRefinementOptions {
+        refinement_level: 2,
+        ..Default::default()
+    };
+
+    let hash_of = |crease_weight: Option<f32>| -> Result<u64> {
+        let mut descriptor = TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?;
+        let weights = crease_weight.map(|weight| [weight]);
+        if let Some(weights) = &weights {
+            descriptor = descriptor.creases(&crease_vertices, weights)?;
+        }
+        Ok(TopologyHasher::new()
+            .descriptor(&descriptor)
+            .refiner_options(&options)
+            .uniform_refinement(&refinement)
+            .finish())
+    };
+    let hash = hash_of(None)?;
+    assert_eq!(hash, hash_of(None)?);
+    assert_ne!(hash, hash_of(Some(2.0))?);
+    assert_ne!(hash_of(Some(2.0))?, hash_of(Some(3.0))?);
+
+    let build = || -> opensubdiv_petite::Result<TopologyTables> {
+        let descriptor = TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?;
+        let mut refiner = TopologyRefiner::new(descriptor, options)?;
+        refiner.refine_uniform(refinement);
+        let stencil_table = StencilTable::new(&refiner, StencilTableOptions::default())?;
+        Ok(TopologyTables::new(refiner).stencil_table(stencil_table))
+    };
+
+    let cache = TopologyCache::new(usize::MAX);
+    let first = cache.get_or_build(hash, build)?;
+    let second = cache.get_or_build(hash, || unreachable!())?;
+    assert!(std::sync::Arc::ptr_eq(&first, &second));
+    assert!(first.stencils().is_some());
+    assert!(format!("{first:?}").starts_with("TopologyTables"));
+    assert!(format!("{cache:?}").contains("misses: 1"));
+
+    let stats = cache.stats();
+    assert_eq!((stats.hits, stats.misses, stats.entries), (1, 1, 1));
+    assert_eq!(stats.bytes, first.byte_size());
+
+    // A budget fitting one entry evicts the least recently used one.
+    cache.set_budget(first.byte_size());
+    cache.get_or_build(hash + 1, build)?;
+    let stats = cache.stats();
+    assert_eq!((stats.entries, stats.evictions), (1, 1));
+    assert!(cache.get(hash).is_none());
+    assert!(cache.get(hash + 1).is_some());
+    // Handles given out stay valid.
+    assert!(first.stencils().unwrap().len() > 0);
+    Ok(())
+}
+
+#[test]
+fn lod_refiner_rebuilds_changed_lods() -> Result<()> {
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+    let positions = [
+        -0.5, -0.5, 0.5, 0.5, -0.5, 0.5, -0.5, 0.5, 0.5, 0.5, 0.5, 0.5, -0.5, 0.5, -0.5, 0.5, 0.5,
+        -0.5, -0.5, -0.5, -0.5, 0.5, -0.5, -0.5f32,
+    ];
+
+    let descriptor = TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?;
+    let refiner = TopologyRefiner::new(descriptor, TopologyRefinerOptions::default())?;
+    let options = LodOptions {
+        isolation_levels: vec![0, 2],
+        ..Default::default()
+    };
+    let mut lod_refiner = LodRefiner::new(refiner, options, PatchTableOptions::new())?;
+
+    let update = lod_refiner.assign(&[1, 1, 0, 0, 0, 0])?;
+    assert_eq!(update.changed_faces, 2);
+    assert_eq!(update.rebuilt_lods, 2);
+
+    let near = lod_refiner.lod(1).unwrap();
+    assert_eq!(near.isolation_level(), 2);
+    assert_eq!(near.faces(), &[Index(0), Index(1)]);
+    assert!(!near.patch_indices().is_empty());
+    let table = near.patch_table();
+    assert!(near.patch_map().is_built_from(table));
+    assert!(format!("{lod_refiner:?}").contains("isolation_level: 2"));
+    for &patch in near.patch_indices() {
+        let handle = table.patch_handle(patch as usize).unwrap();
+        assert!(table.patch_param_with_handle(handle).unwrap().face_id() < 2);
+    }
+    // Only the selected faces are isolated.
+    let far = lod_refiner.lod(0).unwrap();
+    assert!(far.patch_table().patch_count() < table.patch_count());
+    assert_eq!(far.patch_indices().len(), 4);
+
+    // Nothing changed, nothing is rebuilt.
+    assert_eq!(
+        lod_refiner.assign(&[1, 1, 0, 0, 0, 0])?,
+        LodUpdate::default()
+    );
+
+    // Seen from far away every face fits the coarsest LOD.
+    let metric = ScreenSpaceMetric {
+        eye: [0.0, 0.0, 1000.0],
+        fov_y: 0.8,
+        viewport_height: 1080.0,
+        target_edge_pixels: 8.0,
+    };
+    let update = lod_refiner.update(&positions, &metric)?;
+    assert_eq!(update.changed_faces, 2);
+    assert_eq!(lod_refiner.face_lods(), &[0; 6]);
+    assert!(lod_refiner.lod(1).is_none());
+    assert_eq!(lod_refiner.lods().count(), 1);
+
+    // Up close every face wants the finest LOD.
+    let metric = ScreenSpaceMetric {
+        eye: [0.0, 0.0, 2.0],
+        ..metric
+    };
+    lod_refiner.update(&positions, &metric)?;
+    assert_eq!(lod_refiner.face_lods(), &[1; 6]);
+
+    assert!(lod_refiner.assign(&[2; 6]).is_err());
+    assert!(LodRefiner::new(
+        TopologyRefiner::new(
+            TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?,
+            TopologyRefinerOptions::default(),
+        )?,
+        LodOptions {
+            isolation_levels: vec![2, 1],
+            ..Default::default()
+        },
+        PatchTableOptions::new(),
+    )
+    .is_err());
+    Ok(())
+}
+
 #[test]
 fn uniform_refinement_options_default() {
     let options = UniformRefinementOptions::default();
@@ -561,3 +1394,62 @@ fn deprecated_method_wrappers() -> Result<()> {
 
     Ok(())
 }
+
+#[test]
+fn instrument_records_stages_and_footprints() -> Result<()> {
+    use opensubdiv_petite::instrument::{self, Stage};
+
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+
+    let (tables, report) = instrument::record(|| -> Result<_> {
+        let descriptor = TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?;
+        let mut refiner = TopologyRefiner::new(descriptor, TopologyRefinerOptions::default())?;
+        refiner.refine_adaptive(
+            AdaptiveRefinementOptions {
+                isolation_level: 2,
+                ..Default::default()
+            },
+            None,
+        );
+        let stencil_table = StencilTable::new(&refiner, StencilTableOptions::default())?;
+        let patch_table = PatchTable::new(&refiner, None)?;
+        Ok((stencil_table, patch_table))
+    });
+    let (stencil_table, patch_table) = tables?;
+
+    for stage in [
+        Stage::RefinerCreation,
+        Stage::AdaptiveRefinement,
+        Stage::StencilTableFactory,
+        Stage::PatchTableFactory,
+    ] {
+        assert_eq!(report.stage(stage).map(|record| record.calls), Some(1));
+    }
+    assert_eq!(report.call_count(), 4);
+
+    // Base level plus two isolation levels.
+    assert_eq!(report.levels.len(), 3);
+    assert_eq!(report.levels[0].vertex_count, 8);
+    assert_eq!(report.levels[0].face_count, 6);
+
+    let footprint = stencil_table.memory_footprint();
+    assert_eq!(
+        footprint.weights,
+        stencil_table.weights().len() * std::mem::size_of::<f32>()
+    );
+    assert_eq!(report.tables.len(), 2);
+    assert_eq!(report.tables[0].footprint, footprint);
+    assert_eq!(report.tables[1].footprint, patch_table.memory_footprint());
+    assert!(patch_table.memory_footprint().patch_params > 0);
+    assert!(report
+        .to_json()
+        .contains("\"stage\":\"patch_table_factory\""));
+
+    // A recording of no stages is empty.
+    let (_, empty) = instrument::record(|| ());
+    assert_eq!(empty, instrument::Report::default());
+    Ok(())
+}
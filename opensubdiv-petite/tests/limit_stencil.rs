@@ -86,6 +86,83 @@ fn limit_stencil_2nd_derivatives() {
     assert!(!table.dvv_weights().is_empty());
 }
 
+#[test]
+fn limit_stencil_dirty_derivatives() {
+    use opensubdiv_petite::osd::BufferDescriptor;
+    use opensubdiv_petite::Index;
+
+    let refiner = cube_refiner();
+    let s = [0.1_f32, 0.4, 0.8];
+    let t = [0.3_f32, 0.6, 0.2];
+    let locations: Vec<_> = (0..6)
+        .map(|face| far::LocationArray {
+            ptex_index: face,
+            s: &s,
+            t: &t,
+        })
+        .collect();
+    let table = far::LimitStencilTable::new(
+        &refiner,
+        &locations,
+        None,
+        None,
+        far::LimitStencilTableOptions::default(),
+    )
+    .unwrap();
+    let reverse_index = far::StencilReverseIndex::from_limit_stencil_table(&table).unwrap();
+
+    let mut positions: Vec<f32> = (0..table.control_vertex_count() * 3)
+        .map(|i| (i as f32 * 0.7).sin())
+        .collect();
+    let desc = BufferDescriptor::new(0, 3, 3).unwrap();
+    let mut du = vec![0.0; table.len() * 3];
+    let mut dv = vec![0.0; table.len() * 3];
+    let all: Vec<Index> = (0..table.control_vertex_count()).map(Index::from).collect();
+    table
+        .update_dirty_derivatives(
+            &reverse_index,
+            &all,
+            &positions,
+            desc,
+            &mut du,
+            desc,
+            &mut dv,
+            desc,
+        )
+        .unwrap();
+
+    positions[5] += 2.0;
+    table
+        .update_dirty_derivatives(
+            &reverse_index,
+            &[Index::from(1u32)],
+            &positions,
+            desc,
+            &mut du,
+            desc,
+            &mut dv,
+            desc,
+        )
+        .unwrap();
+
+    // Compare against the derivatives summed from the moved positions.
+    let mut begin = 0;
+    for (stencil, &size) in table.sizes().iter().enumerate() {
+        let taps = begin..begin + size as usize;
+        for dim in 0..3 {
+            let (mut expected_du, mut expected_dv) = (0.0, 0.0);
+            for tap in taps.clone() {
+                let value = positions[table.control_indices()[tap].0 as usize * 3 + dim];
+                expected_du += table.du_weights()[tap] * value;
+                expected_dv += table.dv_weights()[tap] * value;
+            }
+            assert!((du[stencil * 3 + dim] - expected_du).abs() < 1e-4);
+            assert!((dv[stencil * 3 + dim] - expected_dv).abs() < 1e-4);
+        }
+        begin = taps.end;
+    }
+}
+
 #[test]
 fn limit_stencil_multiple_faces() {
     let refiner = cube_refiner();
@@ -120,6 +197,78 @@ fn limit_stencil_multiple_faces() {
     assert_eq!(table.len(), 3);
 }
 
+#[test]
+fn limit_stencil_chunked_matches_serial() {
+    let refiner = cube_refiner();
+    let positions = [
+        [-0.5f32, -0.5, 0.5],
+        [0.5, -0.5, 0.5],
+        [-0.5, 0.5, 0.5],
+        [0.5, 0.5, 0.5],
+        [-0.5, 0.5, -0.5],
+        [0.5, 0.5, -0.5],
+        [-0.5, -0.5, -0.5],
+        [0.5, -0.5, -0.5],
+    ];
+
+    let s: Vec<f32> = (0..7).map(|i| (i as f32 + 0.5) / 7.0).collect();
+    let t: Vec<f32> = s.iter().rev().copied().collect();
+    let locations: Vec<_> = (0..6)
+        .map(|ptex_index| far::LocationArray {
+            ptex_index,
+            s: &s,
+            t: &t,
+        })
+        .collect();
+
+    // Applies each stencil's du weights to the cube's corners.
+    let tangents = |table: &far::LimitStencilTable| -> Vec<[f32; 3]> {
+        (0..table.len())
+            .map(|stencil| {
+                let offset = table.offsets()[stencil].0 as usize;
+                let size = table.sizes()[stencil] as usize;
+                (offset..offset + size).fold([0.0; 3], |mut sum, i| {
+                    let vertex = positions[table.control_indices()[i].0 as usize];
+                    for axis in 0..3 {
+                        sum[axis] += table.du_weights()[i] * vertex[axis];
+                    }
+                    sum
+                })
+            })
+            .collect()
+    };
+
+    let options = far::LimitStencilTableOptions::default();
+    let serial =
+        far::LimitStencilTable::new(&refiner, &locations, None, None, options.clone()).unwrap();
+    // Chunks of 5 split most faces' arrays.
+    let chunked =
+        far::LimitStencilTable::new_chunked(&refiner, &locations, None, None, options.clone(), 5)
+            .unwrap();
+
+    assert_eq!(chunked.len(), serial.len());
+    assert!(chunked.has_1st_derivatives());
+    assert_eq!(chunked.du_weights().len(), chunked.weights().len());
+    for (a, b) in tangents(&serial).iter().zip(tangents(&chunked)) {
+        for axis in 0..3 {
+            assert!((a[axis] - b[axis]).abs() < 1e-5);
+        }
+    }
+
+    // Streaming yields the same stencils in order.
+    let mut stencil_count = 0;
+    let chunks =
+        far::LimitStencilTable::chunks(&refiner, &locations, None, None, options, 5).unwrap();
+    assert_eq!(chunks.len(), (6 * 7usize).div_ceil(5));
+    assert!(format!("{chunks:?}").contains("first_stencil: 0"));
+    for chunk in chunks {
+        let chunk = chunk.unwrap();
+        assert_eq!(chunk.first_stencil, stencil_count);
+        stencil_count += chunk.table.len();
+    }
+    assert_eq!(stencil_count, serial.len());
+}
+
 #[test]
 fn limit_stencil_mismatched_st_lengths() {
     let refiner = cube_refiner();
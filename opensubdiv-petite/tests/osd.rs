@@ -97,6 +97,141 @@ fn test_cpu_evaluator() -> Result<(), Box<dyn std::error::Error>> {
     Ok(())
 }
 
+#[test]
+fn test_cpu_evaluator_views_match_buffers() -> Result<(), Box<dyn std::error::Error>> {
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+    let positions = [
+        [-0.5, -0.5, 0.5],
+        [0.5, -0.5, 0.5],
+        [-0.5, 0.5, 0.5],
+        [0.5, 0.5, 0.5],
+        [-0.5, 0.5, -0.5],
+        [0.5, 0.5, -0.5],
+        [-0.5, -0.5, -0.5],
+        [0.5, -0.5, -0.5f32],
+    ];
+
+    let descriptor = far::TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?;
+    let mut refiner = far::TopologyRefiner::new(descriptor, far::TopologyRefinerOptions::default())
+        .expect("Failed to create TopologyRefiner");
+    refiner.refine_uniform(far::topology_refiner::UniformRefinementOptions {
+        refinement_level: 2,
+        ..Default::default()
+    });
+    let stencil_table = far::StencilTable::new(&refiner, far::StencilTableOptions::default())?;
+    let n_refined_verts = stencil_table.len();
+    let desc = osd::BufferDescriptor::new(0, 3, 3).unwrap();
+
+    let mut src_buffer = osd::CpuVertexBuffer::new(3, positions.len())?;
+    src_buffer.update_data(bytemuck::cast_slice(&positions), 0, positions.len())?;
+    let mut dst_buffer = osd::CpuVertexBuffer::new(3, n_refined_verts)?;
+    osd::cpu_evaluator::evaluate_stencils(
+        &src_buffer,
+        desc,
+        &mut dst_buffer,
+        desc,
+        &stencil_table,
+    )?;
+
+    // Evaluate straight from and into the caller's arrays.
+    let mut refined = vec![[0.0f32; 3]; n_refined_verts];
+    osd::cpu_evaluator::evaluate_stencils_view(
+        &osd::CpuVertexView::from_vertices(&positions),
+        desc,
+        &mut osd::CpuVertexViewMut::from_vertices(&mut refined),
+        desc,
+        &stencil_table,
+    )?;
+    let refined: &[f32] = bytemuck::cast_slice(&refined);
+    assert_eq!(refined, dst_buffer.bind_cpu_buffer()?);
+
+    // Views are bounds checked like buffers.
+    let mut short = vec![[0.0f32; 3]; n_refined_verts - 1];
+    assert!(osd::cpu_evaluator::evaluate_stencils_view(
+        &osd::CpuVertexView::from_vertices(&positions),
+        desc,
+        &mut osd::CpuVertexViewMut::from_vertices(&mut short),
+        desc,
+        &stencil_table,
+    )
+    .is_err());
+    assert!(osd::CpuVertexView::new(&[0.0; 4], 3).is_err());
+    Ok(())
+}
+
+#[cfg(feature = "rayon")]
+#[test]
+fn test_rayon_evaluator_matches_cpu_evaluator() -> Result<(), Box<dyn std::error::Error>> {
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+
+    let descriptor = far::TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?;
+    let mut refiner = far::TopologyRefiner::new(descriptor, far::TopologyRefinerOptions::default())
+        .expect("Failed to create TopologyRefiner");
+    refiner.refine_uniform(far::topology_refiner::UniformRefinementOptions {
+        refinement_level: 4,
+        ..Default::default()
+    });
+
+    let stencil_table = far::StencilTable::new(&refiner, far::StencilTableOptions::default())?;
+    let n_coarse_verts = refiner.level(0).unwrap().vertex_count();
+    let n_refined_verts = stencil_table.len();
+
+    // xyz plus a 5-wide primvar, to cover both the fixed-width and the
+    // generic kernel.
+    let positions: Vec<f32> = (0..n_coarse_verts * 8).map(|i| (i as f32).sin()).collect();
+    let mut src_buffer = osd::CpuVertexBuffer::new(8, n_coarse_verts)?;
+    src_buffer.update_data(&positions, 0, n_coarse_verts)?;
+
+    for (offset, length) in [(0, 3), (3, 5)] {
+        let src_desc = osd::BufferDescriptor::new(offset, length, 8)?;
+        let dst_desc = osd::BufferDescriptor::new(offset, length, 8)?;
+
+        let mut expected = osd::CpuVertexBuffer::new(8, n_refined_verts)?;
+        osd::cpu_evaluator::evaluate_stencils(
+            &src_buffer,
+            src_desc,
+            &mut expected,
+            dst_desc,
+            &stencil_table,
+        )?;
+        let mut actual = osd::CpuVertexBuffer::new(8, n_refined_verts)?;
+        osd::rayon_evaluator::evaluate_stencils(
+            &src_buffer,
+            src_desc,
+            &mut actual,
+            dst_desc,
+            &stencil_table,
+        )?;
+
+        let expected = expected.bind_cpu_buffer()?;
+        let actual = actual.bind_cpu_buffer()?;
+        for vertex in 0..n_refined_verts {
+            for k in offset..offset + length {
+                let i = vertex * 8 + k;
+                assert!((expected[i] - actual[i]).abs() < 1e-5);
+            }
+        }
+    }
+
+    // Short destination buffers are rejected.
+    let desc = osd::BufferDescriptor::new(0, 3, 3)?;
+    assert!(osd::rayon_evaluator::evaluate_stencils_slice(
+        src_buffer.bind_cpu_buffer()?,
+        osd::BufferDescriptor::new(0, 3, 8)?,
+        &mut [0.0; 3],
+        desc,
+        &stencil_table,
+    )
+    .is_err());
+    Ok(())
+}
+
 #[cfg(feature = "cuda")]
 #[test]
 fn test_cuda_vertex_buffer() -> Result<(), Box<dyn std::error::Error>> {
@@ -0,0 +1,475 @@
+//! Tests for `PatchTable` basis and point evaluation.
+
+use opensubdiv_petite::far::{
+    AdaptiveRefinementOptions, EndCapType, FacePoints, PatchEvalOutputs, PatchMap, PatchPoints,
+    PatchTable, PatchTableOptions, PatchType, PrimvarInterpolation, PrimvarRefiner, StencilTable,
+    StencilTableOptions, TopologyDescriptor, TopologyRefiner, TopologyRefinerOptions,
+};
+use opensubdiv_petite::osd::BufferDescriptor;
+
+const CUBE_POSITIONS: [f32; 24] = [
+    -0.5, -0.5, 0.5, 0.5, -0.5, 0.5, -0.5, 0.5, 0.5, 0.5, 0.5, 0.5, -0.5, 0.5, -0.5, 0.5, 0.5,
+    -0.5, -0.5, -0.5, -0.5, 0.5, -0.5, -0.5,
+];
+
+fn cube_patch_table() -> (TopologyRefiner, PatchTable) {
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+
+    let descriptor = TopologyDescriptor::new(8, &vertices_per_face, &face_vertices).unwrap();
+    let mut refiner = TopologyRefiner::new(descriptor, TopologyRefinerOptions::default()).unwrap();
+    refiner.refine_adaptive(
+        AdaptiveRefinementOptions {
+            isolation_level: 2,
+            ..Default::default()
+        },
+        None,
+    );
+
+    let patch_table = PatchTable::new(
+        &refiner,
+        Some(PatchTableOptions::new().end_cap_type(EndCapType::GregoryBasis)),
+    )
+    .unwrap();
+
+    (refiner, patch_table)
+}
+
+#[test]
+fn evaluate_basis_partition_of_unity() {
+    let (_refiner, patch_table) = cube_patch_table();
+
+    let mut patch_types = Vec::new();
+    for patch_index in 0..patch_table.patch_count() {
+        let handle = patch_table.patch_handle(patch_index).unwrap();
+        let patch_type = patch_table
+            .patch_array_descriptor(handle.array_index())
+            .unwrap()
+            .patch_type();
+        if !patch_types.contains(&patch_type) {
+            patch_types.push(patch_type);
+        }
+
+        // Evaluate at the center of the patch's sub-domain.
+        let param = patch_table.patch_param_with_handle(handle).unwrap();
+        let (u, v) = param.unnormalize(0.5, 0.5);
+
+        let (w_p, w_du, w_dv, ..) = patch_table.evaluate_basis(patch_index, u, v).unwrap();
+
+        let sum: f32 = w_p.iter().sum();
+        let sum_du: f32 = w_du.iter().sum();
+        let sum_dv: f32 = w_dv.iter().sum();
+        assert!((sum - 1.0).abs() < 1e-4, "patch {patch_index}: {sum}");
+        assert!(sum_du.abs() < 1e-3, "patch {patch_index}: {sum_du}");
+        assert!(sum_dv.abs() < 1e-3, "patch {patch_index}: {sum_dv}");
+
+        // Handle-based evaluation must agree with index-based evaluation.
+        let (w_p_handle, ..) = patch_table
+            .evaluate_basis_with_handle(handle, u, v)
+            .unwrap();
+        assert_eq!(w_p, w_p_handle);
+    }
+
+    // A cube has extraordinary vertices, so both types must be exercised.
+    assert!(patch_types.contains(&PatchType::Regular));
+    assert!(patch_types.contains(&PatchType::GregoryBasis));
+}
+
+#[test]
+fn patch_handle_lookup() {
+    let (_refiner, patch_table) = cube_patch_table();
+
+    let mut vertex_index = 0;
+    for patch_index in 0..patch_table.patch_count() {
+        let handle = patch_table.patch_handle(patch_index).unwrap();
+        assert_eq!(handle.patch_index(), patch_index);
+        assert_eq!(handle.vertex_index(), vertex_index);
+
+        let vertices = patch_table.patch_vertices(handle).unwrap();
+        vertex_index += vertices.len();
+    }
+
+    assert!(patch_table
+        .patch_handle(patch_table.patch_count())
+        .is_none());
+}
+
+/// Refined vertices of all levels followed by the local points, xyz
+/// interleaved.
+fn cube_control_points(refiner: &TopologyRefiner, patch_table: &PatchTable) -> Vec<f32> {
+    let primvar_refiner = PrimvarRefiner::new(refiner).unwrap();
+    let desc = BufferDescriptor::new(0, 3, 3).unwrap();
+    let mut points = vec![0.0; refiner.vertex_count_all_levels() * 3];
+    points[..CUBE_POSITIONS.len()].copy_from_slice(&CUBE_POSITIONS);
+    primvar_refiner
+        .interpolate_levels(PrimvarInterpolation::Vertex, &mut points, desc)
+        .unwrap();
+
+    if let Some(stencil_table) = patch_table.local_point_stencil_table() {
+        let mut local_points = vec![0.0; stencil_table.len() * 3];
+        stencil_table
+            .update_values_interleaved(&points, desc, &mut local_points, desc, None, None)
+            .unwrap();
+        points.extend_from_slice(&local_points);
+    }
+    points
+}
+
+#[test]
+fn evaluate_points_matches_evaluate_point() {
+    let (refiner, patch_table) = cube_patch_table();
+    let control_points = cube_control_points(&refiner, &patch_table);
+    let xyz: Vec<[f32; 3]> = control_points
+        .chunks_exact(3)
+        .map(|c| [c[0], c[1], c[2]])
+        .collect();
+
+    let patch_indices: Vec<u32> = (0..patch_table.patch_count() as u32).collect();
+    let (u, v): (Vec<f32>, Vec<f32>) = patch_indices
+        .iter()
+        .map(|&patch_index| {
+            let handle = patch_table.patch_handle(patch_index as usize).unwrap();
+            let param = patch_table.patch_param_with_handle(handle).unwrap();
+            param.unnormalize(0.25, 0.75)
+        })
+        .unzip();
+
+    // Write positions and du into one interleaved buffer; skip dv.
+    let src_desc = BufferDescriptor::new(0, 3, 3).unwrap();
+    let mut position = vec![0.0; patch_indices.len() * 6];
+    let mut du = vec![0.0; patch_indices.len() * 6];
+    patch_table
+        .evaluate_points(
+            PatchPoints {
+                patch_indices: &patch_indices,
+                u: &u,
+                v: &v,
+            },
+            &control_points,
+            src_desc,
+            PatchEvalOutputs {
+                desc: BufferDescriptor::new(3, 3, 6).unwrap(),
+                position: Some(&mut position),
+                du: Some(&mut du),
+                ..Default::default()
+            },
+        )
+        .unwrap();
+
+    for (i, &patch_index) in patch_indices.iter().enumerate() {
+        let expected = patch_table
+            .evaluate_point(patch_index as usize, u[i], v[i], &xyz)
+            .unwrap();
+        for k in 0..3 {
+            assert!((position[i * 6 + 3 + k] - expected.point[k]).abs() < 1e-5);
+            assert!((du[i * 6 + 3 + k] - expected.du[k]).abs() < 1e-4);
+        }
+    }
+
+    // Out-of-range patches and short buffers are rejected up front.
+    let bad_index = [patch_table.patch_count() as u32];
+    assert!(patch_table
+        .evaluate_points(
+            PatchPoints {
+                patch_indices: &bad_index,
+                u: &[0.5],
+                v: &[0.5],
+            },
+            &control_points,
+            src_desc,
+            PatchEvalOutputs {
+                desc: src_desc,
+                position: Some(&mut [0.0; 3]),
+                ..Default::default()
+            },
+        )
+        .is_err());
+    assert!(patch_table
+        .evaluate_points(
+            PatchPoints {
+                patch_indices: &patch_indices,
+                u: &u,
+                v: &v,
+            },
+            &control_points,
+            src_desc,
+            PatchEvalOutputs {
+                desc: src_desc,
+                position: Some(&mut [0.0; 3]),
+                ..Default::default()
+            },
+        )
+        .is_err());
+}
+
+#[test]
+fn evaluate_face_points() {
+    let (refiner, patch_table) = cube_patch_table();
+    let control_points = cube_control_points(&refiner, &patch_table);
+    let patch_map = PatchMap::new(&patch_table).unwrap();
+
+    let face_indices: Vec<u32> = (0..6).collect();
+    let u = [0.5; 6];
+    let v = [0.5; 6];
+    let desc = BufferDescriptor::new(0, 3, 3).unwrap();
+    let mut position = vec![0.0; 18];
+
+    let evaluated = patch_table
+        .evaluate_face_points(
+            &patch_map,
+            FacePoints {
+                face_indices: &face_indices,
+                u: &u,
+                v: &v,
+            },
+            &control_points,
+            desc,
+            PatchEvalOutputs {
+                desc,
+                position: Some(&mut position),
+                ..Default::default()
+            },
+        )
+        .unwrap();
+    assert_eq!(evaluated, 6);
+
+    // Face centers of the limit surface lie strictly inside the cage, on the
+    // face's axis.
+    for point in position.chunks_exact(3) {
+        let max = point.iter().fold(0.0f32, |max, c| max.max(c.abs()));
+        assert!(max > 0.0 && max < 0.5, "{point:?}");
+    }
+}
+
+#[test]
+fn patch_map_find_patches() {
+    let (refiner, patch_table) = cube_patch_table();
+    let control_points = cube_control_points(&refiner, &patch_table);
+    let patch_map = PatchMap::new(&patch_table).unwrap();
+
+    // A grid of samples on every face.
+    let (mut face_indices, mut u, mut v) = (Vec::new(), Vec::new(), Vec::new());
+    for face in 0..6u32 {
+        for j in 0..8 {
+            for i in 0..8 {
+                face_indices.push(face);
+                u.push((i as f32 + 0.5) / 8.0);
+                v.push((j as f32 + 0.5) / 8.0);
+            }
+        }
+    }
+    let points = FacePoints {
+        face_indices: &face_indices,
+        u: &u,
+        v: &v,
+    };
+
+    let mut patch_indices = vec![0; face_indices.len()];
+    let mut local_u = vec![0.0; face_indices.len()];
+    let mut local_v = vec![0.0; face_indices.len()];
+    let found = patch_map
+        .find_patches(
+            &patch_table,
+            points,
+            &mut patch_indices,
+            Some((&mut local_u, &mut local_v)),
+        )
+        .unwrap();
+    assert_eq!(found, face_indices.len());
+
+    for i in 0..face_indices.len() {
+        let (patch_index, patch_u, patch_v) = patch_map
+            .find_patch(&patch_table, face_indices[i] as usize, u[i], v[i])
+            .unwrap();
+        assert_eq!(patch_index, patch_indices[i] as usize);
+        assert_eq!((patch_u, patch_v), (local_u[i], local_v[i]));
+
+        // Local coordinates must come from the located patch's parameter.
+        let handle = patch_table.patch_handle(patch_index).unwrap();
+        let param = patch_table.patch_param_with_handle(handle).unwrap();
+        assert_eq!(param.normalize(u[i], v[i]), (patch_u, patch_v));
+        assert!((0.0..=1.0).contains(&patch_u) && (0.0..=1.0).contains(&patch_v));
+    }
+
+    // Evaluating the located patches at the face coordinates matches
+    // evaluating the faces directly.
+    let desc = BufferDescriptor::new(0, 3, 3).unwrap();
+    let mut by_patch = vec![0.0; face_indices.len() * 3];
+    let mut by_face = vec![0.0; face_indices.len() * 3];
+    patch_table
+        .evaluate_points(
+            PatchPoints {
+                patch_indices: &patch_indices,
+                u: &u,
+                v: &v,
+            },
+            &control_points,
+            desc,
+            PatchEvalOutputs {
+                desc,
+                position: Some(&mut by_patch),
+                ..Default::default()
+            },
+        )
+        .unwrap();
+    patch_table
+        .evaluate_face_points(
+            &patch_map,
+            points,
+            &control_points,
+            desc,
+            PatchEvalOutputs {
+                desc,
+                position: Some(&mut by_face),
+                ..Default::default()
+            },
+        )
+        .unwrap();
+    assert_eq!(by_patch, by_face);
+
+    // Faces outside the table are reported as not found.
+    let mut missing = [0];
+    let found = patch_map
+        .find_patches(
+            &patch_table,
+            FacePoints {
+                face_indices: &[6],
+                u: &[0.5],
+                v: &[0.5],
+            },
+            &mut missing,
+            None,
+        )
+        .unwrap();
+    assert_eq!((found, missing[0]), (0, PatchMap::NOT_FOUND));
+
+    // The map only answers for the table it was built from.
+    let (_, other_table) = cube_patch_table();
+    assert!(!patch_map.is_built_from(&other_table));
+    assert!(patch_map.find_patch(&other_table, 0, 0.5, 0.5).is_none());
+    assert!(patch_map
+        .find_patches(&other_table, points, &mut patch_indices, None)
+        .is_err());
+}
+
+#[test]
+fn factorized_local_point_stencils() {
+    let (refiner, patch_table) = cube_patch_table();
+    let expected = cube_control_points(&refiner, &patch_table);
+    let local_points = patch_table.local_point_stencil_table().unwrap();
+
+    let base = StencilTable::new(
+        &refiner,
+        StencilTableOptions {
+            generate_control_vertices: true,
+            generate_intermediate_levels: true,
+            generate_offsets: true,
+            ..Default::default()
+        },
+    )
+    .unwrap();
+    let all_points = base
+        .append_local_points(&refiner, local_points, true)
+        .unwrap();
+    assert_eq!(all_points.len(), base.len() + local_points.len());
+    assert_eq!(all_points.control_vertex_count(), 8);
+
+    // One pass over the base control vertices yields every patch CV.
+    let desc = BufferDescriptor::new(0, 3, 3).unwrap();
+    let mut points = vec![0.0; all_points.len() * 3];
+    all_points
+        .update_values_interleaved(&CUBE_POSITIONS, desc, &mut points, desc, None, None)
+        .unwrap();
+    assert_eq!(points.len(), expected.len());
+    for (point, expected) in points.iter().zip(&expected) {
+        assert!((point - expected).abs() < 1e-5, "{point} != {expected}");
+    }
+
+    // Concatenation keeps both tables' stencils in order.
+    let twice = StencilTable::concatenate(&[base.as_table_ref(), base.as_table_ref()]).unwrap();
+    assert_eq!(twice.len(), 2 * base.len());
+    assert_eq!(twice.weights().len(), 2 * base.weights().len());
+    assert_eq!(&twice.weights()[base.weights().len()..], base.weights());
+
+    // Tables indexing different control vertices cannot be concatenated,
+    // and local points only append to tables of all refined vertices.
+    assert!(StencilTable::concatenate(&[base.as_table_ref(), local_points]).is_err());
+    assert!(StencilTable::concatenate(&[]).is_err());
+    assert!(all_points
+        .append_local_points(&refiner, local_points, true)
+        .is_err());
+}
+
+#[test]
+fn osd_evaluate_patches_matches_evaluate_point() {
+    use opensubdiv_petite::osd::{
+        cpu_evaluator, CpuPatchTable, CpuVertexBuffer, Derivatives, EvalOutput, PatchCoord,
+    };
+
+    let (refiner, patch_table) = cube_patch_table();
+    let control_points = cube_control_points(&refiner, &patch_table);
+    let xyz: Vec<[f32; 3]> = control_points
+        .chunks_exact(3)
+        .map(|c| [c[0], c[1], c[2]])
+        .collect();
+
+    let patch_coords: Vec<PatchCoord> = (0..patch_table.patch_count())
+        .map(|patch_index| {
+            let handle = patch_table.patch_handle(patch_index).unwrap();
+            let param = patch_table.patch_param_with_handle(handle).unwrap();
+            let (s, t) = param.unnormalize(0.25, 0.75);
+            PatchCoord::new(handle, s, t)
+        })
+        .collect();
+
+    let mut src = CpuVertexBuffer::new(3, xyz.len()).unwrap();
+    src.update_data(&control_points, 0, xyz.len()).unwrap();
+    let cpu_patch_table = CpuPatchTable::new(&patch_table).unwrap();
+
+    // Positions, du and dv interleaved in one buffer.
+    let mut dst = CpuVertexBuffer::new(9, patch_coords.len()).unwrap();
+    cpu_evaluator::evaluate_patches_with_derivatives(
+        &src,
+        BufferDescriptor::new(0, 3, 3).unwrap(),
+        &mut dst,
+        BufferDescriptor::new(0, 3, 9).unwrap(),
+        Derivatives {
+            du: EvalOutput::interleaved(BufferDescriptor::new(3, 3, 9).unwrap()),
+            dv: EvalOutput::interleaved(BufferDescriptor::new(6, 3, 9).unwrap()),
+        },
+        None,
+        &patch_coords,
+        &cpu_patch_table,
+    )
+    .unwrap();
+
+    let result = dst.bind_cpu_buffer().unwrap();
+    for (i, coord) in patch_coords.iter().enumerate() {
+        let expected = patch_table
+            .evaluate_point(coord.handle().patch_index(), coord.s(), coord.t(), &xyz)
+            .unwrap();
+        for k in 0..3 {
+            assert!((result[i * 9 + k] - expected.point[k]).abs() < 1e-5);
+            assert!((result[i * 9 + 3 + k] - expected.du[k]).abs() < 1e-4);
+            assert!((result[i * 9 + 6 + k] - expected.dv[k]).abs() < 1e-4);
+        }
+    }
+
+    // Overlapping interleaved outputs are rejected.
+    assert!(cpu_evaluator::evaluate_patches_with_derivatives(
+        &src,
+        BufferDescriptor::new(0, 3, 3).unwrap(),
+        &mut dst,
+        BufferDescriptor::new(0, 3, 9).unwrap(),
+        Derivatives {
+            du: EvalOutput::interleaved(BufferDescriptor::new(2, 3, 9).unwrap()),
+            dv: EvalOutput::interleaved(BufferDescriptor::new(6, 3, 9).unwrap()),
+        },
+        None,
+        &patch_coords,
+        &cpu_patch_table,
+    )
+    .is_err());
+}
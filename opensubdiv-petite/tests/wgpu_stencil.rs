@@ -344,3 +344,277 @@ fn wgpu_limit_stencil_positions_match_cpu() -> Result<(), Box<dyn std::error::Er
 
     Ok(())
 }
+
+#[test]
+fn wgpu_context_reuses_buffers_across_frames() -> Result<(), Box<dyn std::error::Error>> {
+    let (device, queue) = match request_device() {
+        Some(d) => d,
+        None => return Ok(()),
+    };
+
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+    let positions = [
+        -0.5_f32, -0.5, 0.5, 0.5, -0.5, 0.5, -0.5, 0.5, 0.5, 0.5, 0.5, 0.5, -0.5, 0.5, -0.5, 0.5,
+        0.5, -0.5, -0.5, -0.5, -0.5, 0.5, -0.5, -0.5,
+    ];
+
+    let descriptor = far::TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?;
+    let mut refiner =
+        far::TopologyRefiner::new(descriptor, far::TopologyRefinerOptions::default())?;
+    refiner.refine_uniform(far::topology_refiner::UniformRefinementOptions {
+        refinement_level: 2,
+        ..Default::default()
+    });
+
+    let stencil_table = far::StencilTable::new(
+        &refiner,
+        far::StencilTableOptions {
+            generate_offsets: true,
+            ..Default::default()
+        },
+    )?;
+
+    let n_coarse = 8;
+    let n_refined = stencil_table.len();
+    let desc = osd::BufferDescriptor::new(0, 3, 3)?;
+
+    let pipeline =
+        osd::wgpu::StencilEvalPipeline::new(&device, osd::wgpu::WgslModuleConfig::default());
+    let contexts = [
+        osd::wgpu::StencilEvalContext::new(&device, &pipeline, &stencil_table, desc, desc)?,
+        osd::wgpu::StencilEvalContext::new(&device, &pipeline, &stencil_table, desc, desc)?,
+    ];
+    let dst_size_bytes = (n_refined * 3 * std::mem::size_of::<f32>()) as u64;
+
+    // Every "frame" deforms both meshes differently and evaluates them in one
+    // compute pass.
+    for frame in 0..3 {
+        let frames: Vec<Vec<f32>> = (0..contexts.len())
+            .map(|mesh| {
+                let scale = 1.0 + frame as f32 + mesh as f32 * 0.5;
+                positions.iter().map(|p| p * scale).collect()
+            })
+            .collect();
+        for (context, data) in contexts.iter().zip(&frames) {
+            context.update_control_vertices(&queue, data, 0)?;
+        }
+
+        let mut encoder =
+            device.create_command_encoder(&wgpu::CommandEncoderDescriptor { label: None });
+        pipeline.encode_contexts(&mut encoder, &contexts);
+        queue.submit(std::iter::once(encoder.finish()));
+
+        for (context, data) in contexts.iter().zip(&frames) {
+            let gpu_data = readback_buffer(&device, &queue, context.dst_buffer(), dst_size_bytes);
+
+            let mut cpu_src = osd::CpuVertexBuffer::new(3, n_coarse)?;
+            let mut cpu_dst = osd::CpuVertexBuffer::new(3, n_refined)?;
+            cpu_src.update_data(data, 0, n_coarse)?;
+            osd::cpu_evaluator::evaluate_stencils(
+                &cpu_src,
+                desc,
+                &mut cpu_dst,
+                desc,
+                &stencil_table,
+            )?;
+            let cpu_data = cpu_dst.bind_cpu_buffer()?;
+
+            assert_eq!(gpu_data.len(), cpu_data.len());
+            for (cpu, gpu) in cpu_data.iter().zip(gpu_data.iter()) {
+                assert!((cpu - gpu).abs() < 1e-5, "cpu {cpu} vs gpu {gpu}");
+            }
+        }
+    }
+
+    // Writes past the coarse vertex buffer are rejected.
+    assert!(contexts[0]
+        .update_control_vertices(&queue, &positions, 1)
+        .is_err());
+
+    Ok(())
+}
+
+#[test]
+fn wgpu_batched_context_matches_cpu_per_mesh() -> Result<(), Box<dyn std::error::Error>> {
+    let (device, queue) = match request_device() {
+        Some(d) => d,
+        None => return Ok(()),
+    };
+
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+    let positions = [
+        -0.5_f32, -0.5, 0.5, 0.5, -0.5, 0.5, -0.5, 0.5, 0.5, 0.5, 0.5, 0.5, -0.5, 0.5, -0.5, 0.5,
+        0.5, -0.5, -0.5, -0.5, -0.5, 0.5, -0.5, -0.5,
+    ];
+
+    // Two different tables over two different cages.
+    let tables = [1, 2]
+        .into_iter()
+        .map(|level| {
+            let descriptor = far::TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?;
+            let mut refiner =
+                far::TopologyRefiner::new(descriptor, far::TopologyRefinerOptions::default())?;
+            refiner.refine_uniform(far::topology_refiner::UniformRefinementOptions {
+                refinement_level: level,
+                ..Default::default()
+            });
+            far::StencilTable::new(
+                &refiner,
+                far::StencilTableOptions {
+                    generate_offsets: true,
+                    ..Default::default()
+                },
+            )
+        })
+        .collect::<Result<Vec<_>, _>>()?;
+
+    let entries = [
+        osd::wgpu::StencilBatchEntry {
+            table: &tables[0],
+            src_vertex: 0,
+        },
+        osd::wgpu::StencilBatchEntry {
+            table: &tables[1],
+            src_vertex: 8,
+        },
+        // An instance sharing the cage of the first mesh.
+        osd::wgpu::StencilBatchEntry {
+            table: &tables[1],
+            src_vertex: 0,
+        },
+    ];
+
+    let desc = osd::BufferDescriptor::new(0, 3, 3)?;
+    let pipeline =
+        osd::wgpu::StencilEvalPipeline::new(&device, osd::wgpu::WgslModuleConfig::default());
+    let context =
+        osd::wgpu::StencilEvalContext::new_batched(&device, &pipeline, &entries, desc, desc)?;
+    assert_eq!(context.meshes().len(), entries.len());
+    assert_eq!(context.control_vertex_count(), 16);
+
+    let cages: [Vec<f32>; 2] = [
+        positions.to_vec(),
+        positions.iter().map(|p| p * 2.0 + 1.0).collect(),
+    ];
+    context.update_control_vertices(&queue, &cages[0], 0)?;
+    context.update_control_vertices(&queue, &cages[1], 8)?;
+
+    let mut encoder =
+        device.create_command_encoder(&wgpu::CommandEncoderDescriptor { label: None });
+    context.encode(&pipeline, &mut encoder);
+    queue.submit(std::iter::once(encoder.finish()));
+
+    let dst_size_bytes = (context.stencil_count() * 3 * std::mem::size_of::<f32>()) as u64;
+    let gpu_data = readback_buffer(&device, &queue, context.dst_buffer(), dst_size_bytes);
+
+    for (entry, range) in entries.iter().zip(context.meshes()) {
+        let cage = &cages[entry.src_vertex / 8];
+        let n_refined = entry.table.len();
+        assert_eq!(range.dst.len(), n_refined);
+
+        let mut cpu_src = osd::CpuVertexBuffer::new(3, 8)?;
+        let mut cpu_dst = osd::CpuVertexBuffer::new(3, n_refined)?;
+        cpu_src.update_data(cage, 0, 8)?;
+        osd::cpu_evaluator::evaluate_stencils(&cpu_src, desc, &mut cpu_dst, desc, entry.table)?;
+        let cpu_data = cpu_dst.bind_cpu_buffer()?;
+
+        let gpu_mesh = &gpu_data[range.dst.start * 3..range.dst.end * 3];
+        for (cpu, gpu) in cpu_data.iter().zip(gpu_mesh) {
+            assert!((cpu - gpu).abs() < 1e-5, "cpu {cpu} vs gpu {gpu}");
+        }
+    }
+
+    Ok(())
+}
+
+#[test]
+fn wgpu_compact_stencils_match_cpu_within_report() -> Result<(), Box<dyn std::error::Error>> {
+    let vertices_per_face = [4, 4, 4, 4, 4, 4];
+    let face_vertices = [
+        0, 1, 3, 2, 2, 3, 5, 4, 4, 5, 7, 6, 6, 7, 1, 0, 1, 7, 5, 3, 6, 0, 2, 4,
+    ];
+    let positions = [
+        -0.5_f32, -0.5, 0.5, 0.5, -0.5, 0.5, -0.5, 0.5, 0.5, 0.5, 0.5, 0.5, -0.5, 0.5, -0.5, 0.5,
+        0.5, -0.5, -0.5, -0.5, -0.5, 0.5, -0.5, -0.5,
+    ];
+
+    let descriptor = far::TopologyDescriptor::new(8, &vertices_per_face, &face_vertices)?;
+    let mut refiner =
+        far::TopologyRefiner::new(descriptor, far::TopologyRefinerOptions::default())?;
+    refiner.refine_uniform(far::topology_refiner::UniformRefinementOptions {
+        refinement_level: 2,
+        ..Default::default()
+    });
+    let stencil_table = far::StencilTable::new(&refiner, far::StencilTableOptions::default())?;
+    let n_refined_verts = stencil_table.len();
+
+    // The host encoding round-trips indices exactly and weights within the
+    // reported error.
+    let compact = osd::wgpu::CompactStencilTable::encode(&stencil_table)?;
+    let report = compact.report();
+    assert!(report.compact_bytes < report.full_bytes);
+    let mut begin = 0;
+    for (stencil, &size) in stencil_table.sizes().iter().enumerate() {
+        let taps = compact.decode_stencil(stencil).unwrap();
+        assert_eq!(taps.len(), size as usize);
+        for (tap, (index, weight)) in taps.into_iter().enumerate() {
+            assert_eq!(index, stencil_table.control_indices()[begin + tap]);
+            let expected = stencil_table.weights()[begin + tap];
+            assert!((weight - expected).abs() <= report.max_weight_error);
+        }
+        begin += size as usize;
+    }
+
+    let (device, queue) = match request_device() {
+        Some(d) => d,
+        None => return Ok(()), // Skip if no backend is available.
+    };
+
+    let desc = osd::BufferDescriptor::new(0, 3, 3)?;
+    let mut cpu_data = vec![0.0f32; n_refined_verts * 3];
+    stencil_table.update_values_interleaved(&positions, desc, &mut cpu_data, desc, None, None)?;
+
+    let gpu_table = osd::wgpu::CompactStencilTableGpu::upload(&device, &compact);
+    let src_buffer = device.create_buffer_init(&wgpu::util::BufferInitDescriptor {
+        label: Some("opensubdiv-petite test src"),
+        contents: bytemuck::cast_slice(&positions),
+        usage: wgpu::BufferUsages::STORAGE | wgpu::BufferUsages::COPY_DST,
+    });
+    let dst_size_bytes = (n_refined_verts * 3 * std::mem::size_of::<f32>()) as u64;
+    let dst_buffer = device.create_buffer(&wgpu::BufferDescriptor {
+        label: Some("opensubdiv-petite test dst"),
+        size: dst_size_bytes,
+        usage: wgpu::BufferUsages::STORAGE | wgpu::BufferUsages::COPY_SRC,
+        mapped_at_creation: false,
+    });
+
+    let pipeline =
+        osd::wgpu::CompactStencilEvalPipeline::new(&device, osd::wgpu::WgslModuleConfig::default());
+    osd::wgpu::evaluate_compact_stencils(
+        &device,
+        &queue,
+        &pipeline,
+        &gpu_table,
+        &src_buffer,
+        &dst_buffer,
+        desc,
+        desc,
+        0..gpu_table.stencil_count,
+    )?;
+
+    let gpu_data = readback_buffer(&device, &queue, &dst_buffer, dst_size_bytes);
+
+    // Positions are at most 0.5 in magnitude.
+    let tolerance = 0.5 * report.max_stencil_error + 1e-5;
+    for (cpu, gpu) in cpu_data.iter().zip(gpu_data.iter()) {
+        assert!((cpu - gpu).abs() <= tolerance, "cpu {cpu} vs gpu {gpu}");
+    }
+
+    Ok(())
+}